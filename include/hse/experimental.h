@@ -31,6 +31,17 @@ extern "C" {
 #define HSE_KVDB_COMPACT_SAMP_LWM (1u << 1)
 #define HSE_KVDB_COMPACT_FULL     (1u << 2)
 
+/* hse_kvs_cursor_create() flags, in addition to those in flags.h.
+ *
+ * Cursors created with either flag never fetch values from media, which
+ * makes scans that need only keys (e.g., counting or existence sweeps) far
+ * cheaper on KVSs with large values.  Cursor reads return a NULL value whose
+ * length is zero (KEYS_ONLY) or the actual length of the value (VLEN_ONLY).
+ * The two flags are mutually exclusive.
+ */
+#define HSE_CURSOR_CREATE_KEYS_ONLY (1u << 1)
+#define HSE_CURSOR_CREATE_VLEN_ONLY (1u << 2)
+
 /** @addtogroup KVDB Key-Value Database (KVDB)
  * @{
  */
@@ -88,6 +99,82 @@ hse_kvdb_compact(struct hse_kvdb *kvdb, unsigned int flags);
 hse_err_t
 hse_kvdb_compact_status_get(struct hse_kvdb *kvdb, struct hse_kvdb_compact_status *status);
 
+/** @brief Create an online, consistent copy of a KVDB.
+ *
+ * Syncs the KVDB, then clones its cN metadata and media class files into
+ * @p dest_dir, so that @p dest_dir becomes the KVDB home of a point-in-time
+ * copy which can be opened with hse_kvdb_open().  Each configured media
+ * class is placed in a subdirectory of @p dest_dir named after the media
+ * class.  Files are reflinked when the file system supports it, making the
+ * copy nearly instantaneous and space efficient, and are otherwise copied.
+ * cN metadata updates are held off only while the metadata is cloned.
+ * Writes to the KVDB and cN maintenance may proceed while the data files
+ * are copied, but the release of storage freed by cN maintenance and of
+ * WAL files no longer needed for recovery is deferred until the copy
+ * completes.
+ *
+ * @note This function is thread safe.
+ *
+ * @param kvdb: KVDB handle.
+ * @param dest_dir: Existing directory without a KVDB.
+ *
+ * @remark @p kvdb must not be NULL.
+ * @remark @p dest_dir must not be NULL.
+ * @remark @p kvdb must have been opened in a mode that allows writes.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvdb_checkpoint(struct hse_kvdb *kvdb, const char *dest_dir);
+
+/** @struct hse_kvdb_snapshot
+ * @brief Opaque structure, a pointer to which is a handle to a read snapshot
+ * of a KVDB.
+ */
+struct hse_kvdb_snapshot;
+
+/** @brief Create a read snapshot of a KVDB.
+ *
+ * A snapshot is a stable, read-only view of all KVSs in the KVDB as of the
+ * time it was created, which can be passed to hse_kvs_snapshot_get(),
+ * hse_kvs_snapshot_prefix_probe() and hse_kvs_snapshot_cursor_create().
+ * Unlike a transaction, a snapshot has no write set and is never aborted
+ * by HSE, so it may be held for as long as the application needs it.
+ * Snapshots are cheap to create, but while a snapshot exists compaction
+ * cannot discard values which it may see, so long-lived snapshots increase
+ * space amplification.
+ *
+ * @note This function is thread safe.
+ *
+ * @param kvdb: KVDB handle.
+ * @param[out] snap: Snapshot handle.
+ *
+ * @remark @p kvdb must not be NULL.
+ * @remark @p snap must not be NULL.
+ * @remark The snapshot must be released with hse_kvdb_snapshot_release()
+ * before @p kvdb is closed.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvdb_snapshot_create(struct hse_kvdb *kvdb, struct hse_kvdb_snapshot **snap);
+
+/** @brief Release a read snapshot.
+ *
+ * Cursors created from the snapshot remain usable after it is released.
+ *
+ * @note This function is thread safe with respect to other snapshots.
+ *
+ * @param kvdb: KVDB handle.
+ * @param snap: Snapshot handle (may be NULL).
+ *
+ * @remark @p kvdb must not be NULL.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvdb_snapshot_release(struct hse_kvdb *kvdb, struct hse_kvdb_snapshot *snap);
+
 /**@} KVDB */
 
 /** @addtogroup KVS Key-Value Store (KVS)
@@ -150,6 +237,769 @@ hse_kvs_prefix_probe(
     size_t valbuf_sz,
     size_t *val_len);
 
+/** @brief Completion callback for hse_kvs_get_threaded().
+ *
+ * Invoked exactly once per successfully submitted request, from an HSE
+ * worker thread. The callback should not block for long periods as it
+ * occupies the worker and delays the completion of other queued gets.
+ *
+ * @param arg: Argument passed to hse_kvs_get_threaded().
+ * @param err: Error status of the get.
+ * @param found: Whether or not the key was found.
+ * @param val_len: Actual length of the value if the key was found.
+ */
+typedef void
+hse_kvs_get_cb(void *arg, hse_err_t err, bool found, size_t val_len);
+
+/** @brief Retrieve the value for a given key from a KVS on an HSE worker thread.
+ *
+ * This is a convenience wrapper which runs an ordinary blocking get on a
+ * pool of HSE worker threads and reports the result through a callback.
+ * It does not issue asynchronous media reads, so the number of gets that
+ * make progress concurrently is bounded by the size of the pool (see the
+ * kvdb rparam get_threaded_workers).  Requests submitted beyond that are
+ * queued until a worker becomes free.
+ *
+ * The view of the KVS is established when the request is submitted, so the
+ * result is the same as that of a hse_kvs_get() issued at that time.  The
+ * workers read values that are not resident in memory with explicit reads
+ * rather than page faults on the mcache maps.
+ *
+ * The key is copied and may be reused as soon as this function returns.
+ * @p valbuf must remain valid until @p cb has been invoked.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param key: Key to get from @p kvs.
+ * @param key_len: Length of @p key.
+ * @param valbuf: Buffer into which the value associated with @p key will be
+ *     copied (optional).
+ * @param valbuf_sz: Size of @p valbuf.
+ * @param cb: Completion callback.
+ * @param arg: Argument passed to @p cb.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p key must not be NULL.
+ * @remark @p key_len must be within the range of [1, HSE_KVS_KEY_LEN_MAX].
+ * @remark @p cb must not be NULL.
+ * @remark Transactional gets are not supported.
+ *
+ * @returns Error status. If non-zero, @p cb will not be invoked.
+ */
+hse_err_t
+hse_kvs_get_threaded(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    const void *key,
+    size_t key_len,
+    void *valbuf,
+    size_t valbuf_sz,
+    hse_kvs_get_cb *cb,
+    void *arg);
+
+/** @brief Descriptor for one key of a hse_kvs_get_multi() request. */
+struct hse_kvs_get_desc {
+    const void *key;  /**< Key to look up. */
+    size_t key_len;   /**< Length of @p key. */
+    void *valbuf;     /**< Buffer into which the value associated with @p key will be copied (optional). */
+    size_t valbuf_sz; /**< Size of @p valbuf. */
+    size_t val_len;   /**< [out] Actual length of the value if the key was found. */
+    bool found;       /**< [out] Whether or not the key was found. */
+};
+
+/** @brief Retrieve the values for a batch of keys from a KVS.
+ *
+ * Semantically equivalent to calling hse_kvs_get() for each descriptor in
+ * @p descv using a single view of the KVS, but the lookups in the cn tree
+ * are resolved for the whole batch at once: the keys are sorted, the tree
+ * is locked once, keys are routed to nodes in a single pass and each kvset
+ * is probed for all of its keys before moving on to the next kvset.
+ *
+ * Each descriptor follows the hse_kvs_get() rules for its key and value
+ * buffer, including the probe semantics of a NULL @p valbuf with a zero
+ * @p valbuf_sz.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param txn: Transaction context (optional).
+ * @param[in,out] descv: Array of key descriptors.
+ * @param descc: Number of elements in @p descv.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p descv must not be NULL unless @p descc is 0.
+ * @remark Every key must be non-NULL with a length in the range of
+ *         [1, HSE_KVS_KEY_LEN_MAX].
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_get_multi(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_txn *txn,
+    struct hse_kvs_get_desc *descv,
+    size_t descc);
+
+/** @brief Delete all key-value pairs within a range of keys from a KVS.
+ *
+ * Atomically deletes every key @p k such that @p start <= @p k < @p end in
+ * the ordering of hse_kvs_cursor_read(). The delete is recorded as a single
+ * range tombstone, so its cost does not depend on the number of keys in the
+ * range. Gets, prefix probes and cursors whose view is established after the
+ * call returns see none of the keys of the range that were put before the
+ * call. Keys put after the call returns are not affected.
+ *
+ * The range tombstone is retired by compaction once none of the data it
+ * deletes remains. A KVS has a bounded number of outstanding range
+ * tombstones, beyond which this function fails with ENOSPC until some have
+ * been retired.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param start: First key of the range (inclusive).
+ * @param start_len: Length of @p start.
+ * @param end: End of the range (exclusive).
+ * @param end_len: Length of @p end.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p start and @p end must not be NULL.
+ * @remark @p start_len and @p end_len must be within the range of
+ *         [1, HSE_KVS_KEY_LEN_MAX].
+ * @remark @p start must be less than @p end.
+ * @remark Range deletes are not supported on transactional KVSs.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_range_delete(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    const void *start,
+    size_t start_len,
+    const void *end,
+    size_t end_len);
+
+/** @brief Operation types for hse_kvs_write_batch(). */
+enum hse_kvs_batch_op_type {
+    HSE_KVS_BATCH_PUT,    /**< Put a key-value pair. */
+    HSE_KVS_BATCH_DELETE, /**< Delete a key. */
+};
+
+/** @brief Descriptor for one operation of a hse_kvs_write_batch() request. */
+struct hse_kvs_batch_op {
+    enum hse_kvs_batch_op_type type; /**< Operation type. */
+    const void *key;                 /**< Key to put or delete. */
+    size_t key_len;                  /**< Length of @p key. */
+    const void *val;                 /**< Value to put (ignored for deletes). */
+    size_t val_len;                  /**< Length of @p val (ignored for deletes). */
+};
+
+/** @brief Apply a batch of puts and deletes to a KVS.
+ *
+ * Semantically equivalent to calling hse_kvs_put() or hse_kvs_delete() for
+ * each descriptor in @p opv, in order, outside of a transaction. The batch is
+ * neither atomic nor isolated: other threads may observe a partially applied
+ * batch, and if an error is returned a prefix of the batch may have been
+ * applied. In exchange, the whole batch is logged to the WAL through a small
+ * number of buffer reservations and inserted into the in-memory index in a
+ * single pass per batch, which is considerably cheaper than issuing the
+ * operations one at a time.
+ *
+ * When a key appears more than once in a batch, the last operation on it wins.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ * @arg HSE_KVS_PUT_PRIO - Operations will not be throttled.
+ * @arg HSE_KVS_PUT_VCOMP_OFF - Values will not be compressed.
+ * @arg HSE_KVS_PUT_VCOMP_ON - Values will be compressed.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param opv: Array of operation descriptors.
+ * @param opc: Number of elements in @p opv.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p opv must not be NULL unless @p opc is 0.
+ * @remark Every key must be non-NULL with a length in the range of
+ *         [1, HSE_KVS_KEY_LEN_MAX].
+ * @remark Every put value must be at most HSE_KVS_VALUE_LEN_MAX bytes.
+ * @remark Transactional batches are not supported.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_write_batch(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    const struct hse_kvs_batch_op *opv,
+    size_t opc);
+
+/** @brief Opaque structure, a pointer to which is a handle to a bulk load.
+ */
+struct hse_kvs_bulk;
+
+/** @brief Start a bulk load of pre-sorted key-value pairs into a KVS.
+ *
+ * A bulk load streams key-value pairs in strictly ascending key order straight
+ * into the on-media format of the KVS, bypassing the WAL and the in-memory
+ * index. Nothing put into a bulk load is visible until hse_kvs_bulk_commit()
+ * atomically adds the whole load to the KVS, and nothing of it survives a
+ * crash before then. This makes loading a large, sorted data set roughly
+ * write-once rather than having every pair logged, ingested and rewritten.
+ *
+ * Every pair of the load is given a sequence number minted when the load is
+ * created. Hence the load appears older than any mutation made after this
+ * call, and keys in the load must not be updated by anyone else until the
+ * load has been committed. Transactions, snapshots and cursors (including
+ * split cursors) created after this call hold off the commit of the load, see
+ * hse_kvs_bulk_commit().
+ *
+ * @note This function is thread safe. A bulk load itself is not, and must be
+ * used by one thread at a time.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ * @arg HSE_KVS_PUT_VCOMP_OFF - Values will not be compressed.
+ * @arg HSE_KVS_PUT_VCOMP_ON - Values will be compressed.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param[out] bulk: Bulk load handle.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p bulk must not be NULL.
+ * @remark Bulk loads are not supported by transactional or capped KVSs.
+ * @remark The bulk load must be destroyed before @p kvs is closed.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_bulk_create(struct hse_kvs *kvs, unsigned int flags, struct hse_kvs_bulk **bulk);
+
+/** @brief Add the next key-value pair to a bulk load.
+ *
+ * @note This function is not thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ * @arg HSE_KVS_PUT_VCOMP_OFF - Value will not be compressed.
+ * @arg HSE_KVS_PUT_VCOMP_ON - Value will be compressed.
+ *
+ * @param bulk: Bulk load handle.
+ * @param flags: Flags for operation specialization.
+ * @param key: Key to put into the load.
+ * @param key_len: Length of @p key.
+ * @param val: Value associated with @p key.
+ * @param val_len: Length of @p val.
+ *
+ * @remark @p bulk must not be NULL.
+ * @remark @p key must not be NULL.
+ * @remark @p key_len must be within the range of [1, HSE_KVS_KEY_LEN_MAX].
+ * @remark If @p val is NULL, then @p val_len must be 0.
+ * @remark @p val_len must be less than HSE_KVS_VALUE_LEN_MAX.
+ * @remark @p key must be greater than every key previously put into the load,
+ *         else EINVAL is returned and the load is left as it was. Any other
+ *         error fails the load.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_bulk_put(
+    struct hse_kvs_bulk *bulk,
+    unsigned int flags,
+    const void *key,
+    size_t key_len,
+    const void *val,
+    size_t val_len);
+
+/** @brief Atomically add the contents of a bulk load to its KVS.
+ *
+ * Mutations of the KVS which are held in memory are first made durable, so
+ * committing a load may take a while on a busy KVDB. Either the whole load
+ * becomes visible or, if an error is returned, none of it does.
+ *
+ * A load cannot become visible to a view which already exists without
+ * breaking the view's consistency, yet its sequence number makes it visible to
+ * every view created after hse_kvs_bulk_create(). Hence the commit fails with
+ * EBUSY while any transaction, snapshot or cursor (including split cursors)
+ * created after hse_kvs_bulk_create() is still open. The load is kept and the
+ * commit may be retried once they are gone. Views created once the commit has
+ * returned see the whole load. Reads made without a view concurrently with the
+ * commit may or may not see the load.
+ *
+ * The commit fails with ECANCELED, and so does the load, if keys within the
+ * range of the load were updated or range deleted after hse_kvs_bulk_create(),
+ * as the load would otherwise hide or be deleted by mutations newer than
+ * itself.
+ *
+ * @note This function is not thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param bulk: Bulk load handle.
+ * @param flags: Flags for operation specialization.
+ *
+ * @remark @p bulk must not be NULL.
+ * @remark A bulk load can be committed at most once.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_bulk_commit(struct hse_kvs_bulk *bulk, unsigned int flags);
+
+/** @brief Destroy a bulk load.
+ *
+ * A bulk load which has not been committed is discarded.
+ *
+ * @note This function is not thread safe.
+ *
+ * @param bulk: Bulk load handle (may be NULL).
+ */
+void
+hse_kvs_bulk_destroy(struct hse_kvs_bulk *bulk);
+
+/** @brief Merge operator callback.
+ *
+ * Computes the new value of a key from its current value and a merge operand
+ * passed to hse_kvs_merge(). The callback is invoked without any HSE locks
+ * held, but it may be invoked more than once per merge if the key is updated
+ * concurrently, so it must be a pure function of its arguments.
+ *
+ * If the new value is longer than @p valbuf_sz, the callback must set
+ * @p val_len to its length and return zero without writing @p valbuf. It is
+ * then invoked again with a buffer large enough to hold the new value.
+ *
+ * @param arg: Argument given to hse_kvs_merge_register().
+ * @param key: Key being merged.
+ * @param key_len: Length of @p key.
+ * @param base: Current value of the key, or NULL if the key has no value.
+ * @param base_len: Length of @p base.
+ * @param operand: Merge operand given to hse_kvs_merge().
+ * @param operand_len: Length of @p operand.
+ * @param valbuf: Buffer to receive the new value.
+ * @param valbuf_sz: Size of @p valbuf.
+ * @param[out] val_len: Length of the new value, at most HSE_KVS_VALUE_LEN_MAX.
+ *
+ * @returns Zero on success, otherwise an errno value which fails the merge and
+ *          is returned by hse_kvs_merge().
+ */
+typedef int
+hse_kvs_merge_fn(
+    void *arg,
+    const void *key,
+    size_t key_len,
+    const void *base,
+    size_t base_len,
+    const void *operand,
+    size_t operand_len,
+    void *valbuf,
+    size_t valbuf_sz,
+    size_t *val_len);
+
+/** @brief Register the merge operator of a KVS.
+ *
+ * The merge operator is not persistent and must be registered each time the
+ * KVS is opened, before the first call to hse_kvs_merge(). It can be
+ * registered only once per open.
+ *
+ * @note This function is thread safe.
+ *
+ * @param kvs: KVS handle.
+ * @param fn: Merge operator callback.
+ * @param arg: Argument passed to @p fn.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p fn must not be NULL.
+ *
+ * @returns Error status. EEXIST if a merge operator is already registered.
+ */
+hse_err_t
+hse_kvs_merge_register(struct hse_kvs *kvs, hse_kvs_merge_fn *fn, void *arg);
+
+/** @brief Merge an operand into the value of a key.
+ *
+ * Atomically replaces the value of @p key with the result of applying the
+ * KVS's merge operator to its current value and @p operand, with respect to
+ * other calls to hse_kvs_merge(), hse_kvs_put() and hse_kvs_delete() on the
+ * same key. This makes read-modify-write updates such as counters possible
+ * without a transaction or an application level lock.
+ *
+ * Merges are resolved eagerly: the merged value is written as if by
+ * hse_kvs_put(), so readers and cursors see ordinary values. A merge into a
+ * recently written key costs no more than a put, while the first merge into
+ * a key that is not in memory must first read its current value. Operands
+ * are never stored for readers or compaction to apply later.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ * @arg HSE_KVS_PUT_PRIO - Operation will not be throttled.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param key: Key to merge into.
+ * @param key_len: Length of @p key.
+ * @param operand: Merge operand.
+ * @param operand_len: Length of @p operand.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p key must not be NULL.
+ * @remark @p key_len must be within the range of [1, HSE_KVS_KEY_LEN_MAX].
+ * @remark @p operand must not be NULL unless @p operand_len is 0.
+ * @remark @p operand_len must be at most HSE_KVS_VALUE_LEN_MAX.
+ * @remark A merge operator must have been registered on @p kvs.
+ * @remark Merges into transaction enabled KVSs are not supported.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_merge(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    const void *key,
+    size_t key_len,
+    const void *operand,
+    size_t operand_len);
+
+/** @brief Put a key-value pair that expires after a given time.
+ *
+ * Like hse_kvs_put(), except that the value expires @p ttl seconds after
+ * the call is made, after which the key reads as if it had been deleted.
+ * Expired values are physically removed by compaction, which the compaction
+ * scheduler prioritizes for nodes estimated to hold many expired values.
+ *
+ * Expiration is based on the wall clock, with a granularity of one second.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ * @arg HSE_KVS_PUT_PRIO - Operation will not be throttled.
+ * @arg HSE_KVS_PUT_VCOMP_OFF - Value will not be compressed.
+ * @arg HSE_KVS_PUT_VCOMP_ON - Value may be compressed.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param txn: Transaction context (optional).
+ * @param key: Key to put into kvs.
+ * @param key_len: Length of @p key.
+ * @param val: Value associated with @p key (optional).
+ * @param val_len: Length of @p value.
+ * @param ttl: Time to live of the value, in seconds.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p key must not be NULL.
+ * @remark @p key_len must be within the range of [1, HSE_KVS_KEY_LEN_MAX].
+ * @remark @p val must not be NULL unless @p val_len is 0.
+ * @remark @p val_len must be at most HSE_KVS_VALUE_LEN_MAX.
+ * @remark @p ttl must be greater than zero.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_put_ttl(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_txn *txn,
+    const void *key,
+    size_t key_len,
+    const void *val,
+    size_t val_len,
+    uint64_t ttl);
+
+/** @brief Retrieve the value for a given key as of a read snapshot.
+ *
+ * Like hse_kvs_get(), except that the lookup is made in the view of @p snap
+ * rather than in the current view of the KVS.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param snap: Snapshot handle.
+ * @param key: Key.
+ * @param key_len: Length of @p key.
+ * @param[out] found: Whether or not @p key was found.
+ * @param[in,out] valbuf: Buffer into which the value associated with @p key
+ * will be copied (optional).
+ * @param valbuf_sz: Size of @p valbuf.
+ * @param[out] val_len: Actual length of value if @p key was found.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p snap must not be NULL and must belong to the KVDB of @p kvs.
+ * @remark @p key must not be NULL.
+ * @remark @p key_len must be within the range of [1, HSE_KVS_KEY_LEN_MAX].
+ * @remark @p found must not be NULL.
+ * @remark @p val_len must not be NULL.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_snapshot_get(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    const void *key,
+    size_t key_len,
+    bool *found,
+    void *valbuf,
+    size_t valbuf_sz,
+    size_t *val_len);
+
+/** @brief Probe for a prefix as of a read snapshot.
+ *
+ * Like hse_kvs_prefix_probe(), except that the probe is made in the view of
+ * @p snap rather than in the current view of the KVS.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param snap: Snapshot handle.
+ * @param pfx: Prefix.
+ * @param pfx_len: Length of @p pfx.
+ * @param[out] found: Zero, one or multiple matches seen.
+ * @param[in,out] keybuf: Buffer which will be populated with contents of first
+ * seen key.
+ * @param keybuf_sz: Size of @p keybuf.
+ * @param[out] key_len: Length of first seen key.
+ * @param[in,out] valbuf: Buffer which will be populated with value for @p
+ * keybuf.
+ * @param valbuf_sz: Size of @p valbuf.
+ * @param[out] val_len: Length of the value seen.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p snap must not be NULL and must belong to the KVDB of @p kvs.
+ * @remark @p pfx must not be NULL.
+ * @remark @p pfx_len must be within the range of [1, HSE_KVS_PFX_LEN_MAX].
+ * @remark @p found must not be NULL.
+ * @remark @p keybuf_sz must be equal to HSE_KVS_KEY_LEN_MAX.
+ * @remark @p val_len must not be NULL.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_snapshot_prefix_probe(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    const void *pfx,
+    size_t pfx_len,
+    enum hse_kvs_pfx_probe_cnt *found,
+    void *keybuf,
+    size_t keybuf_sz,
+    size_t *key_len,
+    void *valbuf,
+    size_t valbuf_sz,
+    size_t *val_len);
+
+/** @brief Create a cursor over the view of a read snapshot.
+ *
+ * Like a non-transactional hse_kvs_cursor_create(), except that the cursor's
+ * view is that of @p snap.  Calling hse_kvs_cursor_update_view() on such a
+ * cursor is a no-op and has no effect on its view.  The cursor may outlive
+ * the snapshot.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg HSE_CURSOR_CREATE_REV - Iterate in reverse lexicographical order.
+ * @arg HSE_CURSOR_CREATE_KEYS_ONLY - Do not read values.
+ * @arg HSE_CURSOR_CREATE_VLEN_ONLY - Do not read values, only their lengths.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param snap: Snapshot handle.
+ * @param filter: Iteration limited to keys matching this prefix filter.
+ * (optional).
+ * @param filter_len: Length of filter (optional).
+ * @param[out] cursor: Cursor handle.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p snap must not be NULL and must belong to the KVDB of @p kvs.
+ * @remark @p cursor must not be NULL.
+ *
+ * @returns Error status
+ */
+hse_err_t
+hse_kvs_snapshot_cursor_create(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    const void *filter,
+    size_t filter_len,
+    struct hse_kvs_cursor **cursor);
+
+/** @brief Create cursors which scan a key range in parallel.
+ *
+ * Splits the closed interval [@p filt_min, @p filt_max] into up to
+ * @p cursorc contiguous, non-overlapping parts and creates one forward
+ * cursor per part.  Split points are chosen from the layout of the KVS on
+ * media so that each part holds roughly the same number of keys.  All the
+ * cursors share a single view, so together they return exactly the keys a
+ * single cursor over the whole range would, and each may be read from a
+ * different thread.
+ *
+ * Each cursor is created positioned at the start of its part, as if by
+ * hse_kvs_cursor_seek_range().  Seeking a cursor replaces its bounds.
+ * Fewer cursors than requested are created if the range cannot be split
+ * further, for example when most of its keys have not yet been ingested
+ * into the media resident part of the KVS.
+ *
+ * @note This function is thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg HSE_CURSOR_CREATE_KEYS_ONLY - Do not read values.
+ * @arg HSE_CURSOR_CREATE_VLEN_ONLY - Do not read values, only their lengths.
+ *
+ * @param kvs: KVS handle.
+ * @param flags: Flags for operation specialization.
+ * @param filt_min: Start of the range (optional).
+ * @param filt_min_len: Length of @p filt_min, 0 for the start of the KVS.
+ * @param filt_max: End of the range, inclusive (optional).
+ * @param filt_max_len: Length of @p filt_max, 0 for the end of the KVS.
+ * @param[in,out] cursorc: Maximum number of cursors to create, set to the
+ * number of cursors created.
+ * @param[out] cursorv: Array of at least @p cursorc cursor handles, in key
+ * order of their parts.
+ *
+ * @remark @p kvs must not be NULL.
+ * @remark @p cursorc must not be NULL and must point to a non-zero count.
+ * @remark @p cursorv must not be NULL.
+ * @remark Each cursor must be destroyed with hse_kvs_cursor_destroy().
+ *
+ * @returns Error status
+ */
+hse_err_t
+hse_kvs_cursor_split_create(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    const void *filt_min,
+    size_t filt_min_len,
+    const void *filt_max,
+    size_t filt_max_len,
+    unsigned int *cursorc,
+    struct hse_kvs_cursor **cursorv);
+
+/** @brief Descriptor for one key-value pair returned by hse_kvs_cursor_read_batch(). */
+struct hse_kvs_cursor_kv {
+    const void *key; /**< Key, within the caller's buffer. */
+    size_t key_len;  /**< Length of @p key. */
+    const void *val; /**< Value, within the caller's buffer. */
+    size_t val_len;  /**< Length of @p val. */
+};
+
+/** @brief Iteratively read a batch of key-value pairs from a cursor.
+ *
+ * Semantically equivalent to calling hse_kvs_cursor_read_copy() up to
+ * @p kvc times, but the per-call work of validating arguments, refreshing a
+ * transaction bound cursor and updating statistics is done once per batch.
+ * Keys and values are copied back to back into @p buf, and each element of
+ * @p kvv is filled in to point at one pair within @p buf, in cursor order.
+ *
+ * Reading stops once @p kvc pairs have been read, the end of the cursor is
+ * reached, or @p buf cannot hold the next pair, in which case that pair is
+ * returned by the next read.
+ *
+ * @note This function is not thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param cursor: Cursor handle.
+ * @param flags: Flags for operation specialization.
+ * @param buf: Buffer into which keys and values will be copied.
+ * @param buf_sz: Size of @p buf.
+ * @param[out] kvv: Array of pair descriptors.
+ * @param[in,out] kvc: Number of elements in @p kvv, set to the number of
+ * pairs read.
+ * @param[out] eof: If true, the end of the cursor has been reached.
+ *
+ * @remark @p cursor must not be NULL.
+ * @remark @p buf, @p kvv and @p kvc must not be NULL.
+ * @remark @p eof must not be NULL.
+ *
+ * @returns Error status. EMSGSIZE if @p buf cannot hold even the first pair.
+ */
+hse_err_t
+hse_kvs_cursor_read_batch(
+    struct hse_kvs_cursor *cursor,
+    unsigned int flags,
+    void *buf,
+    size_t buf_sz,
+    struct hse_kvs_cursor_kv *kvv,
+    size_t *kvc,
+    bool *eof);
+
+/** @brief Key predicate for hse_kvs_cursor_filter_set().
+ *
+ * @param arg: Argument given to hse_kvs_cursor_filter_set().
+ * @param key: Key under consideration.
+ * @param key_len: Length of @p key.
+ *
+ * @returns True to return the key, false to skip it.
+ */
+typedef bool
+hse_kvs_cursor_filter_fn(void *arg, const void *key, size_t key_len);
+
+/** @brief Install a key predicate that the cursor evaluates as it scans.
+ *
+ * Keys for which @p filter returns false are skipped by the cursor.  The
+ * predicate is evaluated within each of the KVS's internal layers before
+ * their contents are merged, so rejected keys never have their values
+ * read from media.  Hence @p filter may be called more than once for the
+ * same key, possibly for keys outside the cursor's view, and it must be a
+ * pure function of the key.
+ *
+ * The predicate applies from the cursor's current position and persists
+ * across seeks and updates.  Passing a NULL @p filter removes it.
+ *
+ * @note This function is not thread safe.
+ *
+ * <b>Flags:</b>
+ * @arg 0 - Reserved for future use.
+ *
+ * @param cursor: Cursor handle.
+ * @param flags: Flags for operation specialization.
+ * @param filter: Key predicate, or NULL.
+ * @param arg: Argument passed to @p filter.
+ *
+ * @remark @p cursor must not be NULL.
+ *
+ * @returns Error status.
+ */
+hse_err_t
+hse_kvs_cursor_filter_set(
+    struct hse_kvs_cursor *cursor,
+    unsigned int flags,
+    hse_kvs_cursor_filter_fn *filter,
+    void *arg);
+
 /**@} KVS */
 
 #pragma GCC visibility pop
@@ -235,4 +235,21 @@ enum kvdb_perfc_sidx_sts_queues {
     PERFC_EN_STS
 };
 
+enum kvdb_perfc_sidx_vbcache {
+    PERFC_RA_VBCACHE_HIT,
+    PERFC_RA_VBCACHE_MISS,
+    PERFC_RA_VBCACHE_INSERT,
+    PERFC_RA_VBCACHE_EVICT,
+    PERFC_EN_VBCACHE
+};
+
+enum kvdb_perfc_sidx_rcache {
+    PERFC_RA_RCACHE_HIT,
+    PERFC_RA_RCACHE_MISS,
+    PERFC_RA_RCACHE_INSERT,
+    PERFC_RA_RCACHE_STALE,
+    PERFC_RA_RCACHE_EVICT,
+    PERFC_EN_RCACHE
+};
+
 #endif /* HSE_KVDB_PERFC_API_H */
@@ -40,6 +40,7 @@
 #include <hse/rest/status.h>
 #include <hse/util/err_ctx.h>
 #include <hse/util/event_counter.h>
+#include <hse/util/keycmp.h>
 #include <hse/util/mutex.h>
 #include <hse/util/platform.h>
 #include <hse/util/vlb.h>
@@ -51,10 +52,11 @@
         HSE_KVDB_COMPACT_SAMP_LWM | \
         HSE_KVDB_COMPACT_FULL )
 
-#define HSE_KVDB_SYNC_MASK     (HSE_KVDB_SYNC_ASYNC)
-#define HSE_KVS_PUT_MASK       (HSE_KVS_PUT_PRIO | HSE_KVS_PUT_VCOMP_OFF | HSE_KVS_PUT_VCOMP_ON)
-#define HSE_KVS_PUT_VCOMP_MASK (HSE_KVS_PUT_VCOMP_OFF | HSE_KVS_PUT_VCOMP_ON)
-#define HSE_CURSOR_CREATE_MASK (HSE_CURSOR_CREATE_REV)
+#define HSE_KVDB_SYNC_MASK           (HSE_KVDB_SYNC_ASYNC)
+#define HSE_KVS_PUT_MASK             (HSE_KVS_PUT_PRIO | HSE_KVS_PUT_VCOMP_OFF | HSE_KVS_PUT_VCOMP_ON)
+#define HSE_KVS_PUT_VCOMP_MASK       (HSE_KVS_PUT_VCOMP_OFF | HSE_KVS_PUT_VCOMP_ON)
+#define HSE_CURSOR_CREATE_NOVAL_MASK (HSE_CURSOR_CREATE_KEYS_ONLY | HSE_CURSOR_CREATE_VLEN_ONLY)
+#define HSE_CURSOR_CREATE_MASK       (HSE_CURSOR_CREATE_REV | HSE_CURSOR_CREATE_NOVAL_MASK)
 
 /* clang-format on */
 
@@ -1234,11 +1236,12 @@ hse_kvs_put(
     return err;
 }
 
-hse_err_t
-hse_kvs_get(
+static hse_err_t
+kvs_get_impl(
     struct hse_kvs *handle,
     const unsigned int flags,
     struct hse_kvdb_txn * const txn,
+    struct hse_kvdb_snapshot *snap,
     const void *key,
     size_t key_len,
     bool *found,
@@ -1274,7 +1277,10 @@ hse_kvs_get(
     kvs_ktuple_init_nohash(&kt, key, key_len);
     kvs_buf_init(&vbuf, valbuf, valbuf_sz);
 
-    err = ikvdb_kvs_get(handle, flags, txn, &kt, &res, &vbuf);
+    if (snap)
+        err = ikvdb_kvs_snapshot_get(handle, flags, snap, &kt, &res, &vbuf);
+    else
+        err = ikvdb_kvs_get(handle, flags, txn, &kt, &res, &vbuf);
     if (ev(err))
         return err;
 
@@ -1293,6 +1299,166 @@ hse_kvs_get(
     return 0;
 }
 
+hse_err_t
+hse_kvs_get(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    const void *key,
+    size_t key_len,
+    bool *found,
+    void *valbuf,
+    size_t valbuf_sz,
+    size_t *val_len)
+{
+    return kvs_get_impl(handle, flags, txn, NULL, key, key_len, found, valbuf, valbuf_sz, val_len);
+}
+
+hse_err_t
+hse_kvs_snapshot_get(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    const void *key,
+    size_t key_len,
+    bool *found,
+    void *valbuf,
+    size_t valbuf_sz,
+    size_t *val_len)
+{
+    if (HSE_UNLIKELY(!snap))
+        return merr(EINVAL);
+
+    return kvs_get_impl(handle, flags, NULL, snap, key, key_len, found, valbuf, valbuf_sz, val_len);
+}
+
+hse_err_t
+hse_kvs_get_threaded(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    const void *key,
+    size_t key_len,
+    void *valbuf,
+    size_t valbuf_sz,
+    hse_kvs_get_cb *cb,
+    void *arg)
+{
+    struct kvs_ktuple kt;
+    struct kvs_buf vbuf;
+    merr_t err;
+
+    if (HSE_UNLIKELY(!handle || !key || !cb || flags != 0))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(!valbuf && valbuf_sz > 0))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(key_len > HSE_KVS_KEY_LEN_MAX))
+        return merr(ENAMETOOLONG);
+
+    if (HSE_UNLIKELY(key_len == 0))
+        return merr(ENOENT);
+
+    /* Same probe semantics as hse_kvs_get() for a NULL valbuf. */
+    if (!valbuf && valbuf_sz == 0)
+        valbuf = (void *)-1;
+
+    kvs_ktuple_init_nohash(&kt, key, key_len);
+    kvs_buf_init(&vbuf, valbuf, valbuf_sz);
+
+    err = ikvdb_kvs_get_threaded(handle, flags, &kt, &vbuf, cb, arg);
+    if (ev(err))
+        return err;
+
+    PERFC_INC_RU(&kvdb_pc, PERFC_RA_KVDBOP_KVS_GET);
+
+    return 0;
+}
+
+hse_err_t
+hse_kvs_get_multi(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    struct hse_kvs_get_desc *descv,
+    size_t descc)
+{
+    struct kvs_ktuple *ktv;
+    struct kvs_buf *vbufv;
+    enum key_lookup_res *resv;
+    size_t vlen = 0;
+    merr_t err;
+    void *mem;
+
+    if (HSE_UNLIKELY(!handle || (!descv && descc > 0) || flags != 0))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(descc > UINT_MAX))
+        return merr(EINVAL);
+
+    if (descc == 0)
+        return 0;
+
+    for (size_t i = 0; i < descc; i++) {
+        const struct hse_kvs_get_desc *desc = descv + i;
+
+        if (HSE_UNLIKELY(!desc->key || (!desc->valbuf && desc->valbuf_sz > 0)))
+            return merr(EINVAL);
+
+        if (HSE_UNLIKELY(desc->key_len > HSE_KVS_KEY_LEN_MAX))
+            return merr(ENAMETOOLONG);
+
+        if (HSE_UNLIKELY(desc->key_len == 0))
+            return merr(ENOENT);
+    }
+
+    mem = malloc(descc * (sizeof(*ktv) + sizeof(*vbufv) + sizeof(*resv)));
+    if (ev(!mem))
+        return merr(ENOMEM);
+
+    ktv = mem;
+    vbufv = (void *)(ktv + descc);
+    resv = (void *)(vbufv + descc);
+
+    for (size_t i = 0; i < descc; i++) {
+        struct hse_kvs_get_desc *desc = descv + i;
+        void *valbuf = desc->valbuf;
+
+        /* Same probe semantics as hse_kvs_get() for a NULL valbuf. */
+        if (!valbuf && desc->valbuf_sz == 0)
+            valbuf = (void *)-1;
+
+        kvs_ktuple_init_nohash(ktv + i, desc->key, desc->key_len);
+        kvs_buf_init(vbufv + i, valbuf, desc->valbuf_sz);
+    }
+
+    err = ikvdb_kvs_get_multi(handle, flags, txn, descc, ktv, resv, vbufv);
+    if (ev(err))
+        goto out;
+
+    for (size_t i = 0; i < descc; i++) {
+        struct hse_kvs_get_desc *desc = descv + i;
+
+        if (ev(resv[i] == FOUND_MULTIPLE)) {
+            err = merr(EPROTO);
+            goto out;
+        }
+
+        desc->found = (resv[i] == FOUND_VAL);
+        desc->val_len = vbufv[i].b_len;
+
+        if (desc->found)
+            vlen += desc->val_len;
+    }
+
+    perfc_add2(&kvdb_pc, PERFC_RA_KVDBOP_KVS_GET, descc, PERFC_RA_KVDBOP_KVS_GETB, vlen);
+
+out:
+    free(mem);
+
+    return err;
+}
+
 /**
  * hse_kvs_delete() - remove the supplied key and associated value from the KVS
  */
@@ -1327,11 +1493,12 @@ hse_kvs_delete(
     return err;
 }
 
-hse_err_t
-hse_kvs_prefix_probe(
+static hse_err_t
+kvs_prefix_probe_impl(
     struct hse_kvs *handle,
     const unsigned int flags,
     struct hse_kvdb_txn * const txn,
+    struct hse_kvdb_snapshot *snap,
     const void *pfx,
     size_t pfx_len,
     enum hse_kvs_pfx_probe_cnt *found,
@@ -1370,7 +1537,10 @@ hse_kvs_prefix_probe(
     kvs_buf_init(&kbuf, keybuf, keybuf_sz);
     kvs_buf_init(&vbuf, valbuf, valbuf_sz);
 
-    err = ikvdb_kvs_pfx_probe(handle, flags, txn, &kt, &res, &kbuf, &vbuf);
+    if (snap)
+        err = ikvdb_kvs_snapshot_pfx_probe(handle, flags, snap, &kt, &res, &kbuf, &vbuf);
+    else
+        err = ikvdb_kvs_pfx_probe(handle, flags, txn, &kt, &res, &kbuf, &vbuf);
     if (err)
         return err;
 
@@ -1402,6 +1572,49 @@ hse_kvs_prefix_probe(
     return 0;
 }
 
+hse_err_t
+hse_kvs_prefix_probe(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    const void *pfx,
+    size_t pfx_len,
+    enum hse_kvs_pfx_probe_cnt *found,
+    void *keybuf,
+    size_t keybuf_sz,
+    size_t *key_len,
+    void *valbuf,
+    size_t valbuf_sz,
+    size_t *val_len)
+{
+    return kvs_prefix_probe_impl(
+        handle, flags, txn, NULL, pfx, pfx_len, found, keybuf, keybuf_sz, key_len, valbuf,
+        valbuf_sz, val_len);
+}
+
+hse_err_t
+hse_kvs_snapshot_prefix_probe(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    const void *pfx,
+    size_t pfx_len,
+    enum hse_kvs_pfx_probe_cnt *found,
+    void *keybuf,
+    size_t keybuf_sz,
+    size_t *key_len,
+    void *valbuf,
+    size_t valbuf_sz,
+    size_t *val_len)
+{
+    if (HSE_UNLIKELY(!snap))
+        return merr(EINVAL);
+
+    return kvs_prefix_probe_impl(
+        handle, flags, NULL, snap, pfx, pfx_len, found, keybuf, keybuf_sz, key_len, valbuf,
+        valbuf_sz, val_len);
+}
+
 hse_err_t
 hse_kvs_prefix_delete(
     struct hse_kvs *handle,
@@ -1434,6 +1647,284 @@ hse_kvs_prefix_delete(
     return err;
 }
 
+hse_err_t
+hse_kvs_write_batch(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    const struct hse_kvs_batch_op *opv,
+    size_t opc)
+{
+    struct kvs_batch_op *bopv;
+    size_t bytes = 0;
+    merr_t err;
+
+    if (HSE_UNLIKELY(
+            !handle || (!opv && opc > 0) || flags & ~HSE_KVS_PUT_MASK ||
+            (flags & HSE_KVS_PUT_VCOMP_MASK) == HSE_KVS_PUT_VCOMP_MASK))
+        return merr(EINVAL);
+
+    if (opc == 0)
+        return 0;
+
+    for (size_t i = 0; i < opc; i++) {
+        const struct hse_kvs_batch_op *op = opv + i;
+
+        if (HSE_UNLIKELY(!op->key))
+            return merr(EINVAL);
+
+        if (HSE_UNLIKELY(op->type != HSE_KVS_BATCH_PUT && op->type != HSE_KVS_BATCH_DELETE))
+            return merr(EINVAL);
+
+        if (HSE_UNLIKELY(op->key_len > HSE_KVS_KEY_LEN_MAX))
+            return merr(ENAMETOOLONG);
+
+        if (HSE_UNLIKELY(op->key_len == 0))
+            return merr(ENOENT);
+
+        if (op->type == HSE_KVS_BATCH_PUT) {
+            if (HSE_UNLIKELY(op->val_len > 0 && !op->val))
+                return merr(EINVAL);
+
+            if (HSE_UNLIKELY(op->val_len > HSE_KVS_VALUE_LEN_MAX))
+                return merr(EMSGSIZE);
+        }
+    }
+
+    bopv = malloc(opc * sizeof(*bopv));
+    if (ev(!bopv))
+        return merr(ENOMEM);
+
+    for (size_t i = 0; i < opc; i++) {
+        const struct hse_kvs_batch_op *op = opv + i;
+        struct kvs_batch_op *bop = bopv + i;
+
+        kvs_ktuple_init_nohash(&bop->bo_kt, op->key, op->key_len);
+        bop->bo_del = (op->type == HSE_KVS_BATCH_DELETE);
+
+        if (bop->bo_del) {
+            kvs_vtuple_init(&bop->bo_vt, NULL, 0);
+        } else {
+            kvs_vtuple_init(&bop->bo_vt, (void *)op->val, op->val_len);
+            bytes += op->val_len;
+        }
+
+        bytes += op->key_len;
+    }
+
+    err = ikvdb_kvs_write_batch(handle, flags, opc, bopv);
+    ev(err);
+
+    free(bopv);
+
+    if (!err)
+        PERFC_INCADD_RU(&kvdb_pc, PERFC_RA_KVDBOP_KVS_PUT, PERFC_RA_KVDBOP_KVS_PUTB, bytes);
+
+    return err;
+}
+
+hse_err_t
+hse_kvs_bulk_create(struct hse_kvs *handle, const unsigned int flags, struct hse_kvs_bulk **bulk)
+{
+    merr_t err;
+
+    if (HSE_UNLIKELY(
+            !handle || !bulk || flags & ~HSE_KVS_PUT_MASK ||
+            (flags & HSE_KVS_PUT_VCOMP_MASK) == HSE_KVS_PUT_VCOMP_MASK))
+        return merr(EINVAL);
+
+    err = ikvdb_kvs_bulk_create(handle, flags, bulk);
+    ev(err);
+
+    return err;
+}
+
+hse_err_t
+hse_kvs_bulk_put(
+    struct hse_kvs_bulk *bulk,
+    const unsigned int flags,
+    const void *key,
+    size_t key_len,
+    const void *val,
+    size_t val_len)
+{
+    struct kvs_ktuple kt;
+    struct kvs_vtuple vt;
+    merr_t err;
+
+    if (HSE_UNLIKELY(
+            !bulk || !key || (val_len > 0 && !val) || flags & ~HSE_KVS_PUT_MASK ||
+            (flags & HSE_KVS_PUT_VCOMP_MASK) == HSE_KVS_PUT_VCOMP_MASK))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(key_len > HSE_KVS_KEY_LEN_MAX))
+        return merr(ENAMETOOLONG);
+
+    if (HSE_UNLIKELY(key_len == 0))
+        return merr(ENOENT);
+
+    if (HSE_UNLIKELY(val_len > HSE_KVS_VALUE_LEN_MAX))
+        return merr(EMSGSIZE);
+
+    kvs_ktuple_init_nohash(&kt, key, key_len);
+    kvs_vtuple_init(&vt, (void *)val, val_len);
+
+    err = ikvdb_kvs_bulk_put(bulk, flags, &kt, &vt);
+    ev(err);
+
+    if (!err)
+        PERFC_INCADD_RU(
+            &kvdb_pc, PERFC_RA_KVDBOP_KVS_PUT, PERFC_RA_KVDBOP_KVS_PUTB, key_len + val_len);
+
+    return err;
+}
+
+hse_err_t
+hse_kvs_bulk_commit(struct hse_kvs_bulk *bulk, const unsigned int flags)
+{
+    merr_t err;
+
+    if (HSE_UNLIKELY(!bulk || flags))
+        return merr(EINVAL);
+
+    err = ikvdb_kvs_bulk_commit(bulk, flags);
+    ev(err);
+
+    return err;
+}
+
+void
+hse_kvs_bulk_destroy(struct hse_kvs_bulk *bulk)
+{
+    ikvdb_kvs_bulk_destroy(bulk);
+}
+
+hse_err_t
+hse_kvs_merge_register(struct hse_kvs *handle, hse_kvs_merge_fn *fn, void *arg)
+{
+    if (HSE_UNLIKELY(!handle || !fn))
+        return merr(EINVAL);
+
+    return ikvdb_kvs_merge_register(handle, fn, arg);
+}
+
+hse_err_t
+hse_kvs_merge(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    const void *key,
+    size_t key_len,
+    const void *operand,
+    size_t operand_len)
+{
+    struct kvs_ktuple kt;
+    merr_t err;
+
+    if (HSE_UNLIKELY(
+            !handle || !key || (operand_len > 0 && !operand) || flags & ~HSE_KVS_PUT_PRIO))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(key_len > HSE_KVS_KEY_LEN_MAX))
+        return merr(ENAMETOOLONG);
+
+    if (HSE_UNLIKELY(key_len == 0))
+        return merr(ENOENT);
+
+    if (HSE_UNLIKELY(operand_len > HSE_KVS_VALUE_LEN_MAX))
+        return merr(EMSGSIZE);
+
+    kvs_ktuple_init_nohash(&kt, key, key_len);
+
+    err = ikvdb_kvs_merge(handle, flags, &kt, operand, operand_len);
+    ev(err);
+
+    if (!err)
+        PERFC_INCADD_RU(
+            &kvdb_pc, PERFC_RA_KVDBOP_KVS_PUT, PERFC_RA_KVDBOP_KVS_PUTB, key_len + operand_len);
+
+    return err;
+}
+
+hse_err_t
+hse_kvs_put_ttl(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    const void *key,
+    size_t key_len,
+    const void *val,
+    size_t val_len,
+    uint64_t ttl)
+{
+    struct kvs_ktuple kt;
+    struct kvs_vtuple vt;
+    uint64_t now;
+    merr_t err;
+
+    if (HSE_UNLIKELY(
+            !handle || !key || (val_len > 0 && !val) || flags & ~HSE_KVS_PUT_MASK ||
+            (flags & HSE_KVS_PUT_VCOMP_MASK) == HSE_KVS_PUT_VCOMP_MASK))
+        return merr(EINVAL);
+
+    now = kvs_expire_now();
+    if (HSE_UNLIKELY(ttl == 0 || ttl > UINT64_MAX - now))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(key_len > HSE_KVS_KEY_LEN_MAX))
+        return merr(ENAMETOOLONG);
+
+    if (HSE_UNLIKELY(key_len == 0))
+        return merr(ENOENT);
+
+    if (HSE_UNLIKELY(val_len > HSE_KVS_VALUE_LEN_MAX))
+        return merr(EMSGSIZE);
+
+    kvs_ktuple_init_nohash(&kt, key, key_len);
+    kvs_vtuple_init(&vt, (void *)val, val_len);
+    vt.vt_expire = now + ttl;
+
+    err = ikvdb_kvs_put(handle, flags, txn, &kt, &vt);
+    ev(err);
+
+    if (!err)
+        PERFC_INCADD_RU(
+            &kvdb_pc, PERFC_RA_KVDBOP_KVS_PUT, PERFC_RA_KVDBOP_KVS_PUTB, key_len + val_len);
+
+    return err;
+}
+
+hse_err_t
+hse_kvs_range_delete(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    const void *start,
+    size_t start_len,
+    const void *end,
+    size_t end_len)
+{
+    struct kvs_ktuple kt_start, kt_end;
+    merr_t err;
+
+    if (HSE_UNLIKELY(!handle || !start || !end || flags != 0))
+        return merr(EINVAL);
+
+    if (HSE_UNLIKELY(start_len > HSE_KVS_KEY_LEN_MAX || end_len > HSE_KVS_KEY_LEN_MAX))
+        return merr(ENAMETOOLONG);
+
+    if (HSE_UNLIKELY(start_len == 0 || end_len == 0))
+        return merr(ENOENT);
+
+    if (HSE_UNLIKELY(keycmp(start, start_len, end, end_len) >= 0))
+        return merr(EINVAL);
+
+    kvs_ktuple_init_nohash(&kt_start, start, start_len);
+    kvs_ktuple_init_nohash(&kt_end, end, end_len);
+
+    err = ikvdb_kvs_range_delete(handle, flags, &kt_start, &kt_end);
+    ev(err);
+
+    return err;
+}
+
 hse_err_t
 hse_kvdb_sync(struct hse_kvdb *handle, const unsigned int flags)
 {
@@ -1590,11 +2081,12 @@ hse_kvdb_txn_state_get(struct hse_kvdb *handle, struct hse_kvdb_txn *txn)
 
 #define MAX_CUR_TIME (10 * NSEC_PER_SEC)
 
-hse_err_t
-hse_kvs_cursor_create(
+static hse_err_t
+kvs_cursor_create_impl(
     struct hse_kvs *handle,
     const unsigned int flags,
     struct hse_kvdb_txn * const txn,
+    struct hse_kvdb_snapshot *snap,
     const void *prefix,
     size_t pfx_len,
     struct hse_kvs_cursor **cursor)
@@ -1605,10 +2097,16 @@ hse_kvs_cursor_create(
     if (HSE_UNLIKELY(!handle || !cursor || (pfx_len && !prefix) || flags & ~HSE_CURSOR_CREATE_MASK))
         return merr(EINVAL);
 
+    if (HSE_UNLIKELY((flags & HSE_CURSOR_CREATE_NOVAL_MASK) == HSE_CURSOR_CREATE_NOVAL_MASK))
+        return merr(EINVAL);
+
     PERFC_INC_RU(&kvdb_pc, PERFC_RA_KVDBOP_KVS_CURSOR_CREATE);
 
     t_cur = get_time_ns();
-    err = ikvdb_kvs_cursor_create(handle, flags, txn, prefix, pfx_len, cursor);
+    if (snap)
+        err = ikvdb_kvs_snapshot_cursor_create(handle, flags, snap, prefix, pfx_len, cursor);
+    else
+        err = ikvdb_kvs_cursor_create(handle, flags, txn, prefix, pfx_len, cursor);
     ev(err);
 
     t_cur = get_time_ns() - t_cur;
@@ -1618,6 +2116,63 @@ hse_kvs_cursor_create(
     return err;
 }
 
+hse_err_t
+hse_kvs_cursor_create(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    const void *prefix,
+    size_t pfx_len,
+    struct hse_kvs_cursor **cursor)
+{
+    return kvs_cursor_create_impl(handle, flags, txn, NULL, prefix, pfx_len, cursor);
+}
+
+hse_err_t
+hse_kvs_snapshot_cursor_create(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    const void *prefix,
+    size_t pfx_len,
+    struct hse_kvs_cursor **cursor)
+{
+    if (HSE_UNLIKELY(!snap))
+        return merr(EINVAL);
+
+    return kvs_cursor_create_impl(handle, flags, NULL, snap, prefix, pfx_len, cursor);
+}
+
+hse_err_t
+hse_kvs_cursor_split_create(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    const void *filt_min,
+    size_t filt_min_len,
+    const void *filt_max,
+    size_t filt_max_len,
+    unsigned int *cursorc,
+    struct hse_kvs_cursor **cursorv)
+{
+    merr_t err;
+
+    if (HSE_UNLIKELY(
+            !handle || !cursorc || !*cursorc || !cursorv || (filt_min_len && !filt_min) ||
+            (filt_max_len && !filt_max) || filt_min_len > HSE_KVS_KEY_LEN_MAX ||
+            filt_max_len > HSE_KVS_KEY_LEN_MAX || flags & ~HSE_CURSOR_CREATE_NOVAL_MASK ||
+            flags == HSE_CURSOR_CREATE_NOVAL_MASK))
+        return merr(EINVAL);
+
+    PERFC_INC_RU(&kvdb_pc, PERFC_RA_KVDBOP_KVS_CURSOR_CREATE);
+
+    err = ikvdb_kvs_cursor_split_create(
+        handle, flags, filt_min_len ? filt_min : NULL, filt_min_len,
+        filt_max_len ? filt_max : NULL, filt_max_len, cursorc, cursorv);
+    ev(err);
+
+    return err;
+}
+
 hse_err_t
 hse_kvs_cursor_update_view(struct hse_kvs_cursor *cursor, const unsigned int flags)
 {
@@ -1727,6 +2282,56 @@ hse_kvs_cursor_read(
     return err;
 }
 
+hse_err_t
+hse_kvs_cursor_read_batch(
+    struct hse_kvs_cursor *cursor,
+    unsigned int flags,
+    void *buf,
+    size_t buf_sz,
+    struct hse_kvs_cursor_kv *kvv,
+    size_t *kvc,
+    bool *eof)
+{
+    merr_t err;
+
+    if (HSE_UNLIKELY(!cursor || !buf || !kvv || !kvc || !eof || flags != 0))
+        return merr(EINVAL);
+
+    err = ikvdb_kvs_cursor_read_batch(cursor, flags, buf, buf_sz, kvv, kvc, eof);
+    ev(err);
+
+    if (!err && *kvc > 0) {
+        const struct hse_kvs_cursor_kv *last = kvv + *kvc - 1;
+
+        /* Pairs are packed back to back, so the bytes read are the extent
+         * of the buffer up to the end of the last value.
+         */
+        perfc_add2(
+            &kvdb_pc, PERFC_RA_KVDBOP_KVS_CURSOR_READ, *kvc, PERFC_RA_KVDBOP_KVS_GETB,
+            (last->val - buf) + last->val_len);
+    }
+
+    return err;
+}
+
+hse_err_t
+hse_kvs_cursor_filter_set(
+    struct hse_kvs_cursor *cursor,
+    unsigned int flags,
+    hse_kvs_cursor_filter_fn *filter,
+    void *arg)
+{
+    merr_t err;
+
+    if (HSE_UNLIKELY(!cursor || flags != 0))
+        return merr(EINVAL);
+
+    err = ikvdb_kvs_cursor_filter_set(cursor, filter, arg);
+    ev(err);
+
+    return err;
+}
+
 hse_err_t
 hse_kvs_cursor_read_copy(
     struct hse_kvs_cursor *cursor,
@@ -1790,6 +2395,52 @@ hse_kvdb_compact(struct hse_kvdb *handle, unsigned int flags)
     return 0;
 }
 
+hse_err_t
+hse_kvdb_checkpoint(struct hse_kvdb *handle, const char *dest_dir)
+{
+    size_t len;
+    merr_t err;
+
+    if (!handle || !dest_dir)
+        return merr(EINVAL);
+
+    len = strnlen(dest_dir, PATH_MAX);
+    if (len == 0)
+        return merr(EINVAL);
+    if (len == PATH_MAX)
+        return merr(ENAMETOOLONG);
+
+    err = ikvdb_checkpoint((struct ikvdb *)handle, dest_dir);
+    ev(err);
+
+    return err;
+}
+
+hse_err_t
+hse_kvdb_snapshot_create(struct hse_kvdb *handle, struct hse_kvdb_snapshot **snap)
+{
+    merr_t err;
+
+    if (HSE_UNLIKELY(!handle || !snap))
+        return merr(EINVAL);
+
+    err = ikvdb_snapshot_create((struct ikvdb *)handle, snap);
+    ev(err);
+
+    return err;
+}
+
+hse_err_t
+hse_kvdb_snapshot_release(struct hse_kvdb *handle, struct hse_kvdb_snapshot *snap)
+{
+    if (HSE_UNLIKELY(!handle))
+        return merr(EINVAL);
+
+    ikvdb_snapshot_release((struct ikvdb *)handle, snap);
+
+    return 0;
+}
+
 hse_err_t
 hse_kvdb_compact_status_get(struct hse_kvdb *handle, struct hse_kvdb_compact_status *status)
 {
@@ -99,6 +99,46 @@ c0_put(struct c0 *handle, struct kvs_ktuple *kt, const struct kvs_vtuple *vt, ui
     return c0sk_put(self->c0_c0sk, self->c0_index, kt, vt, seqnoref);
 }
 
+merr_t
+c0_write_batch(struct c0 *handle, struct kvs_batch_op *opv, uint cnt, uintptr_t seqnoref)
+{
+    struct c0_impl *self = c0_h2r(handle);
+
+    assert(self->c0_index < HSE_KVS_COUNT_MAX);
+    return c0sk_write_batch(self->c0_c0sk, self->c0_index, opv, cnt, seqnoref);
+}
+
+merr_t
+c0_merge_read(
+    struct c0 *handle,
+    const struct kvs_ktuple *kt,
+    uint64_t *genp,
+    struct kvs_buf *curbuf,
+    enum key_lookup_res *res,
+    struct c0_merge_ver *ver)
+{
+    struct c0_impl *self = c0_h2r(handle);
+
+    assert(self->c0_index < HSE_KVS_COUNT_MAX);
+    return c0sk_merge_read(
+        self->c0_c0sk, self->c0_index, self->c0_pfx_len, kt, genp, curbuf, res, ver);
+}
+
+merr_t
+c0_merge_commit(
+    struct c0 *handle,
+    struct kvs_ktuple *kt,
+    const struct kvs_vtuple *vt,
+    uintptr_t seqnoref,
+    const struct c0_merge_ver *ver)
+{
+    struct c0_impl *self = c0_h2r(handle);
+
+    assert(self->c0_index < HSE_KVS_COUNT_MAX);
+    return c0sk_merge_commit(
+        self->c0_c0sk, self->c0_index, self->c0_pfx_len, kt, vt, seqnoref, ver);
+}
+
 merr_t
 c0_del(struct c0 *handle, struct kvs_ktuple *kt, uintptr_t seqnoref)
 {
@@ -128,7 +168,8 @@ c0_get(
     uint64_t view_seqno,
     uintptr_t seqnoref,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf)
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
 {
     struct c0_impl *self;
 
@@ -136,7 +177,8 @@ c0_get(
 
     assert(self->c0_index < HSE_KVS_COUNT_MAX);
     return c0sk_get(
-        self->c0_c0sk, self->c0_index, self->c0_pfx_len, kt, view_seqno, seqnoref, res, vbuf);
+        self->c0_c0sk, self->c0_index, self->c0_pfx_len, kt, view_seqno, seqnoref, res, vbuf,
+        seqnop);
 }
 
 merr_t
@@ -8,8 +8,8 @@
 #include <hse/ikvdb/c0_kvset.h>
 #include <hse/ikvdb/c0_kvset_iterator.h>
 #include <hse/ikvdb/limits.h>
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/util/bonsai_tree.h>
-#include <hse/util/compression_lz4.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/fmt.h>
 #include <hse/util/keycmp.h>
@@ -589,6 +589,7 @@ c0kvs_put(
 
     bn_skey_init(kt->kt_data, kt->kt_len, kt->kt_flags, skidx, &skey);
     bn_sval_init(vt->vt_data, vt->vt_xlen, seqnoref, &sval);
+    sval.bsv_expire = vt->vt_expire;
 
     return c0kvs_putdel(self, &skey, &sval, &kt->kt_seqno);
 }
@@ -623,6 +624,125 @@ c0kvs_prefix_del(
     return c0kvs_putdel(self, &skey, &sval, &key->kt_seqno);
 }
 
+merr_t
+c0kvs_write_batch(
+    struct c0_kvset *handle,
+    uint16_t skidx,
+    struct kvs_batch_op **opv,
+    uint cnt,
+    uintptr_t seqnoref,
+    uint *donep)
+{
+    struct c0_kvset_impl *self = c0_kvset_h2r(handle);
+    merr_t err = 0;
+    uint i;
+
+    c0kvs_lock(self);
+    for (i = 0; i < cnt; ++i) {
+        struct kvs_batch_op *op = opv[i];
+        struct bonsai_skey skey;
+        struct bonsai_sval sval;
+
+        /* As with c0kvs_del(), tombstone keys are always copied. */
+        if (op->bo_del) {
+            bn_skey_init(op->bo_kt.kt_data, op->bo_kt.kt_len, 0, skidx, &skey);
+            bn_sval_init(HSE_CORE_TOMB_REG, 0, seqnoref, &sval);
+        } else {
+            bn_skey_init(op->bo_kt.kt_data, op->bo_kt.kt_len, op->bo_kt.kt_flags, skidx, &skey);
+            bn_sval_init(op->bo_vt.vt_data, op->bo_vt.vt_xlen, seqnoref, &sval);
+            sval.bsv_expire = op->bo_vt.vt_expire;
+        }
+
+        err = bn_insert_or_replace(self->c0s_broot, &skey, &sval);
+        if (err)
+            break;
+
+        op->bo_kt.kt_seqno = HSE_SQNREF_TO_ORDNL(sval.bsv_seqnoref);
+    }
+    c0kvs_unlock(self);
+
+    /* See c0kvs_putdel(). */
+    assert(atomic_read(&self->c0s_finalized) == 0);
+
+    *donep = i;
+
+    return err;
+}
+
+/* Return the newest value of a key, which identifies the key's version for
+ * c0kvs_merge_commit().  The caller must either hold the c0_kvset lock or be
+ * in an rcu read-side critical section.
+ */
+static const void *
+c0kvs_merge_ver(struct c0_kvset_impl *self, uint16_t skidx, const void *key, uint32_t klen)
+{
+    struct bonsai_skey skey;
+    struct bonsai_kv *kv;
+
+    bn_skey_init(key, klen, 0, skidx, &skey);
+
+    if (!bn_find(self->c0s_broot, &skey, &kv))
+        return NULL;
+
+    return c0kvs_findval(kv, UINT64_MAX, 0);
+}
+
+merr_t
+c0kvs_merge_read(
+    struct c0_kvset *handle,
+    uint16_t skidx,
+    const struct kvs_ktuple *kt,
+    struct kvs_buf *curbuf,
+    enum key_lookup_res *res,
+    uintptr_t *oseqnoref,
+    const void **verp)
+{
+    struct c0_kvset_impl *self = c0_kvset_h2r(handle);
+    merr_t err;
+
+    c0kvs_lock(self);
+    err = c0kvs_get_excl(handle, skidx, kt, UINT64_MAX, 0, res, curbuf, oseqnoref);
+    if (!err)
+        *verp = c0kvs_merge_ver(self, skidx, kt->kt_data, kt->kt_len);
+    c0kvs_unlock(self);
+
+    return err;
+}
+
+merr_t
+c0kvs_merge_commit(
+    struct c0_kvset *handle,
+    uint16_t skidx,
+    struct kvs_ktuple *kt,
+    const struct kvs_vtuple *vt,
+    uintptr_t seqnoref,
+    const void *ver)
+{
+    struct c0_kvset_impl *self = c0_kvset_h2r(handle);
+    struct bonsai_skey skey;
+    struct bonsai_sval sval;
+    merr_t err;
+
+    bn_skey_init(kt->kt_data, kt->kt_len, kt->kt_flags, skidx, &skey);
+    bn_sval_init(vt->vt_data, vt->vt_xlen, seqnoref, &sval);
+    sval.bsv_expire = vt->vt_expire;
+
+    c0kvs_lock(self);
+    if (c0kvs_merge_ver(self, skidx, kt->kt_data, kt->kt_len) == ver) {
+        err = bn_insert_or_replace(self->c0s_broot, &skey, &sval);
+        if (!err)
+            kt->kt_seqno = HSE_SQNREF_TO_ORDNL(sval.bsv_seqnoref);
+    } else {
+        err = merr(ECANCELED);
+    }
+    c0kvs_unlock(self);
+
+    /* See c0kvs_putdel(). */
+    assert(atomic_read(&self->c0s_finalized) == 0);
+
+    return err;
+}
+
 uint64_t
 c0kvs_get_element_count(struct c0_kvset *handle)
 {
@@ -703,7 +823,7 @@ c0kvs_get_excl(
 
     *oseqnoref = val->bv_seqnoref;
 
-    if (HSE_CORE_IS_TOMB(val->bv_value)) {
+    if (HSE_CORE_IS_TOMB(val->bv_value) || kvs_expired(bonsai_val_expire(val))) {
         *res = FOUND_TMB;
         return 0;
     }
@@ -719,8 +839,9 @@ c0kvs_get_excl(
         ulen = bonsai_val_ulen(val);
 
         if (clen > 0) {
-            err = compress_lz4_ops.cop_decompress(
-                val->bv_value, clen, vbuf->b_buf, vbuf->b_buf_sz, &outlen);
+            err = vcomp_decompress(
+                bonsai_val_calgo(val), val->bv_value, clen, vbuf->b_buf, vbuf->b_buf_sz,
+                &outlen);
             if (ev(err))
                 return err;
 
@@ -822,8 +943,8 @@ c0kvs_pfx_probe_cmn(
                 continue;
         }
 
-        /* add to tomblist if a tombstone was encountered */
-        if (HSE_CORE_IS_TOMB(val->bv_value)) {
+        /* add to tomblist if a tombstone (or an expired value) was encountered */
+        if (HSE_CORE_IS_TOMB(val->bv_value) || kvs_expired(bonsai_val_expire(val))) {
             err = qctx_tomb_insert(qctx, kv->bkv_key, klen);
             if (ev(err))
                 break;
@@ -850,8 +971,9 @@ c0kvs_pfx_probe_cmn(
                 ulen = bonsai_val_ulen(val);
 
                 if (clen > 0) {
-                    err = compress_lz4_ops.cop_decompress(
-                        val->bv_value, clen, vbuf->b_buf, vbuf->b_buf_sz, &outlen);
+                    err = vcomp_decompress(
+                        bonsai_val_calgo(val), val->bv_value, clen, vbuf->b_buf,
+                        vbuf->b_buf_sz, &outlen);
                     if (ev(err))
                         return err;
 
@@ -959,6 +1081,18 @@ c0kvs_prefix_get_rcu(
     return c0kvs_prefix_get_excl(handle, skidx, key, view_seqno, seqnoref, pfx_len, oseqnoref);
 }
 
+const void *
+c0kvs_prefix_ver_rcu(
+    struct c0_kvset *handle,
+    uint16_t skidx,
+    const struct kvs_ktuple *key,
+    uint32_t pfx_len)
+{
+    assert(rcu_read_ongoing());
+
+    return c0kvs_merge_ver(c0_kvset_h2r(handle), skidx, key->kt_data, pfx_len);
+}
+
 void
 c0kvs_finalize(struct c0_kvset *handle)
 {
@@ -256,6 +256,72 @@ c0sk_put(
     return err;
 }
 
+merr_t
+c0sk_write_batch(
+    struct c0sk *handle,
+    uint16_t skidx,
+    struct kvs_batch_op *opv,
+    uint cnt,
+    uintptr_t seqnoref)
+{
+    struct c0sk_impl *self = c0sk_h2r(handle);
+    uint64_t start;
+    merr_t err;
+
+    start = perfc_lat_startu(&self->c0sk_pc_op, PERFC_LT_C0SKOP_PUT);
+
+    err = c0sk_putdel_batch(self, skidx, opv, cnt, seqnoref);
+
+    if (start > 0) {
+        perfc_lat_record(&self->c0sk_pc_op, PERFC_LT_C0SKOP_PUT, start);
+        perfc_add(&self->c0sk_pc_op, PERFC_RA_C0SKOP_PUT, cnt);
+    }
+
+    return err;
+}
+
+merr_t
+c0sk_merge_read(
+    struct c0sk *handle,
+    uint16_t skidx,
+    uint32_t pfx_len,
+    const struct kvs_ktuple *kt,
+    uint64_t *genp,
+    struct kvs_buf *curbuf,
+    enum key_lookup_res *res,
+    struct c0_merge_ver *ver)
+{
+    struct c0sk_impl *self = c0sk_h2r(handle);
+
+    return c0sk_getmerge(self, skidx, pfx_len, kt, genp, curbuf, res, ver);
+}
+
+merr_t
+c0sk_merge_commit(
+    struct c0sk *handle,
+    uint16_t skidx,
+    uint32_t pfx_len,
+    struct kvs_ktuple *kt,
+    const struct kvs_vtuple *vt,
+    uintptr_t seqnoref,
+    const struct c0_merge_ver *ver)
+{
+    struct c0sk_impl *self = c0sk_h2r(handle);
+    uint64_t start;
+    merr_t err;
+
+    start = perfc_lat_startu(&self->c0sk_pc_op, PERFC_LT_C0SKOP_PUT);
+
+    err = c0sk_putmerge(self, skidx, pfx_len, kt, vt, seqnoref, ver);
+
+    if (start > 0) {
+        perfc_lat_record(&self->c0sk_pc_op, PERFC_LT_C0SKOP_PUT, start);
+        perfc_inc(&self->c0sk_pc_op, PERFC_RA_C0SKOP_PUT);
+    }
+
+    return err;
+}
+
 merr_t
 c0sk_del(struct c0sk *handle, uint16_t skidx, struct kvs_ktuple *kt, uintptr_t seqnoref)
 {
@@ -296,7 +362,8 @@ c0sk_get(
     uint64_t view_seq,
     uintptr_t seqref,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf)
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
 {
     struct c0_kvmultiset *c0kvms;
     struct c0sk_impl *self;
@@ -352,6 +419,9 @@ c0sk_get(
         vbuf->b_len = 0;
     }
 
+    if (seqnop)
+        *seqnop = (*res == FOUND_PTMB) ? pfx_seq : val_seq;
+
     if (start > 0) {
         perfc_lat_record(&self->c0sk_pc_op, PERFC_LT_C0SKOP_GET, start);
         perfc_inc(&self->c0sk_pc_op, PERFC_RA_C0SKOP_GET);
@@ -1113,11 +1183,14 @@ c0sk_cursor_read(struct c0_cursor *cur, struct kvs_cursor_element *elem, bool *e
         }
 
         if (cur->c0cur_filter) {
-            const void *maxkey = cur->c0cur_filter->kcf_maxkey;
-            size_t maxlen = cur->c0cur_filter->kcf_maxklen;
+            const struct kc_filter *filt = cur->c0cur_filter;
 
-            if (keycmp(bkv->bkv_key, klen, maxkey, maxlen) > 0)
+            if (filt->kcf_maxkey && keycmp(bkv->bkv_key, klen, filt->kcf_maxkey, filt->kcf_maxklen) > 0)
                 break; /* eof */
+
+            /* Any duplicates of a rejected key are rejected in turn. */
+            if (filt->kcf_pred && !is_ptomb && !filt->kcf_pred(filt->kcf_pred_arg, bkv->bkv_key, klen))
+                continue;
         }
 
         val = c0kvs_findval(bkv, cur->c0cur_seqno, seqnoref);
@@ -1205,9 +1278,12 @@ c0sk_cursor_read(struct c0_cursor *cur, struct kvs_cursor_element *elem, bool *e
             kvs_vtuple_init(&elem->kce_vt, val->bv_value, val->bv_xlen);
             if (HSE_CORE_IS_PTOMB(val->bv_value))
                 elem->kce_is_ptomb = true;
+        } else if (kvs_expired(bonsai_val_expire(val))) {
+            kvs_vtuple_init(&elem->kce_vt, HSE_CORE_TOMB_REG, 0);
         } else {
             kvs_vtuple_init(&elem->kce_vt, val->bv_value, bonsai_val_ulen(val));
             elem->kce_complen = bonsai_val_clen(val);
+            elem->kce_calgo = bonsai_val_calgo(val);
         }
 
         *eof = false;
@@ -329,10 +329,20 @@ c0sk_cningest_cb(void *rock, struct bonsai_kv *bkv, struct bonsai_val *vlist)
         else
             seqno_prev = seqno;
 
+        /* Values that expired while in c0 are ingested as tombstones.
+         */
+        if (HSE_UNLIKELY(kvs_expired(bonsai_val_expire(val)))) {
+            err = kvset_builder_add_val(bldr, &ko, HSE_CORE_TOMB_REG, 0, seqno, 0, 0, 0);
+            if (ev(err))
+                return err;
+            continue;
+        }
+
         vlen += bonsai_val_vlen(val);
 
         err = kvset_builder_add_val(
-            bldr, &ko, val->bv_value, bonsai_val_ulen(val), seqno, bonsai_val_clen(val));
+            bldr, &ko, val->bv_value, bonsai_val_ulen(val), seqno, bonsai_val_expire(val),
+            bonsai_val_clen(val), bonsai_val_calgo(val));
 
         if (ev(err))
             return err;
@@ -1342,6 +1352,237 @@ c0sk_putdel(
     return err;
 }
 
+merr_t
+c0sk_putdel_batch(
+    struct c0sk_impl *self,
+    uint32_t skidx,
+    struct kvs_batch_op *opv,
+    uint cnt,
+    uintptr_t seqnoref)
+{
+    struct kvs_batch_op *groupv[HSE_C0SK_BATCH_MAX];
+    merr_t err = 0;
+    uint i, j;
+
+    assert(HSE_SQNREF_SINGLE_P(seqnoref));
+    assert(cnt <= NELEM(groupv));
+
+    for (i = 0; i < cnt; ++i)
+        opv[i].bo_kt.kt_dgen = 0;
+
+    while (1) {
+        struct c0_kvmultiset *dst;
+        uint64_t dst_gen;
+        void *cookie = NULL;
+
+        rcu_read_lock();
+        dst = c0sk_get_first_c0kvms(&self->c0sk_handle);
+        if (ev_warn(!dst)) {
+            rcu_read_unlock();
+            return merr(EINVAL);
+        }
+
+        /* Non-txn mutations must synchronize with c0sk_queue_ingest()
+         * to ensure correct seqno ordering across a kvms switch.
+         */
+        c0sk_ingestref_get(self, false, &cookie);
+
+        if (c0kvms_should_ingest(dst) && atomic_read(&self->c0sk_replaying) == 0) {
+            err = merr(ENOMEM);
+            goto unlock;
+        }
+
+        dst_gen = c0kvms_gen_read(dst);
+
+        /* Gather the remaining ops that hash to the same c0kvset as op i
+         * (preserving their order so that the last op on a key wins) and
+         * insert them all under a single acquisition of the c0kvset lock.
+         */
+        for (i = 0; i < cnt && !err; ++i) {
+            struct c0_kvset *kvs;
+            uint n = 0, done = 0;
+
+            if (opv[i].bo_kt.kt_dgen)
+                continue;
+
+            kvs = c0kvms_get_hashed_c0kvset(dst, opv[i].bo_kt.kt_hash);
+
+            for (j = i; j < cnt; ++j) {
+                if (opv[j].bo_kt.kt_dgen)
+                    continue;
+
+                if (c0kvms_get_hashed_c0kvset(dst, opv[j].bo_kt.kt_hash) == kvs)
+                    groupv[n++] = opv + j;
+            }
+
+            err = c0kvs_write_batch(kvs, skidx, groupv, n, seqnoref, &done);
+
+            for (j = 0; j < done; ++j)
+                groupv[j]->bo_kt.kt_dgen = dst_gen;
+        }
+
+        assert(!c0kvms_is_finalized(dst));
+
+    unlock:
+        c0sk_ingestref_put(self, cookie);
+
+        if (merr_errno(err) == ENOMEM)
+            c0kvms_getref(dst);
+
+        rcu_read_unlock();
+
+        if (merr_errno(err) != ENOMEM)
+            break;
+
+        /* The kvms filled up part way through the batch, switch to a new
+         * one and insert the remaining ops there.
+         */
+        c0sk_queue_ingest(self, dst);
+        c0kvms_putref(dst);
+        err = 0;
+    }
+
+    return err;
+}
+
+merr_t
+c0sk_getmerge(
+    struct c0sk_impl *self,
+    uint32_t skidx,
+    uint32_t pfx_len,
+    const struct kvs_ktuple *kt,
+    uint64_t *genp,
+    struct kvs_buf *curbuf,
+    enum key_lookup_res *res,
+    struct c0_merge_ver *ver)
+{
+    struct c0_kvmultiset *dst;
+    struct c0_kvset *kvs;
+    uintptr_t ptomb_seqref = 0, oseqnoref;
+    merr_t err = 0;
+
+    if (kt->kt_len < pfx_len)
+        pfx_len = 0;
+
+    ver->mv_ptomb = NULL;
+
+    rcu_read_lock();
+    dst = c0sk_get_first_c0kvms(&self->c0sk_handle);
+    if (ev_warn(!dst)) {
+        rcu_read_unlock();
+        return merr(EINVAL);
+    }
+
+    /* The caller may have based its view of older data on this kvms
+     * being the active one, which no longer holds after a switch.
+     */
+    ver->mv_gen = c0kvms_gen_read(dst);
+    if (*genp && *genp != ver->mv_gen) {
+        err = merr(EAGAIN);
+        goto unlock;
+    }
+
+    if (pfx_len > 0) {
+        kvs = c0kvms_ptomb_c0kvset_get(dst);
+        c0kvs_prefix_get_rcu(kvs, skidx, kt, UINT64_MAX, 0, pfx_len, &ptomb_seqref);
+        ver->mv_ptomb = c0kvs_prefix_ver_rcu(kvs, skidx, kt, pfx_len);
+    }
+
+    kvs = c0kvms_get_hashed_c0kvset(dst, kt->kt_hash);
+
+    err = c0kvs_merge_read(kvs, skidx, kt, curbuf, res, &oseqnoref, &ver->mv_val);
+    if (!err && HSE_SQNREF_TO_ORDNL(ptomb_seqref) > HSE_SQNREF_TO_ORDNL(oseqnoref))
+        *res = FOUND_PTMB;
+
+unlock:
+    rcu_read_unlock();
+
+    *genp = ver->mv_gen;
+
+    return err;
+}
+
+merr_t
+c0sk_putmerge(
+    struct c0sk_impl *self,
+    uint32_t skidx,
+    uint32_t pfx_len,
+    struct kvs_ktuple *kt,
+    const struct kvs_vtuple *vt,
+    uintptr_t seqnoref,
+    const struct c0_merge_ver *ver)
+{
+    struct c0_kvmultiset *dst;
+    struct c0_kvset *kvs;
+    void *cookie = NULL;
+    merr_t err;
+
+    assert(HSE_SQNREF_SINGLE_P(seqnoref));
+
+    if (kt->kt_len < pfx_len)
+        pfx_len = 0;
+
+    kt->kt_dgen = 0;
+
+    rcu_read_lock();
+    dst = c0sk_get_first_c0kvms(&self->c0sk_handle);
+    if (ev_warn(!dst)) {
+        rcu_read_unlock();
+        return merr(EINVAL);
+    }
+
+    c0sk_ingestref_get(self, false, &cookie);
+
+    if (c0kvms_should_ingest(dst) && atomic_read(&self->c0sk_replaying) == 0) {
+        err = merr(ENOMEM);
+        goto unlock;
+    }
+
+    /* The version is meaningless in any other kvms, whose values may
+     * reside at the same addresses.
+     */
+    if (c0kvms_gen_read(dst) != ver->mv_gen) {
+        err = merr(EAGAIN);
+        goto unlock;
+    }
+
+    if (pfx_len > 0) {
+        kvs = c0kvms_ptomb_c0kvset_get(dst);
+        if (c0kvs_prefix_ver_rcu(kvs, skidx, kt, pfx_len) != ver->mv_ptomb) {
+            err = merr(ECANCELED);
+            goto unlock;
+        }
+    }
+
+    kvs = c0kvms_get_hashed_c0kvset(dst, kt->kt_hash);
+
+    err = c0kvs_merge_commit(kvs, skidx, kt, vt, seqnoref, ver->mv_val);
+    if (!err)
+        kt->kt_dgen = ver->mv_gen;
+
+    assert(!c0kvms_is_finalized(dst));
+
+unlock:
+    c0sk_ingestref_put(self, cookie);
+
+    if (merr_errno(err) == ENOMEM) {
+        c0kvms_getref(dst);
+        rcu_read_unlock();
+
+        /* The merged value was computed from this kvms, so the merge
+         * must be restarted in the next one.
+         */
+        c0sk_queue_ingest(self, dst);
+        c0kvms_putref(dst);
+
+        return merr(EAGAIN);
+    }
+
+    rcu_read_unlock();
+
+    return err;
+}
+
 #if HSE_MOCKING
 #include "c0sk_internal_ut_impl.i"
 #endif /* HSE_MOCKING */
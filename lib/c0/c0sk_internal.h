@@ -222,6 +222,76 @@ c0sk_putdel(
     const struct kvs_vtuple *vt,
     uintptr_t seqnoref);
 
+/**
+ * c0sk_putdel_batch() - put a batch of non-transactional key/values and tombstones
+ * @self:        struct c0sk_impl in which to put
+ * @skidx:       which kvs is the insert targeted to
+ * @opv:         vector of ops
+ * @cnt:         number of elements in @opv
+ * @seqnoref:    seqnoref of all ops
+ *
+ * See c0sk_write_batch().
+ *
+ * Return: [HSE_REVISIT]
+ */
+merr_t
+c0sk_putdel_batch(
+    struct c0sk_impl *self,
+    uint32_t skidx,
+    struct kvs_batch_op *opv,
+    uint cnt,
+    uintptr_t seqnoref);
+
+/**
+ * c0sk_getmerge() - read the value of a key in the active kvms for a merge
+ * @self:        struct c0sk_impl from which to read
+ * @skidx:       which kvs is the merge targeted to
+ * @pfx_len:     kvs prefix length
+ * @kt:          key tuple
+ * @genp:        required kvms gen (zero for any), gen read from (output)
+ * @curbuf:      buffer for the key's current value
+ * @res:         state of the key (output)
+ * @ver:         version of the key (output)
+ *
+ * See c0sk_merge_read().
+ *
+ * Return: [HSE_REVISIT]
+ */
+merr_t
+c0sk_getmerge(
+    struct c0sk_impl *self,
+    uint32_t skidx,
+    uint32_t pfx_len,
+    const struct kvs_ktuple *kt,
+    uint64_t *genp,
+    struct kvs_buf *curbuf,
+    enum key_lookup_res *res,
+    struct c0_merge_ver *ver);
+
+/**
+ * c0sk_putmerge() - insert the merged value of a key
+ * @self:        struct c0sk_impl in which to insert
+ * @skidx:       which kvs is the merge targeted to
+ * @pfx_len:     kvs prefix length
+ * @kt:          key tuple
+ * @vt:          merged value
+ * @seqnoref:    seqnoref of the merged value
+ * @ver:         version of the key returned by c0sk_getmerge()
+ *
+ * See c0sk_merge_commit().
+ *
+ * Return: [HSE_REVISIT]
+ */
+merr_t
+c0sk_putmerge(
+    struct c0sk_impl *self,
+    uint32_t skidx,
+    uint32_t pfx_len,
+    struct kvs_ktuple *kt,
+    const struct kvs_vtuple *vt,
+    uintptr_t seqnoref,
+    const struct c0_merge_ver *ver);
+
 struct cn *
 c0sk_get_cn(struct c0sk_impl *c0sk, uint64_t skidx);
 
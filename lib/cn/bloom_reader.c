@@ -3,11 +3,123 @@
  * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
  */
 
+#include <endian.h>
+
+#if __aarch64__
+#include <arm_neon.h>
+#endif
+
+#include <hse/util/arch.h>
 #include <hse/util/bloom_filter.h>
+#include <hse/util/compiler.h>
 #include <hse/util/page.h>
 
 #include "bloom_reader.h"
 
+/* Bloom filters are laid out as an array of fixed size buckets and all the
+ * bits for a given key reside in a single bucket.  For the common 512-bit
+ * bucket (i.e., one cache line on most platforms) we build a mask of all the
+ * key's bits up front and then test the whole bucket against the mask in one
+ * SIMD pass, rather than testing one bit at a time with a data dependent
+ * branch per hash.  The kernel is selected by the instruction set detected
+ * at startup by hse_simd_init().
+ */
+#define BLOOM_BKT512_SHIFT (9)
+#define BLOOM_BKT512_WORDS ((1u << BLOOM_BKT512_SHIFT) / 64)
+
+/* Bucket bits are addressed bytewise (see isset()), which matches the layout
+ * of 64-bit words only on little endian machines.
+ */
+#define BLOOM_BKT512_ENABLE (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+
+static HSE_ALWAYS_INLINE bool
+bloom_probe512_scalar(const uint8_t *bkt, const uint64_t *maskv)
+{
+    uint64_t miss = 0;
+
+    for (uint i = 0; i < BLOOM_BKT512_WORDS; ++i) {
+        uint64_t word;
+
+        memcpy(&word, bkt + i * sizeof(word), sizeof(word));
+        miss |= maskv[i] & ~word;
+    }
+
+    return !miss;
+}
+
+#if __amd64__
+static __attribute__((__target__("avx2"))) bool
+bloom_probe512_avx2(const uint8_t *bkt, const uint64_t *maskv)
+{
+    const __m256i *bv = (const __m256i *)bkt;
+    const __m256i *mv = (const __m256i *)maskv;
+
+    /* testc returns 1 iff (~bucket & mask) is all zeroes. */
+    return _mm256_testc_si256(_mm256_loadu_si256(bv), _mm256_loadu_si256(mv)) &
+        _mm256_testc_si256(_mm256_loadu_si256(bv + 1), _mm256_loadu_si256(mv + 1));
+}
+
+static __attribute__((__target__("sse4.2"))) bool
+bloom_probe512_sse42(const uint8_t *bkt, const uint64_t *maskv)
+{
+    const __m128i *bv = (const __m128i *)bkt;
+    const __m128i *mv = (const __m128i *)maskv;
+    int rc = 1;
+
+    for (uint i = 0; i < 4; ++i)
+        rc &= _mm_testc_si128(_mm_loadu_si128(bv + i), _mm_loadu_si128(mv + i));
+
+    return rc;
+}
+#endif
+
+#if __aarch64__
+static bool
+bloom_probe512_neon(const uint8_t *bkt, const uint64_t *maskv)
+{
+    uint64x2_t miss = vdupq_n_u64(0);
+
+    for (uint i = 0; i < 4; ++i) {
+        uint64x2_t b = vld1q_u64((const uint64_t *)(bkt + i * 16));
+        uint64x2_t m = vld1q_u64(maskv + i * 2);
+
+        miss = vorrq_u64(miss, vbicq_u64(m, b));
+    }
+
+    return !(vgetq_lane_u64(miss, 0) | vgetq_lane_u64(miss, 1));
+}
+#endif
+
+static HSE_ALWAYS_INLINE bool
+bloom_lookup512(const uint8_t *bkt, uint64_t hash, int32_t n, uint32_t rotl)
+{
+    uint64_t maskv[BLOOM_BKT512_WORDS] HSE_ALIGNED(64) = { 0 };
+
+    while (n-- > 0) {
+        const uint32_t bit = bf_hash2bit(&hash, rotl, (1u << BLOOM_BKT512_SHIFT) - 1);
+
+        maskv[bit / 64] |= 1ull << (bit % 64);
+    }
+
+    switch (hse_simd) {
+#if __amd64__
+    case HSE_SIMD_AVX2:
+        return bloom_probe512_avx2(bkt, maskv);
+
+    case HSE_SIMD_SSE42:
+        return bloom_probe512_sse42(bkt, maskv);
+#endif
+#if __aarch64__
+    case HSE_SIMD_NEON:
+        return bloom_probe512_neon(bkt, maskv);
+#endif
+    default:
+        break;
+    }
+
+    return bloom_probe512_scalar(bkt, maskv);
+}
+
 /* [HSE_REVISIT] bloom_filter.[ch] provides an abstracted data type for a bloom
  * filter, but does not provide for creation of a self-managed bloom filter
  * object.  This leaves it up to the client to create and manage the operation
@@ -30,5 +142,8 @@ bloom_reader_lookup(const struct bloom_desc *desc, uint64_t hash)
 
     bitmap += (bkt / PAGE_SIZE) * PAGE_SIZE + (bkt % PAGE_SIZE);
 
+    if (BLOOM_BKT512_ENABLE && desc->bd_bktshift == BLOOM_BKT512_SHIFT)
+        return bloom_lookup512(bitmap, hash, desc->bd_n_hashes, desc->bd_rotl);
+
     return bf_lookup(hash, bitmap, desc->bd_n_hashes, desc->bd_rotl, desc->bd_bktmask);
 }
@@ -39,6 +39,8 @@
 #include <hse/rest/status.h>
 #include <hse/util/alloc.h>
 #include <hse/util/event_counter.h>
+#include <hse/util/key_util.h>
+#include <hse/util/keycmp.h>
 #include <hse/util/log2.h>
 #include <hse/util/map.h>
 #include <hse/util/perfc.h>
@@ -64,7 +66,9 @@
 #include "kvset.h"
 #include "kvset_internal.h"
 #include "omf.h"
+#include "rcache.h"
 #include "route.h"
+#include "rtomb.h"
 #include "spill.h"
 #include "vblock_reader.h"
 #include "wbt_reader.h"
@@ -189,6 +193,18 @@ cn_get_io_wq(struct cn *cn)
     return cn->cn_io_wq;
 }
 
+struct workqueue_struct *
+cn_get_spill_wq(struct cn *cn)
+{
+    return cn->cn_spill_wq;
+}
+
+struct workqueue_struct *
+cn_get_wr_wq(struct cn *cn)
+{
+    return cn->cn_wr_wq;
+}
+
 struct workqueue_struct *
 cn_get_maint_wq(struct cn *cn)
 {
@@ -340,15 +356,335 @@ cn_get_cparams(const struct cn *handle)
     return handle->cp;
 }
 
+/* Turn a value found by a get into a tombstone if a range tombstone
+ * in view deletes it.
+ */
+static void
+cn_get_rtomb_filter(
+    struct rtomb_set *rtombs,
+    const struct kvs_ktuple *kt,
+    uint64_t view,
+    uint64_t vseq,
+    enum key_lookup_res *res)
+{
+    struct key_obj kobj;
+
+    if (*res != FOUND_VAL)
+        return;
+
+    key2kobj(&kobj, kt->kt_data, kt->kt_len);
+
+    if (vseq < rtomb_set_floor(rtombs, &kobj, view))
+        *res = FOUND_TMB;
+}
+
 merr_t
 cn_get(
     struct cn *cn,
     struct kvs_ktuple *kt,
     uint64_t seq,
+    uint64_t rcgen,
+    bool direct,
     enum key_lookup_res *res,
     struct kvs_buf *vbuf)
 {
-    return cn_tree_lookup(cn->cn_tree, &cn->cn_pc_get, kt, seq, res, NULL, vbuf);
+    struct rtomb_set *rtombs = cn_rtombs_get(cn);
+    struct kvs_vtuple_ref vref;
+    uint64_t vseq;
+    merr_t err;
+
+    if (!rcgen || !cn->cn_rcache) {
+        err = cn_tree_lookup(cn->cn_tree, &cn->cn_pc_get, kt, seq, direct, res, &vref, vbuf);
+        if (!err && rtombs)
+            cn_get_rtomb_filter(rtombs, kt, seq, vref.vr_seq, res);
+        goto out;
+    }
+
+    if (rcache_get(cn->cn_rcache, kt, seq, vbuf, &vseq)) {
+        *res = FOUND_VAL;
+        if (rtombs)
+            cn_get_rtomb_filter(rtombs, kt, seq, vseq, res);
+        err = 0;
+        goto out;
+    }
+
+    err = cn_tree_lookup(cn->cn_tree, &cn->cn_pc_get, kt, seq, direct, res, &vref, vbuf);
+    if (!err && rtombs)
+        cn_get_rtomb_filter(rtombs, kt, seq, vref.vr_seq, res);
+
+    /* Only values that were copied out in full can be cached.
+     */
+    if (!err && *res == FOUND_VAL && vbuf->b_len <= vbuf->b_buf_sz)
+        rcache_put(
+            cn->cn_rcache, kt, rcgen, seq, vref.vr_seq, vref.vr_expire, vbuf->b_buf, vbuf->b_len);
+
+out:
+    cn_rtombs_put(rtombs);
+
+    return err;
+}
+
+uint64_t
+cn_rcache_gen(struct cn *cn, const struct kvs_ktuple *kt)
+{
+    return cn->cn_rcache ? rcache_gen(cn->cn_rcache, kt) : 0;
+}
+
+void
+cn_rcache_invalidate(struct cn *cn, const struct kvs_ktuple *kt)
+{
+    if (cn->cn_rcache)
+        rcache_invalidate(cn->cn_rcache, kt);
+}
+
+void
+cn_rcache_purge(struct cn *cn)
+{
+    if (cn->cn_rcache)
+        rcache_purge(cn->cn_rcache);
+}
+
+merr_t
+cn_get_multi(
+    struct cn *cn,
+    uint cnt,
+    struct kvs_ktuple *ktv,
+    uint64_t seq,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv)
+{
+    merr_t err = 0;
+
+    if (!atomic_read(&cn->cn_rtomb_cnt))
+        return cn_tree_lookup_multi(cn->cn_tree, &cn->cn_pc_get, cnt, ktv, seq, resv, vbufv);
+
+    /* The batched lookup does not report the seqnos of the values it finds,
+     * which are needed to apply range tombstones.
+     */
+    for (uint i = 0; i < cnt && !err; i++) {
+        if (resv[i] == NOT_FOUND)
+            err = cn_get(cn, ktv + i, seq, 0, false, resv + i, vbufv + i);
+    }
+
+    return err;
+}
+
+merr_t
+cn_range_delete(
+    struct cn *cn,
+    const struct kvs_ktuple *kt_start,
+    const struct kvs_ktuple *kt_end,
+    atomic_ulong *kvdb_seqno)
+{
+    struct rtomb_set *old, *new;
+    struct rtomb *rt;
+    uint64_t seqno;
+    merr_t err;
+
+    err = rtomb_create(kt_start->kt_data, kt_start->kt_len, kt_end->kt_data, kt_end->kt_len, 0, &rt);
+    if (ev(err))
+        return err;
+
+    mutex_lock(&cn->cn_rtomb_lock);
+
+    err = rtomb_set_insert(cn->cn_rtombs, rt, &new);
+    if (err) {
+        mutex_unlock(&cn->cn_rtomb_lock);
+        rtomb_put(rt);
+        return err;
+    }
+
+    spin_lock(&cn->cn_rtomb_spin);
+    old = cn->cn_rtombs;
+    cn->cn_rtombs = new;
+    spin_unlock(&cn->cn_rtomb_spin);
+
+    atomic_set_rel(&cn->cn_rtomb_cnt, new->rs_cnt);
+
+    /* The tombstone is published before it gets its seqno, so every reader
+     * whose view includes the seqno finds the tombstone.  Readers which find
+     * it before it has a seqno wait for it in rtomb_seqno().
+     */
+    seqno = atomic_inc_return(kvdb_seqno);
+    atomic_set_rel(&rt->rt_seqno, seqno);
+
+    rtomb_set_put(old);
+
+    err = cndb_record_rtomb_add(
+        cn->cn_cndb, cn->cn_cnid, seqno, kt_start->kt_data, kt_start->kt_len, kt_end->kt_data,
+        kt_end->kt_len);
+
+    mutex_unlock(&cn->cn_rtomb_lock);
+
+    rtomb_put(rt);
+
+    /* The tombstone is in effect even though it could not be persisted.
+     */
+    if (ev(err))
+        kvdb_health_error(cn->cn_kvdb_health, err);
+
+    return err;
+}
+
+struct rtomb_set *
+cn_rtombs_get(struct cn *cn)
+{
+    struct rtomb_set *set;
+
+    /* Pairs with the seqno increment in cn_range_delete(), so that readers
+     * whose view includes a tombstone's seqno find the tombstone.
+     */
+    atomic_thread_fence(memory_order_acquire);
+
+    if (!atomic_read(&cn->cn_rtomb_cnt))
+        return NULL;
+
+    spin_lock(&cn->cn_rtomb_spin);
+    set = cn->cn_rtombs;
+    if (set)
+        atomic_inc(&set->rs_ref);
+    spin_unlock(&cn->cn_rtomb_spin);
+
+    return set;
+}
+
+void
+cn_rtombs_put(struct rtomb_set *set)
+{
+    rtomb_set_put(set);
+}
+
+uint64_t
+cn_rtomb_floor(struct rtomb_set *set, const struct key_obj *kobj, uint64_t view)
+{
+    return set ? rtomb_set_floor(set, kobj, view) : 0;
+}
+
+bool
+cn_rtomb_overlaps_pfx(struct rtomb_set *set, const void *pfx, uint plen, uint64_t view)
+{
+    return set ? rtomb_set_overlaps_pfx(set, pfx, plen, view) : false;
+}
+
+/* Check whether no kvset of the tree may hold data deleted by a tombstone.
+ * A kvset holds none if all of its data is newer than the tombstone, or if
+ * it was written by a compaction which applied the tombstone.
+ */
+static bool
+cn_rtomb_applied(struct cn_tree *tree, const struct rtomb *rt, uint64_t seqno)
+{
+    struct cn_tree_node *tn;
+
+    cn_tree_foreach_node(tn, tree) {
+        struct kvset_list_entry *le;
+
+        list_for_each_entry(le, &tn->tn_kvset_list, le_link) {
+            struct kvset *ks = le->le_kvset;
+
+            if (ks->ks_seqno_min >= seqno || ks->ks_rtomb_seqno >= seqno)
+                continue;
+
+            if (keycmp(ks->ks_minkey, ks->ks_minklen, rtomb_end(rt), rt->rt_elen) < 0 &&
+                keycmp(ks->ks_maxkey, ks->ks_maxklen, rtomb_start(rt), rt->rt_slen) >= 0)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void
+cn_rtomb_retire(struct cn *cn)
+{
+    struct rtomb_set *old, *new = NULL;
+    struct rtomb **rmv;
+    uint64_t ingest_min;
+    uint rmc = 0;
+    void *lock;
+    merr_t err;
+
+    rmv = malloc(RTOMB_SET_MAX * sizeof(*rmv));
+    if (ev(!rmv))
+        return;
+
+    mutex_lock(&cn->cn_rtomb_lock);
+
+    old = cn->cn_rtombs;
+    if (!old)
+        goto out;
+
+    /* c0 may hold data deleted by a tombstone until an ingest of data
+     * newer than the tombstone has completed.
+     */
+    ingest_min = atomic_read(&cn->cn_kvdb->cn_ingest_seqno_min);
+
+    rmlock_rlock(&cn->cn_tree->ct_lock, &lock);
+    for (uint i = 0; i < old->rs_cnt; i++) {
+        struct rtomb *rt = old->rs_entv[i].re_tomb;
+        const uint64_t seqno = rtomb_seqno(rt);
+
+        if (seqno <= ingest_min && cn_rtomb_applied(cn->cn_tree, rt, seqno))
+            rmv[rmc++] = rt;
+    }
+    rmlock_runlock(lock);
+
+    if (!rmc)
+        goto out;
+
+    err = rtomb_set_remove(old, rmv, rmc, &new);
+    if (ev(err))
+        goto out;
+
+    spin_lock(&cn->cn_rtomb_spin);
+    cn->cn_rtombs = new;
+    spin_unlock(&cn->cn_rtomb_spin);
+
+    atomic_set_rel(&cn->cn_rtomb_cnt, new ? new->rs_cnt : 0);
+
+    /* A tombstone which could not be retired in the cndb comes back at the
+     * next open, where it is harmless.
+     */
+    for (uint i = 0; i < rmc; i++) {
+        err = cndb_record_rtomb_del(cn->cn_cndb, cn->cn_cnid, rtomb_seqno(rmv[i]));
+        if (ev(err))
+            break;
+    }
+
+    rtomb_set_put(old);
+
+out:
+    mutex_unlock(&cn->cn_rtomb_lock);
+    free(rmv);
+}
+
+static merr_t
+cn_rtomb_restore_cb(
+    void *ctx,
+    uint64_t seqno,
+    const void *start,
+    uint32_t slen,
+    const void *end,
+    uint32_t elen)
+{
+    struct cn *cn = ctx;
+    struct rtomb_set *new;
+    struct rtomb *rt;
+    merr_t err;
+
+    err = rtomb_create(start, slen, end, elen, seqno, &rt);
+    if (ev(err))
+        return err;
+
+    err = rtomb_set_insert(cn->cn_rtombs, rt, &new);
+    rtomb_put(rt);
+    if (ev(err))
+        return err;
+
+    rtomb_set_put(cn->cn_rtombs);
+    cn->cn_rtombs = new;
+    atomic_set(&cn->cn_rtomb_cnt, new->rs_cnt);
+
+    return 0;
 }
 
 merr_t
@@ -364,6 +700,20 @@ cn_pfx_probe(
     return cn_tree_prefix_probe(cn->cn_tree, &cn->cn_pc_get, kt, seq, res, qctx, kbuf, vbuf);
 }
 
+uint
+cn_split_keys(
+    struct cn *cn,
+    const void *min,
+    uint minlen,
+    const void *max,
+    uint maxlen,
+    uint splitc,
+    void *keyv,
+    uint *klenv)
+{
+    return cn_tree_split_keys(cn->cn_tree, min, minlen, max, maxlen, splitc, keyv, klenv);
+}
+
 merr_t
 cn_mblocks_commit(
     struct mpool *mp,
@@ -492,6 +842,7 @@ cn_mb_est_alen(size_t full_captgt, size_t mb_alloc_unit, size_t wlen, uint flags
  * cn_ingest_prep()
  * @cn:
  * @mblocks:
+ * @dgen:    dgen of the new kvset (caller holds cn_ingest_lock)
  * @context:
  */
 static merr_t
@@ -499,12 +850,12 @@ cn_ingest_prep(
     struct cn *cn,
     struct kvset_mblocks *mblocks,
     uint64_t kvsetid,
+    uint64_t dgen,
     struct cndb_txn *txn,
     struct kvset **kvsetp,
     void **cookie)
 {
     struct kvset_meta km = { 0 };
-    uint64_t dgen;
     merr_t err = 0;
 
     if (ev(!mblocks))
@@ -514,8 +865,6 @@ cn_ingest_prep(
 
     *kvsetp = NULL;
 
-    dgen = atomic_read(&cn->cn_ingest_dgen) + 1;
-
     km.km_hblk_id = mblocks->hblk_id;
     km.km_kblk_list = mblocks->kblks;
     km.km_vblk_list = mblocks->vblks;
@@ -586,7 +935,7 @@ cn_ingestv(
     merr_t err = 0;
     uint i, first, last, count, check;
     uint64_t seqno_max = 0, seqno_min = UINT64_MAX;
-    bool log_ingest = false;
+    bool log_ingest = false, locked = false;
     uint64_t dgen = 0;
 
     /* Ingestc can be large (256), and is typically sparse.
@@ -625,6 +974,14 @@ cn_ingestv(
     if (max_seqno_out)
         *max_seqno_out = seqno_max;
 
+    /* Hold off bulk loads until every kvset of this ingest is in its tree.
+     */
+    for (i = first; i <= last; i++) {
+        if (cn[i] && mbv[i])
+            mutex_lock(&cn[i]->cn_ingest_lock);
+    }
+    locked = true;
+
     kvsetv = calloc(ingestc, sizeof(*kvsetv));
     if (ev(!kvsetv)) {
         err = merr(ENOMEM);
@@ -649,7 +1006,9 @@ cn_ingestv(
         if (cn[i]->rp && !log_ingest)
             log_ingest = cn[i]->rp->cn_compaction_debug & 2;
 
-        err = cn_ingest_prep(cn[i], mbv[i], kvsetidv[i], cndb_txn, &kvsetv[i], &cookiev[i]);
+        err = cn_ingest_prep(
+            cn[i], mbv[i], kvsetidv[i], atomic_read(&cn[i]->cn_ingest_dgen) + 1, cndb_txn,
+            &kvsetv[i], &cookiev[i]);
         if (ev(err))
             goto nak;
 
@@ -690,12 +1049,24 @@ cn_ingestv(
             cn[i]->cn_tree, kvsetv[i], mbv[i]->bl_last_ptomb, mbv[i]->bl_last_ptlen,
             mbv[i]->bl_last_ptseq);
 
+        /* Fills of rows by views older than the ingested data must fail
+         * from here on, as c0 no longer shields them from the new data.
+         */
+        if (cn[i]->cn_rcache)
+            rcache_seqno_set(cn[i]->cn_rcache, mbv[i]->bl_seqno_max);
+
         kvsetv[i] = NULL;
 
         check--;
     }
     assert(check == 0);
 
+    /* c0 no longer holds data older than this ingest, which allows range
+     * tombstones older than the ingest to be retired.
+     */
+    if (seqno_min > atomic_read(&cn[first]->cn_kvdb->cn_ingest_seqno_min))
+        atomic_set(&cn[first]->cn_kvdb->cn_ingest_seqno_min, seqno_min);
+
     if (log_ingest) {
         const ulong hwlen_pct = kst.kst_halen ? 100 * kst.kst_hwlen / kst.kst_halen : 0;
         const ulong kwlen_pct = kst.kst_kalen ? 100 * kst.kst_kwlen / kst.kst_kalen : 0;
@@ -731,6 +1102,9 @@ done:
 
         if (cn[i])
             perfc_inc(&cn[i]->cn_pc_ingest, PERFC_BA_CNCOMP_FINISH);
+
+        if (locked && cn[i] && mbv[i])
+            mutex_unlock(&cn[i]->cn_ingest_lock);
     }
 
     free(kvsetv);
@@ -738,6 +1112,375 @@ done:
     return err;
 }
 
+/**
+ * struct cn_bulk - a bulk load in progress
+ * @cb_cn:       cn being loaded
+ * @cb_seqno:    seqno of every value in the load
+ * @cb_err:      first error, which fails all later adds and the commit
+ * @cb_bldr:     builder of the kvset being built, or NULL
+ * @cb_bytes:    key and value bytes added to @cb_bldr
+ * @cb_cutoff:   @cb_bytes at which the current kvset is finished
+ * @cb_mbc:      number of finished kvsets
+ * @cb_mbmax:    number of elements in @cb_mbv and @cb_kvsetidv
+ * @cb_mbv:      mblocks of the finished kvsets
+ * @cb_kvsetidv: kvset IDs of the finished kvsets and of @cb_bldr
+ * @cb_kminlen:  length of @cb_kmin
+ * @cb_klen:     length of @cb_key
+ * @cb_kmin:     first key added
+ * @cb_key:      last key added
+ */
+struct cn_bulk {
+    struct cn *cb_cn;
+    uint64_t cb_seqno;
+    merr_t cb_err;
+    struct kvset_builder *cb_bldr;
+    size_t cb_bytes;
+    size_t cb_cutoff;
+    uint cb_mbc;
+    uint cb_mbmax;
+    struct kvset_mblocks *cb_mbv;
+    uint64_t *cb_kvsetidv;
+    uint cb_kminlen;
+    uint cb_klen;
+    uint8_t cb_kmin[HSE_KVS_KEY_LEN_MAX];
+    uint8_t cb_key[HSE_KVS_KEY_LEN_MAX];
+};
+
+merr_t
+cn_bulk_create(struct cn *cn, uint64_t seqno, struct cn_bulk **bulkp)
+{
+    struct cn_bulk *bulk;
+
+    /* Capped kvs rely on the ptomb state ingests carry into the tree.
+     */
+    if (ev(cn_is_capped(cn) || cn->cn_replay))
+        return merr(EINVAL);
+
+    bulk = calloc(1, sizeof(*bulk));
+    if (ev(!bulk))
+        return merr(ENOMEM);
+
+    bulk->cb_cn = cn;
+    bulk->cb_seqno = seqno;
+    bulk->cb_cutoff = (size_t)cn->rp->cn_split_size << 30;
+
+    *bulkp = bulk;
+
+    return 0;
+}
+
+static merr_t
+cn_bulk_bldr_create(struct cn_bulk *bulk)
+{
+    struct cn *cn = bulk->cb_cn;
+    uint64_t kvsetid;
+    merr_t err;
+
+    if (bulk->cb_mbc == bulk->cb_mbmax) {
+        uint mbmax = bulk->cb_mbmax ? bulk->cb_mbmax * 2 : 8;
+        struct kvset_mblocks *mbv;
+        uint64_t *kvsetidv;
+
+        mbv = realloc(bulk->cb_mbv, mbmax * sizeof(*mbv));
+        if (ev(!mbv))
+            return merr(ENOMEM);
+
+        bulk->cb_mbv = mbv;
+
+        kvsetidv = realloc(bulk->cb_kvsetidv, mbmax * sizeof(*kvsetidv));
+        if (ev(!kvsetidv))
+            return merr(ENOMEM);
+
+        bulk->cb_kvsetidv = kvsetidv;
+        bulk->cb_mbmax = mbmax;
+    }
+
+    kvsetid = cndb_kvsetid_mint(cn->cn_cndb);
+
+    err = kvset_builder_create(&bulk->cb_bldr, cn, &cn->cn_pc_ingest, kvsetid);
+    if (ev(err))
+        return err;
+
+    err = kvset_builder_set_agegroup(bulk->cb_bldr, HSE_MPOLICY_AGE_ROOT);
+    if (ev(err)) {
+        kvset_builder_destroy(bulk->cb_bldr);
+        bulk->cb_bldr = NULL;
+        return err;
+    }
+
+    bulk->cb_kvsetidv[bulk->cb_mbc] = kvsetid;
+    bulk->cb_bytes = 0;
+
+    return 0;
+}
+
+/* Finish the kvset being built and append its mblocks to the load.
+ */
+static merr_t
+cn_bulk_bldr_finish(struct cn_bulk *bulk)
+{
+    struct kvset_mblocks *mb = bulk->cb_mbv + bulk->cb_mbc;
+    merr_t err;
+
+    memset(mb, 0, sizeof(*mb));
+
+    err = kvset_builder_get_mblocks(bulk->cb_bldr, mb);
+    if (!err)
+        bulk->cb_mbc++;
+
+    kvset_builder_destroy(bulk->cb_bldr);
+    bulk->cb_bldr = NULL;
+
+    return err;
+}
+
+merr_t
+cn_bulk_add(struct cn_bulk *bulk, const struct kvs_ktuple *kt, const struct kvs_vtuple *vt)
+{
+    const uint ulen = vt->vt_xlen & 0xfffffffful;
+    const uint clen = kvs_vtuple_clen(vt);
+    struct key_obj ko;
+    merr_t err;
+
+    if (bulk->cb_err)
+        return bulk->cb_err;
+
+    /* Keys must be strictly ascending, which is what lets them go straight
+     * into kvset builders.  Out of order keys are rejected without spoiling
+     * the load.
+     */
+    if (bulk->cb_klen > 0 && keycmp(kt->kt_data, kt->kt_len, bulk->cb_key, bulk->cb_klen) <= 0)
+        return merr(EINVAL);
+
+    if (bulk->cb_bldr && bulk->cb_bytes >= bulk->cb_cutoff) {
+        err = cn_bulk_bldr_finish(bulk);
+        if (ev(err))
+            goto errout;
+    }
+
+    if (!bulk->cb_bldr) {
+        err = cn_bulk_bldr_create(bulk);
+        if (ev(err))
+            goto errout;
+    }
+
+    key2kobj(&ko, kt->kt_data, kt->kt_len);
+
+    err = kvset_builder_add_val(
+        bulk->cb_bldr, &ko, vt->vt_data, ulen, bulk->cb_seqno, vt->vt_expire, clen,
+        kvs_vtuple_calgo(vt));
+    if (ev(err))
+        goto errout;
+
+    err = kvset_builder_add_key(bulk->cb_bldr, &ko);
+    if (ev(err))
+        goto errout;
+
+    if (bulk->cb_klen == 0) {
+        memcpy(bulk->cb_kmin, kt->kt_data, kt->kt_len);
+        bulk->cb_kminlen = kt->kt_len;
+    }
+
+    memcpy(bulk->cb_key, kt->kt_data, kt->kt_len);
+    bulk->cb_klen = kt->kt_len;
+    bulk->cb_bytes += kt->kt_len + (clen ? clen : ulen);
+
+    return 0;
+
+errout:
+    bulk->cb_err = err;
+
+    return err;
+}
+
+/* Check whether anything newer than the load was ingested into, or range
+ * deleted from, the key range of the load.  The load is older, yet it would
+ * shadow such data by virtue of its higher dgens, or be deleted by such
+ * range tombstones.
+ */
+static bool
+cn_bulk_conflicts(struct cn_bulk *bulk)
+{
+    struct cn *cn = bulk->cb_cn;
+    struct rtomb_set *rtombs;
+    bool conflict = false;
+
+    rtombs = cn_rtombs_get(cn);
+    if (rtombs) {
+        for (uint i = 0; i < rtombs->rs_cnt && !conflict; i++) {
+            const struct rtomb *rt = rtombs->rs_entv[i].re_tomb;
+
+            conflict = keycmp(rtomb_start(rt), rt->rt_slen, bulk->cb_key, bulk->cb_klen) <= 0 &&
+                keycmp(rtomb_end(rt), rt->rt_elen, bulk->cb_kmin, bulk->cb_kminlen) > 0 &&
+                rtomb_seqno(rt) > bulk->cb_seqno;
+        }
+
+        cn_rtombs_put(rtombs);
+    }
+
+    return conflict ||
+        cn_tree_overlaps_newer(
+            cn->cn_tree, bulk->cb_kmin, bulk->cb_kminlen, bulk->cb_key, bulk->cb_klen,
+            bulk->cb_seqno);
+}
+
+merr_t
+cn_bulk_commit(struct cn_bulk *bulk, cn_bulk_publish_callback *cb, void *arg)
+{
+    struct cn *cn = bulk->cb_cn;
+    struct cndb_txn *txn = NULL;
+    struct kvset **kvsetv = NULL;
+    void **cookiev = NULL;
+    uint64_t dgen = 0;
+    uint i, prepc = 0;
+    merr_t err;
+
+    if (bulk->cb_err)
+        return bulk->cb_err;
+
+    if (bulk->cb_bldr) {
+        err = cn_bulk_bldr_finish(bulk);
+        if (ev(err))
+            goto errout;
+    }
+
+    if (bulk->cb_mbc == 0)
+        return 0;
+
+    kvsetv = calloc(bulk->cb_mbc, sizeof(*kvsetv));
+    cookiev = calloc(bulk->cb_mbc, sizeof(*cookiev));
+    if (ev(!kvsetv || !cookiev)) {
+        err = merr(ENOMEM);
+        goto errout;
+    }
+
+    /* All the kvsets are added to the root node in one cndb transaction,
+     * each with a dgen of its own, exactly as if they had been ingested
+     * from c0 in key order.  The transaction carries the load's seqno so
+     * that cndb recovery restores a kvdb seqno at least as large.
+     */
+    mutex_lock(&cn->cn_ingest_lock);
+
+    /* Nothing has been recorded in cndb yet, so a busy callback leaves the
+     * load intact for the commit to be retried.
+     */
+    if (cb) {
+        err = cb(arg);
+        if (err) {
+            mutex_unlock(&cn->cn_ingest_lock);
+            free(cookiev);
+            free(kvsetv);
+            return err;
+        }
+    }
+
+    if (cn_bulk_conflicts(bulk)) {
+        err = merr(ECANCELED);
+        goto unlock;
+    }
+
+    dgen = atomic_read(&cn->cn_ingest_dgen);
+
+    err = cndb_record_txstart(
+        cn->cn_cndb, bulk->cb_seqno, CNDB_INVAL_INGESTID, CNDB_INVAL_HORIZON, bulk->cb_mbc, 0,
+        &txn);
+    if (ev(err))
+        goto unlock;
+
+    while (prepc < bulk->cb_mbc) {
+        i = prepc++;
+
+        err = cn_ingest_prep(
+            cn, bulk->cb_mbv + i, bulk->cb_kvsetidv[i], dgen + 1 + i, txn, &kvsetv[i], &cookiev[i]);
+        if (ev(err))
+            goto unlock;
+
+        if (ev(!kvsetv[i])) {
+            err = merr(EINVAL);
+            goto unlock;
+        }
+    }
+
+    for (i = 0; i < bulk->cb_mbc; i++) {
+        err = cndb_record_kvset_add_ack(cn->cn_cndb, txn, cookiev[i]);
+        if (ev(err))
+            goto unlock;
+    }
+
+    txn = NULL;
+
+    for (i = 0; i < bulk->cb_mbc; i++) {
+        cn_tree_ingest_update(cn->cn_tree, kvsetv[i], NULL, 0, 0);
+        kvsetv[i] = NULL;
+    }
+
+    /* The load bypasses c0, so rows of any key it overwrote are stale.
+     */
+    if (cn->cn_rcache) {
+        rcache_seqno_set(cn->cn_rcache, bulk->cb_seqno);
+        rcache_purge(cn->cn_rcache);
+    }
+
+unlock:
+    if (txn) {
+        merr_t err2 = cndb_record_nak(cn->cn_cndb, txn);
+
+        if (!err)
+            err = err2;
+    }
+
+    mutex_unlock(&cn->cn_ingest_lock);
+
+    /* The mblocks of prepared kvsets now belong to cndb (and to the tree on
+     * success); those of the rest are still ours to delete.
+     */
+    for (i = 0; i < prepc; i++) {
+        if (kvsetv[i])
+            kvset_put_ref(kvsetv[i]);
+    }
+
+    if (prepc < bulk->cb_mbc)
+        cn_mblocks_destroy(cn->cn_dataset, bulk->cb_mbc - prepc, bulk->cb_mbv + prepc, false);
+
+    for (i = 0; i < bulk->cb_mbc; i++)
+        kvset_mblocks_destroy(bulk->cb_mbv + i);
+
+    bulk->cb_mbc = 0;
+
+    if (!err)
+        log_info(
+            "%s/%s bulk loaded %u kvsets, seqno %lu dgen %lu-%lu", cn->cn_kvdb_alias,
+            cn->cn_kvs_name, prepc, bulk->cb_seqno, dgen + 1, dgen + prepc);
+
+errout:
+    free(cookiev);
+    free(kvsetv);
+
+    if (err)
+        bulk->cb_err = err;
+
+    return err;
+}
+
+void
+cn_bulk_destroy(struct cn_bulk *bulk)
+{
+    if (!bulk)
+        return;
+
+    if (bulk->cb_bldr)
+        kvset_builder_destroy(bulk->cb_bldr);
+
+    cn_mblocks_destroy(bulk->cb_cn->cn_dataset, bulk->cb_mbc, bulk->cb_mbv, false);
+
+    for (uint i = 0; i < bulk->cb_mbc; i++)
+        kvset_mblocks_destroy(bulk->cb_mbv + i);
+
+    free(bulk->cb_kvsetidv);
+    free(bulk->cb_mbv);
+    free(bulk);
+}
+
 static void
 cn_maint_task(struct work_struct *work)
 {
@@ -959,6 +1702,9 @@ cn_open(
         return merr(ENOMEM);
 
     memset(cn, 0, sz);
+    mutex_init(&cn->cn_ingest_lock);
+    mutex_init(&cn->cn_rtomb_lock);
+    spin_lock_init(&cn->cn_rtomb_spin);
 
     if (!rp) {
         rp = (void *)(cn + 1);
@@ -990,6 +1736,18 @@ cn_open(
 
     cn->cn_replay = flags & IKVS_OFLAG_REPLAY;
 
+    /* The row cache relies on every update being visible to all readers
+     * as soon as it is inserted into c0, which does not hold for
+     * transactions.  Capped kvsets are evicted wholesale by ttl, which
+     * does not go through c0 at all.
+     */
+    if (rp->cn_rcache_mb > 0 && !rp->transactions_enable && !cn_is_capped(cn) &&
+        !cn->cn_replay) {
+        err = rcache_create((size_t)rp->cn_rcache_mb << 20, &cn->cn_rcache);
+        if (ev(err))
+            goto err_exit;
+    }
+
     /* no perf counters in replay mode */
     if (!cn->cn_replay)
         cn_perfc_alloc(cn, rp->perfc_level);
@@ -1012,6 +1770,10 @@ cn_open(
     if (ev(err))
         goto err_exit;
 
+    err = cndb_cn_rtombs(cndb, cnid, cn, cn_rtomb_restore_cb);
+    if (ev(err))
+        goto err_exit;
+
     /* Walk the list of leaf nodes created/populated by cndb_cn_callback()
      * and insert them into the route map (i.e., all nodes except the root
      * node, which always has node ID 0).
@@ -1142,6 +1904,8 @@ cn_open(
     if (!rp->cn_maint_disable) {
         cn->cn_maint_wq = cn_kvdb->cn_maint_wq;
         cn->cn_io_wq = cn_kvdb->cn_io_wq;
+        cn->cn_spill_wq = cn_kvdb->cn_spill_wq;
+        cn->cn_wr_wq = cn_kvdb->cn_wr_wq;
 
         if (cn_is_capped(cn)) {
             cn->cn_maint_running = true;
@@ -1186,6 +1950,10 @@ err_exit:
     cn_tree_destroy(cn->cn_tree);
     if (!cn->cn_replay)
         cn_perfc_free(cn);
+    rcache_destroy(cn->cn_rcache);
+    rtomb_set_put(cn->cn_rtombs);
+    mutex_destroy(&cn->cn_rtomb_lock);
+    mutex_destroy(&cn->cn_ingest_lock);
     free(cn);
 
     return err;
@@ -1222,6 +1990,10 @@ cn_close(struct cn *cn)
     assert(atomic_read(&cn->cn_refcnt) == 0);
 
     cn_perfc_free(cn);
+    rcache_destroy(cn->cn_rcache);
+    rtomb_set_put(cn->cn_rtombs);
+    mutex_destroy(&cn->cn_rtomb_lock);
+    mutex_destroy(&cn->cn_ingest_lock);
     free(cn);
 
     return 0;
@@ -1321,6 +2093,7 @@ cn_cursor_create(
     struct cn *cn,
     uint64_t seqno,
     bool reverse,
+    bool novals,
     const void *prefix,
     uint32_t pfx_len,
     struct cursor_summary *summary,
@@ -1351,6 +2124,7 @@ cn_cursor_create(
 
     cur->cncur_summary = summary;
     cur->cncur_reverse = reverse;
+    cur->cncur_novals = novals;
 
     err = cn_tree_cursor_create(cur);
     if (ev(err)) {
@@ -64,6 +64,7 @@ struct cn_level_cursor {
  * @cncur_dgen:        max dgen in this scan
  * @cncur_seqno:       view sequence number for this cursor
  * @cncur_reverse:     reverse iterator: 1=yes 0=no
+ * @cncur_novals:      caller needs only keys and value lengths: 1=yes 0=no
  * @cncur_eof:         cursor is at eof: 1=yes 0=no
  * @cncur_pt_set:      if the ptomb in cncur_pt_kobj, if there is one, is relevant.
  * @cncur_stats:       metrics for this scan; exists lifetime of cursor
@@ -94,6 +95,7 @@ struct cn_cursor {
 
     /* bitflags */
     uint32_t cncur_reverse : 1;
+    uint32_t cncur_novals : 1;
     uint32_t cncur_eof : 1;
     uint32_t cncur_pt_set : 1;
     uint32_t cncur_pt_level : 1;
@@ -112,6 +114,7 @@ cn_cursor_create(
     struct cn *cn,
     uint64_t seqno,
     bool reverse,
+    bool novals,
     const void *prefix,
     uint32_t len,
     struct cursor_summary *summary,
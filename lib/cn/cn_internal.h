@@ -12,7 +12,9 @@
 
 #include <hse/mpool/mpool.h>
 #include <hse/util/atomic.h>
+#include <hse/util/mutex.h>
 #include <hse/util/perfc.h>
+#include <hse/util/spinlock.h>
 #include <hse/util/token_bucket.h>
 #include <hse/util/workqueue.h>
 
@@ -22,6 +24,8 @@ struct cndb;
 struct ikvdb;
 struct kvdb_health;
 struct csched;
+struct rcache;
+struct rtomb_set;
 
 struct cn {
     struct cn_tree *cn_tree;
@@ -32,14 +36,36 @@ struct cn {
     struct tbkt *cn_tbkt_maint;
     uint64_t cn_cnid;
 
+    /* Serializes c0 ingests with bulk loads, which mint dgens from
+     * cn_ingest_dgen too.
+     */
+    struct mutex cn_ingest_lock;
     atomic_ulong cn_ingest_dgen;
 
     atomic_int cn_refcnt;
     bool cn_replay;
 
+    /* row cache for point lookups (may be NULL) */
+    struct rcache *cn_rcache;
+
+    /* Outstanding range tombstones.  The set is replaced under
+     * cn_rtomb_lock, and its pointer is read under cn_rtomb_spin.
+     * Readers check cn_rtomb_cnt before taking the spinlock.
+     */
+    struct mutex cn_rtomb_lock;
+    spinlock_t cn_rtomb_spin;
+    atomic_int cn_rtomb_cnt;
+    struct rtomb_set *cn_rtombs;
+
     /* for asynchronous mblock I/O */
     struct workqueue_struct *cn_io_wq;
 
+    /* for building spill partitions */
+    struct workqueue_struct *cn_spill_wq;
+
+    /* for asynchronous kvset builder writes */
+    struct workqueue_struct *cn_wr_wq;
+
     /* perf counters */
     struct perfc_set cn_pc_ingest;
     struct perfc_set cn_pc_spill;
@@ -12,10 +12,18 @@
 #include <hse/util/event_counter.h>
 #include <hse/util/slab.h>
 
+#include "vbcache.h"
+
 merr_t
-cn_kvdb_create(uint cn_maint_threads, uint cn_io_threads, struct cn_kvdb **out)
+cn_kvdb_create(
+    uint cn_maint_threads,
+    uint cn_io_threads,
+    uint cn_spill_threads,
+    size_t cn_vbcache_sz,
+    struct cn_kvdb **out)
 {
     struct cn_kvdb *self;
+    merr_t err;
 
     self = calloc(1, sizeof(*self));
     if (ev(!self))
@@ -34,6 +42,38 @@ cn_kvdb_create(uint cn_maint_threads, uint cn_io_threads, struct cn_kvdb **out)
         return merr(ENOMEM);
     }
 
+    self->cn_spill_wq = alloc_workqueue("hse_cn_spill", 0, 1, cn_spill_threads);
+    if (ev(!self->cn_spill_wq)) {
+        destroy_workqueue(self->cn_io_wq);
+        destroy_workqueue(self->cn_maint_wq);
+        free(self);
+        return merr(ENOMEM);
+    }
+
+    /* Builders wait on their writes, and builders run on both the io and the
+     * spill workqueues, so writes need a workqueue of their own.
+     */
+    self->cn_wr_wq = alloc_workqueue("hse_cn_wr", 0, 1, cn_io_threads);
+    if (ev(!self->cn_wr_wq)) {
+        destroy_workqueue(self->cn_spill_wq);
+        destroy_workqueue(self->cn_io_wq);
+        destroy_workqueue(self->cn_maint_wq);
+        free(self);
+        return merr(ENOMEM);
+    }
+
+    if (cn_vbcache_sz > 0) {
+        err = vbcache_create(cn_vbcache_sz, &self->cn_vbcache);
+        if (ev(err)) {
+            destroy_workqueue(self->cn_wr_wq);
+            destroy_workqueue(self->cn_spill_wq);
+            destroy_workqueue(self->cn_io_wq);
+            destroy_workqueue(self->cn_maint_wq);
+            free(self);
+            return err;
+        }
+    }
+
     *out = self;
 
     return 0;
@@ -45,10 +85,20 @@ cn_kvdb_destroy(struct cn_kvdb *h)
     if (h) {
         destroy_workqueue(h->cn_maint_wq);
         destroy_workqueue(h->cn_io_wq);
+        destroy_workqueue(h->cn_spill_wq);
+        destroy_workqueue(h->cn_wr_wq);
+        vbcache_destroy(h->cn_vbcache);
         free(h);
     }
 }
 
+void
+cn_kvdb_perfc_alloc(struct cn_kvdb *h, const char *group, uint prio)
+{
+    if (h && h->cn_vbcache)
+        vbcache_perfc_alloc(h->cn_vbcache, group, prio);
+}
+
 #if HSE_MOCKING
 #include "cn_kvdb_ut_impl.i"
 #endif /* HSE_MOCKING */
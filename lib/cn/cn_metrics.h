@@ -40,6 +40,9 @@ struct kvset_stats {
     uint64_t kst_vwlen;  //<! sum of mpr_write_len for all vblocks
     uint64_t kst_vulen;  //<! total referenced data in all vblocks
     uint64_t kst_vgarb;  //<! total unreferenced data in all vblocks
+    uint64_t kst_expire; //<! number of values with an expiration time
+    uint64_t kst_expmin; //<! earliest value expiration time
+    uint64_t kst_expmax; //<! latest value expiration time
     uint32_t kst_kvsets; //<! number of kvsets (for node-level)
     uint32_t kst_hblks;  //<! number of hblocks
     uint32_t kst_kblks;  //<! number of kblocks
@@ -145,6 +148,28 @@ cn_ns_tombs(const struct cn_node_stats *ns)
     return ns->ns_kst.kst_tombs;
 }
 
+/**
+ * Estimated number of values in node that have expired as of %now.
+ *
+ * Only the number and the range of expiration times are recorded in
+ * the kblock headers, so the estimate assumes expiration times are
+ * uniformly distributed over that range.
+ */
+static inline uint64_t
+cn_ns_expired(const struct cn_node_stats *ns, uint64_t now)
+{
+    const struct kvset_stats *kst = &ns->ns_kst;
+
+    if (!kst->kst_expire || now < kst->kst_expmin)
+        return 0;
+
+    if (now >= kst->kst_expmax)
+        return kst->kst_expire;
+
+    return (kst->kst_expire * (now - kst->kst_expmin + 1)) /
+        (kst->kst_expmax - kst->kst_expmin + 1);
+}
+
 /**
  * Number of prefix tombstones in node.
  */
@@ -234,9 +259,11 @@ struct cn_merge_stats {
 
     struct cn_merge_stats_ops ms_kblk_alloc;
     struct cn_merge_stats_ops ms_kblk_write;
+    struct cn_merge_stats_ops ms_kblk_write_wait;
 
     struct cn_merge_stats_ops ms_vblk_alloc;
     struct cn_merge_stats_ops ms_vblk_write;
+    struct cn_merge_stats_ops ms_vblk_write_wait;
 
     struct cn_merge_stats_ops ms_vblk_read1;
     struct cn_merge_stats_ops ms_vblk_read1_wait;
@@ -292,9 +319,11 @@ cn_merge_stats_diff(
 
     cn_merge_stats_ops_diff(&s->ms_kblk_alloc, &a->ms_kblk_alloc, &b->ms_kblk_alloc);
     cn_merge_stats_ops_diff(&s->ms_kblk_write, &a->ms_kblk_write, &b->ms_kblk_write);
+    cn_merge_stats_ops_diff(&s->ms_kblk_write_wait, &a->ms_kblk_write_wait, &b->ms_kblk_write_wait);
 
     cn_merge_stats_ops_diff(&s->ms_vblk_alloc, &a->ms_vblk_alloc, &b->ms_vblk_alloc);
     cn_merge_stats_ops_diff(&s->ms_vblk_write, &a->ms_vblk_write, &b->ms_vblk_write);
+    cn_merge_stats_ops_diff(&s->ms_vblk_write_wait, &a->ms_vblk_write_wait, &b->ms_vblk_write_wait);
 
     cn_merge_stats_ops_diff(&s->ms_vblk_read1, &a->ms_vblk_read1, &b->ms_vblk_read1);
     cn_merge_stats_ops_diff(&s->ms_vblk_read1_wait, &a->ms_vblk_read1_wait, &b->ms_vblk_read1_wait);
@@ -325,9 +354,11 @@ cn_merge_stats_add(struct cn_merge_stats *lhs, const struct cn_merge_stats *rhs)
 
     cn_merge_stats_ops_add(&lhs->ms_kblk_alloc, &rhs->ms_kblk_alloc);
     cn_merge_stats_ops_add(&lhs->ms_kblk_write, &rhs->ms_kblk_write);
+    cn_merge_stats_ops_add(&lhs->ms_kblk_write_wait, &rhs->ms_kblk_write_wait);
 
     cn_merge_stats_ops_add(&lhs->ms_vblk_alloc, &rhs->ms_vblk_alloc);
     cn_merge_stats_ops_add(&lhs->ms_vblk_write, &rhs->ms_vblk_write);
+    cn_merge_stats_ops_add(&lhs->ms_vblk_write_wait, &rhs->ms_vblk_write_wait);
 
     cn_merge_stats_ops_add(&lhs->ms_vblk_read1, &rhs->ms_vblk_read1);
     cn_merge_stats_ops_add(&lhs->ms_vblk_read1_wait, &rhs->ms_vblk_read1_wait);
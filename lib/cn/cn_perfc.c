@@ -13,6 +13,7 @@
 
 #include "cn_internal.h"
 #include "cn_perfc_internal.h"
+#include "rcache.h"
 
 /* clang-format off */
 
@@ -124,6 +125,9 @@ cn_perfc_alloc(struct cn *cn, uint prio)
     perfc_alloc(cn_perfc_shape, group, "rnode", prio, &cn->cn_pc_shape_rnode);
     perfc_alloc(cn_perfc_shape, group, "lnode", prio, &cn->cn_pc_shape_lnode);
     perfc_alloc(cn_perfc_capped, group, "capped", prio, &cn->cn_pc_capped);
+
+    if (cn->cn_rcache)
+        rcache_perfc_alloc(cn->cn_rcache, group, prio);
 }
 
 void
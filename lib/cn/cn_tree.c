@@ -102,6 +102,7 @@ cn_node_alloc(struct cn_tree *tree, uint64_t nodeid)
 
     tn->tn_split_size = (size_t)tree->rp->cn_split_size << 30;
     atomic_set(&tn->tn_readers, 0);
+    atomic_set(&tn->tn_heat, 0);
 
     INIT_LIST_HEAD(&tn->tn_kvset_list);
 
@@ -926,6 +927,69 @@ cn_tree_route_get(struct cn_tree *tree, const void *key, uint keylen)
     return node;
 }
 
+uint
+cn_tree_split_keys(
+    struct cn_tree *tree,
+    const void *min,
+    uint minlen,
+    const void *max,
+    uint maxlen,
+    uint splitc,
+    void *keyv,
+    uint *klenv)
+{
+    struct route_node *first, *last, *rn;
+    uint64_t total = 0, sum = 0;
+    uint n = 0;
+    void *lock;
+
+    if (!splitc)
+        return 0;
+
+    rmlock_rlock(&tree->ct_lock, &lock);
+
+    first = min ? route_map_lookup(tree->ct_route_map, min, minlen)
+                : route_map_first_node(tree->ct_route_map);
+    last = max ? route_map_lookup(tree->ct_route_map, max, maxlen) : NULL;
+    if (!last)
+        last = route_map_last_node(tree->ct_route_map);
+
+    if (!first || !last)
+        goto out;
+
+    /* Weigh each leaf by its key count, plus one so that a range of empty
+     * leaves is still split by leaf count.  The root's keys are spread over
+     * the whole key space and do not affect where to split.
+     */
+    for (rn = first; rn; rn = route_node_next(rn)) {
+        struct cn_tree_node *tn = route_node_tnode(rn);
+
+        total += cn_ns_keys(&tn->tn_ns) + 1;
+        if (rn == last)
+            break;
+    }
+
+    /* Emit the edge key of the leaf in which the cumulative weight crosses
+     * each of the splitc + 1 equal parts of the total.  The last leaf's edge
+     * key is not emitted as it would not split the range.
+     */
+    for (rn = first; rn != last && n < splitc; rn = route_node_next(rn)) {
+        struct cn_tree_node *tn = route_node_tnode(rn);
+
+        sum += cn_ns_keys(&tn->tn_ns) + 1;
+        if (sum * (splitc + 1) < total * (n + 1))
+            continue;
+
+        route_node_keycpy(rn, keyv + n * HSE_KVS_KEY_LEN_MAX, HSE_KVS_KEY_LEN_MAX, &klenv[n]);
+        n++;
+    }
+
+out:
+    rmlock_runlock(lock);
+
+    return n;
+}
+
 merr_t
 cn_tree_prefix_probe(
     struct cn_tree *tree,
@@ -973,6 +1037,7 @@ cn_tree_prefix_probe(
             if (qctx->seen > 1 || *res == FOUND_PTMB) {
                 if (!atomic_read(&node->tn_readers))
                     atomic_inc(&node->tn_readers);
+                cn_node_heat_inc(node);
                 goto done;
             }
         }
@@ -1016,10 +1081,11 @@ done:
  * @pc:   perf counters
  * @kt:   key to search for
  * @seq:  view sequence number
+ * @direct: read vblock values from media rather than the mcache maps
  * @res:  (output) result (found value, found tomb, or not found)
- * @qctx: query context (if this is a prefix probe)
- * @kbuf: (output) key if this is a prefix probe
- * @vbuf: (output) value if result @res == %FOUND_VAL or %FOUND_MULTIPLE
+ * @vref: (output) seqno and expiration time of the value if result
+ *        @res == %FOUND_VAL (may be NULL)
+ * @vbuf: (output) value if result @res == %FOUND_VAL
  */
 merr_t
 cn_tree_lookup(
@@ -1027,11 +1093,13 @@ cn_tree_lookup(
     struct perfc_set *pc,
     struct kvs_ktuple *kt,
     uint64_t seq,
+    bool direct,
     enum key_lookup_res *res,
-    struct kvs_buf *kbuf,
+    struct kvs_vtuple_ref *vref,
     struct kvs_buf *vbuf)
 {
     enum kvdb_perfc_sidx_cnget pc_cidx;
+    struct kvs_vtuple_ref vrefbuf;
     struct cn_tree_node *node;
     struct key_disc kdisc;
     uint64_t pc_start;
@@ -1040,6 +1108,9 @@ cn_tree_lookup(
 
     *res = NOT_FOUND;
 
+    if (!vref)
+        vref = &vrefbuf;
+
     pc_start = perfc_lat_startu(pc, PERFC_LT_CNGET_GET);
     pc_cidx = PERFC_LT_CNGET_GET_LEAF + 1;
 
@@ -1063,13 +1134,14 @@ cn_tree_lookup(
         list_for_each_entry(le, &node->tn_kvset_list, le_link) {
             struct kvset *kvset = le->le_kvset;
 
-            err = kvset_lookup(kvset, kt, &kdisc, seq, res, vbuf);
+            err = kvset_lookup(kvset, kt, &kdisc, seq, direct, res, vref, vbuf);
             if (err)
                 goto done;
 
             if (*res != NOT_FOUND) {
                 if (!atomic_read(&node->tn_readers))
                     atomic_inc(&node->tn_readers);
+                cn_node_heat_inc(node);
                 goto done;
             }
 
@@ -1099,6 +1171,203 @@ done:
     return err;
 }
 
+/* Per-key state for cn_tree_lookup_multi().
+ */
+struct cn_lookup_req {
+    struct kvs_ktuple *kt;
+    enum key_lookup_res *res;
+    struct kvs_buf *vbuf;
+    struct key_disc kdisc;
+};
+
+static int
+cn_lookup_req_cmp(const void *lhs, const void *rhs)
+{
+    const struct cn_lookup_req *l = lhs;
+    const struct cn_lookup_req *r = rhs;
+
+    return keycmp(l->kt->kt_data, l->kt->kt_len, r->kt->kt_data, r->kt->kt_len);
+}
+
+/* Probe every kvset of a node for each pending request in reqv[].  Kvsets
+ * are visited newest to oldest in the outer loop so that the bloom filter
+ * and wbtree pages of a kvset are reused across the whole batch.  A request
+ * stops participating once it is resolved by a newer kvset.
+ */
+static merr_t
+cn_tree_node_lookup_multi(
+    struct cn_tree_node *node,
+    struct cn_lookup_req *reqv,
+    uint reqc,
+    uint64_t seq,
+    uint *pendingp)
+{
+    struct kvset_list_entry *le;
+    struct kvs_vtuple_ref vref;
+    uint pending = *pendingp;
+    bool found = false;
+    merr_t err = 0;
+
+    list_for_each_entry(le, &node->tn_kvset_list, le_link) {
+        struct kvset *kvset = le->le_kvset;
+        uint i, left = 0;
+
+        for (i = 0; i < reqc; ++i) {
+            struct cn_lookup_req *req = reqv + i;
+
+            if (*req->res != NOT_FOUND)
+                continue;
+
+            err = kvset_lookup(kvset, req->kt, &req->kdisc, seq, false, req->res, &vref, req->vbuf);
+            if (err)
+                goto done;
+
+            if (*req->res != NOT_FOUND) {
+                found = true;
+                pending--;
+                continue;
+            }
+
+            left++;
+        }
+
+        if (!left)
+            break;
+    }
+
+done:
+    if (found) {
+        if (!atomic_read(&node->tn_readers))
+            atomic_inc(&node->tn_readers);
+        cn_node_heat_inc(node);
+    }
+
+    *pendingp = pending;
+
+    return err;
+}
+
+/**
+ * cn_tree_lookup_multi() - search cn tree for a batch of keys
+ * @tree:  cn tree
+ * @pc:    perf counters
+ * @cnt:   number of elements in ktv[], resv[] and vbufv[]
+ * @ktv:   keys to search for
+ * @seq:   view sequence number
+ * @resv:  (in/out) per key result, only keys whose result is %NOT_FOUND on entry are searched
+ * @vbufv: (output) per key value if the result is %FOUND_VAL
+ *
+ * The batch is sorted by key and the tree lock is acquired once for the
+ * whole batch.  All keys are first probed against the root node, then
+ * routed to their leaf nodes in a single ordered pass over the route map.
+ */
+merr_t
+cn_tree_lookup_multi(
+    struct cn_tree *tree,
+    struct perfc_set *pc,
+    uint cnt,
+    struct kvs_ktuple *ktv,
+    uint64_t seq,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv)
+{
+    struct cn_lookup_req reqbuf[32], *reqv = reqbuf;
+    struct route_node *rn;
+    struct cn_tree_node *node;
+    uint reqc, pending, i;
+    void *lock;
+    merr_t err;
+
+    for (i = reqc = 0; i < cnt; ++i)
+        reqc += (resv[i] == NOT_FOUND);
+
+    if (!reqc)
+        return 0;
+
+    if (reqc > NELEM(reqbuf)) {
+        reqv = malloc(reqc * sizeof(*reqv));
+        if (ev(!reqv))
+            return merr(ENOMEM);
+    }
+
+    for (i = reqc = 0; i < cnt; ++i) {
+        struct cn_lookup_req *req = reqv + reqc;
+
+        if (resv[i] != NOT_FOUND)
+            continue;
+
+        req->kt = ktv + i;
+        req->res = resv + i;
+        req->vbuf = vbufv + i;
+        key_disc_init(req->kt->kt_data, req->kt->kt_len, &req->kdisc);
+        reqc++;
+    }
+
+    if (reqc > 1)
+        qsort(reqv, reqc, sizeof(*reqv), cn_lookup_req_cmp);
+
+    pending = reqc;
+
+    rmlock_rlock(&tree->ct_lock, &lock);
+    node = tree->ct_root;
+
+    err = cn_tree_node_lookup_multi(node, reqv, reqc, seq, &pending);
+    if (err || !pending || cn_node_isleaf(node))
+        goto done;
+
+    /* Route the sorted keys to leaf nodes, advancing through the route map
+     * rather than searching it from the top for each key.
+     */
+    rn = NULL;
+    i = 0;
+
+    while (i < reqc && pending > 0) {
+        struct cn_lookup_req *req = reqv + i;
+        uint j;
+
+        if (*req->res != NOT_FOUND) {
+            i++;
+            continue;
+        }
+
+        if (!rn) {
+            rn = route_map_lookup(tree->ct_route_map, req->kt->kt_data, req->kt->kt_len);
+            if (!rn)
+                break;
+        } else {
+            while (!route_node_islast(rn) &&
+                   route_node_keycmp(req->kt->kt_data, req->kt->kt_len, rn) > 0)
+                rn = route_node_next(rn);
+        }
+
+        for (j = i + 1; j < reqc; ++j) {
+            if (!route_node_islast(rn) &&
+                route_node_keycmp(reqv[j].kt->kt_data, reqv[j].kt->kt_len, rn) > 0)
+                break;
+        }
+
+        node = route_node_tnode(rn);
+        assert(node);
+
+        err = cn_tree_node_lookup_multi(node, reqv + i, j - i, seq, &pending);
+        if (err)
+            break;
+
+        i = j;
+    }
+
+done:
+    rmlock_runlock(lock);
+
+    for (i = 0; i < reqc; ++i)
+        perfc_inc(pc, *reqv[i].res);
+
+    if (reqv != reqbuf)
+        free(reqv);
+
+    return err;
+}
+
 bool
 cn_tree_is_capped(const struct cn_tree *tree)
 {
@@ -1891,6 +2160,7 @@ cn_comp_commit(struct cn_compaction_work *w)
             km.km_dgen_hi = w->cw_dgen_hi;
             km.km_dgen_lo = w->cw_dgen_lo;
             km.km_rule = w->cw_rule;
+            km.km_rtomb_seqno = w->cw_horizon;
         }
 
         /* CNDB: Log kvset add records.
@@ -2109,6 +2379,9 @@ cn_comp_cleanup(struct cn_compaction_work *w)
             cn_node_comp_token_put(w->cw_join);
     }
 
+    cn_rtombs_put(w->cw_rtombs);
+    w->cw_rtombs = NULL;
+
     atomic_sub_rel(&w->cw_node->tn_busycnt, (1u << 16) + w->cw_kvset_cnt);
 
     if (w->cw_have_token)
@@ -2362,6 +2635,556 @@ cn_comp_zspill(struct cn_compaction_work *w)
     return true;
 }
 
+/* A spill is split into key range partitions along route map edges only if
+ * its input is large enough to give each partition at least this much work.
+ */
+#define CN_SPILL_PART_MIN (256L << 20)
+
+/**
+ * struct spill_node - a leaf node visited by a partitioned spill
+ *
+ * @sn_rtn:    route node
+ * @sn_tn:     tree node
+ * @sn_dgen:   dgen of the newest kvset in the node when it was pinned
+ * @sn_weight: estimate of the amount of input data that maps to this node
+ * @sn_ss:     subspill built for this node
+ */
+struct spill_node {
+    struct route_node *sn_rtn;
+    struct cn_tree_node *sn_tn;
+    uint64_t sn_dgen;
+    uint64_t sn_weight;
+    struct subspill *sn_ss;
+};
+
+/**
+ * struct spill_part - a key range partition of a spill
+ *
+ * @sp_work:    for queueing to the spill workqueue
+ * @sp_w:       compaction work
+ * @sp_start:   last route node of the preceding partition (NULL for the first)
+ * @sp_end:     last route node of the partition (NULL for the last)
+ * @sp_end_tn:  tree node of @sp_end
+ * @sp_nodev:   nodes visited by the partition, each pinned
+ * @sp_nodec:   number of nodes in @sp_nodev
+ * @sp_nodemax: capacity of @sp_nodev
+ * @sp_idx:     partition index
+ * @sp_pt_dgen: dgen of the node that the preceding edge key's prefix maps to
+ * @sp_busy:    partition is queued or being built (protected by ct_ss_lock)
+ * @sp_err:     result of building the partition
+ * @sp_stats:   merge stats of the partition
+ *
+ * The partition's end node is pinned by cn_comp_spill_parts() for the life
+ * of the spill such that the edge keys between partitions remain edges of
+ * the route map.  All other nodes are pinned by the partition as it reaches
+ * them.
+ */
+struct spill_part {
+    struct work_struct sp_work;
+    struct cn_compaction_work *sp_w;
+    struct route_node *sp_start;
+    struct route_node *sp_end;
+    struct cn_tree_node *sp_end_tn;
+    struct spill_node *sp_nodev;
+    uint sp_nodec;
+    uint sp_nodemax;
+    uint sp_idx;
+    uint64_t sp_pt_dgen;
+    bool sp_busy;
+    merr_t sp_err;
+    struct cn_merge_stats sp_stats;
+};
+
+bool
+cn_spill_part_must_wait(struct cn_tree_node *tn, struct route_node *end)
+{
+    if (!tn->tn_ss_splitting && tn->tn_ss_joining >= 0)
+        return false;
+
+    /* A split or join cannot start until the node's spill refs drain, so
+     * spilling into the node as is cannot race with it.
+     */
+    if (atomic_read(&tn->tn_ss_spilling))
+        return false;
+
+    /* The right node of a join is the node that follows the left node.  sp3
+     * may commit a join whose right node is our pinned end node at any time,
+     * and that join cannot start until our pin is dropped.
+     */
+    if (tn->tn_ss_joining < 0 && end && route_node_next(tn->tn_route_node) == end)
+        return false;
+
+    return true;
+}
+
+/* Pin the node that follows rtn (or the first node if rtn is NULL) and
+ * append it to the partition's node vector.  Returns NULL at the end of
+ * the partition.
+ *
+ * Unlike cn_comp_spill(), a partition holds pins on the nodes it has visited
+ * and on its end node until all partitions have been built, so it must not
+ * wait for a split or join that needs those pins to drain.  Such a split or
+ * join cannot start until our pins are dropped, so it is safe to spill into
+ * the node as is (see cn_spill_part_must_wait()).
+ */
+static struct spill_node *
+cn_spill_part_pin(struct spill_part *sp, struct route_node *rtn, merr_t *errp)
+{
+    struct cn_tree *tree = sp->sp_w->cw_tree;
+    struct kvset_list_entry *le;
+    struct route_node *rtnext;
+    struct cn_tree_node *tn;
+    struct spill_node *sn;
+    void *lock;
+
+    *errp = 0;
+
+    if (rtn && rtn == sp->sp_end)
+        return NULL;
+
+    if (sp->sp_nodec == sp->sp_nodemax) {
+        uint nmax = sp->sp_nodemax * 2 + 4;
+
+        sn = realloc(sp->sp_nodev, nmax * sizeof(*sn));
+        if (!sn) {
+            *errp = merr(ENOMEM);
+            return NULL;
+        }
+
+        sp->sp_nodev = sn;
+        sp->sp_nodemax = nmax;
+    }
+
+    while (1) {
+        rmlock_rlock(&tree->ct_lock, &lock);
+        rtnext = rtn ? route_node_next(rtn) : route_map_first_node(tree->ct_route_map);
+        if (!rtnext) {
+            rmlock_runlock(lock);
+            return NULL;
+        }
+
+        tn = route_node_tnode(rtnext);
+        if (!tn->tn_route_node)
+            abort();
+
+        mutex_lock(&tree->ct_ss_lock);
+        if (rtnext == sp->sp_end)
+            break; /* pinned by cn_comp_spill_parts() */
+
+        if (cn_spill_part_must_wait(tn, sp->sp_end)) {
+            const char *wmesg = tn->tn_ss_splitting ? "spltwait" : "joinwait";
+
+            rmlock_runlock(lock);
+
+            atomic_inc(&tree->ct_rspill_slp);
+            cv_wait(&tree->ct_ss_cv, &tree->ct_ss_lock, wmesg);
+            atomic_dec(&tree->ct_rspill_slp);
+
+            mutex_unlock(&tree->ct_ss_lock);
+            continue;
+        }
+
+        atomic_inc_acq(&tn->tn_ss_spilling);
+        break;
+    }
+    mutex_unlock(&tree->ct_ss_lock);
+
+    sn = sp->sp_nodev + sp->sp_nodec++;
+    memset(sn, 0, sizeof(*sn));
+    sn->sn_rtn = rtnext;
+    sn->sn_tn = tn;
+
+    le = list_first_entry_or_null(&tn->tn_kvset_list, typeof(*le), le_link);
+    sn->sn_dgen = le ? kvset_get_dgen(le->le_kvset) : 0;
+    rmlock_runlock(lock);
+
+    return sn;
+}
+
+/* Build the subspills of all nodes in a partition.  The first partition
+ * reads via the job's input iterators, all other partitions create their
+ * own mmap iterators positioned just beyond the preceding partition.
+ */
+static void
+cn_spill_part_build(struct spill_part *sp)
+{
+    struct cn_compaction_work *w = sp->sp_w;
+    struct kv_iterator **inputv = NULL;
+    struct spillctx *sctx = NULL;
+    struct route_node *rtn = sp->sp_start;
+    struct spill_node *sn;
+    uint8_t ekey[HSE_KVS_KEY_LEN_MAX];
+    uint eklen;
+    merr_t err;
+
+    if (sp->sp_idx == 0) {
+        err = cn_spill_create(w, &sctx);
+    } else {
+        struct workqueue_struct *vra_wq = cn_get_maint_wq(w->cw_tree->cn);
+        const uint flags = kvset_iter_flag_mmap | kvset_iter_flag_fullscan;
+
+        inputv = calloc(w->cw_kvset_cnt, sizeof(*inputv));
+        if (!inputv) {
+            err = merr(ENOMEM);
+            goto out;
+        }
+
+        for (uint i = 0; i < w->cw_kvset_cnt; i++) {
+            struct kvset *ks = kvset_iter_kvset_get(w->cw_inputv[i]);
+
+            err = kvset_iter_create(ks, NULL, vra_wq, w->cw_pc, flags, &inputv[i]);
+            if (err)
+                goto out;
+
+            kvset_iter_set_stats(inputv[i], &sp->sp_stats);
+        }
+
+        route_node_keycpy(sp->sp_start, ekey, sizeof(ekey), &eklen);
+
+        err = cn_spill_create_part(
+            w, inputv, &sp->sp_stats, ekey, eklen, sp->sp_pt_dgen, &sctx);
+    }
+
+    while (!err && (sn = cn_spill_part_pin(sp, rtn, &err))) {
+        struct subspill *ss;
+
+        rtn = sn->sn_rtn;
+
+        ss = malloc(sizeof(*ss));
+        if (!ss) {
+            err = merr(ENOMEM);
+            break;
+        }
+
+        route_node_keycpy(rtn, ekey, sizeof(ekey), &eklen);
+
+        err = cn_subspill(ss, sctx, sn->sn_tn, sn->sn_dgen, ekey, eklen);
+        if (err) {
+            free(ss);
+            break;
+        }
+
+        sn->sn_ss = ss;
+    }
+
+out:
+    cn_spill_destroy(sctx);
+
+    for (uint i = 0; inputv && i < w->cw_kvset_cnt; i++) {
+        if (inputv[i])
+            inputv[i]->kvi_ops->kvi_release(inputv[i]);
+    }
+    free(inputv);
+
+    sp->sp_err = err;
+}
+
+static void
+cn_spill_part_worker(struct work_struct *work)
+{
+    struct spill_part *sp = container_of(work, struct spill_part, sp_work);
+    struct cn_tree *tree = sp->sp_w->cw_tree;
+
+    cn_spill_part_build(sp);
+
+    mutex_lock(&tree->ct_ss_lock);
+    sp->sp_busy = false;
+    cv_broadcast(&tree->ct_ss_cv);
+    mutex_unlock(&tree->ct_ss_lock);
+}
+
+/**
+ * cn_comp_spill_parts() - spill a large job as concurrently built partitions
+ *
+ * @w:           compaction work
+ * @partitioned: set to true if the job was handled here
+ * @ss_failed:   subspill that failed to apply (if any)
+ *
+ * The leaf nodes are divided into contiguous ranges such that each range
+ * receives about the same share of the input kblocks, and the subspills of
+ * each range are built concurrently on the spill workqueue.  Only the last
+ * node of each range is pinned up front, which keeps the edge keys between
+ * ranges stable while nodes within a range may still be split or joined
+ * until the range's build reaches them.  The subspills are then applied in
+ * route order by the calling thread exactly as cn_comp_spill() would apply
+ * them, i.e., in sgen order via the node's subspill list, each in its own
+ * cndb transaction.
+ *
+ * If the last node of any range has a pending split or join, or if the job
+ * is too small to be worth partitioning, then @partitioned is left false and
+ * the caller should proceed with a sequential spill.
+ */
+static merr_t
+cn_comp_spill_parts(struct cn_compaction_work *w, bool *partitioned, struct subspill **ss_failed)
+{
+    struct cn_tree *tree = w->cw_tree;
+    struct spill_node *nodev = NULL;
+    struct spill_part *partv = NULL;
+    struct workqueue_struct *wq;
+    struct route_node *rtn;
+    uint64_t total = 0, sum = 0;
+    uint nodec = 0, nparts, start;
+    bool busy = false, enqueued = false;
+    merr_t err = 0;
+    void *lock;
+    uint i, g;
+
+    *partitioned = false;
+    *ss_failed = NULL;
+
+    if (w->cw_est.cwe_read_sz < 2 * CN_SPILL_PART_MIN)
+        return 0;
+
+    nparts = min_t(uint64_t, w->cw_rp->cn_spill_parts, w->cw_est.cwe_read_sz / CN_SPILL_PART_MIN);
+    if (nparts < 2)
+        return 0;
+
+    wq = cn_get_spill_wq(tree->cn);
+    if (!wq)
+        return 0;
+
+    rmlock_rlock(&tree->ct_lock, &lock);
+    for (rtn = route_map_first_node(tree->ct_route_map); rtn; rtn = route_node_next(rtn))
+        nodec++;
+
+    nparts = min_t(uint, nparts, nodec);
+    if (nparts > 1) {
+        nodev = calloc(nodec, sizeof(*nodev));
+        partv = calloc(nparts, sizeof(*partv));
+    }
+
+    if (!nodev || !partv) {
+        rmlock_runlock(lock);
+        free(partv);
+        free(nodev);
+        return 0;
+    }
+
+    /* Weigh each node by the number of input kblocks whose min key maps to
+     * it, plus one.  The floor of one accounts for the fixed cost of a
+     * subspill (a cndb transaction and a kvset builder) which every node
+     * incurs whether or not any kblock starts in it, and it keeps a long
+     * run of nodes covered by kblocks that start further left from being
+     * lumped into a single partition.
+     */
+    rtn = route_map_first_node(tree->ct_route_map);
+    for (i = 0; rtn; i++, rtn = route_node_next(rtn)) {
+        struct cn_tree_node *tn = route_node_tnode(rtn);
+        struct kvset_list_entry *le;
+
+        le = list_first_entry_or_null(&tn->tn_kvset_list, typeof(*le), le_link);
+
+        nodev[i].sn_rtn = rtn;
+        nodev[i].sn_tn = tn;
+        nodev[i].sn_dgen = le ? kvset_get_dgen(le->le_kvset) : 0;
+        nodev[i].sn_weight = 1;
+    }
+
+    for (uint k = 0; k < w->cw_kvset_cnt; k++) {
+        struct kvset *ks = kvset_iter_kvset_get(w->cw_inputv[k]);
+
+        for (uint j = 0; j < kvset_get_num_kblocks(ks); j++) {
+            uint lo = 0, hi = nodec - 1;
+            const void *key;
+            uint16_t klen;
+
+            kvset_kblk_minkey(ks, j, &key, &klen);
+
+            while (lo < hi) {
+                uint mid = (lo + hi) / 2;
+
+                if (route_node_keycmp(key, klen, nodev[mid].sn_rtn) <= 0)
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+
+            nodev[lo].sn_weight++;
+        }
+    }
+
+    for (i = 0; i < nodec; i++)
+        total += nodev[i].sn_weight;
+
+    for (i = 0, g = 0, start = 0; i < nodec && g < nparts - 1; i++) {
+        sum += nodev[i].sn_weight;
+
+        if (sum * nparts >= total * (g + 1) || nodec - i - 1 == nparts - g - 1) {
+            partv[g].sp_end = nodev[i].sn_rtn;
+            partv[g].sp_end_tn = nodev[i].sn_tn;
+            partv[g].sp_nodemax = i + 1 - start;
+            start = i + 1;
+            g++;
+        }
+    }
+
+    partv[g].sp_nodemax = nodec - start;
+    nparts = g + 1;
+
+    /* A ptomb key that spans a partition boundary maps to the node that
+     * contains the prefix of the boundary's edge key.
+     */
+    for (g = 1, i = 0; g < nparts; g++) {
+        uint8_t pfx[HSE_KVS_KEY_LEN_MAX];
+        uint pfxlen;
+        uint j;
+
+        partv[g].sp_start = partv[g - 1].sp_end;
+
+        while (nodev[i].sn_rtn != partv[g].sp_start)
+            i++;
+
+        j = i;
+
+        if (w->cw_pfx_len) {
+            route_node_keycpy(nodev[j].sn_rtn, pfx, sizeof(pfx), &pfxlen);
+            pfxlen = min_t(uint, pfxlen, w->cw_pfx_len);
+
+            while (j > 0 && route_node_keycmp(pfx, pfxlen, nodev[j - 1].sn_rtn) <= 0)
+                j--;
+
+            partv[g].sp_pt_dgen = nodev[j].sn_dgen;
+        }
+    }
+
+    /* Pin the last node of every partition but the last (see cn_comp_spill()
+     * for why a spill ref taken under the tree lock keeps a node pinned).
+     * Pending splits and joins of these nodes are left to the sequential
+     * spill, which knows how to wait for them.
+     */
+    mutex_lock(&tree->ct_ss_lock);
+    for (g = 0; g < nparts - 1; g++) {
+        struct cn_tree_node *tn = partv[g].sp_end_tn;
+
+        if (tn->tn_ss_splitting || tn->tn_ss_joining) {
+            busy = true;
+            break;
+        }
+    }
+
+    for (g = 0; g < nparts - 1 && !busy; g++)
+        atomic_inc_acq(&partv[g].sp_end_tn->tn_ss_spilling);
+    mutex_unlock(&tree->ct_ss_lock);
+    rmlock_runlock(lock);
+
+    free(nodev);
+
+    if (busy) {
+        free(partv);
+        return 0;
+    }
+
+    for (g = 0; g < nparts; g++) {
+        partv[g].sp_w = w;
+        partv[g].sp_idx = g;
+        partv[g].sp_nodev = malloc(partv[g].sp_nodemax * sizeof(*partv[g].sp_nodev));
+        if (!partv[g].sp_nodev)
+            partv[g].sp_nodemax = 0;
+    }
+
+    for (g = 1; g < nparts; g++) {
+        INIT_WORK(&partv[g].sp_work, cn_spill_part_worker);
+        partv[g].sp_busy = true;
+        queue_work(wq, &partv[g].sp_work);
+    }
+
+    cn_spill_part_build(&partv[0]);
+
+    mutex_lock(&tree->ct_ss_lock);
+    for (g = 1; g < nparts; g++) {
+        while (partv[g].sp_busy)
+            cv_wait(&tree->ct_ss_cv, &tree->ct_ss_lock, "spillprt");
+    }
+    mutex_unlock(&tree->ct_ss_lock);
+
+    for (g = 0; g < nparts; g++) {
+        if (!err)
+            err = partv[g].sp_err;
+
+        if (g > 0)
+            cn_merge_stats_add(&w->cw_stats, &partv[g].sp_stats);
+    }
+
+    /* Apply (or enqueue) the subspills and drop the node pins in the same
+     * order as a sequential spill.  On error, the remaining subspills are
+     * discarded and their nodes unpinned, including the end nodes of the
+     * partitions that failed before reaching them.
+     */
+    for (g = 0; g < nparts; g++) {
+        struct spill_part *sp = partv + g;
+
+        if (sp->sp_end && (!sp->sp_nodec || sp->sp_nodev[sp->sp_nodec - 1].sn_rtn != sp->sp_end))
+            atomic_dec_rel(&sp->sp_end_tn->tn_ss_spilling);
+
+        for (i = 0; i < sp->sp_nodec; i++) {
+            struct cn_tree_node *tn = sp->sp_nodev[i].sn_tn;
+            atomic_uint *spillingp = &tn->tn_ss_spilling;
+            struct subspill *ss = sp->sp_nodev[i].sn_ss;
+
+            if (err) {
+                if (ss) {
+                    blk_list_free(&ss->ss_mblks.kblks);
+                    blk_list_free(&ss->ss_mblks.vblks);
+                    free(ss);
+                }
+
+                atomic_dec_rel(spillingp);
+                continue;
+            }
+
+            if (ss->ss_sgen == atomic_read(&tn->tn_sgen) + 1) {
+                err = cn_subspill_apply(ss);
+                if (err) {
+                    *ss_failed = ss;
+                    atomic_dec_rel(spillingp);
+                    continue;
+                }
+
+                atomic_inc_rel(&tn->tn_sgen);
+                free(ss);
+            } else {
+                atomic_inc(spillingp);
+                cn_subspill_enqueue(ss, tn);
+                enqueued = true;
+            }
+
+            /* Apply subspills that are ready. */
+            while ((ss = cn_subspill_pop(tn))) {
+                err = cn_subspill_apply(ss);
+                if (err) {
+                    *ss_failed = ss;
+                    atomic_dec_rel(spillingp);
+                    break;
+                }
+
+                atomic_inc_rel(&tn->tn_sgen);
+                atomic_dec_rel(spillingp);
+                free(ss);
+            }
+
+            atomic_dec_rel(spillingp);
+        }
+
+        free(sp->sp_nodev);
+    }
+
+    /* An older spill may have gone to sleep awaiting a split or join of a
+     * node while our pin held it off.  It must now notice our enqueued
+     * subspill so that it proceeds rather than waiting on the split.
+     */
+    if (enqueued) {
+        mutex_lock(&tree->ct_ss_lock);
+        cv_broadcast(&tree->ct_ss_cv);
+        mutex_unlock(&tree->ct_ss_lock);
+    }
+
+    free(partv);
+
+    *partitioned = true;
+
+    return err;
+}
+
 static merr_t
 cn_comp_spill(struct cn_compaction_work *w)
 {
@@ -2377,6 +3200,15 @@ cn_comp_spill(struct cn_compaction_work *w)
     if (is_zspill) {
         znode = w->cw_zspill.znode;
     } else {
+        bool partitioned;
+
+        err = cn_comp_spill_parts(w, &partitioned, &ss);
+        if (partitioned) {
+            w->cw_t3_build = get_time_ns();
+            ss_saved = ss;
+            goto errout;
+        }
+
         err = cn_spill_create(w, &sctx);
         if (err)
             return err;
@@ -2632,6 +3464,7 @@ cn_comp_compact(struct cn_compaction_work *w)
     w->cw_keep_vblks = (w->cw_action == CN_ACTION_COMPACT_K);
 
     w->cw_horizon = cn_get_seqno_horizon(w->cw_tree->cn);
+    w->cw_rtombs = cn_rtombs_get(w->cw_tree->cn);
     w->cw_cancel_request = cn_get_cancel(w->cw_tree->cn);
 
     perfc_inc(w->cw_pc, PERFC_BA_CNCOMP_START);
@@ -2733,12 +3566,67 @@ cn_compact(struct cn_compaction_work *w)
         cn_comp_commit(w);
     }
 
+    /* Range tombstones this compaction finished applying can now be retired.
+     */
+    if (w->cw_rtombs && !w->cw_err)
+        cn_rtomb_retire(w->cw_tree->cn);
+
     cn_comp_cleanup(w);
 
     w->cw_t5_finish = get_time_ns();
     perfc_lat_record(pc, PERFC_LT_CNCOMP_TOTAL, w->cw_t1_qtime);
 }
 
+bool
+cn_tree_overlaps_newer(
+    struct cn_tree *tree,
+    const void *kmin,
+    uint kminlen,
+    const void *kmax,
+    uint kmaxlen,
+    uint64_t seqno)
+{
+    struct cn_tree_node *tn;
+    bool overlaps = false;
+    void *lock;
+
+    rmlock_rlock(&tree->ct_lock, &lock);
+    cn_tree_foreach_node(tn, tree) {
+        struct kvset_list_entry *le;
+
+        list_for_each_entry(le, &tn->tn_kvset_list, le_link) {
+            struct kvset *ks = le->le_kvset;
+            const void *key;
+            uint16_t klen;
+
+            if (kvset_get_seqno_max(ks) < seqno)
+                continue;
+
+            kvset_minkey(ks, &key, &klen);
+            if (keycmp(key, klen, kmax, kmaxlen) > 0)
+                continue;
+
+            kvset_maxkey(ks, &key, &klen);
+            overlaps = keycmp(key, klen, kmin, kminlen) >= 0;
+
+            /* A ptomb covers keys which sort after the ptomb itself.
+             */
+            if (!overlaps) {
+                kvset_max_ptkey(ks, &key, &klen);
+                overlaps = key && keycmp_prefix(key, klen, kmin, kminlen) >= 0;
+            }
+
+            if (overlaps)
+                goto done;
+        }
+    }
+
+done:
+    rmlock_runlock(lock);
+
+    return overlaps;
+}
+
 /**
  * cn_tree_ingest_update() - Update the cn tree with the new kvset
  * @tree:  pointer to struct cn_tree.
@@ -2854,11 +3742,39 @@ cn_tree_node_mclass(struct cn_tree_node *tn, enum hse_mclass_policy_dtype dtype)
     INVARIANT(tn);
 
     policy = cn_get_mclass_policy(tn->tn_tree->cn);
-    age = cn_node_isroot(tn) ? HSE_MPOLICY_AGE_ROOT : HSE_MPOLICY_AGE_LEAF;
+    age = cn_tree_node_agegroup(tn);
 
     return mclass_policy_get_type(policy, age, dtype);
 }
 
+bool
+cn_tree_kvset_misplaced(struct cn_tree_node *tn, const struct kvset *ks)
+{
+    enum hse_mclass mclass;
+
+    mclass = kvset_get_mclass(ks, HSE_MPOLICY_DTYPE_KEY);
+    if (mclass != cn_tree_node_mclass(tn, HSE_MPOLICY_DTYPE_KEY))
+        return true;
+
+    mclass = kvset_get_mclass(ks, HSE_MPOLICY_DTYPE_VALUE);
+
+    return mclass != HSE_MCLASS_INVALID && mclass != cn_tree_node_mclass(tn, HSE_MPOLICY_DTYPE_VALUE);
+}
+
+uint
+cn_tree_node_misplaced(struct cn_tree_node *tn)
+{
+    struct kvset_list_entry *le;
+    uint misplaced = 0;
+
+    list_for_each_entry(le, &tn->tn_kvset_list, le_link) {
+        if (cn_tree_kvset_misplaced(tn, le->le_kvset))
+            misplaced++;
+    }
+
+    return misplaced;
+}
+
 uint
 cn_tree_node_scatter(const struct cn_tree_node *tn)
 {
@@ -22,6 +22,7 @@ struct cn_tree_node;
 enum key_lookup_res;
 struct kvs_buf;
 struct kvs_ktuple;
+struct kvs_vtuple_ref;
 struct perfc_set;
 struct query_ctx;
 
@@ -34,6 +35,37 @@ cn_tree_route_get(struct cn_tree *tree, const void *key, uint keylen);
 void
 cn_tree_route_put(struct cn_tree *tree, struct route_node *node);
 
+/**
+ * cn_tree_split_keys() - propose keys which split a key range into parts
+ * holding roughly equal numbers of keys
+ *
+ * @tree:   cn tree handle
+ * @min:    start of the range (NULL for the first key in the tree)
+ * @minlen: length of %min
+ * @max:    end of the range, inclusive (NULL for the last key in the tree)
+ * @maxlen: length of %max
+ * @splitc: maximum number of keys to propose
+ * @keyv:   (output) array of %splitc buffers of HSE_KVS_KEY_LEN_MAX bytes
+ * @klenv:  (output) array of %splitc key lengths
+ *
+ * The proposed keys are leaf node edge keys from the route map, in
+ * ascending order, each of which is the inclusive upper bound of a part.
+ * They are weighed by the key counts of the leaves, so fewer keys than
+ * requested are returned if the range spans too few leaves.
+ *
+ * Return: number of keys proposed
+ */
+uint
+cn_tree_split_keys(
+    struct cn_tree *tree,
+    const void *min,
+    uint minlen,
+    const void *max,
+    uint maxlen,
+    uint splitc,
+    void *keyv,
+    uint *klenv);
+
 /* MTF_MOCK */
 merr_t
 cn_tree_lookup(
@@ -41,10 +73,22 @@ cn_tree_lookup(
     struct perfc_set *pc,
     struct kvs_ktuple *kt,
     uint64_t seq,
+    bool direct,
     enum key_lookup_res *res,
-    struct kvs_buf *kbuf,
+    struct kvs_vtuple_ref *vref,
     struct kvs_buf *vbuf);
 
+/* MTF_MOCK */
+merr_t
+cn_tree_lookup_multi(
+    struct cn_tree *tree,
+    struct perfc_set *pc,
+    uint cnt,
+    struct kvs_ktuple *ktv,
+    uint64_t seq,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv);
+
 /* MTF_MOCK */
 merr_t
 cn_tree_prefix_probe(
@@ -57,6 +101,28 @@ cn_tree_prefix_probe(
     struct kvs_buf *kbuf,
     struct kvs_buf *vbuf);
 
+/**
+ * cn_tree_overlaps_newer() - check for data at or above a seqno in a key range
+ * @tree:    cn tree
+ * @kmin:    smallest key of the range
+ * @kminlen: length of @kmin
+ * @kmax:    largest key of the range
+ * @kmaxlen: length of @kmax
+ * @seqno:   seqno
+ *
+ * Return: true if a kvset holding data with seqnos at or above @seqno may
+ * have keys or ptombs within [@kmin, @kmax].
+ */
+/* MTF_MOCK */
+bool
+cn_tree_overlaps_newer(
+    struct cn_tree *tree,
+    const void *kmin,
+    uint kminlen,
+    const void *kmax,
+    uint kmaxlen,
+    uint64_t seqno);
+
 /* Return true if the cn_tree is capped. */
 bool
 cn_tree_is_capped(const struct cn_tree *tree);
@@ -26,6 +26,7 @@ struct kv_iterator;
 struct kvset_list_entry;
 struct kvset_mblocks;
 struct kvset;
+struct rtomb_set;
 
 enum cn_action {
     CN_ACTION_NONE = 0,
@@ -103,6 +104,7 @@ struct cn_work_est {
  * @cw_dgen_lo:      the min of dgen_lo of all the compacted kvsets
  * @cw_active_count: for tracking the number of active "root" or "other" threads
  * @cw_horizon:      sequence number horizon to use while compacting
+ * @cw_rtombs:       range tombstones to apply while compacting (may be NULL)
  * @cw_outc:         number of output kvsets
  * @cw_outv:         outputs (mblock ids used to make output kvsets)
  * @cw_inputv:       number of input kvsets
@@ -125,6 +127,7 @@ struct cn_work_est {
 struct cn_compaction_work {
     struct work_struct cw_work;
     uint64_t cw_horizon;
+    struct rtomb_set *cw_rtombs;
     uint cw_iter_flags;
     uint cw_debug;
     bool cw_canceled;
@@ -20,6 +20,7 @@
 #include <stdint.h>
 
 #include <hse/ikvdb/cn.h>
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/logging/logging.h>
 #include <hse/util/assert.h>
 #include <hse/util/bin_heap.h>
@@ -95,6 +96,15 @@ cn_kv_cmp_rev(const void *a_blob, const void *b_blob)
     return key_obj_cmp(&b->kobj, &a->kobj);
 }
 
+/* Returns true if the value is stored in a vblock, i.e., fetching it may
+ * require I/O.
+ */
+static HSE_ALWAYS_INLINE bool
+vtype_in_vblock(enum kmd_vtype vtype)
+{
+    return vtype == VTYPE_UCVAL || vtype == VTYPE_CVAL || vtype == VTYPE_ZCVAL;
+}
+
 MTF_STATIC merr_t
 cn_tree_kvset_refs(struct cn_tree_node *node, struct cn_level_cursor *lcur)
 {
@@ -103,6 +113,7 @@ cn_tree_kvset_refs(struct cn_tree_node *node, struct cn_level_cursor *lcur)
 
     if (!atomic_read(&node->tn_readers))
         atomic_inc(&node->tn_readers);
+    cn_node_heat_inc(node);
 
     lcur->cnlc_dgen_hi = lcur->cnlc_dgen_lo = 0;
     table_reset(tab);
@@ -252,6 +263,8 @@ cn_tree_cursor_create(struct cn_cursor *cur)
     cur->cncur_flags = kvset_iter_flag_mmap;
     if (cur->cncur_reverse)
         cur->cncur_flags |= kvset_iter_flag_reverse;
+    if (cur->cncur_novals)
+        cur->cncur_flags |= kvset_iter_flag_novals;
 
     lcur = &cur->cncur_lcur[0];
 
@@ -649,6 +662,7 @@ merr_t
 cn_tree_cursor_read(struct cn_cursor *cur, struct kvs_cursor_element *elem, bool *eof)
 {
     struct cn_kv_item *item;
+    enum kmd_vtype vtype;
     uint64_t seq;
     bool found;
     const void *vdata;
@@ -666,11 +680,10 @@ cn_tree_cursor_read(struct cn_cursor *cur, struct kvs_cursor_element *elem, bool
         return 0;
     }
 
-    if (HSE_UNLIKELY(cur->cncur_filter))
+    if (HSE_UNLIKELY(cur->cncur_filter && cur->cncur_filter->kcf_maxkey))
         key2kobj(&filter_ko, cur->cncur_filter->kcf_maxkey, cur->cncur_filter->kcf_maxklen);
 
     do {
-        enum kmd_vtype vtype;
         uint32_t vbidx;
         uint32_t vboff;
         bool more;
@@ -697,9 +710,21 @@ cn_tree_cursor_read(struct cn_cursor *cur, struct kvs_cursor_element *elem, bool
 
         assert(rc <= 0);
 
-        if (HSE_UNLIKELY(cur->cncur_filter && key_obj_cmp(&item->kobj, &filter_ko) > 0)) {
-            *eof = (cur->cncur_eof = 1);
-            return 0;
+        if (HSE_UNLIKELY(cur->cncur_filter)) {
+            const struct kc_filter *filt = cur->cncur_filter;
+
+            if (filt->kcf_maxkey && key_obj_cmp(&item->kobj, &filter_ko) > 0) {
+                *eof = (cur->cncur_eof = 1);
+                return 0;
+            }
+
+            /* Skip a rejected key before fetching any of its values. The
+             * advance at the top of the loop drops its older versions.
+             */
+            if (filt->kcf_pred && !item->vctx.is_ptomb && !kc_filter_pred_kobj(filt, &item->kobj)) {
+                found = false;
+                continue;
+            }
         }
 
         kv_iter = kvset_cursor_es_h2r(item->src);
@@ -712,10 +737,16 @@ cn_tree_cursor_read(struct cn_cursor *cur, struct kvs_cursor_element *elem, bool
         if (!found)
             continue; /* Key doesn't have a value in the cursor's view. */
 
-        cur->cncur_merr =
-            kvset_iter_val_get(kv_iter, &item->vctx, vtype, vbidx, vboff, &vdata, &vlen, &complen);
-        if (ev(cur->cncur_merr))
-            return cur->cncur_merr;
+        if (cur->cncur_novals && vtype_in_vblock(vtype)) {
+            /* Report the value's length without touching its vblock. */
+            vdata = NULL;
+            complen = 0;
+        } else {
+            cur->cncur_merr = kvset_iter_val_get(
+                kv_iter, &item->vctx, vtype, vbidx, vboff, &vdata, &vlen, &complen);
+            if (ev(cur->cncur_merr))
+                return cur->cncur_merr;
+        }
 
         if (cur->cncur_pt_set) {
             if (key_obj_cmp_prefix(&cur->cncur_pt_kobj, &item->kobj) == 0) {
@@ -751,6 +782,7 @@ cn_tree_cursor_read(struct cn_cursor *cur, struct kvs_cursor_element *elem, bool
     elem->kce_kobj = item->kobj;
     kvs_vtuple_init(&elem->kce_vt, (void *)vdata, vlen);
     elem->kce_complen = complen;
+    elem->kce_calgo = vtype_to_calgo(vtype);
     elem->kce_is_ptomb = false; /* cn never returns a ptomb */
     elem->kce_seqnoref = HSE_ORDNL_TO_SQNREF(seq);
 
@@ -27,6 +27,7 @@
 #include "omf.h"
 
 struct hlog;
+struct kvset;
 struct route_map;
 
 /* Each node in a cN tree contains a list of kvsets that must be protected
@@ -141,6 +142,10 @@ struct cn_tree {
  * @tn_split_size:   size in bytes at which the node should split
  * @tn_split_ns:     time beyond which a node may split again
  * @tn_readers:      non-zero if there have been readers in the node recently
+ * @tn_heat:         sampled count of reads served by the node (see cn_node_heat_inc())
+ * @tn_heat_rate:    smoothed read rate of the node (reads per second)
+ * @tn_hot:          node is hot, new kvsets are placed on the hot media class
+ * @tn_retier:       node changed temperature, its kvsets need to be rewritten
  * @tn_hlog:         hyperloglog structure
  * @tn_ns:           metrics about node to guide node compaction decisions
  * @tn_compacting:   true if if an exclusive job is running on this node
@@ -156,6 +161,10 @@ struct cn_tree_node {
     size_t tn_split_size;
     uint64_t tn_split_ns;
     atomic_uint tn_readers;
+    atomic_uint tn_heat;
+    uint32_t tn_heat_rate;
+    bool tn_hot;
+    bool tn_retier;
 
     struct list_head tn_kvset_list HSE_L1D_ALIGNED;
     uint64_t tn_update_incr_dgen;
@@ -220,9 +229,54 @@ cn_node_isleaf(const struct cn_tree_node *tn)
     return !cn_node_isroot(tn);
 }
 
+/* Only every CN_HEAT_SAMPLE'th read on a given thread updates the shared
+ * heat counter, so as to keep the node's cacheline out of the read path.
+ */
+#define CN_HEAT_SAMPLE (16u)
+
+static HSE_ALWAYS_INLINE void
+cn_node_heat_inc(struct cn_tree_node *tn)
+{
+    static thread_local uint heat_tls;
+
+    if (++heat_tls % CN_HEAT_SAMPLE == 0)
+        atomic_add(&tn->tn_heat, CN_HEAT_SAMPLE);
+}
+
+/**
+ * cn_tree_node_agegroup() - media class policy age group of a node
+ * @tn: cn tree node pointer
+ *
+ * Hot leaf nodes use the root age group so that their kvsets are placed
+ * on the same (typically faster) media class as the root node.
+ */
+static HSE_ALWAYS_INLINE enum hse_mclass_policy_age
+cn_tree_node_agegroup(const struct cn_tree_node *tn)
+{
+    return (cn_node_isroot(tn) || tn->tn_hot) ? HSE_MPOLICY_AGE_ROOT : HSE_MPOLICY_AGE_LEAF;
+}
+
 enum hse_mclass
 cn_tree_node_mclass(struct cn_tree_node *tn, enum hse_mclass_policy_dtype dtype);
 
+/**
+ * cn_tree_kvset_misplaced() - check whether a kvset resides on the wrong media class
+ * @tn: cn tree node pointer
+ * @ks: a kvset in @tn
+ */
+bool
+cn_tree_kvset_misplaced(struct cn_tree_node *tn, const struct kvset *ks);
+
+/**
+ * cn_tree_node_misplaced() - count kvsets residing on the wrong media class
+ * @tn: cn tree node pointer
+ *
+ * Return: The number of kvsets in the node whose keys or values do not
+ * reside on the media class chosen by the node's current age group.
+ */
+uint
+cn_tree_node_misplaced(struct cn_tree_node *tn);
+
 /**
  * cn_tree_node_scatter()
  * @tn: cn tree node pointer
@@ -250,6 +304,20 @@ cn_compact(struct cn_compaction_work *w);
 struct cn_tree_node *
 cn_kvset_can_zspill(struct kvset *ks, struct route_map *map);
 
+/**
+ * cn_spill_part_must_wait() - must a spill partition wait for a node's split or join
+ * @tn:  node reached by the partition, other than its end node
+ * @end: route node of the partition's end node, pinned for the life of the
+ *       spill (NULL for the last partition)
+ *
+ * Must be called with the tree's ct_ss_lock held.
+ *
+ * Return: true if @tn has a pending split or is the left node of a pending
+ * join which does not depend on the pins held by the partition.
+ */
+bool
+cn_spill_part_must_wait(struct cn_tree_node *tn, struct route_node *end);
+
 /**
  * cn_tree_find_node() - Find a cn tree node by node ID.
  *
@@ -19,8 +19,10 @@
 #include <hse/ikvdb/ikvdb.h>
 #include <hse/ikvdb/kvdb_perfc.h>
 #include <hse/ikvdb/kvdb_rparams.h>
+#include <hse/ikvdb/mclass_policy.h>
 #include <hse/ikvdb/sched_sts.h>
 #include <hse/ikvdb/throttle.h>
+#include <hse/mpool/mpool.h>
 #include <hse/rest/headers.h>
 #include <hse/rest/method.h>
 #include <hse/rest/params.h>
@@ -182,6 +184,8 @@ struct sp3_qinfo {
  * @samp_reduce:  if true, compact while samp > LWM
  * @check_garbage_ns: used to stagger start of garbage jobs
  * @check_scatter_ns: used to stagger start of scatter jobs
+ * @check_tier_ns: used to stagger start of tier jobs
+ * @shape_ns:     time of the previous tree shape check
  * @mon_lock:     mutex used with @mon_cv
  * @mon_signaled: set via sp3_monitor_wakeup()
  * @mon_cv:       monitor thread conditional var
@@ -249,6 +253,7 @@ struct sp3 {
 
     uint64_t check_garbage_ns;
     uint64_t check_scatter_ns;
+    uint64_t check_tier_ns;
     uint64_t qos_log_ttl;
 
     uint64_t ucomp_report_ns;
@@ -261,6 +266,7 @@ struct sp3 {
     bool shape_llen_bad;
     bool shape_lsiz_bad;
     bool shape_samp_bad;
+    uint64_t shape_ns;
 
     struct cn_samp_stats samp;
     struct cn_samp_stats samp_wip;
@@ -431,6 +437,8 @@ sp3_log_progress(struct cn_compaction_work *w, struct cn_merge_stats *ms, bool f
         "vblk_read2wait_ops=%u vblk_read2wait_ms=%u "
         "kblk_write_ops=%u kblk_write_sz=%ld kblk_write_ms=%u "
         "kblk_readwait_ops=%u kblk_readwait_ms=%u "
+        "kblk_writewait_ops=%u kblk_writewait_ms=%u "
+        "vblk_writewait_ops=%u vblk_writewait_ms=%u "
         "vblk_dbl_reads=%ld "
         "queue_us=%lu prep_us=%lu build_us=%lu commit_us=%lu",
         msg_type, w->cw_job.sj_id, cn_action2str(w->cw_action), cn_rule2str(w->cw_rule),
@@ -446,6 +454,8 @@ sp3_log_progress(struct cn_compaction_work *w, struct cn_merge_stats *ms, bool f
         ms->ms_vblk_read2_wait.op_cnt, ms->ms_vblk_read2_wait.op_time,
         ms->ms_kblk_read.op_cnt, ms->ms_kblk_read.op_size, ms->ms_kblk_read.op_time,
         ms->ms_kblk_read_wait.op_cnt, ms->ms_kblk_read_wait.op_time,
+        ms->ms_kblk_write_wait.op_cnt, ms->ms_kblk_write_wait.op_time,
+        ms->ms_vblk_write_wait.op_cnt, ms->ms_vblk_write_wait.op_time,
         ms->ms_vblk_wasted_reads, qt, pt, bt, ct);
     // clang-format on
 }
@@ -847,16 +857,28 @@ sp3_dirty_node_locked(struct sp3 *sp, struct cn_tree_node *tn)
             sp3_node_remove(sp, spn, wtype_length);
             sp3_node_remove(sp, spn, wtype_scatter);
             sp3_node_remove(sp, spn, wtype_garbage);
+            sp3_node_remove(sp, spn, wtype_tier);
         } else if (nkvsets > 0 && jobs < 1) {
             const uint64_t keys_uniq = cn_ns_keys_uniq(ns);
             const uint64_t keys = cn_ns_keys(ns);
             const uint64_t tombs = cn_ns_tombs(ns);
             struct cn_tree_node *left;
             uint64_t weight;
+            uint expired = 0;
 
             garbage = cn_samp_pct_garbage(&tn->tn_samp, 100);
             scatter = cn_tree_node_scatter(tn);
 
+            /* Expired values are garbage that the sampled stats know
+             * nothing about, so estimate their percentage from the range
+             * of expiration times recorded in the kblock headers.
+             */
+            if (keys > 0 && ns->ns_kst.kst_expire > 0) {
+                expired = (cn_ns_expired(ns, kvs_expire_now()) * 100) / keys;
+                expired = min_t(uint, expired, 100);
+                garbage = max_t(uint, garbage, expired);
+            }
+
             /* Leaf nodes sorted by vgroup scatter and garbage.
              */
             if (scatter > 0) {
@@ -899,7 +921,7 @@ sp3_dirty_node_locked(struct sp3 *sp, struct cn_tree_node *tn)
                 sp3_node_unlink(sp, spn);
                 sp3_node_insert(sp, spn, wtype_garbage, weight);
                 ev_debug(1);
-            } else if (garbage > 0 && nkvsets > 1) {
+            } else if ((garbage > 0 && nkvsets > 1) || expired >= SP3_LCOMP_EXPIRED_PCT_MIN) {
                 weight = ((uint64_t)garbage << 32) | (cn_ns_alen(ns) >> 20);
 
                 sp3_node_insert(sp, spn, wtype_garbage, weight);
@@ -909,6 +931,22 @@ sp3_dirty_node_locked(struct sp3 *sp, struct cn_tree_node *tn)
                 ev_debug(1);
             }
 
+            /* Leaf nodes that changed temperature sorted by number of
+             * kvsets residing on the wrong media class.
+             */
+            if (tn->tn_retier) {
+                const uint misplaced = cn_tree_node_misplaced(tn);
+
+                if (misplaced > 0) {
+                    sp3_node_insert(sp, spn, wtype_tier, misplaced);
+                } else {
+                    sp3_node_remove(sp, spn, wtype_tier);
+                    tn->tn_retier = false;
+                }
+            } else {
+                sp3_node_remove(sp, spn, wtype_tier);
+            }
+
             /* Schedule a split if this node is splittable and there is
              * room in the tree for more nodes.  Splits prevent all other
              * potentially large compaction jobs as they could otherwise
@@ -922,6 +960,7 @@ sp3_dirty_node_locked(struct sp3 *sp, struct cn_tree_node *tn)
                     ev_debug(1);
                 }
                 sp3_node_remove(sp, spn, wtype_scatter);
+                sp3_node_remove(sp, spn, wtype_tier);
                 sp3_node_insert(sp, spn, wtype_split, keys);
                 ev_debug(1);
             } else {
@@ -1534,6 +1573,9 @@ sp3_comp_thread_name(
     case CN_RULE_JOIN:
         r = "nj";
         break;
+    case CN_RULE_TIER:
+        r = "tr";
+        break;
     case CN_RULE_MAX:
         r = "xx";
         break;
@@ -1878,6 +1920,78 @@ sp3_tree_shape_log(const struct cn_tree_node *tn, bool bad, const char *category
     // clang-format on
 }
 
+/* Promoting a node rewrites all of its kvsets onto the hot media class,
+ * so we promote it only if that media class has at least twice the node's
+ * size available (i.e., room for the node to grow, and for everything else
+ * that lands on the hot media class in the meantime).  Otherwise the tier
+ * job would likely fail with ENOSPC, which is fatal to the kvdb.
+ */
+static bool
+sp3_node_hot_fits(const struct cn_tree_node *tn)
+{
+    struct mclass_policy *policy = cn_get_mclass_policy(tn->tn_tree->cn);
+    const uint64_t need = 2 * cn_ns_alen(&tn->tn_ns);
+    enum hse_mclass_policy_dtype dtype;
+
+    for (dtype = HSE_MPOLICY_DTYPE_KEY; dtype < HSE_MPOLICY_DTYPE_CNT; dtype++) {
+        enum hse_mclass hot, cold;
+        uint64_t avail;
+        merr_t err;
+
+        hot = mclass_policy_get_type(policy, HSE_MPOLICY_AGE_ROOT, dtype);
+        cold = mclass_policy_get_type(policy, HSE_MPOLICY_AGE_LEAF, dtype);
+        if (hot == cold)
+            continue;
+
+        err = mpool_mclass_avail_get(tn->tn_tree->mp, hot, &avail);
+        if (ev(err) || avail < need)
+            return false;
+    }
+
+    return true;
+}
+
+/* Update a leaf node's smoothed read rate and reclassify it as hot or cold.
+ * The cold threshold is a quarter of the hot threshold so as to keep nodes
+ * whose read rate hovers near the threshold from flapping between media
+ * classes.  Nodes that change temperature are marked for retiering, which
+ * rewrites their kvsets onto the media class of their new age group.  A
+ * cold node that the hot media class has no room for remains cold, and is
+ * reconsidered on the next update.
+ */
+static void
+sp3_node_heat_update(struct sp3 *sp, struct cn_tree_node *tn, uint64_t dt)
+{
+    const uint hot_rate = tn->tn_tree->rp->cn_tier_hot_rate;
+    uint heat;
+    bool hot;
+
+    heat = atomic_read(&tn->tn_heat);
+    if (heat > 0)
+        atomic_sub(&tn->tn_heat, heat);
+
+    if (dt > 0) {
+        uint64_t rate = (uint64_t)heat * NSEC_PER_SEC / dt;
+
+        rate = (tn->tn_heat_rate + rate) / 2;
+        tn->tn_heat_rate = min_t(uint64_t, rate, UINT32_MAX);
+    }
+
+    if (hot_rate == 0)
+        hot = false;
+    else if (tn->tn_hot)
+        hot = tn->tn_heat_rate >= hot_rate / 4;
+    else
+        hot = tn->tn_heat_rate >= hot_rate && sp3_node_hot_fits(tn);
+
+    if (hot != tn->tn_hot) {
+        tn->tn_hot = hot;
+        tn->tn_retier = (hot_rate > 0);
+        sp3_dirty_node_locked(sp, tn);
+        ev_debug(1);
+    }
+}
+
 /**
  * sp3_tree_shape_check() - report on tree shape
  * @sp: scheduler context
@@ -1912,6 +2026,8 @@ sp3_tree_shape_check(struct sp3 *sp)
     uint lsiz = sp->shape_lsiz_bad ? 0 : lsiz_thresh;
     bool rlen_bad, llen_bad, lsiz_bad, samp_bad;
     bool log = debug_tree_shape(sp);
+    const uint64_t now = get_time_ns();
+    const uint64_t dt = sp->shape_ns ? now - sp->shape_ns : 0;
 
     struct cn_tree *tree;
 
@@ -1961,6 +2077,8 @@ sp3_tree_shape_check(struct sp3 *sp)
                 atomic_sub(&tn->tn_readers, readers);
                 ev_debug(1);
             }
+
+            sp3_node_heat_update(sp, tn, dt);
         }
         rmlock_runlock(lock);
 
@@ -2016,6 +2134,8 @@ sp3_tree_shape_check(struct sp3 *sp)
         rmlock_wunlock(&tree->ct_lock);
     }
 
+    sp->shape_ns = now;
+
     rlen_bad = rlen > rlen_thresh;
     llen_bad = llen > llen_thresh;
     lsiz_bad = lsiz > lsiz_thresh;
@@ -2328,6 +2448,23 @@ sp3_schedule(struct sp3 *sp)
                 sp->check_scatter_ns = jclock_ns + NSEC_PER_SEC * 3;
             break;
 
+        case wtype_tier:
+            qnum = SP3_QNUM_SHARED;
+
+            /* Tier jobs only improve read latency, so stagger their
+             * start and defer to space amp reduction.
+             */
+            if (!qempty(sp, qnum) && jclock_ns < sp->check_tier_ns)
+                break;
+
+            if (sp->samp_reduce || qfull(sp, qnum))
+                break;
+
+            job = sp3_check_rb_tree(sp, sp->rr_wtype, 0, qnum);
+            if (job)
+                sp->check_tier_ns = jclock_ns + NSEC_PER_SEC * 5;
+            break;
+
         case wtype_split:
             qnum = SP3_QNUM_SPLIT;
             if (qfull(sp, qnum))
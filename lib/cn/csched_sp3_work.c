@@ -745,6 +745,53 @@ sp3_work_wtype_scatter(
     return min_t(uint, runlen, runlen_max);
 }
 
+static uint
+sp3_work_wtype_tier(
+    struct sp3_node *spn,
+    struct sp3_thresholds *thresh,
+    struct kvset_list_entry **mark,
+    enum cn_action *action,
+    enum cn_rule *rule)
+{
+    struct cn_tree_node *tn = spn2tn(spn);
+    struct kvset_list_entry *le;
+    uint runlen = 0, n = 0;
+
+    *mark = NULL;
+    *action = CN_ACTION_COMPACT_KV;
+    *rule = CN_RULE_TIER;
+
+    /* Rewrite the run of kvsets from the oldest through the newest kvset
+     * that resides on the wrong media class.  If the run is too long then
+     * leave tn_retier set so that the remainder is rewritten by another job.
+     */
+    list_for_each_entry_reverse(le, &tn->tn_kvset_list, le_link) {
+        const bool misplaced = cn_tree_kvset_misplaced(tn, le->le_kvset);
+
+        if (!*mark) {
+            if (!misplaced)
+                continue;
+
+            *mark = le;
+        }
+
+        if (misplaced)
+            runlen = n + 1;
+
+        if (++n >= thresh->lcomp_runlen_max)
+            break;
+    }
+
+    /* The run covers all misplaced kvsets, so there's nothing more to do
+     * until the node changes temperature again.  In particular, we do not
+     * want to retry kvsets that landed on a fallback media class.
+     */
+    if (&le->le_link == &tn->tn_kvset_list)
+        tn->tn_retier = false;
+
+    return runlen;
+}
+
 static uint
 sp3_work_wtype_length(
     struct sp3_node *spn,
@@ -1034,6 +1081,10 @@ sp3_work(
             n_kvsets = sp3_work_wtype_length(spn, thresh, &mark, &action, &rule);
             break;
 
+        case wtype_tier:
+            n_kvsets = sp3_work_wtype_tier(spn, thresh, &mark, &action, &rule);
+            break;
+
         case wtype_idle:
             n_kvsets = sp3_work_wtype_idle(spn, thresh, &mark, &action, &rule);
             break;
@@ -52,6 +52,8 @@
 #define SP3_LCOMP_SPLIT_KEYS_MAX        (UINT_MAX)
 #define SP3_LCOMP_SPLIT_KEYS_DEFAULT    (256u << 20)
 
+#define SP3_LCOMP_EXPIRED_PCT_MIN       (10u) /* estimated pct of expired values */
+
 /* clang-format on */
 
 struct sp3_node;
@@ -67,6 +69,7 @@ enum sp3_work_type {
     wtype_split,       /* leaf nodes: split to eliminate large nodes */
     wtype_join,        /* leaf nodes: join to eliminate small nodes */
     wtype_idle,        /* root+leaf nodes: kv-compact idle nodes */
+    wtype_tier,        /* leaf nodes: kv-compact to rewrite kvsets on a new mclass */
     wtype_root,        /* root node: spill to leaves */
     wtype_MAX
 };
@@ -179,7 +179,8 @@ hbb_create(struct hblock_builder **bld_out, const struct cn * const cn, struct p
 
     bld->max_size = props.mc_mblocksz;
 
-    err = wbb_create(&bld->ptree, bld->max_size / PAGE_SIZE, &bld->ptree_pgc);
+    err = wbb_create(
+        &bld->ptree, bld->max_size / PAGE_SIZE, &bld->ptree_pgc, WBT_LEAF_ENC_PLAIN);
     if (err)
         goto out;
 
@@ -16,6 +16,7 @@
 #include <hse/ikvdb/kvset_builder.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/logging/logging.h>
 #include <hse/mpool/mpool.h>
 #include <hse/util/alloc.h>
@@ -29,6 +30,7 @@
 #include <hse/util/perfc.h>
 #include <hse/util/slab.h>
 #include <hse/util/vlb.h>
+#include <hse/util/workqueue.h>
 
 #include "blk_list.h"
 #include "cn_mblocks.h"
@@ -37,6 +39,7 @@
 #include "kblock_builder.h"
 #include "kblock_reader.h"
 #include "kvs_mblk_desc.h"
+#include "mbio.h"
 #include "omf.h"
 #include "wbt_builder.h"
 #include "wbt_reader.h"
@@ -50,6 +53,10 @@
     ((VLB_ALLOCSZ_MAX - 4096 - sizeof(struct hash_set_part)) / \
      sizeof(((struct hash_set_part *)0))->hashvec[0])
 
+/* Kblocks are written in chunks of at most this many bytes (see mblk_blow_chunks()).
+ */
+#define KBLOCK_WR_CHUNK_LEN (1024 * 1024)
+
 /**
  * DOC: Overview
  * This file implements a @kblock_builder.  It also defines @hash_set and
@@ -97,6 +104,8 @@ struct hash_set {
  *             Bloom filter at end of kblock construction.
  * @num_keys:  Number of keys in kblock.
  * @num_tombstones:  Number of keys in kblock that have tombstone values.
+ * @num_expire: Number of values in kblock that have an expiration time.
+ * @expire_min, @expire_max: Range of value expiration times.
  * @total_key_bytes: Sum of all key lengths.
  * @total_val_bytes: Sum of all value lengths.
  * @hlog: kblocks's hlog, last kblock stores the kvsets hlog instead
@@ -137,6 +146,9 @@ struct curr_kblock {
     uint64_t total_vused_bytes;
     uint32_t num_keys;
     uint32_t num_tombstones;
+    uint32_t num_expire;
+    uint64_t expire_min;
+    uint64_t expire_max;
 
     uint32_t max_size;
     uint32_t max_pgc;
@@ -173,8 +185,20 @@ available_pgc(struct curr_kblock *kblk)
  * @composite_hlog: hlog for the entire set of kblocks
  * @finished_kblks: list of finished kblocks (written, not committed)
  * @curr: the kblock currently being built
+ * @kblkv: kblock images, the second is only used for asynchronous writes
  * @finished: mark builder as finished (end of life)
  * @max_size: Maximum mblock size of all configured media classes.
+ * @wr_wq: workqueue for asynchronous writes (NULL for synchronous writes)
+ * @wr_kblk: kblock image being written, NULL if no write is in flight
+ * @wr_iov: iovec of the write in flight
+ * @wr_iovc: number of elements in @wr_iov
+ * @wr_blkid: mblock ID of the write in flight
+ * @wr_work: work struct for asynchronous writes
+ * @wr_mbio: completion state of the write in flight
+ *
+ * With asynchronous writes, a finished kblock image is written by @wr_wq
+ * while keys are added to the other image.  The write must complete before
+ * the next kblock is finished, at which point its image is reset for reuse.
  */
 struct kblock_builder {
     struct mpool *mp;
@@ -185,12 +209,21 @@ struct kblock_builder {
     struct hlog *composite_hlog;
     struct cn_merge_stats *mstats;
     struct blk_list finished_kblks;
-    struct curr_kblock curr;
+    struct curr_kblock *curr;
+    struct curr_kblock kblkv[2];
     enum hse_mclass_policy_age agegroup;
     bool finished;
     uint pt_pgc;
     uint pt_max_pgc;
     uint32_t max_size;
+
+    struct workqueue_struct *wr_wq;
+    struct curr_kblock *wr_kblk;
+    struct iovec *wr_iov;
+    uint wr_iovc;
+    uint64_t wr_blkid;
+    struct work_struct wr_work;
+    struct async_mbio wr_mbio;
 };
 
 /**
@@ -448,6 +481,24 @@ hash_set_free(struct hash_set *hs)
  *
  * kblock_free() -- free resources
  */
+
+/* Map the cn_wbt_leaf_enc rparam to a wbtree leaf encoding, compressed
+ * leaves use the same algorithm as values.
+ */
+static enum wbt_leaf_enc
+kblock_leaf_enc(const struct kvs_rparams *rp)
+{
+    switch (rp->cn_wbt_leaf_enc) {
+    case 1:
+        return WBT_LEAF_ENC_DELTA;
+    case 2:
+        return rp->value.compression.algo == VCOMP_ALGO_ZSTD ? WBT_LEAF_ENC_ZSTD
+                                                             : WBT_LEAF_ENC_LZ4;
+    default:
+        return WBT_LEAF_ENC_PLAIN;
+    }
+}
+
 /**
  * kblock_init - initialize caller-supplied struct curr_kblock
  *
@@ -479,7 +530,8 @@ kblock_init(
     if (ev(err))
         return err;
 
-    err = wbb_create(&kblk->wbtree, kblk->wbt_pgc + available_pgc(kblk), &kblk->wbt_pgc);
+    err = wbb_create(
+        &kblk->wbtree, kblk->wbt_pgc + available_pgc(kblk), &kblk->wbt_pgc, kblock_leaf_enc(rp));
     if (ev(err)) {
         hlog_destroy(kblk->hlog);
         return err;
@@ -499,6 +551,9 @@ kblock_reset(struct curr_kblock *kblk)
     kblk->total_vused_bytes = 0;
     kblk->num_keys = 0;
     kblk->num_tombstones = 0;
+    kblk->num_expire = 0;
+    kblk->expire_min = 0;
+    kblk->expire_max = 0;
 
     kblk->blm_pgc = 0;
     kblk->blm_elt_cap = 0;
@@ -585,6 +640,13 @@ kblock_add_entry(
     kblk->total_vused_bytes += stats->tot_vused;
     kblk->num_tombstones += stats->ntombs;
 
+    if (stats->nexpire) {
+        if (kblk->num_expire == 0 || stats->expire_min < kblk->expire_min)
+            kblk->expire_min = stats->expire_min;
+        kblk->expire_max = max_t(uint64_t, kblk->expire_max, stats->expire_max);
+        kblk->num_expire += stats->nexpire;
+    }
+
     return 0;
 }
 
@@ -679,6 +741,9 @@ kblock_make_header(
     omf_set_kbh_val_bytes(hdr, kblk->total_val_bytes);
     omf_set_kbh_kvlen(hdr, wbb_kvlen(kblk->wbtree));
     omf_set_kbh_vused_bytes(hdr, kblk->total_vused_bytes);
+    omf_set_kbh_expire_cnt(hdr, kblk->num_expire);
+    omf_set_kbh_expire_min(hdr, kblk->expire_min);
+    omf_set_kbh_expire_max(hdr, kblk->expire_max);
 
     /* wbtree header is right after kblock_hdr at an 8-byte boundary */
     off += sizeof(*hdr);
@@ -760,13 +825,50 @@ kbb_estimate_alen(struct cn *cn, size_t wlen, enum hse_mclass mclass)
         KBLOCK_MAX_SIZE, zonealloc_unit, wlen, CN_MB_EST_FLAGS_TRUNCATE | CN_MB_EST_FLAGS_POW2);
 }
 
+static void
+kblock_write_cb(struct work_struct *work)
+{
+    struct kblock_builder *bld = container_of(work, struct kblock_builder, wr_work);
+    merr_t err;
+
+    err = mblk_blow_chunks(bld, bld->wr_blkid, bld->wr_iov, bld->wr_iovc, KBLOCK_WR_CHUNK_LEN);
+
+    mbio_signal(&bld->wr_mbio, err);
+}
+
+/* Wait for the write in flight (if any) to complete and reset its kblock
+ * image for reuse.
+ */
+static merr_t
+kblock_write_wait(struct kblock_builder *bld)
+{
+    struct cn_merge_stats *stats = bld->mstats;
+    merr_t err;
+
+    if (!bld->wr_kblk)
+        return 0;
+
+    err = mbio_wait(&bld->wr_mbio, stats ? &stats->ms_kblk_write_wait : NULL);
+
+    kblock_reset(bld->wr_kblk);
+    free(bld->wr_iov);
+
+    bld->wr_kblk = NULL;
+    bld->wr_iov = NULL;
+
+    return err;
+}
+
 /**
  * kblock_finish() - allocate and write an mblock with kblock data
  *
  * Finalize wbtree and Bloom filter regions, allocate an appropriately sized
  * mblock, and write all kblock data to it.  Does not commit the mblock.
  *
- * This function unconditionally invokes kblock_free().
+ * With asynchronous writes the write is handed off to the builder's
+ * workqueue and the builder switches to its other kblock image, which is
+ * reset once the previous write has completed.  Otherwise, this function
+ * unconditionally resets the current kblock.
  */
 static merr_t
 kblock_finish(struct kblock_builder *bld)
@@ -776,14 +878,14 @@ kblock_finish(struct kblock_builder *bld)
     struct mblock_props mbprop;
     struct mpool_mclass_props mc_props;
 
-    struct curr_kblock *kblk = &bld->curr;
+    struct curr_kblock *kblk = bld->curr;
     struct cn_merge_stats *stats = bld->mstats;
     struct mclass_policy *mpolicy = cn_get_mclass_policy(bld->cn);
 
     struct iovec *iov = NULL;
     uint iov_cnt = 0;
     uint iov_max;
-    uint i, chunk;
+    uint i;
     size_t wlen;
     uint32_t flags = 0;
 
@@ -846,7 +948,7 @@ kblock_finish(struct kblock_builder *bld)
     }
 
     /* Finalize HyperLogLog. */
-    iov[iov_cnt].iov_base = hlog_data(bld->curr.hlog);
+    iov[iov_cnt].iov_base = hlog_data(kblk->hlog);
     iov[iov_cnt].iov_len = HLOG_PGC * PAGE_SIZE;
     iov_cnt++;
 
@@ -897,11 +999,33 @@ kblock_finish(struct kblock_builder *bld)
     if (stats)
         count_ops(&stats->ms_kblk_alloc, 1, mbprop.mpr_alloc_cap, get_time_ns() - tstart);
 
+    if (bld->wr_wq) {
+        err = kblock_write_wait(bld);
+        if (ev(err))
+            goto errout;
+
+        err = blk_list_append(&bld->finished_kblks, blkid);
+        if (ev(err))
+            goto errout;
+
+        hlog_union(bld->composite_hlog, hlog_data(kblk->hlog));
+
+        bld->wr_kblk = kblk;
+        bld->wr_iov = iov;
+        bld->wr_iovc = iov_cnt;
+        bld->wr_blkid = blkid;
+        bld->curr = (kblk == bld->kblkv) ? bld->kblkv + 1 : bld->kblkv;
+
+        mbio_arm(&bld->wr_mbio);
+        queue_work(bld->wr_wq, &bld->wr_work);
+
+        return 0;
+    }
+
     /* Write mblock in chunks.  Chunk size must be a multiple of
      * mblock optimal write size. Use largest chunk size less than 1 MiB.
      */
-    chunk = 1024 * 1024;
-    err = mblk_blow_chunks(bld, blkid, iov, iov_cnt, chunk);
+    err = mblk_blow_chunks(bld, blkid, iov, iov_cnt, KBLOCK_WR_CHUNK_LEN);
     if (ev(err))
         goto errout;
 
@@ -969,13 +1093,30 @@ kbb_create(struct kblock_builder **builder_out, struct cn *cn, struct perfc_set
     if (ev(err))
         goto err_exit1;
 
-    err = kblock_init(&bld->curr, bld->cp, bld->rp, bld->pc, bld->max_size);
+    bld->curr = bld->kblkv;
+
+    err = kblock_init(bld->curr, bld->cp, bld->rp, bld->pc, bld->max_size);
     if (ev(err))
         goto err_exit2;
 
+    if (bld->rp->cn_async_write)
+        bld->wr_wq = cn_get_wr_wq(cn);
+
+    if (bld->wr_wq) {
+        err = kblock_init(bld->kblkv + 1, bld->cp, bld->rp, bld->pc, bld->max_size);
+        if (ev(err))
+            goto err_exit3;
+
+        INIT_WORK(&bld->wr_work, kblock_write_cb);
+        mbio_init(&bld->wr_mbio, "kbbwrite");
+    }
+
     *builder_out = bld;
     return 0;
 
+err_exit3:
+    kblock_free(bld->curr);
+
 err_exit2:
     hlog_destroy(bld->composite_hlog);
 
@@ -991,8 +1132,14 @@ kbb_destroy(struct kblock_builder *bld)
     if (ev(!bld))
         return;
 
+    if (bld->wr_wq) {
+        kblock_write_wait(bld);
+        mbio_fini(&bld->wr_mbio);
+        kblock_free(bld->kblkv + 1);
+    }
+
     hlog_destroy(bld->composite_hlog);
-    kblock_free(&bld->curr);
+    kblock_free(bld->kblkv);
     delete_mblocks(bld->mp, &bld->finished_kblks);
     blk_list_free(&bld->finished_kblks);
     free(bld);
@@ -1019,11 +1166,11 @@ kbb_add_entry(
 
     hash = hse_hash64v(kobj->ko_pfx, kobj->ko_pfx_len, kobj->ko_sfx, kobj->ko_sfx_len);
 
-    err = kblock_add_entry(&bld->curr, kobj, kmd, kmd_len, stats, &added);
+    err = kblock_add_entry(bld->curr, kobj, kmd, kmd_len, stats, &added);
     if (ev(err))
         return err;
     if (added) {
-        hlog_add(bld->curr.hlog, hash);
+        hlog_add(bld->curr->hlog, hash);
         return 0;
     }
 
@@ -1034,8 +1181,8 @@ kbb_add_entry(
      *   - add key to new kblock
      *   - bug if fails with no space
      */
-    assert(!kblock_is_empty(&bld->curr));
-    if (ev(kblock_is_empty(&bld->curr)))
+    assert(!kblock_is_empty(bld->curr));
+    if (ev(kblock_is_empty(bld->curr)))
         return merr(EBUG);
 
     /* There are more keys to add, do not pass in ptree details */
@@ -1043,10 +1190,10 @@ kbb_add_entry(
     if (ev(err))
         return err;
 
-    err = kblock_add_entry(&bld->curr, kobj, kmd, kmd_len, stats, &added);
+    err = kblock_add_entry(bld->curr, kobj, kmd, kmd_len, stats, &added);
     if (ev(err))
         return err;
-    hlog_add(bld->curr.hlog, hash);
+    hlog_add(bld->curr->hlog, hash);
     assert(added);
     if (ev(!added))
         return merr(EBUG);
@@ -1071,7 +1218,7 @@ kbb_finish(struct kblock_builder *bld, struct blk_list *kblks)
     bld->finished = true;
 
     /* In the event we have no keys, return no kblocks to the caller. */
-    if (bld->curr.num_keys == 0) {
+    if (bld->curr->num_keys == 0) {
         assert(bld->finished_kblks.idc == 0);
 
         return 0;
@@ -1081,6 +1228,10 @@ kbb_finish(struct kblock_builder *bld, struct blk_list *kblks)
     if (ev(err))
         return err;
 
+    err = kblock_write_wait(bld);
+    if (ev(err))
+        return err;
+
     /* Transfer ownership of blk_list and the mblocks in
      * the blk_list to caller
      */
@@ -1126,7 +1277,7 @@ kbb_set_merge_stats(struct kblock_builder *bld, struct cn_merge_stats *stats)
 bool
 kbb_is_empty(struct kblock_builder *bld)
 {
-    return kblock_is_empty(&bld->curr);
+    return kblock_is_empty(bld->curr);
 }
 
 void
@@ -1135,7 +1286,7 @@ kbb_curr_kblk_min_max_keys(
     struct key_obj *min_kobj,
     struct key_obj *max_kobj)
 {
-    wbb_min_max_keys(bld->curr.wbtree, min_kobj, max_kobj);
+    wbb_min_max_keys(bld->curr->wbtree, min_kobj, max_kobj);
 }
 
 #if HSE_MOCKING
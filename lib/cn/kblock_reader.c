@@ -122,6 +122,16 @@ kbr_read_metrics(struct kvs_mblk_desc *kblkdesc, struct kblk_metrics *metrics)
     metrics->tot_wbt_pages = omf_kbh_wbt_dlen_pg(hdr);
     metrics->tot_blm_pages = omf_kbh_blm_dlen_pg(hdr);
 
+    if (omf_kbh_version(hdr) >= KBLOCK_HDR_VERSION7) {
+        metrics->num_expire = omf_kbh_expire_cnt(hdr);
+        metrics->expire_min = omf_kbh_expire_min(hdr);
+        metrics->expire_max = omf_kbh_expire_max(hdr);
+    } else {
+        metrics->num_expire = 0;
+        metrics->expire_min = 0;
+        metrics->expire_max = 0;
+    }
+
     return 0;
 }
 
@@ -24,6 +24,9 @@ struct kblk_metrics {
     uint64_t tot_vused_bytes;
     uint32_t tot_wbt_pages;
     uint32_t tot_blm_pages;
+    uint32_t num_expire;
+    uint64_t expire_min;
+    uint64_t expire_max;
 };
 
 struct kblock_desc {
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <hse/ikvdb/cn.h>
 #include <hse/ikvdb/kvs_rparams.h>
 #include <hse/ikvdb/kvset_builder.h>
 #include <hse/ikvdb/limits.h>
@@ -63,6 +64,7 @@ kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
 
     bool pt_set = false;
     uint64_t pt_seq = 0;
+    uint64_t rt_seq = 0;
     uint64_t tprog = 0;
 
     uint64_t dbg_prev_seq HSE_MAYBE_UNUSED;
@@ -132,6 +134,8 @@ kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
         emitted_seq = 0;
         emitted_seq_pt = 0;
 
+        rt_seq = cn_rtomb_floor(w->cw_rtombs, &curr->kobj, w->cw_horizon);
+
         dbg_prev_seq = 0;
         dbg_prev_idx = 0;
         dbg_nvals_this_key = 0;
@@ -165,6 +169,9 @@ kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
                 if (pt_set && seq < pt_seq)
                     continue; /* skip value */
 
+                if (seq < rt_seq && vtype != VTYPE_PTOMB)
+                    continue; /* skip value deleted by a range tombstone */
+
                 if (vtype == VTYPE_PTOMB) {
                     pt_set = true;
                     pt_kobj = curr->kobj;
@@ -191,12 +198,15 @@ kcompact(struct cn_compaction_work *w, struct kvset_builder *bldr)
                 switch (vtype) {
                 case VTYPE_UCVAL:
                 case VTYPE_CVAL:
+                case VTYPE_ZCVAL:
                     err = kvset_builder_add_vref(
-                        bldr, seq, vbidx + w->cw_vbmap.vbm_map[idx], vboff, vlen, complen);
+                        bldr, seq, curr->vctx.expire, vbidx + w->cw_vbmap.vbm_map[idx], vboff,
+                        vlen, complen, vtype_to_calgo(vtype));
                     break;
                 case VTYPE_ZVAL:
                 case VTYPE_IVAL:
-                    err = kvset_builder_add_val(bldr, &curr->kobj, vdata, vlen, seq, 0);
+                    err = kvset_builder_add_val(
+                        bldr, &curr->kobj, vdata, vlen, seq, curr->vctx.expire, 0, 0);
                     break;
                 default:
                     err = kvset_builder_add_nonval(bldr, seq, vtype);
@@ -307,7 +317,7 @@ cn_kcompact(struct cn_compaction_work *w)
     if (ev(err))
         return err;
 
-    err = kvset_builder_set_agegroup(bldr, HSE_MPOLICY_AGE_LEAF);
+    err = kvset_builder_set_agegroup(bldr, cn_tree_node_agegroup(w->cw_node));
     if (err)
         goto done;
 
@@ -37,6 +37,7 @@ struct kvset_iter_vctx {
     uint nvals;
     uint next;
     bool is_ptomb;
+    uint64_t expire; /* expiration time of the most recent vref, or 0 */
 };
 
 struct cn_kv_item {
@@ -101,6 +101,7 @@ cn_kvcompact(struct cn_compaction_work *w)
     struct key_obj pt_kobj = { 0 };
     uint64_t pt_seq = 0;
     bool pt_set = false;
+    uint64_t rt_seq = 0;
 
     uint64_t tstart, tprog = 0;
     uint64_t dbg_prev_seq = 0;
@@ -143,7 +144,7 @@ cn_kvcompact(struct cn_compaction_work *w)
 
     kvset_builder_set_merge_stats(bldr, &w->cw_stats);
 
-    err = kvset_builder_set_agegroup(bldr, HSE_MPOLICY_AGE_LEAF);
+    err = kvset_builder_set_agegroup(bldr, cn_tree_node_agegroup(w->cw_node));
     if (err)
         goto out;
 
@@ -179,6 +180,8 @@ cn_kvcompact(struct cn_compaction_work *w)
             emitted_seq = 0;
             emitted_seq_pt = 0;
 
+            rt_seq = cn_rtomb_floor(w->cw_rtombs, &curr->kobj, w->cw_horizon);
+
             dbg_prev_seq = 0;
             dbg_prev_idx = 0;
             dbg_nvals_this_key = 0;
@@ -200,7 +203,8 @@ cn_kvcompact(struct cn_compaction_work *w)
                     iter, &curr->vctx, &seq, &vtype, &vbidx, &vboff, &vdata, &vlen, &complen))
                 break;
 
-            omlen = (vtype == VTYPE_UCVAL) ? vlen : ((vtype == VTYPE_CVAL) ? complen : 0);
+            omlen = (vtype == VTYPE_UCVAL) ? vlen
+                : ((vtype == VTYPE_CVAL || vtype == VTYPE_ZCVAL) ? complen : 0);
 
             direct = omlen > direct_read_len;
             if (direct) {
@@ -238,6 +242,9 @@ cn_kvcompact(struct cn_compaction_work *w)
             if (bg_val && pt_set && w->cw_horizon >= pt_seq && pt_seq > seq)
                 break; /* drop val if it and pt are beyond horizon */
 
+            if (bg_val && rt_seq > seq && !HSE_CORE_IS_PTOMB(vdata))
+                break; /* drop val deleted by a range tombstone beyond horizon */
+
             /* Set ptomb context irrespective of bg_val for tombstone propagation */
             if (HSE_CORE_IS_PTOMB(vdata)) {
                 pt_set = true;
@@ -259,7 +266,9 @@ cn_kvcompact(struct cn_compaction_work *w)
                 if (w->cw_drop_tombs && HSE_CORE_IS_TOMB(vdata) && bg_val)
                     continue; /* skip value */
 
-                err = kvset_builder_add_val(bldr, &curr->kobj, vdata, vlen, seq, complen);
+                err = kvset_builder_add_val(
+                    bldr, &curr->kobj, vdata, vlen, seq, curr->vctx.expire, complen,
+                    vtype_to_calgo(vtype));
                 if (err)
                     break;
 
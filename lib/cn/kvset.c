@@ -16,11 +16,11 @@
 #include <hse/ikvdb/ikvdb.h>
 #include <hse/ikvdb/kvs_rparams.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/logging/logging.h>
 #include <hse/util/alloc.h>
 #include <hse/util/assert.h>
 #include <hse/util/bloom_filter.h>
-#include <hse/util/compression_lz4.h>
 #include <hse/util/condvar.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/keycmp.h>
@@ -43,6 +43,7 @@
 #include <hse/util/hlog.h>
 
 #include "blk_list.h"
+#include "vbcache.h"
 #include "bloom_reader.h"
 #include "cn_metrics.h"
 #include "cn_tree.h"
@@ -54,6 +55,7 @@
 #include "kvset.h"
 #include "kvset_internal.h"
 #include "kvset_split.h"
+#include "mbio.h"
 #include "mbset.h"
 #include "omf.h"
 #include "vblock_reader.h"
@@ -360,6 +362,14 @@ kvset_kblk_init(struct kvs_rparams *rp, struct mpool *ds, uint64_t mbid, struct
     if (rp->cn_bloom_preload)
         kbr_madvise_bloom(kbd, &p->kb_blm_desc, MADV_WILLNEED);
 
+    /* The fence index is merely an accelerator, lookups fall back to
+     * descending the wbtree if it cannot be built.
+     */
+    if (rp->cn_wbt_fence) {
+        err = wbtr_fence_create(kbd->map_base, &p->kb_wbt_desc);
+        ev(err);
+    }
+
     return 0;
 }
 
@@ -460,6 +470,7 @@ kvset_open2(
     ks->ks_dgen_lo = km->km_dgen_lo;
     ks->ks_compc = km->km_compc;
     ks->ks_rule = km->km_rule;
+    ks->ks_rtomb_seqno = km->km_rtomb_seqno;
     ks->ks_kvsetid = kvsetid;
     ks->ks_cnid = cn_tree_get_cnid(tree);
     ks->ks_cndb = cn_tree_get_cndb(tree);
@@ -516,6 +527,15 @@ kvset_open2(
         ks->ks_st.kst_kwlen += kblk->kb_kblk_desc.wlen_pages * PAGE_SIZE;
         ks->ks_st.kst_keys += kblk->kb_metrics.num_keys;
         ks->ks_st.kst_tombs += kblk->kb_metrics.num_tombstones;
+
+        if (kblk->kb_metrics.num_expire) {
+            const struct kblk_metrics *km = &kblk->kb_metrics;
+
+            if (!ks->ks_st.kst_expire || km->expire_min < ks->ks_st.kst_expmin)
+                ks->ks_st.kst_expmin = km->expire_min;
+            ks->ks_st.kst_expmax = max(ks->ks_st.kst_expmax, km->expire_max);
+            ks->ks_st.kst_expire += km->num_expire;
+        }
     }
 
     /* Cache the large min/max keys from all the kblocks into a packed
@@ -838,6 +858,8 @@ cleanup_kblocks(struct kvset *ks)
     merr_t err = 0;
 
     for (uint32_t i = 0; i < ks->ks_st.kst_kblks; i++) {
+        wbtr_fence_destroy(&ks->ks_kblks[i].kb_wbt_desc);
+
         err = mblk_munmap(ks->ks_mp, &ks->ks_kblks[i].kb_kblk_desc);
         ev(err);
     }
@@ -1223,6 +1245,36 @@ kvset_get_immediate_value(struct kvs_vtuple_ref *vref, struct kvs_buf *vbuf)
 extern thread_local char tls_vbuf[];
 extern const size_t tls_vbufsz;
 
+/* Reads larger than this bypass the vblock cache so that a few large values
+ * cannot flush out the many small pages that make up the working set.
+ */
+#define KVSET_VBCACHE_SPAN_MAX (16 * PAGE_SIZE)
+
+/* Read a page aligned range of an mblock, serving it from the cn vblock
+ * cache if all of its pages are resident and populating the cache on a miss.
+ * Only value reads come through here; the sequential kblock reads of
+ * kvset_iter_kblock_read() would merely flush the cache.
+ */
+static merr_t
+kvset_mblock_read(struct kvset *ks, uint64_t mbid, const struct iovec *iov, size_t off)
+{
+    struct vbcache *bc;
+    merr_t err;
+
+    bc = ks->ks_cn_kvdb ? ks->ks_cn_kvdb->cn_vbcache : NULL;
+    if (iov->iov_len > KVSET_VBCACHE_SPAN_MAX)
+        bc = NULL;
+
+    if (bc && vbcache_get(bc, mbid, off, iov->iov_base, iov->iov_len))
+        return 0;
+
+    err = mpool_mblock_read(ks->ks_mp, mbid, iov, 1, off);
+    if (!err && bc)
+        vbcache_put(bc, mbid, off, iov->iov_base, iov->iov_len);
+
+    return err;
+}
+
 static merr_t
 kvset_lookup_val_direct(
     struct kvset *ks,
@@ -1271,7 +1323,7 @@ kvset_lookup_val_direct(
         }
     }
 
-    err = mpool_mblock_read(ks->ks_mp, mbid, &iov, 1, off);
+    err = kvset_mblock_read(ks, mbid, &iov, off);
     if (err) {
         log_errx("off %lx, len %lx, copylen %u, vbufsz %u", err, off, iov.iov_len, copylen, vbufsz);
     } else {
@@ -1285,7 +1337,7 @@ kvset_lookup_val_direct(
     if (freeme)
         vlb_free(iov.iov_base, iov.iov_len);
 
-    return 0;
+    return err;
 }
 
 static merr_t
@@ -1294,6 +1346,7 @@ kvset_lookup_val_direct_decompress(
     const struct vblock_desc *vbd,
     uint16_t vbidx,
     uint32_t vboff,
+    enum vcomp_algorithm calgo,
     void *vbuf,
     uint copylen,
     uint omlen,
@@ -1322,13 +1375,13 @@ kvset_lookup_val_direct_decompress(
         freeme = true;
     }
 
-    err = mpool_mblock_read(ks->ks_mp, mbid, &iov, 1, off);
+    err = kvset_mblock_read(ks, mbid, &iov, off);
     if (err) {
         log_errx("off %lx, len %lx, copylen %u, omlen %u", err, off, iov.iov_len, copylen, omlen);
     } else {
         src = iov.iov_base + (vboff & ~PAGE_MASK);
 
-        err = compress_lz4_ops.cop_decompress(src, omlen, vbuf, copylen, outlenp);
+        err = vcomp_decompress(calgo, src, omlen, vbuf, copylen, outlenp);
     }
 
     if (freeme)
@@ -1338,17 +1391,18 @@ kvset_lookup_val_direct_decompress(
 }
 
 static merr_t
-kvset_lookup_val(struct kvset *ks, struct kvs_vtuple_ref *vref, struct kvs_buf *vbuf)
+kvset_lookup_val(struct kvset *ks, struct kvs_vtuple_ref *vref, bool direct, struct kvs_buf *vbuf)
 {
     const struct vblock_desc *vbd;
     merr_t err;
     void *src, *dst;
     uint omlen, copylen;
-    bool direct;
+    enum vcomp_algorithm calgo;
 
     assert(
         vref->vr_type == VTYPE_IVAL || vref->vr_type == VTYPE_ZVAL ||
-        vref->vr_type == VTYPE_UCVAL || vref->vr_type == VTYPE_CVAL);
+        vref->vr_type == VTYPE_UCVAL || vref->vr_type == VTYPE_CVAL ||
+        vref->vr_type == VTYPE_ZCVAL);
 
     if (HSE_UNLIKELY(vref->vr_type == VTYPE_ZVAL)) {
         vbuf->b_len = 0;
@@ -1369,7 +1423,8 @@ kvset_lookup_val(struct kvset *ks, struct kvs_vtuple_ref *vref, struct kvs_buf *
     dst = vbuf->b_buf;
     copylen = min(vref->vb.vr_len, vbuf->b_buf_sz);
 
-    direct = (copylen >= ks->ks_vmax) && (vbd->vbd_mblkdesc->mclass != HSE_MCLASS_PMEM);
+    direct = (direct || copylen >= ks->ks_vmax) &&
+        (vbd->vbd_mblkdesc->mclass != HSE_MCLASS_PMEM);
 
     if (!copylen)
         goto done;
@@ -1378,13 +1433,15 @@ kvset_lookup_val(struct kvset *ks, struct kvs_vtuple_ref *vref, struct kvs_buf *
         uint outlen;
 
         err = 0;
+        calgo = vtype_to_calgo(vref->vr_type);
 
         if (direct)
             err = kvset_lookup_val_direct_decompress(
-                ks, vbd, vref->vb.vr_index, vref->vb.vr_off, dst, copylen, omlen, &outlen);
+                ks, vbd, vref->vb.vr_index, vref->vb.vr_off, calgo, dst, copylen, omlen,
+                &outlen);
 
         if (!direct || err) {
-            err = compress_lz4_ops.cop_decompress(src, omlen, dst, copylen, &outlen);
+            err = vcomp_decompress(calgo, src, omlen, dst, copylen, &outlen);
             if (ev(err))
                 return err;
         }
@@ -1467,7 +1524,9 @@ kvset_pfx_lookup(
 next_kblk:
     kblk = &ks->ks_kblks[kbidx];
 
-    wbti_reset(wbti, kblk->kb_kblk_desc.map_base, &kblk->kb_wbt_desc, kt, 0, 0);
+    err = wbti_reset(wbti, kblk->kb_kblk_desc.map_base, &kblk->kb_wbt_desc, kt, 0, 0);
+    if (ev(err))
+        return err;
 
 get_more:
     /* Get next key and set kmd to the base addr for the next keys' metadata */
@@ -1504,7 +1563,7 @@ get_more:
                 /* can't be  a ptomb, b/c they're in their own WBT */
                 assert(vref.vr_type != VTYPE_PTOMB);
                 vref.vr_seq = vseq;
-                if (vref.vr_type == VTYPE_TOMB)
+                if (vref.vr_type == VTYPE_TOMB || kvs_expired(vref.vr_expire))
                     *res = FOUND_TMB;
                 else
                     *res = FOUND_VAL;
@@ -1545,7 +1604,7 @@ get_more:
      * is the first seen kv-pair.
      */
     if (++qctx->seen == 1) {
-        err = kvset_lookup_val(ks, &vref, vbuf);
+        err = kvset_lookup_val(ks, &vref, false, vbuf);
         if (ev(err))
             return err;
 
@@ -1572,20 +1631,21 @@ kvset_lookup(
     struct kvs_ktuple *kt,
     const struct key_disc *kdisc,
     uint64_t seq,
+    bool direct,
     enum key_lookup_res *res,
+    struct kvs_vtuple_ref *vref,
     struct kvs_buf *vbuf)
 {
-    struct kvs_vtuple_ref vref;
     merr_t err;
 
-    err = kvset_lookup_vref(ks, kt, kdisc, seq, res, &vref);
+    err = kvset_lookup_vref(ks, kt, kdisc, seq, res, vref);
     if (ev(err))
         return err;
 
     if (*res != FOUND_VAL)
         return 0;
 
-    return kvset_lookup_val(ks, &vref, vbuf);
+    return kvset_lookup_val(ks, vref, direct, vbuf);
 }
 
 uint64_t
@@ -1644,6 +1704,18 @@ kvset_get_vgroups(const struct kvset *ks)
     return ks->ks_vgmap ? ks->ks_vgmap->nvgroups : 0;
 }
 
+enum hse_mclass
+kvset_get_mclass(const struct kvset *ks, enum hse_mclass_policy_dtype dtype)
+{
+    if (dtype == HSE_MPOLICY_DTYPE_KEY)
+        return ks->ks_hblk.kh_hblk_desc.mclass;
+
+    if (ks->ks_st.kst_vblks == 0)
+        return HSE_MCLASS_INVALID;
+
+    return lvx2vbd(ks, 0)->vbd_mblkdesc->mclass;
+}
+
 size_t
 kvset_get_kwlen(const struct kvset *ks)
 {
@@ -1717,6 +1789,13 @@ kvset_stats_add(const struct kvset_stats *add, struct kvset_stats *result)
     result->kst_vwlen += add->kst_vwlen;
     result->kst_vulen += add->kst_vulen;
     result->kst_vgarb += add->kst_vgarb;
+
+    if (add->kst_expire) {
+        if (!result->kst_expire || add->kst_expmin < result->kst_expmin)
+            result->kst_expmin = add->kst_expmin;
+        result->kst_expmax = max(result->kst_expmax, add->kst_expmax);
+        result->kst_expire += add->kst_expire;
+    }
 }
 
 const void *
@@ -1863,15 +1942,6 @@ kvset_list_add_tail(struct kvset *ks, struct list_head *head)
 
 struct kv_iterator_ops kvset_iter_ops;
 
-/* async_mbio: for asynchronous mblock i/o */
-struct async_mbio {
-    struct mutex mutex;
-    int pending;
-    int status;
-    const char *cv_wmesg;
-    struct cv cv;
-};
-
 struct kr_buf {
     void *node_buf;
     void *kmd_buf;
@@ -1963,6 +2033,9 @@ struct iter_meta {
 
 struct wb_pos {
     void *wb_node;              /* current node */
+    void *wb_leaf;              /* current node, expanded if need be */
+    void *wb_xbuf;              /* expansion buffer (two halves) */
+    uint8_t wb_xidx;            /* current half of wb_xbuf */
     void *wb_pfx;               /* node's lcp */
     uint16_t wb_pfx_len;        /* length of node's lcp */
     struct wbt_lfe_omf *wb_lfe; /* current key */
@@ -2011,54 +2084,6 @@ struct kvset_iterator {
 
 #define handle_to_kvset_iter(_handle) container_of(_handle, struct kvset_iterator, handle)
 
-static void
-mbio_init(struct async_mbio *io, const char *wmesg)
-{
-    mutex_init(&io->mutex);
-    cv_init(&io->cv);
-    io->status = 0;
-    io->pending = 0;
-    io->cv_wmesg = wmesg;
-}
-
-static void
-mbio_arm(struct async_mbio *io)
-{
-    mutex_lock(&io->mutex);
-    assert(!io->pending);
-    io->pending = 1;
-    mutex_unlock(&io->mutex);
-}
-
-static void
-mbio_signal(struct async_mbio *io, merr_t err)
-{
-    mutex_lock(&io->mutex);
-    assert(io->pending);
-    io->status = err;
-    io->pending = 0;
-    cv_signal(&io->cv);
-    mutex_unlock(&io->mutex);
-}
-
-static merr_t
-mbio_wait(struct async_mbio *io, struct cn_merge_stats_ops *stats)
-{
-    merr_t err;
-    uint64_t tstart = 0;
-
-    mutex_lock(&io->mutex);
-    if (stats && io->pending)
-        tstart = get_time_ns();
-    while (io->pending)
-        cv_wait(&io->cv, &io->mutex, io->cv_wmesg);
-    if (tstart)
-        count_ops(stats, 1, 0, get_time_ns() - tstart);
-    err = io->status;
-    mutex_unlock(&io->mutex);
-    return err;
-}
-
 static void
 kvset_iter_kblock_read(struct work_struct *rock)
 {
@@ -2109,7 +2134,7 @@ kvset_iter_kblock_read(struct work_struct *rock)
 
     /* figure out kmd range that corresponds to leaf nodes */
     hdr = iov.iov_base;
-    assert(omf_wbn_magic(hdr) == WBT_LFE_NODE_MAGIC);
+    assert(wbt_node_is_leaf(hdr));
     start_node_kmd_off = omf_wbn_kmd(hdr);
 
     if (last_node) {
@@ -2117,7 +2142,7 @@ kvset_iter_kblock_read(struct work_struct *rock)
     } else {
         /* get end of kmd range last node */
         hdr = iov.iov_base + iov.iov_len - PAGE_SIZE;
-        assert(omf_wbn_magic(hdr) == WBT_LFE_NODE_MAGIC);
+        assert(wbt_node_is_leaf(hdr));
         end_node_kmd_off = omf_wbn_kmd(hdr);
         /* Cannot read keys from last node b/c we don't have kmd
          * for them.  This is why we insist node buffer is at
@@ -2576,8 +2601,20 @@ kvset_iter_create(
     if (reverse) {
         iter->vra_flags |= VBR_REVERSE;
         iter->reverse = reverse;
+
+        /* The kernel's mmap readahead never reads backwards, so reverse
+         * cursors have their own vblock readahead window (zero disables it).
+         * Capped trees keep cn_capped_vra, and vblocks that were advised in
+         * full when the kvset was created need none.
+         */
+        if (!fullscan && ks->ks_st.kst_vblks > 0 && !cn_tree_is_capped(ks->ks_tree) &&
+            !ra_willneed(ks->ks_rp->cn_mcache_vra_params))
+            iter->vra_len = roundup(ks->ks_rp->cn_cursor_rev_vra, PAGE_SIZE);
     }
 
+    if (flags & kvset_iter_flag_novals)
+        iter->vra_len = 0;
+
     iter->vra_len = min_t(uint32_t, iter->vra_len, HSE_KVS_VALUE_LEN_MAX);
     iter->vra_wq = vra_wq;
 
@@ -2820,9 +2857,14 @@ kvset_iter_seek(struct kv_iterator *handle, const void *key, int32_t len, bool *
             wbti_destroy(wbti);
             return err;
         }
-        wbti_reset(
+        err = wbti_reset(
             pti, ks->ks_hblk.kh_hblk_desc.map_base, &ks->ks_hblk.kh_ptree_desc, &kt_pfx,
             iter->reverse, 0);
+        if (ev(err)) {
+            wbti_destroy(wbti);
+            wbti_destroy(pti);
+            return err;
+        }
         iter->pti = pti;
         pti = NULL;
 
@@ -2874,7 +2916,15 @@ kvset_iter_seek(struct kv_iterator *handle, const void *key, int32_t len, bool *
             }
             return err;
         }
-        wbti_reset(wbti, kblk->kb_kblk_desc.map_base, &kblk->kb_wbt_desc, &kt, iter->reverse, 0);
+        err = wbti_reset(
+            wbti, kblk->kb_kblk_desc.map_base, &kblk->kb_wbt_desc, &kt, iter->reverse, 0);
+        if (ev(err)) {
+            wbti_destroy(wbti);
+            wbti_destroy(pti);
+            wbti_destroy(iter->pti);
+            iter->pti = NULL;
+            return err;
+        }
         iter->wbti = wbti;
         wbti = NULL;
     }
@@ -2943,7 +2993,7 @@ kvset_iter_next_wbt_key_mmap(struct kvset_iterator *iter, const void **kdata, ui
 {
     struct kvset *ks = iter->ks;
     merr_t err;
-    bool preload_wbt_nodes;
+    bool readahead;
     int inc = iter->reverse ? -1 : 1;
 
     if (iter->wbti_meta.eof)
@@ -2965,13 +3015,13 @@ next_kblock:
         assert(iter->curr_kblk < ks->ks_st.kst_kblks);
         kb = ks->ks_kblks + iter->curr_kblk;
 
-        /* Can use 'cn_cursor_kblk_madv' to control use of madvise
-         * with since this code is only used with cursors.
+        /* This code is only used with cursors, so 'cn_cursor_rev_kra'
+         * controls the leaf node readahead of reverse iterators.
          */
-        preload_wbt_nodes = ks->ks_rp->cn_cursor_kra;
+        readahead = ks->ks_rp->cn_cursor_rev_kra;
         err = wbti_create(
             &iter->wbti, kb->kb_kblk_desc.map_base, &kb->kb_wbt_desc, 0, iter->reverse,
-            preload_wbt_nodes);
+            readahead);
         if (ev(err))
             return err;
         assert(iter->wbti);
@@ -3052,9 +3102,29 @@ kvset_iter_next_key_read(
     }
 
     /* just landed on a new node */
-    wbt_reader->wb_keyc = omf_wbn_num_keys(wbt_reader->wb_node);
-    wbt_reader->wb_pfx_len = omf_wbn_pfx_len(wbt_reader->wb_node);
-    wbt_reader->wb_pfx = wbt_reader->wb_node + sizeof(struct wbt_node_hdr_omf);
+    wbt_reader->wb_leaf = wbt_reader->wb_node;
+
+    if (omf_wbn_magic(wbt_reader->wb_node) == WBT_LFC_NODE_MAGIC) {
+        /* Expand into the half of the buffer not holding the previous
+         * node, as the caller may still reference the previous key.
+         */
+        if (!wbt_reader->wb_xbuf) {
+            wbt_reader->wb_xbuf = malloc(2 * WBT_LFX_NODE_SIZE);
+            if (ev(!wbt_reader->wb_xbuf))
+                return merr(ENOMEM);
+        }
+
+        wbt_reader->wb_xidx ^= 1;
+        wbt_reader->wb_leaf = wbt_reader->wb_xbuf + wbt_reader->wb_xidx * WBT_LFX_NODE_SIZE;
+
+        err = wbt_leaf_expand(wbt_reader->wb_node, wbt_reader->wb_leaf);
+        if (ev(err))
+            return err;
+    }
+
+    wbt_reader->wb_keyc = omf_wbn_num_keys(wbt_reader->wb_leaf);
+    wbt_reader->wb_pfx_len = omf_wbn_pfx_len(wbt_reader->wb_leaf);
+    wbt_reader->wb_pfx = wbt_reader->wb_leaf + sizeof(struct wbt_node_hdr_omf);
     wbt_reader->wb_lfe = wbt_reader->wb_pfx + wbt_reader->wb_pfx_len;
 
     /* prepare for next node (after each key in node is processed) */
@@ -3062,11 +3132,11 @@ kvset_iter_next_key_read(
 
 next_key:
     /* set kdata and klen outputs */
-    wbt_lfe_key(wbt_reader->wb_node, wbt_reader->wb_lfe, kdata, klen);
+    wbt_lfe_key(wbt_reader->wb_leaf, wbt_reader->wb_lfe, kdata, klen);
 
     /* set kmd output, which is used by caller to iterate through values */
     meta->kmd =
-        (wbt_reader->wb_kmd_base + wbt_lfe_kmd(wbt_reader->wb_node, wbt_reader->wb_lfe) -
+        (wbt_reader->wb_kmd_base + wbt_lfe_kmd(wbt_reader->wb_leaf, wbt_reader->wb_lfe) -
          wbt_reader->wb_node_kmd_off_adj);
     /* prepare for next key */
     wbt_reader->wb_lfe++;
@@ -3093,7 +3163,7 @@ kvset_iter_next_pt_key_mmap(struct kvset_iterator *iter, const void **kdata, uin
 {
     struct kvset *ks = iter->ks;
     merr_t err;
-    bool preload_wbt_nodes, more;
+    bool readahead, more;
 
     if (!iter->pti_meta.eof && !iter->pti) {
         if (!kvset_has_ptree(ks)) {
@@ -3101,10 +3171,10 @@ kvset_iter_next_pt_key_mmap(struct kvset_iterator *iter, const void **kdata, uin
             return 0;
         }
 
-        preload_wbt_nodes = ks->ks_rp->cn_cursor_kra;
+        readahead = ks->ks_rp->cn_cursor_rev_kra;
         err = wbti_create(
             &iter->pti, ks->ks_hblk.kh_hblk_desc.map_base, &ks->ks_hblk.kh_ptree_desc, 0,
-            iter->reverse, preload_wbt_nodes);
+            iter->reverse, readahead);
         if (ev(err))
             return err;
         assert(iter->pti);
@@ -3227,12 +3297,13 @@ kvset_iter_next_vref(
     if (vc->next >= vc->nvals)
         return false;
 
-    kmd_type_seq(vc->kmd, &vc->off, vtype, seq);
+    kmd_type_seq_expire(vc->kmd, &vc->off, vtype, seq, &vc->expire);
     switch (*vtype) {
     case VTYPE_UCVAL:
         kmd_val(vc->kmd, &vc->off, vbidx, vboff, vlen);
         break;
     case VTYPE_CVAL:
+    case VTYPE_ZCVAL:
         kmd_cval(vc->kmd, &vc->off, vbidx, vboff, vlen, complen);
         break;
     case VTYPE_IVAL:
@@ -3247,7 +3318,8 @@ kvset_iter_next_vref(
         break;
     }
 
-    if ((*vtype == VTYPE_UCVAL || *vtype == VTYPE_CVAL) && ks->ks_use_vgmap) {
+    if ((*vtype == VTYPE_UCVAL || *vtype == VTYPE_CVAL || *vtype == VTYPE_ZCVAL) &&
+        ks->ks_use_vgmap) {
         merr_t err;
 
         /* This ugly cast is because we use a mix of 32 and 16-bit bytes to represent
@@ -3258,6 +3330,16 @@ kvset_iter_next_vref(
             abort();
     }
 
+    /* An expired value is indistinguishable from a tombstone to readers
+     * and compaction, the latter of which will eventually drop it.
+     */
+    if (HSE_UNLIKELY(kvs_expired(vc->expire))) {
+        *vtype = VTYPE_TOMB;
+        *vlen = 0;
+        *complen = 0;
+        vc->expire = 0;
+    }
+
     vc->next++;
 
     return true;
@@ -3447,6 +3529,7 @@ kvset_iter_val_get(
     case VTYPE_UCVAL:
         return kvset_iter_get_valptr(handle, vbidx, vboff, *vlen, vdata);
     case VTYPE_CVAL:
+    case VTYPE_ZCVAL:
         return kvset_iter_get_valptr(handle, vbidx, vboff, *complen, vdata);
     case VTYPE_ZVAL:
         *vdata = 0;
@@ -3535,6 +3618,9 @@ kvset_iter_release(struct kv_iterator *handle)
     wbti_destroy(iter->wbti);
     wbti_destroy(iter->pti);
 
+    free(iter->wbt_reader.wb_xbuf);
+    free(iter->pt_reader.wb_xbuf);
+
     kvset_iter_free_buffers(iter, &iter->kreader);
     kvset_iter_free_buffers(iter, &iter->ptreader);
 
@@ -3608,6 +3694,23 @@ kvset_max_ptkey(const struct kvset *ks, const void **max, uint16_t *maxlen)
     }
 }
 
+/**
+ * kvset_kblk_minkey() - Return the smallest key in the given kblock.
+ *
+ * @ks:      Kvset handle
+ * @index:   kblock index
+ * @minkey:  (output) pointer to the min key
+ * @minklen: (output) length of @minkey
+ */
+void
+kvset_kblk_minkey(const struct kvset *ks, uint32_t index, const void **minkey, uint16_t *minklen)
+{
+    assert(index < ks->ks_st.kst_kblks);
+
+    *minkey = ks->ks_kblks[index].kb_koff_min;
+    *minklen = ks->ks_kblks[index].kb_klen_min;
+}
+
 struct vgmap *
 vgmap_alloc(uint32_t nvgroups)
 {
@@ -14,6 +14,7 @@
 #include <hse/ikvdb/csched.h>
 #include <hse/ikvdb/kvs_cparams.h>
 #include <hse/ikvdb/kvset_view.h>
+#include <hse/ikvdb/mclass_policy.h>
 #include <hse/ikvdb/omf_kmd.h>
 #include <hse/ikvdb/tuple.h>
 #include <hse/util/list.h>
@@ -47,6 +48,7 @@ enum kvset_iter_flags {
     kvset_iter_flag_mmap = (1u << 0),
     kvset_iter_flag_reverse = (1u << 1),
     kvset_iter_flag_fullscan = (1u << 2),
+    kvset_iter_flag_novals = (1u << 3),
 };
 
 /**
@@ -61,6 +63,7 @@ enum kvset_iter_flags {
  * @km_nodeid:      cn tree node ID
  * @km_compc:       compaction count (prevents repeated kvset compaction)
  * @km_rule:        compaction rule ID that created this kvset
+ * @km_rtomb_seqno: range tombstones up to this seqno have been applied
  * @km_capped:      cn is capped
  * @km_restored:    kvset is being restored from the cndb
  *
@@ -77,6 +80,7 @@ struct kvset_meta {
     uint64_t km_nodeid;
     uint16_t km_compc;
     uint16_t km_rule;
+    uint64_t km_rtomb_seqno;
     bool km_capped;
     bool km_restored;
 };
@@ -282,7 +286,9 @@ kvset_kblk_start(struct kvset *kvset, const void *key, int len, bool reverse);
  * @kt:     key to search for
  * @kdisc:  key discriminator
  * @seq:    sequence number
+ * @direct: read a vblock value from media rather than the mcache map
  * @result: (output) one of NOT_FOUND, FOUND_VAL, or FOUND_TMB (tombstone)
+ * @vref:   (output) reference to the value if result==FOUND_VAL
  * @vbuf:   (output) value if result==FOUND_VAL
  *                   If vbuf->b_buf is NULL, a buffer large enough to hold the
  *                   value will be allocated.
@@ -293,7 +299,9 @@ kvset_lookup(
     struct kvs_ktuple *kt,
     const struct key_disc *kdisc,
     uint64_t seq,
+    bool direct,
     enum key_lookup_res *res,
+    struct kvs_vtuple_ref *vref,
     struct kvs_buf *vbuf);
 
 struct query_ctx;
@@ -391,6 +399,19 @@ kvset_set_compc(struct kvset *ks, uint32_t compc);
 uint
 kvset_get_vgroups(const struct kvset *km);
 
+/**
+ * kvset_get_mclass() - get the media class on which a kvset's data resides
+ * @ks:    kvset handle
+ * @dtype: HSE_MPOLICY_DTYPE_KEY for the hblock and kblocks,
+ *         HSE_MPOLICY_DTYPE_VALUE for the vblocks
+ *
+ * Return: The media class of the hblock if dtype is key, or of the first
+ * vblock if dtype is value (HSE_MCLASS_INVALID if the kvset has no vblocks).
+ */
+/* MTF_MOCK */
+enum hse_mclass
+kvset_get_mclass(const struct kvset *ks, enum hse_mclass_policy_dtype dtype);
+
 size_t
 kvset_get_kwlen(const struct kvset *ks);
 
@@ -426,6 +447,8 @@ kvset_get_dgen_lo(const struct kvset *kvset);
  *     be used with memory map based iteration.
  *   - %kvset_iter_flag_mmap: If set, use memory maps to access
  *     mblock data.  If not set, access data with mblock read.
+ *   - %kvset_iter_flag_novals: The caller will not fetch values from
+ *     vblocks, so vblock readahead is disabled.
  *
  * Notes:
  *   - @io_workq is ignored when iterating with memory maps.
@@ -559,6 +582,10 @@ kvset_minkey(const struct kvset *ks, const void **minkey, uint16_t *minklen);
 void
 kvset_max_ptkey(const struct kvset *ks, const void **max, uint16_t *maxlen);
 
+/* MTF_MOCK */
+void
+kvset_kblk_minkey(const struct kvset *ks, uint32_t index, const void **minkey, uint16_t *minklen);
+
 /**
  * kvset_iter_next_val_direct() -  read value via direct io
  * @handle: handle to kv iterator
@@ -145,6 +145,9 @@ kvset_builder_add_key(struct kvset_builder *self, const struct key_obj *kobj)
     self->key_stats.tot_vlen = 0;
     self->key_stats.tot_vused = 0;
     self->key_stats.nptombs = 0;
+    self->key_stats.nexpire = 0;
+    self->key_stats.expire_min = 0;
+    self->key_stats.expire_max = 0;
 
     self->kblk_kmd.kmd_used = 0;
     self->hblk_kmd.kmd_used = 0;
@@ -163,8 +166,11 @@ kvset_builder_add_key(struct kvset_builder *self, const struct key_obj *kobj)
  *         bytes of compressed value data, or a special tombstone pointer.
  * @vlen: Length of uncompressed value.
  * @seq: Sequence number of value or tombstone.
+ * @expire: Expiration time of the value (seconds since the epoch), or 0 if
+ *          the value never expires.  Ignored for tombstones.
  * @complen: Length of compressed value if value is compressed. Must
  *           be set to 0 if value is not compressed.
+ * @calgo: Algorithm the value was compressed with.  Ignored if @complen is 0.
  *
  * Notes on compression:
  * - If @complen > 0, then the value is already compressed and will be
@@ -186,7 +192,9 @@ kvset_builder_add_val(
     const void *vdata,
     uint vlen,
     uint64_t seq,
-    uint complen)
+    uint64_t expire,
+    uint complen,
+    enum vcomp_algorithm calgo)
 {
     merr_t err;
     uint64_t seqno_prev;
@@ -203,12 +211,14 @@ kvset_builder_add_val(
         self->key_stats.nptombs++;
         self->last_ptseq = seq;
     } else if (!vdata || vlen == 0) {
-        kmd_add_zval(self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq);
+        kmd_add_zval(self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq, expire);
+        key_stats_add_expire(&self->key_stats, expire);
     } else if (complen == 0 && vlen <= CN_SMALL_VALUE_THRESHOLD) {
         /* Do not currently support compressed valus in KMD as an "ival", so
          * complen must be zero.
          */
-        kmd_add_ival(self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq, vdata, vlen);
+        kmd_add_ival(self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq, expire, vdata, vlen);
+        key_stats_add_expire(&self->key_stats, expire);
         self->key_stats.tot_vlen += vlen;
     } else {
 
@@ -228,9 +238,13 @@ kvset_builder_add_val(
 
         if (complen)
             kmd_add_cval(
-                self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq, vbidx, vboff, vlen, complen);
+                self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, calgo_to_vtype(calgo), seq, expire,
+                vbidx, vboff, vlen, complen);
         else
-            kmd_add_val(self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq, vbidx, vboff, vlen);
+            kmd_add_val(
+                self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq, expire, vbidx, vboff, vlen);
+
+        key_stats_add_expire(&self->key_stats, expire);
 
         /* stats (and space amp) use on-media length */
         self->vused += omlen;
@@ -259,19 +273,21 @@ kvset_builder_add_val(
 }
 
 /**
- * kvset_builder_add_vref() - add a VTYPE_UCVAL or VTYPE_CVAL entry its a kvset
+ * kvset_builder_add_vref() - add a VTYPE_UCVAL, VTYPE_CVAL or VTYPE_ZCVAL entry its a kvset
  *
- * If @complen > 0, a VTYPE_CVAL entry will written to media.
+ * If @complen > 0, a VTYPE_CVAL or VTYPE_ZCVAL entry (per @calgo) will written to media.
  * If @complen == 0, a VTYPE_UCVAL entry will written to media.
  */
 merr_t
 kvset_builder_add_vref(
     struct kvset_builder *self,
     uint64_t seq,
+    uint64_t expire,
     uint vbidx,
     uint vboff,
     uint vlen,
-    uint complen)
+    uint complen,
+    enum vcomp_algorithm calgo)
 {
     uint om_len = complen ? complen : vlen; /* on-media length */
 
@@ -280,9 +296,13 @@ kvset_builder_add_vref(
 
     if (complen > 0)
         kmd_add_cval(
-            self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq, vbidx, vboff, vlen, complen);
+            self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, calgo_to_vtype(calgo), seq, expire,
+            vbidx, vboff, vlen, complen);
     else
-        kmd_add_val(self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq, vbidx, vboff, vlen);
+        kmd_add_val(
+            self->kblk_kmd.kmd, &self->kblk_kmd.kmd_used, seq, expire, vbidx, vboff, vlen);
+
+    key_stats_add_expire(&self->key_stats, expire);
 
     self->vused += om_len;
     self->key_stats.tot_vlen += om_len;
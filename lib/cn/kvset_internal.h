@@ -127,6 +127,7 @@ struct kvset {
     atomic_int ks_mbset_callbacks;
     bool ks_mbset_cb_pending;
     uint64_t ks_seqno_min;
+    uint64_t ks_rtomb_seqno; /* range tombstones applied up to this seqno */
     size_t ks_kvset_sz;
     uint64_t ks_ctime;
 
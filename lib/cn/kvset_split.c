@@ -160,10 +160,12 @@ kblock_copy_range(
 
             /* Pass NULL for vgmap as vbidx is not used here */
             wbt_read_kmd_vref(kmd, NULL, &off, &vseq, &vref);
+            key_stats_add_expire(&stats, vref.vr_expire);
 
             switch (vref.vr_type) {
             case VTYPE_UCVAL:
             case VTYPE_CVAL:
+            case VTYPE_ZCVAL:
                 omlen = (vref.vb.vr_complen ? vref.vb.vr_complen : vref.vb.vr_len);
                 stats.tot_vlen += omlen;
                 stats.tot_vused += omlen;
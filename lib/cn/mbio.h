@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
+ */
+
+#ifndef HSE_KVS_CN_MBIO_H
+#define HSE_KVS_CN_MBIO_H
+
+#include <hse/error/merr.h>
+#include <hse/util/arch.h>
+#include <hse/util/assert.h>
+#include <hse/util/condvar.h>
+#include <hse/util/mutex.h>
+
+#include "cn_metrics.h"
+
+/**
+ * struct async_mbio - completion state of one asynchronous mblock i/o
+ * @mutex:    protects @pending and @status
+ * @pending:  an i/o has been armed and not yet signaled
+ * @status:   status of the most recently completed i/o
+ * @cv_wmesg: wait message for mbio_wait()
+ * @cv:       signaled on completion
+ *
+ * The issuer arms the mbio and hands the i/o to a workqueue, the worker
+ * signals the mbio when the i/o is done, and the issuer collects the status
+ * with mbio_wait() before it reuses the i/o buffers.  At most one i/o may be
+ * in flight per mbio.
+ */
+struct async_mbio {
+    struct mutex mutex;
+    int pending;
+    merr_t status;
+    const char *cv_wmesg;
+    struct cv cv;
+};
+
+static inline void
+mbio_init(struct async_mbio *io, const char *wmesg)
+{
+    mutex_init(&io->mutex);
+    cv_init(&io->cv);
+    io->status = 0;
+    io->pending = 0;
+    io->cv_wmesg = wmesg;
+}
+
+static inline void
+mbio_fini(struct async_mbio *io)
+{
+    assert(!io->pending);
+    cv_destroy(&io->cv);
+    mutex_destroy(&io->mutex);
+}
+
+static inline void
+mbio_arm(struct async_mbio *io)
+{
+    mutex_lock(&io->mutex);
+    assert(!io->pending);
+    io->pending = 1;
+    mutex_unlock(&io->mutex);
+}
+
+static inline void
+mbio_signal(struct async_mbio *io, merr_t err)
+{
+    mutex_lock(&io->mutex);
+    assert(io->pending);
+    io->status = err;
+    io->pending = 0;
+    cv_signal(&io->cv);
+    mutex_unlock(&io->mutex);
+}
+
+static inline merr_t
+mbio_wait(struct async_mbio *io, struct cn_merge_stats_ops *stats)
+{
+    merr_t err;
+    uint64_t tstart = 0;
+
+    mutex_lock(&io->mutex);
+    if (stats && io->pending)
+        tstart = get_time_ns();
+    while (io->pending)
+        cv_wait(&io->cv, &io->mutex, io->cv_wmesg);
+    if (tstart)
+        count_ops(stats, 1, 0, get_time_ns() - tstart);
+    err = io->status;
+    mutex_unlock(&io->mutex);
+    return err;
+}
+
+#endif
@@ -31,6 +31,7 @@
 #include "node_split.h"
 #include "route.h"
 #include "wbt_internal.h"
+#include "wbt_reader.h"
 
 struct reverse_kblk_iterator {
     struct kvset *ks;
@@ -38,6 +39,18 @@ struct reverse_kblk_iterator {
     uint32_t offset;
 };
 
+/* A leaf node and its first key, which for LFC nodes must be decoded.
+ */
+struct wbt_leaf_elem {
+    const struct wbt_node_hdr_omf *node;
+    struct key_obj key;
+    uint8_t kbuf[HSE_KVS_KEY_LEN_MAX];
+};
+
+/* Elements alternate between the two slots of elemv so that the element
+ * most recently popped from the bin heap remains valid while the heap
+ * refills from this source.
+ */
 struct forward_wbt_leaf_iterator {
     struct kvset *ks;
     struct element_source es;
@@ -45,6 +58,8 @@ struct forward_wbt_leaf_iterator {
         uint32_t kblk_idx;
         uint32_t leaf_idx;
     } offset;
+    uint elemx;
+    struct wbt_leaf_elem elemv[2];
 };
 
 static bool
@@ -267,6 +282,7 @@ forward_wbt_leaf_iterator_next(struct element_source *source, void **data)
 {
     struct kvset_kblk *kblk;
     struct wbt_desc *desc;
+    struct wbt_leaf_elem *elem;
     struct forward_wbt_leaf_iterator *iter =
         container_of(source, struct forward_wbt_leaf_iterator, es);
 
@@ -287,10 +303,36 @@ forward_wbt_leaf_iterator_next(struct element_source *source, void **data)
     if (iter->offset.leaf_idx == 0)
         kbr_madvise_wbt_leaf_nodes(&kblk->kb_kblk_desc, desc, MADV_WILLNEED);
 
-    *data = kblk->kb_kblk_desc.map_base + desc->wbd_first_page * PAGE_SIZE +
+    iter->elemx ^= 1;
+    elem = &iter->elemv[iter->elemx];
+
+    elem->node = kblk->kb_kblk_desc.map_base + desc->wbd_first_page * PAGE_SIZE +
         iter->offset.leaf_idx * WBT_NODE_SIZE;
 
-    assert(((struct wbt_node_hdr_omf *)(*data))->wbn_magic == WBT_LFE_NODE_MAGIC);
+    assert(wbt_node_is_leaf(elem->node));
+
+    if (omf_wbn_magic(elem->node) == WBT_LFC_NODE_MAGIC) {
+        merr_t err;
+        uint klen;
+
+        err = wbt_leaf_first_key(elem->node, elem->kbuf, &klen);
+        if (err) {
+            log_errx("Failed to decode wbtree leaf node %u of kblock %u",
+                     err, iter->offset.leaf_idx, iter->offset.kblk_idx);
+            return false;
+        }
+
+        elem->key.ko_pfx = NULL;
+        elem->key.ko_pfx_len = 0;
+        elem->key.ko_sfx = elem->kbuf;
+        elem->key.ko_sfx_len = klen;
+    } else {
+        wbt_node_pfx(elem->node, &elem->key.ko_pfx, &elem->key.ko_pfx_len);
+        wbt_lfe_key(
+            elem->node, wbt_lfe(elem->node, 0), &elem->key.ko_sfx, &elem->key.ko_sfx_len);
+    }
+
+    *data = elem;
 
     /* Move to next kblock if we have exhausted all the WBT leaf nodes in the
      * current kblock.
@@ -317,6 +359,7 @@ forward_wbt_leaf_iterator_init(
     iter->ks = ks;
     iter->offset.kblk_idx = kblk_idx;
     iter->offset.leaf_idx = 0;
+    iter->elemx = 0;
     iter->es = es_make(forward_wbt_leaf_iterator_next, NULL, NULL);
 }
 
@@ -330,23 +373,13 @@ forward_wbt_leaf_iterator_init(
 static int
 wbt_leaf_compare(const void * const a, const void * const b)
 {
-    const struct wbt_node_hdr_omf *wbt_node_a = a, *wbt_node_b = b;
-    const struct wbt_lfe_omf *lfe_a, *lfe_b;
-    struct key_obj key_a, key_b;
+    const struct wbt_leaf_elem *elem_a = a, *elem_b = b;
 
     INVARIANT(a);
     INVARIANT(b);
 
-    lfe_a = wbt_lfe(wbt_node_a, 0);
-    wbt_node_pfx(wbt_node_a, &key_a.ko_pfx, &key_a.ko_pfx_len);
-    wbt_lfe_key(wbt_node_a, lfe_a, &key_a.ko_sfx, &key_a.ko_sfx_len);
-
-    lfe_b = wbt_lfe(wbt_node_b, 0);
-    wbt_node_pfx(wbt_node_b, &key_b.ko_pfx, &key_b.ko_pfx_len);
-    wbt_lfe_key(wbt_node_b, lfe_b, &key_b.ko_sfx, &key_b.ko_sfx_len);
-
     /* Return the WBT leaf node with the smallest key. */
-    return key_obj_cmp(&key_a, &key_b);
+    return key_obj_cmp(&elem_a->key, &elem_b->key);
 }
 
 static merr_t
@@ -364,10 +397,8 @@ find_split_key(
     uint64_t num_kvsets;
     struct forward_wbt_leaf_iterator *iters;
     struct element_source **srcs;
-    const struct wbt_lfe_omf *lfe;
-    struct key_obj key;
     uint64_t limit;
-    struct wbt_node_hdr_omf *wnode = NULL;
+    struct wbt_leaf_elem *elem = NULL;
     void *buf = NULL;
     uint64_t total_kvlen = 0;
     uint64_t kvset_idx = 0;
@@ -426,22 +457,17 @@ find_split_key(
     if (ev(err))
         goto out;
 
-    while (seen_kvlen <= limit && bin_heap_pop(bh, (void **)&wnode))
-        seen_kvlen += omf_wbn_kvlen(wnode);
-    assert(wnode);
+    while (seen_kvlen <= limit && bin_heap_pop(bh, (void **)&elem))
+        seen_kvlen += omf_wbn_kvlen(elem->node);
+    assert(elem);
 
     log_debug(
         "node %lu split key kvlen: %lu/%lu (%lf%%)", tn->tn_nodeid, seen_kvlen, total_kvlen,
         (double)seen_kvlen * 100 / total_kvlen);
 
-    assert(omf_wbn_num_keys(wnode) > 0);
-
-    /* Get first leaf node entry */
-    lfe = wbt_lfe(wnode, 0);
-    wbt_node_pfx(wnode, &key.ko_pfx, &key.ko_pfx_len);
-    wbt_lfe_key(wnode, lfe, &key.ko_sfx, &key.ko_sfx_len);
+    assert(omf_wbn_num_keys(elem->node) > 0);
 
-    key_obj_copy(key_buf, key_buf_sz, key_len, &key);
+    key_obj_copy(key_buf, key_buf_sz, key_len, &elem->key);
     assert(*key_len <= HSE_KVS_KEY_LEN_MAX);
 
 out:
@@ -26,6 +26,9 @@
  *         there is no version field for KMD, so we bump the WBTree
  *         version even though the actual WBTree header, leaf and
  *         internal nodes are no different from OMF v5.
+ *         Kblock v7 trees may also contain delta encoded and optionally
+ *         compressed leaf nodes (WBT_LFC_NODE_MAGIC), in which case the
+ *         tree header has WBT_FLAGS_LFC set.
  *
  * Deprecated versions:
  *     v5: Added longest common prefix elimination for keys in WBTree nodes
@@ -43,7 +46,7 @@ struct wbt_hdr_omf {
     uint16_t wbt_leaf;     /* index of first wbtree leaf node */
     uint16_t wbt_leaf_cnt; /* number of wbtree leaf nodes */
     uint16_t wbt_kmd_pgc;  /* size of kmd region in pages */
-    uint32_t wbt_reserved1;
+    uint32_t wbt_flags;    /* WBT_FLAGS_* */
     uint32_t wbt_reserved2;
 } HSE_PACKED;
 
@@ -53,9 +56,14 @@ OMF_SETGET(struct wbt_hdr_omf, wbt_root, 16);
 OMF_SETGET(struct wbt_hdr_omf, wbt_leaf, 16);
 OMF_SETGET(struct wbt_hdr_omf, wbt_leaf_cnt, 16);
 OMF_SETGET(struct wbt_hdr_omf, wbt_kmd_pgc, 16);
+OMF_SETGET(struct wbt_hdr_omf, wbt_flags, 32);
+
+/* Some of the tree's leaf nodes are WBT_LFC_NODE_MAGIC nodes */
+#define WBT_FLAGS_LFC (1u << 0)
 
 #define WBT_LFE_NODE_MAGIC ((uint16_t)0xabc0)
 #define WBT_INE_NODE_MAGIC ((uint16_t)0xabc1)
+#define WBT_LFC_NODE_MAGIC ((uint16_t)0xabc2)
 
 /* WBT node header (v6) */
 struct wbt_node_hdr_omf {
@@ -98,6 +106,37 @@ struct wbt_lfe_omf {
 OMF_SETGET(struct wbt_lfe_omf, lfe_koff, 16)
 OMF_SETGET(struct wbt_lfe_omf, lfe_kmd, 16)
 
+/* WBT compressed leaf node header (kblock v7)
+ *
+ * An LFC leaf node holds the same keys as an LFE leaf node, but not in a
+ * directly searchable form.  The node header has the same meaning as for
+ * LFE nodes, except that the node's longest common prefix (wbn_pfx_len) is
+ * not stored.  The node header is followed by this header and then by
+ * lfc_grpc restart groups, each of which is laid out as:
+ *
+ *     hg16  raw length of the group's entries
+ *     hg16  stored length of the group's entries
+ *     ...   entries, compressed with lfc_calgo if stored length < raw length
+ *
+ * Each entry is laid out as:
+ *
+ *     hg16  length of the prefix shared with the previous key in the group
+ *     hg16  length of the remainder of the key
+ *     hg32  kmd offset, relative to wbn_kmd
+ *     ...   remainder of the key
+ *
+ * The first key of each group is stored in full, so that groups can be
+ * decoded independently.
+ */
+struct wbt_lfc_hdr_omf {
+    uint16_t lfc_grpc;  /* number of restart groups */
+    uint8_t  lfc_calgo; /* 0: none, otherwise 1 + enum vcomp_algorithm */
+    uint8_t  lfc_rsvd;  /* unused padding */
+} HSE_PACKED;
+
+OMF_SETGET(struct wbt_lfc_hdr_omf, lfc_grpc, 16)
+OMF_SETGET(struct wbt_lfc_hdr_omf, lfc_calgo, 8)
+
 /*****************************************************************
  *
  * Hblock header OMF
@@ -225,7 +264,7 @@ struct kblock_hdr_omf {
     /* metrics */
     uint32_t kbh_entries;
     uint32_t kbh_tombs;
-    uint32_t kbh_rsvd1;
+    uint32_t kbh_expire_cnt; /* number of values with an expiration time (v7) */
     uint32_t kbh_key_bytes;
     uint64_t kbh_val_bytes;
     uint64_t kbh_kvlen;
@@ -250,6 +289,10 @@ struct kblock_hdr_omf {
     uint32_t kbh_blm_hlen;
     uint32_t kbh_blm_doff_pg;
     uint32_t kbh_blm_dlen_pg;
+
+    /* Range of value expiration times (v7) */
+    uint64_t kbh_expire_min;
+    uint64_t kbh_expire_max;
 } HSE_PACKED;
 
 /* Define set/get methods for kblock_hdr_omf */
@@ -280,6 +323,10 @@ OMF_SETGET(struct kblock_hdr_omf, kbh_blm_hlen, 32)
 OMF_SETGET(struct kblock_hdr_omf, kbh_blm_doff_pg, 32)
 OMF_SETGET(struct kblock_hdr_omf, kbh_blm_dlen_pg, 32)
 
+OMF_SETGET(struct kblock_hdr_omf, kbh_expire_cnt, 32)
+OMF_SETGET(struct kblock_hdr_omf, kbh_expire_min, 64)
+OMF_SETGET(struct kblock_hdr_omf, kbh_expire_max, 64)
+
 /* Storing 2 keys in the header: min and max. */
 #define KBLOCK_HDR_PAGES \
     (roundup(sizeof(struct kblock_hdr_omf) + 2 * HSE_KVS_KEY_LEN_MAX, PAGE_SIZE) / PAGE_SIZE)
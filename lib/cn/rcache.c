@@ -0,0 +1,414 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <hse/ikvdb/tuple.h>
+#include <hse/kvdb_perfc.h>
+#include <hse/util/assert.h>
+#include <hse/util/atomic.h>
+#include <hse/util/compiler.h>
+#include <hse/util/event_counter.h>
+#include <hse/util/list.h>
+#include <hse/util/log2.h>
+#include <hse/util/minmax.h>
+#include <hse/util/mutex.h>
+#include <hse/util/page.h>
+#include <hse/util/perfc.h>
+
+#include "rcache.h"
+
+/* clang-format off */
+
+#define RCACHE_SHARDS_MAX       (64)
+#define RCACHE_SHARD_SZMIN      (1ul << 20)
+#define RCACHE_ROW_AVG          (256)
+#define RCACHE_ROW_MAX_SHIFT    (6)
+#define RCACHE_REF_MAX          (3)
+
+static struct perfc_name rcache_perfc[] _dt_section = {
+    NE(PERFC_RA_RCACHE_HIT,      2, "Row cache hit rate",        "r_hit(/s)"),
+    NE(PERFC_RA_RCACHE_MISS,     2, "Row cache miss rate",       "r_miss(/s)"),
+    NE(PERFC_RA_RCACHE_INSERT,   3, "Row cache insert rate",     "r_insert(/s)"),
+    NE(PERFC_RA_RCACHE_STALE,    3, "Row cache stale fill rate", "r_stale(/s)"),
+    NE(PERFC_RA_RCACHE_EVICT,    3, "Row cache evict rate",      "r_evict(/s)"),
+};
+
+NE_CHECK(rcache_perfc, PERFC_EN_RCACHE, "rcache_perfc table/enum mismatch");
+
+/* clang-format on */
+
+/**
+ * struct rcache_row - a cached key/value pair
+ *
+ * @rr_next:   next row in the hash chain
+ * @rr_link:   clock list linkage
+ * @rr_hash:   key hash
+ * @rr_seq:    seqno of the value
+ * @rr_expire: expiration time of the value (zero if it never expires)
+ * @rr_klen:   key length
+ * @rr_vlen:   value length
+ * @rr_ref:    clock reference count
+ * @rr_data:   key followed by value
+ */
+struct rcache_row {
+    struct rcache_row *rr_next;
+    struct list_head   rr_link;
+    uint64_t           rr_hash;
+    uint64_t           rr_seq;
+    uint64_t           rr_expire;
+    uint32_t           rr_klen;
+    uint32_t           rr_vlen;
+    uint8_t            rr_ref;
+    char               rr_data[];
+};
+
+/**
+ * struct rcache_shard - independently locked partition of the cache
+ *
+ * @rs_lock:    protects all fields of the shard but @rs_gen
+ * @rs_gen:     generation count, bumped by every invalidation
+ * @rs_used:    bytes consumed by rows
+ * @rs_size:    max bytes consumed by rows
+ * @rs_clock:   rows in clock order (the hand is at the head)
+ * @rs_bktmask: hash bucket mask
+ * @rs_bktv:    hash bucket heads
+ */
+struct rcache_shard {
+    struct mutex        rs_lock HSE_L1D_ALIGNED;
+    atomic_ulong        rs_gen;
+    size_t              rs_used;
+    size_t              rs_size;
+    struct list_head    rs_clock;
+    uint32_t            rs_bktmask;
+    struct rcache_row **rs_bktv;
+};
+
+struct rcache {
+    uint32_t            rc_nshards;
+    size_t              rc_row_max;
+    struct perfc_set    rc_pc;
+    atomic_ulong        rc_seqno HSE_L1D_ALIGNED;
+    struct rcache_shard rc_shardv[];
+};
+
+static HSE_ALWAYS_INLINE size_t
+rcache_row_size(uint32_t klen, uint32_t vlen)
+{
+    return sizeof(struct rcache_row) + klen + vlen;
+}
+
+static HSE_ALWAYS_INLINE struct rcache_shard *
+rcache_shard(struct rcache *rc, uint64_t hash)
+{
+    return rc->rc_shardv + (hash % rc->rc_nshards);
+}
+
+static struct rcache_row **
+rcache_chain(struct rcache_shard *rs, uint64_t hash)
+{
+    return rs->rs_bktv + ((hash >> 32) & rs->rs_bktmask);
+}
+
+/* Return a pointer to the link that references the row of the given key,
+ * or to the terminating NULL link of the key's hash chain.
+ */
+static struct rcache_row **
+rcache_find(struct rcache_shard *rs, const struct kvs_ktuple *kt)
+{
+    struct rcache_row **rrp = rcache_chain(rs, kt->kt_hash);
+
+    while (*rrp) {
+        struct rcache_row *rr = *rrp;
+
+        if (rr->rr_hash == kt->kt_hash && rr->rr_klen == kt->kt_len &&
+            !memcmp(rr->rr_data, kt->kt_data, kt->kt_len))
+            break;
+
+        rrp = &rr->rr_next;
+    }
+
+    return rrp;
+}
+
+static void
+rcache_unlink(struct rcache_shard *rs, struct rcache_row **rrp)
+{
+    struct rcache_row *rr = *rrp;
+
+    *rrp = rr->rr_next;
+    list_del(&rr->rr_link);
+    rs->rs_used -= rcache_row_size(rr->rr_klen, rr->rr_vlen);
+
+    free(rr);
+}
+
+/* Advance the clock hand until enough rows with a zero reference count
+ * have been evicted to make room for a row of the given size.
+ */
+static void
+rcache_evict(struct rcache *rc, struct rcache_shard *rs, size_t sz)
+{
+    while (rs->rs_used + sz > rs->rs_size) {
+        struct rcache_row *rr, **rrp;
+
+        rr = list_first_entry_or_null(&rs->rs_clock, struct rcache_row, rr_link);
+        if (!rr)
+            break;
+
+        if (rr->rr_ref > 0) {
+            rr->rr_ref--;
+            list_del(&rr->rr_link);
+            list_add_tail(&rr->rr_link, &rs->rs_clock);
+            continue;
+        }
+
+        rrp = rcache_chain(rs, rr->rr_hash);
+        while (*rrp != rr)
+            rrp = &(*rrp)->rr_next;
+
+        rcache_unlink(rs, rrp);
+        perfc_inc(&rc->rc_pc, PERFC_RA_RCACHE_EVICT);
+    }
+}
+
+uint64_t
+rcache_gen(struct rcache *rc, const struct kvs_ktuple *kt)
+{
+    return atomic_read_acq(&rcache_shard(rc, kt->kt_hash)->rs_gen);
+}
+
+bool
+rcache_get(
+    struct rcache *rc,
+    const struct kvs_ktuple *kt,
+    uint64_t seq,
+    struct kvs_buf *vbuf,
+    uint64_t *vseqp)
+{
+    struct rcache_shard *rs = rcache_shard(rc, kt->kt_hash);
+    struct rcache_row *rr, **rrp;
+
+    mutex_lock(&rs->rs_lock);
+    rrp = rcache_find(rs, kt);
+    rr = *rrp;
+
+    if (rr && kvs_expired(rr->rr_expire)) {
+        rcache_unlink(rs, rrp);
+        rr = NULL;
+    }
+
+    if (!rr || rr->rr_seq > seq) {
+        mutex_unlock(&rs->rs_lock);
+        perfc_inc(&rc->rc_pc, PERFC_RA_RCACHE_MISS);
+        return false;
+    }
+
+    if (rr->rr_ref < RCACHE_REF_MAX)
+        rr->rr_ref++;
+
+    memcpy(vbuf->b_buf, rr->rr_data + rr->rr_klen, min_t(uint32_t, rr->rr_vlen, vbuf->b_buf_sz));
+    vbuf->b_len = rr->rr_vlen;
+    *vseqp = rr->rr_seq;
+    mutex_unlock(&rs->rs_lock);
+
+    perfc_inc(&rc->rc_pc, PERFC_RA_RCACHE_HIT);
+
+    return true;
+}
+
+void
+rcache_put(
+    struct rcache *rc,
+    const struct kvs_ktuple *kt,
+    uint64_t gen,
+    uint64_t view,
+    uint64_t seq,
+    uint64_t expire,
+    const void *val,
+    uint32_t vlen)
+{
+    struct rcache_shard *rs = rcache_shard(rc, kt->kt_hash);
+    struct rcache_row *rr, **rrp;
+    size_t sz;
+
+    sz = rcache_row_size(kt->kt_len, vlen);
+    if (sz > rc->rc_row_max)
+        return;
+
+    rr = malloc(sz);
+    if (ev(!rr))
+        return;
+
+    rr->rr_hash = kt->kt_hash;
+    rr->rr_seq = seq;
+    rr->rr_expire = expire;
+    rr->rr_klen = kt->kt_len;
+    rr->rr_vlen = vlen;
+    rr->rr_ref = 0;
+    memcpy(rr->rr_data, kt->kt_data, kt->kt_len);
+    memcpy(rr->rr_data + kt->kt_len, val, vlen);
+
+    mutex_lock(&rs->rs_lock);
+    if (atomic_read(&rs->rs_gen) != gen || view < atomic_read_acq(&rc->rc_seqno)) {
+        mutex_unlock(&rs->rs_lock);
+        perfc_inc(&rc->rc_pc, PERFC_RA_RCACHE_STALE);
+        free(rr);
+        return;
+    }
+
+    rrp = rcache_find(rs, kt);
+    if (*rrp)
+        rcache_unlink(rs, rrp);
+
+    rcache_evict(rc, rs, sz);
+
+    rrp = rcache_chain(rs, kt->kt_hash);
+    rr->rr_next = *rrp;
+    *rrp = rr;
+    list_add_tail(&rr->rr_link, &rs->rs_clock);
+    rs->rs_used += sz;
+    mutex_unlock(&rs->rs_lock);
+
+    perfc_inc(&rc->rc_pc, PERFC_RA_RCACHE_INSERT);
+}
+
+void
+rcache_invalidate(struct rcache *rc, const struct kvs_ktuple *kt)
+{
+    struct rcache_shard *rs = rcache_shard(rc, kt->kt_hash);
+    struct rcache_row **rrp;
+
+    mutex_lock(&rs->rs_lock);
+    atomic_inc_rel(&rs->rs_gen);
+
+    rrp = rcache_find(rs, kt);
+    if (*rrp)
+        rcache_unlink(rs, rrp);
+    mutex_unlock(&rs->rs_lock);
+}
+
+static void
+rcache_shard_purge(struct rcache_shard *rs)
+{
+    struct rcache_row *rr, *next;
+
+    list_for_each_entry_safe(rr, next, &rs->rs_clock, rr_link)
+        free(rr);
+
+    INIT_LIST_HEAD(&rs->rs_clock);
+    memset(rs->rs_bktv, 0, sizeof(*rs->rs_bktv) * (rs->rs_bktmask + 1));
+    rs->rs_used = 0;
+}
+
+void
+rcache_purge(struct rcache *rc)
+{
+    uint32_t i;
+
+    for (i = 0; i < rc->rc_nshards; i++) {
+        struct rcache_shard *rs = rc->rc_shardv + i;
+
+        mutex_lock(&rs->rs_lock);
+        atomic_inc_rel(&rs->rs_gen);
+        rcache_shard_purge(rs);
+        mutex_unlock(&rs->rs_lock);
+    }
+}
+
+void
+rcache_seqno_set(struct rcache *rc, uint64_t seqno)
+{
+    uint64_t old = atomic_read(&rc->rc_seqno);
+
+    while (old < seqno && !atomic_cmpxchg(&rc->rc_seqno, &old, seqno))
+        continue;
+}
+
+void
+rcache_perfc_alloc(struct rcache *rc, const char *group, uint prio)
+{
+    perfc_alloc(rcache_perfc, group, "rcache", prio, &rc->rc_pc);
+}
+
+merr_t
+rcache_create(size_t size, struct rcache **out)
+{
+    struct rcache *rc;
+    uint32_t nshards, i;
+    size_t sz;
+
+    if (ev(!out))
+        return merr(EINVAL);
+
+    if (ev(size < RCACHE_SHARD_SZMIN))
+        return merr(EINVAL);
+
+    nshards = clamp_t(size_t, size / RCACHE_SHARD_SZMIN, 1, RCACHE_SHARDS_MAX);
+
+    sz = sizeof(*rc) + sizeof(rc->rc_shardv[0]) * nshards;
+
+    rc = aligned_alloc(__alignof__(*rc), ALIGN(sz, __alignof__(*rc)));
+    if (ev(!rc))
+        return merr(ENOMEM);
+
+    memset(rc, 0, sz);
+    rc->rc_nshards = nshards;
+    rc->rc_row_max = (size / nshards) >> RCACHE_ROW_MAX_SHIFT;
+
+    for (i = 0; i < nshards; i++) {
+        struct rcache_shard *rs = rc->rc_shardv + i;
+        uint32_t nbkts;
+
+        rs->rs_size = size / nshards;
+        INIT_LIST_HEAD(&rs->rs_clock);
+
+        /* Generation zero is never handed out so that callers may use
+         * it to mean "no fill".
+         */
+        atomic_set(&rs->rs_gen, 1);
+
+        nbkts = roundup_pow_of_two(rs->rs_size / RCACHE_ROW_AVG);
+        rs->rs_bktmask = nbkts - 1;
+
+        rs->rs_bktv = calloc(nbkts, sizeof(*rs->rs_bktv));
+
+        mutex_init(&rs->rs_lock);
+
+        if (ev(!rs->rs_bktv)) {
+            rc->rc_nshards = i + 1;
+            rcache_destroy(rc);
+            return merr(ENOMEM);
+        }
+    }
+
+    *out = rc;
+
+    return 0;
+}
+
+void
+rcache_destroy(struct rcache *rc)
+{
+    uint32_t i;
+
+    if (!rc)
+        return;
+
+    perfc_free(&rc->rc_pc);
+
+    for (i = 0; i < rc->rc_nshards; i++) {
+        struct rcache_shard *rs = rc->rc_shardv + i;
+
+        if (rs->rs_bktv)
+            rcache_shard_purge(rs);
+
+        mutex_destroy(&rs->rs_lock);
+        free(rs->rs_bktv);
+    }
+
+    free(rc);
+}
@@ -0,0 +1,152 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#ifndef HSE_CN_RCACHE_H
+#define HSE_CN_RCACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <hse/error/merr.h>
+
+/* The row cache holds copies of recently read key/value pairs so that point
+ * lookups of hot keys which have aged out of c0 are served without a route
+ * map lookup, bloom probes and wbtree searches in cn.  Rows are spread over
+ * a number of independently locked shards by key hash, and each shard is
+ * bounded in bytes and managed by a generalized CLOCK policy.
+ *
+ * Rows are filled after a cn hit and must be dropped by every update of
+ * their key.  To keep a fill from racing with an update, each shard carries
+ * a generation count which writers bump after they have inserted into c0.
+ * A reader samples the generation before it searches c0, and the fill is
+ * discarded if the generation has moved by the time the row is inserted.
+ * A fill is also discarded if the reader's view is older than the newest
+ * data ingested into cn, since such a reader may not have seen the latest
+ * version of the key.
+ *
+ * Every cached row is therefore the newest version of its key, and may be
+ * returned to any reader whose view includes the row's seqno.
+ */
+
+struct rcache;
+struct kvs_ktuple;
+struct kvs_buf;
+
+/**
+ * rcache_create() - create a row cache
+ *
+ * @size: cache size in bytes
+ * @out:  row cache handle (output)
+ */
+merr_t
+rcache_create(size_t size, struct rcache **out);
+
+/**
+ * rcache_destroy() - destroy a row cache
+ *
+ * @rc: row cache handle (may be NULL)
+ */
+void
+rcache_destroy(struct rcache *rc);
+
+/**
+ * rcache_perfc_alloc() - allocate the row cache performance counters
+ *
+ * @rc:    row cache handle
+ * @group: perfc group name
+ * @prio:  perfc level
+ */
+void
+rcache_perfc_alloc(struct rcache *rc, const char *group, uint prio);
+
+/**
+ * rcache_gen() - sample the generation of the shard of a key
+ *
+ * @rc: row cache handle
+ * @kt: key (with kt_hash set)
+ *
+ * Must be called before the key is searched for in c0.
+ *
+ * Return: generation to pass to rcache_put() (never zero)
+ */
+uint64_t
+rcache_gen(struct rcache *rc, const struct kvs_ktuple *kt);
+
+/**
+ * rcache_get() - look up a row
+ *
+ * @rc:   row cache handle
+ * @kt:   key (with kt_hash set)
+ * @seq:  view sequence number
+ * @vbuf: (output) value, truncated to vbuf->b_buf_sz
+ * @vseqp: (output) seqno of the value
+ *
+ * Return: true if a row visible to @seq was found and copied into @vbuf.
+ */
+bool
+rcache_get(
+    struct rcache *rc,
+    const struct kvs_ktuple *kt,
+    uint64_t seq,
+    struct kvs_buf *vbuf,
+    uint64_t *vseqp);
+
+/**
+ * rcache_put() - insert a row read from cn
+ *
+ * @rc:      row cache handle
+ * @kt:      key (with kt_hash set)
+ * @gen:     generation sampled by rcache_gen() before the lookup
+ * @view:    view sequence number of the lookup
+ * @seq:     seqno of the value
+ * @expire:  expiration time of the value (zero if it never expires)
+ * @val:     value
+ * @vlen:    value length
+ *
+ * The row is silently dropped if it may be stale, or if it is too large.
+ */
+void
+rcache_put(
+    struct rcache *rc,
+    const struct kvs_ktuple *kt,
+    uint64_t gen,
+    uint64_t view,
+    uint64_t seq,
+    uint64_t expire,
+    const void *val,
+    uint32_t vlen);
+
+/**
+ * rcache_invalidate() - drop the row of a key that has just been updated
+ *
+ * @rc: row cache handle
+ * @kt: key (with kt_hash set)
+ */
+void
+rcache_invalidate(struct rcache *rc, const struct kvs_ktuple *kt);
+
+/**
+ * rcache_purge() - drop all rows
+ *
+ * @rc: row cache handle
+ *
+ * Used by updates which may affect more than one key (e.g., prefix deletes).
+ */
+void
+rcache_purge(struct rcache *rc);
+
+/**
+ * rcache_seqno_set() - record the max seqno of data newly added to cn
+ *
+ * @rc:    row cache handle
+ * @seqno: max seqno of the ingested data
+ *
+ * Must be called before the data is released from c0.
+ */
+void
+rcache_seqno_set(struct rcache *rc, uint64_t seqno);
+
+#endif
@@ -0,0 +1,257 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <hse/util/arch.h>
+#include <hse/util/assert.h>
+#include <hse/util/atomic.h>
+#include <hse/util/event_counter.h>
+#include <hse/util/key_util.h>
+#include <hse/util/keycmp.h>
+#include <hse/util/minmax.h>
+
+#include "rtomb.h"
+
+uint64_t
+rtomb_seqno(const struct rtomb *rt)
+{
+    uint64_t seqno;
+
+    while (!(seqno = atomic_read_acq(&rt->rt_seqno)))
+        cpu_relax();
+
+    return seqno;
+}
+
+merr_t
+rtomb_create(
+    const void *start,
+    uint slen,
+    const void *end,
+    uint elen,
+    uint64_t seqno,
+    struct rtomb **out)
+{
+    struct rtomb *rt;
+
+    rt = malloc(sizeof(*rt) + slen + elen);
+    if (ev(!rt))
+        return merr(ENOMEM);
+
+    atomic_set(&rt->rt_seqno, seqno);
+    atomic_set(&rt->rt_ref, 1);
+    rt->rt_slen = slen;
+    rt->rt_elen = elen;
+    memcpy(rt->rt_keys, start, slen);
+    memcpy(rt->rt_keys + slen, end, elen);
+
+    *out = rt;
+
+    return 0;
+}
+
+void
+rtomb_put(struct rtomb *rt)
+{
+    if (rt && atomic_dec_return(&rt->rt_ref) == 0)
+        free(rt);
+}
+
+static int
+rtomb_start_cmp(const struct rtomb *rt1, const struct rtomb *rt2)
+{
+    return keycmp(rtomb_start(rt1), rt1->rt_slen, rtomb_start(rt2), rt2->rt_slen);
+}
+
+static int
+rtomb_end_cmp(const struct rtomb *rt1, const struct rtomb *rt2)
+{
+    return keycmp(rtomb_end(rt1), rt1->rt_elen, rtomb_end(rt2), rt2->rt_elen);
+}
+
+static struct rtomb_set *
+rtomb_set_alloc(uint cnt)
+{
+    struct rtomb_set *set;
+
+    set = malloc(sizeof(*set) + cnt * sizeof(set->rs_entv[0]));
+    if (ev(!set))
+        return NULL;
+
+    atomic_set(&set->rs_ref, 1);
+    set->rs_cnt = 0;
+
+    return set;
+}
+
+/* Append a tombstone to a set under construction, taking a reference on it.
+ */
+static void
+rtomb_set_append(struct rtomb_set *set, struct rtomb *rt)
+{
+    struct rtomb_ent *ent = set->rs_entv + set->rs_cnt;
+
+    atomic_inc(&rt->rt_ref);
+
+    ent->re_tomb = rt;
+    ent->re_maxend = rt;
+
+    if (set->rs_cnt > 0 && rtomb_end_cmp(ent[-1].re_maxend, rt) > 0)
+        ent->re_maxend = ent[-1].re_maxend;
+
+    set->rs_cnt++;
+}
+
+merr_t
+rtomb_set_insert(const struct rtomb_set *set, struct rtomb *rt, struct rtomb_set **out)
+{
+    struct rtomb_set *new;
+    uint cnt = set ? set->rs_cnt : 0;
+    uint i;
+
+    if (cnt >= RTOMB_SET_MAX)
+        return merr(ENOSPC);
+
+    new = rtomb_set_alloc(cnt + 1);
+    if (ev(!new))
+        return merr(ENOMEM);
+
+    for (i = 0; i < cnt && rtomb_start_cmp(set->rs_entv[i].re_tomb, rt) <= 0; i++)
+        rtomb_set_append(new, set->rs_entv[i].re_tomb);
+
+    rtomb_set_append(new, rt);
+
+    for (; i < cnt; i++)
+        rtomb_set_append(new, set->rs_entv[i].re_tomb);
+
+    *out = new;
+
+    return 0;
+}
+
+merr_t
+rtomb_set_remove(
+    const struct rtomb_set *set,
+    struct rtomb * const *rmv,
+    uint rmc,
+    struct rtomb_set **out)
+{
+    struct rtomb_set *new;
+    uint i, j;
+
+    assert(rmc <= set->rs_cnt);
+
+    *out = NULL;
+
+    if (rmc == set->rs_cnt)
+        return 0;
+
+    new = rtomb_set_alloc(set->rs_cnt - rmc);
+    if (ev(!new))
+        return merr(ENOMEM);
+
+    for (i = 0; i < set->rs_cnt; i++) {
+        struct rtomb *rt = set->rs_entv[i].re_tomb;
+
+        for (j = 0; j < rmc && rmv[j] != rt; j++)
+            ; /* do nothing */
+
+        if (j == rmc)
+            rtomb_set_append(new, rt);
+    }
+
+    assert(new->rs_cnt == set->rs_cnt - rmc);
+
+    *out = new;
+
+    return 0;
+}
+
+void
+rtomb_set_put(struct rtomb_set *set)
+{
+    uint i;
+
+    if (!set || atomic_dec_return(&set->rs_ref) > 0)
+        return;
+
+    for (i = 0; i < set->rs_cnt; i++)
+        rtomb_put(set->rs_entv[i].re_tomb);
+
+    free(set);
+}
+
+uint64_t
+rtomb_set_floor(const struct rtomb_set *set, const struct key_obj *kobj, uint64_t view)
+{
+    struct key_obj ko;
+    uint64_t floor = 0;
+    int lo, hi;
+
+    /* Find the last tombstone which starts at or before the key.
+     */
+    lo = 0;
+    hi = set->rs_cnt - 1;
+
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        const struct rtomb *rt = set->rs_entv[mid].re_tomb;
+
+        key2kobj(&ko, rtomb_start(rt), rt->rt_slen);
+
+        if (key_obj_cmp(&ko, kobj) <= 0)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+
+    /* Every tombstone at or before hi starts at or before the key, so it
+     * covers the key if it ends after it.  Stop once no earlier tombstone
+     * ends after the key.
+     */
+    for (; hi >= 0; hi--) {
+        const struct rtomb_ent *ent = set->rs_entv + hi;
+        const struct rtomb *rt = ent->re_maxend;
+        uint64_t seqno;
+
+        key2kobj(&ko, rtomb_end(rt), rt->rt_elen);
+        if (key_obj_cmp(&ko, kobj) <= 0)
+            break;
+
+        rt = ent->re_tomb;
+
+        key2kobj(&ko, rtomb_end(rt), rt->rt_elen);
+        if (key_obj_cmp(&ko, kobj) <= 0)
+            continue;
+
+        seqno = rtomb_seqno(rt);
+        if (seqno <= view)
+            floor = max_t(uint64_t, floor, seqno);
+    }
+
+    return floor;
+}
+
+bool
+rtomb_set_overlaps_pfx(const struct rtomb_set *set, const void *pfx, uint plen, uint64_t view)
+{
+    uint i;
+
+    for (i = 0; i < set->rs_cnt; i++) {
+        const struct rtomb *rt = set->rs_entv[i].re_tomb;
+
+        /* The remaining tombstones start after every key with this prefix.
+         */
+        if (memcmp(rtomb_start(rt), pfx, min_t(uint, rt->rt_slen, plen)) > 0)
+            break;
+
+        if (keycmp(rtomb_end(rt), rt->rt_elen, pfx, plen) > 0 && rtomb_seqno(rt) <= view)
+            return true;
+    }
+
+    return false;
+}
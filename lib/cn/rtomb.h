@@ -0,0 +1,173 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#ifndef HSE_CN_RTOMB_H
+#define HSE_CN_RTOMB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <hse/error/merr.h>
+#include <hse/util/atomic.h>
+
+/* A range tombstone deletes every version of every key in [start, end) whose
+ * seqno is less than the seqno of the tombstone.  Tombstones are not written
+ * to c0 or to kvsets.  Instead, each cn keeps the set of its outstanding
+ * tombstones in memory (and in the cndb), and point gets, cursors and
+ * compactions filter the values they encounter against it.
+ *
+ * A tombstone is published with a seqno of zero, and is given its seqno
+ * right after.  Readers whose view could include the tombstone must wait
+ * for its seqno, which is never more than a few instructions away.
+ *
+ * A tombstone set is immutable once published.  Adding or removing a
+ * tombstone creates a new set, which shares the tombstones of the old set.
+ */
+
+struct key_obj;
+
+/**
+ * struct rtomb - a range tombstone
+ * @rt_seqno: seqno of the tombstone (zero until assigned)
+ * @rt_ref:   reference count
+ * @rt_slen:  length of the start key
+ * @rt_elen:  length of the end key
+ * @rt_keys:  start key followed by end key
+ */
+struct rtomb {
+    atomic_ulong rt_seqno;
+    atomic_int rt_ref;
+    uint rt_slen;
+    uint rt_elen;
+    uint8_t rt_keys[];
+};
+
+/**
+ * struct rtomb_ent - a tombstone set entry
+ * @re_tomb:   tombstone
+ * @re_maxend: tombstone with the greatest end key of entries [0, this]
+ */
+struct rtomb_ent {
+    struct rtomb *re_tomb;
+    const struct rtomb *re_maxend;
+};
+
+/**
+ * struct rtomb_set - an immutable set of range tombstones
+ * @rs_ref:  reference count
+ * @rs_cnt:  number of entries
+ * @rs_entv: entries, sorted by start key
+ */
+struct rtomb_set {
+    atomic_int rs_ref;
+    uint rs_cnt;
+    struct rtomb_ent rs_entv[];
+};
+
+/* Max number of outstanding tombstones per cn.
+ */
+#define RTOMB_SET_MAX (1024)
+
+static inline const void *
+rtomb_start(const struct rtomb *rt)
+{
+    return rt->rt_keys;
+}
+
+static inline const void *
+rtomb_end(const struct rtomb *rt)
+{
+    return rt->rt_keys + rt->rt_slen;
+}
+
+/**
+ * rtomb_seqno() - get the seqno of a tombstone, waiting for it if need be
+ */
+uint64_t
+rtomb_seqno(const struct rtomb *rt);
+
+/**
+ * rtomb_create() - create a range tombstone
+ *
+ * @start: start key (inclusive)
+ * @slen:  start key length
+ * @end:   end key (exclusive)
+ * @elen:  end key length
+ * @seqno: seqno of the tombstone, or zero if it is to be set later
+ * @out:   tombstone with one reference (output)
+ */
+merr_t
+rtomb_create(
+    const void *start,
+    uint slen,
+    const void *end,
+    uint elen,
+    uint64_t seqno,
+    struct rtomb **out);
+
+/**
+ * rtomb_put() - drop a reference on a tombstone
+ */
+void
+rtomb_put(struct rtomb *rt);
+
+/**
+ * rtomb_set_insert() - create a set with one more tombstone
+ *
+ * @set: existing set (may be NULL)
+ * @rt:  tombstone to add
+ * @out: new set (output)
+ *
+ * Return: ENOSPC if @set already holds RTOMB_SET_MAX tombstones.
+ */
+merr_t
+rtomb_set_insert(const struct rtomb_set *set, struct rtomb *rt, struct rtomb_set **out);
+
+/**
+ * rtomb_set_remove() - create a set without the given tombstones
+ *
+ * @set:  existing set
+ * @rmv:  tombstones to remove
+ * @rmc:  number of tombstones in @rmv
+ * @out:  new set, or NULL if it would be empty (output)
+ */
+merr_t
+rtomb_set_remove(
+    const struct rtomb_set *set,
+    struct rtomb * const *rmv,
+    uint rmc,
+    struct rtomb_set **out);
+
+/**
+ * rtomb_set_put() - drop a reference on a set (may be NULL)
+ */
+void
+rtomb_set_put(struct rtomb_set *set);
+
+/**
+ * rtomb_set_floor() - get the seqno below which versions of a key are deleted
+ *
+ * @set:  tombstone set
+ * @kobj: key
+ * @view: view seqno of the reader
+ *
+ * Return: the greatest seqno not above @view of the tombstones covering
+ * @kobj, or zero if there is no such tombstone.
+ */
+uint64_t
+rtomb_set_floor(const struct rtomb_set *set, const struct key_obj *kobj, uint64_t view);
+
+/**
+ * rtomb_set_overlaps_pfx() - check if a tombstone in view covers part of a prefix
+ *
+ * @set:  tombstone set
+ * @pfx:  prefix
+ * @plen: prefix length
+ * @view: view seqno of the reader
+ */
+bool
+rtomb_set_overlaps_pfx(const struct rtomb_set *set, const void *pfx, uint plen, uint64_t view);
+
+#endif
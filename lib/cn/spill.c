@@ -87,6 +87,7 @@ get_direct_read_buf(uint len, bool aligned_voff, uint32_t *bufsz, void **buf)
 
 struct spillctx {
     struct cn_compaction_work *work;
+    struct cn_merge_stats *stats;
 
     uint64_t sgen;
 
@@ -102,8 +103,12 @@ struct spillctx {
     bool pt_set;
 };
 
-merr_t
-cn_spill_create(struct cn_compaction_work *w, struct spillctx **sctx_out)
+static merr_t
+spill_create(
+    struct cn_compaction_work *w,
+    struct kv_iterator **inputv,
+    struct cn_merge_stats *stats,
+    struct spillctx **sctx_out)
 {
     struct spillctx *s;
     size_t sz;
@@ -122,24 +127,18 @@ cn_spill_create(struct cn_compaction_work *w, struct spillctx **sctx_out)
     if (err)
         goto out;
 
-    for (uint i = 0; i < w->cw_kvset_cnt; i++) {
-        struct kv_iterator *iter = w->cw_inputv[i];
-
-        s->bh_sources[i] = kvset_iter_es_get(iter);
-    }
+    for (uint i = 0; i < w->cw_kvset_cnt; i++)
+        s->bh_sources[i] = kvset_iter_es_get(inputv[i]);
 
     err = bin_heap_prepare(s->bh, w->cw_kvset_cnt, s->bh_sources);
     if (err)
         goto out;
 
     s->work = w;
+    s->stats = stats;
     s->sgen = w->cw_sgen;
 
     s->more = bin_heap_peek(s->bh, (void **)&s->curr);
-    if (s->curr) {
-        w->cw_stats.ms_keys_in++;
-        w->cw_stats.ms_key_bytes_in += key_obj_len(&s->curr->kobj);
-    }
 
     *sctx_out = s;
 
@@ -152,6 +151,139 @@ out:
     return err;
 }
 
+merr_t
+cn_spill_create(struct cn_compaction_work *w, struct spillctx **sctx_out)
+{
+    struct spillctx *s;
+    merr_t err;
+
+    err = spill_create(w, w->cw_inputv, &w->cw_stats, &s);
+    if (err)
+        return err;
+
+    if (s->curr) {
+        w->cw_stats.ms_keys_in++;
+        w->cw_stats.ms_key_bytes_in += key_obj_len(&s->curr->kobj);
+    }
+
+    *sctx_out = s;
+
+    return 0;
+}
+
+/* Skip all keys up to and including skey.  A ptomb whose prefix matches skey
+ * would have been carried across skey by the preceding subspill, so its values
+ * are replayed here exactly as cn_subspill() would process them in order to
+ * rebuild that ptomb context.  Only the ptomb key itself (i.e., the first key
+ * with skey's prefix) can affect the context, all other keys are skipped.
+ */
+static merr_t
+spill_skip(struct spillctx *sctx, const void *skey, uint sklen, uint64_t pt_dgen)
+{
+    struct cn_compaction_work *w = sctx->work;
+    struct key_obj skobj, prev_kobj;
+    bool bg_val = false;
+    bool new_key = true;
+
+    key2kobj(&skobj, skey, sklen);
+
+    while (sctx->more && key_obj_cmp(&sctx->curr->kobj, &skobj) <= 0) {
+        struct kv_iterator *iter = kvset_cursor_es_h2r(sctx->curr->src);
+        bool ptkey;
+
+        if (new_key) {
+            bg_val = false;
+
+            if (sctx->pt_set && key_obj_cmp_prefix(&sctx->pt_kobj, &sctx->curr->kobj) != 0)
+                sctx->pt_set = false;
+        }
+
+        ptkey = w->cw_pfx_len && key_obj_len(&sctx->curr->kobj) == w->cw_pfx_len &&
+            key_obj_cmp_prefix(&sctx->curr->kobj, &skobj) == 0;
+
+        while (ptkey && !bg_val) {
+            const void *vdata = NULL;
+            enum kmd_vtype vtype;
+            uint vbidx, vboff, vlen, complen;
+            uint64_t seq;
+
+            if (!kvset_iter_next_vref(
+                    iter, &sctx->curr->vctx, &seq, &vtype, &vbidx, &vboff, &vdata, &vlen, &complen))
+                break;
+
+            if (sctx->curr->vctx.dgen <= pt_dgen)
+                break;
+
+            bg_val = (seq <= w->cw_horizon);
+
+            if (bg_val && sctx->pt_set && w->cw_horizon >= sctx->pt_seq && sctx->pt_seq > seq)
+                break;
+
+            if (vtype == VTYPE_PTOMB) {
+                sctx->pt_set = true;
+                sctx->pt_kobj = sctx->curr->kobj;
+                sctx->pt_seq = seq;
+            }
+        }
+
+        prev_kobj = sctx->curr->kobj;
+
+        bin_heap_pop(sctx->bh, NULL);
+        sctx->more = bin_heap_peek(sctx->bh, (void **)&sctx->curr);
+
+        new_key = !sctx->more || key_obj_cmp(&sctx->curr->kobj, &prev_kobj) != 0;
+
+        if (atomic_read(w->cw_cancel_request))
+            return merr(ESHUTDOWN);
+    }
+
+    if (sctx->pt_set && key_obj_cmp_prefix(&sctx->pt_kobj, &skobj) != 0)
+        sctx->pt_set = false;
+
+    return 0;
+}
+
+merr_t
+cn_spill_create_part(
+    struct cn_compaction_work *w,
+    struct kv_iterator **inputv,
+    struct cn_merge_stats *stats,
+    const void *skey,
+    uint sklen,
+    uint64_t pt_dgen,
+    struct spillctx **sctx_out)
+{
+    struct spillctx *s;
+    uint seeklen;
+    merr_t err;
+
+    /* Seek to skey's prefix so that a ptomb which spans skey is not missed.
+     */
+    seeklen = (w->cw_pfx_len && sklen > w->cw_pfx_len) ? w->cw_pfx_len : sklen;
+
+    for (uint i = 0; i < w->cw_kvset_cnt; i++) {
+        bool eof;
+
+        err = kvset_iter_seek(inputv[i], skey, seeklen, &eof);
+        if (err)
+            return err;
+    }
+
+    err = spill_create(w, inputv, stats, &s);
+    if (err)
+        return err;
+
+    err = spill_skip(s, skey, sklen, pt_dgen);
+    if (err) {
+        cn_spill_destroy(s);
+        return err;
+    }
+
+    *sctx_out = s;
+
+    return 0;
+}
+
 void
 cn_spill_destroy(struct spillctx *sctx)
 {
@@ -184,6 +316,7 @@ cn_subspill_get_kvset_meta(struct subspill *ss, struct kvset_meta *km)
 
     km->km_compc = 0;
     km->km_nodeid = ss->ss_node->tn_nodeid;
+    km->km_rtomb_seqno = w->cw_horizon;
 }
 
 merr_t
@@ -208,6 +341,7 @@ cn_subspill(
 
     uint64_t seq, emitted_seq = 0, emitted_seq_pt = 0;
     bool emitted_val = false, bg_val = false;
+    uint64_t rt_seq = 0;
 
     uint64_t tstart, tprog = 0;
     uint64_t dbg_prev_seq = 0;
@@ -227,7 +361,10 @@ cn_subspill(
 
     ss->ss_sgen = w->cw_sgen;
 
-    if (w->cw_prog_interval && w->cw_progress)
+    /* Only the spill thread itself reports progress, the merge stats of
+     * concurrently built partitions are folded in after they complete.
+     */
+    if (w->cw_prog_interval && w->cw_progress && sctx->stats == &w->cw_stats)
         tprog = jiffies;
 
     /* We must issue a direct read for all values that will not fit into the vblock readahead
@@ -250,7 +387,9 @@ cn_subspill(
     if (!sctx->pt_set && key_obj_cmp(&sctx->curr->kobj, &ekobj) > 0)
         return 0;
 
-    w->cw_kvsetidv[0] = ss->ss_kvsetid = cndb_kvsetid_mint(cn_tree_get_cndb(w->cw_tree));
+    ss->ss_kvsetid = cndb_kvsetid_mint(cn_tree_get_cndb(w->cw_tree));
+    if (sctx->stats == &w->cw_stats)
+        w->cw_kvsetidv[0] = ss->ss_kvsetid;
 
     err = kvset_builder_create(&child, cn_tree_get_cn(w->cw_tree), w->cw_pc, ss->ss_kvsetid);
     if (err)
@@ -258,9 +397,9 @@ cn_subspill(
 
     assert(child);
 
-    kvset_builder_set_merge_stats(child, &w->cw_stats);
+    kvset_builder_set_merge_stats(child, sctx->stats);
 
-    err = kvset_builder_set_agegroup(child, HSE_MPOLICY_AGE_LEAF);
+    err = kvset_builder_set_agegroup(child, cn_tree_node_agegroup(node));
     if (err) {
         kvset_builder_destroy(child);
         return err;
@@ -270,7 +409,8 @@ cn_subspill(
      * previous node spill, i.e., this ptomb spans across multiple children.
      */
     if (sctx->pt_set && (!w->cw_drop_tombs || sctx->pt_seq > w->cw_horizon)) {
-        err = kvset_builder_add_val(child, &sctx->pt_kobj, HSE_CORE_TOMB_PFX, 0, sctx->pt_seq, 0);
+        err = kvset_builder_add_val(
+            child, &sctx->pt_kobj, HSE_CORE_TOMB_PFX, 0, sctx->pt_seq, 0, 0, 0);
         if (!err)
             err = kvset_builder_add_key(child, &sctx->pt_kobj);
 
@@ -279,8 +419,8 @@ cn_subspill(
             return err;
         }
 
-        w->cw_stats.ms_keys_out++;
-        w->cw_stats.ms_key_bytes_out += key_obj_len(&sctx->pt_kobj);
+        sctx->stats->ms_keys_out++;
+        sctx->stats->ms_key_bytes_out += key_obj_len(&sctx->pt_kobj);
 
         ss->ss_added = true;
         if (key_obj_cmp_prefix(&sctx->pt_kobj, &ekobj) < 0)
@@ -303,6 +443,8 @@ cn_subspill(
             emitted_seq = 0;
             emitted_seq_pt = 0;
 
+            rt_seq = cn_rtomb_floor(w->cw_rtombs, &sctx->curr->kobj, w->cw_horizon);
+
             dbg_prev_seq = 0;
             dbg_prev_idx = 0;
             dbg_nvals_this_key = 0;
@@ -327,7 +469,8 @@ cn_subspill(
                     iter, &sctx->curr->vctx, &seq, &vtype, &vbidx, &vboff, &vdata, &vlen, &complen))
                 break;
 
-            omlen = (vtype == VTYPE_UCVAL) ? vlen : ((vtype == VTYPE_CVAL) ? complen : 0);
+            omlen = (vtype == VTYPE_UCVAL) ? vlen
+                : ((vtype == VTYPE_CVAL || vtype == VTYPE_ZCVAL) ? complen : 0);
 
             direct = omlen > direct_read_len;
             if (direct) {
@@ -368,6 +511,9 @@ cn_subspill(
             if (bg_val && sctx->pt_set && w->cw_horizon >= sctx->pt_seq && sctx->pt_seq > seq)
                 break; /* drop val if it and pt are beyond horizon */
 
+            if (bg_val && rt_seq > seq && !HSE_CORE_IS_PTOMB(vdata))
+                break; /* drop val deleted by a range tombstone beyond horizon */
+
             /* Set ptomb context irrespective of bg_val for tombstone propagation */
             if (HSE_CORE_IS_PTOMB(vdata)) {
                 sctx->pt_set = true;
@@ -389,11 +535,13 @@ cn_subspill(
                 if (w->cw_drop_tombs && HSE_CORE_IS_TOMB(vdata) && bg_val)
                     continue; /* skip value */
 
-                err = kvset_builder_add_val(child, &sctx->curr->kobj, vdata, vlen, seq, complen);
+                err = kvset_builder_add_val(
+                    child, &sctx->curr->kobj, vdata, vlen, seq, sctx->curr->vctx.expire, complen,
+                    vtype_to_calgo(vtype));
                 if (err)
                     break;
 
-                w->cw_stats.ms_val_bytes_out += complen ? complen : vlen;
+                sctx->stats->ms_val_bytes_out += complen ? complen : vlen;
                 emitted_val = true;
                 if (HSE_CORE_IS_PTOMB(vdata))
                     emitted_seq_pt = seq;
@@ -436,8 +584,8 @@ cn_subspill(
         sctx->more = bin_heap_peek(bh, (void **)&sctx->curr);
 
         if (sctx->curr) {
-            w->cw_stats.ms_keys_in++;
-            w->cw_stats.ms_key_bytes_in += key_obj_len(&sctx->curr->kobj);
+            sctx->stats->ms_keys_in++;
+            sctx->stats->ms_key_bytes_in += key_obj_len(&sctx->curr->kobj);
         }
 
         if (sctx->more) {
@@ -455,8 +603,8 @@ cn_subspill(
                 goto out;
 
             ss->ss_added = true;
-            w->cw_stats.ms_keys_out++;
-            w->cw_stats.ms_key_bytes_out += key_obj_len(&prev_kobj);
+            sctx->stats->ms_keys_out++;
+            sctx->stats->ms_key_bytes_out += key_obj_len(&prev_kobj);
         }
 
         new_key = true;
@@ -15,7 +15,9 @@
 #include "route.h"
 
 struct cn_compaction_work;
+struct cn_merge_stats;
 struct cn_tree_node;
+struct kv_iterator;
 struct kvset_meta;
 struct spillctx;
 
@@ -79,6 +81,32 @@ cn_subspill(
 merr_t
 cn_spill_create(struct cn_compaction_work *w, struct spillctx **sctx_out);
 
+/**
+ * cn_spill_create_part() - Create a spill context for a key range partition
+ *
+ * @w:       compaction work
+ * @inputv:  private mmap iterators over the input kvsets (same order as cw_inputv)
+ * @stats:   merge stats for this partition
+ * @skey:    edge key of the node that precedes this partition
+ * @sklen:   length of @skey
+ * @pt_dgen: dgen of the newest kvset in the node that @skey's prefix maps to
+ *
+ * The iterators are positioned past @skey, and a ptomb spanning @skey is
+ * carried into the context just as the subspill into the preceding node
+ * would have carried it, so that cn_subspill() may then be called on the
+ * nodes of the partition as if the spill had walked all preceding nodes.
+ */
+/* MTF_MOCK */
+merr_t
+cn_spill_create_part(
+    struct cn_compaction_work *w,
+    struct kv_iterator **inputv,
+    struct cn_merge_stats *stats,
+    const void *skey,
+    uint sklen,
+    uint64_t pt_dgen,
+    struct spillctx **sctx_out);
+
 /* MTF_MOCK */
 void
 cn_spill_destroy(struct spillctx *ctx);
@@ -0,0 +1,314 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <hse/kvdb_perfc.h>
+#include <hse/util/assert.h>
+#include <hse/util/compiler.h>
+#include <hse/util/event_counter.h>
+#include <hse/util/hash.h>
+#include <hse/util/log2.h>
+#include <hse/util/minmax.h>
+#include <hse/util/mutex.h>
+#include <hse/util/page.h>
+#include <hse/util/perfc.h>
+
+#include "vbcache.h"
+
+/* clang-format off */
+
+#define VBCACHE_SHARDS_MAX     (64)
+#define VBCACHE_SHARD_PGMIN    (256)
+#define VBCACHE_REF_MAX        (3)
+#define VBCACHE_NIL            (UINT32_MAX)
+
+static struct perfc_name vbcache_perfc[] _dt_section = {
+    NE(PERFC_RA_VBCACHE_HIT,    2, "Vblock cache hit rate",      "r_hit(/s)"),
+    NE(PERFC_RA_VBCACHE_MISS,   2, "Vblock cache miss rate",     "r_miss(/s)"),
+    NE(PERFC_RA_VBCACHE_INSERT, 3, "Vblock cache insert rate",   "r_insert(/s)"),
+    NE(PERFC_RA_VBCACHE_EVICT,  3, "Vblock cache evict rate",    "r_evict(/s)"),
+};
+
+NE_CHECK(vbcache_perfc, PERFC_EN_VBCACHE, "vbcache_perfc table/enum mismatch");
+
+/* clang-format on */
+
+/**
+ * struct vbcache_frame - per-page metadata
+ *
+ * @bf_mbid:  mblock ID of the cached page
+ * @bf_pgno:  page number within the mblock
+ * @bf_next:  index of next frame in the hash chain
+ * @bf_ref:   clock reference count
+ * @bf_valid: frame holds a cached page
+ */
+struct vbcache_frame {
+    uint64_t bf_mbid;
+    uint32_t bf_pgno;
+    uint32_t bf_next;
+    uint8_t  bf_ref;
+    bool     bf_valid;
+};
+
+/**
+ * struct vbcache_shard - independently locked partition of the cache
+ *
+ * @bs_lock:    protects all fields of the shard
+ * @bs_hand:    clock hand
+ * @bs_nframes: number of page frames
+ * @bs_bktmask: hash bucket mask
+ * @bs_bktv:    hash bucket heads (frame indices)
+ * @bs_framev:  page frame metadata
+ * @bs_data:    page frame data
+ */
+struct vbcache_shard {
+    struct mutex           bs_lock HSE_L1D_ALIGNED;
+    uint32_t               bs_hand;
+    uint32_t               bs_nframes;
+    uint32_t               bs_bktmask;
+    uint32_t              *bs_bktv;
+    struct vbcache_frame *bs_framev;
+    char                  *bs_data;
+};
+
+struct vbcache {
+    uint32_t              bc_nshards;
+    struct perfc_set      bc_pc;
+    struct vbcache_shard bc_shardv[];
+};
+
+static HSE_ALWAYS_INLINE uint64_t
+vbcache_hash(uint64_t mbid, uint32_t pgno)
+{
+    return hse_hash64_seed(&pgno, sizeof(pgno), mbid);
+}
+
+static uint32_t *
+vbcache_chain(struct vbcache_shard *bs, uint64_t hash)
+{
+    return bs->bs_bktv + ((hash >> 32) & bs->bs_bktmask);
+}
+
+static struct vbcache_frame *
+vbcache_find(struct vbcache_shard *bs, uint64_t hash, uint64_t mbid, uint32_t pgno)
+{
+    uint32_t idx = *vbcache_chain(bs, hash);
+
+    while (idx != VBCACHE_NIL) {
+        struct vbcache_frame *bf = bs->bs_framev + idx;
+
+        if (bf->bf_mbid == mbid && bf->bf_pgno == pgno)
+            return bf;
+
+        idx = bf->bf_next;
+    }
+
+    return NULL;
+}
+
+static void
+vbcache_unlink(struct vbcache_shard *bs, uint32_t victim)
+{
+    struct vbcache_frame *bf = bs->bs_framev + victim;
+    uint32_t *idxp;
+
+    idxp = vbcache_chain(bs, vbcache_hash(bf->bf_mbid, bf->bf_pgno));
+
+    while (*idxp != victim) {
+        assert(*idxp != VBCACHE_NIL);
+        idxp = &bs->bs_framev[*idxp].bf_next;
+    }
+
+    *idxp = bf->bf_next;
+    bf->bf_valid = false;
+}
+
+/* Advance the clock hand until it finds a free frame or one whose reference
+ * count has dropped to zero.  Since every pass decrements the reference count
+ * of each frame it skips, this terminates within VBCACHE_REF_MAX + 1 passes.
+ */
+static uint32_t
+vbcache_evict(struct vbcache *bc, struct vbcache_shard *bs)
+{
+    while (1) {
+        uint32_t idx = bs->bs_hand;
+        struct vbcache_frame *bf = bs->bs_framev + idx;
+
+        if (++bs->bs_hand >= bs->bs_nframes)
+            bs->bs_hand = 0;
+
+        if (!bf->bf_valid)
+            return idx;
+
+        if (bf->bf_ref > 0) {
+            bf->bf_ref--;
+            continue;
+        }
+
+        vbcache_unlink(bs, idx);
+        perfc_inc(&bc->bc_pc, PERFC_RA_VBCACHE_EVICT);
+
+        return idx;
+    }
+}
+
+bool
+vbcache_get(struct vbcache *bc, uint64_t mbid, size_t off, void *buf, size_t len)
+{
+    uint32_t pgno = off / PAGE_SIZE;
+
+    assert(IS_ALIGNED(off, PAGE_SIZE) && IS_ALIGNED(len, PAGE_SIZE));
+
+    for (; len > 0; len -= PAGE_SIZE, buf += PAGE_SIZE, pgno++) {
+        uint64_t hash = vbcache_hash(mbid, pgno);
+        struct vbcache_shard *bs = bc->bc_shardv + (hash % bc->bc_nshards);
+        struct vbcache_frame *bf;
+
+        mutex_lock(&bs->bs_lock);
+        bf = vbcache_find(bs, hash, mbid, pgno);
+        if (!bf) {
+            mutex_unlock(&bs->bs_lock);
+            perfc_inc(&bc->bc_pc, PERFC_RA_VBCACHE_MISS);
+            return false;
+        }
+
+        if (bf->bf_ref < VBCACHE_REF_MAX)
+            bf->bf_ref++;
+
+        memcpy(buf, bs->bs_data + (size_t)(bf - bs->bs_framev) * PAGE_SIZE, PAGE_SIZE);
+        mutex_unlock(&bs->bs_lock);
+    }
+
+    perfc_inc(&bc->bc_pc, PERFC_RA_VBCACHE_HIT);
+
+    return true;
+}
+
+void
+vbcache_put(
+    struct vbcache *bc,
+    uint64_t mbid,
+    size_t off,
+    const void *buf,
+    size_t len)
+{
+    uint32_t pgno = off / PAGE_SIZE;
+
+    assert(IS_ALIGNED(off, PAGE_SIZE) && IS_ALIGNED(len, PAGE_SIZE));
+
+    for (; len > 0; len -= PAGE_SIZE, buf += PAGE_SIZE, pgno++) {
+        uint64_t hash = vbcache_hash(mbid, pgno);
+        struct vbcache_shard *bs = bc->bc_shardv + (hash % bc->bc_nshards);
+        struct vbcache_frame *bf;
+        uint32_t *headp;
+        uint32_t idx;
+
+        mutex_lock(&bs->bs_lock);
+        if (vbcache_find(bs, hash, mbid, pgno)) {
+            mutex_unlock(&bs->bs_lock);
+            continue;
+        }
+
+        idx = vbcache_evict(bc, bs);
+        bf = bs->bs_framev + idx;
+
+        headp = vbcache_chain(bs, hash);
+        bf->bf_mbid = mbid;
+        bf->bf_pgno = pgno;
+        bf->bf_ref = 1;
+        bf->bf_valid = true;
+        bf->bf_next = *headp;
+        *headp = idx;
+
+        memcpy(bs->bs_data + (size_t)idx * PAGE_SIZE, buf, PAGE_SIZE);
+        mutex_unlock(&bs->bs_lock);
+
+        perfc_inc(&bc->bc_pc, PERFC_RA_VBCACHE_INSERT);
+    }
+}
+
+void
+vbcache_perfc_alloc(struct vbcache *bc, const char *group, uint prio)
+{
+    perfc_alloc(vbcache_perfc, group, "vbcache", prio, &bc->bc_pc);
+}
+
+merr_t
+vbcache_create(size_t size, struct vbcache **out)
+{
+    struct vbcache *bc;
+    size_t npages, sz;
+    uint32_t nshards, i;
+
+    if (ev(!out))
+        return merr(EINVAL);
+
+    npages = size / PAGE_SIZE;
+    if (ev(npages < VBCACHE_SHARD_PGMIN || npages / VBCACHE_SHARDS_MAX > INT32_MAX))
+        return merr(EINVAL);
+
+    nshards = clamp_t(size_t, npages / VBCACHE_SHARD_PGMIN, 1, VBCACHE_SHARDS_MAX);
+
+    sz = sizeof(*bc) + sizeof(bc->bc_shardv[0]) * nshards;
+
+    bc = aligned_alloc(__alignof__(*bc), ALIGN(sz, __alignof__(*bc)));
+    if (ev(!bc))
+        return merr(ENOMEM);
+
+    memset(bc, 0, sz);
+    bc->bc_nshards = nshards;
+
+    for (i = 0; i < nshards; i++) {
+        struct vbcache_shard *bs = bc->bc_shardv + i;
+        uint32_t nbkts;
+
+        bs->bs_nframes = npages / nshards;
+
+        nbkts = roundup_pow_of_two(bs->bs_nframes);
+        bs->bs_bktmask = nbkts - 1;
+
+        bs->bs_bktv = malloc(sizeof(*bs->bs_bktv) * nbkts);
+        bs->bs_framev = calloc(bs->bs_nframes, sizeof(*bs->bs_framev));
+        bs->bs_data = aligned_alloc(PAGE_SIZE, (size_t)bs->bs_nframes * PAGE_SIZE);
+
+        mutex_init(&bs->bs_lock);
+
+        if (ev(!bs->bs_bktv || !bs->bs_framev || !bs->bs_data)) {
+            bc->bc_nshards = i + 1;
+            vbcache_destroy(bc);
+            return merr(ENOMEM);
+        }
+
+        memset(bs->bs_bktv, 0xff, sizeof(*bs->bs_bktv) * nbkts);
+    }
+
+    *out = bc;
+
+    return 0;
+}
+
+void
+vbcache_destroy(struct vbcache *bc)
+{
+    uint32_t i;
+
+    if (!bc)
+        return;
+
+    perfc_free(&bc->bc_pc);
+
+    for (i = 0; i < bc->bc_nshards; i++) {
+        struct vbcache_shard *bs = bc->bc_shardv + i;
+
+        mutex_destroy(&bs->bs_lock);
+        free(bs->bs_data);
+        free(bs->bs_framev);
+        free(bs->bs_bktv);
+    }
+
+    free(bc);
+}
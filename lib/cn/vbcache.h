@@ -0,0 +1,95 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#ifndef HSE_CN_VBCACHE_H
+#define HSE_CN_VBCACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <hse/error/merr.h>
+
+/* The vblock cache holds page sized copies of vblock data read via
+ * direct I/O so that repeated lookups of the same pages are served from
+ * memory rather than from the device or the page cache.  Pages are keyed by
+ * (mblock ID, page number) and spread over a number of independently locked
+ * shards.  Each shard is managed by a generalized CLOCK policy in which a
+ * page's reference count is bumped on every hit and decremented each time
+ * the clock hand sweeps over it.
+ *
+ * Since mblocks are immutable once committed, cached pages never need to be
+ * updated.  Pages of deleted mblocks simply age out.
+ *
+ * Only vblock pages are cached.  Kblock (wbtree, bloom and kmd) pages are
+ * accessed through their mcache mappings: the kblock readers hand out
+ * pointers into those pages (e.g., inline values in kmd, the min/max keys
+ * in struct kvset_kblk, cursor nodes) which must outlive a single probe,
+ * whereas this cache only ever copies pages out under the shard lock.
+ */
+
+struct vbcache;
+
+/**
+ * vbcache_create() - create a vblock cache
+ *
+ * @size: cache size in bytes (rounded down to a multiple of PAGE_SIZE)
+ * @out:  vblock cache handle (output)
+ */
+merr_t
+vbcache_create(size_t size, struct vbcache **out);
+
+/**
+ * vbcache_destroy() - destroy a vblock cache
+ *
+ * @bc: vblock cache handle (may be NULL)
+ */
+void
+vbcache_destroy(struct vbcache *bc);
+
+/**
+ * vbcache_perfc_alloc() - allocate the vblock cache performance counters
+ *
+ * @bc:    vblock cache handle
+ * @group: perfc group name
+ * @prio:  perfc level
+ */
+void
+vbcache_perfc_alloc(struct vbcache *bc, const char *group, uint prio);
+
+/**
+ * vbcache_get() - copy a range of cached pages into a buffer
+ *
+ * @bc:   vblock cache handle
+ * @mbid: mblock ID
+ * @off:  page aligned offset into the mblock
+ * @buf:  output buffer
+ * @len:  page aligned length of the range
+ *
+ * Return: true if every page of the range was present in the cache and has
+ * been copied into %buf, false otherwise (in which case the contents of %buf
+ * are undefined).
+ */
+bool
+vbcache_get(struct vbcache *bc, uint64_t mbid, size_t off, void *buf, size_t len);
+
+/**
+ * vbcache_put() - insert a range of pages into the cache
+ *
+ * @bc:   vblock cache handle
+ * @mbid: mblock ID
+ * @off:  page aligned offset into the mblock
+ * @buf:  page data just read from the mblock
+ * @len:  page aligned length of the range
+ */
+void
+vbcache_put(
+    struct vbcache *bc,
+    uint64_t mbid,
+    size_t off,
+    const void *buf,
+    size_t len);
+
+#endif
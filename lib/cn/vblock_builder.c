@@ -28,11 +28,13 @@
 #include <hse/util/perfc.h>
 #include <hse/util/slab.h>
 #include <hse/util/vlb.h>
+#include <hse/util/workqueue.h>
 
 #include "blk_list.h"
 #include "cn_mblocks.h"
 #include "cn_metrics.h"
 #include "cn_perfc.h"
+#include "mbio.h"
 #include "omf.h"
 #include "vblock_builder.h"
 
@@ -53,6 +55,12 @@
  * @mblocksz:  mblock size of specified media class
  * @cur_minklen: min key length
  * @cur_minkey:  a copy of the min key referencing this vblock
+ * @wr_wq:     workqueue for asynchronous writes (NULL for synchronous writes)
+ * @wr_buf:    write buffer of the write in flight
+ * @wr_blkid:  mblock ID of the write in flight
+ * @wr_len:    length of the write in flight
+ * @wr_work:   work struct for asynchronous writes
+ * @wr_mbio:   completion state of the write in flight
  *
  * WBUF_LEN_MAX is the allocated size of the write buffer.  Each mblock write
  * will be at most WBUF_LEN_MAX bytes.  Member @wbuf_len is the actual write
@@ -84,6 +92,14 @@
  *       -- write @wbuf_len bytes to mblock
  *       -- set @wbuf_off to 0
  *       -- set @vblk_off += @wbuff_off
+ *
+ * If @wr_wq is set the builder owns a second write buffer.  A full buffer is
+ * handed off to @wr_wq and the builder continues to fill the other buffer
+ * while the write is in flight, so that copying values into the builder and
+ * writing them to media overlap.  There is at most one write in flight, and
+ * it must complete before the next write is issued, so writes to an mblock
+ * remain sequential.  An error from an asynchronous write is reported by the
+ * builder operation that next waits on it.
  */
 struct vblock_builder {
     struct mpool *mp;
@@ -104,6 +120,13 @@ struct vblock_builder {
     bool destruct;
     uint32_t cur_minklen;
     char cur_minkey[HSE_KVS_KEY_LEN_MAX];
+
+    struct workqueue_struct *wr_wq;
+    void *wr_buf;
+    uint64_t wr_blkid;
+    unsigned int wr_len;
+    struct work_struct wr_work;
+    struct async_mbio wr_mbio;
 };
 
 static inline bool
@@ -176,6 +199,51 @@ vblock_start(struct vblock_builder *bld, const struct key_obj *min_kobj)
     return 0;
 }
 
+static void
+vblock_write_cb(struct work_struct *work)
+{
+    struct vblock_builder *bld = container_of(work, struct vblock_builder, wr_work);
+    struct cn_merge_stats *stats = bld->mstats;
+    struct iovec iov;
+    uint64_t tstart;
+    merr_t err;
+
+    iov.iov_base = bld->wr_buf;
+    iov.iov_len = bld->wr_len;
+
+    tstart = get_time_ns();
+
+    err = mpool_mblock_write(bld->mp, bld->wr_blkid, &iov, 1);
+
+    if (stats)
+        count_ops(&stats->ms_vblk_write, 1, iov.iov_len, get_time_ns() - tstart);
+
+    if (!ev(err)) {
+        perfc_inc(bld->pc, PERFC_RA_CNCOMP_WREQS);
+        perfc_add(bld->pc, PERFC_RA_CNCOMP_WBYTES, iov.iov_len);
+    }
+
+    mbio_signal(&bld->wr_mbio, err);
+}
+
+/* Wait for the write in flight (if any) to complete.
+ */
+static merr_t
+vblock_write_wait(struct vblock_builder *bld)
+{
+    struct cn_merge_stats *stats = bld->mstats;
+    merr_t err;
+
+    if (!bld->wr_wq)
+        return 0;
+
+    err = mbio_wait(&bld->wr_mbio, stats ? &stats->ms_vblk_write_wait : NULL);
+    if (ev(err))
+        bld->destruct = true;
+
+    return err;
+}
+
 static merr_t
 vblock_write(struct vblock_builder *bld)
 {
@@ -183,9 +251,28 @@ vblock_write(struct vblock_builder *bld)
     struct iovec iov;
     struct cn_merge_stats *stats = bld->mstats;
     uint64_t tstart;
+    void *wbuf;
 
     assert(bld->blkid);
 
+    if (bld->wr_wq) {
+        err = vblock_write_wait(bld);
+        if (err)
+            return err;
+
+        wbuf = bld->wr_buf;
+        bld->wr_buf = bld->wbuf;
+        bld->wr_blkid = bld->blkid;
+        bld->wr_len = bld->wbuf_len;
+        bld->wbuf = wbuf;
+        bld->wbuf_off = 0;
+
+        mbio_arm(&bld->wr_mbio);
+        queue_work(bld->wr_wq, &bld->wr_work);
+
+        return 0;
+    }
+
     iov.iov_base = bld->wbuf;
     iov.iov_len = bld->wbuf_len;
 
@@ -303,6 +390,20 @@ vbb_create(
 
     bld->max_size = props.mc_mblocksz;
 
+    if (cn_get_rp(cn)->cn_async_write)
+        bld->wr_wq = cn_get_wr_wq(cn);
+
+    if (bld->wr_wq) {
+        bld->wr_buf = vlb_alloc(WBUF_LEN_MAX);
+        if (ev(!bld->wr_buf)) {
+            vlb_free(wbuf, WBUF_LEN_MAX + sizeof(*bld));
+            return merr(ENOMEM);
+        }
+
+        INIT_WORK(&bld->wr_work, vblock_write_cb);
+        mbio_init(&bld->wr_mbio, "vbbwrite");
+    }
+
     *builder_out = bld;
 
     return 0;
@@ -312,13 +413,26 @@ vbb_create(
 void
 vbb_destroy(struct vblock_builder *bld)
 {
+    void *wbuf;
+
     if (ev(!bld))
         return;
 
+    /* The builder is embedded in the buffer allocated by vbb_create(), which
+     * may have been swapped with the asynchronous write buffer.
+     */
+    wbuf = (void *)bld - WBUF_LEN_MAX;
+
+    if (bld->wr_wq) {
+        vblock_write_wait(bld);
+        mbio_fini(&bld->wr_mbio);
+        vlb_free(bld->wbuf == wbuf ? bld->wr_buf : bld->wbuf, WBUF_LEN_MAX);
+    }
+
     delete_mblocks(bld->mp, &bld->vblk_list);
     blk_list_free(&bld->vblk_list);
 
-    vlb_free(bld->wbuf, WBUF_LEN_MAX + sizeof(*bld));
+    vlb_free(wbuf, WBUF_LEN_MAX + sizeof(*bld));
 }
 
 /* Add a value to vblock.  Create new vblock if needed. */
@@ -410,6 +524,10 @@ vbb_finish(struct vblock_builder *bld, struct blk_list *vblks, const struct key_
     if (ev(err))
         return err;
 
+    err = vblock_write_wait(bld);
+    if (err)
+        return err;
+
     /* Transfer ownership of blk_list and the mblocks in
      * the blk_list to caller  */
     *vblks = bld->vblk_list;
@@ -3,9 +3,41 @@
  * SPDX-FileCopyrightText: Copyright 2020 Micron Technology, Inc.
  */
 
+#include "build_config.h"
+
 #include <hse/ikvdb/vcomp_params.h>
+#include <hse/util/compiler.h>
 #include <hse/util/compression_lz4.h>
+#include <hse/util/event_counter.h>
+
+#ifdef HAVE_ZSTD
+#include <hse/util/compression_zstd.h>
+#endif
 
 const struct compress_ops *vcomp_compress_ops[VCOMP_ALGO_COUNT] = {
-    &compress_lz4_ops,
+    [VCOMP_ALGO_LZ4] = &compress_lz4_ops,
+#ifdef HAVE_ZSTD
+    [VCOMP_ALGO_ZSTD] = &compress_zstd_ops,
+#endif
 };
+
+merr_t
+vcomp_decompress(
+    enum vcomp_algorithm algo,
+    const void *src,
+    uint src_len,
+    void *dst,
+    uint dst_capacity,
+    uint *dst_len)
+{
+    const struct compress_ops *cops;
+
+    if (HSE_LIKELY(algo == VCOMP_ALGO_LZ4))
+        return compress_lz4_ops.cop_decompress(src, src_len, dst, dst_capacity, dst_len);
+
+    cops = algo < VCOMP_ALGO_COUNT ? vcomp_compress_ops[algo] : NULL;
+    if (ev(!cops))
+        return merr(ENOTSUP);
+
+    return cops->cop_decompress(src, src_len, dst, dst_capacity, dst_len);
+}
@@ -7,11 +7,16 @@
 
 #include <hse/limits.h>
 
+#include <hse/ikvdb/encoders.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/omf_kmd.h>
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/util/alloc.h>
+#include <hse/util/arch.h>
+#include <hse/util/compression.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/key_util.h>
+#include <hse/util/minmax.h>
 #include <hse/util/page.h>
 #include <hse/util/platform.h>
 #include <hse/util/slab.h>
@@ -27,6 +32,18 @@
 #define KMD_CHUNK_LEN   (KMD_CHUNK_PAGES * PAGE_SIZE)
 #define KMD_CHUNKS      (KBLOCK_MAX_SIZE / KMD_CHUNK_LEN)
 
+/* An LFC node's open restart group is closed (and compressed) once its
+ * entries reach WBT_LFC_GRP_SIZE bytes.  The largest group is then less
+ * than WBT_LFC_GRP_SIZE plus one maximal entry, which must fit the raw
+ * group buffer.
+ */
+#define WBT_LFC_TMP_SIZE (2 * PAGE_SIZE)
+
+static_assert(
+    WBT_LFC_GRP_SIZE + WBT_LFC_ENT_HDR_MAX + HSE_KVS_KEY_LEN_MAX <= WBT_LFC_RAW_SIZE,
+    "WBT_LFC_RAW_SIZE too small");
+static_assert(WBT_LFC_RAW_SIZE <= HG16_32K_MAX, "LFC group length must fit an hg16");
+
 /**
  * struct wbb - a wb tree builder (wb --> "wants to be a b-tree")
  * @nodev: vector of nodes (nodev[0] == first leaf node)
@@ -43,6 +60,17 @@
  * @wbt_first_kobj: first key (aka, min key in wb tree)
  * @wbt_last_kobj: last key (aka, max key in wb tree)
  * @sum_right_keys: total length of right-most keys in all leaf nodes
+ * @leaf_enc:   leaf node encoding
+ * @leaf_cops:  restart group compression ops (NULL if not compressed)
+ * @leaf_calgo: lfc_calgo of LFC nodes
+ * @lfc_buf:    closed restart groups of the current LFC node
+ * @lfc_len:    length of data in @lfc_buf
+ * @lfc_grpc:   number of restart groups in @lfc_buf
+ * @lfc_raw:    entries of the open restart group
+ * @lfc_raw_len: length of data in @lfc_raw
+ * @lfc_tmp:    compression output buffer
+ * @wbt_first_key: copy of the first key (LFC nodes do not hold plain keys)
+ * @wbt_last_key:  copy of the last key
  *
  * Notes:
  *   @max_pages tracks the max number of pages that can be used by the wbtree.
@@ -87,6 +115,20 @@ struct wbb {
 
     uint kmd_iov_index;
     struct iovec kmd_iov[KMD_CHUNKS + 1];
+
+    enum wbt_leaf_enc leaf_enc;
+    const struct compress_ops *leaf_cops;
+    uint8_t leaf_calgo;
+
+    void *lfc_buf;
+    uint lfc_len;
+    uint lfc_grpc;
+    void *lfc_raw;
+    uint lfc_raw_len;
+    void *lfc_tmp;
+
+    uint8_t wbt_first_key[HSE_KVS_KEY_LEN_MAX];
+    uint8_t wbt_last_key[HSE_KVS_KEY_LEN_MAX];
 };
 
 struct key_stage_entry_leaf {
@@ -144,6 +186,9 @@ _new_node(struct wbb *wbb)
     wbb->cnode_nkeys = 0;
     wbb->cnode_key_extra_cnt = 0;
     wbb->cnode_kvlen = 0;
+    wbb->lfc_len = 0;
+    wbb->lfc_grpc = 0;
+    wbb->lfc_raw_len = 0;
 
     memset(wbb->cnode, 0, WBT_NODE_SIZE);
     wbb->lnodec += 1;
@@ -257,9 +302,207 @@ wbb_entries(const struct wbb *wbb)
     return wbb->entries + wbb->cnode_nkeys;
 }
 
-/* Close out the node - Write out node_hdr, prefix, LFEs and key suffixes.
+/* Length of the shared prefix of a key and the previous key in the group.
+ */
+static uint
+wbb_lfc_shared(const void *prev, uint prev_len, const struct key_obj *ko)
+{
+    uint len, shared;
+
+    len = min_t(uint, prev_len, ko->ko_pfx_len);
+    shared = len ? memlcp(prev, ko->ko_pfx, len) : 0;
+    if (shared < ko->ko_pfx_len)
+        return shared;
+
+    len = min_t(uint, prev_len - shared, ko->ko_sfx_len);
+
+    return shared + (len ? memlcp(prev + shared, ko->ko_sfx, len) : 0);
+}
+
+static uint
+wbb_lfc_ent_hdr(void *buf, uint shared, uint unshared, uint kmd_off)
+{
+    size_t off = 0;
+
+    encode_hg16_32k(buf, &off, shared);
+    encode_hg16_32k(buf, &off, unshared);
+    encode_hg32_1024m(buf, &off, kmd_off);
+
+    assert(off <= WBT_LFC_ENT_HDR_MAX);
+    return off;
+}
+
+/* Media size of the current LFC node given an open group of %raw_len bytes.
+ * The open group is accounted for as if it were stored uncompressed, as it
+ * will be if compression doesn't shrink it.
+ */
+static HSE_ALWAYS_INLINE uint
+wbb_lfc_space(const struct wbb *wbb, uint raw_len)
+{
+    uint space;
+
+    space = sizeof(struct wbt_node_hdr_omf) + sizeof(struct wbt_lfc_hdr_omf) + wbb->lfc_len;
+    if (raw_len > 0)
+        space += WBT_LFC_GRP_HDR_MAX + raw_len;
+
+    return space;
+}
+
+/* Close the open restart group - compress it and append it to lfc_buf.
+ */
+static merr_t
+wbb_lfc_grp_close(struct wbb *wbb)
+{
+    uint raw_len = wbb->lfc_raw_len;
+    uint stored_len = raw_len;
+    const void *data = wbb->lfc_raw;
+    size_t off = wbb->lfc_len;
+
+    assert(raw_len > 0);
+
+    if (wbb->leaf_cops) {
+        uint clen = 0;
+        merr_t err;
+
+        assert(wbb->leaf_cops->cop_estimate(NULL, raw_len) <= WBT_LFC_TMP_SIZE);
+
+        err = wbb->leaf_cops->cop_compress(
+            wbb->lfc_raw, raw_len, wbb->lfc_tmp, WBT_LFC_TMP_SIZE, 0, &clen);
+        if (ev(err))
+            return err;
+
+        if (clen < raw_len) {
+            stored_len = clen;
+            data = wbb->lfc_tmp;
+        }
+    }
+
+    encode_hg16_32k(wbb->lfc_buf, &off, raw_len);
+    encode_hg16_32k(wbb->lfc_buf, &off, stored_len);
+    memcpy(wbb->lfc_buf + off, data, stored_len);
+
+    wbb->lfc_len = off + stored_len;
+    wbb->lfc_grpc++;
+    wbb->lfc_raw_len = 0;
+
+    assert(wbb_lfc_space(wbb, 0) <= WBT_NODE_SIZE);
+
+    return 0;
+}
+
+/**
+ * wbb_lfc_fits() - Check whether a key fits the current LFC node
+ * @wbb:     wbtree builder
+ * @kobj:    key to add
+ * @kmd_off: key's kmd offset relative to the node's kmd
+ * @fits:    (output) true if the key fits
+ *
+ * A key that would push the open restart group past WBT_LFC_GRP_SIZE, or
+ * that fits only once the open group has been compressed, starts a new
+ * group.  In both cases the open group is closed here.
+ */
+static merr_t
+wbb_lfc_fits(struct wbb *wbb, const struct key_obj *kobj, uint kmd_off, bool *fits)
+{
+    uint8_t ehdr[WBT_LFC_ENT_HDR_MAX];
+    uint klen = key_obj_len(kobj);
+    uint shared, len;
+
+    if (wbb->lfc_raw_len > 0 && wbb->lfc_raw_len < WBT_LFC_GRP_SIZE) {
+        shared = wbb_lfc_shared(wbb->cnode_last_key, wbb->cnode_last_klen, kobj);
+        len = wbb_lfc_ent_hdr(ehdr, shared, klen - shared, kmd_off) + klen - shared;
+
+        if (wbb_lfc_space(wbb, wbb->lfc_raw_len + len) <= WBT_NODE_SIZE) {
+            *fits = true;
+            return 0;
+        }
+    }
+
+    if (wbb->lfc_raw_len > 0) {
+        merr_t err = wbb_lfc_grp_close(wbb);
+
+        if (ev(err))
+            return err;
+    }
+
+    len = wbb_lfc_ent_hdr(ehdr, 0, klen, kmd_off) + klen;
+    *fits = wbb_lfc_space(wbb, len) <= WBT_NODE_SIZE;
+
+    return 0;
+}
+
+/* Append a key to the open restart group, must be called before the key
+ * becomes the node's last key.
  */
 static void
+wbb_lfc_add(struct wbb *wbb, const struct key_obj *kobj, uint kmd_off)
+{
+    uint klen = key_obj_len(kobj);
+    size_t off = wbb->lfc_raw_len;
+    uint shared = 0;
+    void *dst;
+
+    if (off > 0)
+        shared = wbb_lfc_shared(wbb->cnode_last_key, wbb->cnode_last_klen, kobj);
+
+    off += wbb_lfc_ent_hdr(wbb->lfc_raw + off, shared, klen - shared, kmd_off);
+    dst = wbb->lfc_raw + off;
+
+    if (shared < kobj->ko_pfx_len) {
+        memcpy(dst, kobj->ko_pfx + shared, kobj->ko_pfx_len - shared);
+        memcpy(dst + kobj->ko_pfx_len - shared, kobj->ko_sfx, kobj->ko_sfx_len);
+    } else {
+        memcpy(dst, kobj->ko_sfx + shared - kobj->ko_pfx_len, klen - shared);
+    }
+
+    wbb->lfc_raw_len = off + klen - shared;
+    assert(wbb->lfc_raw_len <= WBT_LFC_RAW_SIZE);
+}
+
+/* Close out an LFC node - Write out the lfc header and the restart groups.
+ */
+static merr_t
+wbt_leaf_publish_lfc(struct wbb *wbb)
+{
+    struct wbt_node_hdr_omf *node_hdr = wbb->cnode;
+    struct wbt_lfc_hdr_omf *lfc_hdr = wbb->cnode + sizeof(*node_hdr);
+
+    if (wbb->lfc_raw_len > 0) {
+        merr_t err = wbb_lfc_grp_close(wbb);
+
+        if (ev(err))
+            return err;
+    }
+
+    assert(wbb_lfc_space(wbb, 0) <= WBT_NODE_SIZE);
+
+    omf_set_wbn_magic(node_hdr, WBT_LFC_NODE_MAGIC);
+    omf_set_lfc_grpc(lfc_hdr, wbb->lfc_grpc);
+    omf_set_lfc_calgo(lfc_hdr, wbb->leaf_calgo);
+    memcpy(lfc_hdr + 1, wbb->lfc_buf, wbb->lfc_len);
+
+    if (!wbb->cnode_nkeys)
+        return 0;
+
+    /* The node doesn't hold plain keys, so keep copies of the first and last
+     * keys for the internal nodes and wbb_min_max_keys().
+     */
+    if (!wbb->entries) {
+        memcpy(wbb->wbt_first_key, wbb->cnode_first_key, wbb->cnode_first_klen);
+        key2kobj(&wbb->wbt_first_kobj, wbb->wbt_first_key, wbb->cnode_first_klen);
+    }
+
+    memcpy(wbb->wbt_last_key, wbb->cnode_last_key, wbb->cnode_last_klen);
+    key2kobj(&wbb->wbt_last_kobj, wbb->wbt_last_key, wbb->cnode_last_klen);
+
+    wbb->entries += wbb->cnode_nkeys;
+
+    return 0;
+}
+
+/* Close out the node - Write out node_hdr, prefix, LFEs and key suffixes.
+ */
+static merr_t
 wbt_leaf_publish(struct wbb *wbb)
 {
     struct wbt_node_hdr_omf *node_hdr = wbb->cnode;
@@ -279,6 +522,9 @@ wbt_leaf_publish(struct wbb *wbb)
 
     wbb->total_kvlen += wbb->cnode_kvlen;
 
+    if (wbb->leaf_enc != WBT_LEAF_ENC_PLAIN)
+        return wbt_leaf_publish_lfc(wbb);
+
     /* Use the first key to write out the prefix. */
     if (pfx_len) {
         void *pfxp = wbb->cnode + sizeof(*node_hdr);
@@ -333,6 +579,8 @@ wbt_leaf_publish(struct wbb *wbb)
         kin = (void *)kin + get_kst_sz(kin->klen);
         wbb->entries++;
     }
+
+    return 0;
 }
 
 merr_t
@@ -355,6 +603,7 @@ wbb_add_entry(
     char encoded_cnt[4]; /* large enough to hold kmd encoded count */
     size_t new_pfx_len;
     uint klen = key_obj_len(kobj);
+    bool fits;
 
     struct key_stage_entry_leaf *kst_leaf;
 
@@ -400,14 +649,30 @@ wbb_add_entry(
 
     wbb->cnode_sumlen += klen;
 
-    /* Create a new node if space exceeds PAGE_SIZE */
+    /* Create a new node if space exceeds PAGE_SIZE.  For LFC nodes, space
+     * is the size of the expanded node, and the encoded node must also fit
+     * in a page.
+     */
     space = sizeof(struct wbt_node_hdr_omf) + new_pfx_len +
         ((wbb->cnode_nkeys + 1) * sizeof(struct wbt_lfe_omf)) + wbb->cnode_sumlen +
         (sizeof(uint32_t) * wbb->cnode_key_extra_cnt) - ((wbb->cnode_nkeys + 1) * new_pfx_len);
 
-    if (space > PAGE_SIZE) {
+    if (wbb->leaf_enc == WBT_LEAF_ENC_PLAIN) {
+        fits = space <= PAGE_SIZE;
+    } else {
+        fits = space <= WBT_LFX_NODE_SIZE;
+        if (fits) {
+            err = wbb_lfc_fits(wbb, kobj, entry_kmd_off - wbb->cnode_kmd_off, &fits);
+            if (ev(err))
+                return err;
+        }
+    }
+
+    if (!fits) {
         /* close out current node */
-        wbt_leaf_publish(wbb);
+        err = wbt_leaf_publish(wbb);
+        if (ev(err))
+            return err;
 
         /* new node allocate fail --> out of space (not error) */
         err = _new_leaf_node(wbb, &wbb->wbt_last_kobj);
@@ -450,6 +715,9 @@ wbb_add_entry(
     /* Get the key's kmd offset within the node's kmd region. */
     entry_kmd_off -= wbb->cnode_kmd_off;
 
+    if (wbb->leaf_enc != WBT_LEAF_ENC_PLAIN)
+        wbb_lfc_add(wbb, kobj, entry_kmd_off);
+
     assert(wbb->cnode_key_cursor >= wbb->cnode_key_stage_base);
     assert(wbb->cnode_key_cursor <= wbb->cnode_key_stage_end);
 
@@ -527,6 +795,7 @@ wbb_hdr_set(struct wbt_hdr_omf *hdr, struct wbt_desc *desc)
     omf_set_wbt_leaf_cnt(hdr, desc->wbd_leaf_cnt);
     omf_set_wbt_root(hdr, desc->wbd_root);
     omf_set_wbt_kmd_pgc(hdr, desc->wbd_kmd_pgc);
+    omf_set_wbt_flags(hdr, desc->wbd_lfc ? WBT_FLAGS_LFC : 0);
 }
 
 merr_t
@@ -542,6 +811,7 @@ wbb_freeze(
     uint first_leaf_node, num_leaf_nodes, root_node;
     uint i, kmd_pgc;
     uint iov_cnt = 0;
+    merr_t err;
 
     assert(*wbt_pgc <= max_pgc);
     if (!(*wbt_pgc <= max_pgc))
@@ -561,7 +831,9 @@ wbb_freeze(
 
     /* write node header in the leaf node that was in progress */
     assert(wbb->cnode_nkeys <= UINT16_MAX);
-    wbt_leaf_publish(wbb);
+    err = wbt_leaf_publish(wbb);
+    if (ev(err))
+        return err;
 
     /* get num_leaf_nodes now, b/c wbb->lnodec
      * will increase as internal nodes are built.
@@ -594,6 +866,7 @@ wbb_freeze(
     omf_set_wbt_leaf_cnt(hdr, num_leaf_nodes);
     omf_set_wbt_root(hdr, root_node);
     omf_set_wbt_kmd_pgc(hdr, kmd_pgc);
+    omf_set_wbt_flags(hdr, wbb->leaf_enc != WBT_LEAF_ENC_PLAIN ? WBT_FLAGS_LFC : 0);
 
     for (i = 0; i <= wbb->kmd_iov_index; i++) {
         size_t len = wbb->kmd_iov[i].iov_len;
@@ -619,7 +892,11 @@ merr_t
 wbb_init(struct wbb *wbb, void *nodev, uint max_pgc, uint *wbt_pgc)
 {
     void *kst_base, *kst_end, *iov_base[KMD_CHUNKS + 1];
+    const struct compress_ops *leaf_cops;
+    void *lfc_buf, *lfc_raw, *lfc_tmp;
+    enum wbt_leaf_enc leaf_enc;
     struct intern_builder *ibldr;
+    uint8_t leaf_calgo;
     uint kst_pgc;
     uint i;
     merr_t err;
@@ -632,9 +909,15 @@ wbb_init(struct wbb *wbb, void *nodev, uint max_pgc, uint *wbt_pgc)
     for (i = 0; wbb->kmd_iov[i].iov_base; i++)
         iov_base[i] = wbb->kmd_iov[i].iov_base;
     iov_base[i] = NULL;
+    leaf_enc = wbb->leaf_enc;
+    leaf_cops = wbb->leaf_cops;
+    leaf_calgo = wbb->leaf_calgo;
+    lfc_buf = wbb->lfc_buf;
+    lfc_raw = wbb->lfc_raw;
+    lfc_tmp = wbb->lfc_tmp;
 
     /* Reset */
-    memset(wbb, 0, sizeof(*wbb));
+    memset(wbb, 0, offsetof(struct wbb, wbt_first_key));
 
     /* Restore */
     wbb->cnode_key_stage_base = kst_base;
@@ -642,6 +925,12 @@ wbb_init(struct wbb *wbb, void *nodev, uint max_pgc, uint *wbt_pgc)
     wbb->cnode_key_stage_pgc = kst_pgc;
     for (i = 0; iov_base[i]; i++)
         wbb->kmd_iov[i].iov_base = iov_base[i];
+    wbb->leaf_enc = leaf_enc;
+    wbb->leaf_cops = leaf_cops;
+    wbb->leaf_calgo = leaf_calgo;
+    wbb->lfc_buf = lfc_buf;
+    wbb->lfc_raw = lfc_raw;
+    wbb->lfc_tmp = lfc_tmp;
 
     /* Init new params */
     wbb->max_pgc = max_pgc;
@@ -669,8 +958,8 @@ merr_t
 wbb_create(
     struct wbb **wbb_out,
     uint max_pgc,
-    uint *wbt_pgc /* in/out */
-)
+    uint *wbt_pgc, /* in/out */
+    enum wbt_leaf_enc leaf_enc)
 {
     struct wbb *wbb;
     void *nodev;
@@ -684,8 +973,44 @@ wbb_create(
     if (ev(!wbb))
         return merr(ENOMEM);
 
+    wbb->leaf_enc = leaf_enc;
+
+    switch (leaf_enc) {
+    case WBT_LEAF_ENC_PLAIN:
+    case WBT_LEAF_ENC_DELTA:
+        break;
+
+    case WBT_LEAF_ENC_LZ4:
+    case WBT_LEAF_ENC_ZSTD:
+        wbb->leaf_calgo = leaf_enc == WBT_LEAF_ENC_ZSTD ? VCOMP_ALGO_ZSTD : VCOMP_ALGO_LZ4;
+        wbb->leaf_cops = vcomp_compress_ops[wbb->leaf_calgo];
+        wbb->leaf_calgo++;
+
+        if (ev(!wbb->leaf_cops)) {
+            free(wbb);
+            return merr(ENOTSUP);
+        }
+        break;
+
+    default:
+        free(wbb);
+        return merr(ev(EINVAL));
+    }
+
+    if (leaf_enc != WBT_LEAF_ENC_PLAIN) {
+        wbb->lfc_buf = malloc(WBT_NODE_SIZE + WBT_LFC_RAW_SIZE + WBT_LFC_TMP_SIZE);
+        if (ev(!wbb->lfc_buf)) {
+            free(wbb);
+            return merr(ENOMEM);
+        }
+
+        wbb->lfc_raw = wbb->lfc_buf + WBT_NODE_SIZE;
+        wbb->lfc_tmp = wbb->lfc_raw + WBT_LFC_RAW_SIZE;
+    }
+
     nodev = aligned_alloc(PAGE_SIZE, max_pgc * PAGE_SIZE);
     if (ev(!nodev)) {
+        free(wbb->lfc_buf);
         free(wbb);
         return merr(ENOMEM);
     }
@@ -693,6 +1018,7 @@ wbb_create(
     err = wbb_init(wbb, nodev, max_pgc, wbt_pgc);
     if (ev(err)) {
         free(nodev);
+        free(wbb->lfc_buf);
         free(wbb);
         return err;
     }
@@ -759,6 +1085,7 @@ wbb_destroy(struct wbb *wbb)
             vlb_free(wbb->kmd_iov[i].iov_base, KMD_CHUNK_LEN);
         free(wbb->nodev);
         free(wbb->cnode_key_stage_base);
+        free(wbb->lfc_buf);
         free(wbb);
     }
 }
@@ -21,16 +21,34 @@ struct wbb;
 struct wbt_hdr_omf;
 struct wbt_desc;
 
+/* Leaf node encodings
+ *
+ * WBT_LEAF_ENC_PLAIN: LFE leaf nodes, searchable in place
+ * WBT_LEAF_ENC_DELTA: LFC leaf nodes with delta encoded keys
+ * WBT_LEAF_ENC_LZ4:   LFC leaf nodes with delta encoded keys, lz4 compressed
+ * WBT_LEAF_ENC_ZSTD:  LFC leaf nodes with delta encoded keys, zstd compressed
+ */
+enum wbt_leaf_enc {
+    WBT_LEAF_ENC_PLAIN,
+    WBT_LEAF_ENC_DELTA,
+    WBT_LEAF_ENC_LZ4,
+    WBT_LEAF_ENC_ZSTD,
+};
+
 /* Create a wbtree builder
  *
  * Parameters:
  * - wbb_out: (output) builder handle
  * - max_pgc: (in) max allowable size of wbtree in pages
  * - wbt_pgc: (in/out) actual size (in pages) of wbtree creation
+ * - leaf_enc: (in) leaf node encoding
+ *
+ * Returns ENOTSUP if leaf_enc requires a compression algorithm that
+ * this build does not support.
  */
 /* MTF_MOCK */
 merr_t
-wbb_create(struct wbb **wbb_out, uint max_pgc, uint *wbt_pgc);
+wbb_create(struct wbb **wbb_out, uint max_pgc, uint *wbt_pgc, enum wbt_leaf_enc leaf_enc);
 
 /* Reset a wbtree builder so it can be reused for a new wbtree
  */
@@ -6,6 +6,7 @@
 #ifndef HSE_KVS_CN_WBT_INTERNAL_H
 #define HSE_KVS_CN_WBT_INTERNAL_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <sys/types.h>
@@ -16,6 +17,37 @@
 #include "kvs_mblk_desc.h"
 #include "omf.h"
 
+/* WBT_LFC_NODE_MAGIC leaf nodes are expanded into WBT_LFX_NODE_MAGIC nodes,
+ * which have the same layout as WBT_LFE_NODE_MAGIC nodes, but span up to
+ * WBT_LFX_NODE_SIZE bytes.  Expanded nodes only ever exist in memory.
+ */
+#define WBT_LFX_NODE_MAGIC ((uint16_t)0xabc3)
+#define WBT_LFX_NODE_SIZE  (4 * WBT_NODE_SIZE)
+
+/* LFC restart groups (see struct wbt_lfc_hdr_omf) are closed once their
+ * entries reach WBT_LFC_GRP_SIZE bytes, hence the entries of a group never
+ * exceed WBT_LFC_RAW_SIZE bytes.
+ */
+#define WBT_LFC_GRP_SIZE    (2048)
+#define WBT_LFC_GRP_HDR_MAX (4)
+#define WBT_LFC_ENT_HDR_MAX (8)
+#define WBT_LFC_RAW_SIZE    (PAGE_SIZE)
+
+static HSE_ALWAYS_INLINE bool
+wbt_node_is_leaf(const struct wbt_node_hdr_omf *node)
+{
+    const uint16_t magic = omf_wbn_magic(node);
+
+    return magic == WBT_LFE_NODE_MAGIC || magic == WBT_LFC_NODE_MAGIC ||
+        magic == WBT_LFX_NODE_MAGIC;
+}
+
+static HSE_ALWAYS_INLINE uint
+wbt_node_size(const struct wbt_node_hdr_omf *node)
+{
+    return omf_wbn_magic(node) == WBT_LFX_NODE_MAGIC ? WBT_LFX_NODE_SIZE : WBT_NODE_SIZE;
+}
+
 static HSE_ALWAYS_INLINE const struct wbt_lfe_omf *
 wbt_lfe(const struct wbt_node_hdr_omf *node, int nth)
 {
@@ -47,7 +79,7 @@ wbt_lfe_key(
     __builtin_prefetch((void *)node + start);
 
     /* end == one byte past end of key. */
-    end = (lfe == wbt_lfe(node, 0) ? WBT_NODE_SIZE : omf_lfe_koff(lfe - 1));
+    end = (lfe == wbt_lfe(node, 0) ? wbt_node_size(node) : omf_lfe_koff(lfe - 1));
 
     *klen = end - start;
     *kdata = (void *)node + start;
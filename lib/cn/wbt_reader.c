@@ -10,8 +10,11 @@
 
 #include <hse/limits.h>
 
+#include <hse/ikvdb/encoders.h>
 #include <hse/ikvdb/omf_kmd.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/ikvdb/vcomp_params.h>
+#include <hse/logging/logging.h>
 #include <hse/util/alloc.h>
 #include <hse/util/atomic.h>
 #include <hse/util/compiler.h>
@@ -34,6 +37,11 @@
  * This file should contain no wbt omf specific code.
  */
 
+/* Reverse leaf node readahead windows, in nodes (i.e., pages).
+ */
+#define WBTI_RA_NODES_MIN (4)
+#define WBTI_RA_NODES_MAX (32)
+
 static struct kmem_cache *wbti_cache HSE_READ_MOSTLY;
 
 void
@@ -51,7 +59,7 @@ wbt_read_kmd_vref(
     uint complen = 0;
     const void *vdata = 0;
 
-    kmd_type_seq(kmd, off, &vtype, seq);
+    kmd_type_seq_expire(kmd, off, &vtype, seq, &vref->vr_expire);
 
     switch (vtype) {
     case VTYPE_UCVAL:
@@ -66,6 +74,7 @@ wbt_read_kmd_vref(
         vref->vb.vr_complen = 0;
         break;
     case VTYPE_CVAL:
+    case VTYPE_ZCVAL:
         kmd_cval(kmd, off, &vbidx, &vboff, &vlen, &complen);
         /* assert no truncation */
         assert(vbidx <= UINT16_MAX);
@@ -90,7 +99,7 @@ wbt_read_kmd_vref(
         break;
     }
 
-    if ((vtype == VTYPE_UCVAL || vtype == VTYPE_CVAL) && vgmap) {
+    if ((vtype == VTYPE_UCVAL || vtype == VTYPE_CVAL || vtype == VTYPE_ZCVAL) && vgmap) {
         merr_t err;
 
         err = vgmap_vbidx_src2out(vgmap, vref->vb.vr_index, &vref->vb.vr_index);
@@ -101,6 +110,273 @@ wbt_read_kmd_vref(
     vref->vr_type = vtype;
 }
 
+/* Read the restart group at %off of an LFC leaf node.  %data is set to the
+ * group's entries, which are decompressed into %buf if need be.  If %buf is
+ * smaller than the group only a prefix of the group is decompressed.
+ */
+static merr_t
+wbt_lfc_grp_read(
+    const struct wbt_node_hdr_omf *node,
+    uint calgo,
+    size_t *off,
+    void *buf,
+    uint buf_sz,
+    const void **data,
+    uint *dlen)
+{
+    uint raw_len, stored_len;
+    merr_t err;
+
+    raw_len = decode_hg16_32k(node, off);
+    stored_len = decode_hg16_32k(node, off);
+
+    if (ev(raw_len > WBT_LFC_RAW_SIZE || stored_len > raw_len ||
+           *off + stored_len > WBT_NODE_SIZE))
+        return merr(EPROTO);
+
+    if (stored_len == raw_len) {
+        *data = (const void *)node + *off;
+        *dlen = raw_len;
+    } else {
+        if (ev(calgo == 0 || calgo - 1 > VCOMP_ALGO_MAX))
+            return merr(EPROTO);
+
+        err = vcomp_decompress(
+            calgo - 1, (const void *)node + *off, stored_len, buf, min_t(uint, buf_sz, raw_len),
+            dlen);
+        if (ev(err))
+            return err;
+
+        if (ev(*dlen != min_t(uint, buf_sz, raw_len)))
+            return merr(EPROTO);
+
+        *data = buf;
+    }
+
+    *off += stored_len;
+
+    return 0;
+}
+
+/* Decode the header of the entry at %off, %klen is the length of the
+ * previous key in the group (zero for the first entry).
+ */
+static HSE_ALWAYS_INLINE merr_t
+wbt_lfc_ent_read(
+    const void *data,
+    uint dlen,
+    size_t *off,
+    uint klen,
+    uint *shared,
+    uint *unshared,
+    uint *kmd_off)
+{
+    *shared = decode_hg16_32k(data, off);
+    *unshared = decode_hg16_32k(data, off);
+    *kmd_off = decode_hg32_1024m(data, off);
+
+    if (ev(*shared > klen || *shared + *unshared > HSE_KVS_KEY_LEN_MAX ||
+           *off + *unshared > dlen))
+        return merr(EPROTO);
+
+    return 0;
+}
+
+merr_t
+wbt_leaf_expand(const struct wbt_node_hdr_omf *node, void *xnode)
+{
+    const struct wbt_lfc_hdr_omf *lfc_hdr = (const void *)(node + 1);
+    struct wbt_node_hdr_omf *xhdr = xnode;
+    uint8_t key[HSE_KVS_KEY_LEN_MAX];
+    uint8_t buf[WBT_LFC_RAW_SIZE];
+    uint nkeys, pfx_len, grpc, calgo;
+    struct wbt_lfe_omf *lfe;
+    size_t off;
+    void *sfxp;
+    uint i = 0;
+
+    assert(omf_wbn_magic(node) == WBT_LFC_NODE_MAGIC);
+
+    nkeys = omf_wbn_num_keys(node);
+    pfx_len = omf_wbn_pfx_len(node);
+    grpc = omf_lfc_grpc(lfc_hdr);
+    calgo = omf_lfc_calgo(lfc_hdr);
+
+    if (ev(pfx_len > HSE_KVS_KEY_LEN_MAX))
+        return merr(EPROTO);
+
+    memcpy(xhdr, node, sizeof(*xhdr));
+    omf_set_wbn_magic(xhdr, WBT_LFX_NODE_MAGIC);
+
+    lfe = xnode + sizeof(*xhdr) + pfx_len;
+    sfxp = xnode + WBT_LFX_NODE_SIZE;
+    off = sizeof(*node) + sizeof(*lfc_hdr);
+
+    while (grpc-- > 0) {
+        const void *data;
+        size_t doff = 0;
+        uint dlen, klen = 0;
+        merr_t err;
+
+        err = wbt_lfc_grp_read(node, calgo, &off, buf, sizeof(buf), &data, &dlen);
+        if (ev(err))
+            return err;
+
+        while (doff < dlen) {
+            uint shared, unshared, kmd_off, extra;
+
+            err = wbt_lfc_ent_read(data, dlen, &doff, klen, &shared, &unshared, &kmd_off);
+            if (ev(err))
+                return err;
+
+            memcpy(key + shared, data + doff, unshared);
+            doff += unshared;
+            klen = shared + unshared;
+
+            extra = kmd_off < UINT16_MAX ? 0 : WBT_LFE_INLINE_KMD_OFF_SIZE;
+
+            if (ev(i >= nkeys || klen < pfx_len))
+                return merr(EPROTO);
+
+            sfxp -= klen - pfx_len + extra;
+            if (ev(sfxp < (void *)(lfe + 1)))
+                return merr(EPROTO);
+
+            if (extra) {
+                uint32_t kmd_off_omf = cpu_to_omf32(kmd_off);
+
+                omf_set_lfe_kmd(lfe, UINT16_MAX);
+                memcpy(sfxp, &kmd_off_omf, WBT_LFE_INLINE_KMD_OFF_SIZE);
+            } else {
+                omf_set_lfe_kmd(lfe, kmd_off);
+            }
+
+            memcpy(sfxp + extra, key + pfx_len, klen - pfx_len);
+            omf_set_lfe_koff(lfe, sfxp - xnode);
+
+            if (i++ == 0)
+                memcpy(xnode + sizeof(*xhdr), key, pfx_len);
+
+            lfe++;
+        }
+    }
+
+    if (ev(i != nkeys))
+        return merr(EPROTO);
+
+    return 0;
+}
+
+merr_t
+wbt_leaf_first_key(const struct wbt_node_hdr_omf *node, void *kbuf, uint *klen)
+{
+    const struct wbt_lfc_hdr_omf *lfc_hdr = (const void *)(node + 1);
+    uint8_t buf[WBT_LFC_ENT_HDR_MAX + HSE_KVS_KEY_LEN_MAX];
+    uint shared, unshared, kmd_off, dlen;
+    size_t off, doff = 0;
+    const void *data;
+    merr_t err;
+
+    assert(omf_wbn_magic(node) == WBT_LFC_NODE_MAGIC);
+
+    if (ev(!omf_wbn_num_keys(node) || !omf_lfc_grpc(lfc_hdr)))
+        return merr(EPROTO);
+
+    off = sizeof(*node) + sizeof(*lfc_hdr);
+
+    err = wbt_lfc_grp_read(node, omf_lfc_calgo(lfc_hdr), &off, buf, sizeof(buf), &data, &dlen);
+    if (ev(err))
+        return err;
+
+    err = wbt_lfc_ent_read(data, dlen, &doff, 0, &shared, &unshared, &kmd_off);
+    if (ev(err))
+        return err;
+
+    memcpy(kbuf, data + doff, unshared);
+    *klen = unshared;
+
+    return 0;
+}
+
+/* Search an LFC leaf node for a key.  Restart groups before the one that
+ * may hold the key are skipped after decoding just their first key, only
+ * the candidate group is decoded in full.
+ */
+static merr_t
+wbtr_lfc_lookup(
+    const struct wbt_node_hdr_omf *node,
+    const void *kt_data,
+    uint kt_len,
+    size_t *kmd_off,
+    bool *found)
+{
+    const struct wbt_lfc_hdr_omf *lfc_hdr = (const void *)(node + 1);
+    uint grpc = omf_lfc_grpc(lfc_hdr);
+    uint calgo = omf_lfc_calgo(lfc_hdr);
+    uint8_t key[HSE_KVS_KEY_LEN_MAX];
+    uint8_t buf[WBT_LFC_RAW_SIZE];
+    uint shared, unshared, koff, dlen, klen;
+    size_t off, doff, cand = 0;
+    const void *data;
+    merr_t err;
+
+    *found = false;
+    off = sizeof(*node) + sizeof(*lfc_hdr);
+
+    /* Find the last group whose first key is not greater than the key.
+     */
+    while (grpc-- > 0) {
+        size_t goff = off;
+
+        err = wbt_lfc_grp_read(
+            node, calgo, &off, buf, WBT_LFC_ENT_HDR_MAX + HSE_KVS_KEY_LEN_MAX, &data, &dlen);
+        if (ev(err))
+            return err;
+
+        doff = 0;
+        err = wbt_lfc_ent_read(data, dlen, &doff, 0, &shared, &unshared, &koff);
+        if (ev(err))
+            return err;
+
+        if (keycmp(data + doff, unshared, kt_data, kt_len) > 0)
+            break;
+
+        cand = goff;
+    }
+
+    if (!cand)
+        return 0;
+
+    off = cand;
+    err = wbt_lfc_grp_read(node, calgo, &off, buf, sizeof(buf), &data, &dlen);
+    if (ev(err))
+        return err;
+
+    for (doff = 0, klen = 0; doff < dlen; ) {
+        int cmp;
+
+        err = wbt_lfc_ent_read(data, dlen, &doff, klen, &shared, &unshared, &koff);
+        if (ev(err))
+            return err;
+
+        memcpy(key + shared, data + doff, unshared);
+        doff += unshared;
+        klen = shared + unshared;
+
+        cmp = keycmp(key, klen, kt_data, kt_len);
+        if (cmp > 0)
+            break;
+
+        if (cmp == 0) {
+            *kmd_off = omf_wbn_kmd(node) + koff;
+            *found = true;
+            break;
+        }
+    }
+
+    return 0;
+}
+
 static void
 wbti_get_page(struct wbti *self, uint32_t node_idx)
 {
@@ -111,12 +387,191 @@ wbti_get_page(struct wbti *self, uint32_t node_idx)
     mblock_offset = PAGE_SIZE * (node_idx + self->wbd->wbd_first_page);
     self->node = self->base + mblock_offset;
 
-    assert(omf_wbn_magic(self->node) == WBT_LFE_NODE_MAGIC);
+    if (omf_wbn_magic(self->node) == WBT_LFC_NODE_MAGIC) {
+        struct wbt_node_hdr_omf *xnode;
+        merr_t err;
+
+        assert(self->xbuf);
+
+        self->xidx ^= 1;
+        xnode = self->xbuf + self->xidx * WBT_LFX_NODE_SIZE;
+
+        err = wbt_leaf_expand(self->node, xnode);
+        if (err) {
+            /* Present a malformed leaf as an empty one.
+             */
+            log_errx("malformed wbtree leaf node %u", err, node_idx);
+            assert(0);
+
+            memset(xnode, 0, sizeof(*xnode));
+            omf_set_wbn_magic(xnode, WBT_LFX_NODE_MAGIC);
+        }
+
+        self->node = xnode;
+    }
+
+    assert(wbt_node_is_leaf(self->node));
 
     self->lfe_idx = -1;
     self->node_idx = node_idx;
 }
 
+/**
+ * struct wbt_fence - dense array of leaf node upper bounds
+ * @wf_leafc:  number of leaf nodes
+ * @wf_fencev: leading eight bytes (big-endian) of each leaf's upper bound key
+ */
+struct wbt_fence {
+    uint32_t wf_leafc;
+    uint64_t wf_fencev[];
+};
+
+/* Convert the leading eight bytes of (pfx || sfx) to an integer that orders
+ * the same as keycmp() would order the keys, short keys are zero padded.
+ */
+static HSE_ALWAYS_INLINE uint64_t
+wbt_fence_key(const void *pfx, uint pfx_len, const void *sfx, uint sfx_len)
+{
+    uint64_t fence = 0;
+    uint len;
+
+    len = min_t(uint, pfx_len, sizeof(fence));
+    memcpy(&fence, pfx, len);
+
+    if (len < sizeof(fence))
+        memcpy((void *)&fence + len, sfx, min_t(uint, sfx_len, sizeof(fence) - len));
+
+    return be64_to_cpu(fence);
+}
+
+static bool
+wbtr_fence_fill(
+    const void *base,
+    const struct wbt_desc *wbd,
+    int node_num,
+    uint64_t upper,
+    struct wbt_fence *wf,
+    uint *leafc)
+{
+    const struct wbt_node_hdr_omf *node;
+    const void *node_pfx;
+    uint node_pfx_len, nkeys;
+
+    if (ev(node_num < 0 || node_num >= wbd->wbd_n_pages))
+        return false;
+
+    node = base + (wbd->wbd_first_page + node_num) * PAGE_SIZE;
+
+    if (wbt_node_is_leaf(node)) {
+        /* Leaves are laid out in key order, hence are visited in order.
+         */
+        if (ev(node_num != wbd->wbd_leaf + *leafc || *leafc >= wf->wf_leafc))
+            return false;
+
+        wf->wf_fencev[(*leafc)++] = upper;
+        return true;
+    }
+
+    if (ev(omf_wbn_magic(node) != WBT_INE_NODE_MAGIC))
+        return false;
+
+    wbt_node_pfx(node, &node_pfx, &node_pfx_len);
+    nkeys = omf_wbn_num_keys(node);
+
+    /* Child j holds keys less than or equal to key j, the rightmost child
+     * (which has no key) inherits the upper bound of this node.
+     */
+    for (uint j = 0; j <= nkeys; j++) {
+        const struct wbt_ine_omf *ine = wbt_ine(node, j);
+        uint64_t fence = upper;
+
+        if (j < nkeys) {
+            const void *kdata;
+            uint klen;
+
+            wbt_ine_key(node, ine, &kdata, &klen);
+            fence = wbt_fence_key(node_pfx, node_pfx_len, kdata, klen);
+        }
+
+        if (ev(omf_ine_left_child(ine) >= node_num))
+            return false;
+
+        if (!wbtr_fence_fill(base, wbd, omf_ine_left_child(ine), fence, wf, leafc))
+            return false;
+    }
+
+    return true;
+}
+
+merr_t
+wbtr_fence_create(const void *base, struct wbt_desc *wbd)
+{
+    struct wbt_fence *wf;
+    uint leafc = 0;
+
+    assert(!wbd->wbd_fence);
+
+    /* Nothing to predict if the root is the only leaf.
+     */
+    if (wbd->wbd_leaf_cnt < 2)
+        return 0;
+
+    wf = malloc(sizeof(*wf) + sizeof(wf->wf_fencev[0]) * wbd->wbd_leaf_cnt);
+    if (ev(!wf))
+        return merr(ENOMEM);
+
+    wf->wf_leafc = wbd->wbd_leaf_cnt;
+
+    if (!wbtr_fence_fill(base, wbd, wbd->wbd_root, UINT64_MAX, wf, &leafc) ||
+        ev(leafc != wf->wf_leafc)) {
+        free(wf);
+        return merr(EPROTO);
+    }
+
+    wbd->wbd_fence = wf;
+
+    return 0;
+}
+
+void
+wbtr_fence_destroy(struct wbt_desc *wbd)
+{
+    free(wbd->wbd_fence);
+    wbd->wbd_fence = NULL;
+}
+
+/* Predict the leaf node containing the given key from the fence index.
+ * Returns -1 if the prediction is ambiguous, in which case the caller
+ * must descend the wbtree.
+ */
+static HSE_ALWAYS_INLINE int
+wbtr_fence_lookup(const struct wbt_desc *wbd, const void *kt_data, uint kt_len)
+{
+    const struct wbt_fence *wf = wbd->wbd_fence;
+    uint first = 0, last = wf->wf_leafc - 1;
+    uint64_t key;
+
+    key = wbt_fence_key(kt_data, kt_len, NULL, 0);
+
+    /* Find the first leaf whose upper bound is not less than the key.
+     * The last fence is UINT64_MAX, so the search always terminates
+     * within the array.
+     */
+    while (first < last) {
+        uint mid = (first + last) / 2;
+
+        if (wf->wf_fencev[mid] < key)
+            first = mid + 1;
+        else
+            last = mid;
+    }
+
+    if (wf->wf_fencev[first] == key)
+        return -1;
+
+    return wbd->wbd_leaf + first;
+}
+
 static int
 wbtr_seek_page(
     const void *base,
@@ -133,6 +588,14 @@ wbtr_seek_page(
     /* pull struct derefs out of the loop */
     uint first_page = wbd->wbd_first_page;
 
+    if (wbd->wbd_fence) {
+        node_num = wbtr_fence_lookup(wbd, kt_data, kt_len);
+        if (node_num >= 0) {
+            __builtin_prefetch(base + (first_page + node_num) * PAGE_SIZE);
+            return node_num;
+        }
+    }
+
     /* search from root */
     node_num = wbd->wbd_root;
 
@@ -271,7 +734,6 @@ wbti_seek_fwd(struct wbti *self, struct kvs_ktuple *kt)
     const struct wbt_node_hdr_omf *node;
     int j, cmp, node_num;
     int first, last, lfe_eof;
-    size_t pg;
     const void *kdata, *kt_data;
     uint klen, kt_len, cmplen;
     const struct wbt_lfe_omf *lfe;
@@ -293,11 +755,10 @@ wbti_seek_fwd(struct wbti *self, struct kvs_ktuple *kt)
     wbti_get_page(self, node_num);
 
     assert(0 <= node_num && node_num < wbd->wbd_n_pages);
-    pg = wbd->wbd_first_page + node_num;
-    node = self->base + pg * PAGE_SIZE;
+    node = self->node;
 
     /* at leaf */
-    assert(omf_wbn_magic(node) == WBT_LFE_NODE_MAGIC);
+    assert(wbt_node_is_leaf(node));
 
     /* binary search over keys in node */
     first = 0;
@@ -462,7 +923,6 @@ wbti_seek_rev(struct wbti *self, struct kvs_ktuple *kt)
     const struct wbt_node_hdr_omf *node;
     int cmp, node_num;
     int first, last, lfe_eof;
-    size_t pg;
     const void *kdata, *kt_data;
     uint klen, kt_len, cmplen;
     const struct wbt_lfe_omf *lfe;
@@ -492,11 +952,10 @@ repeat:
     wbti_get_page(self, node_num);
 
     assert(0 <= node_num && node_num < wbd->wbd_n_pages);
-    pg = wbd->wbd_first_page + node_num;
-    node = self->base + pg * PAGE_SIZE;
+    node = self->node;
 
     /* at leaf */
-    assert(omf_wbn_magic(node) == WBT_LFE_NODE_MAGIC);
+    assert(wbt_node_is_leaf(node));
 
     /* binary search over keys in node */
     lfe_eof = first = 0;
@@ -609,13 +1068,64 @@ wbti_seek(struct wbti *self, struct kvs_ktuple *seek)
     return self->reverse ? wbti_seek_rev(self, seek) : wbti_seek_fwd(self, seek);
 }
 
+/* Issue an asynchronous readahead for the next window of leaf nodes below
+ * the current one, along with the key metadata they likely reference.  The
+ * next window is requested once the iterator is halfway through the current
+ * one so that its pages are in flight by the time they're needed.
+ */
+static void
+wbti_readahead_rev(struct wbti *self)
+{
+    const struct wbt_desc *wbd = self->wbd;
+    uint32_t lo, hi, kmd_lo, kmd_hi;
+    int rc;
+
+    if (self->ra_lo <= wbd->wbd_leaf)
+        return;
+
+    if (self->node_idx >= self->ra_lo + self->ra_nodes / 2)
+        return;
+
+    self->ra_nodes = self->ra_nodes ? min_t(uint, self->ra_nodes * 2, WBTI_RA_NODES_MAX)
+                                    : WBTI_RA_NODES_MIN;
+
+    hi = self->ra_lo;
+    lo = hi - min_t(uint32_t, hi - wbd->wbd_leaf, self->ra_nodes);
+    self->ra_lo = lo;
+
+    rc = madvise(
+        (void *)self->base + PAGE_SIZE * (wbd->wbd_first_page + lo), PAGE_SIZE * (hi - lo),
+        MADV_WILLNEED);
+    ev(rc);
+
+    /* The kmd region is laid out in leaf node order, so estimate the pages
+     * used by this window of leaves from the average kmd pages per leaf.
+     */
+    if (!wbd->wbd_kmd_pgc || !wbd->wbd_leaf_cnt)
+        return;
+
+    kmd_lo = ((lo - wbd->wbd_leaf) * wbd->wbd_kmd_pgc) / wbd->wbd_leaf_cnt;
+    kmd_hi = ((hi - wbd->wbd_leaf) * wbd->wbd_kmd_pgc + wbd->wbd_leaf_cnt - 1) / wbd->wbd_leaf_cnt;
+    kmd_hi = min_t(uint32_t, kmd_hi + 1, wbd->wbd_kmd_pgc);
+
+    if (kmd_hi > kmd_lo) {
+        rc = madvise(
+            (void *)self->kmd + PAGE_SIZE * kmd_lo, PAGE_SIZE * (kmd_hi - kmd_lo), MADV_WILLNEED);
+        ev(rc);
+    }
+}
+
 static void
 wbti_node_prev(struct wbti *self)
 {
-    if (self->node_idx > 0)
+    if (self->node_idx > 0) {
         wbti_get_page(self, self->node_idx - 1);
-    else
+
+        if (self->readahead)
+            wbti_readahead_rev(self);
+    } else {
         self->node_idx = NODE_EOF;
+    }
 
     self->lfe_idx = omf_wbn_num_keys(self->node) - 1;
 }
@@ -629,7 +1139,8 @@ wbti_node_advance(struct wbti *self)
         wbti_get_page(self, self->node_idx + 1);
 
         if (self->node_idx + 2 < max_idx)
-            __builtin_prefetch(self->node + PAGE_SIZE);
+            __builtin_prefetch(
+                self->base + PAGE_SIZE * (self->node_idx + 1 + self->wbd->wbd_first_page));
     } else {
         self->node_idx = NODE_EOF;
     }
@@ -712,15 +1223,23 @@ wbti_next(struct wbti *self, const void **kdata, uint *klen, const void **kmd)
                          : wbti_next_fwd(self, kdata, klen, kmd);
 }
 
-void
+merr_t
 wbti_reset(
     struct wbti *self,
     const void *base,
     struct wbt_desc *desc,
     struct kvs_ktuple *seek,
     bool reverse,
-    bool cache)
+    bool readahead)
 {
+    /* The expansion buffer is retained across resets.
+     */
+    if (desc->wbd_lfc && !self->xbuf) {
+        self->xbuf = malloc(2 * WBT_LFX_NODE_SIZE);
+        if (ev(!self->xbuf))
+            return merr(ENOMEM);
+    }
+
     /* self is not zeroed out so be sure to initialize all fields.
      */
     self->wbd = desc;
@@ -731,6 +1250,7 @@ wbti_reset(
     self->node_idx = 0;
     self->lfe_idx = 0;
     self->reverse = reverse;
+    self->readahead = reverse && readahead;
 
     if (seek) {
         if (!wbti_seek(self, seek))
@@ -743,6 +1263,13 @@ wbti_reset(
             self->node_idx = desc->wbd_leaf + desc->wbd_leaf_cnt - 1;
         }
     }
+
+    /* Nothing below the starting node has been prefetched yet.
+     */
+    self->ra_lo = self->node_idx;
+    self->ra_nodes = 0;
+
+    return 0;
 }
 
 merr_t
@@ -758,10 +1285,13 @@ wbtr_read_vref(
     const struct wbt_node_hdr_omf *node;
     int j, cmp, node_num;
     int first, last;
-    size_t pg;
+    size_t pg, off;
     const void *kdata, *kt_data;
     uint klen, kt_len;
     const struct wbt_lfe_omf *lfe;
+    const void *kmd;
+    uint64_t vseq;
+    uint nvals;
 
     const void *node_pfx;
     uint node_pfx_len;
@@ -781,7 +1311,21 @@ wbtr_read_vref(
     node = base + pg * PAGE_SIZE;
 
     /* at leaf */
-    assert(omf_wbn_magic(node) == WBT_LFE_NODE_MAGIC);
+    assert(wbt_node_is_leaf(node));
+
+    if (omf_wbn_magic(node) == WBT_LFC_NODE_MAGIC) {
+        bool found;
+        merr_t err;
+
+        err = wbtr_lfc_lookup(node, kt_data, kt_len, &off, &found);
+        if (ev(err))
+            return err;
+
+        if (found)
+            goto found;
+
+        goto done;
+    }
 
     /* binary search over keys in node */
     first = 0;
@@ -808,41 +1352,40 @@ wbtr_read_vref(
         wbt_lfe_key(node, lfe, &kdata, &klen); /* sfx */
 
         cmp = keycmp(kt_data, kt_len, kdata, klen);
-        if (cmp < 0)
+        if (cmp < 0) {
             last = j - 1;
-        else if (cmp > 0)
+        } else if (cmp > 0) {
             first = j + 1;
-        else {
-            /* Found key */
-            const void *kmd;
-            size_t off;
-            uint64_t vseq;
-            uint nvals;
-
-            kmd = base + PAGE_SIZE * (wbd->wbd_first_page + wbd->wbd_root + 1);
-
+        } else {
             off = wbt_lfe_kmd(node, lfe);
-            assert(off < wbd->wbd_kmd_pgc * PAGE_SIZE);
-            nvals = kmd_count(kmd, &off);
-            assert(nvals > 0);
-            while (nvals--) {
-                wbt_read_kmd_vref(kmd, vgmap, &off, &vseq, vref);
-                assert(off <= wbd->wbd_kmd_pgc * PAGE_SIZE);
-                if (seq >= vseq) {
-                    vref->vr_seq = vseq;
-                    if (vref->vr_type == VTYPE_TOMB)
-                        *lookup_res = FOUND_TMB;
-                    else if (vref->vr_type == VTYPE_PTOMB)
-                        *lookup_res = FOUND_PTMB;
-                    else
-                        *lookup_res = FOUND_VAL;
-
-                    return 0;
-                }
-            }
-            break;
+            goto found;
         }
     }
+
+    goto done;
+
+found:
+    kmd = base + PAGE_SIZE * (wbd->wbd_first_page + wbd->wbd_root + 1);
+
+    assert(off < wbd->wbd_kmd_pgc * PAGE_SIZE);
+    nvals = kmd_count(kmd, &off);
+    assert(nvals > 0);
+    while (nvals--) {
+        wbt_read_kmd_vref(kmd, vgmap, &off, &vseq, vref);
+        assert(off <= wbd->wbd_kmd_pgc * PAGE_SIZE);
+        if (seq >= vseq) {
+            vref->vr_seq = vseq;
+            if (vref->vr_type == VTYPE_TOMB || kvs_expired(vref->vr_expire))
+                *lookup_res = FOUND_TMB;
+            else if (vref->vr_type == VTYPE_PTOMB)
+                *lookup_res = FOUND_PTMB;
+            else
+                *lookup_res = FOUND_VAL;
+
+            return 0;
+        }
+    }
+
 done:
     /* Not finding the key is *not* an error. */
     *lookup_res = NOT_FOUND;
@@ -864,6 +1407,9 @@ wbti_alloc(struct wbti **wbti_out)
     if (ev(!self))
         return merr(ENOMEM);
 
+    self->xbuf = NULL;
+    self->xidx = 0;
+
     *wbti_out = self;
 
     return 0;
@@ -876,7 +1422,7 @@ wbti_create(
     struct wbt_desc *desc,
     struct kvs_ktuple *seek,
     bool reverse,
-    bool cache)
+    bool readahead)
 {
     struct wbti *self = NULL;
     merr_t err;
@@ -885,7 +1431,11 @@ wbti_create(
     if (ev(err))
         return err;
 
-    wbti_reset(self, base, desc, seek, reverse, cache);
+    err = wbti_reset(self, base, desc, seek, reverse, readahead);
+    if (ev(err)) {
+        wbti_destroy(self);
+        return err;
+    }
 
     *wbti_out = self;
     return 0;
@@ -894,6 +1444,10 @@ wbti_create(
 void
 wbti_destroy(struct wbti *self)
 {
+    if (!self)
+        return;
+
+    free(self->xbuf);
     kmem_cache_free(wbti_cache, self);
 }
 
@@ -941,6 +1495,7 @@ wbtr_read_desc(const struct wbt_hdr_omf *wbt_hdr, struct wbt_desc *desc)
         desc->wbd_leaf = omf_wbt_leaf(wbt_hdr);
         desc->wbd_leaf_cnt = omf_wbt_leaf_cnt(wbt_hdr);
         desc->wbd_kmd_pgc = omf_wbt_kmd_pgc(wbt_hdr);
+        desc->wbd_lfc = omf_wbt_flags(wbt_hdr) & WBT_FLAGS_LFC;
         break;
 
     default:
@@ -16,6 +16,7 @@ struct kvs_mblk_desc;
 struct mpool;
 struct wbt_hdr_omf;
 struct vgmap;
+struct wbt_fence;
 
 /* MTF_MOCK_DECL(wbt_reader) */
 
@@ -29,6 +30,8 @@ struct vgmap;
  * @wbd_leaf: first leaf node (@wbd_leaf < @wbd_n_pages)
  * @wbd_leaf_cnt: number of leaf nodes
  * @wbd_kmd_pgc: size of key-metadata region in pages
+ * @wbd_lfc: some leaf nodes are WBT_LFC_NODE_MAGIC nodes
+ * @wbd_fence: optional in-memory fence index over the leaf nodes
  *
  * When a KBLOCK is opened for reading, the @wbt_hdr_omf struct is read from
  * media and the relevant information is stored in a @wbt_desc struct.
@@ -47,8 +50,20 @@ struct wbt_desc {
     uint16_t wbd_leaf_cnt;
     uint16_t wbd_kmd_pgc;
     uint16_t wbd_version;
+    bool wbd_lfc;
+    struct wbt_fence *wbd_fence;
 };
 
+/* When iterating over LFC leaf nodes, @node points to the leaf expanded into
+ * one half of @xbuf.  The halves are used alternately so that keys returned
+ * from the previous leaf remain valid until the iterator leaves the current
+ * leaf.
+ *
+ * Reverse iterators prefetch the leaf nodes below @node in windows that
+ * grow from WBTI_RA_NODES_MIN to WBTI_RA_NODES_MAX nodes, as the kernel's
+ * own mmap readahead only ever reads forward.  @ra_lo is the lowest leaf
+ * node prefetched so far and @ra_nodes the size of the last window.
+ */
 struct wbti {
     struct wbt_desc *wbd; /* MUST BE FIRST */
     const void *base;
@@ -58,6 +73,12 @@ struct wbti {
     uint32_t lfe_idx;
 
     bool reverse;
+    bool readahead;
+    uint8_t xidx;
+    void *xbuf;
+
+    uint32_t ra_lo;
+    uint16_t ra_nodes;
 };
 
 /**
@@ -83,6 +104,29 @@ wbtr_read_vref(
 merr_t
 wbti_alloc(struct wbti **wbti_out);
 
+/**
+ * wbt_leaf_expand() - Expand an LFC leaf node
+ * @node:  leaf node (WBT_LFC_NODE_MAGIC)
+ * @xnode: buffer of WBT_LFX_NODE_SIZE bytes
+ *
+ * Rebuilds @node in @xnode with the layout of an LFE leaf node (but with
+ * magic WBT_LFX_NODE_MAGIC), such that it can be searched with wbt_lfe()
+ * and wbt_lfe_key().
+ *
+ * Return: EPROTO if @node is malformed.
+ */
+merr_t
+wbt_leaf_expand(const struct wbt_node_hdr_omf *node, void *xnode);
+
+/**
+ * wbt_leaf_first_key() - Decode the first key of an LFC leaf node
+ * @node: leaf node (WBT_LFC_NODE_MAGIC)
+ * @kbuf: buffer of HSE_KVS_KEY_LEN_MAX bytes
+ * @klen: (output) key length
+ */
+merr_t
+wbt_leaf_first_key(const struct wbt_node_hdr_omf *node, void *kbuf, uint *klen);
+
 /**
  * wbti_reset() - Reset the fields of a wbtree iterator.
  * @wbti: wbt iterator
@@ -90,16 +134,19 @@ wbti_alloc(struct wbti **wbti_out);
  * @wbd:  wbtree descriptor
  * @seek: if set, first key in iterator
  * @reverse: whether to iterate backwards
- * @cache: whether to cache wbt node values
+ * @readahead: whether a reverse iterator advises the leaf nodes below it
+ *             (and their kmd pages) ahead of use
+ *
+ * Return: ENOMEM if an expansion buffer for LFC leaf nodes cannot be allocated.
  */
-void
+merr_t
 wbti_reset(
     struct wbti *self,
     const void *base,
     struct wbt_desc *desc,
     struct kvs_ktuple *seek,
     bool reverse,
-    bool cache);
+    bool readahead);
 
 /**
  * wbti_create() - Create a wbtree iterator
@@ -108,7 +155,8 @@ wbti_reset(
  * @wbd:  wbtree descriptor
  * @seek: if set, first key in iterator
  * @reverse: whether to iterate backwards
- * @cache: whether to cache wbt node values
+ * @readahead: whether a reverse iterator advises the leaf nodes below it
+ *             (and their kmd pages) ahead of use
  */
 /* MTF_MOCK */
 merr_t
@@ -118,7 +166,7 @@ wbti_create(
     struct wbt_desc *wbd,
     struct kvs_ktuple *seek,
     bool reverse,
-    bool cache);
+    bool readahead);
 
 /**
  * wbti_destroy() - Destroy a wbtree iterator. Does not
@@ -161,6 +209,28 @@ wbt_read_kmd_vref(
     uint64_t *seq,
     struct kvs_vtuple_ref *vref);
 
+/**
+ * wbtr_fence_create() - Build an in-memory fence index for a wbtree
+ * @base: base address of the block
+ * @wbd:  wbtree descriptor (fence index is attached to @wbd->wbd_fence)
+ *
+ * The fence index holds the leading eight bytes of each leaf node's upper
+ * bound key in a dense array, built by walking only the internal nodes.
+ * Point lookups binary search this array to predict the target leaf
+ * directly, and fall back to descending the wbtree when the prediction
+ * is ambiguous (i.e., the search key and a fence share the same leading
+ * eight bytes).
+ */
+merr_t
+wbtr_fence_create(const void *base, struct wbt_desc *wbd);
+
+/**
+ * wbtr_fence_destroy() - Free a wbtree's fence index
+ * @wbd:  wbtree descriptor
+ */
+void
+wbtr_fence_destroy(struct wbt_desc *wbd);
+
 merr_t
 wbti_init(void);
 void
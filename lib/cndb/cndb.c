@@ -11,6 +11,7 @@
 #include <hse/ikvdb/cndb.h>
 #include <hse/ikvdb/ikvdb.h>
 #include <hse/ikvdb/kvdb_rparams.h>
+#include <hse/ikvdb/omf_version.h>
 #include <hse/logging/logging.h>
 #include <hse/util/alloc.h>
 #include <hse/util/event_counter.h>
@@ -23,9 +24,19 @@
 #include "omf.h"
 #include "txn.h"
 
+/**
+ * struct cndb_rtomb - a range tombstone (keyed by its seqno in rtomb_map)
+ */
+struct cndb_rtomb {
+    uint32_t cr_slen;
+    uint32_t cr_elen;
+    uint8_t cr_keys[];
+};
+
 struct cndb_cn {
     uint64_t cnid;
     struct map *kvset_map;
+    struct map *rtomb_map;
     struct kvs_cparams cp;
     char name[HSE_KVS_NAME_LEN_MAX];
 };
@@ -180,14 +191,20 @@ static void
 cndb_cn_destroy(uint64_t key, uintptr_t val)
 {
     struct cndb_cn *cn = (void *)val;
+    struct cndb_rtomb *rtomb;
     struct cndb_kvset *kvset;
-    struct map_iter kvset_iter;
+    struct map_iter iter;
 
-    map_iter_init(&kvset_iter, cn->kvset_map);
-    while (map_iter_next_val(&kvset_iter, &kvset))
+    map_iter_init(&iter, cn->kvset_map);
+    while (map_iter_next_val(&iter, &kvset))
         free(kvset);
 
+    map_iter_init(&iter, cn->rtomb_map);
+    while (map_iter_next_val(&iter, &rtomb))
+        free(rtomb);
+
     map_destroy(cn->kvset_map);
+    map_destroy(cn->rtomb_map);
     free(cn);
 }
 
@@ -316,7 +333,10 @@ cndb_record_kvs_add_inner(
     strlcpy(cn->name, name, NELEM(cn->name));
 
     cn->kvset_map = map_create(HSE_KVS_COUNT_MAX);
-    if (ev(!cn->kvset_map)) {
+    cn->rtomb_map = map_create(0);
+    if (ev(!cn->kvset_map || !cn->rtomb_map)) {
+        map_destroy(cn->kvset_map);
+        map_destroy(cn->rtomb_map);
         free(cn);
         return merr(ENOMEM);
     }
@@ -346,6 +366,8 @@ out:
 
     if (err) {
         map_remove(cndb->cn_map, cn->cnid, NULL);
+        map_destroy(cn->kvset_map);
+        map_destroy(cn->rtomb_map);
         free(cn);
     }
 
@@ -632,6 +654,106 @@ cndb_record_kvsetv_move(
     return err;
 }
 
+merr_t
+cndb_record_rtomb_add(
+    struct cndb *cndb,
+    uint64_t cnid,
+    uint64_t seqno,
+    const void *start,
+    uint32_t slen,
+    const void *end,
+    uint32_t elen)
+{
+    struct cndb_rtomb *rtomb;
+    struct cndb_cn *cn;
+    merr_t err = 0;
+
+    rtomb = malloc(sizeof(*rtomb) + slen + elen);
+    if (ev(!rtomb))
+        return merr(ENOMEM);
+
+    rtomb->cr_slen = slen;
+    rtomb->cr_elen = elen;
+    memcpy(rtomb->cr_keys, start, slen);
+    memcpy(rtomb->cr_keys + slen, end, elen);
+
+    mutex_lock(&cndb->mutex);
+    do {
+        cn = map_lookup_ptr(cndb->cn_map, cnid);
+        if (!cn) {
+            err = merr(EPROTO);
+            break;
+        }
+
+        if (!cndb->replaying) {
+            if (cndb_needs_compaction(cndb)) {
+                err = cndb_compact(cndb);
+                if (err)
+                    break;
+            }
+
+            err = cndb_omf_rtomb_add_write(cndb->mdc, cnid, seqno, start, slen, end, elen);
+            if (err)
+                break;
+        }
+
+        err = map_insert_ptr(cn->rtomb_map, seqno, rtomb);
+        if (err)
+            break;
+
+        rtomb = NULL;
+
+        /* The seqno of the tombstone must not be reused after a restart.
+         */
+        cndb->seqno_max = seqno > cndb->seqno_max ? seqno : cndb->seqno_max;
+    } while (0);
+    mutex_unlock(&cndb->mutex);
+
+    free(rtomb);
+
+    return err;
+}
+
+merr_t
+cndb_record_rtomb_del(struct cndb *cndb, uint64_t cnid, uint64_t seqno)
+{
+    struct cndb_rtomb *rtomb = NULL;
+    struct cndb_cn *cn;
+    merr_t err = 0;
+
+    mutex_lock(&cndb->mutex);
+    do {
+        cn = map_lookup_ptr(cndb->cn_map, cnid);
+        if (!cn) {
+            err = merr(EPROTO);
+            break;
+        }
+
+        rtomb = map_remove_ptr(cn->rtomb_map, seqno);
+        if (!rtomb) {
+            err = merr(EPROTO);
+            break;
+        }
+
+        if (!cndb->replaying) {
+            if (cndb_needs_compaction(cndb)) {
+                err = cndb_compact(cndb);
+                if (err)
+                    break;
+            }
+
+            err = cndb_omf_rtomb_del_write(cndb->mdc, cnid, seqno);
+            if (err)
+                break;
+        }
+    } while (0);
+    mutex_unlock(&cndb->mutex);
+
+    free(rtomb);
+
+    return err;
+}
+
 static merr_t
 process_finished_add_txn_cb(
     struct cndb_txn *tx,
@@ -864,11 +986,14 @@ write_compacted_log(struct cndb *cndb)
 
     map_iter_init(&cniter, cndb->cn_map);
 
-    /* For each cn in cndb, write a kvs_add record followed by all the kvsets of that cn.
+    /* For each cn in cndb, write a kvs_add record followed by all the kvsets and
+     * range tombstones of that cn.
      */
     while (!err && map_iter_next_val(&cniter, &cn)) {
-        struct map_iter kvset_iter;
+        struct map_iter kvset_iter, rtomb_iter;
         struct cndb_kvset *kvset;
+        struct cndb_rtomb *rtomb;
+        uint64_t seqno;
 
         err = cndb_omf_kvs_add_write(cndb->mdc, cn->cnid, &cn->cp, cn->name);
         if (ev(err))
@@ -881,6 +1006,16 @@ write_compacted_log(struct cndb *cndb)
             if (ev(err))
                 return err;
         }
+
+        map_iter_init(&rtomb_iter, cn->rtomb_map);
+
+        while (map_iter_next(&rtomb_iter, &seqno, (uintptr_t *)&rtomb)) {
+            err = cndb_omf_rtomb_add_write(
+                cndb->mdc, cn->cnid, seqno, rtomb->cr_keys, rtomb->cr_slen,
+                rtomb->cr_keys + rtomb->cr_slen, rtomb->cr_elen);
+            if (ev(err))
+                return err;
+        }
     }
 
     return 0;
@@ -943,6 +1078,25 @@ cndb_compact(struct cndb *cndb)
     return mpool_mdc_cend(cndb->mdc);
 }
 
+merr_t
+cndb_checkpoint(struct cndb *cndb, const char *paths[HSE_MCLASS_COUNT])
+{
+    merr_t err;
+
+    /* The cndb lock is held only while the MDC is compacted and cloned,
+     * the data files are cloned afterwards by the caller.
+     */
+    mutex_lock(&cndb->mutex);
+
+    err = cndb_compact(cndb);
+    if (!err)
+        err = mpool_mdc_checkpoint(cndb->mp, cndb->oid1, cndb->oid2, paths);
+
+    mutex_unlock(&cndb->mutex);
+
+    return err;
+}
+
 /* Replay */
 
 struct cndb_reader {
@@ -1013,7 +1167,7 @@ cndb_read_record(struct cndb *cndb, struct cndb_reader *reader)
         uint32_t magic;
 
         cndb_omf_ver_read(reader->recbuf, &magic, &cndb->cndb_version, &cndb->cndb_captgt);
-        if (magic != CNDB_MAGIC)
+        if (magic != CNDB_MAGIC || cndb->cndb_version > CNDB_VERSION)
             err = merr(EPROTO);
 
     } else if (rec_type == CNDB_TYPE_META) {
@@ -1107,6 +1261,24 @@ cndb_read_record(struct cndb *cndb, struct cndb_reader *reader)
 
         err = cndb_record_nak(cndb, txid2tx(cndb, txid));
         ev(err);
+
+    } else if (rec_type == CNDB_TYPE_RTOMB_ADD) {
+        uint64_t cnid, seqno;
+        const void *start, *end;
+        uint32_t slen, elen;
+
+        cndb_omf_rtomb_add_read(reader->recbuf, &cnid, &seqno, &start, &slen, &end, &elen);
+
+        err = cndb_record_rtomb_add(cndb, cnid, seqno, start, slen, end, elen);
+        ev(err);
+
+    } else if (rec_type == CNDB_TYPE_RTOMB_DEL) {
+        uint64_t cnid, seqno;
+
+        cndb_omf_rtomb_del_read(reader->recbuf, &cnid, &seqno);
+
+        err = cndb_record_rtomb_del(cndb, cnid, seqno);
+        ev(err);
     } else {
         assert(0);
         return merr(EPROTO);
@@ -1448,6 +1620,32 @@ cndb_cn_instantiate(struct cndb *cndb, uint64_t cnid, void *ctx, cn_init_callbac
     return 0;
 }
 
+merr_t
+cndb_cn_rtombs(struct cndb *cndb, uint64_t cnid, void *ctx, cn_rtomb_callback *cb)
+{
+    struct cndb_cn *cn = map_lookup_ptr(cndb->cn_map, cnid);
+    struct cndb_rtomb *rtomb;
+    struct map_iter rtomb_iter;
+    uint64_t seqno;
+
+    if (ev(!cn))
+        return merr(EINVAL);
+
+    map_iter_init(&rtomb_iter, cn->rtomb_map);
+
+    while (map_iter_next(&rtomb_iter, &seqno, (uintptr_t *)&rtomb)) {
+        merr_t err;
+
+        err = cb(
+            ctx, seqno, rtomb->cr_keys, rtomb->cr_slen, rtomb->cr_keys + rtomb->cr_slen,
+            rtomb->cr_elen);
+        if (ev(err))
+            return err;
+    }
+
+    return 0;
+}
+
 merr_t
 cndb_kvset_delete(struct cndb *cndb, uint64_t cnid, uint64_t kvsetid)
 {
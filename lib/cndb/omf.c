@@ -262,6 +262,51 @@ cndb_omf_nak_write(struct mpool_mdc *mdc, uint64_t txid)
     return mpool_mdc_append(mdc, &omf, sizeof(omf), true);
 }
 
+merr_t
+cndb_omf_rtomb_add_write(
+    struct mpool_mdc *mdc,
+    uint64_t cnid,
+    uint64_t seqno,
+    const void *start,
+    uint32_t slen,
+    const void *end,
+    uint32_t elen)
+{
+    struct cndb_rtomb_add_omf *omf;
+    uint8_t buf[sizeof(*omf) + 2 * HSE_KVS_KEY_LEN_MAX];
+    size_t sz;
+
+    assert(slen <= HSE_KVS_KEY_LEN_MAX && elen <= HSE_KVS_KEY_LEN_MAX);
+
+    omf = (void *)buf;
+    sz = sizeof(*omf) + slen + elen;
+
+    cndb_hdr_omf_init(&omf->hdr, CNDB_TYPE_RTOMB_ADD, sz);
+
+    omf_set_rtomb_add_cnid(omf, cnid);
+    omf_set_rtomb_add_seqno(omf, seqno);
+    omf_set_rtomb_add_slen(omf, slen);
+    omf_set_rtomb_add_elen(omf, elen);
+
+    memcpy(omf + 1, start, slen);
+    memcpy((uint8_t *)(omf + 1) + slen, end, elen);
+
+    return mpool_mdc_append(mdc, omf, sz, true);
+}
+
+merr_t
+cndb_omf_rtomb_del_write(struct mpool_mdc *mdc, uint64_t cnid, uint64_t seqno)
+{
+    struct cndb_rtomb_del_omf omf;
+
+    cndb_hdr_omf_init(&omf.hdr, CNDB_TYPE_RTOMB_DEL, sizeof(omf));
+
+    omf_set_rtomb_del_cnid(&omf, cnid);
+    omf_set_rtomb_del_seqno(&omf, seqno);
+
+    return mpool_mdc_append(mdc, &omf, sizeof(omf), true);
+}
+
 /*
  * OMF Read functions
  */
@@ -428,3 +473,28 @@ cndb_omf_nak_read(struct cndb_nak_omf *omf, uint64_t *txid)
 {
     *txid = omf_nak_txid(omf);
 }
+
+void
+cndb_omf_rtomb_add_read(
+    struct cndb_rtomb_add_omf *omf,
+    uint64_t *cnid,
+    uint64_t *seqno,
+    const void **start,
+    uint32_t *slen,
+    const void **end,
+    uint32_t *elen)
+{
+    *cnid = omf_rtomb_add_cnid(omf);
+    *seqno = omf_rtomb_add_seqno(omf);
+    *slen = omf_rtomb_add_slen(omf);
+    *elen = omf_rtomb_add_elen(omf);
+    *start = omf + 1;
+    *end = (uint8_t *)(omf + 1) + *slen;
+}
+
+void
+cndb_omf_rtomb_del_read(struct cndb_rtomb_del_omf *omf, uint64_t *cnid, uint64_t *seqno)
+{
+    *cnid = omf_rtomb_del_cnid(omf);
+    *seqno = omf_rtomb_del_seqno(omf);
+}
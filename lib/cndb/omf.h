@@ -37,6 +37,8 @@ struct kvs_cparams;
  * CNDB_TYPE_KVSET_DEL: Delete a kvset.
  * CNDB_TYPE_ACK:       Acknowledge a CNDB_TYPE_KVSET_ADD or a CNDB_TYPE_KVSET_DEL record.
  * CNDB_TYPE_NAK:       Abort transaction.
+ * CNDB_TYPE_RTOMB_ADD: Add a range tombstone to a KVS.
+ * CNDB_TYPE_RTOMB_DEL: Retire a range tombstone.
  */
 enum cndb_rec_type {
     CNDB_TYPE_VERSION = 1,
@@ -49,8 +51,10 @@ enum cndb_rec_type {
     CNDB_TYPE_KVSET_MOVE = 8,
     CNDB_TYPE_ACK = 9,
     CNDB_TYPE_NAK = 10,
+    CNDB_TYPE_RTOMB_ADD = 11,
+    CNDB_TYPE_RTOMB_DEL = 12,
 
-    CNDB_TYPE_CNT = 10,
+    CNDB_TYPE_CNT = 12,
 };
 
 /**
@@ -294,6 +298,46 @@ struct cndb_nak_omf {
 
 OMF_SETGET(struct cndb_nak_omf, nak_txid, 64);
 
+/**
+ * struct cndb_rtomb_add_omf
+ *
+ * An RTOMB_ADD record persists a range tombstone, which deletes every key in
+ * [start, end) with a seqno less than that of the tombstone.
+ *
+ * @rtomb_add_cnid:  KVS of the tombstone
+ * @rtomb_add_seqno: seqno of the tombstone
+ * @rtomb_add_slen:  start key length
+ * @rtomb_add_elen:  end key length
+ */
+struct cndb_rtomb_add_omf {
+    struct cndb_hdr_omf hdr;
+    uint64_t rtomb_add_cnid;
+    uint64_t rtomb_add_seqno;
+    uint32_t rtomb_add_slen;
+    uint32_t rtomb_add_elen;
+    /* the start key followed by the end key appears here */
+} HSE_PACKED;
+
+OMF_SETGET(struct cndb_rtomb_add_omf, rtomb_add_cnid, 64);
+OMF_SETGET(struct cndb_rtomb_add_omf, rtomb_add_seqno, 64);
+OMF_SETGET(struct cndb_rtomb_add_omf, rtomb_add_slen, 32);
+OMF_SETGET(struct cndb_rtomb_add_omf, rtomb_add_elen, 32);
+
+/**
+ * struct cndb_rtomb_del_omf
+ *
+ * An RTOMB_DEL record retires a range tombstone once no data it deletes
+ * remains in the KVS.
+ */
+struct cndb_rtomb_del_omf {
+    struct cndb_hdr_omf hdr;
+    uint64_t rtomb_del_cnid;
+    uint64_t rtomb_del_seqno;
+} HSE_PACKED;
+
+OMF_SETGET(struct cndb_rtomb_del_omf, rtomb_del_cnid, 64);
+OMF_SETGET(struct cndb_rtomb_del_omf, rtomb_del_seqno, 64);
+
 /*
  * OMF Write functions
  */
@@ -366,6 +410,19 @@ cndb_omf_ack_write(
 merr_t
 cndb_omf_nak_write(struct mpool_mdc *mdc, uint64_t txid);
 
+merr_t
+cndb_omf_rtomb_add_write(
+    struct mpool_mdc *mdc,
+    uint64_t cnid,
+    uint64_t seqno,
+    const void *start,
+    uint32_t slen,
+    const void *end,
+    uint32_t elen);
+
+merr_t
+cndb_omf_rtomb_del_write(struct mpool_mdc *mdc, uint64_t cnid, uint64_t seqno);
+
 /*
  * OMF Read functions
  */
@@ -442,4 +499,17 @@ cndb_omf_ack_read(
 void
 cndb_omf_nak_read(struct cndb_nak_omf *omf, uint64_t *txid);
 
+void
+cndb_omf_rtomb_add_read(
+    struct cndb_rtomb_add_omf *omf,
+    uint64_t *cnid,
+    uint64_t *seqno,
+    const void **start,
+    uint32_t *slen,
+    const void **end,
+    uint32_t *elen);
+
+void
+cndb_omf_rtomb_del_read(struct cndb_rtomb_del_omf *omf, uint64_t *cnid, uint64_t *seqno);
+
 #endif /* HSE_KVS_CNDB_OMF_H */
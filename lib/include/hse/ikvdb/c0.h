@@ -12,6 +12,7 @@
 #include <hse/error/merr.h>
 #include <hse/ikvdb/cursor.h>
 #include <hse/ikvdb/ikvdb.h>
+#include <hse/ikvdb/kvs.h>
 #include <hse/util/mutex.h>
 
 #define CURSOR_FLAG_SEQNO_CHANGE   1
@@ -21,6 +22,7 @@
 
 struct c0;
 struct c0_cursor;
+struct c0_merge_ver;
 struct cn;
 
 struct query_ctx;
@@ -101,6 +103,65 @@ c0_get_pfx_len(struct c0 *c0);
 merr_t
 c0_put(struct c0 *self, struct kvs_ktuple *key, const struct kvs_vtuple *value, uintptr_t seqnoref);
 
+/**
+ * c0_write_batch() - insert a batch of puts and deletes into the struct c0
+ * @self:      Instance of struct c0 into which to insert
+ * @opv:       Vector of ops, applied in order
+ * @cnt:       Number of elements in @opv (at most HSE_C0SK_BATCH_MAX)
+ * @seqnoref:  seqnoref for insertion
+ *
+ * See c0sk_write_batch().
+ *
+ * Return: [HSE_REVISIT]
+ */
+/* MTF_MOCK */
+merr_t
+c0_write_batch(struct c0 *self, struct kvs_batch_op *opv, uint cnt, uintptr_t seqnoref);
+
+/**
+ * c0_merge_read() - read the value of a key for a merge
+ * @self:      Instance of struct c0
+ * @key:       Key
+ * @genp:      Required kvms gen or zero for any, gen read from (output)
+ * @curbuf:    Buffer for the key's current value
+ * @res:       State of the key in the active kvms (output)
+ * @ver:       Version of the key (output)
+ *
+ * See c0sk_merge_read().
+ *
+ * Return: [HSE_REVISIT]
+ */
+/* MTF_MOCK */
+merr_t
+c0_merge_read(
+    struct c0 *self,
+    const struct kvs_ktuple *key,
+    uint64_t *genp,
+    struct kvs_buf *curbuf,
+    enum key_lookup_res *res,
+    struct c0_merge_ver *ver);
+
+/**
+ * c0_merge_commit() - insert the merged value of a key
+ * @self:      Instance of struct c0
+ * @key:       Key
+ * @value:     Merged value
+ * @seqnoref:  seqnoref for insertion
+ * @ver:       Version of the key returned by c0_merge_read()
+ *
+ * See c0sk_merge_commit().
+ *
+ * Return: [HSE_REVISIT]
+ */
+/* MTF_MOCK */
+merr_t
+c0_merge_commit(
+    struct c0 *self,
+    struct kvs_ktuple *key,
+    const struct kvs_vtuple *value,
+    uintptr_t seqnoref,
+    const struct c0_merge_ver *ver);
+
 /**
  * c0_get() - retrieve the value associated with the given key,
  *            no newer than seqno
@@ -109,6 +170,7 @@ c0_put(struct c0 *self, struct kvs_ktuple *key, const struct kvs_vtuple *value,
  * @seqno:     Seqno to use for get
  * @res:       Status of lookup
  * @vbuf:      Ptr to callers buffer
+ * @seqnop:    Seqno of the value found (may be NULL)
  *
  * Return: [HSE_REVISIT]
  */
@@ -120,7 +182,8 @@ c0_get(
     uint64_t view_seqno,
     uintptr_t seqnoref,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf);
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop);
 
 /**
  * c0_del() - delete any value associated with the given key
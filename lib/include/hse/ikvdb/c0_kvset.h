@@ -143,6 +143,77 @@ c0kvs_put(
     const struct kvs_vtuple *value,
     uintptr_t seqnoref);
 
+/**
+ * c0kvs_write_batch() - insert a group of puts and deletes under one lock
+ * @set:      Struct c0_kvset to insert into
+ * @skidx:    Structured key index
+ * @opv:      Vector of ops, applied in order
+ * @cnt:      Number of elements in @opv
+ * @seqnoref: seqnoref for all ops
+ * @donep:    Number of ops inserted (output)
+ *
+ * Equivalent to calling c0kvs_put() or c0kvs_del() for each op, but the
+ * c0_kvset is locked just once for the whole group.  Stops at the first
+ * error, in which case only the first *@donep ops have been inserted.
+ *
+ * Return: [HSE_REVISIT]
+ */
+merr_t
+c0kvs_write_batch(
+    struct c0_kvset *set,
+    uint16_t skidx,
+    struct kvs_batch_op **opv,
+    uint cnt,
+    uintptr_t seqnoref,
+    uint *donep);
+
+/**
+ * c0kvs_merge_read() - read the current value of a key to be merged
+ * @set:       Struct c0_kvset holding the key
+ * @skidx:     Structured key index
+ * @key:       Key
+ * @curbuf:    buffer to receive the key's current value
+ * @res:       lookup result (output)
+ * @oseqnoref: seqnoref of the key's current value (output)
+ * @verp:      version of the key, see c0kvs_merge_commit() (output)
+ *
+ * Return: [HSE_REVISIT]
+ */
+merr_t
+c0kvs_merge_read(
+    struct c0_kvset *set,
+    uint16_t skidx,
+    const struct kvs_ktuple *key,
+    struct kvs_buf *curbuf,
+    enum key_lookup_res *res,
+    uintptr_t *oseqnoref,
+    const void **verp);
+
+/**
+ * c0kvs_merge_commit() - insert the merged value of a key
+ * @set:      Struct c0_kvset holding the key
+ * @skidx:    Structured key index
+ * @key:      Key
+ * @value:    merged value
+ * @seqnoref: seqnoref for insertion
+ * @ver:      version of the key returned by c0kvs_merge_read()
+ *
+ * The value is inserted only if the key has not been updated since it was
+ * read by c0kvs_merge_read(), which requires that the c0_kvset's kvms has
+ * not been destroyed in the meantime.  Values are never freed before their
+ * kvms, so a value's address identifies it for the life of the kvms.
+ *
+ * Return: ECANCELED if the key has been updated, [HSE_REVISIT] otherwise
+ */
+merr_t
+c0kvs_merge_commit(
+    struct c0_kvset *set,
+    uint16_t skidx,
+    struct kvs_ktuple *key,
+    const struct kvs_vtuple *value,
+    uintptr_t seqnoref,
+    const void *ver);
+
 /**
  * c0kvs_del() - delete the key/value pair matching the given key
  * @set:   Struct c0_kvset to delete the key/value from
@@ -283,6 +354,25 @@ c0kvs_prefix_get_rcu(
     uint32_t pfx_len,
     uintptr_t *oseqnoref);
 
+/**
+ * c0kvs_prefix_ver_rcu() - return the version of a key's prefix tombstone
+ * @handle:    Struct c0_kvset holding the prefix tombstones
+ * @skidx:     Structured key index
+ * @key:       Key
+ * @pfx_len:   Prefix length
+ *
+ * Like c0kvs_merge_read(), but for the newest prefix tombstone covering the
+ * key.  Caller must be within an rcu read-side critical section.
+ *
+ * Return: prefix tombstone version (NULL if there is none)
+ */
+const void *
+c0kvs_prefix_ver_rcu(
+    struct c0_kvset *handle,
+    uint16_t skidx,
+    const struct kvs_ktuple *key,
+    uint32_t pfx_len);
+
 void
 c0kvs_prefix_get_excl(
     struct c0_kvset *handle,
@@ -31,6 +31,9 @@ struct query_ctx;
 struct kvdb_ctxn_set;
 struct kvdb_callback;
 
+/* Maximum number of ops in one call to c0sk_write_batch() */
+#define HSE_C0SK_BATCH_MAX (256)
+
 merr_t
 c0sk_init(void);
 
@@ -169,6 +172,7 @@ c0sk_put(
  * @seqref:    Caller's sequence number reference (may be 0)
  * @res:       Status of lookup
  * @vbuf:      Ptr to callers buffer
+ * @seqnop:    Seqno of the value found (may be NULL)
  *
  * Return: [HSE_REVISIT]
  */
@@ -182,7 +186,108 @@ c0sk_get(
     uint64_t view_seq,
     uintptr_t seqref,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf);
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop);
+
+/**
+ * c0sk_write_batch() - insert a batch of non-transactional puts and deletes
+ * @self:      Instance of struct c0sk into which to insert
+ * @skidx:     Structured key index
+ * @opv:       Vector of ops, applied in order
+ * @cnt:       Number of elements in @opv (at most HSE_C0SK_BATCH_MAX)
+ * @seqnoref:  seqnoref for insertion
+ *
+ * All ops are inserted into the active kvms in a single pass: the ops are
+ * grouped by the c0_kvset they hash to and each c0_kvset is locked once.
+ * On return, the kt_dgen of each op that was inserted is set to the gen of
+ * the kvms it was inserted into, and is zero for ops that were not.
+ *
+ * Return: [HSE_REVISIT]
+ */
+/* MTF_MOCK */
+merr_t
+c0sk_write_batch(
+    struct c0sk *self,
+    uint16_t skidx,
+    struct kvs_batch_op *opv,
+    uint cnt,
+    uintptr_t seqnoref);
+
+/**
+ * struct c0_merge_ver - version of a key read by c0sk_merge_read()
+ * @mv_gen:   gen of the active kvms the key was read from
+ * @mv_val:   the key's newest value in that kvms (NULL if none)
+ * @mv_ptomb: the newest prefix tombstone covering the key in that kvms
+ *            (NULL if none)
+ */
+struct c0_merge_ver {
+    uint64_t    mv_gen;
+    const void *mv_val;
+    const void *mv_ptomb;
+};
+
+/**
+ * c0sk_merge_read() - read the value of a key in the active kvms for a merge
+ * @self:      Instance of struct c0sk
+ * @skidx:     Structured key index
+ * @pfx_len:   Prefix length of the kvs
+ * @key:       Key
+ * @genp:      Required kvms gen or zero for any (input), gen of the kvms the
+ *             key was read from (output)
+ * @curbuf:    Buffer for the key's current value
+ * @res:       State of the key in the active kvms (output), one of NOT_FOUND,
+ *             FOUND_VAL, FOUND_TMB or FOUND_PTMB
+ * @ver:       Version of the key to pass to c0sk_merge_commit() (output)
+ *
+ * Only the active kvms is consulted.  If the key has neither a value nor a
+ * tombstone there, it is up to the caller to look up the value in older data
+ * and read again with the gen returned in @genp, which fails with EAGAIN if
+ * the active kvms has changed in the meantime.
+ *
+ * No locks are held on return, so the caller is free to compute the merged
+ * value and log it to the wal before committing it to c0.
+ *
+ * Return: [HSE_REVISIT]
+ */
+/* MTF_MOCK */
+merr_t
+c0sk_merge_read(
+    struct c0sk *self,
+    uint16_t skidx,
+    uint32_t pfx_len,
+    const struct kvs_ktuple *key,
+    uint64_t *genp,
+    struct kvs_buf *curbuf,
+    enum key_lookup_res *res,
+    struct c0_merge_ver *ver);
+
+/**
+ * c0sk_merge_commit() - insert the merged value of a key into the active kvms
+ * @self:      Instance of struct c0sk
+ * @skidx:     Structured key index
+ * @pfx_len:   Prefix length of the kvs
+ * @key:       Key
+ * @value:     Merged value
+ * @seqnoref:  seqnoref for insertion
+ * @ver:       Version of the key returned by c0sk_merge_read()
+ *
+ * The value is inserted only if neither the key nor its prefix has been
+ * updated since @ver was read.
+ *
+ * Return: ECANCELED if the key or its prefix has been updated, in which
+ * case the merge may be retried from c0sk_merge_read(), EAGAIN if the active
+ * kvms has changed, [HSE_REVISIT] otherwise
+ */
+/* MTF_MOCK */
+merr_t
+c0sk_merge_commit(
+    struct c0sk *self,
+    uint16_t skidx,
+    uint32_t pfx_len,
+    struct kvs_ktuple *key,
+    const struct kvs_vtuple *value,
+    uintptr_t seqnoref,
+    const struct c0_merge_ver *ver);
 
 /**
  * c0sk_del() - delete any value associated with the given key
@@ -14,6 +14,7 @@
 #include <hse/ikvdb/kvs_cparams.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/util/atomic.h>
 #include <hse/util/workqueue.h>
 
 /* MTF_MOCK_DECL(cn) */
@@ -21,6 +22,7 @@
 #define CN_CFLAG_CAPPED (1 << 0)
 
 struct cn;
+struct cn_bulk;
 struct cn_kvdb;
 struct cndb;
 struct mpool;
@@ -103,6 +105,13 @@ cn_disable_maint(struct cn *handle, bool onoff);
 /*
  * Note: Tombstones indicated by:
  *     return value == hse_success && res == FOUND_TOMB
+ *
+ * If @rcgen is non-zero the row cache is searched before the cn tree, and
+ * a value found in the tree is added to the row cache.  @rcgen must have
+ * been obtained by cn_rcache_gen() before the key was searched for in c0.
+ *
+ * If @direct is true, vblock values are read from media (pread or io_uring)
+ * instead of being faulted in through the mcache maps.
  */
 /* MTF_MOCK */
 merr_t
@@ -110,9 +119,101 @@ cn_get(
     struct cn *cn,
     struct kvs_ktuple *kt,
     uint64_t seq,
+    uint64_t rcgen,
+    bool direct,
     enum key_lookup_res *res,
     struct kvs_buf *vbuf);
 
+/*
+ * Sample the row cache generation of a key for a subsequent cn_get().
+ * Returns zero if the kvs has no row cache.
+ */
+/* MTF_MOCK */
+uint64_t
+cn_rcache_gen(struct cn *cn, const struct kvs_ktuple *kt);
+
+/*
+ * Drop the cached row of a key.  Must be called after every update of the
+ * key has been inserted into c0.
+ */
+/* MTF_MOCK */
+void
+cn_rcache_invalidate(struct cn *cn, const struct kvs_ktuple *kt);
+
+/*
+ * Drop all cached rows.  Must be called after updates that may affect more
+ * than one key (e.g., prefix deletes) have been inserted into c0.
+ */
+/* MTF_MOCK */
+void
+cn_rcache_purge(struct cn *cn);
+
+/*
+ * Batched variant of cn_get(). Only keys whose result is NOT_FOUND on
+ * entry are searched, so results from c0 and lc are preserved.
+ */
+/* MTF_MOCK */
+merr_t
+cn_get_multi(
+    struct cn *cn,
+    uint cnt,
+    struct kvs_ktuple *ktv,
+    uint64_t seq,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv);
+
+struct key_obj;
+struct rtomb_set;
+
+/**
+ * cn_range_delete() - delete the keys of a range which are visible now
+ * @cn:         cn handle
+ * @kt_start:   start key (inclusive)
+ * @kt_end:     end key (exclusive)
+ * @kvdb_seqno: kvdb seqno counter, from which the tombstone gets its seqno
+ *
+ * Adds a range tombstone which deletes every version of every key in the
+ * range whose seqno is less than the seqno of the tombstone, in c0 as well
+ * as in cn.  Keys put after the call returns are not affected.  The
+ * tombstone is persisted in the cndb, and is retired by compaction once
+ * none of the data it deletes remains.
+ *
+ * Return: ENOSPC if the cn has too many outstanding range tombstones.
+ */
+/* MTF_MOCK */
+merr_t
+cn_range_delete(
+    struct cn *cn,
+    const struct kvs_ktuple *kt_start,
+    const struct kvs_ktuple *kt_end,
+    atomic_ulong *kvdb_seqno);
+
+/*
+ * Get a reference on the set of range tombstones of a cn, or NULL if it
+ * has none.  Must be called after the caller's view seqno has been read.
+ */
+/* MTF_MOCK */
+struct rtomb_set *
+cn_rtombs_get(struct cn *cn);
+
+/* Drop a reference obtained by cn_rtombs_get() (@set may be NULL). */
+void
+cn_rtombs_put(struct rtomb_set *set);
+
+/*
+ * Get the seqno below which the versions of a key are deleted by the range
+ * tombstones in view @view, or zero if there are none (@set may be NULL).
+ */
+uint64_t
+cn_rtomb_floor(struct rtomb_set *set, const struct key_obj *kobj, uint64_t view);
+
+/*
+ * Check whether a range tombstone in view @view may delete keys with the
+ * given prefix (@set may be NULL).
+ */
+bool
+cn_rtomb_overlaps_pfx(struct rtomb_set *set, const void *pfx, uint plen, uint64_t view);
+
 struct query_ctx;
 
 merr_t
@@ -125,6 +226,23 @@ cn_pfx_probe(
     struct kvs_buf *kbuf,
     struct kvs_buf *vbuf);
 
+/**
+ * cn_split_keys() - propose keys which split a key range of a cn into parts
+ * holding roughly equal numbers of keys
+ *
+ * See cn_tree_split_keys().
+ */
+uint
+cn_split_keys(
+    struct cn *cn,
+    const void *min,
+    uint minlen,
+    const void *max,
+    uint maxlen,
+    uint splitc,
+    void *keyv,
+    uint *klenv);
+
 /**
  * cn_ingestv() - A vectored version of cn_ingest
  * @cn:
@@ -147,6 +265,68 @@ cn_ingestv(
     uint64_t *min_seqno_out,
     uint64_t *max_seqno_out);
 
+/**
+ * cn_bulk_create() - start a bulk load of sorted key/value pairs into a cn
+ * @cn:    cn to load
+ * @seqno: seqno given to every value of the load
+ * @bulkp: bulk load handle (output)
+ *
+ * A bulk load streams keys in strictly ascending order straight into kvset
+ * builders, bypassing the wal, c0 and c0 ingest.  The resulting kvsets are
+ * linked into the root node of the cn tree by cn_bulk_commit(), after which
+ * they are spilled into the leaves like any ingested kvset.  Not supported
+ * for capped kvs.
+ */
+/* MTF_MOCK */
+merr_t
+cn_bulk_create(struct cn *cn, uint64_t seqno, struct cn_bulk **bulkp);
+
+/**
+ * cn_bulk_add() - add a key/value pair to a bulk load
+ * @bulk: bulk load handle
+ * @kt:   key, which must be greater than the previous key of the load
+ * @vt:   value (neither tombstones nor ptombs)
+ *
+ * Return: EINVAL if @kt is out of order, in which case the load may go on.
+ * Any other error fails the load.
+ */
+/* MTF_MOCK */
+merr_t
+cn_bulk_add(struct cn_bulk *bulk, const struct kvs_ktuple *kt, const struct kvs_vtuple *vt);
+
+typedef merr_t
+cn_bulk_publish_callback(void *);
+
+/**
+ * cn_bulk_commit() - atomically add the kvsets of a bulk load to the cn
+ * @bulk: bulk load handle
+ * @cb:   called under the ingest lock before the load is recorded (may be NULL)
+ * @arg:  argument passed to @cb
+ *
+ * The caller must ensure that all data with seqnos older than the load's
+ * has been ingested from c0, else a later ingest of such data would get a
+ * higher dgen than the load and shadow it.
+ *
+ * @cb is called before anything of the load is recorded in cndb.  If it
+ * fails, the commit fails with its error but the load is kept, and the
+ * commit may be retried.
+ *
+ * Return: ECANCELED if data or a range tombstone newer than the load has
+ * made it into the cn within the key range of the load, in which case the
+ * load fails.
+ */
+/* MTF_MOCK */
+merr_t
+cn_bulk_commit(struct cn_bulk *bulk, cn_bulk_publish_callback *cb, void *arg);
+
+/**
+ * cn_bulk_destroy() - free a bulk load, discarding anything not committed
+ * @bulk: bulk load handle (may be NULL)
+ */
+/* MTF_MOCK */
+void
+cn_bulk_destroy(struct cn_bulk *bulk);
+
 /* MTF_MOCK */
 struct perfc_set *
 cn_get_ingest_perfc(const struct cn *cn);
@@ -159,6 +339,14 @@ cn_get_tree(const struct cn *cn);
 uint64_t
 cn_get_seqno_horizon(struct cn *cn);
 
+/*
+ * Retire the range tombstones of a cn whose deleted data is all gone.
+ * Called by compaction.
+ */
+/* MTF_MOCK */
+void
+cn_rtomb_retire(struct cn *cn);
+
 /* MTF_MOCK */
 void
 cn_ref_get(struct cn *cn);
@@ -174,6 +362,14 @@ cn_ref_wait(struct cn *cn);
 struct workqueue_struct *
 cn_get_io_wq(struct cn *cn);
 
+/* MTF_MOCK */
+struct workqueue_struct *
+cn_get_spill_wq(struct cn *cn);
+
+/* MTF_MOCK */
+struct workqueue_struct *
+cn_get_wr_wq(struct cn *cn);
+
 /* MTF_MOCK */
 struct workqueue_struct *
 cn_get_maint_wq(struct cn *cn);
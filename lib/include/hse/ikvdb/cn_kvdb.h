@@ -12,17 +12,38 @@
 
 /* MTF_MOCK_DECL(cn_kvdb) */
 
+struct vbcache;
+
 /**
  * Public portion of per kvdb cN object
+ *
+ * @cn_spill_wq: builds the key range partitions of large spills
+ * @cn_wr_wq:    writes finished kblocks and vblocks for kvset builders
+ * @cn_vbcache:  caches vblock pages read via direct I/O (may be NULL)
+ * @cn_ingest_seqno_min: greatest min seqno of a completed ingest, below
+ *                       which c0 holds no more data
  */
 struct cn_kvdb {
     struct workqueue_struct *cn_maint_wq;
     struct workqueue_struct *cn_io_wq;
+    struct workqueue_struct *cn_spill_wq;
+    struct workqueue_struct *cn_wr_wq;
+    struct vbcache          *cn_vbcache;
+    atomic_ulong             cn_ingest_seqno_min;
 };
 
 /* MTF_MOCK */
 merr_t
-cn_kvdb_create(uint cn_maint_threads, uint cn_io_threads, struct cn_kvdb **h);
+cn_kvdb_create(
+    uint cn_maint_threads,
+    uint cn_io_threads,
+    uint cn_spill_threads,
+    size_t cn_vbcache_sz,
+    struct cn_kvdb **h);
+
+/* MTF_MOCK */
+void
+cn_kvdb_perfc_alloc(struct cn_kvdb *h, const char *group, uint prio);
 
 /* MTF_MOCK */
 void
@@ -8,6 +8,8 @@
 
 #include <stdint.h>
 
+#include <hse/types.h>
+
 #include <hse/error/merr.h>
 #include <hse/util/atomic.h>
 #include <hse/util/platform.h>
@@ -61,6 +63,17 @@ cndb_replay(struct cndb *cndb, uint64_t *seqno, uint64_t *ingestid, uint64_t *tx
 merr_t
 cndb_compact(struct cndb *cndb);
 
+/**
+ * cndb_checkpoint() - compact the cndb and clone its MDC
+ * @cndb:  cndb handle
+ * @paths: per media class target directory
+ *
+ * Must be called from an mpool_checkpoint() callback, such that the mblocks
+ * referenced by the cloned MDC remain intact until they have been cloned.
+ */
+merr_t
+cndb_checkpoint(struct cndb *cndb, const char *paths[HSE_MCLASS_COUNT]);
+
 /* MTF_MOCK */
 uint64_t
 cndb_kvsetid_mint(struct cndb *cndb);
@@ -127,6 +140,42 @@ cndb_record_kvsetv_move(
     uint32_t kvset_idc,
     const uint64_t *kvset_idv);
 
+/**
+ * cndb_record_rtomb_add() - persist a range tombstone
+ *
+ * @cndb:  cndb handle
+ * @cnid:  KVS of the tombstone
+ * @seqno: seqno of the tombstone (unique)
+ * @start: start key (inclusive)
+ * @slen:  start key length
+ * @end:   end key (exclusive)
+ * @elen:  end key length
+ *
+ * The seqno of the tombstone also raises the max seqno recorded by the cndb,
+ * so that it is not reused once the kvdb is reopened.
+ */
+/* MTF_MOCK */
+merr_t
+cndb_record_rtomb_add(
+    struct cndb *cndb,
+    uint64_t cnid,
+    uint64_t seqno,
+    const void *start,
+    uint32_t slen,
+    const void *end,
+    uint32_t elen);
+
+/**
+ * cndb_record_rtomb_del() - retire a range tombstone
+ *
+ * @cndb:  cndb handle
+ * @cnid:  KVS of the tombstone
+ * @seqno: seqno of the tombstone
+ */
+/* MTF_MOCK */
+merr_t
+cndb_record_rtomb_del(struct cndb *cndb, uint64_t cnid, uint64_t seqno);
+
 /* MTF_MOCK */
 merr_t
 cndb_record_kvset_add_ack(struct cndb *cndb, struct cndb_txn *tx, void *cookie);
@@ -157,6 +206,13 @@ cn_init_callback(void *, struct kvset_meta *, uint64_t);
 merr_t
 cndb_cn_instantiate(struct cndb *cndb, uint64_t cnid, void *ctx, cn_init_callback *cb);
 
+typedef merr_t
+cn_rtomb_callback(void *, uint64_t, const void *, uint32_t, const void *, uint32_t);
+
+/* MTF_MOCK */
+merr_t
+cndb_cn_rtombs(struct cndb *cndb, uint64_t cnid, void *ctx, cn_rtomb_callback *cb);
+
 merr_t
 cndb_kvset_delete(struct cndb *cndb, uint64_t cnid, uint64_t kvsetid);
 
@@ -67,6 +67,7 @@ enum cn_rule {
     CN_RULE_LSPLIT,         /* left node kvset after a split */
     CN_RULE_RSPLIT,         /* right ndoe kvset after a split */
     CN_RULE_JOIN,           /* prev node is very small */
+    CN_RULE_TIER,           /* leaf changed temperature, rewrite on new mclass */
     CN_RULE_MAX,
 };
 
@@ -122,6 +123,8 @@ cn_rule2str(enum cn_rule rule)
         return "right";
     case CN_RULE_JOIN:
         return "join";
+    case CN_RULE_TIER:
+        return "tier";
     case CN_RULE_MAX:
         return "max";
     }
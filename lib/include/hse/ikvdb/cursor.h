@@ -81,6 +81,7 @@ enum kvs_bh_source {
  * @kce_kobj:     Key (as a struct key_obj)
  * @kce_source:   Source of kv-tuple
  * @kce_complen:  Length of compressed value. Zero if not compressed.
+ * @kce_calgo:    Compression algorithm (enum vcomp_algorithm) if compressed.
  * @kce_is_ptomb: Whether or not kv-tuple is a ptomb
  */
 struct kvs_cursor_element {
@@ -89,6 +90,7 @@ struct kvs_cursor_element {
     enum kvs_bh_source kce_source;
     uintptr_t kce_seqnoref;
     uint kce_complen;
+    uint8_t kce_calgo;
     bool kce_is_ptomb;
 };
 
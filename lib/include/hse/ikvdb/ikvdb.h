@@ -8,6 +8,7 @@
 
 #include <bsd/libutil.h>
 
+#include <hse/experimental.h>
 #include <hse/flags.h>
 
 #include <hse/error/merr.h>
@@ -30,6 +31,7 @@ struct kvs_rparams;
 struct kvs_cparams;
 struct hse_kvdb_opspec;
 struct hse_kvs_cursor;
+struct hse_kvs_bulk;
 struct mpool;
 struct c0sk;
 struct cndb;
@@ -406,6 +408,69 @@ ikvdb_kvs_put(
     struct kvs_ktuple *kt,
     struct kvs_vtuple *vt);
 
+/**
+ * ikvdb_kvs_write_batch() - apply a batch of non-transactional puts and
+ * deletes to the KVS, logging and inserting them in as few wal reservations
+ * and c0 passes as possible.
+ */
+merr_t
+ikvdb_kvs_write_batch(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    size_t cnt,
+    struct kvs_batch_op *opv);
+
+/**
+ * ikvdb_kvs_bulk_create() - start a bulk load of sorted key/value pairs
+ * which bypasses the wal and c0 (see cn_bulk_create())
+ */
+merr_t
+ikvdb_kvs_bulk_create(struct hse_kvs *kvs, unsigned int flags, struct hse_kvs_bulk **bulkp);
+
+/**
+ * ikvdb_kvs_bulk_put() - add the next key/value pair to a bulk load
+ */
+merr_t
+ikvdb_kvs_bulk_put(
+    struct hse_kvs_bulk *bulk,
+    unsigned int flags,
+    struct kvs_ktuple *kt,
+    struct kvs_vtuple *vt);
+
+/**
+ * ikvdb_kvs_bulk_commit() - ingest c0 and atomically link the kvsets of a
+ * bulk load into cn
+ */
+merr_t
+ikvdb_kvs_bulk_commit(struct hse_kvs_bulk *bulk, unsigned int flags);
+
+/**
+ * ikvdb_kvs_bulk_destroy() - free a bulk load, discarding it if it has not
+ * been committed
+ */
+void
+ikvdb_kvs_bulk_destroy(struct hse_kvs_bulk *bulk);
+
+/**
+ * ikvdb_kvs_merge_register() - set the merge operator of the KVS
+ *
+ * Return: EEXIST if the KVS already has a merge operator.
+ */
+merr_t
+ikvdb_kvs_merge_register(struct hse_kvs *kvs, hse_kvs_merge_fn *fn, void *arg);
+
+/**
+ * ikvdb_kvs_merge() - replace the value of a key with the result of applying
+ * the KVS's merge operator to it and the given operand, without a transaction.
+ */
+merr_t
+ikvdb_kvs_merge(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct kvs_ktuple *kt,
+    const void *operand,
+    size_t operand_len);
+
 /**
  * ikvdb_kvs_get() - search for the given key within the KVS. HSE allocates
  * memory for the result if vbuf->b_buf is NULL.
@@ -419,6 +484,48 @@ ikvdb_kvs_get(
     enum key_lookup_res *res,
     struct kvs_buf *vbuf);
 
+/**
+ * ikvdb_kvs_snapshot_get() - search for the given key within the KVS as of
+ * the view of a snapshot. HSE allocates memory for the result if
+ * vbuf->b_buf is NULL.
+ */
+merr_t
+ikvdb_kvs_snapshot_get(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    struct kvs_ktuple *kt,
+    enum key_lookup_res *res,
+    struct kvs_buf *vbuf);
+
+/**
+ * ikvdb_kvs_get_threaded() - search for the given key within the KVS on a
+ * kvdb worker thread and report the result through @cb. The key is copied,
+ * the value buffer described by @vbuf must remain valid until @cb is called.
+ */
+merr_t
+ikvdb_kvs_get_threaded(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct kvs_ktuple *kt,
+    struct kvs_buf *vbuf,
+    hse_kvs_get_cb *cb,
+    void *arg);
+
+/**
+ * ikvdb_kvs_get_multi() - search for a batch of keys within the KVS using a
+ * single view, resolving the cn lookups of all keys in one pass.
+ */
+merr_t
+ikvdb_kvs_get_multi(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_txn *txn,
+    uint cnt,
+    struct kvs_ktuple *ktv,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv);
+
 /**
  * ikvdb_kvs_del() - remove the supplied key and associated value from the KVS
  * indexed by opspec->kop_index.
@@ -442,6 +549,20 @@ ikvdb_kvs_pfx_probe(
     struct kvs_buf *kbuf,
     struct kvs_buf *vbuf);
 
+/**
+ * ikvdb_kvs_snapshot_pfx_probe() - probe for a prefix as of the view of a
+ * snapshot
+ */
+merr_t
+ikvdb_kvs_snapshot_pfx_probe(
+    struct hse_kvs *handle,
+    unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    struct kvs_ktuple *kt,
+    enum key_lookup_res *res,
+    struct kvs_buf *kbuf,
+    struct kvs_buf *vbuf);
+
 /**
  * ikvdb_kvs_prefix_delete() - remove all key/value pairs with the given prefix
  * from the KVS indexed by opspec->kop_index. If a prefix scan is in progress
@@ -455,6 +576,18 @@ ikvdb_kvs_prefix_delete(
     struct hse_kvdb_txn *txn,
     struct kvs_ktuple *kt);
 
+/**
+ * ikvdb_kvs_range_delete() - atomically remove all key/value pairs in the
+ * range [kt_start, kt_end) from a non-transactional KVS by adding a range
+ * tombstone to its cn.
+ */
+merr_t
+ikvdb_kvs_range_delete(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct kvs_ktuple *kt_start,
+    struct kvs_ktuple *kt_end);
+
 merr_t
 ikvdb_kvs_param_get(
     struct hse_kvs *kvs,
@@ -515,6 +648,23 @@ ikvdb_txn_commit(struct ikvdb *kvdb, struct hse_kvdb_txn *txn);
 merr_t
 ikvdb_txn_abort(struct ikvdb *kvdb, struct hse_kvdb_txn *txn);
 
+/**
+ * ikvdb_snapshot_create() - establish a read view which holds back the
+ * seqno horizon until it is released
+ * @handle: KVDB handle
+ * @snapp:  snapshot handle (output)
+ */
+merr_t
+ikvdb_snapshot_create(struct ikvdb *handle, struct hse_kvdb_snapshot **snapp);
+
+/**
+ * ikvdb_snapshot_release() - release a snapshot from ikvdb_snapshot_create()
+ * @handle: KVDB handle
+ * @snap:   snapshot handle (may be NULL)
+ */
+void
+ikvdb_snapshot_release(struct ikvdb *handle, struct hse_kvdb_snapshot *snap);
+
 /**
  * ikvdb_txn_state() - retrieve the state of a transaction.
  *
@@ -536,6 +686,36 @@ ikvdb_kvs_cursor_create(
     size_t pfx_len,
     struct hse_kvs_cursor **cursor);
 
+/**
+ * ikvdb_kvs_snapshot_cursor_create() - create a cursor whose view is that of
+ * the given snapshot. Updating the view of such a cursor is a no-op.
+ */
+merr_t
+ikvdb_kvs_snapshot_cursor_create(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    const void *prefix,
+    size_t pfx_len,
+    struct hse_kvs_cursor **cursor);
+
+/**
+ * ikvdb_kvs_cursor_split_create() - create up to *%cursorc forward cursors
+ * which share a single view and partition the key range [%min, %max] into
+ * parts holding roughly equal numbers of keys, as estimated from cN.
+ * On success *%cursorc is set to the number of cursors created.
+ */
+merr_t
+ikvdb_kvs_cursor_split_create(
+    struct hse_kvs *kvs,
+    unsigned int flags,
+    const void *min,
+    size_t minlen,
+    const void *max,
+    size_t maxlen,
+    uint *cursorc,
+    struct hse_kvs_cursor **cursorv);
+
 /**
  * ikvdb_kvs_cursor_update() - incorporate updates since cursor created
  */
@@ -582,6 +762,29 @@ ikvdb_kvs_cursor_read_copy(
     size_t *val_len,
     bool *eof);
 
+/**
+ * ikvdb_kvs_cursor_read_batch() - copy out up to *kvc successive key/value
+ * pairs in a single call
+ */
+merr_t
+ikvdb_kvs_cursor_read_batch(
+    struct hse_kvs_cursor *cur,
+    unsigned int flags,
+    void *buf,
+    size_t buf_sz,
+    struct hse_kvs_cursor_kv *kvv,
+    size_t *kvc,
+    bool *eof);
+
+/**
+ * ikvdb_kvs_cursor_filter_set() - install or clear the cursor's key predicate
+ */
+merr_t
+ikvdb_kvs_cursor_filter_set(
+    struct hse_kvs_cursor *cur,
+    bool (*filter)(void *arg, const void *key, size_t key_len),
+    void *arg);
+
 /**
  * ikvdb_kvs_cursor_destroy() - allow the caller to indicate that is is done
  * with the scan and release the associated cursor
@@ -592,6 +795,17 @@ ikvdb_kvs_cursor_destroy(struct hse_kvs_cursor *cursor);
 void
 ikvdb_compact(struct ikvdb *self, unsigned int flags);
 
+/**
+ * ikvdb_checkpoint() - create a consistent copy of an open KVDB
+ * @handle: KVDB handle
+ * @dest:   existing directory that becomes the KVDB home of the copy
+ *
+ * The copy shares data with the source where the file system supports
+ * reflinks, and otherwise is a full copy of the allocated data.
+ */
+merr_t
+ikvdb_checkpoint(struct ikvdb *handle, const char *dest);
+
 /* [HSE_REVISIT] - the ikvdb layer needs its own struct */
 
 struct hse_kvdb_compact_status;
@@ -647,6 +861,7 @@ ikvdb_wal_replay_open(struct ikvdb *ikvdb, struct ikvdb_kvs_hdl **ikvsh_out);
 void
 ikvdb_wal_replay_close(struct ikvdb *ikvdb, struct ikvdb_kvs_hdl *ikvsh);
 
+/* MTF_MOCK */
 merr_t
 ikvdb_wal_replay_put(
     struct ikvdb *ikvdb,
@@ -656,6 +871,7 @@ ikvdb_wal_replay_put(
     struct kvs_ktuple *kt,
     struct kvs_vtuple *vt);
 
+/* MTF_MOCK */
 merr_t
 ikvdb_wal_replay_del(
     struct ikvdb *ikvdb,
@@ -664,6 +880,7 @@ ikvdb_wal_replay_del(
     uint64_t seqno,
     struct kvs_ktuple *kt);
 
+/* MTF_MOCK */
 merr_t
 ikvdb_wal_replay_prefix_del(
     struct ikvdb *ikvdb,
@@ -672,6 +889,19 @@ ikvdb_wal_replay_prefix_del(
     uint64_t seqno,
     struct kvs_ktuple *kt);
 
+/**
+ * ikvdb_wal_replay_key_hash() - compute the c0 hash of a replayed key
+ * @ikvsh: replay kvs handle
+ * @cnid:  cnid of the kvs to which the key belongs
+ * @kt:    key
+ *
+ * Returns the same hash that kvs_put() and kvs_del() use to select a
+ * c0kvset, or zero if the kvs no longer exists.
+ */
+/* MTF_MOCK */
+uint64_t
+ikvdb_wal_replay_key_hash(struct ikvdb_kvs_hdl *ikvsh, uint64_t cnid, const struct kvs_ktuple *kt);
+
 merr_t
 ikvdb_wal_replay_sync(struct ikvdb *handle, const unsigned int flags);
 
@@ -96,12 +96,16 @@ struct kvdb_rparams {
     uint32_t c0_ingest_threads;
     uint16_t cn_maint_threads;
     uint16_t cn_io_threads;
+    uint16_t cn_spill_threads;
+    uint16_t get_threaded_workers;
+    uint32_t cn_vbcache_mb;
     double cndb_compact_hwm_pct;
 
     uint32_t keylock_tables;
     enum kvdb_open_mode mode;
 
     bool dio_enable[HSE_MCLASS_COUNT];
+    bool uring_enable[HSE_MCLASS_COUNT];
     struct mclass_policy mclass_policies[HSE_MPOLICY_COUNT];
 };
 
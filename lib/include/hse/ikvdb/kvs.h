@@ -6,12 +6,16 @@
 #ifndef HSE_KVS_IKVS_H
 #define HSE_KVS_IKVS_H
 
+#include <hse/limits.h>
+
 #include <hse/error/merr.h>
 #include <hse/ikvdb/kvdb_health.h>
 #include <hse/ikvdb/kvs_rparams.h>
 #include <hse/ikvdb/query_ctx.h>
 #include <hse/ikvdb/tuple.h>
 #include <hse/util/arch.h>
+#include <hse/util/atomic.h>
+#include <hse/util/key_util.h>
 #include <hse/util/list.h>
 #include <hse/util/mutex.h>
 #include <hse/util/perfc.h>
@@ -23,6 +27,7 @@
 /*- Internal Key Value Store  -----------------------------------------------*/
 
 struct hse_kvdb_txn;
+struct hse_kvs_cursor_kv;
 struct kvdb_ctxn;
 struct kvdb_kvs;
 struct cndb;
@@ -36,11 +41,42 @@ struct cn_kvdb;
 struct wal;
 struct viewset;
 
+/**
+ * struct kc_filter - cursor filter pushed down into the c0, lc and cn cursors
+ * @kcf_maxkey:   inclusive upper bound of the cursor's range (optional)
+ * @kcf_maxklen:  length of %kcf_maxkey
+ * @kcf_pred:     key predicate, keys for which it returns false are skipped (optional)
+ * @kcf_pred_arg: argument passed to %kcf_pred
+ * @kcf_kbuf:     scratch buffer of HSE_KVS_KEY_LEN_MAX bytes for kc_filter_pred_kobj()
+ *
+ * Each source evaluates the predicate before an element enters the merge.
+ * This is correct only because the predicate depends on nothing but the key,
+ * so every version of a key (including its tombstones) in every source gets
+ * the same verdict.  Prefix tombstones are never subject to the predicate as
+ * they hide keys other than their own.
+ */
 struct kc_filter {
     const void *kcf_maxkey;
     size_t kcf_maxklen;
+    bool (*kcf_pred)(void *arg, const void *key, size_t klen);
+    void *kcf_pred_arg;
+    void *kcf_kbuf;
 };
 
+static HSE_ALWAYS_INLINE bool
+kc_filter_pred_kobj(const struct kc_filter *filt, const struct key_obj *kobj)
+{
+    const void *key;
+    uint klen;
+
+    if (!kobj->ko_pfx_len)
+        return filt->kcf_pred(filt->kcf_pred_arg, kobj->ko_sfx, kobj->ko_sfx_len);
+
+    key = key_obj_copy(filt->kcf_kbuf, HSE_KVS_KEY_LEN_MAX, &klen, kobj);
+
+    return filt->kcf_pred(filt->kcf_pred_arg, key, klen);
+}
+
 struct hse_kvs_cursor {
     struct perfc_set *kc_pkvsl_pc;
     struct kvdb_kvs *kc_kvs;
@@ -49,6 +85,7 @@ struct hse_kvs_cursor {
     uint64_t kc_seq;
     uint64_t kc_create_time;
     volatile bool kc_on_list;
+    bool kc_snap;
     unsigned int kc_flags;
     merr_t kc_err;
     struct kc_filter kc_filter;
@@ -123,6 +160,45 @@ kvs_cursor_seek(
 merr_t
 kvs_cursor_read(struct hse_kvs_cursor *cursor, unsigned int flags, bool *eof);
 
+/**
+ * kvs_cursor_read_batch() - read and copy out successive key/value pairs
+ * @cursor: cursor handle
+ * @flags:  read flags (passed to kvs_cursor_read())
+ * @buf:    buffer into which keys and values are packed back to back
+ * @bufsz:  size of %buf
+ * @kvv:    pair descriptors, pointing into %buf (output)
+ * @kvcp:   in: length of %kvv, out: number of pairs read
+ * @eof:    set if the cursor reached the end of its range (output)
+ *
+ * Stops early, leaving the cursor on the pair that did not fit, when %buf
+ * cannot hold the next pair.  Returns EMSGSIZE if not even the first pair
+ * fits.
+ */
+merr_t
+kvs_cursor_read_batch(
+    struct hse_kvs_cursor *cursor,
+    unsigned int flags,
+    void *buf,
+    size_t bufsz,
+    struct hse_kvs_cursor_kv *kvv,
+    size_t *kvcp,
+    bool *eof);
+
+/**
+ * kvs_cursor_filter_set() - install or clear a cursor's key predicate
+ * @cursor: cursor handle
+ * @pred:   key predicate, or NULL to clear
+ * @arg:    argument passed to %pred
+ *
+ * The predicate takes effect from the cursor's current position, which
+ * is re-evaluated against it on the next read.
+ */
+void
+kvs_cursor_filter_set(
+    struct hse_kvs_cursor *cursor,
+    bool (*pred)(void *arg, const void *key, size_t klen),
+    void *arg);
+
 void
 kvs_cursor_key_copy(
     struct hse_kvs_cursor *cursor,
@@ -172,15 +248,62 @@ kvs_put(
     struct kvs_vtuple *vt,
     uint64_t seqno);
 
+/* Apply a batch of non-transactional puts and deletes.  The key and value
+ * tuples in @opv are modified to reference their copies in the wal.
+ */
+merr_t
+kvs_write_batch(struct ikvs *ikvs, uint cnt, struct kvs_batch_op *opv);
+
+/**
+ * kvs_merge_cb - compute the value to store for a merge
+ * @arg: callback argument
+ * @res: state of the key in the active c0 kvms, one of NOT_FOUND,
+ *       FOUND_VAL, FOUND_TMB or FOUND_PTMB
+ * @cur: the key's current value if @res is FOUND_VAL
+ * @vt:  value to insert (output)
+ *
+ * Called without any c0 locks held, and called again if the key is updated
+ * before the value can be inserted.  Any error aborts the merge with nothing
+ * inserted.
+ */
+typedef merr_t
+kvs_merge_cb(void *arg, enum key_lookup_res res, const struct kvs_buf *cur, struct kvs_vtuple *vt);
+
+/* Replace the value of a key in the active c0 kvms with the value computed by
+ * @cb, logging the new value to the wal.  See c0sk_merge_read().
+ */
+merr_t
+kvs_merge(
+    struct ikvs *ikvs,
+    struct kvs_ktuple *kt,
+    uint64_t *genp,
+    struct kvs_buf *curbuf,
+    kvs_merge_cb *cb,
+    void *cbarg);
+
+/* If @direct is true, values found in cn are read from media rather than
+ * through the mcache maps (see cn_get()).
+ */
 merr_t
 kvs_get(
     struct ikvs *ikvs,
     struct hse_kvdb_txn *txn,
     struct kvs_ktuple *key,
     uint64_t seqno,
+    bool direct,
     enum key_lookup_res *res,
     struct kvs_buf *vbuf);
 
+merr_t
+kvs_get_multi(
+    struct ikvs *ikvs,
+    struct hse_kvdb_txn *txn,
+    uint cnt,
+    struct kvs_ktuple *ktv,
+    uint64_t seqno,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv);
+
 merr_t
 kvs_del(struct ikvs *ikvs, struct hse_kvdb_txn *txn, struct kvs_ktuple *key, uint64_t seqno);
 
@@ -197,11 +320,34 @@ kvs_pfx_probe(
 merr_t
 kvs_prefix_del(struct ikvs *ikvs, struct hse_kvdb_txn *txn, struct kvs_ktuple *key, uint64_t seqno);
 
+/**
+ * kvs_range_del() - delete the keys in [kt_start, kt_end) visible now
+ *
+ * See cn_range_delete().  Only valid for non-transactional KVSs.
+ */
+merr_t
+kvs_range_del(
+    struct ikvs *ikvs,
+    struct kvs_ktuple *kt_start,
+    struct kvs_ktuple *kt_end,
+    atomic_ulong *kvdb_seqno);
+
+/**
+ * kvs_rtomb_pfx_overlap() - check if a range delete in view may cover keys with prefix @kt
+ */
+bool
+kvs_rtomb_pfx_overlap(struct ikvs *ikvs, const struct kvs_ktuple *kt, uint64_t seqno);
+
 void
 kvs_maint_task(struct ikvs *ikvs, uint64_t now);
 
 struct hse_kvs_cursor *
-kvs_cursor_alloc(struct ikvs *ikvs, const void *prefix, size_t pfx_len, bool reverse);
+kvs_cursor_alloc(
+    struct ikvs *ikvs,
+    const void *prefix,
+    size_t pfx_len,
+    bool reverse,
+    bool novals);
 
 void
 kvs_cursor_free(struct hse_kvs_cursor *cursor);
@@ -48,6 +48,8 @@ struct kvs_rparams {
     uint64_t cn_compact_kblk_ra;
     uint64_t cn_compact_vblk_ra;
     uint64_t cn_compact_vra;
+    uint8_t cn_spill_parts;
+    bool cn_async_write;
 
     uint64_t cn_capped_ttl;
     uint64_t cn_capped_vra;
@@ -55,10 +57,14 @@ struct kvs_rparams {
     uint64_t cn_cursor_seq;
     uint64_t cn_cursor_vra;
     bool cn_cursor_kra;
+    bool cn_cursor_rev_kra;
+    uint64_t cn_cursor_rev_vra;
 
     uint8_t cn_mcache_kra_params;
     uint8_t cn_mcache_vra_params;
     uint8_t cn_mcache_wbt;
+    bool cn_wbt_fence;
+    uint8_t cn_wbt_leaf_enc;
     uint32_t cn_mcache_vmax;
 
     bool cn_bloom_create;
@@ -70,9 +76,14 @@ struct kvs_rparams {
 
     uint64_t capped_evict_ttl;
 
+    uint32_t cn_tier_hot_rate;
+    uint32_t cn_rcache_mb;
+
     struct {
         struct {
             enum vcomp_default dflt;
+            enum vcomp_algorithm algo;
+            int32_t level;
         } compression;
     } value;
 
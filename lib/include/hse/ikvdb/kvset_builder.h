@@ -11,6 +11,7 @@
 #include <hse/ikvdb/mclass_policy.h>
 #include <hse/ikvdb/omf_kmd.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/mpool/mpool.h>
 #include <hse/util/atomic.h>
 
@@ -25,10 +26,28 @@ struct key_stats {
     uint nvals;
     uint ntombs;
     uint nptombs;
+    uint nexpire;
     uint64_t tot_vlen;
     uint64_t tot_vused;
+    uint64_t expire_min;
+    uint64_t expire_max;
 };
 
+/* Track the number and range of expiration times of the values of a key
+ * so that the kblock header can summarize them for the compaction scheduler.
+ */
+static inline void
+key_stats_add_expire(struct key_stats *stats, uint64_t expire)
+{
+    if (!expire)
+        return;
+
+    if (stats->nexpire++ == 0 || expire < stats->expire_min)
+        stats->expire_min = expire;
+    if (expire > stats->expire_max)
+        stats->expire_max = expire;
+}
+
 /* MTF_MOCK_DECL(kvset_builder) */
 /* MTF_MOCK */
 merr_t
@@ -82,17 +101,21 @@ kvset_builder_add_val(
     const void *vdata,
     uint vlen,
     uint64_t seq,
-    uint complen);
+    uint64_t expire,
+    uint complen,
+    enum vcomp_algorithm calgo);
 
 /* MTF_MOCK */
 merr_t
 kvset_builder_add_vref(
     struct kvset_builder *self,
     uint64_t seq,
+    uint64_t expire,
     uint vbidx,
     uint vboff,
     uint vlen,
-    uint complen);
+    uint complen,
+    enum vcomp_algorithm calgo);
 
 /* MTF_MOCK */
 merr_t
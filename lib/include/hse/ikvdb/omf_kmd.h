@@ -18,6 +18,8 @@
  *   ------  --------    --- --- ---  -----
  *   vtype   u8           1   1   1
  *   seqno   hg64         2   2   8   sequence number
+ *   expire  hg64         2   6   8   expiration time, only present if
+ *                                    vtype has KMD_VTYPE_EXPIRE set
  *   vboff   u32          4   4   4   not present for tombs
  *   vbidx   hg16_32k     1   1   2   not present for tombs
  *   vlen    hg32_1024m   1   1   4   not present for tombs
@@ -30,6 +32,7 @@
  *      3      3      9     A key with 1 tombstone entry
  *      9      9     19     A key with a non-zero length value
  *     10     10     23     A compressed key
+ *     12     16     31     A compressed key with an expiration time
  *
  * KMD List:
  *
@@ -48,15 +51,15 @@
  *    kmd_set_count(mem, &off, count);
  *    kmd_add_tomb(mem, &off, seq);
  *    kmd_add_ptomb(mem, &off, seq);
- *    kmd_add_ival(mem, &off, seq, vbase, vlen);
- *    kmd_add_val(mem, &off, seq, vbidx, vboff, vlen);
+ *    kmd_add_ival(mem, &off, seq, 0, vbase, vlen);
+ *    kmd_add_val(mem, &off, seq, expire, vbidx, vboff, vlen);
  *    assert(off <= memsize);
  *
  * Unpack example:
  *
  *    count = kmd_count(mem, &off);
  *    for (i = 0; i < count; i++) {
- *            kmd_type_seq(mem, &off, &vtype, &seq);
+ *            kmd_type_seq_expire(mem, &off, &vtype, &seq, &expire);
  *            if (vtype == VTYPE_UCVAL) {
  *                    kmd_val(mem, &off, &vbidx, &vboff, &vlen);
  *            } else if (vtype == VTYPE_IVAL) {
@@ -72,7 +75,7 @@
 
 #define KMD_MAX_COUNT HG32_1024M_MAX
 
-#define KMD_MAX_ENCODED_ENTRY_LEN 23
+#define KMD_MAX_ENCODED_ENTRY_LEN 31
 #define KMD_MAX_ENCODED_COUNT_LEN 4
 
 static inline uint
@@ -104,20 +107,34 @@ kmd_add_ptomb(void *kmd, size_t *off, uint64_t seq)
     encode_hg64(kmd, off, seq);
 }
 
+/* Encode the vtype, seqno and expiration time (if any) of a value.
+ */
 static inline void
-kmd_add_zval(void *kmd, size_t *off, uint64_t seq)
+kmd_add_type_seq(void *kmd, size_t *off, enum kmd_vtype vtype, uint64_t seq, uint64_t expire)
 {
-    ((uint8_t *)kmd)[*off] = VTYPE_ZVAL;
+    ((uint8_t *)kmd)[*off] = expire ? (vtype | KMD_VTYPE_EXPIRE) : vtype;
     *off += 1;
     encode_hg64(kmd, off, seq);
+    if (expire)
+        encode_hg64(kmd, off, expire);
 }
 
 static inline void
-kmd_add_ival(void *kmd, size_t *off, uint64_t seq, const void *vdata, uint8_t vlen)
+kmd_add_zval(void *kmd, size_t *off, uint64_t seq, uint64_t expire)
 {
-    ((uint8_t *)kmd)[*off] = VTYPE_IVAL;
-    *off += 1;
-    encode_hg64(kmd, off, seq);
+    kmd_add_type_seq(kmd, off, VTYPE_ZVAL, seq, expire);
+}
+
+static inline void
+kmd_add_ival(
+    void *kmd,
+    size_t *off,
+    uint64_t seq,
+    uint64_t expire,
+    const void *vdata,
+    uint8_t vlen)
+{
+    kmd_add_type_seq(kmd, off, VTYPE_IVAL, seq, expire);
     ((uint8_t *)kmd)[*off] = vlen;
     *off += 1;
     memcpy(((uint8_t *)kmd) + *off, vdata, vlen);
@@ -125,13 +142,18 @@ kmd_add_ival(void *kmd, size_t *off, uint64_t seq, const void *vdata, uint8_t vl
 }
 
 static inline void
-kmd_add_val(void *kmd, size_t *off, uint64_t seq, uint vbidx, uint vboff, uint vlen)
+kmd_add_val(
+    void *kmd,
+    size_t *off,
+    uint64_t seq,
+    uint64_t expire,
+    uint vbidx,
+    uint vboff,
+    uint vlen)
 {
     __be32 val32;
 
-    ((uint8_t *)kmd)[*off] = VTYPE_UCVAL;
-    *off += 1;
-    encode_hg64(kmd, off, seq);
+    kmd_add_type_seq(kmd, off, VTYPE_UCVAL, seq, expire);
     encode_hg16_32k(kmd, off, vbidx);
     val32 = cpu_to_be32(vboff);
     memcpy(kmd + *off, &val32, sizeof(val32));
@@ -140,13 +162,22 @@ kmd_add_val(void *kmd, size_t *off, uint64_t seq, uint vbidx, uint vboff, uint v
 }
 
 static inline void
-kmd_add_cval(void *kmd, size_t *off, uint64_t seq, uint vbidx, uint vboff, uint vlen, uint complen)
+kmd_add_cval(
+    void *kmd,
+    size_t *off,
+    enum kmd_vtype vtype,
+    uint64_t seq,
+    uint64_t expire,
+    uint vbidx,
+    uint vboff,
+    uint vlen,
+    uint complen)
 {
     __be32 val32;
 
-    ((uint8_t *)kmd)[*off] = VTYPE_CVAL;
-    *off += 1;
-    encode_hg64(kmd, off, seq);
+    assert(vtype == VTYPE_CVAL || vtype == VTYPE_ZCVAL);
+
+    kmd_add_type_seq(kmd, off, vtype, seq, expire);
     encode_hg16_32k(kmd, off, vbidx);
     val32 = cpu_to_be32(vboff);
     memcpy(kmd + *off, &val32, sizeof(val32));
@@ -162,11 +193,30 @@ kmd_count(const void *kmd, size_t *off)
 }
 
 static inline void
-kmd_type_seq(const void *kmd, size_t *off, enum kmd_vtype *vtype, uint64_t *seq)
+kmd_type_seq_expire(
+    const void *kmd,
+    size_t *off,
+    enum kmd_vtype *vtype,
+    uint64_t *seq,
+    uint64_t *expire)
 {
-    *vtype = ((const uint8_t *)kmd)[*off];
+    uint8_t type = ((const uint8_t *)kmd)[*off];
+
     *off += 1;
     *seq = decode_hg64(kmd, off);
+    *expire = (type & KMD_VTYPE_EXPIRE) ? decode_hg64(kmd, off) : 0;
+    *vtype = type & ~KMD_VTYPE_EXPIRE;
+}
+
+/* Like kmd_type_seq_expire(), but for callers that have no use for
+ * expiration times.
+ */
+static inline void
+kmd_type_seq(const void *kmd, size_t *off, enum kmd_vtype *vtype, uint64_t *seq)
+{
+    uint64_t expire;
+
+    kmd_type_seq_expire(kmd, off, vtype, seq, &expire);
 }
 
 static inline void
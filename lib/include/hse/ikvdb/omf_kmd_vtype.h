@@ -17,8 +17,15 @@ enum kmd_vtype {
     VTYPE_PTOMB = 3,  // prefix tombstone
     VTYPE_IVAL = 4,   // immediate value, uncompressed, stored in a kblock
     VTYPE_CVAL = 5,   // an LZ4 compressed value stored in a vblock
+    VTYPE_ZCVAL = 6,  // a zstd compressed value stored in a vblock
 };
 
-#define NUM_KMD_VTYPES 6
+#define NUM_KMD_VTYPES 7
+
+/* Or'd into the vtype byte of a value (i.e., not a tombstone) that has an
+ * expiration time, in which case the expiration time immediately follows
+ * the seqno (kblock version 7 and later).
+ */
+#define KMD_VTYPE_EXPIRE 0x80u
 
 #endif
@@ -11,10 +11,13 @@ enum {
     GLOBAL_OMF_VERSION2 = 2,
     GLOBAL_OMF_VERSION3 = 3,
     GLOBAL_OMF_VERSION4 = 4,
+    GLOBAL_OMF_VERSION5 = 5,
+    GLOBAL_OMF_VERSION6 = 6,
 };
 
 enum {
     CNDB_VERSION1 = 1,
+    CNDB_VERSION2 = 2,
 };
 
 enum { HBLOCK_HDR_VERSION1 = 1 };
@@ -23,6 +26,7 @@ enum { VGROUP_MAP_VERSION1 = 1 };
 
 enum {
     KBLOCK_HDR_VERSION6 = 6,
+    KBLOCK_HDR_VERSION7 = 7,
 };
 
 enum {
@@ -55,6 +59,7 @@ enum {
 enum {
     WAL_VERSION1 = 1,
     WAL_VERSION2 = 2,
+    WAL_VERSION3 = 3,
 };
 
 enum {
@@ -62,23 +67,23 @@ enum {
     KVDB_META_VERSION2 = 2,
 };
 
-#define GLOBAL_OMF_VERSION GLOBAL_OMF_VERSION4
+#define GLOBAL_OMF_VERSION GLOBAL_OMF_VERSION6
 
 /* In the event one of the following versions in incremented, increment the
  * global OMF version.
  */
 
-#define CNDB_VERSION           CNDB_VERSION1
+#define CNDB_VERSION           CNDB_VERSION2
 #define HBLOCK_HDR_VERSION     HBLOCK_HDR_VERSION1
 #define VGROUP_MAP_VERSION     VGROUP_MAP_VERSION1
-#define KBLOCK_HDR_VERSION     KBLOCK_HDR_VERSION6
+#define KBLOCK_HDR_VERSION     KBLOCK_HDR_VERSION7
 #define VBLOCK_FOOTER_VERSION  VBLOCK_FOOTER_VERSION1
 #define BLOOM_OMF_VERSION      BLOOM_OMF_VERSION5
 #define WBT_TREE_VERSION       WBT_TREE_VERSION6
 #define CN_TSTATE_VERSION      CN_TSTATE_VERSION2
 #define MBLOCK_METAHDR_VERSION MBLOCK_METAHDR_VERSION2
 #define MDC_LOGHDR_VERSION     MDC_LOGHDR_VERSION2
-#define WAL_VERSION            WAL_VERSION2
+#define WAL_VERSION            WAL_VERSION3
 #define KVDB_META_VERSION      KVDB_META_VERSION2
 
 #endif
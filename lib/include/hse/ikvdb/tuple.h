@@ -6,7 +6,9 @@
 #ifndef HSE_CORE_TUPLE_H
 #define HSE_CORE_TUPLE_H
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <time.h>
 
 #include <hse/error/merr.h>
 #include <hse/ikvdb/key_hash.h>
@@ -47,8 +49,9 @@ struct kvs_ktuple {
 
 /**
  * struct kvs_vtuple - a container for carrying a value
- * @vt_data: ptr to the value in-core memory or a special tomb value
- * @vt_xlen: opaque encoded length
+ * @vt_data:   ptr to the value in-core memory or a special tomb value
+ * @vt_xlen:   opaque encoded length
+ * @vt_expire: expiration time (see kvs_expire_now()), or zero if none
  *
  * Always use kvs_vtuple_vlen() to learn the in-core length of a value.
  * If it returns zero then @kt_data likely is not a valid pointer but
@@ -57,6 +60,7 @@ struct kvs_ktuple {
 struct kvs_vtuple {
     void *vt_data;
     uint64_t vt_xlen;
+    uint64_t vt_expire;
 };
 
 struct kvs_buf {
@@ -70,6 +74,18 @@ struct kvs_kvtuple {
     struct kvs_vtuple kvt_value;
 };
 
+/**
+ * struct kvs_batch_op - one mutation of a write batch
+ * @bo_kt:  key
+ * @bo_vt:  value (ignored for deletes)
+ * @bo_del: op is a delete rather than a put
+ */
+struct kvs_batch_op {
+    struct kvs_ktuple bo_kt;
+    struct kvs_vtuple bo_vt;
+    bool              bo_del;
+};
+
 struct kvs_vtuple_ref {
     enum kmd_vtype vr_type;
     union {
@@ -85,6 +101,7 @@ struct kvs_vtuple_ref {
         } vi;
     };
     uint64_t vr_seq;
+    uint64_t vr_expire;
 };
 
 static inline void
@@ -120,27 +137,69 @@ kvs_vtuple_init(struct kvs_vtuple *vt, void *val, uint64_t xlen)
 {
     vt->vt_data = val;
     vt->vt_xlen = xlen;
+    vt->vt_expire = 0;
 }
 
+/* The opaque encoded value length (xlen) holds the uncompressed length in
+ * the low 32 bits, the compressed length (zero if not compressed) in the
+ * next 24 bits, and the compression algorithm in the top 8 bits.  Since
+ * LZ4 is algorithm zero, xlens from before the algorithm was recorded
+ * decode correctly.
+ */
+#define KVS_XLEN_CLEN_MASK   (0xffffffull)
+#define KVS_XLEN_CALGO_SHIFT (56)
+
 /**
  * kvs_vtuple_cinit() - initialize a compressed value tuple
- * @vt:   the vtuple to initialize
- * @val:  pointer to compressed in-core value
- * @vlen: the uncompressed value length
- * @clen: the compressed value length
+ * @vt:    the vtuple to initialize
+ * @val:   pointer to compressed in-core value
+ * @vlen:  the uncompressed value length
+ * @clen:  the compressed value length
+ * @calgo: the compression algorithm (enum vcomp_algorithm)
  *
  * A compressed value length should always be greater than zero
  * and less than the uncompressed value length.  The val pointer
  * should always be a valid memory pointer, not a tomb encoding.
  */
 static inline void
-kvs_vtuple_cinit(struct kvs_vtuple *vt, void *val, uint vlen, uint clen)
+kvs_vtuple_cinit(struct kvs_vtuple *vt, void *val, uint vlen, uint clen, uint calgo)
 {
     assert(!(HSE_CORE_IS_TOMB(val) && HSE_CORE_IS_PTOMB(val)));
-    assert(clen > 0 && clen < vlen);
+    assert(clen > 0 && clen < vlen && clen <= KVS_XLEN_CLEN_MASK);
 
     vt->vt_data = val;
-    vt->vt_xlen = ((uint64_t)clen << 32) | vlen;
+    vt->vt_xlen = ((uint64_t)calgo << KVS_XLEN_CALGO_SHIFT) | ((uint64_t)clen << 32) | vlen;
+}
+
+/**
+ * kvs_expire_now() - return the current time in expiration time units
+ *
+ * Value expiration times are absolute wall clock times in seconds since
+ * the Epoch so that they remain meaningful across restarts.
+ */
+static HSE_ALWAYS_INLINE uint64_t
+kvs_expire_now(void)
+{
+    return time(NULL);
+}
+
+/**
+ * kvs_expired_at() - test whether a value has expired as of the given time
+ * @expire: value expiration time, or zero if the value never expires
+ * @now:    current time as returned by kvs_expire_now()
+ *
+ * An expired value behaves exactly like a tombstone with the same seqno.
+ */
+static HSE_ALWAYS_INLINE bool
+kvs_expired_at(uint64_t expire, uint64_t now)
+{
+    return expire && expire <= now;
+}
+
+static HSE_ALWAYS_INLINE bool
+kvs_expired(uint64_t expire)
+{
+    return expire && expire <= kvs_expire_now();
 }
 
 /**
@@ -153,7 +212,7 @@ kvs_vtuple_cinit(struct kvs_vtuple *vt, void *val, uint vlen, uint clen)
 static HSE_ALWAYS_INLINE uint32_t
 kvs_vtuple_vlen(const struct kvs_vtuple *vt)
 {
-    const uint32_t clen = vt->vt_xlen >> 32;
+    const uint32_t clen = (vt->vt_xlen >> 32) & KVS_XLEN_CLEN_MASK;
     const uint32_t vlen = vt->vt_xlen & 0xfffffffful;
 
     return clen ? clen : vlen;
@@ -162,7 +221,15 @@ kvs_vtuple_vlen(const struct kvs_vtuple *vt)
 static HSE_ALWAYS_INLINE uint32_t
 kvs_vtuple_clen(const struct kvs_vtuple *vt)
 {
-    return vt->vt_xlen >> 32;
+    return (vt->vt_xlen >> 32) & KVS_XLEN_CLEN_MASK;
+}
+
+/* Returns the compression algorithm of a compressed value.
+ */
+static HSE_ALWAYS_INLINE uint
+kvs_vtuple_calgo(const struct kvs_vtuple *vt)
+{
+    return vt->vt_xlen >> KVS_XLEN_CALGO_SHIFT;
 }
 
 static inline void
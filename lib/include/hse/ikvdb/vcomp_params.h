@@ -8,9 +8,17 @@
 
 #include <stdint.h>
 
+#include <sys/types.h>
+
+#include <hse/error/merr.h>
+#include <hse/ikvdb/omf_kmd_vtype.h>
+
 #define VCOMP_PARAM_OFF "off"
 #define VCOMP_PARAM_ON  "on"
 
+#define VCOMP_PARAM_LZ4  "lz4"
+#define VCOMP_PARAM_ZSTD "zstd"
+
 enum vcomp_default {
     VCOMP_DEFAULT_OFF,
     VCOMP_DEFAULT_ON,
@@ -20,14 +28,61 @@ enum vcomp_default {
 #define VCOMP_DEFAULT_MAX   VCOMP_DEFAULT_ON
 #define VCOMP_DEFAULT_COUNT (VCOMP_DEFAULT_MAX + 1)
 
+/* The algorithm a value was compressed with travels with the value (see
+ * kvs_vtuple_calgo() and vtype_to_calgo()), so do not change this enum
+ * without considering the impact on backward compatibility.  Values are
+ * compressed individually, trained zstd dictionaries are a TODO (see
+ * docs/cn_omf.md).
+ */
 enum vcomp_algorithm {
     VCOMP_ALGO_LZ4,
+    VCOMP_ALGO_ZSTD,
 };
 
 #define VCOMP_ALGO_MIN   VCOMP_ALGO_LZ4
-#define VCOMP_ALGO_MAX   VCOMP_ALGO_LZ4
+#define VCOMP_ALGO_MAX   VCOMP_ALGO_ZSTD
 #define VCOMP_ALGO_COUNT (VCOMP_ALGO_MAX + 1)
 
+/* zstd levels range from 1 (fastest) to 22, with 0 selecting its default.
+ */
+#define VCOMP_LEVEL_MIN     (0)
+#define VCOMP_LEVEL_MAX     (22)
+#define VCOMP_LEVEL_DEFAULT (0)
+
+/* Entries are NULL for algorithms this build does not support.
+ */
 extern const struct compress_ops *vcomp_compress_ops[VCOMP_ALGO_COUNT];
 
+static inline enum vcomp_algorithm
+vtype_to_calgo(enum kmd_vtype vtype)
+{
+    return vtype == VTYPE_ZCVAL ? VCOMP_ALGO_ZSTD : VCOMP_ALGO_LZ4;
+}
+
+static inline enum kmd_vtype
+calgo_to_vtype(enum vcomp_algorithm algo)
+{
+    return algo == VCOMP_ALGO_ZSTD ? VTYPE_ZCVAL : VTYPE_CVAL;
+}
+
+/**
+ * vcomp_decompress() - decompress a value with the algorithm it was compressed with
+ * @algo:         compression algorithm
+ * @src:          compressed value
+ * @src_len:      length of @src
+ * @dst:          output buffer
+ * @dst_capacity: size of @dst, may be less than the uncompressed length
+ * @dst_len:      number of bytes written to @dst (output)
+ *
+ * Return: ENOTSUP if this build does not support @algo.
+ */
+merr_t
+vcomp_decompress(
+    enum vcomp_algorithm algo,
+    const void *src,
+    uint src_len,
+    void *dst,
+    uint dst_capacity,
+    uint *dst_len);
+
 #endif
@@ -88,6 +88,29 @@ wal_del(
     uint64_t txid,
     struct wal_record *recout);
 
+/**
+ * wal_write_batch() - log a batch of non-transactional puts and deletes
+ * @wal:  wal handle
+ * @kvs:  kvs the ops belong to
+ * @opv:  vector of ops
+ * @cntp: number of ops in @opv (input), number of ops logged (output)
+ * @recv: per-op wal records (output)
+ *
+ * Logs a prefix of @opv using a single buffer reservation, returning the
+ * length of that prefix in @cntp.  As with wal_put() and wal_del(), the key
+ * and value of each logged op are redirected to their copies in the wal
+ * buffer, and each record must be completed by wal_op_finish() once the op
+ * has been applied to c0.
+ */
+/* MTF_MOCK */
+merr_t
+wal_write_batch(
+    struct wal *wal,
+    struct ikvs *kvs,
+    struct kvs_batch_op *opv,
+    uint *cntp,
+    struct wal_record *recv);
+
 /* MTF_MOCK */
 merr_t
 wal_del_pfx(
@@ -126,6 +149,19 @@ wal_bufrel_cb(struct wal *wal, uint64_t gen);
 merr_t
 wal_sync(struct wal *wal);
 
+/* WAL files are not reclaimed while the WAL is pinned, such that every file
+ * needed to recover the state of cndb at any point in between can be cloned
+ * by wal_checkpoint().
+ */
+void
+wal_pin(struct wal *wal);
+
+void
+wal_unpin(struct wal *wal);
+
+merr_t
+wal_checkpoint(struct wal *wal, const char *paths[HSE_MCLASS_COUNT]);
+
 void
 wal_throttle_sensor(struct wal *wal, struct throttle_sensor *sensor);
 
@@ -60,6 +60,7 @@
 #include <hse/util/bkv_collection.h>
 #include <hse/util/compression_lz4.h>
 #include <hse/util/event_counter.h>
+#include <hse/util/keycmp.h>
 #include <hse/util/log2.h>
 #include <hse/util/page.h>
 #include <hse/util/seqno.h>
@@ -142,6 +143,7 @@ static atomic_uint ikvdb_txn_idx;
  * @ikdb_curcnt_max:    maximum number of active cursors
  * @ikdb_seqno:         current sequence number for the struct ikvdb
  * @ikdb_maint_work:    used to schedule kvdb maint task
+ * @ikdb_get_wq:        workqueue servicing hse_kvs_get_threaded() requests
  * @ikdb_rp:            KVDB run time params
  * @ikdb_lock:          protects ikdb_kvs_vec/ikdb_kvs_cnt writes
  * @ikdb_kvs_cnt:       number of KVSes in ikdb_kvs_vec
@@ -198,6 +200,7 @@ struct ikvdb_impl {
     struct mclass_policy    ikdb_mpolicies[HSE_MPOLICY_COUNT];
 
     struct workqueue_struct *ikdb_workqueue;
+    struct workqueue_struct *ikdb_get_wq;
 
     struct mutex     ikdb_lock;
     uint32_t         ikdb_kvs_cnt;
@@ -227,6 +230,8 @@ ikvdb_perfc_alloc(struct ikvdb_impl *self)
 
     perfc_alloc(ctxn_perfc_op, group, "set", self->ikdb_rp.perfc_level, &self->ikdb_ctxn_op);
     kvdb_keylock_perfc_init(self->ikdb_keylock, &self->ikdb_ctxn_op);
+
+    cn_kvdb_perfc_alloc(self->ikdb_cn_kvdb, group, self->ikdb_rp.perfc_level);
 }
 
 static void
@@ -960,8 +965,10 @@ ikvdb_diag_open(const char *kvdb_home, struct kvdb_rparams *params, struct ikvdb
     if (ev(err))
         goto self_cleanup;
 
-    for (int i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++)
+    for (int i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++) {
         mparams.mclass[i].dio_disable = !params->dio_enable[i];
+        mparams.mclass[i].uring_enable = params->uring_enable[i];
+    }
 
     err = mpool_open(kvdb_home, &mparams, O_RDONLY, &self->ikdb_mp);
     if (ev(err))
@@ -1313,8 +1320,10 @@ ikvdb_open(const char *kvdb_home, struct kvdb_rparams *params, struct ikvdb **ha
     if (ev(err))
         goto out;
 
-    for (i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++)
+    for (i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++) {
         mparams.mclass[i].dio_disable = !params->dio_enable[i];
+        mparams.mclass[i].uring_enable = params->uring_enable[i];
+    }
 
     err = mpool_open(kvdb_home, &mparams, allow_media_writes ? O_RDWR : O_RDONLY, &self->ikdb_mp);
     if (ev(err))
@@ -1423,7 +1432,9 @@ ikvdb_open(const char *kvdb_home, struct kvdb_rparams *params, struct ikvdb **ha
     }
 
     err = cn_kvdb_create(
-        self->ikdb_rp.cn_maint_threads, self->ikdb_rp.cn_io_threads, &self->ikdb_cn_kvdb);
+        self->ikdb_rp.cn_maint_threads, self->ikdb_rp.cn_io_threads,
+        self->ikdb_rp.cn_spill_threads, (size_t)self->ikdb_rp.cn_vbcache_mb << 20,
+        &self->ikdb_cn_kvdb);
     if (err) {
         log_errx("cannot open %s", err, kvdb_home);
         goto out;
@@ -1435,6 +1446,13 @@ ikvdb_open(const char *kvdb_home, struct kvdb_rparams *params, struct ikvdb **ha
         goto out;
     }
 
+    self->ikdb_get_wq = alloc_workqueue("hse_kvdb_get", 0, 1, self->ikdb_rp.get_threaded_workers);
+    if (!self->ikdb_get_wq) {
+        err = merr(ENOMEM);
+        log_errx("cannot open %s", err, kvdb_home);
+        goto out;
+    }
+
     if (ingestid != CNDB_INVAL_INGESTID && ingestid != CNDB_DFLT_INGESTID && ingestid > 0)
         gen = ingestid;
 
@@ -1513,6 +1531,7 @@ out:
         lc_destroy(self->ikdb_lc);
         self->ikdb_work_stop = true;
         destroy_workqueue(self->ikdb_workqueue);
+        destroy_workqueue(self->ikdb_get_wq);
         cn_kvdb_destroy(self->ikdb_cn_kvdb);
         for (i = 0; i < self->ikdb_kvs_cnt; i++)
             kvdb_kvs_destroy(self->ikdb_kvs_vec[i]);
@@ -2054,7 +2073,9 @@ ikvdb_kvs_open(
     kvs->kk_viewset = self->ikdb_cur_viewset;
 
     kvs->kk_vcomp_default = params->value.compression.dflt;
-    cops = vcomp_compress_ops[VCOMP_ALGO_LZ4];
+    kvs->kk_vcomp_algo = params->value.compression.algo;
+    kvs->kk_vcomp_level = params->value.compression.level;
+    cops = vcomp_compress_ops[kvs->kk_vcomp_algo];
     assert(cops && cops->cop_compress && cops->cop_estimate);
 
     kvs->kk_vcompress = cops->cop_compress;
@@ -2104,8 +2125,13 @@ ikvdb_kvs_close(struct hse_kvs *handle)
 
     mutex_lock(&parent->ikdb_lock);
     ikvs = kk->kk_ikvs;
-    if (ikvs)
+    if (ikvs) {
         kk->kk_ikvs = NULL;
+
+        /* The merge operator must be registered again on the next open. */
+        atomic_set(&kk->kk_merge_fn, NULL);
+        kk->kk_merge_arg = NULL;
+    }
     mutex_unlock(&parent->ikdb_lock);
 
     if (ev(!ikvs))
@@ -2159,6 +2185,10 @@ ikvdb_close(struct ikvdb *handle)
         destroy_workqueue(self->ikdb_workqueue);
     }
 
+    /* Drain outstanding threaded gets before tearing down the KVSes.
+     */
+    destroy_workqueue(self->ikdb_get_wq);
+
     /* Removing the endpoints before trying to get ikdb_lock prevents deadlock
      * between this call and an ongoing call to ikvdb_kvs_names_get().
      */
@@ -2327,13 +2357,13 @@ ikvdb_kvs_put(
         }
 
         if (vbuf) {
-            err = kk->kk_vcompress(vt->vt_data, vlen, vbuf, vbufsz, &clen);
+            err = kk->kk_vcompress(vt->vt_data, vlen, vbuf, vbufsz, kk->kk_vcomp_level, &clen);
 
             /* Save space by storing the original value if the compressed length
              * is larger than the original length.
              */
             if (!err && clen < vlen) {
-                kvs_vtuple_cinit(vt, vbuf, vlen, clen);
+                kvs_vtuple_cinit(vt, vbuf, vlen, clen, kk->kk_vcomp_algo);
                 vlen = clen;
             }
         }
@@ -2353,94 +2383,143 @@ ikvdb_kvs_put(
 }
 
 merr_t
-ikvdb_kvs_pfx_probe(
+ikvdb_kvs_write_batch(
     struct hse_kvs *handle,
     const unsigned int flags,
-    struct hse_kvdb_txn * const txn,
-    struct kvs_ktuple *kt,
-    enum key_lookup_res *res,
-    struct kvs_buf *kbuf,
-    struct kvs_buf *vbuf)
+    size_t cnt,
+    struct kvs_batch_op *opv)
 {
     struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
-    struct ikvdb_impl *p;
-    uint64_t view_seqno;
+    struct ikvdb_impl *parent;
+    merr_t err = 0;
 
-    if (ev(!handle))
-        return merr(EINVAL);
+    INVARIANT(handle && (opv || cnt == 0));
 
-    if (ev(!is_read_allowed(kk->kk_ikvs, txn)))
+    if (HSE_UNLIKELY(!is_write_allowed(kk->kk_ikvs, NULL)))
         return merr(EINVAL);
 
-    p = kk->kk_parent;
+    parent = kk->kk_parent;
+    if (HSE_UNLIKELY(!parent->ikdb_allow_writes))
+        return merr(EROFS);
 
-    if (txn) {
-        /*
-         * No need to wait for ongoing commits. A transaction waited when its view was
-         * being established i.e. at the time of transaction begin.
+    err = kvdb_health_check(&parent->ikdb_health, KVDB_HEALTH_FLAG_ALL);
+    if (err)
+        return err;
+
+    while (cnt > 0 && !err) {
+        uint n = min_t(size_t, cnt, HSE_C0SK_BATCH_MAX);
+        size_t used = 0, bytes = 0;
+
+        /* Values are compressed back to back into tls_vbuf, which remains
+         * valid until kvs_write_batch() has copied them into the wal and c0.
+         * Values that do not fit in what remains of tls_vbuf are stored
+         * uncompressed.
          */
-        view_seqno = 0;
-    } else {
-        /* Establish our view before waiting on ongoing commits. */
-        view_seqno = atomic_read(&p->ikdb_seqno);
-        kvdb_ctxn_set_wait_commits(p->ikdb_ctxn_set, 0);
+        for (uint i = 0; i < n; ++i) {
+            struct kvs_vtuple *vt = &opv[i].bo_vt;
+            uint vlen, clen = 0;
+
+            bytes += opv[i].bo_kt.kt_len;
+            if (opv[i].bo_del)
+                continue;
+
+            vlen = kvs_vtuple_vlen(vt);
+
+            if (vlen > VCOMP_VALUE_THRESHOLD && used + vlen < tls_vbufsz &&
+                kvs_vtuple_clen(vt) == 0 && is_compression_allowed(kk, flags)) {
+
+                merr_t cerr;
+
+                cerr = kk->kk_vcompress(
+                    vt->vt_data, vlen, tls_vbuf + used, tls_vbufsz - used, kk->kk_vcomp_level,
+                    &clen);
+                if (!cerr && clen < vlen) {
+                    kvs_vtuple_cinit(vt, tls_vbuf + used, vlen, clen, kk->kk_vcomp_algo);
+                    used += clen;
+                    vlen = clen;
+                }
+            }
+
+            bytes += vlen;
+        }
+
+        err = kvs_write_batch(kk->kk_ikvs, n, opv);
+
+        if (!(flags & HSE_KVS_PUT_PRIO || parent->ikdb_rp.throttle_disable))
+            throttle(parent->ikdb_sensor, &hse_throttle_tls, bytes);
+
+        opv += n;
+        cnt -= n;
     }
 
-    return kvs_pfx_probe(kk->kk_ikvs, txn, kt, view_seqno, res, kbuf, vbuf);
+    return err;
 }
 
-merr_t
-ikvdb_kvs_get(
-    struct hse_kvs *handle,
-    const unsigned int flags,
-    struct hse_kvdb_txn * const txn,
-    struct kvs_ktuple *kt,
-    enum key_lookup_res *res,
-    struct kvs_buf *vbuf)
-{
-    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
-    struct ikvdb_impl *p;
-    uint64_t view_seqno;
-
-    if (ev(!handle))
-        return merr(EINVAL);
+/**
+ * struct hse_kvs_bulk - a bulk load into a kvs
+ * @kb_kk:        kvs being loaded (holds a reference on it)
+ * @kb_cn:        cn bulk load
+ * @kb_seqno:     seqno of every value of the load
+ * @kb_frozen:    the view sets are frozen while the load is published
+ * @kb_committed: the load has been committed
+ */
+struct hse_kvs_bulk {
+    struct kvdb_kvs *kb_kk;
+    struct cn_bulk  *kb_cn;
+    uint64_t         kb_seqno;
+    bool             kb_frozen;
+    bool             kb_committed;
+};
 
-    if (ev(!is_read_allowed(kk->kk_ikvs, txn)))
-        return merr(EINVAL);
+/* The load's seqno was minted at create time, but the load becomes visible
+ * only at commit.  A view at or above the load's seqno which exists at commit
+ * time would see the load appear out of nowhere, hence such views must hold
+ * off the commit.
+ */
+static bool
+ikvdb_kvs_bulk_views_busy(struct hse_kvs_bulk *bulk, bool freeze)
+{
+    struct ikvdb_impl *parent = bulk->kb_kk->kk_parent;
+    uint64_t txn_max, cur_max;
 
-    p = kk->kk_parent;
+    viewset_freeze(parent->ikdb_txn_viewset, &txn_max);
+    viewset_freeze(parent->ikdb_cur_viewset, &cur_max);
 
-    if (txn) {
-        /*
-         * No need to wait for ongoing commits. A transaction waited when its view was
-         * being established i.e. at the time of transaction begin.
-         */
-        view_seqno = 0;
+    if (freeze) {
+        bulk->kb_frozen = true;
     } else {
-        /* Establish our view before waiting on ongoing commits. */
-        view_seqno = atomic_read(&p->ikdb_seqno);
-        kvdb_ctxn_set_wait_commits(p->ikdb_ctxn_set, 0);
+        viewset_thaw(parent->ikdb_cur_viewset);
+        viewset_thaw(parent->ikdb_txn_viewset);
     }
 
-    return kvs_get(kk->kk_ikvs, txn, kt, view_seqno, res, vbuf);
+    return max(txn_max, cur_max) >= bulk->kb_seqno;
+}
+
+/* Called by cn_bulk_commit() under the ingest lock, before the load is
+ * recorded in cndb.  The view sets stay frozen until the commit returns,
+ * such that no view can be created in between the check and the load
+ * becoming visible.
+ */
+static merr_t
+ikvdb_kvs_bulk_publish_cb(void *arg)
+{
+    struct hse_kvs_bulk *bulk = arg;
+
+    return ikvdb_kvs_bulk_views_busy(bulk, true) ? merr(EBUSY) : 0;
 }
 
 merr_t
-ikvdb_kvs_del(
-    struct hse_kvs *handle,
-    const unsigned int flags,
-    struct hse_kvdb_txn * const txn,
-    struct kvs_ktuple *kt)
+ikvdb_kvs_bulk_create(struct hse_kvs *handle, const unsigned int flags, struct hse_kvs_bulk **bulkp)
 {
     struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
     struct ikvdb_impl *parent;
-    uint64_t seqnoref;
+    struct hse_kvs_bulk *bulk;
+    uint64_t seqno;
     merr_t err;
 
-    if (ev(!handle))
-        return merr(EINVAL);
+    INVARIANT(handle && bulkp);
 
-    if (ev(!is_write_allowed(kk->kk_ikvs, txn)))
+    if (ev(!is_write_allowed(kk->kk_ikvs, NULL)))
         return merr(EINVAL);
 
     parent = kk->kk_parent;
@@ -2451,145 +2530,938 @@ ikvdb_kvs_del(
     if (ev(err))
         return err;
 
-    seqnoref = txn ? 0 : HSE_SQNREF_SINGLE;
+    bulk = malloc(sizeof(*bulk));
+    if (ev(!bulk))
+        return merr(ENOMEM);
 
-    return kvs_del(kk->kk_ikvs, txn, kt, seqnoref);
+    /* Every value of the load carries the same seqno, minted now such that
+     * it orders after everything already put and before everything put from
+     * here on.
+     */
+    seqno = atomic_inc_acq_return(&parent->ikdb_seqno);
+
+    err = cn_bulk_create(kvs_cn(kk->kk_ikvs), seqno, &bulk->kb_cn);
+    if (ev(err)) {
+        free(bulk);
+        return err;
+    }
+
+    atomic_inc(&kk->kk_refcnt);
+
+    bulk->kb_kk = kk;
+    bulk->kb_seqno = seqno;
+    bulk->kb_frozen = false;
+    bulk->kb_committed = false;
+
+    *bulkp = bulk;
+
+    return 0;
 }
 
 merr_t
-ikvdb_kvs_prefix_delete(
-    struct hse_kvs *handle,
+ikvdb_kvs_bulk_put(
+    struct hse_kvs_bulk *bulk,
     const unsigned int flags,
-    struct hse_kvdb_txn * const txn,
-    struct kvs_ktuple *kt)
+    struct kvs_ktuple *kt,
+    struct kvs_vtuple *vt)
 {
-    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
-    struct ikvdb_impl *parent;
-    uint64_t seqnoref;
+    struct kvdb_kvs *kk = bulk->kb_kk;
+    struct kvs_vtuple vtbuf;
+    size_t vbufsz;
+    uint vlen, clen;
+    void *vbuf;
     merr_t err;
 
-    INVARIANT(handle);
-    INVARIANT(kt->kt_data);
-    INVARIANT(kt->kt_len > 0 && kt->kt_len <= HSE_KVS_PFX_LEN_MAX);
+    INVARIANT(bulk && kt && vt);
 
-    if (ev(!is_write_allowed(kk->kk_ikvs, txn)))
+    if (ev(bulk->kb_committed))
         return merr(EINVAL);
 
-    parent = kk->kk_parent;
-    if (!parent->ikdb_allow_writes)
-        return merr(EROFS);
-
-    err = kvdb_health_check(&parent->ikdb_health, KVDB_HEALTH_FLAG_ALL);
-    if (ev(err))
-        return err;
+    vtbuf = *vt;
+    vt = &vtbuf;
 
-    /* [HSE_REVISIT]: Should this be an invariant? */
-    if (kt->kt_len != kk->kk_cparams->pfx_len)
-        return merr(EINVAL);
+    vlen = kvs_vtuple_vlen(vt);
+    clen = kvs_vtuple_clen(vt);
 
-    seqnoref = txn ? 0 : HSE_SQNREF_SINGLE;
+    vbufsz = tls_vbufsz;
+    vbuf = NULL;
 
-    /* Prefix tombstone deletes all current keys with a matching prefix -
-     * those with a sequence number up to but excluding the current seqno.
-     * Insert prefix tombstone with a higher seqno. Use a higher sequence
-     * number to allow newer mutations (after prefix) to be distinguished.
+    /* Values are compressed as by ikvdb_kvs_put().  The kvset builder copies
+     * them into its vblock buffer before cn_bulk_add() returns.
      */
-    return kvs_prefix_del(kk->kk_ikvs, txn, kt, seqnoref);
-}
-
-/*-  IKVDB Cursors --------------------------------------------------*/
+    if (clen == 0 && vlen > VCOMP_VALUE_THRESHOLD && is_compression_allowed(kk, flags)) {
+        if (vlen > kk->kk_vcompbnd) {
+            vbufsz = vlen + PAGE_SIZE * 2;
+            vbuf = vlb_alloc(vbufsz);
+        } else {
+            vbuf = tls_vbuf;
+        }
 
-/*
- * IKVDB cursors allow iteration over a single KVS' c0, cN, and ctxn.
- * The normal life-cycle is create-iterate-destroy, where iterate has
- * several verbs: seek, read, bind, and update.  Cursors are single-threaded
- * and they are stateful.  These states are:
- *
- * 0 nil - cursor does not exist
- * 1 use - cursor has been created, and is iteratable
- * 2 err - cursor is in error and must be destroyed
- * 3 txn - cursor is bound to a transaction
- * 4 inv - cursor is invalid, either because the txn commited/aborted
- *         or because the cursor was holding onto resources too long
- *         and they were removed.
- *
- * These states are operated on by direct calls into kvdb, or indirectly
- * due to an asynchronous timeout, or an error resulting from a kvdb call.
- *
- * The state transition table (dashes represent invalid verbs for a state):
- *
- *              0/nil   1/use   2/err   3/txn   4/inv
- *      create  1       -       -       -       -
- *      destroy -       0       0       0       0
- *      update  -       1a      -       3b      1a
- *      bind    -       3c      -       -       3c
- *      commit  -       -       -       4       -
- *      abort   -       -       -       4       -
- *
- * a - view seqno is updated as in create
- * b - view seqno remains same, but all existing keys in txn become visible
- * c - view seqno is set to the transactions view
- *
- * Seek and read are available in states 1 and 3, and return ESTALE in 4.
- * They can only operate over the keys visible at the time of the create
- * or last update.
- *
- * State 2 can only occur if there is an error in an underlying operation.
- *
- * Transactions only interact with bound cursors (state 3); transaction
- * puts and dels after bind are invisible until a subsequent update,
- * just as puts and dels after create are invisible until an update.
- */
+        if (vbuf) {
+            err = kk->kk_vcompress(vt->vt_data, vlen, vbuf, vbufsz, kk->kk_vcomp_level, &clen);
+            if (!err && clen < vlen)
+                kvs_vtuple_cinit(vt, vbuf, vlen, clen, kk->kk_vcomp_algo);
+        }
+    }
 
-static void
-cursor_view_release(struct hse_kvs_cursor *cursor)
-{
-    uint64_t minview;
-    uint32_t minchg;
+    err = cn_bulk_add(bulk->kb_cn, kt, vt);
 
-    if (!cursor->kc_on_list)
-        return;
+    if (vbuf && vbuf != tls_vbuf)
+        vlb_free(vbuf, (vbufsz > VLB_ALLOCSZ_MAX) ? vbufsz : clen);
 
-    viewset_remove(cursor->kc_kvs->kk_viewset, cursor->kc_viewcookie, &minchg, &minview);
-    cursor->kc_on_list = false;
+    return err;
 }
 
-static merr_t
-cursor_view_acquire(struct hse_kvs_cursor *cur, uint64_t *tseqnop)
+merr_t
+ikvdb_kvs_bulk_commit(struct hse_kvs_bulk *bulk, const unsigned int flags)
 {
+    struct ikvdb_impl *parent;
     merr_t err;
 
-    /* Add to cursor list only if this is NOT part of a txn.
-     */
-    if (cur->kc_seq != HSE_SQNREF_UNDEFINED)
-        return 0;
+    INVARIANT(bulk);
 
-    err = viewset_insert(cur->kc_kvs->kk_viewset, &cur->kc_seq, tseqnop, &cur->kc_viewcookie);
-    if (!err)
-        cur->kc_on_list = true;
+    if (ev(bulk->kb_committed))
+        return merr(EINVAL);
 
-    return err;
-}
+    parent = bulk->kb_kk->kk_parent;
 
-static merr_t
-cursor_unbind_txn(struct hse_kvs_cursor *cur)
-{
-    struct kvdb_ctxn_bind *bind = cur->kc_bind;
+    err = kvdb_health_check(&parent->ikdb_health, KVDB_HEALTH_FLAG_ALL);
+    if (ev(err))
+        return err;
 
-    if (bind) {
-        cur->kc_gen = -1;
-        cur->kc_bind = 0;
-        kvdb_ctxn_cursor_unbind(bind);
-    }
+    /* Refuse early rather than ingest c0 only to be refused by the publish
+     * callback, which makes the definitive check.  Either way the load is
+     * kept for a retry.
+     */
+    if (ikvdb_kvs_bulk_views_busy(bulk, false))
+        return merr(EBUSY);
 
-    return 0;
-}
+    /* Ingest whatever c0 holds before linking in the load, such that no
+     * value older than the load can ever land in cn above it.
+     */
+    err = c0sk_sync(parent->ikdb_c0sk, 0);
+    if (ev(err))
+        return err;
+
+    err = cn_bulk_commit(bulk->kb_cn, ikvdb_kvs_bulk_publish_cb, bulk);
+
+    if (bulk->kb_frozen) {
+        viewset_thaw(parent->ikdb_cur_viewset);
+        viewset_thaw(parent->ikdb_txn_viewset);
+        bulk->kb_frozen = false;
+    }
+
+    if (ev(err))
+        return err;
+
+    bulk->kb_committed = true;
+
+    return 0;
+}
+
+void
+ikvdb_kvs_bulk_destroy(struct hse_kvs_bulk *bulk)
+{
+    if (!bulk)
+        return;
+
+    cn_bulk_destroy(bulk->kb_cn);
+    atomic_dec(&bulk->kb_kk->kk_refcnt);
+    free(bulk);
+}
 
 merr_t
-ikvdb_kvs_cursor_create(
+ikvdb_kvs_merge_register(struct hse_kvs *handle, hse_kvs_merge_fn *fn, void *arg)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_impl *parent = kk->kk_parent;
+    merr_t err = 0;
+
+    /* The operator is set once per open, and is published after its
+     * argument such that hse_kvs_merge() never sees one without the other.
+     */
+    mutex_lock(&parent->ikdb_lock);
+    if (atomic_read(&kk->kk_merge_fn)) {
+        err = merr(EEXIST);
+    } else {
+        kk->kk_merge_arg = arg;
+        atomic_set_rel(&kk->kk_merge_fn, fn);
+    }
+    mutex_unlock(&parent->ikdb_lock);
+
+    return err;
+}
+
+/* Values of up to this length are merged in thread-local buffers.  Larger
+ * values are merged in buffers from the vlb cache sized to the value.
+ */
+#define IKVDB_MERGE_TLS_VLEN (4096)
+
+static thread_local char ikvdb_merge_tls[IKVDB_MERGE_TLS_VLEN * 3] HSE_ALIGNED(PAGE_SIZE);
+
+/**
+ * struct ikvdb_merge_ctx - state of one hse_kvs_merge() call
+ * @kk:          kvs
+ * @key:         key
+ * @key_len:     key length
+ * @operand:     merge operand
+ * @operand_len: merge operand length
+ * @need_base:   the key's value must be read from below the active kvms
+ * @base_res:    lookup result for the value below the active kvms (zero if
+ *               it has not been read)
+ * @base:        the value below the active kvms
+ * @merge_fn:    merge operator
+ * @merge_arg:   argument for @merge_fn
+ * @need_len:    buffer length needed for the merge to go on (zero if the
+ *               buffers are large enough)
+ * @vmax:        length of each of the current value, base value and merge
+ *               operator output buffers
+ * @buf:         the three buffers, in that order
+ */
+struct ikvdb_merge_ctx {
+    struct kvdb_kvs    *kk;
+    const void         *key;
+    size_t              key_len;
+    const void         *operand;
+    size_t              operand_len;
+    bool                need_base;
+    enum key_lookup_res base_res;
+    struct kvs_buf      base;
+    hse_kvs_merge_fn   *merge_fn;
+    void               *merge_arg;
+    size_t              need_len;
+    size_t              vmax;
+    char               *buf;
+};
+
+static void
+ikvdb_merge_ctx_buf_free(struct ikvdb_merge_ctx *ctx)
+{
+    if (ctx->buf != ikvdb_merge_tls)
+        vlb_free(ctx->buf, ctx->vmax * 3);
+}
+
+/* Replace the buffers with ones that can hold a value of the given length.
+ */
+static merr_t
+ikvdb_merge_ctx_buf_grow(struct ikvdb_merge_ctx *ctx, size_t vlen)
+{
+    size_t vmax = ALIGN(vlen, PAGE_SIZE);
+    char *buf;
+
+    assert(vmax > ctx->vmax && vmax <= ALIGN(HSE_KVS_VALUE_LEN_MAX, PAGE_SIZE));
+
+    buf = vlb_alloc(vmax * 3);
+    if (ev(!buf))
+        return merr(ENOMEM);
+
+    ikvdb_merge_ctx_buf_free(ctx);
+
+    ctx->buf = buf;
+    ctx->vmax = vmax;
+
+    return 0;
+}
+
+static merr_t
+ikvdb_kvs_merge_cb(
+    void *arg,
+    enum key_lookup_res res,
+    const struct kvs_buf *cur,
+    struct kvs_vtuple *vt)
+{
+    struct ikvdb_merge_ctx *ctx = arg;
+    const void *base = NULL;
+    size_t base_len = 0, val_len = 0;
+    int rc;
+
+    /* The key has neither a value nor a tombstone in the active kvms, so
+     * whatever value it has lies in older data which must be read first.
+     */
+    if (res == NOT_FOUND) {
+        if (!ctx->base_res) {
+            ctx->need_base = true;
+            return merr(ENOENT);
+        }
+
+        res = ctx->base_res;
+        cur = &ctx->base;
+    }
+
+    if (res == FOUND_VAL) {
+        base = cur->b_buf;
+        base_len = cur->b_len;
+
+        /* A value which fills the buffer may have been truncated (the
+         * length of a truncated compressed value is that of the copy).
+         */
+        if (base_len >= cur->b_buf_sz && cur->b_buf_sz < HSE_KVS_VALUE_LEN_MAX) {
+            ctx->need_len = max_t(size_t, base_len, cur->b_buf_sz * 2);
+            ctx->need_len = min_t(size_t, ctx->need_len, HSE_KVS_VALUE_LEN_MAX);
+            return merr(ENOBUFS);
+        }
+    }
+
+    rc = ctx->merge_fn(
+        ctx->merge_arg, ctx->key, ctx->key_len, base, base_len, ctx->operand, ctx->operand_len,
+        ctx->buf + ctx->vmax * 2, ctx->vmax, &val_len);
+    if (rc)
+        return merr(rc);
+
+    if (ev(val_len > HSE_KVS_VALUE_LEN_MAX))
+        return merr(EMSGSIZE);
+
+    if (val_len > ctx->vmax) {
+        ctx->need_len = val_len;
+        return merr(ENOBUFS);
+    }
+
+    kvs_vtuple_init(vt, ctx->buf + ctx->vmax * 2, val_len);
+
+    return 0;
+}
+
+merr_t
+ikvdb_kvs_merge(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct kvs_ktuple *kt,
+    const void *operand,
+    size_t operand_len)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_merge_ctx ctx = {};
+    struct ikvdb_impl *parent;
+    struct kvs_ktuple ktbuf;
+    struct kvs_buf cur;
+    merr_t err;
+
+    INVARIANT(handle && kt);
+
+    if (ev(!is_write_allowed(kk->kk_ikvs, NULL)))
+        return merr(EINVAL);
+
+    ctx.merge_fn = atomic_read_acq(&kk->kk_merge_fn);
+    if (ev(!ctx.merge_fn))
+        return merr(EINVAL);
+
+    ctx.merge_arg = kk->kk_merge_arg;
+
+    parent = kk->kk_parent;
+    if (!parent->ikdb_allow_writes)
+        return merr(EROFS);
+
+    err = kvdb_health_check(&parent->ikdb_health, KVDB_HEALTH_FLAG_ALL);
+    if (ev(err))
+        return err;
+
+    ktbuf = *kt;
+
+    ctx.kk = kk;
+    ctx.key = kt->kt_data;
+    ctx.key_len = kt->kt_len;
+    ctx.operand = operand;
+    ctx.operand_len = operand_len;
+    ctx.vmax = IKVDB_MERGE_TLS_VLEN;
+    ctx.buf = ikvdb_merge_tls;
+
+    /* Try to merge with the key's value in the active kvms, which for hot
+     * keys is where it will be found.  Otherwise, read the value from older
+     * data and merge again, which succeeds unless the active kvms changed
+     * while the value was being read.  A change of the active kvms at any
+     * point restarts the merge from scratch, as does a value too large for
+     * the buffers, which are then grown to fit it.
+     */
+    while (1) {
+        uint64_t gen = 0, view_seqno;
+
+        kvs_buf_init(&cur, ctx.buf, ctx.vmax);
+        ctx.need_base = false;
+        ctx.base_res = 0;
+        ctx.need_len = 0;
+
+        err = kvs_merge(kk->kk_ikvs, &ktbuf, &gen, &cur, ikvdb_kvs_merge_cb, &ctx);
+
+        if (ctx.need_base) {
+            view_seqno = atomic_read(&parent->ikdb_seqno);
+            kvdb_ctxn_set_wait_commits(parent->ikdb_ctxn_set, 0);
+
+            kvs_buf_init(&ctx.base, ctx.buf + ctx.vmax, ctx.vmax);
+
+            err = kvs_get(kk->kk_ikvs, NULL, &ktbuf, view_seqno, false, &ctx.base_res, &ctx.base);
+            if (ev(err))
+                break;
+
+            err = kvs_merge(kk->kk_ikvs, &ktbuf, &gen, &cur, ikvdb_kvs_merge_cb, &ctx);
+        }
+
+        if (ctx.need_len) {
+            err = ikvdb_merge_ctx_buf_grow(&ctx, ctx.need_len);
+            if (ev(err))
+                break;
+            continue;
+        }
+
+        if (merr_errno(err) != EAGAIN)
+            break;
+    }
+
+    ikvdb_merge_ctx_buf_free(&ctx);
+
+    if (!(flags & HSE_KVS_PUT_PRIO || parent->ikdb_rp.throttle_disable))
+        throttle(parent->ikdb_sensor, &hse_throttle_tls, kt->kt_len + operand_len);
+
+    return err;
+}
+
+/**
+ * struct hse_kvdb_snapshot - a long-lived, transaction-free read view
+ * @ks_ikvdb:  kvdb the snapshot was taken on
+ * @ks_seqno:  view seqno
+ * @ks_cookie: viewset entry which holds the horizon at or below @ks_seqno
+ *
+ * A snapshot pins only a cursor viewset entry, so unlike a transaction it
+ * has no write set and is never aborted by the transaction reaper.
+ */
+struct hse_kvdb_snapshot {
+    struct ikvdb_impl *ks_ikvdb;
+    uint64_t           ks_seqno;
+    void              *ks_cookie;
+};
+
+merr_t
+ikvdb_snapshot_create(struct ikvdb *handle, struct hse_kvdb_snapshot **snapp)
+{
+    struct ikvdb_impl *self = ikvdb_h2r(handle);
+    struct hse_kvdb_snapshot *snap;
+    uint64_t tseqno;
+    merr_t err;
+
+    snap = malloc(sizeof(*snap));
+    if (ev(!snap))
+        return merr(ENOMEM);
+
+    snap->ks_ikvdb = self;
+
+    err = viewset_insert(self->ikdb_cur_viewset, &snap->ks_seqno, &tseqno, &snap->ks_cookie);
+    if (ev(err)) {
+        free(snap);
+        return err;
+    }
+
+    /* As for non-txn cursors, wait for ongoing commits to finish so that
+     * the snapshot never sees a partial txn.
+     */
+    kvdb_ctxn_set_wait_commits(self->ikdb_ctxn_set, tseqno);
+
+    *snapp = snap;
+
+    return 0;
+}
+
+void
+ikvdb_snapshot_release(struct ikvdb *handle, struct hse_kvdb_snapshot *snap)
+{
+    struct ikvdb_impl *self = ikvdb_h2r(handle);
+    uint64_t minview;
+    uint32_t minchg;
+
+    if (!snap)
+        return;
+
+    assert(snap->ks_ikvdb == self);
+
+    viewset_remove(self->ikdb_cur_viewset, snap->ks_cookie, &minchg, &minview);
+    free(snap);
+}
+
+/* Prefix probes search c0, lc and cn for at most two keys, which a range
+ * tombstone can hide only after the fact.  Count the keys with a cursor,
+ * which filters them against the range tombstones as it goes, instead.
+ */
+static merr_t
+ikvdb_kvs_pfx_probe_cursor(
+    struct hse_kvs *handle,
+    struct hse_kvdb_txn * const txn,
+    struct hse_kvdb_snapshot *snap,
+    struct kvs_ktuple *kt,
+    enum key_lookup_res *res,
+    struct kvs_buf *kbuf,
+    struct kvs_buf *vbuf)
+{
+    struct hse_kvs_cursor *cur;
+    size_t klen, vlen;
+    merr_t err, err2;
+    bool eof;
+
+    if (snap)
+        err = ikvdb_kvs_snapshot_cursor_create(handle, 0, snap, kt->kt_data, kt->kt_len, &cur);
+    else
+        err = ikvdb_kvs_cursor_create(handle, 0, txn, kt->kt_data, kt->kt_len, &cur);
+    if (ev(err))
+        return err;
+
+    err = ikvdb_kvs_cursor_read_copy(
+        cur, 0, kbuf->b_buf, kbuf->b_buf_sz, &klen, vbuf->b_buf, vbuf->b_buf_sz, &vlen, &eof);
+    if (!err && eof) {
+        *res = NOT_FOUND;
+    } else if (!err) {
+        kbuf->b_len = klen;
+        vbuf->b_len = vlen;
+
+        err = kvs_cursor_read(cur, 0, &eof);
+        if (!err)
+            *res = eof ? FOUND_VAL : FOUND_MULTIPLE;
+    }
+
+    err2 = ikvdb_kvs_cursor_destroy(cur);
+
+    return ev(err ?: err2);
+}
+
+merr_t
+ikvdb_kvs_pfx_probe(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    struct kvs_ktuple *kt,
+    enum key_lookup_res *res,
+    struct kvs_buf *kbuf,
+    struct kvs_buf *vbuf)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_impl *p;
+    uint64_t view_seqno;
+
+    if (ev(!handle))
+        return merr(EINVAL);
+
+    if (ev(!is_read_allowed(kk->kk_ikvs, txn)))
+        return merr(EINVAL);
+
+    p = kk->kk_parent;
+
+    if (txn) {
+        /*
+         * No need to wait for ongoing commits. A transaction waited when its view was
+         * being established i.e. at the time of transaction begin.
+         */
+        view_seqno = 0;
+    } else {
+        /* Establish our view before waiting on ongoing commits. */
+        view_seqno = atomic_read(&p->ikdb_seqno);
+        kvdb_ctxn_set_wait_commits(p->ikdb_ctxn_set, 0);
+    }
+
+    if (!txn && kvs_rtomb_pfx_overlap(kk->kk_ikvs, kt, view_seqno))
+        return ikvdb_kvs_pfx_probe_cursor(handle, NULL, NULL, kt, res, kbuf, vbuf);
+
+    return kvs_pfx_probe(kk->kk_ikvs, txn, kt, view_seqno, res, kbuf, vbuf);
+}
+
+merr_t
+ikvdb_kvs_get(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    struct kvs_ktuple *kt,
+    enum key_lookup_res *res,
+    struct kvs_buf *vbuf)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_impl *p;
+    uint64_t view_seqno;
+
+    if (ev(!handle))
+        return merr(EINVAL);
+
+    if (ev(!is_read_allowed(kk->kk_ikvs, txn)))
+        return merr(EINVAL);
+
+    p = kk->kk_parent;
+
+    if (txn) {
+        /*
+         * No need to wait for ongoing commits. A transaction waited when its view was
+         * being established i.e. at the time of transaction begin.
+         */
+        view_seqno = 0;
+    } else {
+        /* Establish our view before waiting on ongoing commits. */
+        view_seqno = atomic_read(&p->ikdb_seqno);
+        kvdb_ctxn_set_wait_commits(p->ikdb_ctxn_set, 0);
+    }
+
+    return kvs_get(kk->kk_ikvs, txn, kt, view_seqno, false, res, vbuf);
+}
+
+merr_t
+ikvdb_kvs_snapshot_get(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    struct kvs_ktuple *kt,
+    enum key_lookup_res *res,
+    struct kvs_buf *vbuf)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+
+    if (ev(!handle || !snap || snap->ks_ikvdb != kk->kk_parent))
+        return merr(EINVAL);
+
+    return kvs_get(kk->kk_ikvs, NULL, kt, snap->ks_seqno, false, res, vbuf);
+}
+
+merr_t
+ikvdb_kvs_snapshot_pfx_probe(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    struct kvs_ktuple *kt,
+    enum key_lookup_res *res,
+    struct kvs_buf *kbuf,
+    struct kvs_buf *vbuf)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+
+    if (ev(!handle || !snap || snap->ks_ikvdb != kk->kk_parent))
+        return merr(EINVAL);
+
+    if (kvs_rtomb_pfx_overlap(kk->kk_ikvs, kt, snap->ks_seqno))
+        return ikvdb_kvs_pfx_probe_cursor(handle, NULL, snap, kt, res, kbuf, vbuf);
+
+    return kvs_pfx_probe(kk->kk_ikvs, NULL, kt, snap->ks_seqno, res, kbuf, vbuf);
+}
+
+/**
+ * struct ikvdb_get_work - a get request queued to the get workqueue
+ * @gw_work:  work struct queued on ikdb_get_wq
+ * @gw_kk:    kvs handle, holds a reference until the get has completed
+ * @gw_ikvs:  kvs instance
+ * @gw_seqno: view seqno established at submission
+ * @gw_kt:    key tuple, points into gw_key[]
+ * @gw_vbuf:  caller's value buffer
+ * @gw_cb:    completion callback
+ * @gw_arg:   completion callback argument
+ * @gw_key:   copy of the caller's key
+ */
+struct ikvdb_get_work {
+    struct work_struct gw_work;
+    struct kvdb_kvs   *gw_kk;
+    struct ikvs       *gw_ikvs;
+    uint64_t           gw_seqno;
+    struct kvs_ktuple  gw_kt;
+    struct kvs_buf     gw_vbuf;
+    hse_kvs_get_cb    *gw_cb;
+    void              *gw_arg;
+    char               gw_key[];
+};
+
+static void
+ikvdb_kvs_get_threaded_worker(struct work_struct *work)
+{
+    struct ikvdb_get_work *gw = container_of(work, struct ikvdb_get_work, gw_work);
+    enum key_lookup_res res = NOT_FOUND;
+    merr_t err;
+
+    /* Read cold values from media rather than taking a major fault on the
+     * mcache map, so that this worker is the only thread that blocks.
+     */
+    err = kvs_get(gw->gw_ikvs, NULL, &gw->gw_kt, gw->gw_seqno, true, &res, &gw->gw_vbuf);
+
+    if (!err && ev(res == FOUND_MULTIPLE))
+        err = merr(EPROTO);
+
+    /* Drop the kvs reference before the callback so that the callback may
+     * close the kvs.
+     */
+    atomic_dec(&gw->gw_kk->kk_refcnt);
+
+    gw->gw_cb(gw->gw_arg, err, !err && res == FOUND_VAL, gw->gw_vbuf.b_len);
+
+    free(gw);
+}
+
+merr_t
+ikvdb_kvs_get_threaded(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct kvs_ktuple *kt,
+    struct kvs_buf *vbuf,
+    hse_kvs_get_cb *cb,
+    void *arg)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_get_work *gw;
+    struct ikvdb_impl *p;
+    struct ikvs *ikvs;
+
+    if (ev(!handle || !cb))
+        return merr(EINVAL);
+
+    p = kk->kk_parent;
+
+    gw = malloc(sizeof(*gw) + kt->kt_len);
+    if (ev(!gw))
+        return merr(ENOMEM);
+
+    atomic_inc(&kk->kk_refcnt);
+
+    ikvs = kk->kk_ikvs;
+    if (ev(!ikvs)) {
+        atomic_dec(&kk->kk_refcnt);
+        free(gw);
+        return merr(EBADF);
+    }
+
+    memcpy(gw->gw_key, kt->kt_data, kt->kt_len);
+    kvs_ktuple_init_nohash(&gw->gw_kt, gw->gw_key, kt->kt_len);
+
+    gw->gw_kk = kk;
+    gw->gw_ikvs = ikvs;
+    gw->gw_vbuf = *vbuf;
+    gw->gw_cb = cb;
+    gw->gw_arg = arg;
+
+    /* Establish our view before waiting on ongoing commits, exactly as
+     * a synchronous get would.
+     */
+    gw->gw_seqno = atomic_read(&p->ikdb_seqno);
+    kvdb_ctxn_set_wait_commits(p->ikdb_ctxn_set, 0);
+
+    INIT_WORK(&gw->gw_work, ikvdb_kvs_get_threaded_worker);
+    queue_work(p->ikdb_get_wq, &gw->gw_work);
+
+    return 0;
+}
+
+merr_t
+ikvdb_kvs_get_multi(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    uint cnt,
+    struct kvs_ktuple *ktv,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_impl *p;
+    uint64_t view_seqno;
+
+    if (ev(!handle))
+        return merr(EINVAL);
+
+    if (ev(!is_read_allowed(kk->kk_ikvs, txn)))
+        return merr(EINVAL);
+
+    p = kk->kk_parent;
+
+    if (txn) {
+        view_seqno = 0;
+    } else {
+        /* Establish one view for the whole batch before waiting on ongoing commits. */
+        view_seqno = atomic_read(&p->ikdb_seqno);
+        kvdb_ctxn_set_wait_commits(p->ikdb_ctxn_set, 0);
+    }
+
+    return kvs_get_multi(kk->kk_ikvs, txn, cnt, ktv, view_seqno, resv, vbufv);
+}
+
+merr_t
+ikvdb_kvs_del(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    struct kvs_ktuple *kt)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_impl *parent;
+    uint64_t seqnoref;
+    merr_t err;
+
+    if (ev(!handle))
+        return merr(EINVAL);
+
+    if (ev(!is_write_allowed(kk->kk_ikvs, txn)))
+        return merr(EINVAL);
+
+    parent = kk->kk_parent;
+    if (!parent->ikdb_allow_writes)
+        return merr(EROFS);
+
+    err = kvdb_health_check(&parent->ikdb_health, KVDB_HEALTH_FLAG_ALL);
+    if (ev(err))
+        return err;
+
+    seqnoref = txn ? 0 : HSE_SQNREF_SINGLE;
+
+    return kvs_del(kk->kk_ikvs, txn, kt, seqnoref);
+}
+
+merr_t
+ikvdb_kvs_prefix_delete(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    struct kvs_ktuple *kt)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_impl *parent;
+    uint64_t seqnoref;
+    merr_t err;
+
+    INVARIANT(handle);
+    INVARIANT(kt->kt_data);
+    INVARIANT(kt->kt_len > 0 && kt->kt_len <= HSE_KVS_PFX_LEN_MAX);
+
+    if (ev(!is_write_allowed(kk->kk_ikvs, txn)))
+        return merr(EINVAL);
+
+    parent = kk->kk_parent;
+    if (!parent->ikdb_allow_writes)
+        return merr(EROFS);
+
+    err = kvdb_health_check(&parent->ikdb_health, KVDB_HEALTH_FLAG_ALL);
+    if (ev(err))
+        return err;
+
+    /* [HSE_REVISIT]: Should this be an invariant? */
+    if (kt->kt_len != kk->kk_cparams->pfx_len)
+        return merr(EINVAL);
+
+    seqnoref = txn ? 0 : HSE_SQNREF_SINGLE;
+
+    /* Prefix tombstone deletes all current keys with a matching prefix -
+     * those with a sequence number up to but excluding the current seqno.
+     * Insert prefix tombstone with a higher seqno. Use a higher sequence
+     * number to allow newer mutations (after prefix) to be distinguished.
+     */
+    return kvs_prefix_del(kk->kk_ikvs, txn, kt, seqnoref);
+}
+
+merr_t
+ikvdb_kvs_range_delete(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct kvs_ktuple *kt_start,
+    struct kvs_ktuple *kt_end)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_impl *parent;
+    merr_t err;
+
+    INVARIANT(handle);
+    INVARIANT(kt_start->kt_data && kt_end->kt_data);
+
+    if (ev(!is_write_allowed(kk->kk_ikvs, NULL)))
+        return merr(EINVAL);
+
+    parent = kk->kk_parent;
+    if (!parent->ikdb_allow_writes)
+        return merr(EROFS);
+
+    err = kvdb_health_check(&parent->ikdb_health, KVDB_HEALTH_FLAG_ALL);
+    if (ev(err))
+        return err;
+
+    return kvs_range_del(kk->kk_ikvs, kt_start, kt_end, &parent->ikdb_seqno);
+}
+
+/*-  IKVDB Cursors --------------------------------------------------*/
+
+/*
+ * IKVDB cursors allow iteration over a single KVS' c0, cN, and ctxn.
+ * The normal life-cycle is create-iterate-destroy, where iterate has
+ * several verbs: seek, read, bind, and update.  Cursors are single-threaded
+ * and they are stateful.  These states are:
+ *
+ * 0 nil - cursor does not exist
+ * 1 use - cursor has been created, and is iteratable
+ * 2 err - cursor is in error and must be destroyed
+ * 3 txn - cursor is bound to a transaction
+ * 4 inv - cursor is invalid, either because the txn commited/aborted
+ *         or because the cursor was holding onto resources too long
+ *         and they were removed.
+ *
+ * These states are operated on by direct calls into kvdb, or indirectly
+ * due to an asynchronous timeout, or an error resulting from a kvdb call.
+ *
+ * The state transition table (dashes represent invalid verbs for a state):
+ *
+ *              0/nil   1/use   2/err   3/txn   4/inv
+ *      create  1       -       -       -       -
+ *      destroy -       0       0       0       0
+ *      update  -       1a      -       3b      1a
+ *      bind    -       3c      -       -       3c
+ *      commit  -       -       -       4       -
+ *      abort   -       -       -       4       -
+ *
+ * a - view seqno is updated as in create
+ * b - view seqno remains same, but all existing keys in txn become visible
+ * c - view seqno is set to the transactions view
+ *
+ * Seek and read are available in states 1 and 3, and return ESTALE in 4.
+ * They can only operate over the keys visible at the time of the create
+ * or last update.
+ *
+ * State 2 can only occur if there is an error in an underlying operation.
+ *
+ * Transactions only interact with bound cursors (state 3); transaction
+ * puts and dels after bind are invisible until a subsequent update,
+ * just as puts and dels after create are invisible until an update.
+ */
+
+static void
+cursor_view_release(struct hse_kvs_cursor *cursor)
+{
+    uint64_t minview;
+    uint32_t minchg;
+
+    if (!cursor->kc_on_list)
+        return;
+
+    viewset_remove(cursor->kc_kvs->kk_viewset, cursor->kc_viewcookie, &minchg, &minview);
+    cursor->kc_on_list = false;
+}
+
+static merr_t
+cursor_view_acquire(struct hse_kvs_cursor *cur, uint64_t *tseqnop)
+{
+    merr_t err;
+
+    /* Add to cursor list only if this is NOT part of a txn.
+     */
+    if (cur->kc_seq != HSE_SQNREF_UNDEFINED)
+        return 0;
+
+    err = viewset_insert(cur->kc_kvs->kk_viewset, &cur->kc_seq, tseqnop, &cur->kc_viewcookie);
+    if (!err)
+        cur->kc_on_list = true;
+
+    return err;
+}
+
+static merr_t
+cursor_unbind_txn(struct hse_kvs_cursor *cur)
+{
+    struct kvdb_ctxn_bind *bind = cur->kc_bind;
+
+    if (bind) {
+        cur->kc_gen = -1;
+        cur->kc_bind = 0;
+        kvdb_ctxn_cursor_unbind(bind);
+    }
+
+    return 0;
+}
+
+static merr_t
+ikvdb_kvs_cursor_create_impl(
     struct hse_kvs *handle,
     const unsigned int flags,
     struct hse_kvdb_txn * const txn,
+    struct hse_kvdb_snapshot *snap,
     const void *prefix,
     size_t pfx_len,
     struct hse_kvs_cursor **cursorp)
@@ -2607,13 +3479,16 @@ ikvdb_kvs_cursor_create(
     if (ev(!is_read_allowed(kk->kk_ikvs, txn)))
         return merr(EINVAL);
 
+    if (ev(snap && snap->ks_ikvdb != ikvdb))
+        return merr(EINVAL);
+
     if (ev(atomic_read(&ikvdb->ikdb_curcnt) > ikvdb->ikdb_curcnt_max))
         return merr(ECANCELED);
 
     pkvsl_pc = kvs_perfc_pkvsl(kk->kk_ikvs);
     tstart = perfc_lat_start(pkvsl_pc);
 
-    vseq = HSE_SQNREF_UNDEFINED;
+    vseq = snap ? snap->ks_seqno : HSE_SQNREF_UNDEFINED;
 
     if (txn) {
         ctxn = kvdb_ctxn_h2h(txn);
@@ -2633,15 +3508,18 @@ ikvdb_kvs_cursor_create(
      *  - initialize cursor
      * The failure path must unregister the cursor from kk_cursors.
      */
-    cur = kvs_cursor_alloc(kk->kk_ikvs, prefix, pfx_len, flags & HSE_CURSOR_CREATE_REV);
+    cur = kvs_cursor_alloc(
+        kk->kk_ikvs, prefix, pfx_len, flags & HSE_CURSOR_CREATE_REV,
+        flags & (HSE_CURSOR_CREATE_KEYS_ONLY | HSE_CURSOR_CREATE_VLEN_ONLY));
     if (ev(!cur))
         return merr(ENOMEM);
 
     cur->kc_pkvsl_pc = pkvsl_pc;
 
-    /* if we have a transaction at all, use its view seqno... */
+    /* if we have a transaction or a snapshot, use its view seqno... */
     cur->kc_seq = vseq;
     cur->kc_flags = flags;
+    cur->kc_snap = !!snap;
 
     cur->kc_kvs = kk;
     cur->kc_gen = 0;
@@ -2662,9 +3540,10 @@ ikvdb_kvs_cursor_create(
 
     /* After acquiring a view, non-txn cursors must wait for ongoing commits
      * to finish to ensure they never see partial txns.  This is not necessary
-     * for txn cursors because their view is inherited from the txn.
+     * for txn and snapshot cursors because their view is inherited from
+     * the txn or snapshot.
      */
-    if (!txn)
+    if (!txn && !snap)
         kvdb_ctxn_set_wait_commits(ikvdb->ikdb_ctxn_set, tseqno);
 
     perfc_inc(&kvdb_metrics_pc, PERFC_BA_KVDBMETRICS_CURCNT);
@@ -2681,6 +3560,138 @@ out:
     return err;
 }
 
+merr_t
+ikvdb_kvs_cursor_create(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_txn * const txn,
+    const void *prefix,
+    size_t pfx_len,
+    struct hse_kvs_cursor **cursorp)
+{
+    return ikvdb_kvs_cursor_create_impl(handle, flags, txn, NULL, prefix, pfx_len, cursorp);
+}
+
+merr_t
+ikvdb_kvs_snapshot_cursor_create(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    struct hse_kvdb_snapshot *snap,
+    const void *prefix,
+    size_t pfx_len,
+    struct hse_kvs_cursor **cursorp)
+{
+    if (ev(!snap))
+        return merr(EINVAL);
+
+    return ikvdb_kvs_cursor_create_impl(handle, flags, NULL, snap, prefix, pfx_len, cursorp);
+}
+
+merr_t
+ikvdb_kvs_cursor_split_create(
+    struct hse_kvs *handle,
+    const unsigned int flags,
+    const void *min,
+    size_t minlen,
+    const void *max,
+    size_t maxlen,
+    uint *cursorc,
+    struct hse_kvs_cursor **cursorv)
+{
+    struct kvdb_kvs *kk = (struct kvdb_kvs *)handle;
+    struct ikvdb_impl *ikvdb = kk->kk_parent;
+    struct hse_kvdb_snapshot *snap;
+    uint8_t lo[HSE_KVS_KEY_LEN_MAX];
+    uint splitc, i, j, n = 0;
+    uint *klenv = NULL;
+    void *keyv = NULL;
+    merr_t err;
+
+    if (ev(*cursorc == 0 || (flags & HSE_CURSOR_CREATE_REV)))
+        return merr(EINVAL);
+
+    if (ev(min && max && keycmp(min, minlen, max, maxlen) > 0))
+        return merr(EINVAL);
+
+    splitc = *cursorc - 1;
+    if (splitc > 0) {
+        keyv = malloc(splitc * (HSE_KVS_KEY_LEN_MAX + sizeof(*klenv)));
+        if (ev(!keyv))
+            return merr(ENOMEM);
+
+        klenv = keyv + splitc * HSE_KVS_KEY_LEN_MAX;
+
+        splitc = cn_split_keys(kvs_cn(kk->kk_ikvs), min, minlen, max, maxlen, splitc, keyv, klenv);
+
+        /* A part starts just past the previous part's upper bound, which
+         * cannot be expressed for a key of maximum length.  Merge such parts
+         * with the next one.
+         */
+        for (i = j = 0; i < splitc; i++) {
+            if (klenv[i] >= HSE_KVS_KEY_LEN_MAX)
+                continue;
+
+            if (i != j) {
+                memcpy(keyv + j * HSE_KVS_KEY_LEN_MAX, keyv + i * HSE_KVS_KEY_LEN_MAX, klenv[i]);
+                klenv[j] = klenv[i];
+            }
+            j++;
+        }
+        splitc = j;
+    }
+
+    /* All the cursors share the view of a transient snapshot.
+     */
+    err = ikvdb_snapshot_create(&ikvdb->ikdb_handle, &snap);
+    if (ev(err))
+        goto out;
+
+    for (i = 0; i <= splitc; i++) {
+        const void *lokey = min, *hikey = max;
+        size_t lolen = minlen, hilen = maxlen;
+        struct hse_kvs_cursor *cur;
+
+        if (i > 0) {
+            uint klen = klenv[i - 1];
+
+            memcpy(lo, keyv + (i - 1) * HSE_KVS_KEY_LEN_MAX, klen);
+            lo[klen] = 0;
+            lokey = lo;
+            lolen = klen + 1;
+        }
+
+        if (i < splitc) {
+            hikey = keyv + i * HSE_KVS_KEY_LEN_MAX;
+            hilen = klenv[i];
+        }
+
+        err = ikvdb_kvs_cursor_create_impl(handle, flags, NULL, snap, NULL, 0, &cur);
+        if (ev(err))
+            break;
+
+        cursorv[n++] = cur;
+
+        if (lokey || hikey) {
+            err = ikvdb_kvs_cursor_seek(cur, 0, lokey, lolen, hikey, hilen, NULL);
+            if (ev(err))
+                break;
+        }
+    }
+
+    ikvdb_snapshot_release(&ikvdb->ikdb_handle, snap);
+
+out:
+    if (err) {
+        while (n > 0)
+            ikvdb_kvs_cursor_destroy(cursorv[--n]);
+    }
+
+    *cursorc = n;
+    free(keyv);
+
+    return err;
+}
+
 merr_t
 ikvdb_kvs_cursor_update_view(struct hse_kvs_cursor *cur, unsigned int flags)
 {
@@ -2693,9 +3704,9 @@ ikvdb_kvs_cursor_update_view(struct hse_kvs_cursor *cur, unsigned int flags)
     if (ev(cur->kc_err))
         return cur->kc_err;
 
-    /* This is a no-op for a transaction cursor.
+    /* This is a no-op for transaction and snapshot cursors.
      */
-    if (cur->kc_bind)
+    if (cur->kc_bind || cur->kc_snap)
         return 0;
 
     cur->kc_seq = HSE_SQNREF_UNDEFINED;
@@ -2876,6 +3887,60 @@ ikvdb_kvs_cursor_read_copy(
     return 0;
 }
 
+merr_t
+ikvdb_kvs_cursor_read_batch(
+    struct hse_kvs_cursor *cur,
+    unsigned int flags,
+    void *buf,
+    size_t buf_sz,
+    struct hse_kvs_cursor_kv *kvv,
+    size_t *kvc,
+    bool *eof)
+{
+    merr_t err;
+    uint64_t tstart;
+
+    tstart = perfc_lat_start(cur->kc_pkvsl_pc);
+
+    if (ev(cur->kc_err))
+        return cur->kc_err;
+
+    /* The txn binding is checked once per batch rather than once per pair.
+     */
+    if (cur->kc_bind) {
+        cur->kc_err = cursor_refresh(cur);
+        if (ev(cur->kc_err))
+            return cur->kc_err;
+    }
+
+    err = kvs_cursor_read_batch(cur, flags, buf, buf_sz, kvv, kvc, eof);
+    if (ev(err))
+        return err;
+
+    if (*kvc > 0)
+        perfc_lat_record(
+            cur->kc_pkvsl_pc,
+            cur->kc_flags & HSE_CURSOR_CREATE_REV ? PERFC_LT_PKVSL_KVS_CURSOR_READREV
+                                                  : PERFC_LT_PKVSL_KVS_CURSOR_READFWD,
+            tstart);
+
+    return 0;
+}
+
+merr_t
+ikvdb_kvs_cursor_filter_set(
+    struct hse_kvs_cursor *cur,
+    bool (*filter)(void *arg, const void *key, size_t key_len),
+    void *arg)
+{
+    if (ev(cur->kc_err))
+        return cur->kc_err;
+
+    kvs_cursor_filter_set(cur, filter, arg);
+
+    return 0;
+}
+
 merr_t
 ikvdb_kvs_cursor_destroy(struct hse_kvs_cursor *cur)
 {
@@ -2937,6 +4002,115 @@ ikvdb_sync(struct ikvdb *handle, const unsigned int flags)
     return c0sk_sync(self->ikdb_c0sk, flags);
 }
 
+struct ikvdb_ckpt {
+    struct cndb *ck_cndb;
+    struct wal *ck_wal;
+    const char **ck_paths;
+};
+
+static merr_t
+ikvdb_checkpoint_cb(void *arg)
+{
+    struct ikvdb_ckpt *ckpt = arg;
+    merr_t err;
+
+    /* The WAL is pinned by the caller, hence every WAL file holding data
+     * not yet ingested as of the cndb clone still exists when it is cloned.
+     */
+    err = cndb_checkpoint(ckpt->ck_cndb, ckpt->ck_paths);
+    if (!err && ckpt->ck_wal)
+        err = wal_checkpoint(ckpt->ck_wal, ckpt->ck_paths);
+
+    return err;
+}
+
+merr_t
+ikvdb_checkpoint(struct ikvdb *handle, const char *dest)
+{
+    struct ikvdb_impl *self = ikvdb_h2r(handle);
+    char pathv[HSE_MCLASS_COUNT][PATH_MAX];
+    const char *paths[HSE_MCLASS_COUNT] = { 0 };
+    struct mpool_dparams dparams = { 0 };
+    struct ikvdb_ckpt ckpt;
+    struct kvdb_meta meta;
+    merr_t err;
+    int i;
+
+    if (!self->ikdb_allow_writes)
+        return merr(EROFS);
+
+    err = kvdb_meta_deserialize(&meta, self->ikdb_home);
+    if (err)
+        return err;
+
+    /* Every configured media class is laid out in a subdirectory of the
+     * checkpoint named after the media class, such that the checkpoint is
+     * a self-contained KVDB home.
+     */
+    for (i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++) {
+        const char *name = hse_mclass_name_get(i);
+        int n;
+
+        meta.km_storage[i].path[0] = '\0';
+
+        if (!mpool_mclass_is_configured(self->ikdb_mp, i))
+            continue;
+
+        n = snprintf(pathv[i], sizeof(pathv[i]), "%s/%s", dest, name);
+        if (n >= sizeof(pathv[i]))
+            return merr(ENAMETOOLONG);
+
+        strlcpy(meta.km_storage[i].path, name, sizeof(meta.km_storage[i].path));
+        strlcpy(dparams.mclass[i].path, pathv[i], sizeof(dparams.mclass[i].path));
+        paths[i] = pathv[i];
+    }
+
+    err = kvdb_meta_create(dest);
+    if (err) {
+        log_errx("cannot checkpoint KVDB (%s) to %s, target not empty", err, self->ikdb_home, dest);
+        return err;
+    }
+
+    /* Make all acknowledged mutations durable and ingest c0 into cn, such
+     * that little if any of the WAL needs to be replayed from the checkpoint.
+     */
+    if (self->ikdb_wal)
+        err = wal_sync(self->ikdb_wal);
+
+    if (!err)
+        err = c0sk_sync(self->ikdb_c0sk, 0);
+
+    if (!err) {
+        ckpt.ck_cndb = self->ikdb_cndb;
+        ckpt.ck_wal = self->ikdb_wal;
+        ckpt.ck_paths = paths;
+
+        if (ckpt.ck_wal)
+            wal_pin(ckpt.ck_wal);
+
+        err = mpool_checkpoint(self->ikdb_mp, paths, ikvdb_checkpoint_cb, &ckpt);
+
+        if (ckpt.ck_wal)
+            wal_unpin(ckpt.ck_wal);
+    }
+
+    if (!err)
+        err = kvdb_meta_serialize(&meta, dest);
+
+    if (err) {
+        log_errx("cannot checkpoint KVDB (%s) to %s", err, self->ikdb_home, dest);
+
+        mpool_destroy(dest, &dparams);
+        for (i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++) {
+            if (paths[i])
+                remove(paths[i]);
+        }
+        kvdb_meta_destroy(dest);
+    }
+
+    return err;
+}
+
 uint64_t
 ikvdb_horizon(struct ikvdb *handle)
 {
@@ -3098,9 +4272,12 @@ ikvdb_txn_state(struct ikvdb *handle, struct hse_kvdb_txn *txn)
 
 /* ------------------  WAL replay ikvdb interfaces ---------------- */
 
+/* kk_prev caches the most recently resolved kvs.  It is read and updated
+ * concurrently by the replay apply workers, so only the kvs pointer itself
+ * is cached and its cnid is verified on every hit.
+ */
 struct ikvdb_kvs_hdl {
-    struct kvdb_kvs *kk_prev;
-    uint64_t cnid_prev;
+    struct kvdb_kvs *_Atomic kk_prev;
     size_t cache_sz;
     size_t cheap_sz;
     bool needs_reset;
@@ -3173,16 +4350,17 @@ ikvdb_wal_replay_close(struct ikvdb *ikvdb, struct ikvdb_kvs_hdl *ikvsh)
 static struct kvdb_kvs *
 ikvdb_wal_replay_kvs_get(struct ikvdb_kvs_hdl *ikvsh, uint64_t cnid)
 {
+    struct kvdb_kvs *kk;
     int i;
 
-    if (ikvsh->cnid_prev == cnid)
-        return ikvsh->kk_prev;
+    kk = atomic_read(&ikvsh->kk_prev);
+    if (kk && kk->kk_cnid == cnid)
+        return kk;
 
     for (i = 0; i < ikvsh->kvshc; i++) {
-        struct kvdb_kvs *kk = (struct kvdb_kvs *)ikvsh->kvshv[i];
+        kk = (struct kvdb_kvs *)ikvsh->kvshv[i];
         if (kk->kk_cnid == cnid) {
-            ikvsh->cnid_prev = cnid;
-            ikvsh->kk_prev = kk;
+            atomic_set(&ikvsh->kk_prev, kk);
             return kk;
         }
     }
@@ -3190,6 +4368,26 @@ ikvdb_wal_replay_kvs_get(struct ikvdb_kvs_hdl *ikvsh, uint64_t cnid)
     return NULL;
 }
 
+uint64_t
+ikvdb_wal_replay_key_hash(struct ikvdb_kvs_hdl *ikvsh, uint64_t cnid, const struct kvs_ktuple *kt)
+{
+    struct kvdb_kvs *kk;
+    size_t sfxlen;
+
+    assert(ikvsh && kt);
+
+    kk = ikvdb_wal_replay_kvs_get(ikvsh, cnid);
+    if (!kk)
+        return 0;
+
+    /* Must match the hash computed by kvs_put() and kvs_del() */
+    sfxlen = kk->kk_ikvs->ikv_rp.kvs_sfxlen;
+    if (ev(kt->kt_len < sfxlen))
+        return 0;
+
+    return key_hash64(kt->kt_data, kt->kt_len - sfxlen);
+}
+
 merr_t
 ikvdb_wal_replay_put(
     struct ikvdb *ikvdb,
@@ -3209,7 +4407,7 @@ ikvdb_wal_replay_put(
         return 0; /* Possible that the kvs is dropped just prior to crash */
 
     err = kvs_put(kk->kk_ikvs, NULL, kt, vt, HSE_ORDNL_TO_SQNREF(seqno));
-    if (!err) /* Update ikdb_seqno if it's lower than "seqno", called from the replay thread */
+    if (!err) /* Update ikdb_seqno if it's lower than "seqno", called from a replay worker */
         ikvdb_wal_replay_seqno_set(ikvdb, seqno);
 
     return err;
@@ -3275,14 +4473,20 @@ void
 ikvdb_wal_replay_seqno_set(struct ikvdb *ikvdb, uint64_t seqno)
 {
     struct ikvdb_impl *self;
+    uint64_t cur;
 
     assert(ikvdb);
 
     self = ikvdb_h2r(ikvdb);
 
-    /* This is called only in a single-threaded replay context */
-    if (seqno > atomic_read(&self->ikdb_seqno))
-        atomic_set(&self->ikdb_seqno, seqno);
+    /* Replay applies records from several threads concurrently, so advance
+     * ikdb_seqno only if no other thread has already moved it past seqno.
+     */
+    cur = atomic_read(&self->ikdb_seqno);
+    while (seqno > cur) {
+        if (atomic_cmpxchg(&self->ikdb_seqno, &cur, seqno))
+            break;
+    }
 }
 
 void
@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 
+#include <hse/experimental.h>
 #include <hse/limits.h>
 
 #include <hse/ikvdb/vcomp_params.h>
@@ -26,6 +27,11 @@ struct kvdb_kvs;
  * @kk_parent:       pointer to parent kvdb_impl instance.
  * @kk_vcompbnd:     compression output buffer size estimate for tls_vbuf[]
  * @kk_vcompress:    ptr to value compression function
+ * @kk_vcomp_algo:   algorithm of @kk_vcompress
+ * @kk_vcomp_level:  compression level passed to @kk_vcompress
+ * @kk_merge_fn:     merge operator registered by hse_kvs_merge_register(),
+ *                   published after @kk_merge_arg
+ * @kk_merge_arg:    argument for @kk_merge_fn
  * @kk_cnid:         id of the cn associated with kvdb.
  * @kk_cparams:      cn's create-time parameters.
  * @kk_flags:        flags for cn.
@@ -40,6 +46,10 @@ struct kvdb_kvs {
     enum vcomp_default kk_vcomp_default;
     uint32_t kk_vcompbnd;
     compress_op_compress_t *kk_vcompress;
+    enum vcomp_algorithm kk_vcomp_algo;
+    int kk_vcomp_level;
+    hse_kvs_merge_fn *_Atomic kk_merge_fn;
+    void *kk_merge_arg;
     uint64_t kk_cnid;
     struct kvs_cparams *kk_cparams;
     uint32_t kk_flags;
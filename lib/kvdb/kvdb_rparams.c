@@ -605,6 +605,22 @@ kvdb_open_mode_jsonify(const struct param_spec * const ps, const void * const va
     return cJSON_CreateString(kvdb_mode_to_string(*((enum kvdb_open_mode *)value)));
 }
 
+static bool HSE_NONNULL(1, 2)
+io_uring_enabled_validator(const struct param_spec * const ps, const void * const value)
+{
+    INVARIANT(ps);
+    INVARIANT(value);
+
+#ifndef HAVE_IO_URING
+    if (*(const bool *)value) {
+        log_err("%s: io_uring is not supported by this build", ps->ps_name);
+        return false;
+    }
+#endif
+
+    return true;
+}
+
 static const struct param_spec pspecs[] = {
     {
         .ps_name = "mode",
@@ -1494,6 +1510,69 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "cn_spill_threads",
+        .ps_description = "max number of threads building partitions of large spills",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U16,
+        .ps_offset = offsetof(struct kvdb_rparams, cn_spill_threads),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, cn_spill_threads),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 8,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 1,
+                .ps_max = 256,
+            },
+        },
+    },
+    {
+        .ps_name = "get_threaded_workers",
+        .ps_description = "max number of threads servicing threaded gets",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U16,
+        .ps_offset = offsetof(struct kvdb_rparams, get_threaded_workers),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, get_threaded_workers),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 8,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 1,
+                .ps_max = 256,
+            },
+        },
+    },
+    {
+        .ps_name = "cn_vbcache_mb",
+        .ps_description = "size of the cn vblock cache in MiB (0 disables)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U32,
+        .ps_offset = offsetof(struct kvdb_rparams, cn_vbcache_mb),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, cn_vbcache_mb),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 0,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 0,
+                .ps_max = 1024 * 1024,
+            },
+        },
+    },
     {
         .ps_name = "keylock_tables",
         .ps_description = "number of keylock tables",
@@ -1580,6 +1659,36 @@ static const struct param_spec pspecs[] = {
             .as_uscalar = true,
         },
     },
+    {
+        .ps_name = "storage.capacity.io_uring.enabled",
+        .ps_description = "Use io_uring for capacity mclass mblock I/O",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_BOOL,
+        .ps_offset = offsetof(struct kvdb_rparams, uring_enable[HSE_MCLASS_CAPACITY]),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, uring_enable[HSE_MCLASS_CAPACITY]),
+        .ps_convert = param_default_converter,
+        .ps_validate = io_uring_enabled_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = false,
+        },
+    },
+    {
+        .ps_name = "storage.staging.io_uring.enabled",
+        .ps_description = "Use io_uring for staging mclass mblock I/O",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_BOOL,
+        .ps_offset = offsetof(struct kvdb_rparams, uring_enable[HSE_MCLASS_STAGING]),
+        .ps_size = PARAM_SZ(struct kvdb_rparams, uring_enable[HSE_MCLASS_STAGING]),
+        .ps_convert = param_default_converter,
+        .ps_validate = io_uring_enabled_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = false,
+        },
+    },
 };
 
 const struct param_spec *
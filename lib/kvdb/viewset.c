@@ -292,6 +292,40 @@ viewset_min_view(struct viewset *handle)
     return self->vs_min_view_sn;
 }
 
+void
+viewset_freeze(struct viewset *handle, uint64_t *max_view)
+{
+    struct viewset_impl *self = viewset_h2r(handle);
+    struct viewset_entry *entry;
+    struct viewset_tree *tree;
+    uint64_t max = 0;
+    int i;
+
+    /* View seqnos are minted with the tree lock held, so the last entry
+     * of each list is the newest view of its bucket.
+     */
+    for (i = 0; i < VIEWSET_BKT_MAX; ++i) {
+        tree = self->vs_bktv[i].vsb_tree;
+
+        treelock_lock(tree);
+        entry = list_last_entry_or_null(&tree->vst_head, typeof(*entry), vse_link);
+        if (entry && entry->vse_view_sn > max)
+            max = entry->vse_view_sn;
+    }
+
+    *max_view = max;
+}
+
+void
+viewset_thaw(struct viewset *handle)
+{
+    struct viewset_impl *self = viewset_h2r(handle);
+    int i;
+
+    for (i = VIEWSET_BKT_MAX - 1; i >= 0; --i)
+        treelock_unlock(self->vs_bktv[i].vsb_tree);
+}
+
 /**
  * viewset_update() - update set minimum view seqno
  * @self:       ptr to active_ctxn object
@@ -37,6 +37,23 @@ viewset_horizon(struct viewset *handle);
 uint64_t
 viewset_min_view(struct viewset *handle);
 
+/**
+ * viewset_freeze() - hold off the creation of views
+ * @handle:   viewset handle
+ * @max_view: max view seqno of the views in the set, or zero if none (output)
+ *
+ * Views may be removed from the set only after viewset_thaw().
+ */
+void
+viewset_freeze(struct viewset *handle, uint64_t *max_view);
+
+/**
+ * viewset_thaw() - undo viewset_freeze()
+ * @handle: viewset handle
+ */
+void
+viewset_thaw(struct viewset *handle);
+
 #if HSE_MOCKING
 #include "viewset_ut.h"
 #endif /* HSE_MOCKING */
@@ -12,6 +12,7 @@
 #include <hse/kvdb_perfc.h>
 
 #include <hse/ikvdb/c0.h>
+#include <hse/ikvdb/c0sk.h>
 #include <hse/ikvdb/cn.h>
 #include <hse/ikvdb/cursor.h>
 #include <hse/ikvdb/key_hash.h>
@@ -25,10 +26,13 @@
 #include <hse/logging/logging.h>
 #include <hse/util/alloc.h>
 #include <hse/util/assert.h>
+#include <hse/util/base.h>
 #include <hse/util/byteorder.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/fmt.h>
+#include <hse/util/key_util.h>
 #include <hse/util/map.h>
+#include <hse/util/minmax.h>
 #include <hse/util/perfc.h>
 #include <hse/util/platform.h>
 #include <hse/util/slab.h>
@@ -303,6 +307,7 @@ kvs_put(
 
     if (HSE_LIKELY(!err)) {
         err = c0_put(kvs->ikv_c0, kt, vt, seqnoref);
+        cn_rcache_invalidate(kvs->ikv_cn, kt);
 
         wal_op_finish(kvs->ikv_wal, &rec, kt->kt_seqno, kt->kt_dgen, merr_errno(err));
     }
@@ -315,12 +320,150 @@ kvs_put(
     return err;
 }
 
+merr_t
+kvs_write_batch(struct ikvs *kvs, uint cnt, struct kvs_batch_op *opv)
+{
+    struct wal_record recv[HSE_C0SK_BATCH_MAX];
+    merr_t err = 0;
+    uint i;
+
+    for (i = 0; i < cnt; ++i) {
+        struct kvs_ktuple *kt = &opv[i].bo_kt;
+
+        assert(kt->kt_len >= kvs->ikv_rp.kvs_sfxlen);
+        kt->kt_hash = key_hash64(kt->kt_data, kt->kt_len - kvs->ikv_rp.kvs_sfxlen);
+    }
+
+    /* Each iteration logs as many ops as fit in one wal buffer reservation
+     * and then inserts all of them into c0 in a single pass.
+     */
+    while (cnt > 0 && !err) {
+        uint n = min_t(uint, cnt, NELEM(recv));
+
+        err = wal_write_batch(kvs->ikv_wal, kvs, opv, &n, recv);
+        if (err)
+            break;
+
+        err = c0_write_batch(kvs->ikv_c0, opv, n, HSE_SQNREF_SINGLE);
+
+        for (i = 0; i < n; ++i) {
+            const struct kvs_ktuple *kt = &opv[i].bo_kt;
+
+            cn_rcache_invalidate(kvs->ikv_cn, kt);
+
+            wal_op_finish(
+                kvs->ikv_wal, recv + i, kt->kt_seqno, kt->kt_dgen,
+                kt->kt_dgen ? 0 : merr_errno(err));
+        }
+
+        opv += n;
+        cnt -= n;
+    }
+
+    return err;
+}
+
+merr_t
+kvs_merge(
+    struct ikvs *kvs,
+    struct kvs_ktuple *kt,
+    uint64_t *genp,
+    struct kvs_buf *curbuf,
+    kvs_merge_cb *cb,
+    void *cbarg)
+{
+    const void *kdata;
+    uint32_t kflags;
+    merr_t err;
+
+    assert(kt->kt_len >= kvs->ikv_rp.kvs_sfxlen);
+    kt->kt_hash = key_hash64(kt->kt_data, kt->kt_len - kvs->ikv_rp.kvs_sfxlen);
+    kdata = kt->kt_data;
+    kflags = kt->kt_flags;
+
+    /* The merged value is computed and logged without holding any c0 locks,
+     * and is inserted only if the key has not been updated in the meantime.
+     * Otherwise, its wal record is cancelled and the merge is retried with
+     * the key's new value.  A merge that succeeds thus read the key after
+     * every update that preceded it in c0, and hence logged its record after
+     * theirs.
+     */
+    while (1) {
+        struct c0_merge_ver ver;
+        enum key_lookup_res res;
+        struct wal_record rec;
+        struct kvs_vtuple vt;
+
+        kt->kt_data = kdata;
+        kt->kt_flags = kflags;
+
+        err = c0_merge_read(kvs->ikv_c0, kt, genp, curbuf, &res, &ver);
+        if (err)
+            break;
+
+        err = cb(cbarg, res, curbuf, &vt);
+        if (err)
+            break;
+
+        rec.cookie = -1;
+
+        err = wal_put(kvs->ikv_wal, kvs, kt, &vt, 0, &rec);
+        if (err)
+            break;
+
+        err = c0_merge_commit(kvs->ikv_c0, kt, &vt, HSE_SQNREF_SINGLE, &ver);
+        cn_rcache_invalidate(kvs->ikv_cn, kt);
+
+        wal_op_finish(kvs->ikv_wal, &rec, kt->kt_seqno, kt->kt_dgen, merr_errno(err));
+
+        if (merr_errno(err) != ECANCELED)
+            break;
+    }
+
+    if (err) {
+        kt->kt_data = kdata;
+        kt->kt_flags = kflags;
+    }
+
+    return err;
+}
+
+/* A value found in c0 or lc may have been deleted by a range tombstone
+ * which has yet to be applied by a compaction.
+ */
+static void
+kvs_get_rtomb_filter(
+    struct cn *cn,
+    const struct kvs_ktuple *kt,
+    uint64_t seqno,
+    uint64_t vseq,
+    enum key_lookup_res *res)
+{
+    struct rtomb_set *rtombs;
+    struct key_obj kobj;
+
+    if (*res != FOUND_VAL)
+        return;
+
+    rtombs = cn_rtombs_get(cn);
+    if (!rtombs)
+        return;
+
+    key2kobj(&kobj, kt->kt_data, kt->kt_len);
+
+    if (vseq < cn_rtomb_floor(rtombs, &kobj, seqno))
+        *res = FOUND_TMB;
+
+    cn_rtombs_put(rtombs);
+}
+
 merr_t
 kvs_get(
     struct ikvs *kvs,
     struct hse_kvdb_txn * const txn,
     struct kvs_ktuple *kt,
     uint64_t seqno,
+    bool direct,
     enum key_lookup_res *res,
     struct kvs_buf *vbuf)
 {
@@ -330,6 +473,8 @@ kvs_get(
     struct lc *lc = kvs->ikv_lc;
     struct cn *cn = kvs->ikv_cn;
     uintptr_t seqnoref = 0;
+    uint64_t rcgen = 0;
+    uint64_t vseq = 0;
     uint64_t tstart;
     merr_t err;
 
@@ -340,23 +485,93 @@ kvs_get(
 
     /* Exclusively lock txn for query.
      * seqnoref is invalid ater lock is released.
+     *
+     * Otherwise, sample the row cache generation of the key before
+     * searching c0 so that cn_get() can detect racing updates.
      */
     if (ctxn) {
         err = kvdb_ctxn_trylock_read(ctxn, &seqnoref, &seqno);
         if (err)
             return err;
+    } else {
+        rcgen = cn_rcache_gen(cn, kt);
     }
 
-    err = c0_get(c0, kt, seqno, seqnoref, res, vbuf);
+    err = c0_get(c0, kt, seqno, seqnoref, res, vbuf, &vseq);
 
     if (!err && *res == NOT_FOUND)
         err = lc_get(lc, c0_index(c0), kvs->ikv_pfx_len, kt, seqno, seqnoref, res, vbuf);
+    else if (!err)
+        kvs_get_rtomb_filter(cn, kt, seqno, vseq, res);
 
     if (ctxn)
         kvdb_ctxn_unlock(ctxn);
 
     if (!err && *res == NOT_FOUND)
-        err = cn_get(cn, kt, seqno, res, vbuf);
+        err = cn_get(cn, kt, seqno, rcgen, direct, res, vbuf);
+
+    perfc_lat_record(pkvsl_pc, PERFC_LT_PKVSL_KVS_GET, tstart);
+
+    return err;
+}
+
+merr_t
+kvs_get_multi(
+    struct ikvs *kvs,
+    struct hse_kvdb_txn * const txn,
+    uint cnt,
+    struct kvs_ktuple *ktv,
+    uint64_t seqno,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv)
+{
+    struct kvdb_ctxn *ctxn = txn ? kvdb_ctxn_h2h(txn) : 0;
+    struct perfc_set *pkvsl_pc = kvs_perfc_pkvsl(kvs);
+    struct c0 *c0 = kvs->ikv_c0;
+    struct lc *lc = kvs->ikv_lc;
+    struct cn *cn = kvs->ikv_cn;
+    uintptr_t seqnoref = 0;
+    uint64_t tstart;
+    uint i, misses;
+    merr_t err = 0;
+
+    tstart = perfc_lat_start(pkvsl_pc);
+
+    for (i = 0; i < cnt; ++i) {
+        assert(ktv[i].kt_len >= kvs->ikv_rp.kvs_sfxlen);
+        ktv[i].kt_hash = key_hash64(ktv[i].kt_data, ktv[i].kt_len - kvs->ikv_rp.kvs_sfxlen);
+        resv[i] = NOT_FOUND;
+    }
+
+    /* Exclusively lock txn once for the whole batch.
+     * seqnoref is invalid ater lock is released.
+     */
+    if (ctxn) {
+        err = kvdb_ctxn_trylock_read(ctxn, &seqnoref, &seqno);
+        if (err)
+            return err;
+    }
+
+    for (i = misses = 0; i < cnt && !err; ++i) {
+        uint64_t vseq = 0;
+
+        err = c0_get(c0, ktv + i, seqno, seqnoref, resv + i, vbufv + i, &vseq);
+
+        if (!err && resv[i] == NOT_FOUND)
+            err = lc_get(
+                lc, c0_index(c0), kvs->ikv_pfx_len, ktv + i, seqno, seqnoref, resv + i,
+                vbufv + i);
+        else if (!err)
+            kvs_get_rtomb_filter(cn, ktv + i, seqno, vseq, resv + i);
+
+        misses += (resv[i] == NOT_FOUND);
+    }
+
+    if (ctxn)
+        kvdb_ctxn_unlock(ctxn);
+
+    if (!err && misses > 0)
+        err = cn_get_multi(cn, cnt, ktv, seqno, resv, vbufv);
 
     perfc_lat_record(pkvsl_pc, PERFC_LT_PKVSL_KVS_GET, tstart);
 
@@ -401,6 +616,7 @@ kvs_del(
     err = wal_del(kvs->ikv_wal, kvs, kt, seqno, &rec);
     if (!err) {
         err = c0_del(kvs->ikv_c0, kt, seqnoref);
+        cn_rcache_invalidate(kvs->ikv_cn, kt);
 
         wal_op_finish(kvs->ikv_wal, &rec, kt->kt_seqno, kt->kt_dgen, merr_errno(err));
     }
@@ -451,6 +667,7 @@ kvs_prefix_del(
     err = wal_del_pfx(kvs->ikv_wal, kvs, kt, seqno, &rec);
     if (!err) {
         err = c0_prefix_del(kvs->ikv_c0, kt, seqnoref);
+        cn_rcache_purge(kvs->ikv_cn);
 
         wal_op_finish(kvs->ikv_wal, &rec, kt->kt_seqno, kt->kt_dgen, merr_errno(err));
     }
@@ -463,6 +680,38 @@ kvs_prefix_del(
     return ev(err);
 }
 
+merr_t
+kvs_range_del(
+    struct ikvs *kvs,
+    struct kvs_ktuple *kt_start,
+    struct kvs_ktuple *kt_end,
+    atomic_ulong *kvdb_seqno)
+{
+    merr_t err;
+
+    err = cn_range_delete(kvs->ikv_cn, kt_start, kt_end, kvdb_seqno);
+    if (!err)
+        cn_rcache_purge(kvs->ikv_cn);
+
+    return ev(err);
+}
+
+bool
+kvs_rtomb_pfx_overlap(struct ikvs *kvs, const struct kvs_ktuple *kt, uint64_t seqno)
+{
+    struct rtomb_set *rtombs;
+    bool overlap;
+
+    rtombs = cn_rtombs_get(kvs->ikv_cn);
+    if (!rtombs)
+        return false;
+
+    overlap = cn_rtomb_overlaps_pfx(rtombs, kt->kt_data, kt->kt_len, seqno);
+    cn_rtombs_put(rtombs);
+
+    return overlap;
+}
+
 merr_t
 kvs_pfx_probe(
     struct ikvs *kvs,
@@ -7,6 +7,7 @@
 
 #include <c0/c0_cursor.h>
 
+#include <hse/experimental.h>
 #include <hse/kvdb_perfc.h>
 
 #include <hse/ikvdb/c0.h>
@@ -18,8 +19,8 @@
 #include <hse/ikvdb/lc.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/logging/logging.h>
-#include <hse/util/compression_lz4.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/fmt.h>
 #include <hse/util/keycmp.h>
@@ -166,6 +167,7 @@ struct kvs_cursor_impl {
     struct kvs_cursor_element  kci_ptomb;
     struct key_obj             kci_last_kobj;
     struct key_obj *           kci_last;
+    struct rtomb_set *         kci_rtombs;
     uint8_t *                       kci_last_kbuf;
     uint32_t                        kci_last_klen;
 
@@ -173,6 +175,7 @@ struct kvs_cursor_impl {
     uint32_t kci_need_toss : 1;
     uint32_t kci_need_seek : 1;
     uint32_t kci_reverse : 1;
+    uint32_t kci_novals : 1;
     uint32_t kci_ptomb_set : 1;
 
     uint32_t kci_pfxlen;
@@ -395,9 +398,9 @@ ikvs_curcache_timer_cb(ulong arg)
  * we have to touch while walking the tree.
  */
 static HSE_ALWAYS_INLINE uint64_t
-ikvs_curcache_key(const uint64_t gen, const bool reverse)
+ikvs_curcache_key(const uint64_t gen, const bool reverse, const bool novals)
 {
-    return (gen << 63) | reverse;
+    return (gen << 63) | (novals << 1) | reverse;
 }
 
 static HSE_ALWAYS_INLINE int
@@ -574,6 +577,9 @@ ikvs_cursor_reset(struct kvs_cursor_impl *cursor)
     cursor->kci_ptomb_set = 0;
     cursor->kci_summary.addr = NULL;
 
+    cursor->kci_handle.kc_filter.kcf_pred = NULL;
+    cursor->kci_handle.kc_filter.kcf_pred_arg = NULL;
+
     cursor->kci_cc_pc = PERFC_ISON(&kvs->ikv_cc_pc) ? &kvs->ikv_cc_pc : NULL;
     cursor->kci_cd_pc = PERFC_ISON(&kvs->ikv_cd_pc) ? &kvs->ikv_cd_pc : NULL;
 
@@ -581,14 +587,19 @@ ikvs_cursor_reset(struct kvs_cursor_impl *cursor)
 }
 
 static struct kvs_cursor_impl *
-ikvs_cursor_restore(struct ikvs *kvs, const void *prefix, size_t pfx_len, bool reverse)
+ikvs_cursor_restore(
+    struct ikvs *kvs,
+    const void *prefix,
+    size_t pfx_len,
+    bool reverse,
+    bool novals)
 {
     struct kvs_cursor_impl *cur;
     uint64_t key, tstart;
 
     tstart = perfc_lat_startl(&kvs->ikv_cd_pc, PERFC_LT_CD_RESTORE);
 
-    key = ikvs_curcache_key(kvs->ikv_gen, reverse);
+    key = ikvs_curcache_key(kvs->ikv_gen, reverse, novals);
 
     cur = ikvs_curcache_remove(ikvs_curcache_td2bkt(), key, prefix, pfx_len);
     if (!cur) {
@@ -632,6 +643,11 @@ ikvs_cursor_save(struct kvs_cursor_impl *cur)
 
     tstart = perfc_lat_startl(&kvs->ikv_cd_pc, PERFC_LT_CD_SAVE);
 
+    /* Do not let a cached cursor keep retired range tombstones alive.
+     */
+    cn_rtombs_put(cur->kci_rtombs);
+    cur->kci_rtombs = NULL;
+
     if (cur->kci_item.ci_ttl > jclock_ns)
         cur = ikvs_curcache_insert(ikvs_curcache_td2bkt(), cur);
 
@@ -645,11 +661,11 @@ ikvs_cursor_save(struct kvs_cursor_impl *cur)
 }
 
 struct hse_kvs_cursor *
-kvs_cursor_alloc(struct ikvs *kvs, const void *prefix, size_t pfx_len, bool reverse)
+kvs_cursor_alloc(struct ikvs *kvs, const void *prefix, size_t pfx_len, bool reverse, bool novals)
 {
     struct kvs_cursor_impl *cur;
 
-    cur = ikvs_cursor_restore(kvs, prefix, pfx_len, reverse);
+    cur = ikvs_cursor_restore(kvs, prefix, pfx_len, reverse, novals);
     if (cur) {
 
         /*
@@ -668,7 +684,7 @@ kvs_cursor_alloc(struct ikvs *kvs, const void *prefix, size_t pfx_len, bool reve
 
     memset(cur, 0, sizeof(*cur));
 
-    cur->kci_item.ci_key = ikvs_curcache_key(kvs->ikv_gen, reverse);
+    cur->kci_item.ci_key = ikvs_curcache_key(kvs->ikv_gen, reverse, novals);
     cur->kci_cc_pc = PERFC_ISON(&kvs->ikv_cc_pc) ? &kvs->ikv_cc_pc : NULL;
     cur->kci_cd_pc = PERFC_ISON(&kvs->ikv_cd_pc) ? &kvs->ikv_cd_pc : NULL;
     cur->kci_kvs = kvs;
@@ -678,6 +694,7 @@ kvs_cursor_alloc(struct ikvs *kvs, const void *prefix, size_t pfx_len, bool reve
     cur->kci_prefix = cur->kci_buf + HSE_KVS_KEY_LEN_MAX + HSE_KVS_VALUE_LEN_MAX;
     cur->kci_last_kbuf = cur->kci_prefix + HSE_KVS_KEY_LEN_MAX;
     cur->kci_limit = cur->kci_last_kbuf + HSE_KVS_KEY_LEN_MAX;
+    cur->kci_handle.kc_filter.kcf_kbuf = cur->kci_limit + HSE_KVS_KEY_LEN_MAX;
 
     if (prefix)
         memcpy(cur->kci_prefix, prefix, pfx_len);
@@ -686,6 +703,7 @@ kvs_cursor_alloc(struct ikvs *kvs, const void *prefix, size_t pfx_len, bool reve
     cur->kci_handle.kc_filter.kcf_maxkey = 0;
 
     cur->kci_reverse = reverse;
+    cur->kci_novals = novals;
     ikvs_cursor_reset(cur);
 
     /* Pad with 0xff to make reverse cursor seek-to-pfx simple */
@@ -745,6 +763,9 @@ kvs_cursor_init(struct hse_kvs_cursor *cursor, struct kvdb_ctxn *ctxn)
     /* no context: update must seek to beginning */
     cur->kci_last = 0;
 
+    cn_rtombs_put(cur->kci_rtombs);
+    cur->kci_rtombs = cn_rtombs_get(cn);
+
 #ifndef HSE_BUILD_RELEASE
     if (perfc_ison(cur->kci_cd_pc, PERFC_DI_CD_READPERSEEK)) {
         memset(summary, 0, sizeof(*summary));
@@ -805,7 +826,8 @@ kvs_cursor_init(struct hse_kvs_cursor *cursor, struct kvdb_ctxn *ctxn)
         /* Create cn cursor */
         perfc_inc(cur->kci_cc_pc, PERFC_BA_CC_INIT_CREATE_CN);
         tstart = perfc_lat_startu(cur->kci_cd_pc, PERFC_LT_CD_CREATE_CN);
-        err = cn_cursor_create(cn, seqno, reverse, prefix, pfxlen, summary, &cur->kci_cncur);
+        err = cn_cursor_create(
+            cn, seqno, reverse, cur->kci_novals, prefix, pfxlen, summary, &cur->kci_cncur);
         perfc_lat_record(cur->kci_cd_pc, PERFC_LT_CD_CREATE_CN, tstart);
     } else {
         bool updated = false;
@@ -877,6 +899,8 @@ kvs_cursor_destroy(struct hse_kvs_cursor *handle)
     if (cursor->kci_bh)
         bin_heap_destroy(cursor->kci_bh);
 
+    cn_rtombs_put(cursor->kci_rtombs);
+
     vlb_free(cursor, kvs_cursor_impl_alloc_sz);
 }
 
@@ -907,6 +931,9 @@ kvs_cursor_update(struct hse_kvs_cursor *handle, struct kvdb_ctxn *ctxn, uint64_
     if (bind)
         handle->kc_gen = atomic_read(&bind->b_gen);
 
+    cn_rtombs_put(cursor->kci_rtombs);
+    cursor->kci_rtombs = cn_rtombs_get(cursor->kci_kvs->ikv_cn);
+
     /* Copy out last key that was read */
     if (cursor->kci_last) {
         key_obj_copy(
@@ -970,6 +997,28 @@ kvs_cursor_update(struct hse_kvs_cursor *handle, struct kvdb_ctxn *ctxn, uint64_
     return 0;
 }
 
+void
+kvs_cursor_filter_set(
+    struct hse_kvs_cursor *handle,
+    bool (*pred)(void *arg, const void *key, size_t klen),
+    void *arg)
+{
+    struct kvs_cursor_impl *cursor = (void *)handle;
+
+    handle->kc_filter.kcf_pred = pred;
+    handle->kc_filter.kcf_pred_arg = pred ? arg : NULL;
+
+    /* The sources pick up the filter only when they are seeked, so re-seek
+     * to the current position on the next read.  A key that was peeked but
+     * not yet read is re-evaluated against the new predicate.
+     */
+    if (cursor->kci_last && !cursor->kci_need_seek) {
+        key_obj_copy(
+            cursor->kci_last_kbuf, HSE_KVS_KEY_LEN_MAX, &cursor->kci_last_klen, cursor->kci_last);
+        cursor->kci_need_seek = 1;
+    }
+}
+
 static bool
 ikvs_cursor_should_drop(struct kvs_cursor_element *item, struct kvs_cursor_element *pt)
 {
@@ -1052,6 +1101,20 @@ ikvs_cursor_replenish(struct kvs_cursor_impl *cursor)
 
                 bin_heap_pop(cursor->kci_bh, (void **)&popme);
             }
+
+            /* Skip a value deleted by a range tombstone.
+             */
+            if (!is_tomb && cursor->kci_rtombs) {
+                uint64_t seqno, floor;
+
+                floor = cn_rtomb_floor(
+                    cursor->kci_rtombs, &cursor->kci_last_kobj, cursor->kci_handle.kc_seq);
+
+                if (seqnoref_to_seqno(cursor->kci_elem_last.kce_seqnoref, &seqno) ==
+                        HSE_SQNREF_STATE_DEFINED &&
+                    seqno < floor)
+                    is_tomb = true;
+            }
         }
     } while (is_ptomb || is_tomb);
 
@@ -1063,10 +1126,13 @@ static merr_t
 ikvs_cursor_seek(struct kvs_cursor_impl *cursor, const void *key, size_t klen)
 {
     struct hse_kvs_cursor *handle = &cursor->kci_handle;
-    struct kc_filter *filt = handle->kc_filter.kcf_maxkey ? &handle->kc_filter : 0;
+    struct kc_filter *filt = 0;
     merr_t err = 0;
     int cnt;
 
+    if (handle->kc_filter.kcf_maxkey || handle->kc_filter.kcf_pred)
+        filt = &handle->kc_filter;
+
     cursor->kci_eof = 0;
 
     err = c0_cursor_seek(cursor->kci_c0cur, key, klen, filt);
@@ -1149,6 +1215,17 @@ kvs_cursor_val_copy(
     vt = &cur->kci_elem_last.kce_vt;
     clen = cur->kci_elem_last.kce_complen;
 
+    if (cur->kci_novals) {
+        /* Values from cn were never fetched, so never hand out any. */
+        if (val_out)
+            *val_out = NULL;
+
+        if (vlen_out)
+            *vlen_out = (cursor->kc_flags & HSE_CURSOR_CREATE_VLEN_ONLY) ? kvs_vtuple_vlen(vt) : 0;
+
+        return 0;
+    }
+
     if (!buf && !val_out)
         goto out;
 
@@ -1160,7 +1237,8 @@ kvs_cursor_val_copy(
     if (clen) {
         uint outlen;
 
-        err = compress_lz4_ops.cop_decompress(vt->vt_data, clen, buf, bufsz, &outlen);
+        err = vcomp_decompress(
+            cur->kci_elem_last.kce_calgo, vt->vt_data, clen, buf, bufsz, &outlen);
         if (ev(err))
             return err;
 
@@ -1194,7 +1272,8 @@ kvs_cursor_read(struct hse_kvs_cursor *handle, unsigned int flags, bool *eofp)
         bool toss = cursor->kci_need_toss;
 
         cursor->kci_err = kvs_cursor_seek(
-            &cursor->kci_handle, cursor->kci_last_kbuf, cursor->kci_last_klen, 0, 0, &key);
+            &cursor->kci_handle, cursor->kci_last_kbuf, cursor->kci_last_klen,
+            handle->kc_filter.kcf_maxkey, handle->kc_filter.kcf_maxklen, &key);
 
         if (ev(cursor->kci_err))
             return cursor->kci_err;
@@ -1242,6 +1321,60 @@ kvs_cursor_read(struct hse_kvs_cursor *handle, unsigned int flags, bool *eofp)
     return cursor->kci_err;
 }
 
+merr_t
+kvs_cursor_read_batch(
+    struct hse_kvs_cursor *handle,
+    unsigned int flags,
+    void *buf,
+    size_t bufsz,
+    struct hse_kvs_cursor_kv *kvv,
+    size_t *kvcp,
+    bool *eofp)
+{
+    struct kvs_cursor_impl *cursor = cursor_h2r(handle);
+    merr_t err = 0;
+    size_t n = 0;
+
+    *eofp = false;
+
+    while (n < *kvcp) {
+        struct hse_kvs_cursor_kv *kv = kvv + n;
+        size_t klen, vlen;
+
+        err = kvs_cursor_read(handle, flags, eofp);
+        if (ev(err) || *eofp)
+            break;
+
+        klen = key_obj_len(cursor->kci_last);
+        vlen = cursor->kci_novals ? 0 : kvs_vtuple_vlen(&cursor->kci_elem_last.kce_vt);
+
+        if (klen + vlen > bufsz) {
+            /* Un-read the pair so that the next read returns it again,
+             * exactly as if it had been peeked at by a seek.
+             */
+            cursor->kci_need_toss = 0;
+            if (n == 0)
+                err = merr(EMSGSIZE);
+            break;
+        }
+
+        kvs_cursor_key_copy(handle, buf, klen, &kv->key, &kv->key_len);
+        buf += klen;
+
+        err = kvs_cursor_val_copy(handle, buf, vlen, &kv->val, &kv->val_len);
+        if (ev(err))
+            break;
+
+        buf += vlen;
+        bufsz -= klen + vlen;
+        n++;
+    }
+
+    *kvcp = n;
+
+    return err;
+}
+
 merr_t
 kvs_cursor_seek(
     struct hse_kvs_cursor *handle,
@@ -1261,7 +1394,8 @@ kvs_cursor_seek(
         return merr(EINVAL);
 
     if (limit && limit_len) {
-        memcpy(cursor->kci_limit, limit, limit_len);
+        if (limit != cursor->kci_limit)
+            memcpy(cursor->kci_limit, limit, limit_len);
         handle->kc_filter.kcf_maxkey = cursor->kci_limit;
         handle->kc_filter.kcf_maxklen = cursor->kci_limit_len = limit_len;
     } else {
@@ -1374,7 +1508,7 @@ kvs_curcache_init(void)
 
     sz = sizeof(*kci);
     sz += (HSE_KVS_KEY_LEN_MAX + HSE_KVS_VALUE_LEN_MAX); /* For kci_buf */
-    sz += (HSE_KVS_KEY_LEN_MAX * 3);                     /* For prefix, last_key and limit */
+    sz += (HSE_KVS_KEY_LEN_MAX * 4);                     /* For prefix, last_key, limit and filter */
     kvs_cursor_impl_alloc_sz = sz;
 
     ikvs_curcachec = clamp_t(uint, (get_nprocs() / 2), 16, 48);
@@ -115,6 +115,100 @@ compression_default_jsonify(const struct param_spec * const ps, const void * con
     abort();
 }
 
+static const char *
+compression_algorithm_name(enum vcomp_algorithm algo)
+{
+    switch (algo) {
+    case VCOMP_ALGO_LZ4:
+        return VCOMP_PARAM_LZ4;
+    case VCOMP_ALGO_ZSTD:
+        return VCOMP_PARAM_ZSTD;
+    }
+
+    abort();
+}
+
+static bool HSE_NONNULL(1, 2, 3)
+compression_algorithm_converter(
+    const struct param_spec * const ps,
+    const cJSON * const node,
+    void * const data)
+{
+    const char *value;
+
+    INVARIANT(ps);
+    INVARIANT(node);
+    INVARIANT(data);
+
+    if (!cJSON_IsString(node))
+        return false;
+
+    value = cJSON_GetStringValue(node);
+    if (strcmp(value, VCOMP_PARAM_LZ4) == 0) {
+        *(enum vcomp_algorithm *)data = VCOMP_ALGO_LZ4;
+    } else if (strcmp(value, VCOMP_PARAM_ZSTD) == 0) {
+        *(enum vcomp_algorithm *)data = VCOMP_ALGO_ZSTD;
+    } else {
+        log_err("Unknown compression algorithm: %s", value);
+        return false;
+    }
+
+    return true;
+}
+
+static bool HSE_NONNULL(1, 2)
+compression_algorithm_validator(const struct param_spec * const ps, const void * const value)
+{
+    enum vcomp_algorithm algo;
+
+    INVARIANT(ps);
+    INVARIANT(value);
+
+    algo = *(const enum vcomp_algorithm *)value;
+
+    if (!vcomp_compress_ops[algo]) {
+        log_err("Compression algorithm not supported by this build: %s",
+                compression_algorithm_name(algo));
+        return false;
+    }
+
+    return true;
+}
+
+static merr_t
+compression_algorithm_stringify(
+    const struct param_spec * const ps,
+    const void * const value,
+    char * const buf,
+    const size_t buf_sz,
+    size_t * const needed_sz)
+{
+    int n;
+
+    INVARIANT(ps);
+    INVARIANT(value);
+    INVARIANT(buf);
+
+    n = snprintf(buf, buf_sz, "\"%s\"",
+                 compression_algorithm_name(*(enum vcomp_algorithm *)value));
+    if (n < 0)
+        return merr(EBADMSG);
+
+    if (needed_sz)
+        *needed_sz = n;
+
+    return 0;
+}
+
+static cJSON *
+compression_algorithm_jsonify(const struct param_spec * const ps, const void * const value)
+{
+    INVARIANT(ps);
+    INVARIANT(value);
+
+    return cJSON_CreateString(compression_algorithm_name(*(enum vcomp_algorithm *)value));
+}
+
 static const struct param_spec pspecs[] = {
     {
         .ps_name = "kvs_cursor_ttl",
@@ -299,6 +393,42 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "cn_spill_parts",
+        .ps_description = "max number of key range partitions built in parallel by a large spill",
+        .ps_flags = PARAM_EXPERIMENTAL | PARAM_WRITABLE,
+        .ps_type = PARAM_TYPE_U8,
+        .ps_offset = offsetof(struct kvs_rparams, cn_spill_parts),
+        .ps_size = PARAM_SZ(struct kvs_rparams, cn_spill_parts),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 4,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 1,
+                .ps_max = 16,
+            },
+        },
+    },
+    {
+        .ps_name = "cn_async_write",
+        .ps_description = "overlap kblock and vblock writes with kvset builds (boolean)",
+        .ps_flags = PARAM_EXPERIMENTAL | PARAM_WRITABLE,
+        .ps_type = PARAM_TYPE_BOOL,
+        .ps_offset = offsetof(struct kvs_rparams, cn_async_write),
+        .ps_size = PARAM_SZ(struct kvs_rparams, cn_async_write),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_bool = true,
+        },
+    },
     {
         .ps_name = "cn_capped_ttl",
         .ps_description = "cn cursor cache TTL (ms) for capped kvs",
@@ -377,6 +507,42 @@ static const struct param_spec pspecs[] = {
             .as_bool = false,
         },
     },
+    {
+        .ps_name = "cn_cursor_rev_kra",
+        .ps_description = "reverse cursor wbtree leaf and kmd madvise-ahead (boolean)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_BOOL,
+        .ps_offset = offsetof(struct kvs_rparams, cn_cursor_rev_kra),
+        .ps_size = PARAM_SZ(struct kvs_rparams, cn_cursor_rev_kra),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_bool = true,
+        },
+    },
+    {
+        .ps_name = "cn_cursor_rev_vra",
+        .ps_description = "reverse cursor vblk madvise-ahead (bytes)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U64,
+        .ps_offset = offsetof(struct kvs_rparams, cn_cursor_rev_vra),
+        .ps_size = PARAM_SZ(struct kvs_rparams, cn_cursor_rev_vra),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 256 * 1024,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 0,
+                .ps_max = UINT64_MAX,
+            },
+        },
+    },
     {
         .ps_name = "cn_cursor_seq",
         .ps_description = "optimize cn_tree for longer sequential cursor accesses",
@@ -498,6 +664,42 @@ static const struct param_spec pspecs[] = {
             .as_bool = false,
         },
     },
+    {
+        .ps_name = "cn_wbt_fence",
+        .ps_description = "build in-memory fence indexes over wbtree leaves",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_BOOL,
+        .ps_offset = offsetof(struct kvs_rparams, cn_wbt_fence),
+        .ps_size = PARAM_SZ(struct kvs_rparams, cn_wbt_fence),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_bool = false,
+        },
+    },
+    {
+        .ps_name = "cn_wbt_leaf_enc",
+        .ps_description = "wbtree leaf encoding (0:plain, 1:delta, 2:delta+compressed)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U8,
+        .ps_offset = offsetof(struct kvs_rparams, cn_wbt_leaf_enc),
+        .ps_size = PARAM_SZ(struct kvs_rparams, cn_wbt_leaf_enc),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 0,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 0,
+                .ps_max = 2,
+            },
+        },
+    },
     {
         .ps_name = "cn_bloom_create",
         .ps_description = "enable bloom creation",
@@ -669,6 +871,48 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "cn_tier_hot_rate",
+        .ps_description = "hot leaf node read rate (reads/sec, 0 disables tiering)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U32,
+        .ps_offset = offsetof(struct kvs_rparams, cn_tier_hot_rate),
+        .ps_size = PARAM_SZ(struct kvs_rparams, cn_tier_hot_rate),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 0,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 0,
+                .ps_max = UINT32_MAX,
+            },
+        },
+    },
+    {
+        .ps_name = "cn_rcache_mb",
+        .ps_description = "size of the cn row cache in MiB (0 disables)",
+        .ps_flags = PARAM_EXPERIMENTAL,
+        .ps_type = PARAM_TYPE_U32,
+        .ps_offset = offsetof(struct kvs_rparams, cn_rcache_mb),
+        .ps_size = PARAM_SZ(struct kvs_rparams, cn_rcache_mb),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_uscalar = 0,
+        },
+        .ps_bounds = {
+            .as_uscalar = {
+                .ps_min = 0,
+                .ps_max = 1024 * 1024,
+            },
+        },
+    },
     {
         .ps_name = "mclass.policy",
         .ps_description = "media class policy",
@@ -710,6 +954,48 @@ static const struct param_spec pspecs[] = {
             },
         },
     },
+    {
+        .ps_name = "value.compression.algorithm",
+        .ps_description = "Algorithm used to compress values (lz4 or zstd)",
+        .ps_flags = 0,
+        .ps_type = PARAM_TYPE_ENUM,
+        .ps_offset = offsetof(struct kvs_rparams, value.compression.algo),
+        .ps_size = PARAM_SZ(struct kvs_rparams, value.compression.algo),
+        .ps_convert = compression_algorithm_converter,
+        .ps_validate = compression_algorithm_validator,
+        .ps_stringify = compression_algorithm_stringify,
+        .ps_jsonify = compression_algorithm_jsonify,
+        .ps_default_value = {
+            .as_enum = VCOMP_ALGO_LZ4,
+        },
+        .ps_bounds = {
+            .as_enum = {
+                .ps_min = VCOMP_ALGO_MIN,
+                .ps_max = VCOMP_ALGO_MAX,
+            },
+        },
+    },
+    {
+        .ps_name = "value.compression.level",
+        .ps_description = "Compression level, 0 for the algorithm's default (ignored by lz4)",
+        .ps_flags = 0,
+        .ps_type = PARAM_TYPE_I32,
+        .ps_offset = offsetof(struct kvs_rparams, value.compression.level),
+        .ps_size = PARAM_SZ(struct kvs_rparams, value.compression.level),
+        .ps_convert = param_default_converter,
+        .ps_validate = param_default_validator,
+        .ps_stringify = param_default_stringify,
+        .ps_jsonify = param_default_jsonify,
+        .ps_default_value = {
+            .as_scalar = VCOMP_LEVEL_DEFAULT,
+        },
+        .ps_bounds = {
+            .as_scalar = {
+                .ps_min = VCOMP_LEVEL_MIN,
+                .ps_max = VCOMP_LEVEL_MAX,
+            },
+        },
+    },
 };
 
 const struct param_spec *
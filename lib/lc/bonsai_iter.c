@@ -165,6 +165,12 @@ bonsai_iter_next(struct element_source *es, void **element)
     elem->kce_source = KCE_SOURCE_LC;
     elem->kce_seqnoref = val->bv_seqnoref;
     elem->kce_complen = bonsai_val_clen(val);
+    elem->kce_calgo = bonsai_val_calgo(val);
+
+    if (kvs_expired(bonsai_val_expire(val))) {
+        kvs_vtuple_init(&elem->kce_vt, HSE_CORE_TOMB_REG, 0);
+        elem->kce_complen = 0;
+    }
     elem->kce_is_ptomb = iter->bi_is_ptomb;
 
     *element = &iter->bi_elem;
@@ -82,12 +82,12 @@
 #include <hse/ikvdb/lc.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/ikvdb/tuple.h>
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/logging/logging.h>
 #include <hse/util/alloc.h>
 #include <hse/util/bin_heap.h>
 #include <hse/util/bkv_collection.h>
 #include <hse/util/bonsai_tree.h>
-#include <hse/util/compression_lz4.h>
 #include <hse/util/rmlock.h>
 #include <hse/util/slab.h>
 #include <hse/util/vlb.h>
@@ -491,6 +491,7 @@ lc_builder_cb(void *rock, struct bonsai_kv *bkv, struct bonsai_val *vlist)
         struct bonsai_sval sval;
 
         bn_sval_init(val->bv_value, val->bv_xlen, val->bv_seqnoref, &sval);
+        sval.bsv_expire = bonsai_val_expire(val);
         root = sval.bsv_val == HSE_CORE_TOMB_PFX ? rcu_dereference(lc->lc_broot[0])
                                                  : rcu_dereference(lc->lc_broot[1]);
 
@@ -611,7 +612,10 @@ lc_get_main(
     *val_out = val;
     *oseqnoref = val->bv_seqnoref;
 
-    *res = HSE_CORE_IS_TOMB(val->bv_value) ? FOUND_TMB : FOUND_VAL;
+    if (HSE_CORE_IS_TOMB(val->bv_value) || kvs_expired(bonsai_val_expire(val)))
+        *res = FOUND_TMB;
+    else
+        *res = FOUND_VAL;
 }
 
 static merr_t
@@ -633,8 +637,9 @@ copy_val(struct kvs_buf *vbuf, struct bonsai_val *val)
         ulen = bonsai_val_ulen(val);
 
         if (clen > 0) {
-            err = compress_lz4_ops.cop_decompress(
-                val->bv_value, clen, vbuf->b_buf, vbuf->b_buf_sz, &outlen);
+            err = vcomp_decompress(
+                bonsai_val_calgo(val), val->bv_value, clen, vbuf->b_buf, vbuf->b_buf_sz,
+                &outlen);
             if (ev(err))
                 return err;
 
@@ -786,6 +791,7 @@ struct lc_cursor {
     uint16_t lcc_skidx;
     struct kvs_cursor_element lcc_elem;
     struct key_obj lcc_filter_max;
+    const struct kc_filter *lcc_pred;
     struct key_obj lcc_ptomb;
     uint64_t lcc_ptomb_seq;
     size_t lcc_tree_pfxlen;
@@ -949,6 +955,11 @@ lc_cursor_read(struct lc_cursor *cur, struct kvs_cursor_element *lc_elem, bool *
                 break; /* eof; key is larger than lcc_filter_max */
         }
 
+        if (cur->lcc_pred && !is_ptomb && !kc_filter_pred_kobj(cur->lcc_pred, &elem->kce_kobj)) {
+            bin_heap_pop(cur->lcc_bh, (void **)&elem);
+            continue;
+        }
+
         if (cur->lcc_ptomb_set) {
             int rc = key_obj_cmp_prefix(&cur->lcc_ptomb, &elem->kce_kobj);
 
@@ -1044,12 +1055,14 @@ lc_cursor_seek(struct lc_cursor *cur, const void *seek, size_t seeklen, struct k
 
     assert(cur);
 
-    cur->lcc_filter_set = filter ? 1 : 0;
-    if (filter) {
+    cur->lcc_filter_set = (filter && filter->kcf_maxkey) ? 1 : 0;
+    if (cur->lcc_filter_set) {
         assert(!cur->lcc_reverse);
         key2kobj(&cur->lcc_filter_max, filter->kcf_maxkey, filter->kcf_maxklen);
     }
 
+    cur->lcc_pred = (filter && filter->kcf_pred) ? filter : NULL;
+
     cur->lcc_ptomb_set = 0;
 
     rcu_read_lock();
@@ -128,6 +128,20 @@ mpool_mclass_props_get(struct mpool *mp, enum hse_mclass mclass, struct mpool_mc
 merr_t
 mpool_mclass_info_get(struct mpool *mp, enum hse_mclass mclass, struct hse_mclass_info *info);
 
+/**
+ * mpool_mclass_avail_get() - get the space available for new mblocks in a media class
+ *
+ * @mp:     mpool descriptor
+ * @mclass: input media mclass
+ * @avail:  available bytes (output)
+ *
+ * Returns: 0 for success
+ *          non-zero(err): merr_errno(err) == ENOENT if the specified mclass is not present
+ */
+/* MTF_MOCK */
+merr_t
+mpool_mclass_avail_get(struct mpool *mp, enum hse_mclass mclass, uint64_t *avail);
+
 /**
  * mpool_mclass_ftw() - walk files in 'mclass' and invoke cb for each file matching 'prefix'
  *
@@ -143,6 +157,33 @@ mpool_mclass_ftw(
     const char *prefix,
     struct mpool_file_cb *cb);
 
+typedef merr_t
+mpool_checkpoint_cb(void *arg);
+
+/**
+ * mpool_checkpoint() - clone the files of all configured media classes
+ *
+ * @mp:    mpool descriptor
+ * @paths: per media class target directory
+ * @cb:    callback which freezes and clones the metadata (may be NULL)
+ * @arg:   callback argument
+ *
+ * Files are reflinked where the file system supports it and otherwise
+ * copied extent by extent, preserving holes.  mblock deletes and punches
+ * are held off for the duration of the call.  The callback is invoked
+ * before any other file is cloned; it should clone the MDCs and files which
+ * must be point-in-time via mpool_mdc_checkpoint() and mpool_file_checkpoint(),
+ * and those are then skipped.  The caller must ensure that no mpool file is
+ * destroyed for the duration of the call, a file which vanishes while it is
+ * cloned fails the checkpoint.
+ */
+merr_t
+mpool_checkpoint(
+    struct mpool *mp,
+    const char *paths[HSE_MCLASS_COUNT],
+    mpool_checkpoint_cb *cb,
+    void *arg);
+
 /** @brief Check if a media class is configured.
  *
  * @param mp: Mpool.
@@ -321,6 +362,24 @@ mpool_mdc_cend(struct mpool_mdc *mdc);
 merr_t
 mpool_mdc_sync(struct mpool_mdc *mdc);
 
+/**
+ * mpool_mdc_checkpoint() - Clone the log files of an MDC
+ *
+ * @mp:     mpool handle
+ * @logid1: logid 1
+ * @logid2: logid 2
+ * @paths:  per media class target directory
+ *
+ * Must be called from an mpool_checkpoint() callback, and the caller must
+ * ensure that the MDC is neither appended to nor compacted during the call.
+ */
+merr_t
+mpool_mdc_checkpoint(
+    struct mpool *mp,
+    uint64_t logid1,
+    uint64_t logid2,
+    const char *paths[HSE_MCLASS_COUNT]);
+
 /**
  * mpool_mdc_usage() - Return mdc statistics
  *
@@ -541,6 +600,24 @@ mpool_file_close(struct mpool_file *file);
 merr_t
 mpool_file_destroy(struct mpool *mp, enum hse_mclass mclass, const char *name);
 
+/**
+ * mpool_file_checkpoint() - Clone an mpool file
+ *
+ * @mp:     mpool handle
+ * @mclass: media class
+ * @name:   file name
+ * @paths:  per media class target directory
+ *
+ * Must be called from an mpool_checkpoint() callback, and the caller must
+ * ensure that the file is not destroyed during the call.
+ */
+merr_t
+mpool_file_checkpoint(
+    struct mpool *mp,
+    enum hse_mclass mclass,
+    const char *name,
+    const char *paths[HSE_MCLASS_COUNT]);
+
 /**
  * mpool_file_read() - Read an mpool file
  *
@@ -53,11 +53,14 @@ struct mpool_cparams {
 /**
  * struct mpool_rparams - mpool run params
  *
- * @path:      storage path
+ * @dio_disable:   disable direct I/O
+ * @uring_enable:  use io_uring for mblock data reads and writes (not pmem)
+ * @path:          storage path
  */
 struct mpool_rparams {
     struct {
         bool dio_disable;
+        bool uring_enable;
         char path[PATH_MAX];
     } mclass[HSE_MCLASS_COUNT];
 };
@@ -45,9 +45,26 @@ struct io_ops {
 /* sync backend */
 extern const struct io_ops io_sync_ops;
 
+merr_t
+io_sync_mmap(void **addr, size_t len, int prot, int flags, int fd, off_t offset);
+
+merr_t
+io_sync_munmap(void *addr, size_t len);
+
+merr_t
+io_sync_msync(void *addr, size_t len, int flags);
+
+merr_t
+io_sync_clone(int src_fd, off_t src_off, int tgt_fd, off_t tgt_off, size_t len, int flags);
+
 /* pmem backend */
 #ifdef HAVE_PMEM
 extern const struct io_ops io_pmem_ops;
 #endif /* HAVE_PMEM */
 
+/* io_uring backend, used only for mblock data reads and writes */
+#ifdef HAVE_IO_URING
+extern const struct io_ops io_uring_ops;
+#endif /* HAVE_IO_URING */
+
 #endif /* MPOOL_IO_H */
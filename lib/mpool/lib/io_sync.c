@@ -174,7 +174,7 @@ io_sync_clone(int src_fd, off_t src_off, int tgt_fd, off_t tgt_off, size_t len,
     off_t cur_soff = src_off, cur_toff = tgt_off;
 
     do {
-        cc = copy_file_range(src_fd, &cur_soff, tgt_fd, &cur_toff, len, 0);
+        cc = copy_file_range(src_fd, &cur_soff, tgt_fd, &cur_toff, left, 0);
         if (cc == -1)
             return merr(errno);
 
@@ -0,0 +1,279 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include <liburing.h>
+
+#include <hse/logging/logging.h>
+#include <hse/util/assert.h>
+#include <hse/util/compiler.h>
+#include <hse/util/event_counter.h>
+#include <hse/util/minmax.h>
+
+#include "io.h"
+
+/* clang-format off */
+
+#define IOU_QDEPTH      (128)
+#define IOU_SQE_IOVMAX  (32)
+
+/* clang-format on */
+
+/**
+ * struct iou_ctx - per-thread io_uring context
+ *
+ * @ring:   submission/completion ring
+ * @failed: ring setup failed, fall back to synchronous I/O
+ *
+ * Each thread that issues mblock data I/O lazily creates its own ring so
+ * that submissions never contend on a shared submission queue.  A single
+ * read or write request is split into up to IOU_QDEPTH SQEs which are
+ * submitted together, letting the device work on all of them concurrently
+ * rather than one preadv/pwritev at a time.
+ */
+struct iou_ctx {
+    struct io_uring ring;
+    bool            failed;
+};
+
+static pthread_key_t  iou_key;
+static pthread_once_t iou_once = PTHREAD_ONCE_INIT;
+
+static thread_local struct iou_ctx *iou_tls;
+
+static void
+iou_ctx_free(void *arg)
+{
+    struct iou_ctx *ctx = arg;
+
+    if (!ctx)
+        return;
+
+    if (!ctx->failed)
+        io_uring_queue_exit(&ctx->ring);
+
+    free(ctx);
+}
+
+static void
+iou_key_init(void)
+{
+    int rc HSE_MAYBE_UNUSED;
+
+    rc = pthread_key_create(&iou_key, iou_ctx_free);
+    assert(rc == 0);
+}
+
+static struct iou_ctx *
+iou_ctx_get(void)
+{
+    struct iou_ctx *ctx = iou_tls;
+    int rc;
+
+    if (HSE_LIKELY(ctx))
+        return ctx->failed ? NULL : ctx;
+
+    pthread_once(&iou_once, iou_key_init);
+
+    ctx = calloc(1, sizeof(*ctx));
+    if (ev(!ctx))
+        return NULL;
+
+    rc = io_uring_queue_init(IOU_QDEPTH, &ctx->ring, 0);
+    if (rc < 0) {
+        log_warn("io_uring setup failed (%d), using synchronous I/O on this thread", -rc);
+        ctx->failed = true;
+    }
+
+    pthread_setspecific(iou_key, ctx);
+    iou_tls = ctx;
+
+    return ctx->failed ? NULL : ctx;
+}
+
+/**
+ * iou_retire() - tear down the calling thread's ring after a failure
+ *
+ * @ctx:     io_uring context
+ * @pending: number of submitted requests not yet reaped
+ *
+ * A ring with unreaped completions cannot be reused, since the next request
+ * on this thread would consume them as its own.  Reap what can be reaped so
+ * that the kernel is done with the caller's buffers, then retire the ring
+ * and let this thread fall back to synchronous I/O from here on.
+ */
+static void
+iou_retire(struct iou_ctx *ctx, int pending)
+{
+    struct io_uring_cqe *cqe;
+
+    while (pending-- > 0 && !io_uring_wait_cqe(&ctx->ring, &cqe))
+        io_uring_cqe_seen(&ctx->ring, cqe);
+
+    io_uring_queue_exit(&ctx->ring);
+    ctx->failed = true;
+}
+
+/**
+ * iou_rw() - issue a vectored read or write through the calling thread's ring
+ *
+ * @ctx:    io_uring context
+ * @fd:     file descriptor
+ * @off:    file offset
+ * @iov:    iovec array
+ * @iovcnt: number of elements in iov
+ * @write:  true for a write, false for a read
+ * @iolenp: number of contiguous bytes transferred from @off (output)
+ *
+ * The iovec array is carved into chunks of at most IOU_SQE_IOVMAX
+ * elements, one SQE per chunk, and at most IOU_QDEPTH chunks are in
+ * flight at a time. Completions may arrive in any order, so the length of
+ * each chunk is tracked to compute the contiguous prefix that completed.
+ */
+static merr_t
+iou_rw(
+    struct iou_ctx *ctx,
+    int fd,
+    off_t off,
+    const struct iovec *iov,
+    int iovcnt,
+    bool write,
+    size_t *iolenp)
+{
+    size_t explen[IOU_QDEPTH], donelen[IOU_QDEPTH];
+    size_t total = 0;
+    merr_t err = 0;
+    bool shortio = false;
+
+    while (iovcnt > 0 && !err && !shortio) {
+        struct io_uring_cqe *cqe;
+        off_t soff = off;
+        int nsqe = 0;
+        int rc, i;
+
+        while (iovcnt > 0 && nsqe < IOU_QDEPTH) {
+            struct io_uring_sqe *sqe;
+            int cnt = min_t(int, iovcnt, IOU_SQE_IOVMAX);
+            size_t len = 0;
+
+            sqe = io_uring_get_sqe(&ctx->ring);
+            if (!sqe)
+                break;
+
+            for (i = 0; i < cnt; i++)
+                len += iov[i].iov_len;
+
+            if (write)
+                io_uring_prep_writev(sqe, fd, iov, cnt, soff);
+            else
+                io_uring_prep_readv(sqe, fd, iov, cnt, soff);
+
+            io_uring_sqe_set_data64(sqe, nsqe);
+
+            explen[nsqe] = len;
+            donelen[nsqe] = 0;
+            nsqe++;
+
+            soff += len;
+            iov += cnt;
+            iovcnt -= cnt;
+        }
+
+        if (ev(nsqe == 0))
+            return merr(EAGAIN);
+
+        rc = io_uring_submit_and_wait(&ctx->ring, nsqe);
+        if (rc != nsqe) {
+            log_warn("io_uring submit failed (%d of %d), disabling io_uring on this thread",
+                     rc, nsqe);
+
+            iou_retire(ctx, rc);
+
+            return merr(rc < 0 ? -rc : EIO);
+        }
+
+        for (i = 0; i < nsqe; i++) {
+            uint64_t idx;
+
+            do {
+                rc = io_uring_wait_cqe(&ctx->ring, &cqe);
+            } while (rc == -EINTR);
+
+            if (rc < 0) {
+                log_warn("io_uring wait failed (%d), disabling io_uring on this thread", rc);
+
+                iou_retire(ctx, nsqe - i);
+
+                return merr(-rc);
+            }
+
+            idx = io_uring_cqe_get_data64(cqe);
+            assert(idx < nsqe);
+
+            if (cqe->res < 0) {
+                if (!err)
+                    err = merr(-cqe->res);
+            } else {
+                donelen[idx] = cqe->res;
+            }
+
+            io_uring_cqe_seen(&ctx->ring, cqe);
+        }
+
+        for (i = 0; i < nsqe; i++) {
+            total += donelen[i];
+            if (donelen[i] != explen[i]) {
+                ev(1);
+                shortio = true;
+                break;
+            }
+        }
+
+        off = soff;
+    }
+
+    if (iolenp)
+        *iolenp = total;
+
+    return err;
+}
+
+static merr_t
+iou_read(int src_fd, off_t off, const struct iovec *iov, int iovcnt, int flags, size_t *rdlen)
+{
+    struct iou_ctx *ctx;
+
+    ctx = iou_ctx_get();
+    if (!ctx)
+        return io_sync_ops.read(src_fd, off, iov, iovcnt, flags, rdlen);
+
+    return iou_rw(ctx, src_fd, off, iov, iovcnt, false, rdlen);
+}
+
+static merr_t
+iou_write(int dst_fd, off_t off, const struct iovec *iov, int iovcnt, int flags, size_t *wrlen)
+{
+    struct iou_ctx *ctx;
+
+    ctx = iou_ctx_get();
+    if (!ctx)
+        return io_sync_ops.write(dst_fd, off, iov, iovcnt, flags, wrlen);
+
+    return iou_rw(ctx, dst_fd, off, iov, iovcnt, true, wrlen);
+}
+
+/* Only the data path is served by io_uring, mappings and clones remain synchronous.
+ */
+const struct io_ops io_uring_ops = {
+    .read = iou_read,
+    .write = iou_write,
+    .mmap = io_sync_mmap,
+    .munmap = io_sync_munmap,
+    .msync = io_sync_msync,
+    .clone = io_sync_clone,
+};
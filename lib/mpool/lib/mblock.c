@@ -66,6 +66,8 @@ mpool_mblock_delete(struct mpool *mp, uint64_t mbid)
 {
     struct media_class *mc;
     enum hse_mclass mclass;
+    void *lock;
+    merr_t err;
 
     if (!mp)
         return merr(EINVAL);
@@ -78,7 +80,11 @@ mpool_mblock_delete(struct mpool *mp, uint64_t mbid)
     if (!mc)
         return merr(ENOENT);
 
-    return mblock_fset_delete(mclass_fset(mc), &mbid, 1);
+    mpool_ckpt_rlock(mp, &lock);
+    err = mblock_fset_delete(mclass_fset(mc), &mbid, 1);
+    mpool_ckpt_runlock(lock);
+
+    return err;
 }
 
 merr_t
@@ -142,6 +148,8 @@ merr_t
 mpool_mblock_punch(struct mpool *mp, uint64_t mbid, off_t off, size_t len)
 {
     struct media_class *mc;
+    void *lock;
+    merr_t err;
 
     if (!mp)
         return merr(EINVAL);
@@ -150,7 +158,11 @@ mpool_mblock_punch(struct mpool *mp, uint64_t mbid, off_t off, size_t len)
     if (!mc)
         return merr(ENOENT);
 
-    return mblock_fset_punch(mclass_fset(mc), mbid, off, len);
+    mpool_ckpt_rlock(mp, &lock);
+    err = mblock_fset_punch(mclass_fset(mc), mbid, off, len);
+    mpool_ckpt_runlock(lock);
+
+    return err;
 }
 
 merr_t
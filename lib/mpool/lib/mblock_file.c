@@ -686,7 +686,7 @@ mblock_file_open(
     mbfp->fileid = fileid;
     mbfp->mcid = mcid;
     mbfp->mblocksz = mblocksz;
-    mbfp->dataio = io_sync_ops;
+    mbfp->dataio = *params->dataio;
     mbfp->metaio = *params->metaio;
 
     mbfp->fszmax = fszmax;
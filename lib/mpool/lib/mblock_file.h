@@ -90,6 +90,7 @@ struct mblock_filehdr {
  *
  * @rmcache:     region map cache
  * @metaio:      io backend to use for metadata operations
+ * @dataio:      io backend to use for mblock data reads and writes
  * @meta_addr:   start of memory-mapped region in the metadata file
  * @meta_ugaddr: start of memory-mapped region in the target metadata file (for upgrade)
  * @fszmax:      max file size
@@ -100,6 +101,7 @@ struct mblock_filehdr {
 struct mblock_file_params {
     struct kmem_cache *rmcache;
     struct io_ops *metaio;
+    struct io_ops *dataio;
     char *meta_addr;
     char *meta_ugaddr;
     size_t fszmax;
@@ -35,6 +35,9 @@
  *
  * @fidx:      next file index to use for allocation
  * @filev:     vector of mblock file handles
+ * @mhdr:      mblock metadata header
+ * @io:        io ops for the metadata file
+ * @dataio:    io ops for mblock data reads and writes
  *
  * @ug_maddr:   upgrade target mapped addr
  * @ug_mname:   upgrade target meta file name
@@ -56,6 +59,7 @@ struct mblock_fset {
     struct mblock_file **filev;
     struct mblock_metahdr mhdr;
     struct io_ops io;
+    struct io_ops dataio;
 
     char *ug_maddr;
     char *ug_mname;
@@ -456,6 +460,7 @@ mblock_fset_open(
     mbfsp->mhdr.mblksz = mclass_mblocksz_get(mc);
 
     mclass_io_ops_set(mcid_to_mclass(mclass_id(mc)), &mbfsp->io);
+    mclass_data_io_ops_set(mc, &mbfsp->dataio);
 
     flags &= (O_RDWR | O_RDONLY | O_WRONLY | O_CREAT | O_DIRECT);
     create = (flags & O_CREAT);
@@ -526,6 +531,7 @@ mblock_fset_open(
         }
 
         fparams.metaio = &mbfsp->io;
+        fparams.dataio = &mbfsp->dataio;
 
         err = mblock_file_open(mbfsp, mc, &fparams, flags, mbfsp->mhdr.vers, &mbfsp->filev[i]);
         if (err)
@@ -809,6 +815,37 @@ mblock_fset_info_get(struct mblock_fset *mbfsp, struct hse_mclass_info *info)
     return 0;
 }
 
+merr_t
+mblock_fset_avail_get(struct mblock_fset *mbfsp, uint64_t *avail)
+{
+    struct statvfs sbuf;
+    uint64_t room = 0;
+    int i, rc;
+    merr_t err;
+
+    INVARIANT(mbfsp);
+    INVARIANT(avail);
+
+    for (i = 0; i < mbfsp->mhdr.fcnt; i++) {
+        struct mblock_file_info fst = {};
+
+        err = mblock_file_info_get(mbfsp->filev[i], &fst);
+        if (err)
+            return err;
+
+        if (fst.allocated < mbfsp->mhdr.fszmax)
+            room += mbfsp->mhdr.fszmax - fst.allocated;
+    }
+
+    rc = fstatvfs(mclass_dirfd(mbfsp->mc), &sbuf);
+    if (rc == -1)
+        return merr(errno);
+
+    *avail = min_t(uint64_t, room, (uint64_t)sbuf.f_bavail * sbuf.f_frsize);
+
+    return 0;
+}
+
 size_t
 mblock_fset_fmaxsz_get(const struct mblock_fset * const mbfsp)
 {
@@ -171,6 +171,18 @@ mblock_fset_unmap(struct mblock_fset *mbfsp, uint64_t mbid);
 merr_t
 mblock_fset_info_get(struct mblock_fset *mbfsp, struct hse_mclass_info *info);
 
+/**
+ * mblock_fset_avail_get() - get the space available for new mblocks
+ *
+ * @mbfsp: mblock fileset handle
+ * @avail: available bytes (output)
+ *
+ * This is the lesser of the room left in the mblock files and the free
+ * space of the file system on which they reside.
+ */
+merr_t
+mblock_fset_avail_get(struct mblock_fset *mbfsp, uint64_t *avail);
+
 /** @brief Get file count.
  *
  * @param mbfsp: mblock fileset handle.
@@ -3,9 +3,14 @@
  * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
  */
 
+#include <fcntl.h>
 #include <ftw.h>
+#include <unistd.h>
 
 #include <bsd/string.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
 #include <sys/sysmacros.h>
 
 #include <hse/logging/logging.h>
@@ -35,6 +40,9 @@
  * @mblocksz: mblock size configured for this mclass
  * @mcid:     mclass ID (persisted in mblock/mdc metadata)
  * @gclose:   was mclass closed gracefully in prior instance
+ * @directio: mclass files are opened with O_DIRECT
+ * @uring:    use io_uring for mblock data reads and writes
+ * @ra_pages: device readahead in pages
  * @dpath:    mclass directory path
  * @upath:    mclass user-provided path
  */
@@ -45,6 +53,7 @@ struct media_class {
     enum mclass_id mcid;
     bool gclose;
     bool directio;
+    bool uring;
     uint16_t ra_pages;
     char *dpath;
     char *upath;
@@ -123,6 +132,7 @@ mclass_open(
 
     mc->dirp = dirp;
     mc->mcid = mclass_to_mcid(mclass);
+    mc->uring = params->uring;
 
     err = get_ra_pages(dirp, &mc->ra_pages);
     if (err)
@@ -467,6 +477,22 @@ mclass_io_ops_set(enum hse_mclass mclass, struct io_ops *io)
 #endif
 }
 
+void
+mclass_data_io_ops_set(const struct media_class *mc, struct io_ops *io)
+{
+    INVARIANT(mc);
+    INVARIANT(io);
+
+    mclass_io_ops_set(mcid_to_mclass(mc->mcid), io);
+
+#ifdef HAVE_IO_URING
+    if (mc->uring && mc->mcid != MCID_PMEM) {
+        io->read = io_uring_ops.read;
+        io->write = io_uring_ops.write;
+    }
+#endif
+}
+
 merr_t
 mclass_info_get(const struct media_class *mc, struct hse_mclass_info *info)
 {
@@ -487,6 +513,15 @@ mclass_info_get(const struct media_class *mc, struct hse_mclass_info *info)
     return 0;
 }
 
+merr_t
+mclass_avail_get(const struct media_class *mc, uint64_t *avail)
+{
+    assert(mc);
+    assert(avail);
+
+    return mblock_fset_avail_get(mc->mbfsp, avail);
+}
+
 void
 mclass_props_get(const struct media_class * const mc, struct mpool_mclass_props * const props)
 {
@@ -527,3 +562,162 @@ mclass_ftw(struct media_class *mc, const char *prefix, struct mpool_file_cb *cb)
 
     return 0;
 }
+
+/* Clone srcfd into tgtfd.  A reflink of the whole file is attempted first,
+ * failing that only the allocated extents of the source are cloned so that
+ * the (typically very sparse) mblock data files remain sparse in the target.
+ */
+static merr_t
+mclass_file_clone(int srcfd, int tgtfd, off_t size)
+{
+    off_t data, hole = 0;
+    merr_t err;
+
+    if (!ioctl(tgtfd, FICLONE, srcfd))
+        return 0;
+
+    if (ftruncate(tgtfd, size))
+        return merr(errno);
+
+    while (hole < size) {
+        data = lseek(srcfd, hole, SEEK_DATA);
+        if (data == -1) {
+            if (errno == ENXIO)
+                break; /* no data beyond hole */
+            return merr(errno);
+        }
+
+        if (data >= size)
+            break;
+
+        hole = lseek(srcfd, data, SEEK_HOLE);
+        if (hole == -1)
+            return merr(errno);
+
+        hole = min_t(off_t, hole, size);
+
+        err = io_sync_ops.clone(srcfd, data, tgtfd, data, hole - data, 0);
+        if (err)
+            return err;
+    }
+
+    return 0;
+}
+
+/* Clone the file name from srcdirfd into tgtdirfd.  A file that already
+ * exists in the target was cloned earlier in the same checkpoint (e.g., a
+ * frozen MDC) and is left as is.
+ */
+static merr_t
+mclass_file_checkpoint(int srcdirfd, int tgtdirfd, const char *name)
+{
+    struct stat sb;
+    int srcfd, tgtfd;
+    merr_t err;
+
+    srcfd = openat(srcdirfd, name, O_RDONLY);
+    if (srcfd == -1)
+        return merr(errno);
+
+    if (fstat(srcfd, &sb)) {
+        err = merr(errno);
+        close(srcfd);
+        return err;
+    }
+
+    if (!S_ISREG(sb.st_mode)) {
+        close(srcfd);
+        return 0;
+    }
+
+    tgtfd = openat(tgtdirfd, name, O_CREAT | O_EXCL | O_WRONLY, sb.st_mode & 0777);
+    if (tgtfd == -1) {
+        err = (errno == EEXIST) ? 0 : merr(errno);
+        close(srcfd);
+        return err;
+    }
+
+    err = mclass_file_clone(srcfd, tgtfd, sb.st_size);
+    if (!err && fsync(tgtfd))
+        err = merr(errno);
+
+    close(tgtfd);
+    close(srcfd);
+
+    return err;
+}
+
+static merr_t
+mclass_checkpoint_dir_open(const char *path, int *tgtdirfd)
+{
+    if (mkdir(path, S_IRGRP | S_IXGRP | S_IRWXU) && errno != EEXIST)
+        return merr(errno);
+
+    *tgtdirfd = open(path, O_DIRECTORY | O_RDONLY);
+    if (*tgtdirfd == -1)
+        return merr(errno);
+
+    return 0;
+}
+
+static merr_t
+mclass_checkpoint_dir_close(int tgtdirfd, merr_t err)
+{
+    if (!err && fsync(tgtdirfd))
+        err = merr(errno);
+
+    close(tgtdirfd);
+
+    return err;
+}
+
+merr_t
+mclass_checkpoint_file(struct media_class *mc, const char *name, const char *path)
+{
+    int tgtdirfd;
+    merr_t err;
+
+    INVARIANT(mc && name && path);
+
+    err = mclass_checkpoint_dir_open(path, &tgtdirfd);
+    if (err)
+        return err;
+
+    err = mclass_file_checkpoint(mclass_dirfd(mc), tgtdirfd, name);
+    if (err)
+        log_errx("Cloning %s/%s to %s failed", err, mc->dpath, name, path);
+
+    return mclass_checkpoint_dir_close(tgtdirfd, err);
+}
+
+merr_t
+mclass_checkpoint(struct media_class *mc, const char *path)
+{
+    struct dirent *d;
+    DIR *dirp;
+    int tgtdirfd;
+    merr_t err;
+
+    INVARIANT(mc && path);
+
+    err = mclass_checkpoint_dir_open(path, &tgtdirfd);
+    if (err)
+        return err;
+
+    dirp = opendir(mc->dpath);
+    if (!dirp)
+        return mclass_checkpoint_dir_close(tgtdirfd, merr(errno));
+
+    while (!err && (d = readdir(dirp))) {
+        if (!mclass_files_prefix(d->d_name))
+            continue;
+
+        err = mclass_file_checkpoint(dirfd(dirp), tgtdirfd, d->d_name);
+        if (err)
+            log_errx("Cloning %s/%s to %s failed", err, mc->dpath, d->d_name, path);
+    }
+
+    closedir(dirp);
+
+    return mclass_checkpoint_dir_close(tgtdirfd, err);
+}
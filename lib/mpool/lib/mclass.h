@@ -36,12 +36,14 @@ enum mclass_id {
  * @fmaxsz:   max file size
  * @mblocksz: mblock size
  * @filecnt:  number of files in an mclass fileset
+ * @uring:    use io_uring for mblock data reads and writes
  * @path:     storage path
  */
 struct mclass_params {
     size_t fmaxsz;
     size_t mblocksz;
     uint8_t filecnt;
+    bool uring;
     char path[PATH_MAX];
 };
 
@@ -194,6 +196,18 @@ mclass_gclose_get(const struct media_class *mc);
 void
 mclass_io_ops_set(enum hse_mclass mclass, struct io_ops *io);
 
+/**
+ * mclass_data_io_ops_set() -  set io ops for mblock data reads and writes
+ *
+ * @mc: mclass handle
+ * @io: io_ops (output)
+ *
+ * Same as mclass_io_ops_set() unless io_uring was requested for this mclass
+ * and HSE was built with io_uring support.
+ */
+void
+mclass_data_io_ops_set(const struct media_class *mc, struct io_ops *io);
+
 /**
  * mclass_info_get() - get media class info
  *
@@ -203,6 +217,15 @@ mclass_io_ops_set(enum hse_mclass mclass, struct io_ops *io);
 merr_t
 mclass_info_get(const struct media_class *mc, struct hse_mclass_info *info);
 
+/**
+ * mclass_avail_get() - get the space available for new mblocks
+ *
+ * @mc:    mclass handle
+ * @avail: available bytes (output)
+ */
+merr_t
+mclass_avail_get(const struct media_class *mc, uint64_t *avail);
+
 /** @brief Get properties of a media class.
  *
  * @param mc: Media class.
@@ -221,6 +244,27 @@ mclass_props_get(const struct media_class *mc, struct mpool_mclass_props *props)
 merr_t
 mclass_ftw(struct media_class *mc, const char *prefix, struct mpool_file_cb *cb);
 
+/**
+ * mclass_checkpoint() - clone all the mpool files of an mclass into a directory
+ *
+ * @mc:   mclass handle
+ * @path: target directory, created if it does not exist
+ *
+ * Files which already exist in @path are skipped.
+ */
+merr_t
+mclass_checkpoint(struct media_class *mc, const char *path);
+
+/**
+ * mclass_checkpoint_file() - clone one mpool file of an mclass into a directory
+ *
+ * @mc:   mclass handle
+ * @name: file name
+ * @path: target directory, created if it does not exist
+ */
+merr_t
+mclass_checkpoint_file(struct media_class *mc, const char *name, const char *path);
+
 /**
  * mclass_files_exist() - check for existence of media class files
  *
@@ -155,6 +155,39 @@ mpool_mdc_abort(struct mpool *mp, uint64_t logid1, uint64_t logid2)
     return mpool_mdc_delete(mp, logid1, logid2);
 }
 
+merr_t
+mpool_mdc_checkpoint(
+    struct mpool *mp,
+    uint64_t logid1,
+    uint64_t logid2,
+    const char *paths[HSE_MCLASS_COUNT])
+{
+    struct media_class *mc;
+    enum hse_mclass mclass;
+    uint64_t id[] = { logid1, logid2 };
+    merr_t err;
+
+    if (!mp || !paths || !logids_valid(logid1, logid2))
+        return merr(EINVAL);
+
+    mclass = mcid_to_mclass(logid_mcid(logid1));
+    mc = mpool_mclass_handle(mp, mclass);
+    if (!mc || !paths[mclass])
+        return merr(EINVAL);
+
+    for (int i = 0; i < 2; i++) {
+        char name[MDC_NAME_LENGTH_MAX];
+
+        mdc_filename_gen(name, sizeof(name), id[i]);
+
+        err = mclass_checkpoint_file(mc, name, paths[mclass]);
+        if (err)
+            return err;
+    }
+
+    return 0;
+}
+
 merr_t
 mpool_mdc_open(
     struct mpool *mp,
@@ -24,6 +24,7 @@
 #include <hse/util/dax.h>
 #include <hse/util/event_counter.h>
 #include <hse/util/page.h>
+#include <hse/util/rmlock.h>
 #include <hse/util/workqueue.h>
 
 #include "mblock_file.h"
@@ -33,13 +34,15 @@
 /**
  * struct mpool - mpool handle
  *
- * @mc:   media class handles
- * @home: kvdb home
+ * @mc:        media class handles
+ * @ckpt_lock: excludes mblock deletes and punches while a checkpoint is taken
+ * @home:      kvdb home
  *
  * [HSE_REVISIT]: Remove home member when logging is reworked
  */
 struct mpool {
     struct media_class *mc[HSE_MCLASS_COUNT];
+    struct rmlock ckpt_lock;
     const char home[]; /* flexible array */
 };
 
@@ -261,6 +264,12 @@ mpool_create(const char *home, const struct mpool_cparams *cparams)
     strcpy((char *)mp->home, home);
     flags |= (O_CREAT | O_RDWR);
 
+    err = rmlock_init(&mp->ckpt_lock);
+    if (err) {
+        free(mp);
+        return err;
+    }
+
     for (i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++) {
         struct mclass_params mcp = { 0 };
 
@@ -327,6 +336,7 @@ errout:
             remove(cparams->mclass[i].path);
     }
 
+    rmlock_destroy(&mp->ckpt_lock);
     free(mp);
 
     return err;
@@ -356,6 +366,12 @@ mpool_open(
 
     strcpy((char *)mp->home, home);
 
+    err = rmlock_init(&mp->ckpt_lock);
+    if (err) {
+        free(mp);
+        return err;
+    }
+
     for (i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++) {
         struct mclass_params mcp = { 0 };
         uint32_t oflags = flags;
@@ -364,6 +380,8 @@ mpool_open(
         if (err)
             goto errout;
 
+        mcp.uring = rparams->mclass[i].uring_enable;
+
         if (!rparams->mclass[i].dio_disable) {
             bool tmpfs;
 
@@ -396,6 +414,7 @@ errout:
     while (i-- > HSE_MCLASS_BASE)
         mclass_close(mp->mc[i]);
 
+    rmlock_destroy(&mp->ckpt_lock);
     free(mp);
 
     return err;
@@ -417,6 +436,7 @@ mpool_close(struct mpool *mp)
         }
     }
 
+    rmlock_destroy(&mp->ckpt_lock);
     free(mp);
 
     return err;
@@ -491,6 +511,21 @@ mpool_mclass_info_get(struct mpool *mp, const enum hse_mclass mclass, struct hse
     return mclass_info_get(mc, info);
 }
 
+merr_t
+mpool_mclass_avail_get(struct mpool *mp, const enum hse_mclass mclass, uint64_t *avail)
+{
+    struct media_class *mc;
+
+    if (!mp || mclass >= HSE_MCLASS_COUNT || !avail)
+        return merr(EINVAL);
+
+    mc = mp->mc[mclass];
+    if (!mc)
+        return merr(ENOENT);
+
+    return mclass_avail_get(mc, avail);
+}
+
 merr_t
 mpool_props_get(struct mpool *mp, struct mpool_props *props)
 {
@@ -582,6 +617,59 @@ mpool_mclass_ftw(
     return mclass_ftw(mc, prefix, cb);
 }
 
+void
+mpool_ckpt_rlock(struct mpool *mp, void **cookiep)
+{
+    rmlock_rlock(&mp->ckpt_lock, cookiep);
+}
+
+void
+mpool_ckpt_runlock(void *cookie)
+{
+    rmlock_runlock(cookie);
+}
+
+merr_t
+mpool_checkpoint(
+    struct mpool *mp,
+    const char *paths[HSE_MCLASS_COUNT],
+    mpool_checkpoint_cb *cb,
+    void *arg)
+{
+    merr_t err = 0;
+    int i;
+
+    if (!mp || !paths)
+        return merr(EINVAL);
+
+    for (i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT; i++) {
+        if (mp->mc[i] && ev(!paths[i] || paths[i][0] == '\0'))
+            return merr(EINVAL);
+    }
+
+    /* Holding the write lock keeps every mblock referenced by the metadata
+     * frozen by the callback intact until all the files have been cloned.
+     * New mblocks may still be allocated, written and committed.
+     */
+    rmlock_wlock(&mp->ckpt_lock);
+
+    if (cb)
+        err = cb(arg);
+
+    for (i = HSE_MCLASS_BASE; i < HSE_MCLASS_COUNT && !err; i++) {
+        if (!mp->mc[i])
+            continue;
+
+        err = mclass_checkpoint(mp->mc[i], paths[i]);
+        if (err)
+            log_errx("Checkpoint of mclass %s to %s failed", err, hse_mclass_name_get(i), paths[i]);
+    }
+
+    rmlock_wunlock(&mp->ckpt_lock);
+
+    return err;
+}
+
 bool
 mpool_mclass_is_configured(struct mpool * const mp, const enum hse_mclass mclass)
 {
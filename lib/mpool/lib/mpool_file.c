@@ -162,6 +162,25 @@ mpool_file_destroy(struct mpool *mp, enum hse_mclass mclass, const char *name)
     return 0;
 }
 
+merr_t
+mpool_file_checkpoint(
+    struct mpool *mp,
+    enum hse_mclass mclass,
+    const char *name,
+    const char *paths[HSE_MCLASS_COUNT])
+{
+    struct media_class *mc;
+
+    if (!mp || !name || !paths || mclass >= HSE_MCLASS_COUNT)
+        return merr(EINVAL);
+
+    mc = mpool_mclass_handle(mp, mclass);
+    if (!mc || !paths[mclass])
+        return merr(EINVAL);
+
+    return mclass_checkpoint_file(mc, name, paths[mclass]);
+}
+
 merr_t
 mpool_file_read(struct mpool_file *file, off_t offset, char *buf, size_t buflen, size_t *rdlen)
 {
@@ -30,4 +30,25 @@ mpool_mclass_handle(struct mpool *mp, enum hse_mclass mclass);
 merr_t
 mpool_mclass_dirfd(struct mpool *mp, enum hse_mclass mclass, int *dirfd);
 
+/**
+ * mpool_ckpt_rlock - acquire the checkpoint lock for reading
+ *
+ * @mp:      mpool handle
+ * @cookiep: lock cookie (output)
+ *
+ * Must be held across any operation that destroys mblock data, such that
+ * mpool_checkpoint() never observes an mblock that is referenced by the
+ * checkpointed cndb but already deleted or punched.
+ */
+void
+mpool_ckpt_rlock(struct mpool *mp, void **cookiep);
+
+/**
+ * mpool_ckpt_runlock - release the checkpoint lock
+ *
+ * @cookie: lock cookie returned by mpool_ckpt_rlock()
+ */
+void
+mpool_ckpt_runlock(void *cookie);
+
 #endif /* MPOOL_INTERNAL_H */
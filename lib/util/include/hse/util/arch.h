@@ -225,6 +225,27 @@ memlcpq(const void *s1, const void *s2, const size_t len)
     return i;
 }
 
+/**
+ * enum hse_simd - SIMD instruction set available to vectorized kernels
+ *
+ * Probed once by hse_simd_init() during platform initialization so that
+ * hot paths can select a kernel via a single, well predicted branch.
+ */
+enum hse_simd {
+    HSE_SIMD_NONE,
+    HSE_SIMD_SSE42,
+    HSE_SIMD_AVX2,
+    HSE_SIMD_NEON,
+};
+
+extern enum hse_simd hse_simd;
+
+void
+hse_simd_init(void);
+
+const char *
+hse_simd_name(enum hse_simd simd);
+
 /* GCOV_EXCL_STOP */
 
 #endif
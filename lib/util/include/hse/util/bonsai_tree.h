@@ -91,14 +91,16 @@ struct bonsai_skey {
  * @bv_xlen:      opaque encoded value length
  * @bv_priv:      user-managed ptr
  * @bv_free:      ptr to next value in free list bkv_freevals
- * @bv_valbuf:    value data (zero length if caller managed)
+ * @bv_valbuf:    expiration time (if any) and value data (if not managed)
  *
  * A bonsai_val includes the value data and may be on both the bnkv_values
  * list and the free list at the same time.
  *
  * Note that the value length (@bv_xlen) is an opaque encoding of compressed
  * and uncompressed value lengths so one must use the bonsai_val_*len()
- * functions to decode it.
+ * functions to decode it.  The top bit of @bv_xlen is set if the value has
+ * an expiration time, in which case the time is stored at the head of
+ * @bv_valbuf and must be read via bonsai_val_expire().
  */
 struct bonsai_val {
     uintptr_t          bv_seqnoref;
@@ -110,6 +112,8 @@ struct bonsai_val {
     char               bv_valbuf[];
 };
 
+#define BONSAI_XLEN_EXPIRE (1ull << 63)
+
 /**
  * bonsai_val_ulen() - return uncompressed value length
  * @bv: ptr to a bonsai val
@@ -136,7 +140,20 @@ bonsai_val_ulen(const struct bonsai_val *bv)
 static HSE_ALWAYS_INLINE uint
 bonsai_val_clen(const struct bonsai_val *bv)
 {
-    return bv->bv_xlen >> 32;
+    return (bv->bv_xlen >> 32) & 0xfffffful;
+}
+
+/**
+ * bonsai_val_calgo() - return compression algorithm
+ * @bv: ptr to a bonsai val
+ *
+ * bonsai_val_calgo() returns the caller-defined compression algorithm
+ * recorded in the top byte of the given compressed bonsai value's xlen.
+ */
+static HSE_ALWAYS_INLINE uint
+bonsai_val_calgo(const struct bonsai_val *bv)
+{
+    return (bv->bv_xlen & ~BONSAI_XLEN_EXPIRE) >> 56;
 }
 
 /**
@@ -152,11 +169,28 @@ bonsai_val_vlen(const struct bonsai_val *bv)
     return bonsai_val_clen(bv) ?: bonsai_val_ulen(bv);
 }
 
+/**
+ * bonsai_val_expire() - return expiration time
+ * @bv: ptr to a bonsai val
+ *
+ * bonsai_val_expire() returns the user-defined expiration time of the
+ * given bonsai value, or zero if it never expires.
+ */
+static HSE_ALWAYS_INLINE uint64_t
+bonsai_val_expire(const struct bonsai_val *bv)
+{
+    if (bv->bv_xlen & BONSAI_XLEN_EXPIRE)
+        return *(const uint64_t *)bv->bv_valbuf;
+
+    return 0;
+}
+
 /**
  * struct bonsai_sval - input value argument
  * @bsv_val:      pointer to value data
  * @bsv_xlen:     opaque encoded value length
  * @bsv_seqnoref: sequence number reference
+ * @bsv_expire:   user-defined expiration time (zero if none)
  *
  * Note that the value length (@bsv_xlen) is an opaque encoding of compressed
  * and uncompressed value lengths so one must use the bonsai_sval_vlen()
@@ -166,6 +200,7 @@ struct bonsai_sval {
     void     *bsv_val;
     uint64_t  bsv_xlen;
     uintptr_t bsv_seqnoref;
+    uint64_t  bsv_expire;
 };
 
 /**
@@ -178,7 +213,7 @@ struct bonsai_sval {
 static HSE_ALWAYS_INLINE uint
 bonsai_sval_vlen(const struct bonsai_sval *bsv)
 {
-    uint clen = bsv->bsv_xlen >> 32;
+    uint clen = (bsv->bsv_xlen >> 32) & 0xfffffful;
     uint vlen = bsv->bsv_xlen & 0xfffffffful;
 
     return clen ?: vlen;
@@ -601,6 +636,7 @@ bn_sval_init(void *val, uint64_t xlen, uintptr_t seqnoref, struct bonsai_sval *s
     sval->bsv_val = val;
     sval->bsv_xlen = xlen;
     sval->bsv_seqnoref = seqnoref;
+    sval->bsv_expire = 0;
 }
 
 static inline int32_t
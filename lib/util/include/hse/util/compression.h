@@ -13,9 +13,21 @@
 typedef uint
 compress_op_estimate_t(const void *data, uint len);
 
+/* %level is a codec specific compression level, where zero selects the
+ * codec's default.  Codecs without levels ignore it.
+ */
 typedef merr_t
-compress_op_compress_t(const void *src, uint src_len, void *dst, uint dst_capacity, uint *dst_len);
+compress_op_compress_t(
+    const void *src,
+    uint src_len,
+    void *dst,
+    uint dst_capacity,
+    int level,
+    uint *dst_len);
 
+/* Decompression into a %dst_capacity smaller than the original length must
+ * succeed and yield the first %dst_capacity bytes of the original data.
+ */
 typedef merr_t
 compress_op_decompress_t(
     const void *src,
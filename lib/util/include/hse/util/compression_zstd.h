@@ -0,0 +1,15 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#ifndef HSE_UTIL_COMPRESS_ZSTD_H
+#define HSE_UTIL_COMPRESS_ZSTD_H
+
+#include <zstd.h>
+
+#include <hse/util/compression.h>
+
+extern struct compress_ops compress_zstd_ops;
+
+#endif
@@ -56,4 +56,36 @@ hse_getcpu(uint *node)
 
 #endif
 
+enum hse_simd hse_simd HSE_READ_MOSTLY;
+
+void
+hse_simd_init(void)
+{
+#if __amd64__
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        hse_simd = HSE_SIMD_AVX2;
+    else if (__builtin_cpu_supports("sse4.2"))
+        hse_simd = HSE_SIMD_SSE42;
+#elif __aarch64__
+    hse_simd = HSE_SIMD_NEON; /* Advanced SIMD is mandatory on aarch64 */
+#endif
+}
+
+const char *
+hse_simd_name(enum hse_simd simd)
+{
+    switch (simd) {
+    case HSE_SIMD_SSE42:
+        return "sse4.2";
+    case HSE_SIMD_AVX2:
+        return "avx2";
+    case HSE_SIMD_NEON:
+        return "neon";
+    default:
+        return "none";
+    }
+}
+
 /* GCOV_EXCL_STOP */
@@ -359,17 +359,41 @@ bn_alloc(struct bonsai_root *tree, size_t sz)
     return malloc(sz);
 }
 
+static size_t
+bn_val_size(const struct bonsai_sval *sval, bool managed)
+{
+    size_t sz = sizeof(struct bonsai_val);
+
+    if (sval->bsv_expire)
+        sz += sizeof(sval->bsv_expire);
+
+    if (!managed)
+        sz += bonsai_sval_vlen(sval);
+
+    return sz;
+}
+
 static struct bonsai_val *
 bn_val_init(struct bonsai_val *v, const struct bonsai_sval *sval, size_t sz)
 {
+    size_t off = sizeof(*v);
+
     memset(v, 0, sizeof(*v));
     v->bv_seqnoref = sval->bsv_seqnoref;
     v->bv_value = sval->bsv_val;
-    v->bv_xlen = sval->bsv_xlen;
+    v->bv_xlen = sval->bsv_xlen & ~BONSAI_XLEN_EXPIRE;
 
-    if (sz > sizeof(*v)) {
-        memcpy(v->bv_valbuf, sval->bsv_val, sz - sizeof(*v));
-        v->bv_value = v->bv_valbuf;
+    /* Only values with an expiration time pay for storing it.
+     */
+    if (sval->bsv_expire) {
+        memcpy(v->bv_valbuf, &sval->bsv_expire, sizeof(sval->bsv_expire));
+        v->bv_xlen |= BONSAI_XLEN_EXPIRE;
+        off += sizeof(sval->bsv_expire);
+    }
+
+    if (sz > off) {
+        memcpy((char *)v + off, sval->bsv_val, sz - off);
+        v->bv_value = (char *)v + off;
     }
 
     return v;
@@ -381,10 +405,7 @@ bn_val_alloc(struct bonsai_root *tree, const struct bonsai_sval *sval, bool mana
     struct bonsai_val *v;
     size_t sz;
 
-    sz = sizeof(*v);
-
-    if (!managed)
-        sz += bonsai_sval_vlen(sval);
+    sz = bn_val_size(sval, managed);
 
     v = bn_alloc(tree, sz);
     if (v) {
@@ -449,13 +470,12 @@ bn_kv_alloc(
     uint16_t voffset;
 
     ksz = sizeof(*kv);
-    vsz = sizeof(*v);
 
     managed = skey->bsk_flags & HSE_BTF_MANAGED;
-    if (!managed) {
+    if (!managed)
         ksz += key_imm_klen(&skey->bsk_key_imm);
-        vsz += bonsai_sval_vlen(sval);
-    }
+
+    vsz = bn_val_size(sval, managed);
 
     voffset = roundup(ksz, sizeof(uintptr_t));
 
@@ -26,7 +26,13 @@ compress_lz4_estimate(const void *data, uint len)
 }
 
 static merr_t
-compress_lz4_compress(const void *src, uint src_len, void *dst, uint dst_capacity, uint *dst_len)
+compress_lz4_compress(
+    const void *src,
+    uint src_len,
+    void *dst,
+    uint dst_capacity,
+    int level,
+    uint *dst_len)
 {
     int len;
 
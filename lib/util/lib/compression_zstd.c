@@ -0,0 +1,191 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#include <hse/logging/logging.h>
+#include <hse/util/assert.h>
+#include <hse/util/compiler.h>
+#include <hse/util/compression_zstd.h>
+#include <hse/util/event_counter.h>
+
+#if ZSTD_VERSION_NUMBER < (10000 + 400 + 0)
+#error "Need zstd 1.4.0 or higher"
+#endif
+
+/**
+ * struct compress_zstd_ctx - per-thread zstd contexts
+ *
+ * @cctx: compression context
+ * @dctx: decompression context
+ *
+ * zstd contexts are expensive to create but may be reused indefinitely,
+ * so each thread that compresses or decompresses values lazily creates
+ * its own and keeps them until it exits.
+ */
+struct compress_zstd_ctx {
+    ZSTD_CCtx *cctx;
+    ZSTD_DCtx *dctx;
+};
+
+static pthread_key_t  compress_zstd_key;
+static pthread_once_t compress_zstd_once = PTHREAD_ONCE_INIT;
+
+static thread_local struct compress_zstd_ctx *compress_zstd_tls;
+
+static void
+compress_zstd_ctx_free(void *arg)
+{
+    struct compress_zstd_ctx *ctx = arg;
+
+    if (!ctx)
+        return;
+
+    ZSTD_freeCCtx(ctx->cctx);
+    ZSTD_freeDCtx(ctx->dctx);
+    free(ctx);
+}
+
+static void
+compress_zstd_key_init(void)
+{
+    int rc HSE_MAYBE_UNUSED;
+
+    rc = pthread_key_create(&compress_zstd_key, compress_zstd_ctx_free);
+    assert(rc == 0);
+}
+
+static struct compress_zstd_ctx *
+compress_zstd_ctx_get(void)
+{
+    struct compress_zstd_ctx *ctx = compress_zstd_tls;
+
+    if (HSE_LIKELY(ctx))
+        return ctx;
+
+    pthread_once(&compress_zstd_once, compress_zstd_key_init);
+
+    ctx = calloc(1, sizeof(*ctx));
+    if (ev(!ctx))
+        return NULL;
+
+    pthread_setspecific(compress_zstd_key, ctx);
+    compress_zstd_tls = ctx;
+
+    return ctx;
+}
+
+static uint
+compress_zstd_estimate(const void *data, uint len)
+{
+    if (!len)
+        return 0;
+
+    return (uint)ZSTD_compressBound(len);
+}
+
+static merr_t
+compress_zstd_compress(
+    const void *src,
+    uint src_len,
+    void *dst,
+    uint dst_capacity,
+    int level,
+    uint *dst_len)
+{
+    struct compress_zstd_ctx *ctx;
+    size_t len;
+
+    assert(src && dst && dst_len);
+    assert(src_len && dst_capacity);
+
+    ctx = compress_zstd_ctx_get();
+    if (ev(!ctx))
+        return merr(ENOMEM);
+
+    if (!ctx->cctx) {
+        ctx->cctx = ZSTD_createCCtx();
+        if (ev(!ctx->cctx))
+            return merr(ENOMEM);
+    }
+
+    /* The uncompressed length is stored alongside every compressed value,
+     * so there is no need to spend frame header bytes on it.
+     */
+    ZSTD_CCtx_reset(ctx->cctx, ZSTD_reset_session_only);
+    ZSTD_CCtx_setParameter(ctx->cctx, ZSTD_c_compressionLevel, level);
+    ZSTD_CCtx_setParameter(ctx->cctx, ZSTD_c_contentSizeFlag, 0);
+
+    len = ZSTD_compress2(ctx->cctx, dst, dst_capacity, src, src_len);
+
+    *dst_len = ZSTD_isError(len) ? 0 : len;
+
+    return ZSTD_isError(len) ? merr(EFBIG) : 0;
+}
+
+static merr_t
+compress_zstd_decompress(
+    const void *src,
+    uint src_len,
+    void *dst,
+    uint dst_capacity,
+    uint *dst_len)
+{
+    struct compress_zstd_ctx *ctx;
+    ZSTD_outBuffer out = { dst, dst_capacity, 0 };
+    ZSTD_inBuffer in = { src, src_len, 0 };
+    size_t rc;
+
+    assert(src && dst && dst_len);
+    assert(src_len && dst_capacity);
+
+    ctx = compress_zstd_ctx_get();
+    if (ev(!ctx))
+        return merr(ENOMEM);
+
+    if (!ctx->dctx) {
+        ctx->dctx = ZSTD_createDCtx();
+        if (ev(!ctx->dctx))
+            return merr(ENOMEM);
+    }
+
+    ZSTD_DCtx_reset(ctx->dctx, ZSTD_reset_session_only);
+
+    /* Stream into the caller's buffer so that a short buffer yields the
+     * leading bytes of the value rather than an error.  Stop once the frame
+     * is complete, the buffer is full, or no further progress can be made
+     * (i.e., the frame is truncated).
+     */
+    while (1) {
+        size_t inpos = in.pos, outpos = out.pos;
+
+        rc = ZSTD_decompressStream(ctx->dctx, &out, &in);
+        if (ZSTD_isError(rc) || rc == 0 || out.pos == out.size)
+            break;
+
+        if (in.pos == inpos && out.pos == outpos)
+            break;
+    }
+
+    if (HSE_UNLIKELY(ZSTD_isError(rc) || (rc > 0 && out.pos < out.size))) {
+        log_err(
+            "slen %u, cap %u, len %zu, src %p, dst %p, ver %s: %s", src_len, dst_capacity,
+            out.pos, src, dst, ZSTD_versionString(),
+            ZSTD_isError(rc) ? ZSTD_getErrorName(rc) : "truncated frame");
+
+        return merr(EFBIG);
+    }
+
+    *dst_len = out.pos;
+
+    return 0;
+}
+
+struct compress_ops compress_zstd_ops HSE_READ_MOSTLY = {
+    .cop_estimate = compress_zstd_estimate,
+    .cop_compress = compress_zstd_compress,
+    .cop_decompress = compress_zstd_decompress,
+};
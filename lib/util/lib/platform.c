@@ -189,9 +189,11 @@ hse_cpu_init(void)
 
     hse_tsc_mult = (NSEC_PER_SEC << HSE_TSC_SHIFT) / hse_tsc_freq;
 
+    hse_simd_init();
+
     log_info(
-        "bogomips %d, freq %lu, shift %u, mult %u, L1D_CLSZ %d", bogomips, hse_tsc_freq,
-        HSE_TSC_SHIFT, hse_tsc_mult, LEVEL1_DCACHE_LINESIZE);
+        "bogomips %d, freq %lu, shift %u, mult %u, L1D_CLSZ %d, simd %s", bogomips, hse_tsc_freq,
+        HSE_TSC_SHIFT, hse_tsc_mult, LEVEL1_DCACHE_LINESIZE, hse_simd_name(hse_simd));
 
     return 0;
 }
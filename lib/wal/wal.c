@@ -85,6 +85,12 @@ struct wal_sync_waiter {
 
 #define recoverable_error(rc)  (rc == EAGAIN || rc == ECANCELED)
 
+/* Upper bound on the size of a single write batch buffer reservation.  It must
+ * stay well below the 8MB of headroom wal_bufset_alloc() keeps between the
+ * head and the tail of a buffer.
+ */
+#define WAL_BATCH_RESV_MAX     (4ul << MB_SHIFT)
+
 /* clang-format on */
 
 /* Forward decls */
@@ -346,6 +352,33 @@ wal_sync(struct wal *wal)
     return wal_sync_impl(wal, &swait);
 }
 
+void
+wal_pin(struct wal *wal)
+{
+    wal_fileset_pin(wal->wfset);
+}
+
+void
+wal_unpin(struct wal *wal)
+{
+    wal_fileset_unpin(wal->wfset);
+}
+
+merr_t
+wal_checkpoint(struct wal *wal, const char *paths[HSE_MCLASS_COUNT])
+{
+    merr_t err;
+
+    if (!wal || !paths)
+        return merr(EINVAL);
+
+    err = wal_mdc_checkpoint(wal->mdc, paths);
+    if (!err)
+        err = wal_fileset_checkpoint(wal->wfset, paths);
+
+    return err;
+}
+
 static merr_t
 wal_cond_sync(struct wal *wal, uint64_t gen)
 {
@@ -399,6 +432,8 @@ wal_put(
     vlen = kvs_vtuple_vlen(vt);
     rlen = wal_reclen(wal->version);
     kvlen = ALIGN(klen, kvalign) + ALIGN(vlen, kvalign);
+    if (vt->vt_expire)
+        kvlen += sizeof(uint64_t);
     len = rlen + kvlen;
 
     rec = wal_bufset_alloc(wal->wbs, len, &recout->offset, &recout->wbidx, &recout->cookie);
@@ -415,19 +450,24 @@ wal_put(
     rtype = (txid > 0) ? WAL_RT_TX : WAL_RT_NONTX;
     wal_rechdr_pack(rtype, rid, len, 0, rec);
 
-    wal_rec_pack(WAL_OP_PUT, kvs->ikv_cnid, txid, klen, vt->vt_xlen, rec);
+    wal_rec_pack(
+        vt->vt_expire ? WAL_OP_PUT_TTL : WAL_OP_PUT, kvs->ikv_cnid, txid, klen, vt->vt_xlen, rec);
 
     kvdata = (char *)rec + rlen;
     memcpy(kvdata, kt->kt_data, klen);
     kt->kt_data = kvdata;
     kt->kt_flags = wal->buf_flags;
+    kvdata = PTR_ALIGN(kvdata + klen, kvalign);
 
     if (vlen > 0) {
-        kvdata = PTR_ALIGN(kvdata + klen, kvalign);
         memcpy(kvdata, vt->vt_data, vlen);
         vt->vt_data = kvdata;
+        kvdata = PTR_ALIGN(kvdata + vlen, kvalign);
     }
 
+    if (vt->vt_expire)
+        *(uint64_t *)kvdata = cpu_to_omf64(vt->vt_expire);
+
     return 0;
 }
 
@@ -502,6 +542,93 @@ wal_del_pfx(
     return wal_del_impl(wal, kvs, kt, txid, recout, true);
 }
 
+merr_t
+wal_write_batch(
+    struct wal *wal,
+    struct ikvs *kvs,
+    struct kvs_batch_op *opv,
+    uint *cntp,
+    struct wal_record *recv)
+{
+    const size_t kvalign = sizeof(uint64_t);
+    size_t rlen, total = 0;
+    uint64_t offset;
+    uint32_t wbidx;
+    int64_t cookie = -1;
+    uint cnt, i;
+    merr_t err;
+
+    if (!wal)
+        return 0;
+
+    rlen = wal_reclen(wal->version);
+
+    /* Size the reservation, the first op is always accepted.
+     */
+    for (cnt = 0; cnt < *cntp; ++cnt) {
+        const struct kvs_batch_op *op = opv + cnt;
+        size_t len;
+
+        len = rlen + ALIGN(op->bo_kt.kt_len, kvalign);
+        if (!op->bo_del)
+            len += ALIGN(kvs_vtuple_vlen(&op->bo_vt), kvalign);
+
+        if (cnt > 0 && total + len > WAL_BATCH_RESV_MAX)
+            break;
+
+        recv[cnt].len = len;
+        total += len;
+    }
+
+    if (!wal_bufset_alloc(wal->wbs, total, &offset, &wbidx, &cookie)) {
+        err = merr(ENOMEM); /* unrecoverable error */
+        kvdb_health_error(wal->health, err);
+        return err;
+    }
+
+    /* Each op is laid out as an ordinary record at its own buffer offset,
+     * so the flusher and replay treat them exactly like individual puts
+     * and deletes.
+     */
+    for (i = 0; i < cnt; ++i) {
+        struct kvs_batch_op *op = opv + i;
+        struct wal_record *rec = recv + i;
+        size_t klen = op->bo_kt.kt_len;
+        uint64_t rid;
+        char *kvdata;
+
+        rec->recbuf = wal_bufset_addr(wal->wbs, wbidx, offset);
+        rec->offset = offset;
+        rec->wbidx = wbidx;
+        rec->cookie = cookie;
+        offset += rec->len;
+
+        rid = atomic_inc_return(&wal->wal_rid);
+        wal_rechdr_pack(WAL_RT_NONTX, rid, rec->len, 0, rec->recbuf);
+
+        wal_rec_pack(
+            op->bo_del ? WAL_OP_DEL : WAL_OP_PUT, kvs->ikv_cnid, 0, klen,
+            op->bo_del ? 0 : op->bo_vt.vt_xlen, rec->recbuf);
+
+        kvdata = (char *)rec->recbuf + rlen;
+        memcpy(kvdata, op->bo_kt.kt_data, klen);
+        op->bo_kt.kt_data = kvdata;
+        op->bo_kt.kt_flags = wal->buf_flags;
+
+        if (!op->bo_del && kvs_vtuple_vlen(&op->bo_vt) > 0) {
+            size_t vlen = kvs_vtuple_vlen(&op->bo_vt);
+
+            kvdata = PTR_ALIGN(kvdata + klen, kvalign);
+            memcpy(kvdata, op->bo_vt.vt_data, vlen);
+            op->bo_vt.vt_data = kvdata;
+        }
+    }
+
+    *cntp = cnt;
+
+    return 0;
+}
+
 static merr_t
 wal_txn(
     struct wal *wal,
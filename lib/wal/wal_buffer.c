@@ -427,6 +427,12 @@ wal_bufset_alloc(
     return wb->wb_buf + (offset % wbs->wbs_buf_sz);
 }
 
+void *
+wal_bufset_addr(struct wal_bufset *wbs, uint32_t wbidx, uint64_t offset)
+{
+    return wbs->wbs_bufv[wbidx].wb_buf + (offset % wbs->wbs_buf_sz);
+}
+
 void
 wal_bufset_finish(struct wal_bufset *wbs, uint32_t wbidx, size_t len, uint64_t gen, uint64_t endoff)
 {
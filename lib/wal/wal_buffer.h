@@ -37,6 +37,9 @@ wal_bufset_alloc(
     uint32_t *wbidx,
     int64_t *cookie);
 
+void *
+wal_bufset_addr(struct wal_bufset *wbs, uint32_t wbidx, uint64_t offset);
+
 void
 wal_bufset_finish(
     struct wal_bufset *wbs,
@@ -28,6 +28,9 @@ struct wal_fileset {
     struct list_head complete;
     struct list_head replay;
 
+    struct mutex reclaim_lock;
+    uint pinned;
+
     struct mpool *mp HSE_L1D_ALIGNED;
     enum hse_mclass mclass;
     size_t capacity;
@@ -101,6 +104,11 @@ wal_fileset_reclaim(
 
     INIT_LIST_HEAD(&reclaim);
 
+    /* The reclaim lock is held until the reclaimed files are destroyed, such
+     * that wal_fileset_pin() returns only once no file is being destroyed.
+     */
+    mutex_lock(&wfset->reclaim_lock);
+
     mutex_lock(&wfset->lock);
     list_for_each_entry_safe(cur, next, &wfset->complete, link) {
         struct wal_minmax_info *info = &cur->info;
@@ -119,7 +127,7 @@ wal_fileset_reclaim(
             txid_reclaim = txid_valid ? info->max_txid < txhorizon : true;
         }
 
-        if (seqno_reclaim && txid_reclaim) {
+        if (seqno_reclaim && txid_reclaim && !wfset->pinned) {
             list_del_init(&cur->link);
             list_add_tail(&cur->link, &reclaim);
         } else if (closing) {
@@ -148,9 +156,87 @@ wal_fileset_reclaim(
         wal_file_destroy(wfset, gen, fileid);
     }
 
+    mutex_unlock(&wfset->reclaim_lock);
+
     return 0;
 }
 
+void
+wal_fileset_pin(struct wal_fileset *wfset)
+{
+    mutex_lock(&wfset->reclaim_lock);
+    wfset->pinned++;
+    mutex_unlock(&wfset->reclaim_lock);
+}
+
+void
+wal_fileset_unpin(struct wal_fileset *wfset)
+{
+    mutex_lock(&wfset->reclaim_lock);
+    assert(wfset->pinned > 0);
+    wfset->pinned--;
+    mutex_unlock(&wfset->reclaim_lock);
+}
+
+merr_t
+wal_fileset_checkpoint(struct wal_fileset *wfset, const char *paths[HSE_MCLASS_COUNT])
+{
+    struct wal_file *cur;
+    struct {
+        uint64_t gen;
+        int fileid;
+    } *filev;
+    uint filec = 0, filemax = 0, i;
+    merr_t err = 0;
+
+    if (!wfset || !paths)
+        return merr(EINVAL);
+
+    assert(wfset->pinned > 0);
+
+    /* No file is destroyed while the set is pinned, hence the names taken
+     * under the lock remain valid.  Files created after the names are taken
+     * are cloned by the caller's walk of the media class directory.
+     */
+    mutex_lock(&wfset->lock);
+    list_for_each_entry(cur, &wfset->active, link)
+        filemax++;
+    list_for_each_entry(cur, &wfset->complete, link)
+        filemax++;
+    mutex_unlock(&wfset->lock);
+
+    filev = malloc(max_t(uint, filemax, 1) * sizeof(*filev));
+    if (!filev)
+        return merr(ENOMEM);
+
+    mutex_lock(&wfset->lock);
+    list_for_each_entry(cur, &wfset->complete, link) {
+        if (filec == filemax)
+            break;
+        filev[filec].gen = cur->gen;
+        filev[filec++].fileid = cur->fileid;
+    }
+    list_for_each_entry(cur, &wfset->active, link) {
+        if (filec == filemax)
+            break;
+        filev[filec].gen = cur->gen;
+        filev[filec++].fileid = cur->fileid;
+    }
+    mutex_unlock(&wfset->lock);
+
+    for (i = 0; i < filec && !err; i++) {
+        char name[WAL_FILE_NAME_LEN_MAX];
+
+        snprintf(name, sizeof(name), "%s-%lu-%d", WAL_FILE_PFX, filev[i].gen, filev[i].fileid);
+
+        err = mpool_file_checkpoint(wfset->mp, wfset->mclass, name, paths);
+    }
+
+    free(filev);
+
+    return err;
+}
+
 void
 wal_fileset_mclass_set(struct wal_fileset *wfset, enum hse_mclass mclass)
 {
@@ -185,6 +271,7 @@ wal_fileset_open(
 
     memset(wfset, 0, sizeof(*wfset));
     mutex_init(&wfset->lock);
+    mutex_init(&wfset->reclaim_lock);
     INIT_LIST_HEAD(&wfset->active);
     INIT_LIST_HEAD(&wfset->complete);
     INIT_LIST_HEAD(&wfset->replay);
@@ -214,6 +301,7 @@ wal_fileset_close(
     INIT_LIST_HEAD(&wfset->active);
     wal_fileset_reclaim(wfset, ingestseq, ingestgen, txhorizon, true);
 
+    mutex_destroy(&wfset->reclaim_lock);
     mutex_destroy(&wfset->lock);
     free(wfset);
 }
@@ -76,6 +76,27 @@ wal_fileset_reclaim(
     uint64_t txhorizon,
     bool closing);
 
+/**
+ * wal_fileset_pin() - hold off the destruction of reclaimable WAL files
+ * @wfset: WAL fileset
+ *
+ * Files which become reclaimable while the set is pinned are destroyed by
+ * the first reclaim after wal_fileset_unpin().
+ */
+void
+wal_fileset_pin(struct wal_fileset *wfset);
+
+void
+wal_fileset_unpin(struct wal_fileset *wfset);
+
+/**
+ * wal_fileset_checkpoint() - clone the WAL files of a pinned set
+ * @wfset: WAL fileset
+ * @paths: per media class target directory
+ */
+merr_t
+wal_fileset_checkpoint(struct wal_fileset *wfset, const char *paths[HSE_MCLASS_COUNT]);
+
 merr_t
 wal_file_complete(struct wal_fileset *wfset, struct wal_file *wfile);
 
@@ -7,6 +7,7 @@
 #include <hse/logging/logging.h>
 #include <hse/mpool/mpool.h>
 #include <hse/util/event_counter.h>
+#include <hse/util/mutex.h>
 #include <hse/util/page.h>
 
 #include "wal.h"
@@ -16,7 +17,11 @@
 #define WAL_BUF_SZ (PAGE_SIZE)
 
 struct wal_mdc {
+    struct mutex lock;
+    struct mpool *mp;
     struct mpool_mdc *mp_mdc;
+    uint64_t mdcid1;
+    uint64_t mdcid2;
     char *buf;
 };
 
@@ -166,7 +171,11 @@ wal_mdc_open(
         return merr(ENOMEM);
     }
 
+    mutex_init(&mdc->lock);
+    mdc->mp = mp;
     mdc->mp_mdc = mp_mdc;
+    mdc->mdcid1 = mdcid1;
+    mdc->mdcid2 = mdcid2;
     mdc->buf = (char *)(mdc + 1);
 
     *handle = mdc;
@@ -187,6 +196,7 @@ wal_mdc_close(struct wal_mdc *mdc)
         ev(err);
     }
 
+    mutex_destroy(&mdc->lock);
     free(mdc);
 
     return 0;
@@ -197,15 +207,17 @@ wal_mdc_format(struct wal_mdc *mdc, uint32_t version)
 {
     merr_t err;
 
+    mutex_lock(&mdc->lock);
     err = wal_mdc_version_write(mdc, version, true);
+    mutex_unlock(&mdc->lock);
     if (err)
         return err;
 
     return wal_mdc_close_write(mdc);
 }
 
-merr_t
-wal_mdc_compact(struct wal_mdc *mdc, struct wal *wal)
+static merr_t
+wal_mdc_compact_locked(struct wal_mdc *mdc, struct wal *wal)
 {
     merr_t err;
     bool sync = false;
@@ -233,6 +245,38 @@ wal_mdc_compact(struct wal_mdc *mdc, struct wal *wal)
     return 0;
 }
 
+merr_t
+wal_mdc_compact(struct wal_mdc *mdc, struct wal *wal)
+{
+    merr_t err;
+
+    mutex_lock(&mdc->lock);
+    err = wal_mdc_compact_locked(mdc, wal);
+    mutex_unlock(&mdc->lock);
+
+    return err;
+}
+
+merr_t
+wal_mdc_checkpoint(struct wal_mdc *mdc, const char *paths[HSE_MCLASS_COUNT])
+{
+    merr_t err;
+
+    if (!mdc || !paths)
+        return merr(EINVAL);
+
+    /* The lock keeps the MDC from being appended to or compacted while its
+     * log files are cloned.
+     */
+    mutex_lock(&mdc->lock);
+    err = mpool_mdc_sync(mdc->mp_mdc);
+    if (!err)
+        err = mpool_mdc_checkpoint(mdc->mp, mdc->mdcid1, mdc->mdcid2, paths);
+    mutex_unlock(&mdc->lock);
+
+    return err;
+}
+
 merr_t
 wal_mdc_replay(struct wal_mdc *mdc, struct wal *wal)
 {
@@ -287,11 +331,16 @@ merr_t
 wal_mdc_close_write(struct wal_mdc *mdc)
 {
     struct wal_close_omf comf;
+    merr_t err;
 
     if (!mdc)
         return merr(EINVAL);
 
     wal_mdchdr_pack(WAL_RT_CLOSE, (char *)&comf);
 
-    return mpool_mdc_append(mdc->mp_mdc, &comf, sizeof(comf), true);
+    mutex_lock(&mdc->lock);
+    err = mpool_mdc_append(mdc->mp_mdc, &comf, sizeof(comf), true);
+    mutex_unlock(&mdc->lock);
+
+    return err;
 }
@@ -45,4 +45,7 @@ wal_mdc_replay(struct wal_mdc *mdc, struct wal *wal);
 merr_t
 wal_mdc_close_write(struct wal_mdc *mdc);
 
+merr_t
+wal_mdc_checkpoint(struct wal_mdc *mdc, const char *paths[HSE_MCLASS_COUNT]);
+
 #endif /* WAL_MDC_H */
@@ -46,7 +46,8 @@ wal_rechdr_len(uint32_t version)
     case WAL_VERSION1:
         return sizeof(struct wal_rechdr_omf_v1);
 
-    case WAL_VERSION:
+    case WAL_VERSION2:
+    case WAL_VERSION3:
         return sizeof(struct wal_rechdr_omf);
 
     default:
@@ -93,7 +94,8 @@ wal_reclen(uint32_t version)
     case WAL_VERSION1:
         return sizeof(struct wal_rec_omf_v1);
 
-    case WAL_VERSION:
+    case WAL_VERSION2:
+    case WAL_VERSION3:
         return sizeof(struct wal_rec_omf);
 
     default:
@@ -165,7 +167,8 @@ wal_rec_cksum_valid(const char *inbuf, uint32_t version)
     case WAL_VERSION1:
         return wal_rec_cksum_valid_v1(inbuf);
 
-    case WAL_VERSION:
+    case WAL_VERSION2:
+    case WAL_VERSION3:
         return wal_rec_cksum_valid_latest(inbuf);
 
     default:
@@ -312,7 +315,8 @@ wal_rechdr_unpack(const void *inbuf, uint32_t version, struct wal_rechdr *hdr)
         wal_rechdr_unpack_v1(inbuf, hdr);
         break;
 
-    case WAL_VERSION:
+    case WAL_VERSION2:
+    case WAL_VERSION3:
         wal_rechdr_unpack_latest(inbuf, hdr);
         break;
 
@@ -349,7 +353,11 @@ wal_rec_unpack_v1(const char *inbuf, struct wal_rechdr *hdr, struct wal_rec *rec
 }
 
 static void
-wal_rec_unpack_latest(const char *inbuf, struct wal_rechdr *hdr, struct wal_rec *rec)
+wal_rec_unpack_latest(
+    const char *inbuf,
+    struct wal_rechdr *hdr,
+    uint32_t version,
+    struct wal_rec *rec)
 {
     const struct wal_rec_omf *romf = (const void *)inbuf;
     size_t rlen = wal_reclen(WAL_VERSION);
@@ -373,6 +381,15 @@ wal_rec_unpack_latest(const char *inbuf, struct wal_rechdr *hdr, struct wal_rec
     if (vxlen > 0)
         vdata = PTR_ALIGN((void *)rec->kt.kt_data + klen, kvalign);
     kvs_vtuple_init(&rec->vt, vdata, vxlen);
+
+    /* Expiration times were introduced in WAL_VERSION3.
+     */
+    if (rec->op == WAL_OP_PUT_TTL && version >= WAL_VERSION3) {
+        const void *xdata = PTR_ALIGN((void *)rec->kt.kt_data + klen, kvalign);
+
+        xdata += ALIGN(kvs_vtuple_vlen(&rec->vt), kvalign);
+        rec->vt.vt_expire = omf64_to_cpu(*(const uint64_t *)xdata);
+    }
 }
 
 void
@@ -383,8 +400,9 @@ wal_rec_unpack(const char *inbuf, struct wal_rechdr *hdr, uint32_t version, stru
         wal_rec_unpack_v1(inbuf, hdr, rec);
         break;
 
-    case WAL_VERSION:
-        wal_rec_unpack_latest(inbuf, hdr, rec);
+    case WAL_VERSION2:
+    case WAL_VERSION3:
+        wal_rec_unpack_latest(inbuf, hdr, version, rec);
         break;
 
     default:
@@ -447,7 +465,8 @@ wal_txn_rec_unpack(
         wal_txn_rec_unpack_v1(inbuf, hdr, trec);
         break;
 
-    case WAL_VERSION:
+    case WAL_VERSION2:
+    case WAL_VERSION3:
         wal_txn_rec_unpack_latest(inbuf, hdr, trec);
         break;
 
@@ -463,7 +482,8 @@ wal_txn_reclen(uint32_t version)
     case WAL_VERSION1:
         return sizeof(struct wal_txnrec_omf_v1);
 
-    case WAL_VERSION:
+    case WAL_VERSION2:
+    case WAL_VERSION3:
         return sizeof(struct wal_txnrec_omf);
 
     default:
@@ -548,6 +568,7 @@ static merr_t
 wal_filehdr_unpack_latest(
     const void *inbuf,
     uint32_t magic,
+    uint32_t version,
     bool *close,
     off_t *soff,
     off_t *eoff,
@@ -578,7 +599,7 @@ wal_filehdr_unpack_latest(
         return ((memcmp(fhomf, &ref, sizeof(*fhomf)) == 0) ? merr(ENODATA) : merr(EBADMSG));
     }
 
-    if ((magic != omf_fh_magic(fhomf)) || (WAL_VERSION != omf_fh_version(fhomf)))
+    if ((magic != omf_fh_magic(fhomf)) || (version != omf_fh_version(fhomf)))
         return merr(EBADMSG);
 
     return 0;
@@ -601,8 +622,9 @@ wal_filehdr_unpack(
         err = wal_filehdr_unpack_v1(inbuf, magic, close, soff, eoff, info);
         break;
 
-    case WAL_VERSION:
-        err = wal_filehdr_unpack_latest(inbuf, magic, close, soff, eoff, info);
+    case WAL_VERSION2:
+    case WAL_VERSION3:
+        err = wal_filehdr_unpack_latest(inbuf, magic, version, close, soff, eoff, info);
         break;
 
     default:
@@ -40,6 +40,7 @@ enum wal_op {
     WAL_OP_PUT = 500,
     WAL_OP_DEL = 501,
     WAL_OP_PDEL = 502,
+    WAL_OP_PUT_TTL = 503, /* put whose value is followed by a 64-bit expiration time */
 };
 
 enum wal_flags {
@@ -3,6 +3,8 @@
  * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
  */
 
+#include <sys/sysinfo.h>
+
 #include <rbtree.h>
 
 #include <hse/error/merr.h>
@@ -10,6 +12,7 @@
 #include <hse/ikvdb/ikvdb.h>
 #include <hse/ikvdb/kvdb_modes.h>
 #include <hse/ikvdb/kvdb_rparams.h>
+#include <hse/ikvdb/limits.h>
 #include <hse/logging/logging.h>
 #include <hse/util/bonsai_tree.h>
 #include <hse/util/event_counter.h>
@@ -23,10 +26,18 @@
 #include "wal_omf.h"
 #include "wal_replay.h"
 
+/* clang-format off */
+
+#define WAL_REPLAY_APPLY_WIDTH_MAX  (16)
+#define WAL_REPLAY_APPLY_RECS_MIN   (4096)
+
+/* clang-format on */
+
 struct wal_replay_gen {
     struct mutex rg_lock HSE_ACP_ALIGNED;
     struct rb_root rg_root;
     struct list_head rg_link;
+    uint64_t rg_nrecs;
 
     struct wal_minmax_info rg_info HSE_L1D_ALIGNED;
     uint64_t rg_gen;
@@ -43,6 +54,31 @@ struct wal_replay_work {
     merr_t rw_err;
 };
 
+/**
+ * struct wal_replay_apply - apply worker context for one partition
+ *
+ * @ra_work:  work struct
+ * @ra_rep:   replay handle
+ * @ra_recv:  records of the gen being replayed, in rid order
+ * @ra_partv: partition of each record in ra_recv
+ * @ra_start: index of the first record to consider
+ * @ra_end:   index one past the last record to consider
+ * @ra_part:  partition applied by this worker
+ * @ra_flags: bonsai tree flags for the replayed keys
+ * @ra_err:   first error encountered, if any
+ */
+struct wal_replay_apply {
+    struct work_struct ra_work;
+    struct wal_replay *ra_rep;
+    struct wal_rec **ra_recv;
+    const uint8_t *ra_partv;
+    uint64_t ra_start;
+    uint64_t ra_end;
+    uint32_t ra_part;
+    uint32_t ra_flags;
+    merr_t ra_err;
+};
+
 struct wal_replay {
     struct list_head r_head HSE_ACP_ALIGNED;
     struct kmem_cache *r_cache;
@@ -57,8 +93,10 @@ struct wal_replay {
     atomic_long r_verr;
 
     struct wal *r_wal HSE_L1D_ALIGNED;
+    struct ikvdb *r_ikvdb;
     struct ikvdb_kvs_hdl *r_ikvsh;
     struct workqueue_struct *r_wq;
+    uint32_t r_width;
 
     struct wal_replay_info *r_info;
     struct wal_replay_gen_info *r_ginfo;
@@ -125,6 +163,7 @@ wal_replay_open(struct wal *wal, struct wal_replay_info *rinfo, struct wal_repla
         goto err_exit;
 
     rep->r_wal = wal;
+    rep->r_ikvdb = wal_ikvdb(wal);
     rep->r_info = rinfo;
     INIT_LIST_HEAD(&rep->r_head);
 
@@ -462,6 +501,7 @@ wal_replay_gen_init(struct wal_replay_gen *rgen, struct wal_replay_gen_info *rgi
     INIT_LIST_HEAD(&rgen->rg_link);
     mutex_init(&rgen->rg_lock);
     rgen->rg_root = RB_ROOT;
+    rgen->rg_nrecs = 0;
 
     rgen->rg_gen = rginfo->gen;
     rgen->rg_info = rginfo->info;
@@ -514,66 +554,190 @@ wal_replay_gen_getbyseqno(struct wal_replay *rep, uint64_t seqno)
     return NULL;
 }
 
+static merr_t
+wal_replay_rec_apply(struct wal_replay *rep, struct wal_rec *rec, uint32_t flags)
+{
+    struct ikvdb *ikvdb = rep->r_ikvdb;
+    struct ikvdb_kvs_hdl *ikvsh = rep->r_ikvsh;
+    struct kvs_ktuple *kt = &rec->kt;
+    struct kvs_vtuple *vt = &rec->vt;
+
+    assert(rec->hdr.type == WAL_RT_NONTX || rec->hdr.type == WAL_RT_TX);
+
+    kt->kt_flags = flags;
+
+    switch (rec->op) {
+    case WAL_OP_PUT:
+        return ikvdb_wal_replay_put(ikvdb, ikvsh, rec->cnid, rec->seqno, kt, vt);
+
+    case WAL_OP_PUT_TTL:
+        /* Expiration times were introduced in WAL_VERSION3.
+         */
+        if (wal_version_get(rep->r_wal) < WAL_VERSION3)
+            return merr(EPROTO);
+
+        return ikvdb_wal_replay_put(ikvdb, ikvsh, rec->cnid, rec->seqno, kt, vt);
+
+    case WAL_OP_DEL:
+        return ikvdb_wal_replay_del(ikvdb, ikvsh, rec->cnid, rec->seqno, kt);
+
+    case WAL_OP_PDEL:
+        return ikvdb_wal_replay_prefix_del(ikvdb, ikvsh, rec->cnid, rec->seqno, kt);
+
+    default:
+        break;
+    }
+
+    return merr(EINVAL);
+}
+
+static void
+wal_replay_apply_worker(struct work_struct *work)
+{
+    struct wal_replay_apply *ra;
+    uint64_t i;
+
+    ra = container_of(work, struct wal_replay_apply, ra_work);
+
+    for (i = ra->ra_start; i < ra->ra_end && !ra->ra_err; i++) {
+        if (ra->ra_partv[i] == ra->ra_part)
+            ra->ra_err = wal_replay_rec_apply(ra->ra_rep, ra->ra_recv[i], ra->ra_flags);
+    }
+}
+
+/* Apply records [start, end) of recv, one apply worker per partition.
+ */
+static merr_t
+wal_replay_apply_range(
+    struct wal_replay *rep,
+    struct wal_replay_apply *rav,
+    struct wal_rec **recv,
+    const uint8_t *partv,
+    uint64_t start,
+    uint64_t end,
+    uint32_t flags)
+{
+    merr_t err = 0;
+    uint32_t i;
+
+    for (i = 0; i < rep->r_width; i++) {
+        struct wal_replay_apply *ra = rav + i;
+
+        INIT_WORK(&ra->ra_work, wal_replay_apply_worker);
+        ra->ra_rep = rep;
+        ra->ra_recv = recv;
+        ra->ra_partv = partv;
+        ra->ra_start = start;
+        ra->ra_end = end;
+        ra->ra_part = i;
+        ra->ra_flags = flags;
+        ra->ra_err = 0;
+
+        queue_work(rep->r_wq, &ra->ra_work);
+    }
+
+    flush_workqueue(rep->r_wq);
+
+    for (i = 0; i < rep->r_width; i++) {
+        if (rav[i].ra_err && !err)
+            err = rav[i].ra_err;
+    }
+
+    return err;
+}
+
+/* Replay the records of a gen into c0.
+ *
+ * The records are drained from the gen's rbtree in rid order and partitioned
+ * by the c0kvset each key hashes to, such that all the mutations of a given
+ * key land in the same partition and are applied in seqno order by a single
+ * apply worker.  Since every c0kvset is owned by exactly one partition, the
+ * apply workers never contend on a c0kvset.  Prefix deletes are applied
+ * serially, with all the records that precede them fully applied first.
+ * Small gens are not worth the hand off and are applied serially.
+ */
 merr_t
 wal_replay_gen_impl(struct wal_replay *rep, struct wal_replay_gen *rgen, bool flags)
 {
-    struct rb_root *root = &rgen->rg_root;
+    struct wal_replay_apply *rav = NULL;
+    struct wal_rec **recv;
     struct rb_node *node;
-    struct ikvdb *ikvdb = wal_ikvdb(rep->r_wal);
-    struct ikvdb_kvs_hdl *ikvsh = rep->r_ikvsh;
-    merr_t err;
+    uint8_t *partv;
+    uint64_t nrecs = rgen->rg_nrecs;
+    uint64_t i, start;
+    bool parallel;
+    merr_t err = 0;
 
-    node = rb_first(root);
-    while (node) {
-        struct wal_rec *rec = rb_entry(node, struct wal_rec, node);
-        struct kvs_ktuple *kt = &rec->kt;
-        struct kvs_vtuple *vt = &rec->vt;
+    if (nrecs == 0)
+        return 0;
 
-        node = rb_next(node);
+    recv = malloc(nrecs * (sizeof(*recv) + sizeof(*partv)));
+    if (ev(!recv)) {
+        struct wal_rec *cur, *next;
 
-        assert(rec->hdr.type == WAL_RT_NONTX || rec->hdr.type == WAL_RT_TX);
+        rbtree_postorder_for_each_entry_safe(cur, next, &rgen->rg_root, node)
+            kmem_cache_free(rep->r_cache, cur);
+        rgen->rg_root = RB_ROOT;
 
-        kt->kt_flags = flags;
+        return merr(ENOMEM);
+    }
+    partv = (uint8_t *)(recv + nrecs);
 
-        switch (rec->op) {
-        case WAL_OP_PUT:
-            err = ikvdb_wal_replay_put(ikvdb, ikvsh, rec->cnid, rec->seqno, kt, vt);
-            break;
+    parallel = rep->r_wq && rep->r_width > 1 && nrecs >= WAL_REPLAY_APPLY_RECS_MIN;
+    if (parallel) {
+        rav = calloc(rep->r_width, sizeof(*rav));
+        parallel = !ev(!rav);
+    }
 
-        case WAL_OP_DEL:
-            err = ikvdb_wal_replay_del(ikvdb, ikvsh, rec->cnid, rec->seqno, kt);
-            break;
+    i = 0;
+    for (node = rb_first(&rgen->rg_root); node; node = rb_next(node)) {
+        struct wal_rec *rec = rb_entry(node, struct wal_rec, node);
 
-        case WAL_OP_PDEL:
-            err = ikvdb_wal_replay_prefix_del(ikvdb, ikvsh, rec->cnid, rec->seqno, kt);
-            break;
+        assert(i < nrecs);
+        recv[i] = rec;
+        partv[i] = 0;
 
-        default:
-            err = merr(EINVAL);
-            break;
-        }
+        if (parallel && rec->op != WAL_OP_PDEL) {
+            uint64_t hash = ikvdb_wal_replay_key_hash(rep->r_ikvsh, rec->cnid, &rec->kt);
 
-        if (HSE_UNLIKELY(err)) {
-            struct wal_rec *cur, *next;
+            partv[i] = (hash % HSE_C0_INGEST_WIDTH_MAX) % rep->r_width;
+        }
+        i++;
+    }
+    assert(i == nrecs);
+    rgen->rg_root = RB_ROOT;
 
-            log_crit(
-                "WAL replay: Unrecognized record op %d in gen %lu, failing replay", rec->op,
-                rgen->rg_gen);
+    for (start = 0; start < nrecs && !err;) {
+        uint64_t end = start;
 
-            rbtree_postorder_for_each_entry_safe(cur, next, root, node)
-                kmem_cache_free(rep->r_cache, cur);
+        while (parallel && end < nrecs && recv[end]->op != WAL_OP_PDEL)
+            end++;
 
-            return err;
+        if (end > start) {
+            err = wal_replay_apply_range(rep, rav, recv, partv, start, end, flags);
+            start = end;
+            continue;
         }
 
-        rgen->rg_maxseqno = max_t(uint64_t, rgen->rg_maxseqno, rec->seqno);
+        err = wal_replay_rec_apply(rep, recv[start++], flags);
+    }
+
+    for (i = 0; i < nrecs; i++) {
+        if (!err) {
+            rgen->rg_maxseqno = max_t(uint64_t, rgen->rg_maxseqno, recv[i]->seqno);
+            rgen->rg_krcnt++;
+        }
 
-        rb_erase(&rec->node, root);
-        kmem_cache_free(rep->r_cache, rec);
-        rgen->rg_krcnt++;
+        kmem_cache_free(rep->r_cache, recv[i]);
     }
 
-    return 0;
+    free(rav);
+    free(recv);
+
+    if (err)
+        log_errx("WAL replay: Failed to replay gen %lu, failing replay", err, rgen->rg_gen);
+
+    return err;
 }
 
 /*
@@ -626,6 +790,14 @@ wal_replay_core(struct wal_replay *rep)
      */
     ikvdb_wal_replay_enable(ikvdb);
 
+    /* Records are applied by up to r_width workers, see wal_replay_gen_impl() */
+    rep->r_width = clamp_t(uint32_t, get_nprocs() / 2, 1, WAL_REPLAY_APPLY_WIDTH_MAX);
+    if (rep->r_width > 1) {
+        rep->r_wq = alloc_workqueue("hse_wal_apply", 0, rep->r_width, rep->r_width);
+        if (ev(!rep->r_wq))
+            rep->r_width = 1;
+    }
+
     cur = list_first_entry_or_null(&rep->r_head, typeof(*cur), rg_link);
     if (cur && cur->rg_bytes != 0) {
         /*
@@ -700,6 +872,11 @@ wal_replay_core(struct wal_replay *rep)
 
     ikvdb_wal_replay_disable(ikvdb);
 
+    if (rep->r_wq) {
+        destroy_workqueue(rep->r_wq);
+        rep->r_wq = NULL;
+    }
+
     ikvdb_wal_replay_size_reset(rep->r_ikvsh);
 
     /* Sync a final time after restoring all replay settings */
@@ -708,6 +885,11 @@ wal_replay_core(struct wal_replay *rep)
 errout:
     ikvdb_wal_replay_disable(ikvdb);
 
+    if (rep->r_wq) {
+        destroy_workqueue(rep->r_wq);
+        rep->r_wq = NULL;
+    }
+
     return err;
 }
 
@@ -972,6 +1154,8 @@ wal_replay_worker(struct work_struct *work)
 
         mutex_lock(&trgen->rg_lock);
         err = wal_rec_rb_insert(trgen, rec);
+        if (!err)
+            trgen->rg_nrecs++;
         mutex_unlock(&trgen->rg_lock);
         if (err) {
             rw->rw_err = err;
@@ -1033,6 +1217,7 @@ wal_replay_prepare(struct wal_replay *rep)
 
     flush_workqueue(rep->r_wq);
     destroy_workqueue(rep->r_wq);
+    rep->r_wq = NULL;
 
     for (i = 0; i < rep->r_cnt; i++) {
         if (rw[i].rw_err)
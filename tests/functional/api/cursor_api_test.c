@@ -3,6 +3,7 @@
  * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
  */
 
+#include <hse/experimental.h>
 #include <hse/hse.h>
 
 #include <hse/util/base.h>
@@ -217,6 +218,87 @@ MTF_DEFINE_UTEST(cursor_api_test, create_null_cursor)
     ASSERT_EQ(EINVAL, hse_err_to_errno(err));
 }
 
+MTF_DEFINE_UTEST(cursor_api_test, create_keys_only_and_vlen_only)
+{
+    hse_err_t err;
+    struct hse_kvs_cursor *cursor;
+
+    err = hse_kvs_cursor_create(
+        (struct hse_kvs *)-1, HSE_CURSOR_CREATE_KEYS_ONLY | HSE_CURSOR_CREATE_VLEN_ONLY, NULL,
+        NULL, 0, &cursor);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(cursor_api_test, create_keys_only, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+    struct hse_kvs_cursor *cursor;
+    const void *key, *val;
+    size_t key_len, val_len;
+    char key_buf[8];
+    bool eof;
+
+    /* Move the data into cn, where skipping values saves vblock reads. */
+    err = hse_kvdb_sync(kvdb_handle, 0);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_create(kvs_handle, HSE_CURSOR_CREATE_KEYS_ONLY, NULL, NULL, 0, &cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        err = hse_kvs_cursor_read(cursor, 0, &key, &key_len, &val, &val_len, &eof);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+        ASSERT_FALSE(eof);
+
+        snprintf(key_buf, sizeof(key_buf), KEY_FMT, i);
+
+        ASSERT_EQ(strlen(key_buf), key_len);
+        ASSERT_EQ(0, memcmp(key_buf, key, key_len));
+        ASSERT_EQ(NULL, val);
+        ASSERT_EQ(0, val_len);
+    }
+
+    err = hse_kvs_cursor_read(cursor, 0, &key, &key_len, &val, &val_len, &eof);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(eof);
+
+    err = hse_kvs_cursor_destroy(cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(cursor_api_test, create_vlen_only, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+    struct hse_kvs_cursor *cursor;
+    char key_buf[8], val_buf[8], key_out[8], val_out[8];
+    size_t key_len, val_len;
+    bool eof;
+
+    err = hse_kvs_cursor_create(kvs_handle, HSE_CURSOR_CREATE_VLEN_ONLY, NULL, NULL, 0, &cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        memset(val_out, 0xaa, sizeof(val_out));
+
+        err = hse_kvs_cursor_read_copy(
+            cursor, 0, key_out, sizeof(key_out), &key_len, val_out, sizeof(val_out), &val_len,
+            &eof);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+        ASSERT_FALSE(eof);
+
+        snprintf(key_buf, sizeof(key_buf), KEY_FMT, i);
+        snprintf(val_buf, sizeof(val_buf), VALUE_FMT, i);
+
+        ASSERT_EQ(strlen(key_buf), key_len);
+        ASSERT_EQ(0, memcmp(key_buf, key_out, key_len));
+        ASSERT_EQ(strlen(val_buf), val_len);
+        ASSERT_EQ((char)0xaa, val_out[0]);
+    }
+
+    err = hse_kvs_cursor_destroy(cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+}
+
 MTF_DEFINE_UTEST_PREPOST(
     cursor_api_test,
     create_with_null_txn_on_transactional_kvs,
@@ -1133,6 +1215,259 @@ MTF_DEFINE_UTEST_PREPOST(
     ASSERT_EQ(0, hse_err_to_errno(err));
 }
 
+MTF_DEFINE_UTEST(cursor_api_test, split_create_null_kvs)
+{
+    hse_err_t err;
+    struct hse_kvs_cursor *cursorv[4];
+    unsigned int cursorc = NELEM(cursorv);
+
+    err = hse_kvs_cursor_split_create(NULL, 0, NULL, 0, NULL, 0, &cursorc, cursorv);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(cursor_api_test, split_create_invalid_args, kvs_setup, kvs_teardown)
+{
+    hse_err_t err;
+    struct hse_kvs_cursor *cursorv[4];
+    unsigned int cursorc = NELEM(cursorv);
+
+    err = hse_kvs_cursor_split_create(
+        kvs_handle, HSE_CURSOR_CREATE_REV, NULL, 0, NULL, 0, &cursorc, cursorv);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_split_create(kvs_handle, 0, NULL, 1, NULL, 0, &cursorc, cursorv);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_split_create(kvs_handle, 0, NULL, 0, NULL, 0, NULL, cursorv);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_split_create(kvs_handle, 0, NULL, 0, NULL, 0, &cursorc, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_split_create(
+        kvs_handle, 0, "key3", sizeof("key3") - 1, "key1", sizeof("key1") - 1, &cursorc, cursorv);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    cursorc = 0;
+    err = hse_kvs_cursor_split_create(kvs_handle, 0, NULL, 0, NULL, 0, &cursorc, cursorv);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(cursor_api_test, split_create_success, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+    struct hse_kvs_cursor *cursorv[4];
+    unsigned int cursorc = NELEM(cursorv);
+    const void *key, *val;
+    size_t key_len, val_len;
+    char key_buf[8], val_buf[8];
+    int i = 1;
+    bool eof;
+
+    err = hse_kvdb_sync(kvdb_handle, 0);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_split_create(
+        kvs_handle, 0, "key1", sizeof("key1") - 1, "key3", sizeof("key3") - 1, &cursorc, cursorv);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_GE(cursorc, 1);
+    ASSERT_LE(cursorc, NELEM(cursorv));
+
+    /* Reading the cursors one after the other yields each key in the
+     * range exactly once and in order.
+     */
+    for (unsigned int c = 0; c < cursorc; c++) {
+        while (true) {
+            err = hse_kvs_cursor_read(cursorv[c], 0, &key, &key_len, &val, &val_len, &eof);
+            ASSERT_EQ(0, hse_err_to_errno(err));
+            if (eof)
+                break;
+
+            snprintf(key_buf, sizeof(key_buf), KEY_FMT, i);
+            snprintf(val_buf, sizeof(val_buf), VALUE_FMT, i);
+
+            ASSERT_EQ(strlen(key_buf), key_len);
+            ASSERT_EQ(0, memcmp(key, key_buf, key_len));
+            ASSERT_EQ(0, memcmp(val, val_buf, val_len));
+            i++;
+        }
+
+        err = hse_kvs_cursor_destroy(cursorv[c]);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+    }
+
+    ASSERT_EQ(4, i);
+}
+
+MTF_DEFINE_UTEST(cursor_api_test, read_batch_null_cursor)
+{
+    hse_err_t err;
+    struct hse_kvs_cursor_kv kvv[4];
+    size_t kvc = NELEM(kvv);
+    char buf[64];
+    bool eof;
+
+    err = hse_kvs_cursor_read_batch(NULL, 0, buf, sizeof(buf), kvv, &kvc, &eof);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(cursor_api_test, read_batch_success, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+    struct hse_kvs_cursor *cursor;
+    struct hse_kvs_cursor_kv kvv[2];
+    size_t kvc;
+    char buf[64], key_buf[8], val_buf[8];
+    int i = 0;
+    bool eof = false;
+
+    err = hse_kvs_cursor_create(kvs_handle, 0, NULL, NULL, 0, &cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    while (!eof) {
+        kvc = NELEM(kvv);
+        err = hse_kvs_cursor_read_batch(cursor, 0, buf, sizeof(buf), kvv, &kvc, &eof);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+        ASSERT_LE(kvc, NELEM(kvv));
+
+        if (!eof)
+            ASSERT_EQ(NELEM(kvv), kvc);
+
+        for (size_t j = 0; j < kvc; j++, i++) {
+            snprintf(key_buf, sizeof(key_buf), KEY_FMT, i);
+            snprintf(val_buf, sizeof(val_buf), VALUE_FMT, i);
+
+            ASSERT_EQ(strlen(key_buf), kvv[j].key_len);
+            ASSERT_EQ(0, memcmp(kvv[j].key, key_buf, kvv[j].key_len));
+            ASSERT_EQ(strlen(val_buf), kvv[j].val_len);
+            ASSERT_EQ(0, memcmp(kvv[j].val, val_buf, kvv[j].val_len));
+        }
+    }
+
+    ASSERT_EQ(NUM_ENTRIES, i);
+
+    err = hse_kvs_cursor_destroy(cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(cursor_api_test, read_batch_small_buffer, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+    struct hse_kvs_cursor *cursor;
+    struct hse_kvs_cursor_kv kvv[4];
+    size_t kvc = NELEM(kvv);
+    const void *key, *val;
+    size_t key_len, val_len;
+    char buf[16];
+    bool eof;
+
+    err = hse_kvs_cursor_create(kvs_handle, 0, NULL, NULL, 0, &cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* "key0" + "value0" fits, "key1" + "value1" does not. */
+    err = hse_kvs_cursor_read_batch(cursor, 0, buf, sizeof(buf), kvv, &kvc, &eof);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(eof);
+    ASSERT_EQ(1, kvc);
+    ASSERT_EQ(0, memcmp(kvv[0].key, "key0", kvv[0].key_len));
+
+    kvc = NELEM(kvv);
+    err = hse_kvs_cursor_read_batch(cursor, 0, buf, 4, kvv, &kvc, &eof);
+    ASSERT_EQ(EMSGSIZE, hse_err_to_errno(err));
+
+    /* The pair that did not fit is returned by the next read. */
+    err = hse_kvs_cursor_read(cursor, 0, &key, &key_len, &val, &val_len, &eof);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(eof);
+    ASSERT_EQ(4, key_len);
+    ASSERT_EQ(0, memcmp(key, "key1", key_len));
+
+    err = hse_kvs_cursor_destroy(cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(cursor_api_test, filter_set_null_cursor)
+{
+    hse_err_t err;
+
+    err = hse_kvs_cursor_filter_set(NULL, 0, NULL, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+static bool
+filter_even(void *arg, const void *key, size_t key_len)
+{
+    unsigned int *calls = arg;
+
+    ++*calls;
+
+    return ((const char *)key)[key_len - 1] % 2 == 0;
+}
+
+MTF_DEFINE_UTEST_PREPOST(cursor_api_test, filter_set_success, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+    struct hse_kvs_cursor *cursor;
+    const void *key, *val;
+    size_t key_len, val_len;
+    unsigned int calls = 0;
+    char key_buf[8];
+    bool eof;
+
+    err = hse_kvs_cursor_create(kvs_handle, 0, NULL, NULL, 0, &cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_filter_set(cursor, 1, filter_even, &calls);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_filter_set(cursor, 0, filter_even, &calls);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < NUM_ENTRIES; i += 2) {
+            snprintf(key_buf, sizeof(key_buf), KEY_FMT, i);
+
+            err = hse_kvs_cursor_read(cursor, 0, &key, &key_len, &val, &val_len, &eof);
+            ASSERT_EQ(0, hse_err_to_errno(err));
+            ASSERT_FALSE(eof);
+            ASSERT_EQ(strlen(key_buf), key_len);
+            ASSERT_EQ(0, memcmp(key, key_buf, key_len));
+        }
+
+        err = hse_kvs_cursor_read(cursor, 0, &key, &key_len, &val, &val_len, &eof);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+        ASSERT_TRUE(eof);
+
+        /* Scan again with the data moved out of c0. */
+        err = hse_kvdb_sync(kvdb_handle, 0);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        err = hse_kvs_cursor_update_view(cursor, 0);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        err = hse_kvs_cursor_seek(cursor, 0, NULL, 0, NULL, NULL);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+    }
+
+    ASSERT_GE(calls, NUM_ENTRIES);
+
+    /* Clearing the filter takes effect from the current position. */
+    err = hse_kvs_cursor_read(cursor, 0, &key, &key_len, &val, &val_len, &eof);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_EQ(0, memcmp(key, "key0", key_len));
+
+    err = hse_kvs_cursor_filter_set(cursor, 0, NULL, NULL);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_read(cursor, 0, &key, &key_len, &val, &val_len, &eof);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(eof);
+    ASSERT_EQ(0, memcmp(key, "key1", key_len));
+
+    err = hse_kvs_cursor_destroy(cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+}
+
 MTF_DEFINE_UTEST_PREPOST(cursor_api_test, update_view_null_cursor, kvs_setup, kvs_teardown)
 {
     hse_err_t err;
@@ -4,6 +4,12 @@
  */
 
 #include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <sys/stat.h>
 
@@ -47,6 +53,247 @@ MTF_DEFINE_UTEST(kvdb_api_test, close_null_kvdb)
     ASSERT_EQ(EINVAL, hse_err_to_errno(err));
 }
 
+MTF_DEFINE_UTEST(kvdb_api_test, checkpoint_null_kvdb)
+{
+    hse_err_t err;
+
+    err = hse_kvdb_checkpoint(NULL, "/tmp");
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvdb_api_test, checkpoint_null_dest)
+{
+    hse_err_t err;
+
+    err = hse_kvdb_checkpoint(kvdb_handle, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvdb_api_test, checkpoint_success)
+{
+    char dest[PATH_MAX];
+    struct hse_kvdb *ckpt;
+    struct hse_kvs *kvs;
+    char vbuf[16];
+    size_t vlen;
+    hse_err_t err;
+    bool found;
+    int n;
+
+    n = snprintf(dest, sizeof(dest), "%s-ckpt", mtf_kvdb_home);
+    ASSERT_LT(n, sizeof(dest));
+    ASSERT_EQ(0, mkdir(dest, S_IRWXU));
+
+    err = hse_kvdb_kvs_create(kvdb_handle, "kvs", 0, NULL);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_kvs_open(kvdb_handle, "kvs", 0, NULL, &kvs);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_put(kvs, 0, NULL, "key", 3, "value", 5);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_checkpoint(kvdb_handle, dest);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* Mutations after the checkpoint must not show up in it */
+    err = hse_kvs_put(kvs, 0, NULL, "key", 3, "newer", 5);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* A directory that already holds a KVDB is rejected */
+    err = hse_kvdb_checkpoint(kvdb_handle, dest);
+    ASSERT_EQ(EEXIST, hse_err_to_errno(err));
+
+    err = hse_kvdb_kvs_close(kvs);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_kvs_drop(kvdb_handle, "kvs");
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_open(dest, 0, NULL, &ckpt);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_kvs_open(ckpt, "kvs", 0, NULL, &kvs);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs, 0, NULL, "key", 3, &found, vbuf, sizeof(vbuf), &vlen);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(5, vlen);
+    ASSERT_EQ(0, memcmp(vbuf, "value", vlen));
+
+    err = hse_kvdb_kvs_close(kvs);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_close(ckpt);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_drop(dest);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    ASSERT_EQ(0, rmdir(dest));
+}
+
+#define CKPT_THREADS    2
+#define CKPT_PER_THREAD 3
+
+struct ckpt_ctx {
+    struct hse_kvs *kvs;
+    atomic_uint acked;
+    atomic_bool stop;
+    atomic_int err;
+    unsigned int startv[CKPT_THREADS * CKPT_PER_THREAD];
+};
+
+struct ckpt_arg {
+    struct ckpt_ctx *ctx;
+    int tid;
+};
+
+static void
+ckpt_dest(char *dest, size_t destsz, int idx)
+{
+    snprintf(dest, destsz, "%s-ckpt%d", mtf_kvdb_home, idx);
+}
+
+static void *
+ckpt_put_thread(void *arg)
+{
+    struct ckpt_ctx *ctx = arg;
+    char key[16];
+    unsigned int i;
+    hse_err_t err;
+
+    for (i = 0; !atomic_load(&ctx->stop); i++) {
+        snprintf(key, sizeof(key), "k%08u", i);
+
+        err = hse_kvs_put(ctx->kvs, 0, NULL, key, strlen(key), key, strlen(key));
+        if (err) {
+            atomic_store(&ctx->err, hse_err_to_errno(err));
+            break;
+        }
+
+        atomic_store(&ctx->acked, i + 1);
+    }
+
+    return NULL;
+}
+
+/* Every checkpoint syncs c0, so the checkpoints of one thread ingest and
+ * reclaim WAL files while those of the other thread are being cloned.
+ */
+static void *
+ckpt_thread(void *arg)
+{
+    struct ckpt_arg *ca = arg;
+    struct ckpt_ctx *ctx = ca->ctx;
+    char dest[PATH_MAX];
+    hse_err_t err;
+
+    for (int i = 0; i < CKPT_PER_THREAD; i++) {
+        int idx = ca->tid * CKPT_PER_THREAD + i;
+
+        ckpt_dest(dest, sizeof(dest), idx);
+
+        ctx->startv[idx] = atomic_load(&ctx->acked);
+
+        err = hse_kvdb_checkpoint(kvdb_handle, dest);
+        if (err) {
+            atomic_store(&ctx->err, hse_err_to_errno(err));
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+MTF_DEFINE_UTEST(kvdb_api_test, checkpoint_concurrent)
+{
+    struct ckpt_arg argv[CKPT_THREADS];
+    pthread_t put_tid, tidv[CKPT_THREADS];
+    struct ckpt_ctx ctx = { 0 };
+    char dest[PATH_MAX];
+    struct hse_kvdb *ckpt;
+    struct hse_kvs *kvs;
+    char key[16], vbuf[16];
+    size_t vlen;
+    hse_err_t err;
+    bool found;
+    int i, rc;
+
+    for (i = 0; i < CKPT_THREADS * CKPT_PER_THREAD; i++) {
+        ckpt_dest(dest, sizeof(dest), i);
+        ASSERT_EQ(0, mkdir(dest, S_IRWXU));
+    }
+
+    err = hse_kvdb_kvs_create(kvdb_handle, "kvs_ckpt", 0, NULL);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_kvs_open(kvdb_handle, "kvs_ckpt", 0, NULL, &ctx.kvs);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    rc = pthread_create(&put_tid, NULL, ckpt_put_thread, &ctx);
+    ASSERT_EQ(0, rc);
+
+    while (atomic_load(&ctx.acked) < 1000)
+        usleep(1000);
+
+    for (i = 0; i < CKPT_THREADS; i++) {
+        argv[i].ctx = &ctx;
+        argv[i].tid = i;
+
+        rc = pthread_create(&tidv[i], NULL, ckpt_thread, &argv[i]);
+        ASSERT_EQ(0, rc);
+    }
+
+    for (i = 0; i < CKPT_THREADS; i++)
+        pthread_join(tidv[i], NULL);
+
+    atomic_store(&ctx.stop, true);
+    pthread_join(put_tid, NULL);
+
+    ASSERT_EQ(0, atomic_load(&ctx.err));
+
+    err = hse_kvdb_kvs_close(ctx.kvs);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_kvs_drop(kvdb_handle, "kvs_ckpt");
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* Every put acknowledged before a checkpoint started must be in it.
+     */
+    for (i = 0; i < CKPT_THREADS * CKPT_PER_THREAD; i++) {
+        ckpt_dest(dest, sizeof(dest), i);
+
+        err = hse_kvdb_open(dest, 0, NULL, &ckpt);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        err = hse_kvdb_kvs_open(ckpt, "kvs_ckpt", 0, NULL, &kvs);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        for (unsigned int k = 0; k < ctx.startv[i]; k++) {
+            snprintf(key, sizeof(key), "k%08u", k);
+
+            err = hse_kvs_get(kvs, 0, NULL, key, strlen(key), &found, vbuf, sizeof(vbuf), &vlen);
+            ASSERT_EQ(0, hse_err_to_errno(err));
+            ASSERT_TRUE(found);
+            ASSERT_EQ(strlen(key), vlen);
+            ASSERT_EQ(0, memcmp(vbuf, key, vlen));
+        }
+
+        err = hse_kvdb_kvs_close(kvs);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        err = hse_kvdb_close(ckpt);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        err = hse_kvdb_drop(dest);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        ASSERT_EQ(0, rmdir(dest));
+    }
+}
+
 MTF_DEFINE_UTEST(kvdb_api_test, compact_null_kvdb)
 {
     hse_err_t err;
@@ -439,6 +686,103 @@ MTF_DEFINE_UTEST(kvdb_api_test, param_success)
     ASSERT_EQ(6, needed_sz);
 }
 
+MTF_DEFINE_UTEST(kvdb_api_test, snapshot_create_null_kvdb)
+{
+    struct hse_kvdb_snapshot *snap;
+    hse_err_t err;
+
+    err = hse_kvdb_snapshot_create(NULL, &snap);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvdb_api_test, snapshot_create_null_snap)
+{
+    hse_err_t err;
+
+    err = hse_kvdb_snapshot_create(kvdb_handle, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvdb_api_test, snapshot_success)
+{
+    struct hse_kvdb_snapshot *snap;
+    struct hse_kvs_cursor *cur;
+    struct hse_kvs *kvs;
+    const void *key, *val;
+    size_t klen, vlen;
+    char vbuf[16];
+    hse_err_t err;
+    bool found, eof;
+
+    err = hse_kvdb_kvs_create(kvdb_handle, "kvs", 0, NULL);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_kvs_open(kvdb_handle, "kvs", 0, NULL, &kvs);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_put(kvs, 0, NULL, "key", 3, "value", 5);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_snapshot_create(kvdb_handle, &snap);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_snapshot_get(kvs, 0, NULL, "key", 3, &found, vbuf, sizeof(vbuf), &vlen);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    /* Mutations after the snapshot must not show up in it */
+    err = hse_kvs_put(kvs, 0, NULL, "key", 3, "newer", 5);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_put(kvs, 0, NULL, "key2", 4, "value2", 6);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_snapshot_get(kvs, 0, snap, "key", 3, &found, vbuf, sizeof(vbuf), &vlen);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(5, vlen);
+    ASSERT_EQ(0, memcmp(vbuf, "value", vlen));
+
+    err = hse_kvs_snapshot_get(kvs, 0, snap, "key2", 4, &found, vbuf, sizeof(vbuf), &vlen);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(found);
+
+    err = hse_kvs_get(kvs, 0, NULL, "key", 3, &found, vbuf, sizeof(vbuf), &vlen);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(0, memcmp(vbuf, "newer", vlen));
+
+    err = hse_kvs_snapshot_cursor_create(kvs, 0, snap, NULL, 0, &cur);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* The snapshot's view outlives the snapshot itself */
+    err = hse_kvdb_snapshot_release(kvdb_handle, snap);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_update_view(cur, 0);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_read(cur, 0, &key, &klen, &val, &vlen, &eof);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(eof);
+    ASSERT_EQ(3, klen);
+    ASSERT_EQ(0, memcmp(key, "key", klen));
+    ASSERT_EQ(5, vlen);
+    ASSERT_EQ(0, memcmp(val, "value", vlen));
+
+    err = hse_kvs_cursor_read(cur, 0, &key, &klen, &val, &vlen, &eof);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(eof);
+
+    err = hse_kvs_cursor_destroy(cur);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_kvs_close(kvs);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_kvs_drop(kvdb_handle, "kvs");
+    ASSERT_EQ(0, hse_err_to_errno(err));
+}
+
 MTF_DEFINE_UTEST(kvdb_api_test, storage_add_null_home)
 {
     hse_err_t err;
@@ -4,6 +4,10 @@
  */
 
 #include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <hse/experimental.h>
 #include <hse/hse.h>
@@ -500,6 +504,192 @@ MTF_DEFINE_UTEST_PREPOST(
     ASSERT_EQ(0, memcmp(valbuf, "value0", val_len));
 }
 
+struct get_threaded_ctx {
+    pthread_mutex_t lock;
+    pthread_cond_t cv;
+    int pending;
+    int found;
+    hse_err_t err;
+};
+
+static void
+get_threaded_cb(void *arg, hse_err_t err, bool found, size_t val_len)
+{
+    struct get_threaded_ctx *ctx = arg;
+
+    pthread_mutex_lock(&ctx->lock);
+    if (err && !ctx->err)
+        ctx->err = err;
+    if (found && val_len == sizeof("value0") - 1)
+        ctx->found++;
+    if (--ctx->pending == 0)
+        pthread_cond_signal(&ctx->cv);
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_threaded_null_kvs)
+{
+    hse_err_t err;
+
+    err = hse_kvs_get_threaded(NULL, 0, "key0", 4, NULL, 0, get_threaded_cb, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_threaded_invalid_flags)
+{
+    hse_err_t err;
+
+    err = hse_kvs_get_threaded((struct hse_kvs *)-1, ~0, "key0", 4, NULL, 0, get_threaded_cb, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_threaded_null_cb)
+{
+    hse_err_t err;
+
+    err = hse_kvs_get_threaded((struct hse_kvs *)-1, 0, "key0", 4, NULL, 0, NULL, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_threaded_key_len_too_long)
+{
+    hse_err_t err;
+
+    err = hse_kvs_get_threaded(
+        (struct hse_kvs *)-1, 0, (void *)-1, HSE_KVS_KEY_LEN_MAX + 1, NULL, 0, get_threaded_cb, NULL);
+    ASSERT_EQ(ENAMETOOLONG, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, get_threaded_success, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+    char valbufv[NUM_ENTRIES + 1][8];
+    struct get_threaded_ctx ctx = {
+        .lock = PTHREAD_MUTEX_INITIALIZER,
+        .cv = PTHREAD_COND_INITIALIZER,
+    };
+
+    err = hse_kvdb_sync(kvdb_handle, 0);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* One more key than was loaded, the last get must not find anything. */
+    ctx.pending = NUM_ENTRIES + 1;
+
+    for (int i = 0; i < NUM_ENTRIES + 1; i++) {
+        char key_buf[8];
+        int key_len;
+
+        key_len = snprintf(key_buf, sizeof(key_buf), KEY_FMT, i);
+
+        err = hse_kvs_get_threaded(
+            kvs_handle, 0, key_buf, key_len, valbufv[i], sizeof(valbufv[i]), get_threaded_cb, &ctx);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+    }
+
+    pthread_mutex_lock(&ctx.lock);
+    while (ctx.pending > 0)
+        pthread_cond_wait(&ctx.cv, &ctx.lock);
+    pthread_mutex_unlock(&ctx.lock);
+
+    ASSERT_EQ(0, hse_err_to_errno(ctx.err));
+    ASSERT_EQ(NUM_ENTRIES, ctx.found);
+
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        char expected[8];
+        int len;
+
+        len = snprintf(expected, sizeof(expected), VALUE_FMT, i);
+        ASSERT_EQ(0, memcmp(valbufv[i], expected, len));
+    }
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_multi_null_kvs)
+{
+    hse_err_t err;
+    struct hse_kvs_get_desc desc = { .key = "key0", .key_len = 4 };
+
+    err = hse_kvs_get_multi(NULL, 0, NULL, &desc, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_multi_invalid_flags)
+{
+    hse_err_t err;
+    struct hse_kvs_get_desc desc = { .key = "key0", .key_len = 4 };
+
+    err = hse_kvs_get_multi((struct hse_kvs *)-1, ~0, NULL, &desc, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_multi_null_descv)
+{
+    hse_err_t err;
+
+    err = hse_kvs_get_multi((struct hse_kvs *)-1, 0, NULL, NULL, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_multi_null_key)
+{
+    hse_err_t err;
+    struct hse_kvs_get_desc descv[] = {
+        { .key = "key0", .key_len = 4 },
+        { .key = NULL, .key_len = 4 },
+    };
+
+    err = hse_kvs_get_multi((struct hse_kvs *)-1, 0, NULL, descv, NELEM(descv));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, get_multi_key_len_too_long)
+{
+    hse_err_t err;
+    struct hse_kvs_get_desc desc = { .key = (void *)-1, .key_len = HSE_KVS_KEY_LEN_MAX + 1 };
+
+    err = hse_kvs_get_multi((struct hse_kvs *)-1, 0, NULL, &desc, 1);
+    ASSERT_EQ(ENAMETOOLONG, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, get_multi_success, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+    char valbufv[NUM_ENTRIES + 1][8];
+    char keybufv[NUM_ENTRIES + 1][8];
+    struct hse_kvs_get_desc descv[NUM_ENTRIES + 1];
+
+    /* Look the keys up in reverse order, plus one key which does not exist. */
+    for (int i = 0; i < NELEM(descv); i++) {
+        int n = NUM_ENTRIES - i;
+
+        descv[i].key = keybufv[i];
+        descv[i].key_len = snprintf(keybufv[i], sizeof(keybufv[i]), KEY_FMT, n);
+        descv[i].valbuf = valbufv[i];
+        descv[i].valbuf_sz = sizeof(valbufv[i]);
+    }
+
+    for (int pass = 0; pass < 2; pass++) {
+        err = hse_kvs_get_multi(kvs_handle, 0, NULL, descv, NELEM(descv));
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        ASSERT_FALSE(descv[0].found);
+
+        for (int i = 1; i < NELEM(descv); i++) {
+            char expected[8];
+            int len;
+
+            len = snprintf(expected, sizeof(expected), VALUE_FMT, NUM_ENTRIES - i);
+
+            ASSERT_TRUE(descv[i].found);
+            ASSERT_EQ(len, descv[i].val_len);
+            ASSERT_EQ(0, memcmp(valbufv[i], expected, len));
+        }
+
+        /* Second pass reads the keys back after they have been ingested. */
+        err = hse_kvdb_sync(kvdb_handle, 0);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+    }
+}
+
 MTF_DEFINE_UTEST(kvs_api_test, name_null_kvs)
 {
     const char *name;
@@ -680,6 +870,793 @@ MTF_DEFINE_UTEST_PREPOST(
     hse_kvdb_txn_free(kvdb_handle, txn);
 }
 
+MTF_DEFINE_UTEST(kvs_api_test, write_batch_null_kvs)
+{
+    struct hse_kvs_batch_op op = { HSE_KVS_BATCH_PUT, "key0", 4, "value0", 6 };
+    hse_err_t err;
+
+    err = hse_kvs_write_batch(NULL, 0, &op, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, write_batch_invalid_flags)
+{
+    struct hse_kvs_batch_op op = { HSE_KVS_BATCH_PUT, "key0", 4, "value0", 6 };
+    hse_err_t err;
+
+    err = hse_kvs_write_batch((struct hse_kvs *)-1, ~0, &op, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_write_batch((struct hse_kvs *)-1, HSE_KVS_PUT_VCOMP_MASK, &op, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, write_batch_null_opv)
+{
+    hse_err_t err;
+
+    err = hse_kvs_write_batch((struct hse_kvs *)-1, 0, NULL, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_write_batch((struct hse_kvs *)-1, 0, NULL, 0);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, write_batch_invalid_op)
+{
+    struct hse_kvs_batch_op op = { HSE_KVS_BATCH_PUT, NULL, 4, "value0", 6 };
+    hse_err_t err;
+
+    err = hse_kvs_write_batch((struct hse_kvs *)-1, 0, &op, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    op.key = "key0";
+    op.val = NULL;
+    err = hse_kvs_write_batch((struct hse_kvs *)-1, 0, &op, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    op.type = HSE_KVS_BATCH_DELETE + 1;
+    op.val = "value0";
+    err = hse_kvs_write_batch((struct hse_kvs *)-1, 0, &op, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, write_batch_key_len)
+{
+    struct hse_kvs_batch_op op = { HSE_KVS_BATCH_DELETE, "key0", HSE_KVS_KEY_LEN_MAX + 1 };
+    hse_err_t err;
+
+    err = hse_kvs_write_batch((struct hse_kvs *)-1, 0, &op, 1);
+    ASSERT_EQ(ENAMETOOLONG, hse_err_to_errno(err));
+
+    op.key_len = 0;
+    err = hse_kvs_write_batch((struct hse_kvs *)-1, 0, &op, 1);
+    ASSERT_EQ(ENOENT, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, write_batch_val_len_too_long)
+{
+    struct hse_kvs_batch_op op = {
+        HSE_KVS_BATCH_PUT, "key0", 4, (void *)-1, HSE_KVS_VALUE_LEN_MAX + 1
+    };
+    hse_err_t err;
+
+    err = hse_kvs_write_batch((struct hse_kvs *)-1, 0, &op, 1);
+    ASSERT_EQ(EMSGSIZE, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, write_batch_success, kvs_setup_with_data, kvs_teardown)
+{
+    struct hse_kvs_batch_op opv[] = {
+        { HSE_KVS_BATCH_DELETE, "key0", 4 },
+        { HSE_KVS_BATCH_PUT, "key1", 4, "batch1", 6 },
+        { HSE_KVS_BATCH_PUT, "key9", 4, "batch9", 6 },
+        { HSE_KVS_BATCH_PUT, "key2", 4, "first", 5 },
+        { HSE_KVS_BATCH_PUT, "key2", 4, "second", 6 },
+        { HSE_KVS_BATCH_PUT, "key3", 4, "batch3", 6 },
+        { HSE_KVS_BATCH_DELETE, "key3", 4 },
+    };
+    char val_buf[16];
+    size_t val_len;
+    hse_err_t err;
+    bool found;
+
+    err = hse_kvs_write_batch(kvs_handle, 0, opv, NELEM(opv));
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "key0", 4, &found, NULL, 0, &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(found);
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "key1", 4, &found, val_buf, sizeof(val_buf), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(6, val_len);
+    ASSERT_EQ(0, memcmp(val_buf, "batch1", val_len));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "key9", 4, &found, val_buf, sizeof(val_buf), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(0, memcmp(val_buf, "batch9", val_len));
+
+    /* The last op on a key wins. */
+    err = hse_kvs_get(kvs_handle, 0, NULL, "key2", 4, &found, val_buf, sizeof(val_buf), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(6, val_len);
+    ASSERT_EQ(0, memcmp(val_buf, "second", val_len));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "key3", 4, &found, NULL, 0, &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(found);
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "key4", 4, &found, NULL, 0, &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+}
+
+MTF_DEFINE_UTEST_PREPOST(
+    kvs_api_test,
+    write_batch_transactional,
+    transactional_kvs_setup,
+    kvs_teardown)
+{
+    struct hse_kvs_batch_op op = { HSE_KVS_BATCH_PUT, "key0", 4, "value0", 6 };
+    hse_err_t err;
+
+    err = hse_kvs_write_batch(kvs_handle, 0, &op, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+static int
+merge_add(
+    void *arg,
+    const void *key,
+    size_t key_len,
+    const void *base,
+    size_t base_len,
+    const void *operand,
+    size_t operand_len,
+    void *valbuf,
+    size_t valbuf_sz,
+    size_t *val_len)
+{
+    uint64_t sum = 0, delta;
+
+    if (operand_len != sizeof(delta) || (base && base_len != sizeof(sum)))
+        return EINVAL;
+
+    if (base)
+        memcpy(&sum, base, sizeof(sum));
+    memcpy(&delta, operand, sizeof(delta));
+
+    sum += delta;
+    memcpy(valbuf, &sum, sizeof(sum));
+    *val_len = sizeof(sum);
+
+    return 0;
+}
+
+/* Appends the operand to the value. */
+static int
+merge_append(
+    void *arg,
+    const void *key,
+    size_t key_len,
+    const void *base,
+    size_t base_len,
+    const void *operand,
+    size_t operand_len,
+    void *valbuf,
+    size_t valbuf_sz,
+    size_t *val_len)
+{
+    *val_len = base_len + operand_len;
+    if (*val_len > valbuf_sz)
+        return 0;
+
+    if (base)
+        memcpy(valbuf, base, base_len);
+    memcpy((char *)valbuf + base_len, operand, operand_len);
+
+    return 0;
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, merge_register_null)
+{
+    hse_err_t err;
+
+    err = hse_kvs_merge_register(NULL, merge_add, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge_register((struct hse_kvs *)-1, NULL, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, merge_invalid_args)
+{
+    uint64_t delta = 1;
+    hse_err_t err;
+
+    err = hse_kvs_merge(NULL, 0, "key0", 4, &delta, sizeof(delta));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, ~0, "key0", 4, &delta, sizeof(delta));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, 0, NULL, 4, &delta, sizeof(delta));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, 0, "key0", 4, NULL, sizeof(delta));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, 0, "key0", HSE_KVS_KEY_LEN_MAX + 1, &delta, 8);
+    ASSERT_EQ(ENAMETOOLONG, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, 0, "key0", 0, &delta, sizeof(delta));
+    ASSERT_EQ(ENOENT, hse_err_to_errno(err));
+
+    err = hse_kvs_merge((struct hse_kvs *)-1, 0, "key0", 4, &delta, HSE_KVS_VALUE_LEN_MAX + 1);
+    ASSERT_EQ(EMSGSIZE, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, merge_not_registered, kvs_setup_with_data, kvs_teardown)
+{
+    uint64_t delta = 1;
+    hse_err_t err;
+
+    err = hse_kvs_merge(kvs_handle, 0, "ctr", 3, &delta, sizeof(delta));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, merge_success, kvs_setup_with_data, kvs_teardown)
+{
+    uint64_t delta, sum;
+    size_t val_len;
+    hse_err_t err;
+    bool found;
+
+    err = hse_kvs_merge_register(kvs_handle, merge_add, NULL);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    for (delta = 1; delta <= 100; delta++) {
+        err = hse_kvs_merge(kvs_handle, 0, "ctr", 3, &delta, sizeof(delta));
+        ASSERT_EQ(0, hse_err_to_errno(err));
+    }
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "ctr", 3, &found, &sum, sizeof(sum), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(sizeof(sum), val_len);
+    ASSERT_EQ(5050, sum);
+
+    /* A delete resets the counter. */
+    err = hse_kvs_delete(kvs_handle, 0, NULL, "ctr", 3);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    delta = 7;
+    err = hse_kvs_merge(kvs_handle, 0, "ctr", 3, &delta, sizeof(delta));
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "ctr", 3, &found, &sum, sizeof(sum), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(7, sum);
+
+    /* Errors from the merge operator fail the merge and leave the value as is. */
+    err = hse_kvs_merge(kvs_handle, 0, "ctr", 3, &delta, 1);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "ctr", 3, &found, &sum, sizeof(sum), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(7, sum);
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, merge_register_twice, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+
+    err = hse_kvs_merge_register(kvs_handle, merge_add, NULL);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_merge_register(kvs_handle, merge_append, NULL);
+    ASSERT_EQ(EEXIST, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, merge_large, kvs_setup_with_data, kvs_teardown)
+{
+    const size_t oplen = 3000, opc = 100;
+    size_t val_len;
+    char *op, *val;
+    hse_err_t err;
+    bool found;
+
+    op = malloc(oplen);
+    val = malloc(oplen * opc);
+    ASSERT_NE(NULL, op);
+    ASSERT_NE(NULL, val);
+
+    err = hse_kvs_merge_register(kvs_handle, merge_append, NULL);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* The value outgrows the merge buffers several times over, and is read
+     * back from media after each sync.
+     */
+    for (size_t i = 0; i < opc; i++) {
+        memset(op, 'a' + i % 26, oplen);
+
+        err = hse_kvs_merge(kvs_handle, 0, "log", 3, op, oplen);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+
+        if (i % 25 == 24) {
+            err = hse_kvdb_sync(kvdb_handle, 0);
+            ASSERT_EQ(0, hse_err_to_errno(err));
+        }
+    }
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "log", 3, &found, val, oplen * opc, &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(oplen * opc, val_len);
+
+    for (size_t i = 0; i < opc; i++) {
+        memset(op, 'a' + i % 26, oplen);
+        ASSERT_EQ(0, memcmp(val + i * oplen, op, oplen));
+    }
+
+    free(val);
+    free(op);
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, merge_transactional, transactional_kvs_setup, kvs_teardown)
+{
+    uint64_t delta = 1;
+    hse_err_t err;
+
+    err = hse_kvs_merge_register(kvs_handle, merge_add, NULL);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_merge(kvs_handle, 0, "ctr", 3, &delta, sizeof(delta));
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, put_ttl_invalid_args)
+{
+    hse_err_t err;
+
+    err = hse_kvs_put_ttl(NULL, 0, NULL, "key0", 4, "val0", 4, 60);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_put_ttl((struct hse_kvs *)-1, ~0, NULL, "key0", 4, "val0", 4, 60);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_put_ttl((struct hse_kvs *)-1, 0, NULL, NULL, 4, "val0", 4, 60);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_put_ttl((struct hse_kvs *)-1, 0, NULL, "key0", 4, NULL, 4, 60);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_put_ttl((struct hse_kvs *)-1, 0, NULL, "key0", 4, "val0", 4, 0);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_put_ttl((struct hse_kvs *)-1, 0, NULL, "key0", 4, "val0", 4, UINT64_MAX);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_put_ttl(
+        (struct hse_kvs *)-1, 0, NULL, "key0", HSE_KVS_KEY_LEN_MAX + 1, "val0", 4, 60);
+    ASSERT_EQ(ENAMETOOLONG, hse_err_to_errno(err));
+
+    err = hse_kvs_put_ttl((struct hse_kvs *)-1, 0, NULL, "key0", 0, "val0", 4, 60);
+    ASSERT_EQ(ENOENT, hse_err_to_errno(err));
+
+    err = hse_kvs_put_ttl(
+        (struct hse_kvs *)-1, 0, NULL, "key0", 4, (void *)-1, HSE_KVS_VALUE_LEN_MAX + 1, 60);
+    ASSERT_EQ(EMSGSIZE, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, put_ttl_success, kvs_setup, kvs_teardown)
+{
+    struct hse_kvs_cursor *cursor;
+    char vbuf[16];
+    size_t val_len;
+    hse_err_t err;
+    bool found, eof;
+    const void *key, *val;
+    size_t klen, vlen;
+    unsigned int nkeys;
+
+    err = hse_kvs_put_ttl(kvs_handle, 0, NULL, "live", 4, "val0", 4, 3600);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_put_ttl(kvs_handle, 0, NULL, "dead", 4, "val1", 4, 1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "live", 4, &found, vbuf, sizeof(vbuf), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(4, val_len);
+    ASSERT_EQ(0, memcmp(vbuf, "val0", 4));
+
+    sleep(2);
+
+    /* An expired value reads as if the key had been deleted. */
+    err = hse_kvs_get(kvs_handle, 0, NULL, "dead", 4, &found, vbuf, sizeof(vbuf), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(found);
+
+    err = hse_kvs_cursor_create(kvs_handle, 0, NULL, NULL, 0, &cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    for (nkeys = 0;; nkeys++) {
+        err = hse_kvs_cursor_read(cursor, 0, &key, &klen, &val, &vlen, &eof);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+        if (eof)
+            break;
+
+        ASSERT_EQ(4, klen);
+        ASSERT_EQ(0, memcmp(key, "live", 4));
+    }
+
+    ASSERT_EQ(1, nkeys);
+
+    err = hse_kvs_cursor_destroy(cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* A plain put replaces an expiring value with one that never expires. */
+    err = hse_kvs_put(kvs_handle, 0, NULL, "dead", 4, "val2", 4);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "dead", 4, &found, vbuf, sizeof(vbuf), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, bulk_invalid_args)
+{
+    struct hse_kvs_bulk *bulk;
+    hse_err_t err;
+
+    err = hse_kvs_bulk_create(NULL, 0, &bulk);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_create((struct hse_kvs *)-1, 0, NULL);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_create((struct hse_kvs *)-1, ~0, &bulk);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_put(NULL, 0, "key0", 4, "val0", 4);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_put((struct hse_kvs_bulk *)-1, 0, NULL, 4, "val0", 4);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_put((struct hse_kvs_bulk *)-1, 0, "key0", 4, NULL, 4);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_put(
+        (struct hse_kvs_bulk *)-1, 0, "key0", HSE_KVS_KEY_LEN_MAX + 1, "val0", 4);
+    ASSERT_EQ(ENAMETOOLONG, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_put((struct hse_kvs_bulk *)-1, 0, "key0", 0, "val0", 4);
+    ASSERT_EQ(ENOENT, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_put(
+        (struct hse_kvs_bulk *)-1, 0, "key0", 4, (void *)-1, HSE_KVS_VALUE_LEN_MAX + 1);
+    ASSERT_EQ(EMSGSIZE, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_commit(NULL, 0);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_commit((struct hse_kvs_bulk *)-1, ~0);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    hse_kvs_bulk_destroy(NULL);
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, bulk_transactional, transactional_kvs_setup, kvs_teardown)
+{
+    struct hse_kvs_bulk *bulk;
+    hse_err_t err;
+
+    err = hse_kvs_bulk_create(kvs_handle, 0, &bulk);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, bulk_success, kvs_setup_with_data, kvs_teardown)
+{
+    struct hse_kvs_bulk *bulk;
+    char key_buf[16], val_buf[16];
+    size_t val_len;
+    hse_err_t err;
+    bool found;
+    int n;
+
+    err = hse_kvs_bulk_create(kvs_handle, 0, &bulk);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        n = snprintf(key_buf, sizeof(key_buf), "zbulk%04d", i);
+        snprintf(val_buf, sizeof(val_buf), "bval%04d", i);
+
+        err = hse_kvs_bulk_put(bulk, 0, key_buf, n, val_buf, strlen(val_buf));
+        ASSERT_EQ(0, hse_err_to_errno(err));
+    }
+
+    /* Keys must be put in ascending order. */
+    err = hse_kvs_bulk_put(bulk, 0, "zbulk", 5, "val", 3);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    /* Nothing is visible until the load is committed. */
+    err = hse_kvs_get(kvs_handle, 0, NULL, key_buf, n, &found, val_buf, sizeof(val_buf), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(found);
+
+    err = hse_kvs_bulk_commit(bulk, 0);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_commit(bulk, 0);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    hse_kvs_bulk_destroy(bulk);
+
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        char expect[16];
+
+        n = snprintf(key_buf, sizeof(key_buf), "zbulk%04d", i);
+        snprintf(expect, sizeof(expect), "bval%04d", i);
+
+        err = hse_kvs_get(
+            kvs_handle, 0, NULL, key_buf, n, &found, val_buf, sizeof(val_buf), &val_len);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+        ASSERT_TRUE(found);
+        ASSERT_EQ(strlen(expect), val_len);
+        ASSERT_EQ(0, memcmp(val_buf, expect, val_len));
+    }
+
+    /* Data put before the load is still there. */
+    n = snprintf(key_buf, sizeof(key_buf), KEY_FMT, 0);
+    err = hse_kvs_get(kvs_handle, 0, NULL, key_buf, n, &found, val_buf, sizeof(val_buf), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+
+    /* A load that is destroyed without being committed leaves no trace. */
+    err = hse_kvs_bulk_create(kvs_handle, 0, &bulk);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_bulk_put(bulk, 0, "zzzzzzzz", 8, "val", 3);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    hse_kvs_bulk_destroy(bulk);
+
+    err = hse_kvs_get(
+        kvs_handle, 0, NULL, "zzzzzzzz", 8, &found, val_buf, sizeof(val_buf), &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_FALSE(found);
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, range_delete_null_kvs)
+{
+    hse_err_t err;
+
+    err = hse_kvs_range_delete(NULL, 0, "key1", 4, "key3", 4);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, range_delete_invalid_flags)
+{
+    hse_err_t err;
+
+    err = hse_kvs_range_delete((struct hse_kvs *)-1, ~0, "key1", 4, "key3", 4);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, range_delete_null_bounds)
+{
+    hse_err_t err;
+
+    err = hse_kvs_range_delete((struct hse_kvs *)-1, 0, NULL, 4, "key3", 4);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_range_delete((struct hse_kvs *)-1, 0, "key1", 4, NULL, 4);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, range_delete_key_len_too_long)
+{
+    hse_err_t err;
+
+    err = hse_kvs_range_delete(
+        (struct hse_kvs *)-1, 0, (void *)-1, HSE_KVS_KEY_LEN_MAX + 1, "key3", 4);
+    ASSERT_EQ(ENAMETOOLONG, hse_err_to_errno(err));
+
+    err = hse_kvs_range_delete(
+        (struct hse_kvs *)-1, 0, "key1", 4, (void *)-1, HSE_KVS_KEY_LEN_MAX + 1);
+    ASSERT_EQ(ENAMETOOLONG, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, range_delete_key_len_is_0)
+{
+    hse_err_t err;
+
+    err = hse_kvs_range_delete((struct hse_kvs *)-1, 0, "key1", 0, "key3", 4);
+    ASSERT_EQ(ENOENT, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST(kvs_api_test, range_delete_empty_range)
+{
+    hse_err_t err;
+
+    err = hse_kvs_range_delete((struct hse_kvs *)-1, 0, "key3", 4, "key3", 4);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+
+    err = hse_kvs_range_delete((struct hse_kvs *)-1, 0, "key3", 4, "key1", 4);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(
+    kvs_api_test,
+    range_delete_transactional,
+    transactional_kvs_setup,
+    kvs_teardown)
+{
+    hse_err_t err;
+
+    err = hse_kvs_range_delete(kvs_handle, 0, "key1", 4, "key3", 4);
+    ASSERT_EQ(EINVAL, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, range_delete_success, kvs_setup_with_data, kvs_teardown)
+{
+    hse_err_t err;
+    char key_buf[8];
+    size_t val_len;
+    bool found;
+    int n;
+
+    err = hse_kvs_range_delete(kvs_handle, 0, "key1", 4, "key3", 4);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        n = snprintf(key_buf, sizeof(key_buf), KEY_FMT, i);
+
+        err = hse_kvs_get(kvs_handle, 0, NULL, key_buf, n, &found, NULL, 0, &val_len);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+        ASSERT_EQ(i < 1 || i >= 3, found);
+    }
+
+    /* A put after the range delete is visible. */
+    err = hse_kvs_put(kvs_handle, 0, NULL, "key2", 4, "v", 1);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_get(kvs_handle, 0, NULL, "key2", 4, &found, NULL, 0, &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_TRUE(found);
+    ASSERT_EQ(1, val_len);
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, range_delete_ingested, kvs_setup_with_data, kvs_teardown)
+{
+    struct hse_kvdb_snapshot *snap;
+    char key_buf[8];
+    size_t val_len;
+    hse_err_t err;
+    bool found;
+    int n;
+
+    err = hse_kvdb_snapshot_create(kvdb_handle, &snap);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    /* Delete keys which are in cn rather than in c0. */
+    err = hse_kvdb_sync(kvdb_handle, 0);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_range_delete(kvs_handle, 0, "key", 3, "key4", 4);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvdb_sync(kvdb_handle, 0);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        n = snprintf(key_buf, sizeof(key_buf), KEY_FMT, i);
+
+        err = hse_kvs_get(kvs_handle, 0, NULL, key_buf, n, &found, NULL, 0, &val_len);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+        ASSERT_EQ(i >= 4, found);
+
+        /* A snapshot taken before the range delete still sees every key. */
+        err = hse_kvs_snapshot_get(kvs_handle, 0, snap, key_buf, n, &found, NULL, 0, &val_len);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+        ASSERT_TRUE(found);
+    }
+
+    err = hse_kvdb_snapshot_release(kvdb_handle, snap);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, range_delete_cursor, kvs_setup_with_data, kvs_teardown)
+{
+    struct hse_kvs_cursor *cursor;
+    const void *key, *val;
+    size_t klen, vlen;
+    char key_buf[8];
+    hse_err_t err;
+    bool eof;
+    int i, n;
+
+    err = hse_kvs_range_delete(kvs_handle, 0, "key1", 4, "key3", 4);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_cursor_create(kvs_handle, 0, NULL, NULL, 0, &cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    for (i = 0;; i++) {
+        err = hse_kvs_cursor_read(cursor, 0, &key, &klen, &val, &vlen, &eof);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+        if (eof)
+            break;
+
+        /* key1 and key2 are skipped. */
+        n = snprintf(key_buf, sizeof(key_buf), KEY_FMT, i < 1 ? i : i + 2);
+        ASSERT_EQ(n, klen);
+        ASSERT_EQ(0, memcmp(key, key_buf, klen));
+    }
+
+    ASSERT_EQ(NUM_ENTRIES - 2, i);
+
+    err = hse_kvs_cursor_destroy(cursor);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+}
+
+MTF_DEFINE_UTEST_PREPOST(kvs_api_test, range_delete_prefix_probe, kvs_setup, kvs_teardown)
+{
+    static const char *keyv[] = { "aaa1", "bbb1", "bbb2", "bbb3", "ccc1" };
+    enum hse_kvs_pfx_probe_cnt cnt;
+    char key_buf[HSE_KVS_KEY_LEN_MAX];
+    size_t key_len, val_len;
+    hse_err_t err;
+    bool found;
+
+    for (int i = 0; i < NELEM(keyv); i++) {
+        err = hse_kvs_put(kvs_handle, 0, NULL, keyv[i], strlen(keyv[i]), "v", 1);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+    }
+
+    err = hse_kvs_range_delete(kvs_handle, 0, "aaa5", 4, "bbb3", 4);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    for (int i = 0; i < NELEM(keyv); i++) {
+        err = hse_kvs_get(kvs_handle, 0, NULL, keyv[i], strlen(keyv[i]), &found, NULL, 0, &val_len);
+        ASSERT_EQ(0, hse_err_to_errno(err));
+        ASSERT_EQ(i == 0 || i >= 3, found);
+    }
+
+    /* Only bbb3 is left with prefix "bbb". */
+    err = hse_kvs_prefix_probe(
+        kvs_handle, 0, NULL, "bbb", 3, &cnt, key_buf, sizeof(key_buf), &key_len, NULL, 0,
+        &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_EQ(HSE_KVS_PFX_FOUND_ONE, cnt);
+    ASSERT_EQ(4, key_len);
+    ASSERT_EQ(0, memcmp(key_buf, "bbb3", 4));
+
+    err = hse_kvs_range_delete(kvs_handle, 0, "bbb", 3, "bbc", 3);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+
+    err = hse_kvs_prefix_probe(
+        kvs_handle, 0, NULL, "bbb", 3, &cnt, key_buf, sizeof(key_buf), &key_len, NULL, 0,
+        &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_EQ(HSE_KVS_PFX_FOUND_ZERO, cnt);
+
+    err = hse_kvs_prefix_probe(
+        kvs_handle, 0, NULL, "ccc", 3, &cnt, key_buf, sizeof(key_buf), &key_len, NULL, 0,
+        &val_len);
+    ASSERT_EQ(0, hse_err_to_errno(err));
+    ASSERT_EQ(HSE_KVS_PFX_FOUND_ONE, cnt);
+}
+
 MTF_DEFINE_UTEST(kvs_api_test, put_null_kvs)
 {
     hse_err_t err;
@@ -316,7 +316,8 @@ _c0_get(
     uint64_t view_seqno,
     uintptr_t seqnoref,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf)
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
 {
     struct mock_c0 *m0 = mock_c0_h2r(handle);
     int i;
@@ -333,6 +334,8 @@ _c0_get(
             copylen = MIN(vbuf->b_len, vbuf->b_buf_sz);
             memcpy(vbuf->b_buf, m0->data[i].val, copylen);
             *res = FOUND_VAL;
+            if (seqnop)
+                *seqnop = view_seqno;
             return 0;
         }
     }
@@ -346,6 +349,8 @@ _cn_get(
     struct cn *handle,
     struct kvs_ktuple *kt,
     uint64_t seq,
+    uint64_t rcgen,
+    bool direct,
     enum key_lookup_res *res,
     struct kvs_buf *vbuf)
 {
@@ -353,6 +358,18 @@ _cn_get(
     return 0;
 }
 
+static merr_t
+_cn_get_multi(
+    struct cn *handle,
+    uint cnt,
+    struct kvs_ktuple *ktv,
+    uint64_t seq,
+    enum key_lookup_res *resv,
+    struct kvs_buf *vbufv)
+{
+    return 0;
+}
+
 static merr_t
 _c0_del(struct c0 *handle, struct kvs_ktuple *kt, const uintptr_t seqno)
 {
@@ -476,6 +493,7 @@ _cn_cursor_create(
     struct cn *cn,
     uint64_t seqno,
     bool reverse,
+    bool novals,
     const void *prefix,
     uint32_t pfx_len,
     struct cursor_summary *summary,
@@ -646,6 +664,12 @@ static struct mapi_injection cn_inject_list[] = {
     { mapi_idx_cn_periodic, MAPI_RC_SCALAR, 0 },
     { mapi_idx_cn_is_capped, MAPI_RC_SCALAR, 0 },
     { mapi_idx_cn_disable_maint, MAPI_RC_SCALAR, 0 },
+    { mapi_idx_cn_rcache_gen, MAPI_RC_SCALAR, 0 },
+    { mapi_idx_cn_rcache_invalidate, MAPI_RC_SCALAR, 0 },
+    { mapi_idx_cn_rcache_purge, MAPI_RC_SCALAR, 0 },
+    { mapi_idx_cn_range_delete, MAPI_RC_SCALAR, 0 },
+    { mapi_idx_cn_rtomb_retire, MAPI_RC_SCALAR, 0 },
+    { mapi_idx_cn_rtombs_get, MAPI_RC_PTR, NULL },
 
     { mapi_idx_cn_get_rp, MAPI_RC_PTR, &mocked_kvs_rparams },
     { mapi_idx_cn_get_cparams, MAPI_RC_PTR, &mocked_kvs_cparams },
@@ -669,6 +693,7 @@ mock_cn_set()
     MOCK_SET(cn, _cn_open);
     MOCK_SET(cn, _cn_close);
     MOCK_SET(cn, _cn_get);
+    MOCK_SET(cn, _cn_get_multi);
     MOCK_SET(cn, _cn_ref_get);
     MOCK_SET(cn, _cn_ref_put);
 
@@ -692,6 +717,7 @@ mock_cn_unset()
     MOCK_UNSET(cn, _cn_open);
     MOCK_UNSET(cn, _cn_close);
     MOCK_UNSET(cn, _cn_get);
+    MOCK_UNSET(cn, _cn_get_multi);
     MOCK_UNSET(cn, _cn_ref_get);
     MOCK_UNSET(cn, _cn_ref_put);
 
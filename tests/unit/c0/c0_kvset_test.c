@@ -1149,4 +1149,80 @@ MTF_DEFINE_UTEST_PREPOST(c0_kvset_test, iterator, no_fail_pre, no_fail_post)
     c0kvs_destroy(kvs);
 }
 
+MTF_DEFINE_UTEST_PREPOST(c0_kvset_test, merge_read_commit, no_fail_pre, no_fail_post)
+{
+    const uintptr_t seqnoref = HSE_SQNREF_SINGLE;
+    struct c0_kvset *kvs;
+    struct kvs_ktuple kt;
+    struct kvs_vtuple vt;
+    struct kvs_buf vbuf;
+    enum key_lookup_res res;
+    uintptr_t oseqnoref;
+    const void *ver, *ver2;
+    char buf[16];
+    merr_t err;
+
+    err = c0kvs_create(NULL, NULL, &kvs);
+    ASSERT_EQ(0, err);
+
+    kvs_buf_init(&vbuf, buf, sizeof(buf));
+    kvs_ktuple_init(&kt, "key", 3);
+
+    err = c0kvs_merge_read(kvs, 0, &kt, &vbuf, &res, &oseqnoref, &ver);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(NOT_FOUND, res);
+    ASSERT_EQ(NULL, ver);
+
+    /* A commit succeeds if the key has not changed since it was read.
+     */
+    kvs_vtuple_init(&vt, "val1", 4);
+    err = c0kvs_merge_commit(kvs, 0, &kt, &vt, seqnoref, ver);
+    ASSERT_EQ(0, err);
+
+    err = c0kvs_merge_read(kvs, 0, &kt, &vbuf, &res, &oseqnoref, &ver);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(FOUND_VAL, res);
+    ASSERT_EQ(4, vbuf.b_len);
+    ASSERT_EQ(0, memcmp(buf, "val1", 4));
+    ASSERT_NE(NULL, ver);
+
+    /* A commit fails if the key was updated after it was read, and may be
+     * retried with the version of the new value.
+     */
+    kvs_vtuple_init(&vt, "val2", 4);
+    err = c0kvs_put(kvs, 0, &kt, &vt, seqnoref);
+    ASSERT_EQ(0, err);
+
+    kvs_vtuple_init(&vt, "val3", 4);
+    err = c0kvs_merge_commit(kvs, 0, &kt, &vt, seqnoref, ver);
+    ASSERT_EQ(ECANCELED, merr_errno(err));
+
+    err = c0kvs_merge_read(kvs, 0, &kt, &vbuf, &res, &oseqnoref, &ver2);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(FOUND_VAL, res);
+    ASSERT_EQ(0, memcmp(buf, "val2", 4));
+    ASSERT_NE(ver, ver2);
+
+    err = c0kvs_merge_commit(kvs, 0, &kt, &vt, seqnoref, ver2);
+    ASSERT_EQ(0, err);
+
+    /* Deletes are updates too.
+     */
+    err = c0kvs_merge_read(kvs, 0, &kt, &vbuf, &res, &oseqnoref, &ver);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(0, memcmp(buf, "val3", 4));
+
+    err = c0kvs_del(kvs, 0, &kt, seqnoref);
+    ASSERT_EQ(0, err);
+
+    err = c0kvs_merge_commit(kvs, 0, &kt, &vt, seqnoref, ver);
+    ASSERT_EQ(ECANCELED, merr_errno(err));
+
+    err = c0kvs_merge_read(kvs, 0, &kt, &vbuf, &res, &oseqnoref, &ver);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(FOUND_TMB, res);
+
+    c0kvs_destroy(kvs);
+}
+
 MTF_END_UTEST_COLLECTION(c0_kvset_test)
@@ -99,7 +99,8 @@ _c0sk_get(
     uint64_t view_seqno,
     uintptr_t seqnoref,
     enum key_lookup_res *res,
-    struct kvs_buf *vbuf)
+    struct kvs_buf *vbuf,
+    uint64_t *seqnop)
 {
     struct mock_c0sk *mock_c0sk = (struct mock_c0sk *)self;
     merr_t err = 0;
@@ -325,13 +325,13 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, ingest_debug, no_fail_pre, no_fail_post)
         err = c0sk_put(mkvdb.ikdb_c0sk, skidx, &kt, &vt, HSE_SQNREF_SINGLE);
         ASSERT_EQ(0, err);
 
-        err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+        err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
         ASSERT_EQ(0, err);
         ASSERT_EQ(res, FOUND_VAL);
 
         if (i % 5 == 0 && kt.kt_len >= pfx_len) {
             err =
-                c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+                c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
             ASSERT_EQ(0, err);
 
             if (res != FOUND_TMB) {
@@ -342,12 +342,12 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, ingest_debug, no_fail_pre, no_fail_post)
                 ASSERT_EQ(0, err);
 
                 err = c0sk_get(
-                    mkvdb.ikdb_c0sk, skidx, pfx_len, &pfx_kt, atomic_read(&seqno), 0, &res, &vbuf);
+                    mkvdb.ikdb_c0sk, skidx, pfx_len, &pfx_kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
                 ASSERT_EQ(0, err);
                 ASSERT_EQ(res, FOUND_PTMB);
 
                 err = c0sk_get(
-                    mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+                    mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
                 ASSERT_EQ(0, err);
                 ASSERT_EQ(res, FOUND_PTMB);
 
@@ -357,7 +357,7 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, ingest_debug, no_fail_pre, no_fail_post)
 
             atomic_inc(&seqno);
             err =
-                c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+                c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
             ASSERT_EQ(0, err);
             ASSERT_EQ(res, FOUND_VAL);
 
@@ -366,7 +366,7 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, ingest_debug, no_fail_pre, no_fail_post)
             ASSERT_EQ(0, err);
 
             err =
-                c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+                c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
             ASSERT_EQ(0, err);
             ASSERT_EQ(res, FOUND_TMB);
         }
@@ -375,7 +375,7 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, ingest_debug, no_fail_pre, no_fail_post)
     err = c0sk_del(mkvdb.ikdb_c0sk, skidx, &kt, HSE_SQNREF_SINGLE);
     ASSERT_EQ(0, err);
 
-    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
     ASSERT_EQ(0, err);
     ASSERT_EQ(res, FOUND_TMB);
 
@@ -1496,7 +1496,7 @@ parallel_get_helper(void *arg)
 
         kvs_ktuple_init(&kt, key_buf, key_len);
 
-        c0sk_get(ikvdb, skidx, pfx_len, &kt, seq, 0, &res, &vbuf);
+        c0sk_get(ikvdb, skidx, pfx_len, &kt, seq, 0, &res, &vbuf, NULL);
         if (found) {
             int rc = memcmp(key_buf, val_buf, key_len);
 
@@ -1663,14 +1663,14 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, c0sk_get_test, no_fail_pre, no_fail_post)
 
     /* small buffer */
     kvs_buf_init(&vbuf, buf, 4); /* insufficiently sized buffer */
-    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
     ASSERT_EQ(0, merr_errno(err));
     ASSERT_EQ(res, FOUND_VAL);
     ASSERT_EQ(vbuf.b_len, kvs_vtuple_vlen(&vt));
     ASSERT_EQ(0, strncmp(buf, "this", vbuf.b_buf_sz));
 
     kvs_buf_init(&vbuf, buf, vbuf.b_len);
-    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
     ASSERT_EQ(0, err);
     ASSERT_EQ(res, FOUND_VAL);
     ASSERT_EQ(vbuf.b_len, kvs_vtuple_vlen(&vt));
@@ -1680,7 +1680,7 @@ MTF_DEFINE_UTEST_PREPOST(c0sk_test, c0sk_get_test, no_fail_pre, no_fail_post)
     str = "shouldnt_exist";
     kvs_ktuple_init(&kt, str, strlen(str));
     kvs_buf_init(&vbuf, buf, sizeof(buf));
-    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf);
+    err = c0sk_get(mkvdb.ikdb_c0sk, skidx, pfx_len, &kt, atomic_read(&seqno), 0, &res, &vbuf, NULL);
     ASSERT_EQ(0, err);
     ASSERT_EQ(res, NOT_FOUND);
 
@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <hse/util/arch.h>
+#include <hse/util/bloom_filter.h>
+#include <hse/util/hash.h>
+#include <hse/util/page.h>
+
+#include <hse/test/mtf/framework.h>
+
+#include "cn/bloom_reader.h"
+
+static bool
+simd_usable(enum hse_simd simd, enum hse_simd avail)
+{
+    if (simd == HSE_SIMD_NONE || simd == avail)
+        return true;
+
+    return simd == HSE_SIMD_SSE42 && avail == HSE_SIMD_AVX2;
+}
+
+MTF_BEGIN_UTEST_COLLECTION(bloom_probe_test)
+
+/* Verify that every probe kernel usable on this machine agrees with the
+ * bit-at-a-time reference lookup for both present and absent keys.
+ */
+MTF_DEFINE_UTEST(bloom_probe_test, kernels_match_reference)
+{
+    const enum hse_simd simdv[] = { HSE_SIMD_NONE, HSE_SIMD_SSE42, HSE_SIMD_AVX2, HSE_SIMD_NEON };
+    const uint32_t n_elts = 10000;
+    enum hse_simd simd_saved;
+    struct bf_bithash_desc bhd;
+    struct bloom_filter f;
+    struct bloom_desc desc;
+    uint8_t *bits;
+    uint64_t hash;
+    char buf[100];
+    size_t sz;
+    uint i, n;
+
+    hse_simd_init();
+    simd_saved = hse_simd;
+
+    bhd = bf_compute_bithash_est(10000);
+
+    sz = ALIGN(n_elts * bhd.bhd_bits_per_elt, PAGE_SIZE);
+    bits = aligned_alloc(PAGE_SIZE, sz);
+    ASSERT_NE(NULL, bits);
+    memset(bits, 0, sz);
+
+    bf_filter_init(&f, bhd, n_elts, bits, sz);
+
+    for (i = 0; i < n_elts; ++i) {
+        n = sprintf(buf, "%x:%d", i, i);
+        bf_filter_insert_by_hash(&f, hse_hash64(buf, n));
+    }
+
+    memset(&desc, 0, sizeof(desc));
+    desc.bd_bitmap = bits;
+    desc.bd_modulus = f.bf_modulus;
+    desc.bd_bktshift = f.bf_bktshift;
+    desc.bd_n_hashes = f.bf_n_hashes;
+    desc.bd_rotl = f.bf_rotl;
+    desc.bd_bktmask = f.bf_bktmask;
+
+    for (size_t j = 0; j < NELEM(simdv); ++j) {
+        if (!simd_usable(simdv[j], simd_saved))
+            continue;
+
+        hse_simd = simdv[j];
+
+        for (i = 0; i < 2 * n_elts; ++i) {
+            const uint8_t *bitmap = bits;
+            bool expect, hit;
+
+            n = sprintf(buf, "%x:%d", i, i);
+            hash = hse_hash64(buf, n);
+            if (i >= n_elts)
+                hash = ~hash;
+
+            bitmap += bf_hash2bkt(hash, f.bf_modulus, f.bf_bktshift);
+            expect = bf_lookup(hash, bitmap, f.bf_n_hashes, f.bf_rotl, f.bf_bktmask);
+
+            hit = bloom_reader_lookup(&desc, hash);
+            ASSERT_EQ(expect, hit);
+
+            if (i < n_elts)
+                ASSERT_TRUE(hit);
+        }
+    }
+
+    hse_simd = simd_saved;
+    free(bits);
+}
+
+MTF_END_UTEST_COLLECTION(bloom_probe_test)
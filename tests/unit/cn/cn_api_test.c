@@ -31,6 +31,7 @@ pre(struct mtf_test_info *info)
 
     mapi_inject_ptr(mapi_idx_ikvdb_get_mclass_policy, (void *)5);
     mapi_inject(mapi_idx_cndb_cn_instantiate, 0);
+    mapi_inject(mapi_idx_cndb_cn_rtombs, 0);
     mapi_inject(mapi_idx_cndb_nodeid_mint, 1);
 
     return 0;
@@ -68,7 +69,7 @@ MTF_DEFINE_UTEST_PRE(cn_api, basic, pre)
     mapi_inject_ptr(mapi_idx_ikvdb_kvdb_handle, NULL);
     mapi_inject_ptr(mapi_idx_kvdb_kvs_parent, NULL);
 
-    err = cn_kvdb_create(4, 4, &cn_kvdb);
+    err = cn_kvdb_create(4, 4, 4, 0, &cn_kvdb);
     ASSERT_EQ(0, err);
 
     err = cn_open(cn_kvdb, ds, &kk, cndb, 0, &rp, "mp", "kvs", &mock_health, 0, &cn);
@@ -89,6 +90,7 @@ MTF_DEFINE_UTEST_PRE(cn_api, basic, pre)
 
     (void)cn_get_cancel(cn);
     (void)cn_get_io_wq(cn);
+    (void)cn_get_wr_wq(cn);
     (void)cn_get_sched(cn);
     (void)cn_get_cndb(cn);
     (void)cn_get_perfc(cn, CN_ACTION_COMPACT_K);
@@ -96,7 +98,7 @@ MTF_DEFINE_UTEST_PRE(cn_api, basic, pre)
     (void)cn_get_perfc(cn, CN_ACTION_SPILL);
     (void)cn_get_perfc(cn, CN_ACTION_NONE);
 
-    err = cn_get(cn, &kt, 0, &res, &vbuf);
+    err = cn_get(cn, &kt, 0, 0, false, &res, &vbuf);
     ASSERT_EQ(err, 0);
     ASSERT_EQ(res, NOT_FOUND);
 
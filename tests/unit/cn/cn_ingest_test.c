@@ -22,6 +22,7 @@
 #include "cn/cn_tree_create.h"
 #include "cn/cn_tree_internal.h"
 #include "cn/kvset.h"
+#include "cn/rtomb.h"
 
 static struct mpool *mock_ds = (void *)-1;
 
@@ -173,6 +174,71 @@ init_mblks(struct kvset_mblocks *p, uint nsets, uint *nk, uint *nv)
     }
 }
 
+static uint64_t bulk_dgenv[8];
+static uint bulk_dgenc;
+
+static merr_t
+_kvset_builder_create(
+    struct kvset_builder **builder_out,
+    struct cn *cn,
+    struct perfc_set *pc,
+    uint64_t vgroup)
+{
+    *builder_out = (void *)&bulk_dgenc;
+    return 0;
+}
+
+static merr_t
+_kvset_builder_get_mblocks(struct kvset_builder *builder, struct kvset_mblocks *mblocks)
+{
+    uint k, v;
+
+    init_mblks(mblocks, 1, &k, &v);
+    return 0;
+}
+
+static merr_t
+_kvset_open(struct cn_tree *tree, uint64_t tag, struct kvset_meta *meta, struct kvset **kvset)
+{
+    if (bulk_dgenc < NELEM(bulk_dgenv))
+        bulk_dgenv[bulk_dgenc++] = meta->km_dgen_hi;
+
+    *kvset = (void *)&bulk_dgenv;
+    return 0;
+}
+
+static void
+enable_bulk_mocks(void)
+{
+    mapi_inject(mapi_idx_kvset_builder_add_key, 0);
+    mapi_inject(mapi_idx_kvset_builder_add_val, 0);
+    mapi_inject(mapi_idx_kvset_builder_set_agegroup, 0);
+    mapi_inject(mapi_idx_kvset_builder_destroy, 0);
+
+    MOCK_SET(kvset_builder, _kvset_builder_create);
+    MOCK_SET(kvset_builder, _kvset_builder_get_mblocks);
+
+    mapi_inject_unset(mapi_idx_kvset_open);
+    MOCK_SET(kvset, _kvset_open);
+
+    bulk_dgenc = 0;
+}
+
+static void
+disable_bulk_mocks(void)
+{
+    mapi_inject_unset(mapi_idx_kvset_builder_add_key);
+    mapi_inject_unset(mapi_idx_kvset_builder_add_val);
+    mapi_inject_unset(mapi_idx_kvset_builder_set_agegroup);
+    mapi_inject_unset(mapi_idx_kvset_builder_destroy);
+
+    MOCK_UNSET(kvset_builder, _kvset_builder_create);
+    MOCK_UNSET(kvset_builder, _kvset_builder_get_mblocks);
+    MOCK_UNSET(kvset, _kvset_open);
+
+    mapi_inject(mapi_idx_kvset_open, 0);
+}
+
 /* ------------------------------------------------------------
  * Unit tests
  */
@@ -294,4 +360,224 @@ MTF_DEFINE_UTEST_PRE(cn_ingest_test, fail_cleanup, test_pre)
     cn_tree_destroy(cn.cn_tree);
 }
 
+static merr_t
+bulk_publish_busy(void *arg)
+{
+    ++*(int *)arg;
+
+    return merr(EBUSY);
+}
+
+MTF_DEFINE_UTEST_PRE(cn_ingest_test, bulk, test_pre)
+{
+    int publish_calls = 0;
+    struct cn cn = {};
+    struct cn_bulk *bulk;
+    struct kvs_rparams rp;
+    struct kvs_cparams cp;
+    struct kvs_ktuple kt;
+    struct kvs_vtuple vt;
+    char val[8] = { 0 };
+    char key[8];
+    merr_t err;
+
+    rp = kvs_rparams_defaults();
+    rp.cn_split_size = 8;
+    cn.rp = &rp;
+    cn.cn_dataset = mock_ds;
+    cn.cn_kvdb_alias = "kvdb";
+    cn.cn_kvs_name = "kvs";
+    mutex_init(&cn.cn_ingest_lock);
+    atomic_set(&cn.cn_ingest_dgen, 41);
+
+    cp.pfx_len = 0;
+    err = cn_tree_create(&cn.cn_tree, 0, &cp, &mock_health, &rp);
+    ASSERT_EQ(err, 0);
+
+    enable_bulk_mocks();
+
+    err = cn_bulk_create(&cn, 1234, &bulk);
+    ASSERT_EQ(err, 0);
+
+    /* The builders are mocked, so the values need not be as long as they
+     * claim to be.  Two 4GiB values fill an 8GiB kvset, hence five keys
+     * are cut into three kvsets.
+     */
+    kvs_vtuple_init(&vt, val, UINT32_MAX);
+
+    for (int i = 0; i < 5; i++) {
+        snprintf(key, sizeof(key), "key%02d", i);
+        kvs_ktuple_init_nohash(&kt, key, strlen(key));
+
+        err = cn_bulk_add(bulk, &kt, &vt);
+        ASSERT_EQ(err, 0);
+
+        /* Out of order keys are rejected without failing the load.
+         */
+        err = cn_bulk_add(bulk, &kt, &vt);
+        ASSERT_EQ(merr_errno(err), EINVAL);
+    }
+
+    mapi_calls_clear(mapi_idx_cndb_record_kvset_add);
+    mapi_calls_clear(mapi_idx_cn_tree_ingest_update);
+
+    err = cn_bulk_commit(bulk, NULL, NULL);
+    ASSERT_EQ(err, 0);
+    ASSERT_EQ(3, mapi_calls(mapi_idx_cndb_record_kvset_add));
+    ASSERT_EQ(3, mapi_calls(mapi_idx_cn_tree_ingest_update));
+
+    /* Each kvset gets a dgen of its own, in key order.
+     */
+    ASSERT_EQ(3, bulk_dgenc);
+    ASSERT_EQ(42, bulk_dgenv[0]);
+    ASSERT_EQ(43, bulk_dgenv[1]);
+    ASSERT_EQ(44, bulk_dgenv[2]);
+
+    cn_bulk_destroy(bulk);
+
+    /* A failed commit fails the load and deletes its mblocks.
+     */
+    err = cn_bulk_create(&cn, 1235, &bulk);
+    ASSERT_EQ(err, 0);
+
+    kvs_vtuple_init(&vt, val, sizeof(val));
+    kvs_ktuple_init_nohash(&kt, "key", 3);
+
+    err = cn_bulk_add(bulk, &kt, &vt);
+    ASSERT_EQ(err, 0);
+
+    mapi_calls_clear(mapi_idx_mpool_mblock_delete);
+    mapi_inject(mapi_idx_cndb_record_kvset_add, merr(EIO));
+
+    err = cn_bulk_commit(bulk, NULL, NULL);
+    ASSERT_EQ(merr_errno(err), EIO);
+    ASSERT_EQ(1 + 3 + 5, mapi_calls(mapi_idx_mpool_mblock_delete));
+
+    mapi_inject(mapi_idx_cndb_record_kvset_add, 0);
+
+    kvs_ktuple_init_nohash(&kt, "key2", 4);
+    err = cn_bulk_add(bulk, &kt, &vt);
+    ASSERT_EQ(merr_errno(err), EIO);
+
+    cn_bulk_destroy(bulk);
+
+    /* A failed publish callback fails the commit before anything is
+     * recorded, and the commit may be retried.
+     */
+    err = cn_bulk_create(&cn, 1236, &bulk);
+    ASSERT_EQ(err, 0);
+
+    err = cn_bulk_add(bulk, &kt, &vt);
+    ASSERT_EQ(err, 0);
+
+    mapi_calls_clear(mapi_idx_cndb_record_txstart);
+    mapi_calls_clear(mapi_idx_cndb_record_nak);
+    mapi_calls_clear(mapi_idx_mpool_mblock_delete);
+    mapi_calls_clear(mapi_idx_cn_tree_ingest_update);
+
+    err = cn_bulk_commit(bulk, bulk_publish_busy, &publish_calls);
+    ASSERT_EQ(merr_errno(err), EBUSY);
+    ASSERT_EQ(1, publish_calls);
+
+    err = cn_bulk_commit(bulk, bulk_publish_busy, &publish_calls);
+    ASSERT_EQ(merr_errno(err), EBUSY);
+    ASSERT_EQ(2, publish_calls);
+
+    ASSERT_EQ(0, mapi_calls(mapi_idx_cndb_record_txstart));
+    ASSERT_EQ(0, mapi_calls(mapi_idx_cndb_record_nak));
+    ASSERT_EQ(0, mapi_calls(mapi_idx_mpool_mblock_delete));
+    ASSERT_EQ(0, mapi_calls(mapi_idx_cn_tree_ingest_update));
+
+    err = cn_bulk_commit(bulk, NULL, NULL);
+    ASSERT_EQ(err, 0);
+    ASSERT_EQ(1, mapi_calls(mapi_idx_cn_tree_ingest_update));
+
+    cn_bulk_destroy(bulk);
+
+    /* Newer data within the key range of the load fails the load.
+     */
+    err = cn_bulk_create(&cn, 1237, &bulk);
+    ASSERT_EQ(err, 0);
+
+    err = cn_bulk_add(bulk, &kt, &vt);
+    ASSERT_EQ(err, 0);
+
+    mapi_calls_clear(mapi_idx_cndb_record_txstart);
+    mapi_inject(mapi_idx_cn_tree_overlaps_newer, true);
+
+    err = cn_bulk_commit(bulk, NULL, NULL);
+    ASSERT_EQ(merr_errno(err), ECANCELED);
+    ASSERT_EQ(0, mapi_calls(mapi_idx_cndb_record_txstart));
+
+    err = cn_bulk_commit(bulk, NULL, NULL);
+    ASSERT_EQ(merr_errno(err), ECANCELED);
+
+    mapi_inject_unset(mapi_idx_cn_tree_overlaps_newer);
+    cn_bulk_destroy(bulk);
+
+    /* So does a newer range tombstone which overlaps the load, but neither
+     * an older one nor one outside of the load.
+     */
+    {
+        struct rtomb_set *set = NULL, *new;
+        const struct {
+            const char *start, *end;
+            uint64_t seqno;
+            int errno_exp;
+        } tombv[] = {
+            { "key3", "key4", 2000, 0 },
+            { "a", "key2", 2000, 0 },
+            { "a", "z", 1000, 0 },
+            { "key2", "key21", 2000, ECANCELED },
+        };
+
+        spin_lock_init(&cn.cn_rtomb_spin);
+
+        for (uint i = 0; i < NELEM(tombv); i++) {
+            struct rtomb *rt;
+
+            err = rtomb_create(
+                tombv[i].start, strlen(tombv[i].start), tombv[i].end, strlen(tombv[i].end),
+                tombv[i].seqno, &rt);
+            ASSERT_EQ(err, 0);
+
+            err = rtomb_set_insert(set, rt, &new);
+            ASSERT_EQ(err, 0);
+            rtomb_put(rt);
+            rtomb_set_put(set);
+            set = new;
+
+            cn.cn_rtombs = set;
+            atomic_set(&cn.cn_rtomb_cnt, set->rs_cnt);
+
+            err = cn_bulk_create(&cn, 1238 + i, &bulk);
+            ASSERT_EQ(err, 0);
+
+            kvs_ktuple_init_nohash(&kt, "key2", 4);
+            err = cn_bulk_add(bulk, &kt, &vt);
+            ASSERT_EQ(err, 0);
+
+            err = cn_bulk_commit(bulk, NULL, NULL);
+            ASSERT_EQ(tombv[i].errno_exp, merr_errno(err));
+
+            cn_bulk_destroy(bulk);
+        }
+
+        cn.cn_rtombs = NULL;
+        atomic_set(&cn.cn_rtomb_cnt, 0);
+        rtomb_set_put(set);
+    }
+
+    /* Capped kvs cannot be bulk loaded.
+     */
+    cn.cn_cflags = CN_CFLAG_CAPPED;
+    err = cn_bulk_create(&cn, 1250, &bulk);
+    ASSERT_EQ(merr_errno(err), EINVAL);
+
+    disable_bulk_mocks();
+
+    cn_tree_destroy(cn.cn_tree);
+    mutex_destroy(&cn.cn_ingest_lock);
+}
+
 MTF_END_UTEST_COLLECTION(cn_ingest_test);
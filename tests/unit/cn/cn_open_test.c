@@ -65,6 +65,7 @@ struct mapi_injection inject_list[] = { { mapi_idx_ikvdb_get_csched, MAPI_RC_PTR
                                         { mapi_idx_kvdb_kvs_flags, MAPI_RC_SCALAR, 0 },
 
                                         { mapi_idx_cndb_cn_instantiate, MAPI_RC_SCALAR, 0 },
+                                        { mapi_idx_cndb_cn_rtombs, MAPI_RC_SCALAR, 0 },
                                         { mapi_idx_cndb_nodeid_mint, MAPI_RC_SCALAR, 1 },
 
                                         { mapi_idx_csched_tree_add, MAPI_RC_SCALAR, 0 },
@@ -98,7 +99,7 @@ pre(struct mtf_test_info *lcl_ti)
     h = &health;
     flags = 0;
 
-    err = cn_kvdb_create(4, 4, &cn_kvdb);
+    err = cn_kvdb_create(4, 4, 4, 0, &cn_kvdb);
 
     return merr_errno(err);
 }
@@ -155,6 +155,7 @@ _kvset_iter_val_get(
     case VTYPE_IVAL:
     case VTYPE_UCVAL:
     case VTYPE_CVAL:
+    case VTYPE_ZCVAL:
         *vdata = kv->kdata;
         *vlen = kv->klen;
         break;
@@ -25,6 +25,7 @@
 #include "cn/cn_tree_iter.h"
 #include "cn/kv_iterator.h"
 #include "cn/kvset.h"
+#include "cn/route.h"
 
 struct mpool *mock_ds = (void *)0x1234abcd;
 struct kvdb_health mock_health;
@@ -296,6 +297,7 @@ struct mapi_injection inject_list[] = {
     { mapi_idx_cn_mblocks_destroy, MAPI_RC_SCALAR, 0 },
     { mapi_idx_cn_get_flags, MAPI_RC_SCALAR, 0 },
     { mapi_idx_cn_get_seqno_horizon, MAPI_RC_SCALAR, 10 },
+    { mapi_idx_cn_rtombs_get, MAPI_RC_PTR, NULL },
     { mapi_idx_cn_get_cancel, MAPI_RC_SCALAR, 0 },
     { mapi_idx_cn_get_flags, MAPI_RC_SCALAR, 0 },
     { mapi_idx_cn_get_sched, MAPI_RC_SCALAR, 0 },
@@ -836,6 +838,76 @@ MTF_DEFINE_UTEST_PRE(test, cn_node_get_minmax, test_setup)
     test_tree_destroy(&t);
 }
 
+MTF_DEFINE_UTEST_PRE(test, spill_part_must_wait, test_setup)
+{
+    struct cn_tree_node *tnv[4], *tn;
+    struct test_params tp = {};
+    struct route_node *rtnv[4];
+    struct test t = {};
+    merr_t err;
+    int i = 0;
+
+    tp.fanout_bits = 2;
+    tp.levels = 2;
+
+    test_init(&t, &tp, lcl_ti);
+
+    err = test_tree_create(&t);
+    ASSERT_EQ(0, err);
+
+    list_for_each_entry(tn, &t.tree->ct_nodes, tn_link) {
+        char key = 'a' + i;
+
+        if (tn->tn_nodeid == 0)
+            continue;
+
+        ASSERT_LT(i, NELEM(tnv));
+        tn->tn_route_node = route_map_insert(t.tree->ct_route_map, tn, &key, 1);
+        ASSERT_NE(NULL, tn->tn_route_node);
+
+        tnv[i] = tn;
+        rtnv[i++] = tn->tn_route_node;
+    }
+    ASSERT_EQ(NELEM(tnv), i);
+
+    ASSERT_FALSE(cn_spill_part_must_wait(tnv[0], rtnv[2]));
+
+    /* A pending split with no spill refs does not depend on our pins.
+     */
+    tnv[0]->tn_ss_splitting = true;
+    ASSERT_TRUE(cn_spill_part_must_wait(tnv[0], rtnv[2]));
+
+    atomic_inc(&tnv[0]->tn_ss_spilling);
+    ASSERT_FALSE(cn_spill_part_must_wait(tnv[0], rtnv[2]));
+    atomic_dec(&tnv[0]->tn_ss_spilling);
+    tnv[0]->tn_ss_splitting = false;
+
+    /* A join committed mid-spill whose right node is the partition's pinned
+     * end node cannot start until the spill completes, so the partition must
+     * spill into the left node rather than wait for the join.
+     */
+    atomic_inc(&tnv[2]->tn_ss_spilling);
+    tnv[1]->tn_ss_joining = -1;
+    tnv[2]->tn_ss_joining = 1;
+    ASSERT_FALSE(cn_spill_part_must_wait(tnv[1], rtnv[2]));
+
+    /* The same join does not depend on a partition ending further right,
+     * nor on the last partition.
+     */
+    ASSERT_TRUE(cn_spill_part_must_wait(tnv[1], rtnv[3]));
+    ASSERT_TRUE(cn_spill_part_must_wait(tnv[1], NULL));
+
+    /* Right nodes of a join never wait.
+     */
+    ASSERT_FALSE(cn_spill_part_must_wait(tnv[2], rtnv[3]));
+
+    tnv[1]->tn_ss_joining = 0;
+    tnv[2]->tn_ss_joining = 0;
+    atomic_dec(&tnv[2]->tn_ss_spilling);
+
+    test_tree_destroy(&t);
+}
+
 #define MY_TEST1(NAME, N1, V1, VERBOSE)                     \
     MTF_DEFINE_UTEST_PRE(test, NAME##_##N1##V1, test_setup) \
     {                                                       \
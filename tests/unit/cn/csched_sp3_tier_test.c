@@ -0,0 +1,447 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <hse/error/merr.h>
+#include <hse/ikvdb/kvdb_health.h>
+#include <hse/ikvdb/kvs_rparams.h>
+#include <hse/ikvdb/mclass_policy.h>
+#include <hse/mpool/mpool.h>
+#include <hse/util/time.h>
+
+#include <hse/test/mock/api.h>
+#include <hse/test/mtf/framework.h>
+
+#include "cn/cn_tree_create.h"
+#include "cn/csched_sp3.c"
+#include "cn/csched_sp3_work.c"
+
+/* Hot nodes are placed on staging and cold nodes on capacity.
+ */
+static struct mclass_policy tier_policy = {
+    .mc_name = "staging_capacity",
+    .mc_table = {
+        [HSE_MPOLICY_AGE_ROOT] = { HSE_MCLASS_STAGING, HSE_MCLASS_STAGING },
+        [HSE_MPOLICY_AGE_LEAF] = { HSE_MCLASS_CAPACITY, HSE_MCLASS_CAPACITY },
+    },
+};
+
+static struct mclass_policy flat_policy = {
+    .mc_name = "capacity_only",
+    .mc_table = {
+        [HSE_MPOLICY_AGE_ROOT] = { HSE_MCLASS_CAPACITY, HSE_MCLASS_CAPACITY },
+        [HSE_MPOLICY_AGE_LEAF] = { HSE_MCLASS_CAPACITY, HSE_MCLASS_CAPACITY },
+    },
+};
+
+static struct kvdb_health health;
+static struct kvs_rparams rp;
+static struct kvs_cparams cp;
+
+static uint64_t avail_bytes;
+static uint avail_calls;
+
+/* A kvset is represented by its media classes alone, which is all that
+ * placement decisions look at.
+ */
+struct fake_kvset {
+    struct kvset_list_entry fk_le;
+    enum hse_mclass fk_kmclass;
+    enum hse_mclass fk_vmclass;
+};
+
+static struct fake_kvset kvsetv[8];
+
+static enum hse_mclass
+mock_kvset_get_mclass(const struct kvset *ks, enum hse_mclass_policy_dtype dtype)
+{
+    const struct fake_kvset *fk = (const void *)ks;
+
+    return (dtype == HSE_MPOLICY_DTYPE_KEY) ? fk->fk_kmclass : fk->fk_vmclass;
+}
+
+static merr_t
+mock_mpool_mclass_avail_get(struct mpool *mp, enum hse_mclass mclass, uint64_t *avail)
+{
+    if (mclass != HSE_MCLASS_STAGING)
+        return merr(ENOENT);
+
+    avail_calls++;
+    *avail = avail_bytes;
+
+    return 0;
+}
+
+static int
+setup(struct mtf_test_info *lcl_ti)
+{
+    MOCK_SET_FN(kvset, kvset_get_mclass, mock_kvset_get_mclass);
+    MOCK_SET_FN(mpool, mpool_mclass_avail_get, mock_mpool_mclass_avail_get);
+
+    return 0;
+}
+
+static int
+teardown(struct mtf_test_info *lcl_ti)
+{
+    MOCK_UNSET_FN(kvset, kvset_get_mclass);
+    MOCK_UNSET_FN(mpool, mpool_mclass_avail_get);
+
+    return 0;
+}
+
+static int
+reset(struct mtf_test_info *lcl_ti)
+{
+    rp = kvs_rparams_defaults();
+    rp.cn_tier_hot_rate = 1000;
+
+    memset(&health, 0, sizeof(health));
+    memset(&cp, 0, sizeof(cp));
+    memset(kvsetv, 0, sizeof(kvsetv));
+
+    mapi_inject_ptr(mapi_idx_cn_get_mclass_policy, &tier_policy);
+
+    avail_bytes = UINT64_MAX;
+    avail_calls = 0;
+
+    return 0;
+}
+
+static struct cn_tree_node *
+leaf_create(struct cn_tree **tree_out)
+{
+    struct cn_tree_node *tn;
+    struct cn_tree *tree;
+    merr_t err;
+
+    err = cn_tree_create(&tree, 0, &cp, &health, &rp);
+    if (err)
+        return NULL;
+
+    tn = cn_node_alloc(tree, 1);
+    if (!tn) {
+        cn_tree_destroy(tree);
+        return NULL;
+    }
+
+    list_add_tail(&tn->tn_link, &tree->ct_nodes);
+    *tree_out = tree;
+
+    return tn;
+}
+
+static void
+leaf_destroy(struct cn_tree *tree, struct cn_tree_node *tn)
+{
+    /* The fake kvsets are not refcounted, don't let the tree put them.
+     */
+    INIT_LIST_HEAD(&tn->tn_kvset_list);
+    cn_tree_destroy(tree);
+}
+
+/* Add kvsets to a node, oldest first.  Each character of %placement gives
+ * the media class of a kvset's keys and values: 'c' for capacity, 's' for
+ * staging, and 'k' for keys on staging with no values.
+ */
+static void
+kvsets_add(struct cn_tree_node *tn, const char *placement)
+{
+    int i;
+
+    for (i = 0; placement[i]; i++) {
+        struct fake_kvset *fk = kvsetv + i;
+
+        fk->fk_kmclass = (placement[i] == 'c') ? HSE_MCLASS_CAPACITY : HSE_MCLASS_STAGING;
+        fk->fk_vmclass = (placement[i] == 'k') ? HSE_MCLASS_INVALID : fk->fk_kmclass;
+        fk->fk_le.le_kvset = (void *)fk;
+
+        list_add(&fk->fk_le.le_link, &tn->tn_kvset_list);
+    }
+}
+
+static void
+heat_update(struct sp3 *sp, struct cn_tree_node *tn, uint heat)
+{
+    atomic_set(&tn->tn_heat, heat);
+    sp3_node_heat_update(sp, tn, NSEC_PER_SEC);
+}
+
+MTF_BEGIN_UTEST_COLLECTION_PREPOST(csched_sp3_tier_test, setup, teardown);
+
+MTF_DEFINE_UTEST_PRE(csched_sp3_tier_test, kvset_misplaced, reset)
+{
+    struct cn_tree_node *tn;
+    struct cn_tree *tree;
+    struct kvset *ks;
+
+    tn = leaf_create(&tree);
+    ASSERT_NE(NULL, tn);
+
+    kvsets_add(tn, "c");
+    ks = kvsetv[0].fk_le.le_kvset;
+
+    /* A cold leaf belongs on capacity, a hot leaf and the root on staging.
+     */
+    ASSERT_FALSE(cn_tree_kvset_misplaced(tn, ks));
+    ASSERT_TRUE(cn_tree_kvset_misplaced(tree->ct_root, ks));
+
+    tn->tn_hot = true;
+    ASSERT_TRUE(cn_tree_kvset_misplaced(tn, ks));
+
+    kvsetv[0].fk_kmclass = HSE_MCLASS_STAGING;
+    ASSERT_TRUE(cn_tree_kvset_misplaced(tn, ks));
+
+    kvsetv[0].fk_vmclass = HSE_MCLASS_STAGING;
+    ASSERT_FALSE(cn_tree_kvset_misplaced(tn, ks));
+
+    /* Values that reside on the wrong media class are enough, and a kvset
+     * with no vblocks is placed by its keys alone.
+     */
+    kvsetv[0].fk_vmclass = HSE_MCLASS_CAPACITY;
+    ASSERT_TRUE(cn_tree_kvset_misplaced(tn, ks));
+
+    kvsetv[0].fk_vmclass = HSE_MCLASS_INVALID;
+    ASSERT_FALSE(cn_tree_kvset_misplaced(tn, ks));
+
+    tn->tn_hot = false;
+    ASSERT_TRUE(cn_tree_kvset_misplaced(tn, ks));
+
+    leaf_destroy(tree, tn);
+}
+
+MTF_DEFINE_UTEST_PRE(csched_sp3_tier_test, node_misplaced, reset)
+{
+    struct cn_tree_node *tn;
+    struct cn_tree *tree;
+
+    tn = leaf_create(&tree);
+    ASSERT_NE(NULL, tn);
+
+    ASSERT_EQ(0, cn_tree_node_misplaced(tn));
+
+    kvsets_add(tn, "cskcs");
+    ASSERT_EQ(3, cn_tree_node_misplaced(tn));
+
+    tn->tn_hot = true;
+    ASSERT_EQ(2, cn_tree_node_misplaced(tn));
+
+    /* With a single media class nothing is ever misplaced.
+     */
+    mapi_inject_ptr(mapi_idx_cn_get_mclass_policy, &flat_policy);
+    kvsetv[1].fk_kmclass = HSE_MCLASS_CAPACITY;
+    kvsetv[1].fk_vmclass = HSE_MCLASS_CAPACITY;
+    kvsetv[2].fk_kmclass = HSE_MCLASS_CAPACITY;
+    kvsetv[4].fk_kmclass = HSE_MCLASS_CAPACITY;
+    kvsetv[4].fk_vmclass = HSE_MCLASS_CAPACITY;
+    ASSERT_EQ(0, cn_tree_node_misplaced(tn));
+
+    leaf_destroy(tree, tn);
+}
+
+MTF_DEFINE_UTEST_PRE(csched_sp3_tier_test, heat_update_hysteresis, reset)
+{
+    struct cn_tree_node *tn;
+    struct cn_tree *tree;
+    struct sp3 *sp;
+
+    sp = calloc(1, sizeof(*sp));
+    ASSERT_NE(NULL, sp);
+
+    tn = leaf_create(&tree);
+    ASSERT_NE(NULL, tn);
+
+    /* The rate is the mean of the previous rate and the reads since the
+     * previous update, and the sampled read count is consumed.
+     */
+    heat_update(sp, tn, 4000);
+    ASSERT_EQ(2000, tn->tn_heat_rate);
+    ASSERT_EQ(0, atomic_read(&tn->tn_heat));
+    ASSERT_TRUE(tn->tn_hot);
+    ASSERT_TRUE(tn->tn_retier);
+    ASSERT_EQ(HSE_MPOLICY_AGE_ROOT, cn_tree_node_agegroup(tn));
+
+    /* A hot node stays hot until its rate drops below a quarter of the
+     * hot rate.
+     */
+    tn->tn_retier = false;
+
+    heat_update(sp, tn, 0);
+    ASSERT_EQ(1000, tn->tn_heat_rate);
+    ASSERT_TRUE(tn->tn_hot);
+
+    heat_update(sp, tn, 0);
+    ASSERT_EQ(500, tn->tn_heat_rate);
+    ASSERT_TRUE(tn->tn_hot);
+
+    heat_update(sp, tn, 0);
+    ASSERT_EQ(250, tn->tn_heat_rate);
+    ASSERT_TRUE(tn->tn_hot);
+    ASSERT_FALSE(tn->tn_retier);
+
+    heat_update(sp, tn, 0);
+    ASSERT_EQ(125, tn->tn_heat_rate);
+    ASSERT_FALSE(tn->tn_hot);
+    ASSERT_TRUE(tn->tn_retier);
+    ASSERT_EQ(HSE_MPOLICY_AGE_LEAF, cn_tree_node_agegroup(tn));
+
+    /* A cold node becomes hot only once its rate reaches the hot rate.
+     */
+    tn->tn_retier = false;
+
+    heat_update(sp, tn, 1200);
+    ASSERT_EQ(662, tn->tn_heat_rate);
+    ASSERT_FALSE(tn->tn_hot);
+    ASSERT_FALSE(tn->tn_retier);
+
+    heat_update(sp, tn, 1400);
+    ASSERT_EQ(1031, tn->tn_heat_rate);
+    ASSERT_TRUE(tn->tn_hot);
+    ASSERT_TRUE(tn->tn_retier);
+
+    /* The rate is left alone if no time has elapsed.
+     */
+    atomic_set(&tn->tn_heat, 1000000);
+    sp3_node_heat_update(sp, tn, 0);
+    ASSERT_EQ(1031, tn->tn_heat_rate);
+    ASSERT_EQ(0, atomic_read(&tn->tn_heat));
+
+    /* Disabling tiering cools every node without retiering it.
+     */
+    tn->tn_retier = false;
+    rp.cn_tier_hot_rate = 0;
+
+    heat_update(sp, tn, 4000);
+    ASSERT_FALSE(tn->tn_hot);
+    ASSERT_FALSE(tn->tn_retier);
+
+    leaf_destroy(tree, tn);
+    free(sp);
+}
+
+MTF_DEFINE_UTEST_PRE(csched_sp3_tier_test, heat_update_staging_full, reset)
+{
+    struct cn_tree_node *tn;
+    struct cn_tree *tree;
+    struct sp3 *sp;
+
+    sp = calloc(1, sizeof(*sp));
+    ASSERT_NE(NULL, sp);
+
+    tn = leaf_create(&tree);
+    ASSERT_NE(NULL, tn);
+
+    tn->tn_ns.ns_kst.kst_kalen = 64ul << 20;
+    tn->tn_ns.ns_kst.kst_valen = 960ul << 20;
+
+    /* A node is not promoted unless staging has room for twice its size.
+     */
+    avail_bytes = (2048ul << 20) - 1;
+
+    heat_update(sp, tn, 4000);
+    ASSERT_EQ(2000, tn->tn_heat_rate);
+    ASSERT_FALSE(tn->tn_hot);
+    ASSERT_FALSE(tn->tn_retier);
+    ASSERT_LT(0, avail_calls);
+
+    avail_bytes = 2048ul << 20;
+
+    heat_update(sp, tn, 2000);
+    ASSERT_TRUE(tn->tn_hot);
+    ASSERT_TRUE(tn->tn_retier);
+
+    /* A hot node is not demoted when staging fills up, and staging is not
+     * consulted when the node stays hot.
+     */
+    avail_calls = 0;
+    avail_bytes = 0;
+
+    heat_update(sp, tn, 2000);
+    ASSERT_TRUE(tn->tn_hot);
+    ASSERT_EQ(0, avail_calls);
+
+    /* Nodes are promoted regardless of free space when hot and cold nodes
+     * share a media class.
+     */
+    tn->tn_hot = false;
+    mapi_inject_ptr(mapi_idx_cn_get_mclass_policy, &flat_policy);
+
+    heat_update(sp, tn, 2000);
+    ASSERT_TRUE(tn->tn_hot);
+    ASSERT_EQ(0, avail_calls);
+
+    leaf_destroy(tree, tn);
+    free(sp);
+}
+
+MTF_DEFINE_UTEST_PRE(csched_sp3_tier_test, work_tier, reset)
+{
+    struct sp3_thresholds thresh = { .lcomp_runlen_max = 8 };
+    struct kvset_list_entry *mark;
+    struct cn_tree_node *tn;
+    struct cn_tree *tree;
+    enum cn_action action;
+    enum cn_rule rule;
+    uint runlen;
+
+    tn = leaf_create(&tree);
+    ASSERT_NE(NULL, tn);
+
+    /* The run starts at the oldest misplaced kvset and ends at the newest,
+     * including the correctly placed kvsets in between.
+     */
+    tn->tn_hot = true;
+    tn->tn_retier = true;
+    kvsets_add(tn, "sccskcss");
+
+    runlen = sp3_work_wtype_tier(tn2spn(tn), &thresh, &mark, &action, &rule);
+    ASSERT_EQ(5, runlen);
+    ASSERT_EQ(&kvsetv[1].fk_le, mark);
+    ASSERT_EQ(CN_ACTION_COMPACT_KV, action);
+    ASSERT_EQ(CN_RULE_TIER, rule);
+    ASSERT_FALSE(tn->tn_retier);
+
+    /* A node whose kvsets are all in place has no work.
+     */
+    INIT_LIST_HEAD(&tn->tn_kvset_list);
+    tn->tn_retier = true;
+    kvsets_add(tn, "ssks");
+
+    runlen = sp3_work_wtype_tier(tn2spn(tn), &thresh, &mark, &action, &rule);
+    ASSERT_EQ(0, runlen);
+    ASSERT_EQ(NULL, mark);
+    ASSERT_FALSE(tn->tn_retier);
+
+    /* Runs are limited to lcomp_runlen_max kvsets, in which case the node
+     * remains marked for retiering.
+     */
+    INIT_LIST_HEAD(&tn->tn_kvset_list);
+    tn->tn_retier = true;
+    thresh.lcomp_runlen_max = 3;
+    kvsets_add(tn, "ccccc");
+
+    runlen = sp3_work_wtype_tier(tn2spn(tn), &thresh, &mark, &action, &rule);
+    ASSERT_EQ(3, runlen);
+    ASSERT_EQ(&kvsetv[0].fk_le, mark);
+    ASSERT_TRUE(tn->tn_retier);
+
+    /* A cold node moves its kvsets from staging back to capacity.
+     */
+    tn->tn_hot = false;
+    thresh.lcomp_runlen_max = 8;
+    kvsetv[3].fk_kmclass = HSE_MCLASS_STAGING;
+    kvsetv[3].fk_vmclass = HSE_MCLASS_STAGING;
+
+    runlen = sp3_work_wtype_tier(tn2spn(tn), &thresh, &mark, &action, &rule);
+    ASSERT_EQ(1, runlen);
+    ASSERT_EQ(&kvsetv[3].fk_le, mark);
+    ASSERT_FALSE(tn->tn_retier);
+
+    leaf_destroy(tree, tn);
+}
+
+MTF_END_UTEST_COLLECTION(csched_sp3_tier_test)
@@ -15,6 +15,7 @@
 #include <hse/ikvdb/mclass_policy.h>
 #include <hse/ikvdb/tuple.h>
 #include <hse/logging/logging.h>
+#include <hse/util/workqueue.h>
 
 #include <hse/test/mock/alloc_tester.h>
 #include <hse/test/mock/mock_mpool.h>
@@ -568,4 +569,62 @@ MTF_DEFINE_UTEST_PRE(test, t_hash_set, test_setup)
     kbb_destroy(kbb);
 }
 
+MTF_DEFINE_UTEST_PRE(test, t_kbb_async_write, test_setup)
+{
+    struct workqueue_struct *wq;
+    struct kblock_builder *kbb = 0;
+    struct blk_list blks;
+    uint api = mapi_idx_mpool_mblock_alloc;
+    merr_t err;
+    uint i;
+
+    wq = alloc_workqueue("kbb_test", 0, 1, 1);
+    ASSERT_NE(NULL, wq);
+
+    mocked_rp.cn_async_write = true;
+    mapi_inject_ptr(mapi_idx_cn_get_wr_wq, wq);
+
+    /* Multiple kblocks, each one written while the next one is built */
+    err = kbb_create(KBB_CREATE_ARGS);
+    ASSERT_EQ(err, 0);
+
+    mapi_calls_clear(api);
+    for (i = 0; i < 100 * 1000; i++) {
+        err = add_entry(lcl_ti, kbb, BIG_KLEN, 0, BIG_KMDLEN, 0);
+        ASSERT_EQ(err, 0);
+        if (mapi_calls(api) == 3)
+            break;
+    }
+
+    err = kbb_finish(kbb, &blks);
+    ASSERT_EQ(err, 0);
+    ASSERT_EQ(4, blks.idc);
+
+    blk_list_free(&blks);
+    kbb_destroy(kbb);
+
+    /* A failed write is reported by the next finished kblock or by kbb_finish() */
+    err = kbb_create(KBB_CREATE_ARGS);
+    ASSERT_EQ(err, 0);
+
+    mapi_inject(mapi_idx_mpool_mblock_write, 123);
+
+    mapi_calls_clear(api);
+    for (i = 0; !err && i < 100 * 1000 && mapi_calls(api) < 2; i++) {
+        err = add_entry(lcl_ti, kbb, BIG_KLEN, 0, BIG_KMDLEN, -2);
+        ASSERT_TRUE(!err || merr_errno(err) == 123);
+    }
+
+    if (!err)
+        err = kbb_finish(kbb, &blks);
+    ASSERT_EQ(123, merr_errno(err));
+
+    mapi_inject_unset(mapi_idx_mpool_mblock_write);
+
+    kbb_destroy(kbb);
+
+    mapi_inject_unset(mapi_idx_cn_get_wr_wq);
+    destroy_workqueue(wq);
+}
+
 MTF_END_UTEST_COLLECTION(test)
@@ -171,10 +171,12 @@ static merr_t
 _kvset_builder_add_vref(
     struct kvset_builder *self,
     uint64_t seq,
+    uint64_t expire,
     uint vbidx,
     uint vboff,
     uint vlen,
-    uint complen)
+    uint complen,
+    enum vcomp_algorithm calgo)
 {
     VERIFY_EQ_RET(st.have.nvals, 0, __LINE__);
 
@@ -208,7 +210,9 @@ _kvset_builder_add_val(
     const void *vdata,
     uint vlen,
     uint64_t seq,
-    uint complen)
+    uint64_t expire,
+    uint complen,
+    enum vcomp_algorithm calgo)
 {
     VERIFY_EQ_RET(st.have.nvals, 0, __LINE__);
 
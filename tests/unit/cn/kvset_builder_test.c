@@ -133,26 +133,26 @@ MTF_DEFINE_UTEST_PREPOST(test, t_kvset_builder_add_entry1, pre, post)
      * Four flavors for add_val
      */
     /* zlen values: vlen or both vdata and vlen set to 0 */
-    err = kvset_builder_add_val(bld, &kobj, 0, 0, seq1, 0);
+    err = kvset_builder_add_val(bld, &kobj, 0, 0, seq1, 0, 0, 0);
     ASSERT_EQ(err, 0);
-    err = kvset_builder_add_val(bld, &kobj, vdata1, 0, seq1, 0);
+    err = kvset_builder_add_val(bld, &kobj, vdata1, 0, seq1, 0, 0, 0);
     ASSERT_EQ(err, 0);
     /* tombstone: vlen can be zero or non-zero */
-    err = kvset_builder_add_val(bld, &kobj, HSE_CORE_TOMB_REG, 0, seq1, 0);
+    err = kvset_builder_add_val(bld, &kobj, HSE_CORE_TOMB_REG, 0, seq1, 0, 0, 0);
     ASSERT_EQ(err, 0);
-    err = kvset_builder_add_val(bld, &kobj, HSE_CORE_TOMB_REG, vlen1, seq1, 0);
+    err = kvset_builder_add_val(bld, &kobj, HSE_CORE_TOMB_REG, vlen1, seq1, 0, 0, 0);
     ASSERT_EQ(err, 0);
     /* pfx tombstone: vlen can be zero or non-zero */
-    err = kvset_builder_add_val(bld, &kobj, HSE_CORE_TOMB_PFX, 0, seq1, 0);
+    err = kvset_builder_add_val(bld, &kobj, HSE_CORE_TOMB_PFX, 0, seq1, 0, 0, 0);
     ASSERT_EQ(err, 0);
-    err = kvset_builder_add_val(bld, &kobj, HSE_CORE_TOMB_PFX, vlen1, seq1, 0);
+    err = kvset_builder_add_val(bld, &kobj, HSE_CORE_TOMB_PFX, vlen1, seq1, 0, 0, 0);
     ASSERT_EQ(err, 0);
     /* real values */
-    err = kvset_builder_add_val(bld, &kobj, vdata1, vlen1, seq1, 0);
+    err = kvset_builder_add_val(bld, &kobj, vdata1, vlen1, seq1, 0, 0, 0);
     ASSERT_EQ(err, 0);
-    err = kvset_builder_add_val(bld, &kobj, vdata2, vlen2, seq2, 0);
+    err = kvset_builder_add_val(bld, &kobj, vdata2, vlen2, seq2, 0, 0, 0);
     ASSERT_EQ(err, 0);
-    err = kvset_builder_add_val(bld, &kobj, 0, 0, seq2, 0);
+    err = kvset_builder_add_val(bld, &kobj, 0, 0, seq2, 0, 0, 0);
     ASSERT_EQ(err, 0);
 
     /*
@@ -171,7 +171,7 @@ MTF_DEFINE_UTEST_PREPOST(test, t_kvset_builder_add_entry1, pre, post)
     /*
      * One flavor for add_vref
      */
-    err = kvset_builder_add_vref(bld, seq2, 1, 2, 3, 0);
+    err = kvset_builder_add_vref(bld, seq2, 0, 1, 2, 3, 0, 0);
     ASSERT_EQ(err, 0);
 
     /*
@@ -210,7 +210,7 @@ MTF_DEFINE_UTEST_PREPOST(test, t_kvset_builder_add_val_fail1, pre, post)
 
     api = mapi_idx_vbb_add_entry;
     mapi_inject(api, 1234);
-    err = kvset_builder_add_val(bld, &kobj, value, strlen(value), seq, 0);
+    err = kvset_builder_add_val(bld, &kobj, value, strlen(value), seq, 0, 0, 0);
     ASSERT_EQ(err, 1234);
 
     mapi_inject_unset(api);
@@ -235,7 +235,7 @@ MTF_DEFINE_UTEST_PREPOST(test, t_reserve_kmd1, pre, post)
 
     /* Add entries to exercise kmd growth */
     for (i = 0; i < 100; i++) {
-        err = kvset_builder_add_vref(bld, seq, vbidx, vboff, vlen, 0);
+        err = kvset_builder_add_vref(bld, seq, 0, vbidx, vboff, vlen, 0, 0);
         ASSERT_EQ(err, 0);
     }
 
@@ -264,7 +264,7 @@ MTF_DEFINE_UTEST_PREPOST(test, t_reserve_kmd2, pre, post)
 
     /* Add entries to kmd, eventually we should get an ENOMEM. */
     for (i = 0; i < 100; i++) {
-        err = kvset_builder_add_vref(bld, seq, vbidx, vboff, vlen, 0);
+        err = kvset_builder_add_vref(bld, seq, 0, vbidx, vboff, vlen, 0, 0);
         if (err)
             break;
     }
@@ -280,7 +280,7 @@ MTF_DEFINE_UTEST_PREPOST(test, t_reserve_kmd2, pre, post)
 
     /* Do it again with kvset_builder_add_val */
     for (i = 0; i < 100; i++) {
-        err = kvset_builder_add_val(bld, &kobj, "foobar", 6, seq, 0);
+        err = kvset_builder_add_val(bld, &kobj, "foobar", 6, seq, 0, 0, 0);
         if (err)
             break;
     }
@@ -323,7 +323,7 @@ MTF_DEFINE_UTEST_PREPOST(test, t_kvset_builder_get_mblocks, pre, post)
     ASSERT_EQ(err, 0);
     ASSERT_TRUE(bld);
 
-    err = kvset_builder_add_val(bld, &kobj, "foobar", 6, seq, 0);
+    err = kvset_builder_add_val(bld, &kobj, "foobar", 6, seq, 0, 0, 0);
     ASSERT_EQ(err, 0);
 
     key2kobj(&ko, "foobar", 6);
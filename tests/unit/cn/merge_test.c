@@ -18,6 +18,7 @@
 #include <hse/ikvdb/kvset_builder.h>
 #include <hse/ikvdb/limits.h>
 #include <hse/logging/logging.h>
+#include <hse/util/keycmp.h>
 #include <hse/util/parse_num.h>
 
 #include <hse/test/mock/api.h>
@@ -448,6 +449,9 @@ _kvset_builder_add_val_internal(
         case VTYPE_CVAL:
             tag = "c";
             break;
+        case VTYPE_ZCVAL:
+            tag = "zc";
+            break;
         case VTYPE_ZVAL:
             tag = "z";
             break;
@@ -489,10 +493,12 @@ static merr_t
 _kvset_builder_add_vref(
     struct kvset_builder *self,
     uint64_t seq,
+    uint64_t expire,
     uint vbidx_kvset_node,
     uint vboff_nth_key,
     uint vlen_nth_val,
-    uint complen)
+    uint complen,
+    enum vcomp_algorithm calgo)
 {
     uint64_t tmp_seq;
     enum kmd_vtype vtype;
@@ -527,7 +533,9 @@ _kvset_builder_add_val(
     const void *vdata,
     uint vlen,
     uint64_t seq,
-    uint complen)
+    uint64_t expire,
+    uint complen,
+    enum vcomp_algorithm calgo)
 {
     enum kmd_vtype vtype;
 
@@ -610,6 +618,7 @@ _kvset_iter_next_key(struct kv_iterator *kvi, struct key_obj *kobj, struct kvset
     /* Spill is always called with a node_dgen of 0, set the kv-pair's dgen to something larger than 0.
      */
     vc->dgen = 10;
+    vc->expire = 0;
     return 0;
 }
 
@@ -671,6 +680,7 @@ _kvset_iter_next_vref(
         *vlen_out = vlen;
         break;
     case VTYPE_CVAL:
+    case VTYPE_ZCVAL:
         /* not used by this test */
         assert(0);
         break;
@@ -724,6 +734,7 @@ _kvset_iter_val_get(
 
     switch (vtype) {
     case VTYPE_CVAL:
+    case VTYPE_ZCVAL:
         /* not used by this test */
         assert(0);
         break;
@@ -750,6 +761,30 @@ _kvset_iter_val_get(
     return merr(EBUG);
 }
 
+static merr_t
+_kvset_iter_seek(struct kv_iterator *kvi, const void *key, int len, bool *eof)
+{
+    struct kv_spill_test_kvi *iter = container_of(kvi, typeof(*iter), kvi);
+    cJSON *knode;
+    uint nvals;
+
+    iter->cursor = 0;
+
+    while (!kvset_get_nth_key(iter->kvset_node, iter->cursor, &knode, &nvals)) {
+        const char *kdata = cJSON_GetStringValue(knode);
+
+        if (keycmp(kdata, strlen(kdata), key, len) >= 0)
+            break;
+
+        ++iter->cursor;
+    }
+
+    if (eof)
+        *eof = kvset_get_nth_key(iter->kvset_node, iter->cursor, &knode, &nvals);
+
+    return 0;
+}
+
 void
 kv_spill_test_kvi_release(struct kv_iterator *kvi)
 {
@@ -812,8 +847,9 @@ kv_spill_test_kvi_create(
     return 0;
 }
 
-#define MODE_SPILL    0
-#define MODE_KCOMPACT 1
+#define MODE_SPILL       0
+#define MODE_KCOMPACT    1
+#define MODE_SPILL_PARTS 2
 
 static struct cn_compaction_work *
 init_work(
@@ -908,9 +944,12 @@ run_testcase(struct mtf_test_info *lcl_ti, int mode, const char *info)
     memset(outputs, 0, sizeof(outputs));
     memset(output_nodev, 0, sizeof(output_nodev));
 
-    if (mode == MODE_SPILL) {
+    if (mode == MODE_SPILL || mode == MODE_SPILL_PARTS) {
+        struct kv_iterator **partv = NULL;
+        struct cn_merge_stats stats = { 0 };
         struct cn_tree *tree;
         struct kvdb_health health;
+        int n = 0;
 
         struct kvs_cparams cp = {
             .pfx_len = tp.pfx_len,
@@ -950,6 +989,20 @@ run_testcase(struct mtf_test_info *lcl_ti, int mode, const char *info)
         err = cn_spill_create(&w, &sctx);
         ASSERT_EQ(0, err);
 
+        /* In partitioned mode the second half of the nodes is spilled from
+         * a partition context over a private set of iterators, which must
+         * produce exactly the same output as a spill over all nodes.
+         */
+        if (mode == MODE_SPILL_PARTS) {
+            partv = calloc(iterc, sizeof(*partv));
+            ASSERT_NE(NULL, partv);
+
+            for (i = 0; i < iterc; i++) {
+                err = kv_spill_test_kvi_create(&partv[i], &tp, i, lcl_ti);
+                ASSERT_EQ(0, err);
+            }
+        }
+
         while (1) {
             struct route_node *rtn;
 
@@ -957,6 +1010,13 @@ run_testcase(struct mtf_test_info *lcl_ti, int mode, const char *info)
             if (!rtn)
                 break;
 
+            if (partv && n++ == tp.fanout / 2) {
+                cn_spill_destroy(sctx);
+
+                err = cn_spill_create_part(&w, partv, &stats, ekey, eklen, 0, &sctx);
+                ASSERT_EQ(0, err);
+            }
+
             route_node_keycpy(rtn, ekey, sizeof(ekey), &eklen);
 
             err = cn_subspill(&subspill, sctx, 0, 0, ekey, eklen);
@@ -965,6 +1025,10 @@ run_testcase(struct mtf_test_info *lcl_ti, int mode, const char *info)
 
         cn_spill_destroy(sctx);
         cn_tree_destroy(tree);
+
+        for (i = 0; partv && i < iterc; i++)
+            kv_iterator_release(&partv[i]);
+        free(partv);
     } else {
         /* kcompact */
         struct kvset_vblk_map vbmap;
@@ -1048,9 +1112,17 @@ run_all_tcases(struct mtf_test_info *lcl_ti)
         tp.pfx_len = tp.pfx_len >= 0 ? tp.pfx_len : 0;
         run_testcase(lcl_ti, MODE_KCOMPACT, "kcompact");
 
+        tp.pfx_len = tp.pfx_len >= 0 ? tp.pfx_len : 0;
+        if (tp.fanout > 1)
+            run_testcase(lcl_ti, MODE_SPILL_PARTS, "partitioned spill");
+
         tp.pfx_len = tp.pfx_len >= 0 ? tp.pfx_len : 3;
         run_testcase(lcl_ti, MODE_SPILL, "spill with prefix");
 
+        tp.pfx_len = tp.pfx_len >= 0 ? tp.pfx_len : 3;
+        if (tp.fanout > 1)
+            run_testcase(lcl_ti, MODE_SPILL_PARTS, "partitioned spill with prefix");
+
         teardown_tcase(lcl_ti);
     }
 }
@@ -1149,6 +1221,7 @@ test_prehook(struct mtf_test_info *info)
     MOCK_SET(kvset, _kvset_iter_val_get);
     MOCK_SET(kvset, _kvset_iter_next_vref);
     MOCK_SET(kvset, _kvset_iter_kvset_get);
+    MOCK_SET(kvset, _kvset_iter_seek);
 
     /* Install kvset mocks */
     MOCK_SET(kvset_view, _kvset_get_dgen);
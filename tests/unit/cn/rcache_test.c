@@ -0,0 +1,183 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <hse/ikvdb/tuple.h>
+
+#include <hse/test/mtf/conditions.h>
+#include <hse/test/mtf/framework.h>
+
+#include "cn/rcache.h"
+
+MTF_BEGIN_UTEST_COLLECTION(rcache_test)
+
+MTF_DEFINE_UTEST(rcache_test, create_invalid)
+{
+    struct rcache *rc = NULL;
+    merr_t err;
+
+    err = rcache_create(0, &rc);
+    ASSERT_EQ(EINVAL, merr_errno(err));
+    ASSERT_EQ(NULL, rc);
+
+    err = rcache_create(4096, &rc);
+    ASSERT_EQ(EINVAL, merr_errno(err));
+
+    err = rcache_create(1ul << 20, NULL);
+    ASSERT_EQ(EINVAL, merr_errno(err));
+
+    rcache_destroy(NULL);
+}
+
+MTF_DEFINE_UTEST(rcache_test, get_put)
+{
+    struct kvs_ktuple kt, kt2;
+    struct kvs_buf vbuf;
+    struct rcache *rc;
+    char out[16];
+    uint64_t gen, vseq;
+    merr_t err;
+
+    err = rcache_create(1ul << 20, &rc);
+    ASSERT_EQ(0, err);
+
+    kvs_ktuple_init(&kt, "key1", 4);
+    kvs_ktuple_init(&kt2, "key2", 4);
+
+    vbuf.b_buf = out;
+    vbuf.b_buf_sz = sizeof(out);
+
+    ASSERT_FALSE(rcache_get(rc, &kt, 100, &vbuf, &vseq));
+
+    gen = rcache_gen(rc, &kt);
+    ASSERT_NE(0, gen);
+
+    rcache_put(rc, &kt, gen, 100, 50, 0, "value1", 6);
+
+    ASSERT_TRUE(rcache_get(rc, &kt, 100, &vbuf, &vseq));
+    ASSERT_EQ(6, vbuf.b_len);
+    ASSERT_EQ(50, vseq);
+    ASSERT_EQ(0, memcmp(out, "value1", 6));
+
+    /* Views older than the value and other keys must miss.
+     */
+    ASSERT_FALSE(rcache_get(rc, &kt, 49, &vbuf, &vseq));
+    ASSERT_FALSE(rcache_get(rc, &kt2, 100, &vbuf, &vseq));
+
+    /* A short buffer receives a truncated value and the full length.
+     */
+    vbuf.b_buf_sz = 2;
+    memset(out, 0, sizeof(out));
+    ASSERT_TRUE(rcache_get(rc, &kt, 100, &vbuf, &vseq));
+    ASSERT_EQ(6, vbuf.b_len);
+    ASSERT_EQ(0, memcmp(out, "va\0", 3));
+
+    vbuf.b_buf_sz = sizeof(out);
+
+    rcache_invalidate(rc, &kt);
+    ASSERT_FALSE(rcache_get(rc, &kt, 100, &vbuf, &vseq));
+
+    rcache_destroy(rc);
+}
+
+MTF_DEFINE_UTEST(rcache_test, stale_fill)
+{
+    struct kvs_ktuple kt;
+    struct kvs_buf vbuf;
+    struct rcache *rc;
+    char out[16];
+    uint64_t gen, vseq;
+    merr_t err;
+
+    err = rcache_create(1ul << 20, &rc);
+    ASSERT_EQ(0, err);
+
+    kvs_ktuple_init(&kt, "key1", 4);
+
+    vbuf.b_buf = out;
+    vbuf.b_buf_sz = sizeof(out);
+
+    /* An update between sampling the generation and the fill.
+     */
+    gen = rcache_gen(rc, &kt);
+    rcache_invalidate(rc, &kt);
+    rcache_put(rc, &kt, gen, 100, 50, 0, "value1", 6);
+    ASSERT_FALSE(rcache_get(rc, &kt, 100, &vbuf, &vseq));
+
+    /* A purge between sampling the generation and the fill.
+     */
+    gen = rcache_gen(rc, &kt);
+    rcache_purge(rc);
+    rcache_put(rc, &kt, gen, 100, 50, 0, "value1", 6);
+    ASSERT_FALSE(rcache_get(rc, &kt, 100, &vbuf, &vseq));
+
+    /* A fill by a view older than the newest ingested data.
+     */
+    rcache_seqno_set(rc, 200);
+    gen = rcache_gen(rc, &kt);
+    rcache_put(rc, &kt, gen, 100, 50, 0, "value1", 6);
+    ASSERT_FALSE(rcache_get(rc, &kt, 300, &vbuf, &vseq));
+
+    rcache_put(rc, &kt, gen, 200, 50, 0, "value1", 6);
+    ASSERT_TRUE(rcache_get(rc, &kt, 300, &vbuf, &vseq));
+
+    /* Expired values are never returned.
+     */
+    gen = rcache_gen(rc, &kt);
+    rcache_put(rc, &kt, gen, 200, 60, 1, "value2", 6);
+    ASSERT_FALSE(rcache_get(rc, &kt, 300, &vbuf, &vseq));
+
+    rcache_destroy(rc);
+}
+
+MTF_DEFINE_UTEST(rcache_test, evict)
+{
+    const uint nkeys = 64 * 1024;
+    struct kvs_ktuple kt, hot;
+    struct kvs_buf vbuf;
+    struct rcache *rc;
+    char key[32], out[256];
+    uint64_t vseq;
+    uint hits = 0;
+    merr_t err;
+
+    err = rcache_create(1ul << 20, &rc);
+    ASSERT_EQ(0, err);
+
+    memset(out, 0xaa, sizeof(out));
+    vbuf.b_buf = out;
+    vbuf.b_buf_sz = sizeof(out);
+
+    kvs_ktuple_init(&hot, "hot", 3);
+    rcache_put(rc, &hot, rcache_gen(rc, &hot), 1, 1, 0, out, sizeof(out));
+
+    /* Insert several times the cache capacity worth of rows while the
+     * hot row keeps getting hit.  The hot row must survive while most of
+     * the others are evicted.
+     */
+    for (uint i = 0; i < nkeys; i++) {
+        ASSERT_TRUE(rcache_get(rc, &hot, 1, &vbuf, &vseq));
+
+        snprintf(key, sizeof(key), "key%u", i);
+        kvs_ktuple_init(&kt, key, strlen(key));
+        rcache_put(rc, &kt, rcache_gen(rc, &kt), 1, 1, 0, out, sizeof(out));
+    }
+
+    ASSERT_TRUE(rcache_get(rc, &hot, 1, &vbuf, &vseq));
+
+    for (uint i = 0; i < nkeys; i++) {
+        snprintf(key, sizeof(key), "key%u", i);
+        kvs_ktuple_init(&kt, key, strlen(key));
+        hits += rcache_get(rc, &kt, 1, &vbuf, &vseq);
+    }
+
+    ASSERT_LT(hits, nkeys);
+
+    rcache_destroy(rc);
+}
+
+MTF_END_UTEST_COLLECTION(rcache_test)
@@ -0,0 +1,197 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <hse/util/key_util.h>
+
+#include <hse/test/mtf/conditions.h>
+#include <hse/test/mtf/framework.h>
+
+#include "cn/rtomb.h"
+
+static struct rtomb_set *
+add(struct rtomb_set *set, const char *start, const char *end, uint64_t seqno)
+{
+    struct rtomb_set *new;
+    struct rtomb *rt;
+    merr_t err;
+
+    err = rtomb_create(start, strlen(start), end, strlen(end), seqno, &rt);
+    if (err)
+        return NULL;
+
+    err = rtomb_set_insert(set, rt, &new);
+    rtomb_put(rt);
+    rtomb_set_put(set);
+
+    return err ? NULL : new;
+}
+
+static uint64_t
+floor_of(struct rtomb_set *set, const char *key, uint64_t view)
+{
+    struct key_obj kobj;
+
+    key2kobj(&kobj, key, strlen(key));
+
+    return rtomb_set_floor(set, &kobj, view);
+}
+
+MTF_BEGIN_UTEST_COLLECTION(rtomb_test)
+
+MTF_DEFINE_UTEST(rtomb_test, set_floor)
+{
+    struct rtomb_set *set = NULL;
+
+    /* [b, d) @10, [a, z) @20, [c, e) @30, [x, y) @40
+     */
+    set = add(set, "c", "e", 30);
+    set = add(set, "a", "z", 20);
+    set = add(set, "x", "y", 40);
+    set = add(set, "b", "d", 10);
+    ASSERT_NE(NULL, set);
+    ASSERT_EQ(4, set->rs_cnt);
+
+    /* Start keys are inclusive, end keys are exclusive.
+     */
+    ASSERT_EQ(0, floor_of(set, "0", 100));
+    ASSERT_EQ(20, floor_of(set, "a", 100));
+    ASSERT_EQ(20, floor_of(set, "b", 100));
+    ASSERT_EQ(30, floor_of(set, "c", 100));
+    ASSERT_EQ(30, floor_of(set, "dd", 100));
+    ASSERT_EQ(20, floor_of(set, "e", 100));
+    ASSERT_EQ(40, floor_of(set, "x", 100));
+    ASSERT_EQ(40, floor_of(set, "xzzz", 100));
+    ASSERT_EQ(20, floor_of(set, "y", 100));
+    ASSERT_EQ(0, floor_of(set, "z", 100));
+    ASSERT_EQ(0, floor_of(set, "zz", 100));
+
+    /* Tombstones newer than the view are ignored.
+     */
+    ASSERT_EQ(10, floor_of(set, "c", 19));
+    ASSERT_EQ(10, floor_of(set, "b", 19));
+    ASSERT_EQ(0, floor_of(set, "b", 9));
+    ASSERT_EQ(20, floor_of(set, "x", 39));
+
+    rtomb_set_put(set);
+}
+
+MTF_DEFINE_UTEST(rtomb_test, maxend)
+{
+    struct rtomb_set *set = NULL;
+    int i;
+
+    /* A long tombstone followed by many short ones which end before the
+     * key must still be found.
+     */
+    set = add(set, "a", "zz", 5);
+
+    for (i = 0; i < 100; i++) {
+        char start[8], end[8];
+
+        snprintf(start, sizeof(start), "k%03d", i);
+        snprintf(end, sizeof(end), "k%03d.", i);
+        set = add(set, start, end, 100 + i);
+    }
+    ASSERT_NE(NULL, set);
+
+    ASSERT_EQ(5, floor_of(set, "z", 1000));
+    ASSERT_EQ(150, floor_of(set, "k050", 1000));
+    ASSERT_EQ(5, floor_of(set, "k050.", 1000));
+    ASSERT_EQ(0, floor_of(set, "zz", 1000));
+
+    rtomb_set_put(set);
+}
+
+MTF_DEFINE_UTEST(rtomb_test, overlaps_pfx)
+{
+    struct rtomb_set *set = NULL;
+
+    set = add(set, "ab", "ad", 10);
+    set = add(set, "m", "mm", 20);
+    ASSERT_NE(NULL, set);
+
+    ASSERT_TRUE(rtomb_set_overlaps_pfx(set, "a", 1, 100));
+    ASSERT_TRUE(rtomb_set_overlaps_pfx(set, "ab", 2, 100));
+    ASSERT_TRUE(rtomb_set_overlaps_pfx(set, "abzz", 4, 100));
+    ASSERT_TRUE(rtomb_set_overlaps_pfx(set, "ac", 2, 100));
+    ASSERT_FALSE(rtomb_set_overlaps_pfx(set, "aa", 2, 100));
+    ASSERT_FALSE(rtomb_set_overlaps_pfx(set, "ad", 2, 100));
+    ASSERT_FALSE(rtomb_set_overlaps_pfx(set, "b", 1, 100));
+    ASSERT_TRUE(rtomb_set_overlaps_pfx(set, "ml", 2, 100));
+    ASSERT_FALSE(rtomb_set_overlaps_pfx(set, "mm", 2, 100));
+
+    /* Tombstones newer than the view are ignored.
+     */
+    ASSERT_FALSE(rtomb_set_overlaps_pfx(set, "ab", 2, 9));
+    ASSERT_TRUE(rtomb_set_overlaps_pfx(set, "m", 1, 20));
+    ASSERT_FALSE(rtomb_set_overlaps_pfx(set, "m", 1, 19));
+
+    rtomb_set_put(set);
+}
+
+MTF_DEFINE_UTEST(rtomb_test, set_remove)
+{
+    struct rtomb_set *set = NULL, *new;
+    struct rtomb *rmv[2];
+    merr_t err;
+
+    set = add(set, "a", "c", 10);
+    set = add(set, "b", "d", 20);
+    set = add(set, "e", "f", 30);
+    ASSERT_NE(NULL, set);
+
+    rmv[0] = set->rs_entv[1].re_tomb;
+    rmv[1] = set->rs_entv[2].re_tomb;
+
+    err = rtomb_set_remove(set, rmv, 2, &new);
+    ASSERT_EQ(0, err);
+    ASSERT_NE(NULL, new);
+    ASSERT_EQ(1, new->rs_cnt);
+
+    /* The old set is unchanged and still usable.
+     */
+    ASSERT_EQ(20, floor_of(set, "bb", 100));
+    ASSERT_EQ(30, floor_of(set, "e", 100));
+    rtomb_set_put(set);
+
+    ASSERT_EQ(10, floor_of(new, "bb", 100));
+    ASSERT_EQ(0, floor_of(new, "c", 100));
+    ASSERT_EQ(0, floor_of(new, "e", 100));
+
+    rmv[0] = new->rs_entv[0].re_tomb;
+
+    err = rtomb_set_remove(new, rmv, 1, &set);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(NULL, set);
+
+    rtomb_set_put(new);
+}
+
+MTF_DEFINE_UTEST(rtomb_test, full)
+{
+    struct rtomb_set *set = NULL, *new;
+    struct rtomb *rt;
+    merr_t err;
+    int i;
+
+    for (i = 0; i < RTOMB_SET_MAX; i++) {
+        set = add(set, "a", "b", i + 1);
+        ASSERT_NE(NULL, set);
+    }
+
+    err = rtomb_create("a", 1, "b", 1, 1, &rt);
+    ASSERT_EQ(0, err);
+
+    err = rtomb_set_insert(set, rt, &new);
+    ASSERT_EQ(ENOSPC, merr_errno(err));
+
+    rtomb_put(rt);
+    rtomb_set_put(set);
+}
+
+MTF_END_UTEST_COLLECTION(rtomb_test)
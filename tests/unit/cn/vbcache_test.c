@@ -0,0 +1,112 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <string.h>
+
+#include <hse/util/page.h>
+
+#include <hse/test/mtf/conditions.h>
+#include <hse/test/mtf/framework.h>
+
+#include "cn/vbcache.h"
+
+MTF_BEGIN_UTEST_COLLECTION(vbcache_test)
+
+MTF_DEFINE_UTEST(vbcache_test, create_invalid)
+{
+    struct vbcache *bc = NULL;
+    merr_t err;
+
+    err = vbcache_create(0, &bc);
+    ASSERT_EQ(EINVAL, merr_errno(err));
+    ASSERT_EQ(NULL, bc);
+
+    err = vbcache_create(PAGE_SIZE, &bc);
+    ASSERT_EQ(EINVAL, merr_errno(err));
+
+    err = vbcache_create(1ul << 20, NULL);
+    ASSERT_EQ(EINVAL, merr_errno(err));
+
+    vbcache_destroy(NULL);
+}
+
+MTF_DEFINE_UTEST(vbcache_test, get_put)
+{
+    static char buf[4 * PAGE_SIZE] HSE_ALIGNED(PAGE_SIZE);
+    static char out[4 * PAGE_SIZE] HSE_ALIGNED(PAGE_SIZE);
+    struct vbcache *bc;
+    merr_t err;
+    bool hit;
+
+    err = vbcache_create(1ul << 20, &bc);
+    ASSERT_EQ(0, err);
+
+    for (size_t i = 0; i < sizeof(buf); i++)
+        buf[i] = i / PAGE_SIZE + 1;
+
+    hit = vbcache_get(bc, 1234, PAGE_SIZE, out, sizeof(out));
+    ASSERT_FALSE(hit);
+
+    vbcache_put(bc, 1234, PAGE_SIZE, buf, sizeof(buf));
+
+    hit = vbcache_get(bc, 1234, PAGE_SIZE, out, sizeof(out));
+    ASSERT_TRUE(hit);
+    ASSERT_EQ(0, memcmp(buf, out, sizeof(buf)));
+
+    /* Sub-range of the cached pages.
+     */
+    hit = vbcache_get(bc, 1234, 2 * PAGE_SIZE, out, PAGE_SIZE);
+    ASSERT_TRUE(hit);
+    ASSERT_EQ(0, memcmp(buf + PAGE_SIZE, out, PAGE_SIZE));
+
+    /* Range extending past the cached pages, and a different mblock.
+     */
+    hit = vbcache_get(bc, 1234, 3 * PAGE_SIZE, out, 3 * PAGE_SIZE);
+    ASSERT_FALSE(hit);
+
+    hit = vbcache_get(bc, 1235, PAGE_SIZE, out, PAGE_SIZE);
+    ASSERT_FALSE(hit);
+
+    vbcache_destroy(bc);
+}
+
+MTF_DEFINE_UTEST(vbcache_test, evict)
+{
+    static char buf[PAGE_SIZE] HSE_ALIGNED(PAGE_SIZE);
+    const size_t npages = 256;
+    struct vbcache *bc;
+    uint hits = 0;
+    merr_t err;
+
+    err = vbcache_create(npages * PAGE_SIZE, &bc);
+    ASSERT_EQ(0, err);
+
+    /* Insert several times the cache capacity worth of pages while one hot
+     * page keeps getting hit.  The hot page must survive while most of the
+     * others are evicted.
+     */
+    memset(buf, 0xaa, sizeof(buf));
+    vbcache_put(bc, 1, 0, buf, PAGE_SIZE);
+
+    for (uint i = 0; i < npages; i++) {
+        ASSERT_TRUE(vbcache_get(bc, 1, 0, buf, PAGE_SIZE));
+
+        memset(buf, i, sizeof(buf));
+        vbcache_put(bc, 2, (size_t)i * PAGE_SIZE, buf, PAGE_SIZE);
+        vbcache_put(bc, 3, (size_t)i * PAGE_SIZE, buf, PAGE_SIZE);
+    }
+
+    ASSERT_TRUE(vbcache_get(bc, 1, 0, buf, PAGE_SIZE));
+    ASSERT_EQ((char)0xaa, buf[0]);
+
+    for (uint i = 0; i < npages; i++)
+        hits += vbcache_get(bc, 2, (size_t)i * PAGE_SIZE, buf, PAGE_SIZE);
+
+    ASSERT_LT(hits, npages);
+
+    vbcache_destroy(bc);
+}
+
+MTF_END_UTEST_COLLECTION(vbcache_test)
@@ -4,6 +4,7 @@
  */
 
 #include <stdint.h>
+#include <unistd.h>
 
 #include <hse/limits.h>
 
@@ -14,6 +15,7 @@
 #include <hse/ikvdb/tuple.h>
 #include <hse/logging/logging.h>
 #include <hse/util/page.h>
+#include <hse/util/workqueue.h>
 
 #include <hse/test/mock/alloc_tester.h>
 #include <hse/test/mock/mock_mpool.h>
@@ -70,6 +72,7 @@ test_setup(struct mtf_test_info *lcl_ti)
 
     mapi_inject_ptr(mapi_idx_cn_get_rp, &kvsrp);
     mapi_inject_ptr(mapi_idx_cn_get_mclass_policy, &mocked_mpolicy);
+    mapi_inject_ptr(mapi_idx_cn_get_wr_wq, NULL);
 
     mapi_inject(mapi_idx_cn_get_cnid, 1001);
     mapi_inject(mapi_idx_cn_get_mpool, 0);
@@ -444,6 +447,166 @@ MTF_DEFINE_UTEST_PRE(test, t_vbb_finish_fail_mblock_write, test_setup)
     vbb_destroy(vbb);
 }
 
+/* Records the buffer of each mblock write and appends it to the mocked
+ * mblock, after a delay that gives the builder every chance to touch a
+ * buffer that is still being written.
+ */
+static void *wr_bufv[256];
+static uint wr_bufc;
+
+static merr_t
+mblock_write_delayed(struct mpool *mp, uint64_t id, const struct iovec *iov, int iovc)
+{
+    size_t wlen;
+    void *base;
+    merr_t err;
+    int i;
+
+    usleep(1000);
+
+    if (wr_bufc < NELEM(wr_bufv))
+        wr_bufv[wr_bufc] = iov[0].iov_base;
+    wr_bufc++;
+
+    err = mpm_mblock_get_base(id, &base, &wlen);
+    if (err)
+        return err;
+
+    for (i = 0; i < iovc; i++) {
+        err = mpm_mblock_write(id, iov[i].iov_base, wlen, iov[i].iov_len);
+        if (err)
+            return err;
+        wlen += iov[i].iov_len;
+    }
+
+    return 0;
+}
+
+MTF_DEFINE_UTEST_PRE(test, t_vbb_async_write, test_setup)
+{
+    struct workqueue_struct *wq;
+    struct vblock_builder *vbb = 0;
+    struct blk_list blks;
+    static struct {
+        uint vbidx;
+        uint vboff;
+        uint base;
+    } entv[2048];
+    const uint vlen = 50 * 1000;
+    const uint nentries = 2 * (MPOOL_MBLOCK_SIZE_DEFAULT / vlen) + 10;
+    char *vbuf;
+    uint64_t vbid;
+    merr_t err;
+    uint i;
+
+    ASSERT_LE(nentries, NELEM(entv));
+
+    wq = alloc_workqueue("vbb_test", 0, 1, 1);
+    ASSERT_NE(NULL, wq);
+
+    vbuf = mapi_safe_malloc(vlen);
+    ASSERT_NE(NULL, vbuf);
+
+    mapi_inject_ptr(mapi_idx_cn_get_wr_wq, wq);
+    MOCK_SET_FN(mpool, mpool_mblock_write, mblock_write_delayed);
+
+    /* Three vblocks, each buffer written while the next one is filled.
+     * The builder alternates between its two buffers, and no value is
+     * clobbered by the buffer swap.
+     */
+    err = vbb_create(VBB_CREATE_ARGS);
+    ASSERT_EQ(err, 0);
+
+    wr_bufc = 0;
+    for (i = 0; i < nentries; i++) {
+        entv[i].base = (7 * salt++) % (WORKBUF_SIZE - vlen - 1);
+
+        err = vbb_add_entry(
+            vbb, &max_kobj, workbuf + entv[i].base, vlen, &vbid, &entv[i].vbidx, &entv[i].vboff);
+        ASSERT_EQ(err, 0);
+    }
+
+    err = vbb_finish(vbb, &blks, &max_kobj);
+    ASSERT_EQ(err, 0);
+    ASSERT_EQ(3, blks.idc);
+
+    ASSERT_GT(wr_bufc, 2);
+    ASSERT_LE(wr_bufc, NELEM(wr_bufv));
+    ASSERT_NE(wr_bufv[0], wr_bufv[1]);
+    for (i = 2; i < wr_bufc; i++)
+        ASSERT_EQ(wr_bufv[i % 2], wr_bufv[i]);
+
+    for (i = 0; i < nentries; i++) {
+        err = mpm_mblock_read(blks.idv[entv[i].vbidx], vbuf, entv[i].vboff, vlen);
+        ASSERT_EQ(err, 0);
+        ASSERT_EQ(0, memcmp(workbuf + entv[i].base, vbuf, vlen));
+    }
+
+    blk_list_free(&blks);
+    vbb_destroy(vbb);
+
+    /* Destroy with a write in flight, both before and after the builder's
+     * own buffer has been handed off.  vbb_destroy() must wait for the
+     * write and free the right buffers in either case.
+     */
+    for (i = 1; i <= 2; i++) {
+        uint j;
+
+        err = vbb_create(VBB_CREATE_ARGS);
+        ASSERT_EQ(err, 0);
+
+        /* Each full-size value fills the write buffer exactly. */
+        wr_bufc = 0;
+        for (j = 0; j < i; j++) {
+            err = add_entry(lcl_ti, vbb, HSE_KVS_VALUE_LEN_MAX, 0);
+            ASSERT_EQ(err, 0);
+        }
+
+        vbb_destroy(vbb);
+        ASSERT_EQ(i, wr_bufc);
+    }
+
+    /* A failed write is reported by the next write of the builder */
+    err = vbb_create(VBB_CREATE_ARGS);
+    ASSERT_EQ(err, 0);
+
+    mapi_inject(mapi_idx_mpool_mblock_write, 666);
+
+    for (i = 0; !err && i < nentries; i++) {
+        err = add_entry(lcl_ti, vbb, vlen, -2);
+        ASSERT_TRUE(!err || merr_errno(err) == 666);
+    }
+
+    /* The value that filled the first buffer was added without error. */
+    ASSERT_EQ(666, merr_errno(err));
+    ASSERT_GT((i - 1) * vlen, 1 << 20);
+
+    mapi_inject_unset(mapi_idx_mpool_mblock_write);
+
+    vbb_destroy(vbb);
+
+    /* ... or by vbb_finish() */
+    err = vbb_create(VBB_CREATE_ARGS);
+    ASSERT_EQ(err, 0);
+
+    err = add_entry(lcl_ti, vbb, vlen, 0);
+    ASSERT_EQ(err, 0);
+
+    mapi_inject(mapi_idx_mpool_mblock_write, 666);
+
+    err = vbb_finish(vbb, &blks, &max_kobj);
+    ASSERT_EQ(666, merr_errno(err));
+
+    mapi_inject_unset(mapi_idx_mpool_mblock_write);
+
+    vbb_destroy(vbb);
+
+    mock_mpool_set();
+    mapi_inject_unset(mapi_idx_cn_get_wr_wq);
+    destroy_workqueue(wq);
+    free(vbuf);
+}
+
 static int
 check_err(struct mtf_test_info *lcl_ti, merr_t err, int expected_errno)
 {
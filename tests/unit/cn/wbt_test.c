@@ -7,6 +7,7 @@
 
 #include <hse/limits.h>
 
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/util/keycmp.h>
 #include <hse/util/page.h>
 
@@ -32,6 +33,7 @@ size_t kmd_used;
 struct wbb *wbb;
 uint wbt_pgc;
 uint max_pgc = 1024;
+enum wbt_leaf_enc leaf_enc = WBT_LEAF_ENC_PLAIN;
 
 /* Raw list of keys. Use key_iter to iterate through the buffer. */
 struct key_list {
@@ -81,7 +83,7 @@ MTF_BEGIN_UTEST_COLLECTION_PREPOST(wbt_test, pre_collection, post_collection)
 int
 pre_test(struct mtf_test_info *lcl_ti)
 {
-    wbb_create(&wbb, max_pgc, &wbt_pgc);
+    wbb_create(&wbb, max_pgc, &wbt_pgc, leaf_enc);
     rtree = ref_tree_create();
 
     kmd_used = 0;
@@ -155,7 +157,7 @@ tree_construct(struct mtf_test_info *lcl_ti, void **tree_out, struct wbt_hdr_omf
         bool added = false;
 
         key2kobj(&ko, k->kdata, k->klen);
-        kmd_add_zval(kmd, &kmd_used, 1);
+        kmd_add_zval(kmd, &kmd_used, 1, 0);
 
         /* [HSE_REVISIT] mapi break initialization of added.
          */
@@ -182,7 +184,8 @@ cursor_verify(
     void *tree,
     struct wbt_hdr_omf *hdr,
     struct key_list *kl,
-    bool reverse)
+    bool reverse,
+    bool fence)
 {
     struct kvs_mblk_desc kbd = {
         .map_base = tree,
@@ -196,6 +199,7 @@ cursor_verify(
         .wbd_leaf = omf_wbt_leaf(hdr),
         .wbd_leaf_cnt = omf_wbt_leaf_cnt(hdr),
         .wbd_kmd_pgc = omf_wbt_kmd_pgc(hdr),
+        .wbd_lfc = omf_wbt_flags(hdr) & WBT_FLAGS_LFC,
     };
 
     struct wbti *wbti;
@@ -206,6 +210,11 @@ cursor_verify(
     int i;
     struct key_iter *k = kl->buf;
 
+    if (fence) {
+        merr_t err = wbtr_fence_create(tree, &wbd);
+        ASSERT_EQ_RET(0, err, 1);
+    }
+
     k = kl->buf;
     for (i = 0; i < kl->nkeys; i++) {
         int rc;
@@ -252,11 +261,18 @@ cursor_verify(
         k = key_iter_next(k);
     }
 
+    wbtr_fence_destroy(&wbd);
+
     return 0;
 }
 
 int
-get_verify(struct mtf_test_info *lcl_ti, void *tree, struct wbt_hdr_omf *hdr, struct key_list *kl)
+get_verify(
+    struct mtf_test_info *lcl_ti,
+    void *tree,
+    struct wbt_hdr_omf *hdr,
+    struct key_list *kl,
+    bool fence)
 {
     struct kvs_mblk_desc kbd = {
         .map_base = tree,
@@ -270,6 +286,7 @@ get_verify(struct mtf_test_info *lcl_ti, void *tree, struct wbt_hdr_omf *hdr, st
         .wbd_leaf = omf_wbt_leaf(hdr),
         .wbd_leaf_cnt = omf_wbt_leaf_cnt(hdr),
         .wbd_kmd_pgc = omf_wbt_kmd_pgc(hdr),
+        .wbd_lfc = omf_wbt_flags(hdr) & WBT_FLAGS_LFC,
     };
 
     struct kvs_ktuple kt;
@@ -280,6 +297,11 @@ get_verify(struct mtf_test_info *lcl_ti, void *tree, struct wbt_hdr_omf *hdr, st
     struct kvs_vtuple_ref vref;
     struct key_iter *k = kl->buf;
 
+    if (fence) {
+        merr_t err = wbtr_fence_create(tree, &wbd);
+        ASSERT_EQ_RET(0, err, 1);
+    }
+
     k = kl->buf;
     for (i = 0; i < kl->nkeys; i++) {
         merr_t err;
@@ -302,6 +324,8 @@ get_verify(struct mtf_test_info *lcl_ti, void *tree, struct wbt_hdr_omf *hdr, st
         k = key_iter_next(k);
     }
 
+    wbtr_fence_destroy(&wbd);
+
     return 0;
 }
 
@@ -317,12 +341,18 @@ load_and_test(struct mtf_test_info *lcl_ti, struct key_list *kl)
 
     /* Step 2: Verify keys by seeking to and reading each key that was inserted.
      */
-    cursor_verify(lcl_ti, tree, &hdr, kl, false);
-    cursor_verify(lcl_ti, tree, &hdr, kl, true);
+    cursor_verify(lcl_ti, tree, &hdr, kl, false, false);
+    cursor_verify(lcl_ti, tree, &hdr, kl, true, false);
 
     /* Step 3: Verify keys using a point get.
      */
-    get_verify(lcl_ti, tree, &hdr, kl);
+    get_verify(lcl_ti, tree, &hdr, kl, false);
+
+    /* Step 4: Repeat with the leaf fence index enabled.
+     */
+    cursor_verify(lcl_ti, tree, &hdr, kl, false, true);
+    cursor_verify(lcl_ti, tree, &hdr, kl, true, true);
+    get_verify(lcl_ti, tree, &hdr, kl, true);
 
     free(tree);
 
@@ -570,4 +600,177 @@ MTF_DEFINE_UTEST_PREPOST(wbt_test, skip_keys, pre_test, post_test)
     free(ql.buf);
 }
 
+/* Build a wbtree from keys with long common prefixes with both plain and
+ * encoded leaves, check that the encoded tree needs fewer leaves, then
+ * verify the encoded tree.
+ */
+int
+leaf_enc_test(struct mtf_test_info *lcl_ti, enum wbt_leaf_enc enc, size_t nkeys, size_t klen)
+{
+    char buf[HSE_KVS_KEY_LEN_MAX];
+    struct wbt_hdr_omf hdr;
+    uint plain_leafc;
+    void *tree;
+    merr_t err;
+    int i, rc;
+
+    memset(buf, 0xfe, sizeof(buf));
+
+    for (i = 0; i < nkeys; i++) {
+        bool added;
+
+        snprintf(buf, sizeof(buf), "tenant-0042/table-0007/row-%016d", i);
+        added = add_key(&key_list, buf, klen);
+        ASSERT_TRUE_RET(added, 1);
+        added = ref_tree_insert(rtree, buf, klen, 0);
+        ASSERT_TRUE_RET(added, 1);
+    }
+
+    rc = tree_construct(lcl_ti, &tree, &hdr);
+    ASSERT_EQ_RET(0, rc, 1);
+    ASSERT_EQ_RET(0, omf_wbt_flags(&hdr) & WBT_FLAGS_LFC, 1);
+    plain_leafc = omf_wbt_leaf_cnt(&hdr);
+    free(tree);
+
+    wbb_destroy(wbb);
+    err = wbb_create(&wbb, max_pgc, &wbt_pgc, enc);
+    ASSERT_EQ_RET(0, err, 1);
+
+    rc = tree_construct(lcl_ti, &tree, &hdr);
+    ASSERT_EQ_RET(0, rc, 1);
+    ASSERT_NE_RET(0, omf_wbt_flags(&hdr) & WBT_FLAGS_LFC, 1);
+    ASSERT_LT_RET(omf_wbt_leaf_cnt(&hdr), plain_leafc, 1);
+    free(tree);
+
+    wbb_destroy(wbb);
+    err = wbb_create(&wbb, max_pgc, &wbt_pgc, enc);
+    ASSERT_EQ_RET(0, err, 1);
+
+    return load_and_test(lcl_ti, &key_list);
+}
+
+MTF_DEFINE_UTEST_PREPOST(wbt_test, delta_leaves, pre_test, post_test)
+{
+    int rc;
+
+    rc = leaf_enc_test(lcl_ti, WBT_LEAF_ENC_DELTA, 20 * 1000, 64);
+    ASSERT_EQ(0, rc);
+}
+
+MTF_DEFINE_UTEST_PREPOST(wbt_test, lz4_leaves, pre_test, post_test)
+{
+    int rc;
+
+    rc = leaf_enc_test(lcl_ti, WBT_LEAF_ENC_LZ4, 20 * 1000, 64);
+    ASSERT_EQ(0, rc);
+}
+
+MTF_DEFINE_UTEST_PREPOST(wbt_test, zstd_leaves, pre_test, post_test)
+{
+    int rc;
+
+    if (!vcomp_compress_ops[VCOMP_ALGO_ZSTD])
+        return;
+
+    rc = leaf_enc_test(lcl_ti, WBT_LEAF_ENC_ZSTD, 20 * 1000, 64);
+    ASSERT_EQ(0, rc);
+}
+
+MTF_DEFINE_UTEST_PREPOST(wbt_test, lz4_leaves_long_keys, pre_test, post_test)
+{
+    int rc;
+
+    /* Keys of nearly maximum length exercise the admission checks.
+     */
+    rc = leaf_enc_test(lcl_ti, WBT_LEAF_ENC_LZ4, 2000, HSE_KVS_KEY_LEN_MAX);
+    ASSERT_EQ(0, rc);
+}
+
+/* Iterate over the whole tree and return the number of keys seen, leaving
+ * the iterator's readahead state in %ra_lo and %ra_nodes.
+ */
+int
+readahead_scan(
+    struct mtf_test_info *lcl_ti,
+    void *tree,
+    struct wbt_desc *wbd,
+    bool reverse,
+    bool readahead,
+    uint32_t *ra_lo,
+    uint16_t *ra_nodes)
+{
+    struct wbti *wbti;
+    const void *kdata, *kmd_read;
+    uint klen;
+    merr_t err;
+    int cnt = 0;
+
+    err = wbti_create(&wbti, tree, wbd, NULL, reverse, readahead);
+    ASSERT_EQ_RET(0, err, -1);
+
+    while (wbti_next(wbti, &kdata, &klen, &kmd_read))
+        cnt++;
+
+    *ra_lo = wbti->ra_lo;
+    *ra_nodes = wbti->ra_nodes;
+    wbti_destroy(wbti);
+
+    return cnt;
+}
+
+MTF_DEFINE_UTEST_PREPOST(wbt_test, reverse_readahead, pre_test, post_test)
+{
+    const int nkeys = 20 * 1000;
+    char buf[64];
+    struct wbt_hdr_omf hdr;
+    struct wbt_desc wbd;
+    uint16_t ra_nodes;
+    uint32_t ra_lo;
+    void *tree;
+    int i, rc;
+
+    for (i = 0; i < nkeys; i++) {
+        bool added;
+
+        snprintf(buf, sizeof(buf), "key-%020d", i);
+        added = add_key(&key_list, buf, sizeof(buf));
+        ASSERT_TRUE(added);
+    }
+
+    rc = tree_construct(lcl_ti, &tree, &hdr);
+    ASSERT_EQ(0, rc);
+
+    memset(&wbd, 0, sizeof(wbd));
+    wbd.wbd_n_pages = wbt_pgc;
+    wbd.wbd_version = WBT_TREE_VERSION;
+    wbd.wbd_root = omf_wbt_root(&hdr);
+    wbd.wbd_leaf = omf_wbt_leaf(&hdr);
+    wbd.wbd_leaf_cnt = omf_wbt_leaf_cnt(&hdr);
+    wbd.wbd_kmd_pgc = omf_wbt_kmd_pgc(&hdr);
+    wbd.wbd_lfc = omf_wbt_flags(&hdr) & WBT_FLAGS_LFC;
+    ASSERT_GT(wbd.wbd_leaf_cnt, 64);
+
+    /* A reverse scan with readahead advises every leaf below its
+     * starting point, in windows which grow up to a bounded size.
+     */
+    rc = readahead_scan(lcl_ti, tree, &wbd, true, true, &ra_lo, &ra_nodes);
+    ASSERT_EQ(nkeys, rc);
+    ASSERT_EQ(wbd.wbd_leaf, ra_lo);
+    ASSERT_GT(ra_nodes, 4);
+    ASSERT_LE(ra_nodes, 32);
+
+    /* Without readahead, or when scanning forward, nothing is advised.
+     */
+    rc = readahead_scan(lcl_ti, tree, &wbd, true, false, &ra_lo, &ra_nodes);
+    ASSERT_EQ(nkeys, rc);
+    ASSERT_EQ(0, ra_nodes);
+    ASSERT_EQ(wbd.wbd_leaf + wbd.wbd_leaf_cnt - 1, ra_lo);
+
+    rc = readahead_scan(lcl_ti, tree, &wbd, false, true, &ra_lo, &ra_nodes);
+    ASSERT_EQ(nkeys, rc);
+    ASSERT_EQ(0, ra_nodes);
+
+    free(tree);
+}
+
 MTF_END_UTEST_COLLECTION(wbt_test)
@@ -915,4 +915,69 @@ MTF_DEFINE_UTEST_PREPOST(cndb_test, only_deletes_rollforward, test_pre, test_pos
     ASSERT_EQ(1, g_cb_ctr); /* Only kvsetid1 */
 }
 
+static merr_t
+rtomb_cb(void *ctx, uint64_t seqno, const void *start, uint32_t slen, const void *end, uint32_t elen)
+{
+    uint64_t *seqnov = ctx;
+
+    if (slen != 1 || elen != 1 || *(const char *)start + 1 != *(const char *)end)
+        return merr(EINVAL);
+
+    seqnov[*(const char *)start - 'a'] = seqno;
+
+    return 0;
+}
+
+MTF_DEFINE_UTEST_PREPOST(cndb_test, rtomb_replay, test_pre, test_post)
+{
+    struct kvdb_rparams rp = kvdb_rparams_defaults();
+    uint64_t seqno_out, ingestid_out, txhorizon_out;
+    struct mpool *mp = (void *)-1;
+    uint64_t seqnov[3] = { 0 };
+    merr_t err;
+
+    err = cndb_record_rtomb_add(cndb, cnid, 100, "a", 1, "b", 1);
+    ASSERT_EQ(0, err);
+
+    err = cndb_record_rtomb_add(cndb, cnid, 200, "b", 1, "c", 1);
+    ASSERT_EQ(0, err);
+
+    err = cndb_record_rtomb_add(cndb, cnid + 1, 300, "c", 1, "d", 1);
+    ASSERT_EQ(EPROTO, merr_errno(err));
+
+    /* The first tombstone survives a compaction of the log, the second
+     * one is retired after it.
+     */
+    err = cndb_compact(cndb);
+    ASSERT_EQ(0, err);
+
+    err = cndb_record_rtomb_add(cndb, cnid, 300, "c", 1, "d", 1);
+    ASSERT_EQ(0, err);
+
+    err = cndb_record_rtomb_del(cndb, cnid, 200);
+    ASSERT_EQ(0, err);
+
+    err = cndb_record_rtomb_del(cndb, cnid, 200);
+    ASSERT_EQ(EPROTO, merr_errno(err));
+
+    err = cndb_close(cndb);
+    ASSERT_EQ(0, err);
+
+    err = cndb_open(mp, 0, 0, &rp, &cndb);
+    ASSERT_EQ(0, err);
+
+    err = cndb_replay(cndb, &seqno_out, &ingestid_out, &txhorizon_out);
+    ASSERT_EQ(0, err);
+
+    /* Tombstone seqnos must not be reused after a restart.
+     */
+    ASSERT_EQ(300, seqno_out);
+
+    err = cndb_cn_rtombs(cndb, cnid, seqnov, rtomb_cb);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(100, seqnov[0]);
+    ASSERT_EQ(0, seqnov[1]);
+    ASSERT_EQ(300, seqnov[2]);
+}
+
 MTF_END_UTEST_COLLECTION(cndb_test)
@@ -1852,6 +1852,82 @@ MTF_DEFINE_UTEST_PREPOST(ikvdb_test, kvdb_parallel_kvs_makes, test_pre, test_pos
     ASSERT_EQ(0, err);
 }
 
+struct seqno_set_info {
+    struct ikvdb *h;
+    uint64_t base;
+    int idx;
+    int nthreads;
+    pthread_t tid;
+};
+
+#define SEQNO_SET_STEPS (10000)
+
+void *
+parallel_seqno_set(void *arg)
+{
+    struct seqno_set_info *info = arg;
+    int i;
+
+    /* Odd threads walk their seqnos downward so that they keep trying to
+     * move the kvdb seqno back below what the others have already set.
+     */
+    for (i = 0; i < SEQNO_SET_STEPS; i++) {
+        int step = (info->idx & 1) ? SEQNO_SET_STEPS - 1 - i : i;
+
+        ikvdb_wal_replay_seqno_set(info->h, info->base + step * info->nthreads + info->idx);
+    }
+
+    return 0;
+}
+
+MTF_DEFINE_UTEST_PREPOST(ikvdb_test, wal_replay_seqno_set, test_pre, test_post)
+{
+    const int num_threads = max_t(int, get_nprocs(), 4);
+    struct seqno_set_info infov[num_threads];
+    const char * const paramv[] = { "c0_diag_mode=true" };
+    struct kvdb_rparams params = kvdb_rparams_defaults();
+    uint64_t base, maxseqno;
+    struct ikvdb *h;
+    merr_t err;
+    int i, rc;
+
+    err = kvdb_rparams_from_paramv(&params, NELEM(paramv), paramv);
+    ASSERT_EQ(0, err);
+
+    err = ikvdb_open(__func__, &params, &h);
+    ASSERT_EQ(0, err);
+    ASSERT_NE(NULL, h);
+
+    base = ikvdb_horizon(h) + 1;
+    maxseqno = base + (uint64_t)SEQNO_SET_STEPS * num_threads - 1;
+
+    for (i = 0; i < num_threads; ++i) {
+        infov[i].h = h;
+        infov[i].base = base;
+        infov[i].idx = i;
+        infov[i].nthreads = num_threads;
+
+        rc = pthread_create(&infov[i].tid, 0, parallel_seqno_set, infov + i);
+        ASSERT_EQ(0, rc);
+    }
+
+    for (i = 0; i < num_threads; ++i) {
+        rc = pthread_join(infov[i].tid, 0);
+        ASSERT_EQ(0, rc);
+    }
+
+    /* With no views open the horizon is the kvdb seqno, which must be the
+     * largest seqno set by any thread regardless of the interleaving.
+     */
+    ASSERT_EQ(maxseqno, ikvdb_horizon(h));
+
+    ikvdb_wal_replay_seqno_set(h, base);
+    ASSERT_EQ(maxseqno, ikvdb_horizon(h));
+
+    err = ikvdb_close(h);
+    ASSERT_EQ(0, err);
+}
+
 MTF_DEFINE_UTEST_PREPOST(ikvdb_test, prefix_delete_test, test_pre, test_post)
 {
     merr_t err;
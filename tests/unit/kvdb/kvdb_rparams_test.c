@@ -3,6 +3,8 @@
  * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
  */
 
+#include "build_config.h"
+
 #include <stdarg.h>
 
 #include <hse/config/params.h>
@@ -17,6 +19,12 @@ MTF_BEGIN_UTEST_COLLECTION(kvdb_rparams_test)
 
 struct kvdb_rparams params;
 
+#ifdef HAVE_IO_URING
+static const bool have_io_uring = true;
+#else
+static const bool have_io_uring = false;
+#endif
+
 int
 test_pre(struct mtf_test_info *ti)
 {
@@ -840,6 +848,63 @@ MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, cn_io_threads, test_pre)
     ASSERT_EQ(256, ps->ps_bounds.as_uscalar.ps_max);
 }
 
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, cn_spill_threads, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_spill_threads");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U16, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, cn_spill_threads), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint16_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(8, params.cn_spill_threads);
+    ASSERT_EQ(1, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(256, ps->ps_bounds.as_uscalar.ps_max);
+}
+
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, get_threaded_workers, test_pre)
+{
+    const struct param_spec *ps = ps_get("get_threaded_workers");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U16, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, get_threaded_workers), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint16_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(8, params.get_threaded_workers);
+    ASSERT_EQ(1, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(256, ps->ps_bounds.as_uscalar.ps_max);
+}
+
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, cn_vbcache_mb, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_vbcache_mb");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, cn_vbcache_mb), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(0, params.cn_vbcache_mb);
+    ASSERT_EQ(0, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(1024 * 1024, ps->ps_bounds.as_uscalar.ps_max);
+}
+
 MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, cndb_compact_hwm_pct, test_pre)
 {
     const struct param_spec *ps = ps_get("cndb_compact_hwm_pct");
@@ -929,6 +994,62 @@ MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, storage_pmem_directio_enabled, test_pre)
     ASSERT_EQ(true, params.dio_enable[HSE_MCLASS_PMEM]);
 }
 
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, storage_capacity_io_uring_enabled, test_pre)
+{
+    const struct param_spec *ps = ps_get("storage.capacity.io_uring.enabled");
+    merr_t err;
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_BOOL, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, uring_enable[HSE_MCLASS_CAPACITY]), ps->ps_offset);
+    ASSERT_EQ(sizeof(bool), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_NE((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(false, params.uring_enable[HSE_MCLASS_CAPACITY]);
+
+    /* clang-format off */
+    err = check(
+        "storage.capacity.io_uring.enabled=false", true,
+        "storage.capacity.io_uring.enabled=true", have_io_uring,
+        NULL
+    );
+    /* clang-format on */
+
+    ASSERT_EQ(0, merr_errno(err));
+}
+
+MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, storage_staging_io_uring_enabled, test_pre)
+{
+    const struct param_spec *ps = ps_get("storage.staging.io_uring.enabled");
+    merr_t err;
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_BOOL, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvdb_rparams, uring_enable[HSE_MCLASS_STAGING]), ps->ps_offset);
+    ASSERT_EQ(sizeof(bool), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_NE((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(false, params.uring_enable[HSE_MCLASS_STAGING]);
+
+    /* clang-format off */
+    err = check(
+        "storage.staging.io_uring.enabled=false", true,
+        "storage.staging.io_uring.enabled=true", have_io_uring,
+        NULL
+    );
+    /* clang-format on */
+
+    ASSERT_EQ(0, merr_errno(err));
+}
+
 MTF_DEFINE_UTEST_PRE(kvdb_rparams_test, mclass_policies, test_pre)
 {
     /* [HSE_REVISIT]: mclass_policies has its own test. It should maybe be moved
@@ -272,6 +272,42 @@ MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_compact_kblk_ra, test_pre)
     ASSERT_EQ(2 << MB_SHIFT, ps->ps_bounds.as_uscalar.ps_max);
 }
 
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_spill_parts, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_spill_parts");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL | PARAM_WRITABLE, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U8, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, cn_spill_parts), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint8_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(4, params.cn_spill_parts);
+    ASSERT_EQ(1, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(16, ps->ps_bounds.as_uscalar.ps_max);
+}
+
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_async_write, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_async_write");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL | PARAM_WRITABLE, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_BOOL, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, cn_async_write), ps->ps_offset);
+    ASSERT_EQ(sizeof(bool), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(true, params.cn_async_write);
+}
+
 MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_capped_ttl, test_pre)
 {
     const struct param_spec *ps = ps_get("cn_capped_ttl");
@@ -346,6 +382,42 @@ MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_cursor_kra, test_pre)
     ASSERT_EQ(false, params.cn_cursor_kra);
 }
 
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_cursor_rev_kra, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_cursor_rev_kra");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_BOOL, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, cn_cursor_rev_kra), ps->ps_offset);
+    ASSERT_EQ(sizeof(bool), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(true, params.cn_cursor_rev_kra);
+}
+
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_cursor_rev_vra, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_cursor_rev_vra");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U64, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, cn_cursor_rev_vra), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint64_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(256 * 1024, params.cn_cursor_rev_vra);
+    ASSERT_EQ(0, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(UINT64_MAX, ps->ps_bounds.as_uscalar.ps_max);
+}
+
 MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_cursor_seq, test_pre)
 {
     const struct param_spec *ps = ps_get("cn_cursor_seq");
@@ -458,6 +530,42 @@ MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_maint_disable, test_pre)
     ASSERT_EQ(false, params.cn_maint_disable);
 }
 
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_wbt_fence, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_wbt_fence");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_BOOL, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, cn_wbt_fence), ps->ps_offset);
+    ASSERT_EQ(sizeof(bool), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_FALSE(params.cn_wbt_fence);
+}
+
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_wbt_leaf_enc, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_wbt_leaf_enc");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U8, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, cn_wbt_leaf_enc), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint8_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(0, params.cn_wbt_leaf_enc);
+    ASSERT_EQ(0, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(2, ps->ps_bounds.as_uscalar.ps_max);
+}
+
 MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_bloom_create, test_pre)
 {
     const struct param_spec *ps = ps_get("cn_bloom_create");
@@ -623,6 +731,44 @@ MTF_DEFINE_UTEST_PRE(kvs_rparams_test, capped_evict_ttl, test_pre)
     ASSERT_EQ(UINT64_MAX, ps->ps_bounds.as_uscalar.ps_max);
 }
 
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_tier_hot_rate, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_tier_hot_rate");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, cn_tier_hot_rate), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(0, params.cn_tier_hot_rate);
+    ASSERT_EQ(0, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(UINT32_MAX, ps->ps_bounds.as_uscalar.ps_max);
+}
+
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, cn_rcache_mb, test_pre)
+{
+    const struct param_spec *ps = ps_get("cn_rcache_mb");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(PARAM_EXPERIMENTAL, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_U32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, cn_rcache_mb), ps->ps_offset);
+    ASSERT_EQ(sizeof(uint32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(0, params.cn_rcache_mb);
+    ASSERT_EQ(0, ps->ps_bounds.as_uscalar.ps_min);
+    ASSERT_EQ(1024 * 1024, ps->ps_bounds.as_uscalar.ps_max);
+}
+
 MTF_DEFINE_UTEST_PRE(kvs_rparams_test, mclass_policy, test_pre)
 {
     const struct param_spec *ps = ps_get("mclass.policy");
@@ -678,6 +824,75 @@ MTF_DEFINE_UTEST_PRE(kvs_rparams_test, value_compression_default, test_pre)
     ASSERT_EQ(0, merr_errno(err));
 }
 
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, value_compression_algorithm, test_pre)
+{
+    merr_t err;
+    char buf[128];
+    size_t needed_sz;
+    const struct param_spec *ps = ps_get("value.compression.algorithm");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(0, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_ENUM, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, value.compression.algo), ps->ps_offset);
+    ASSERT_EQ(sizeof(enum vcomp_algorithm), ps->ps_size);
+    ASSERT_NE((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_NE((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_NE((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_NE((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(VCOMP_ALGO_LZ4, params.value.compression.algo);
+    ASSERT_EQ(VCOMP_ALGO_MIN, ps->ps_bounds.as_enum.ps_min);
+    ASSERT_EQ(VCOMP_ALGO_MAX, ps->ps_bounds.as_enum.ps_max);
+
+    ps->ps_stringify(ps, &params.value.compression.algo, buf, sizeof(buf), &needed_sz);
+    ASSERT_STREQ("\"lz4\"", buf);
+    ASSERT_EQ(5, needed_sz);
+
+    /* clang-format off */
+    err = check(
+        "value.compression.algorithm=lz4", true,
+        "value.compression.algorithm=zstd", !!vcomp_compress_ops[VCOMP_ALGO_ZSTD],
+        "value.compression.algorithm=does-not-exist", false,
+        NULL
+    );
+    /* clang-format on */
+
+    ASSERT_EQ(0, merr_errno(err));
+}
+
+MTF_DEFINE_UTEST_PRE(kvs_rparams_test, value_compression_level, test_pre)
+{
+    merr_t err;
+    const struct param_spec *ps = ps_get("value.compression.level");
+
+    ASSERT_NE(NULL, ps);
+    ASSERT_NE(NULL, ps->ps_description);
+    ASSERT_EQ(0, ps->ps_flags);
+    ASSERT_EQ(PARAM_TYPE_I32, ps->ps_type);
+    ASSERT_EQ(offsetof(struct kvs_rparams, value.compression.level), ps->ps_offset);
+    ASSERT_EQ(sizeof(int32_t), ps->ps_size);
+    ASSERT_EQ((uintptr_t)ps->ps_convert, (uintptr_t)param_default_converter);
+    ASSERT_EQ((uintptr_t)ps->ps_validate, (uintptr_t)param_default_validator);
+    ASSERT_EQ((uintptr_t)ps->ps_stringify, (uintptr_t)param_default_stringify);
+    ASSERT_EQ((uintptr_t)ps->ps_jsonify, (uintptr_t)param_default_jsonify);
+    ASSERT_EQ(VCOMP_LEVEL_DEFAULT, params.value.compression.level);
+    ASSERT_EQ(VCOMP_LEVEL_MIN, ps->ps_bounds.as_scalar.ps_min);
+    ASSERT_EQ(VCOMP_LEVEL_MAX, ps->ps_bounds.as_scalar.ps_max);
+
+    /* clang-format off */
+    err = check(
+        "value.compression.level=0", true,
+        "value.compression.level=22", true,
+        "value.compression.level=23", false,
+        "value.compression.level=-1", false,
+        NULL
+    );
+    /* clang-format on */
+
+    ASSERT_EQ(0, merr_errno(err));
+}
+
 MTF_DEFINE_UTEST(kvs_rparams_test, get)
 {
     merr_t err;
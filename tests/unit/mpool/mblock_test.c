@@ -3,6 +3,8 @@
  * SPDX-FileCopyrightText: Copyright 2021 Micron Technology, Inc.
  */
 
+#include "build_config.h"
+
 #include <fcntl.h>
 #include <ftw.h>
 #include <limits.h>
@@ -23,8 +25,10 @@
 #include <hse/test/support/random_buffer.h>
 
 #include "common.h"
+#include "io.h"
 #include "mblock_file.h"
 #include "mblock_fset.h"
+#include "mclass.h"
 #include "mpool_internal.h"
 
 MTF_BEGIN_UTEST_COLLECTION_PRE(mblock_test, mpool_collection_pre)
@@ -564,6 +568,82 @@ MTF_DEFINE_UTEST_PREPOST(mblock_test, mblock_io, mpool_test_pre, mpool_test_post
     free(bufx);
 }
 
+#ifdef HAVE_IO_URING
+MTF_DEFINE_UTEST_PREPOST(mblock_test, mblock_io_uring, mpool_test_pre, mpool_test_post)
+{
+    struct mpool *mp;
+    struct io_ops io;
+    uint64_t mbid;
+    merr_t err;
+    int rc;
+    char *buf, *rbuf;
+    size_t mbsz = 32 << 20;
+
+    err = mpool_create(mtf_kvdb_home, &tcparams);
+    ASSERT_EQ(0, err);
+
+    trparams.mclass[HSE_MCLASS_CAPACITY].uring_enable = true;
+    err = mpool_open(mtf_kvdb_home, &trparams, O_RDWR, &mp);
+    ASSERT_EQ(0, err);
+
+    mclass_data_io_ops_set(mpool_mclass_handle(mp, HSE_MCLASS_CAPACITY), &io);
+    ASSERT_EQ((uintptr_t)io_uring_ops.read, (uintptr_t)io.read);
+    ASSERT_EQ((uintptr_t)io_uring_ops.write, (uintptr_t)io.write);
+
+    err = mpool_mblock_alloc(mp, HSE_MCLASS_CAPACITY, 0, &mbid, NULL);
+    ASSERT_EQ(0, err);
+
+    rc = posix_memalign((void **)&buf, PAGE_SIZE, mbsz);
+    ASSERT_EQ(0, rc);
+
+    rc = posix_memalign((void **)&rbuf, PAGE_SIZE, mbsz);
+    ASSERT_EQ(0, rc);
+
+    randomize_buffer(buf, mbsz, mbsz);
+
+    /* A full mblock of page sized iovecs takes more SQEs than fit in the
+     * ring at once, so this also exercises refilling the ring. Write it
+     * in two appends to cover writes at a non-zero offset.
+     */
+    err = mblock_rw(mp, mbid, buf, mbsz / 2, 0, true);
+    ASSERT_EQ(0, err);
+
+    err = mblock_rw(mp, mbid, buf + mbsz / 2, mbsz / 2, 0, true);
+    ASSERT_EQ(0, err);
+
+    err = mpool_mblock_commit(mp, mbid);
+    ASSERT_EQ(0, err);
+
+    memset(rbuf, 0, mbsz);
+    err = mblock_rw(mp, mbid, rbuf, mbsz, 0, false);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(-1, validate_random_buffer(rbuf, mbsz, mbsz));
+
+    /* Read the second half back at an offset.
+     */
+    memset(rbuf, 0, mbsz);
+    err = mblock_rw(mp, mbid, rbuf, mbsz / 2, mbsz / 2, false);
+    ASSERT_EQ(0, err);
+    ASSERT_EQ(0, memcmp(buf + mbsz / 2, rbuf, mbsz / 2));
+
+    err = mblock_rw(mp, mbid, rbuf, mbsz, PAGE_SIZE, false);
+    ASSERT_EQ(EINVAL, merr_errno(err));
+
+    err = mpool_mblock_delete(mp, mbid);
+    ASSERT_EQ(0, err);
+
+    trparams.mclass[HSE_MCLASS_CAPACITY].uring_enable = false;
+
+    err = mpool_close(mp);
+    ASSERT_EQ(0, err);
+
+    mpool_destroy(mtf_kvdb_home, &tdparams);
+
+    free(rbuf);
+    free(buf);
+}
+#endif /* HAVE_IO_URING */
+
 MTF_DEFINE_UTEST_PREPOST(mblock_test, mblock_invalid_args, mpool_test_pre, mpool_test_post)
 {
     struct mpool *mp;
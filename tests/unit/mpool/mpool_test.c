@@ -215,6 +215,7 @@ MTF_DEFINE_UTEST_PREPOST(mpool_test, mclass_test, mpool_test_pre, mpool_test_pos
     struct mpool_mclass_props props = {};
     struct hse_mclass_info info = {};
     struct media_class *mc;
+    uint64_t avail;
     merr_t err;
     int mcid, fd, i, rc;
     const char *pathp;
@@ -261,6 +262,25 @@ MTF_DEFINE_UTEST_PREPOST(mpool_test, mclass_test, mpool_test_pre, mpool_test_pos
     ASSERT_LT(info.mi_used_bytes, (70ul << MB_SHIFT));
     ASSERT_EQ(0, strncmp(capacity_path, info.mi_path, sizeof(capacity_path)));
 
+    err = mpool_mclass_avail_get(NULL, HSE_MCLASS_CAPACITY, &avail);
+    ASSERT_EQ(EINVAL, merr_errno(err));
+
+    err = mpool_mclass_avail_get(mp, HSE_MCLASS_COUNT, &avail);
+    ASSERT_EQ(EINVAL, merr_errno(err));
+
+    err = mpool_mclass_avail_get(mp, HSE_MCLASS_STAGING, &avail);
+    ASSERT_EQ(ENOENT, merr_errno(err));
+
+    err = mpool_mclass_avail_get(mp, HSE_MCLASS_CAPACITY, NULL);
+    ASSERT_EQ(EINVAL, merr_errno(err));
+
+    /* Bounded by the room left in the mblock files.
+     */
+    err = mpool_mclass_avail_get(mp, HSE_MCLASS_CAPACITY, &avail);
+    ASSERT_EQ(0, merr_errno(err));
+    ASSERT_GT(avail, 0);
+    ASSERT_LE(avail, props.mc_fmaxsz * props.mc_filecnt);
+
     mc = mpool_mclass_handle(NULL, HSE_MCLASS_CAPACITY);
     ASSERT_EQ(NULL, mc);
 
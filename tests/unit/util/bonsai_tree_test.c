@@ -956,6 +956,59 @@ MTF_DEFINE_UTEST_PREPOST(bonsai_tree_test, short_tree, no_fail_pre, no_fail_post
     broot = NULL;
 }
 
+MTF_DEFINE_UTEST_PREPOST(bonsai_tree_test, expire, no_fail_pre, no_fail_post)
+{
+    const uint64_t xlen = (1ull << 56) | (8ull << 32) | 16;
+    struct bonsai_skey skey;
+    struct bonsai_sval sval;
+    struct bonsai_kv *kv = NULL;
+    struct bonsai_val *v;
+    uint64_t key, val;
+    merr_t err;
+    int i;
+
+    err = bn_create(NULL, bonsai_client_insert_callback, NULL, &broot);
+    ASSERT_EQ(err, 0);
+
+    /* Even keys get an expiration time, odd keys do not.  The first value
+     * of each key is allocated with its kv, the second on its own.
+     */
+    for (i = 0; i < 8; ++i) {
+        key = i / 2;
+        val = i;
+
+        bn_skey_init(&key, sizeof(key), 0, 0, &skey);
+        bn_sval_init(&val, xlen, HSE_ORDNL_TO_SQNREF(i), &sval);
+        sval.bsv_expire = (key % 2) ? 0 : 1000 + i;
+
+        rcu_read_lock();
+        err = bn_insert_or_replace(broot, &skey, &sval);
+        rcu_read_unlock();
+        ASSERT_EQ(0, err);
+    }
+
+    for (key = 0; key < 4; ++key) {
+        bn_skey_init(&key, sizeof(key), 0, 0, &skey);
+
+        rcu_read_lock();
+        ASSERT_TRUE(bn_find(broot, &skey, &kv));
+
+        for (v = rcu_dereference(kv->bkv_values); v; v = rcu_dereference(v->bv_next)) {
+            val = HSE_SQNREF_TO_ORDNL(v->bv_seqnoref);
+
+            ASSERT_EQ(16, bonsai_val_ulen(v));
+            ASSERT_EQ(8, bonsai_val_clen(v));
+            ASSERT_EQ(1, bonsai_val_calgo(v));
+            ASSERT_EQ((key % 2) ? 0 : 1000 + val, bonsai_val_expire(v));
+            ASSERT_EQ(0, memcmp(&val, v->bv_value, sizeof(val)));
+        }
+        rcu_read_unlock();
+    }
+
+    bn_destroy(broot);
+    broot = NULL;
+}
+
 MTF_DEFINE_UTEST_PREPOST(bonsai_tree_test, insdel, no_fail_pre, no_fail_post)
 {
     uint ninserted = 0, ndeleted = 0;
@@ -1685,6 +1738,7 @@ again:
             seqnoref = HSE_ORDNL_TO_SQNREF(op_seqno);
             sval.bsv_seqnoref = seqnoref;
             sval.bsv_xlen = 0;
+            sval.bsv_expire = 0;
 
             rcu_read_lock();
             if (op_seqno % 200 == 0) {
@@ -3,6 +3,7 @@
  * SPDX-FileCopyrightText: Copyright 2015 Micron Technology, Inc.
  */
 
+#include <hse/ikvdb/vcomp_params.h>
 #include <hse/logging/logging.h>
 #include <hse/util/compression_lz4.h>
 #include <hse/util/platform.h>
@@ -38,7 +39,7 @@ MTF_DEFINE_UTEST(compression_test, compress)
 
     /* Compress the full source buffer, output to cbuf...
      */
-    err = compress_lz4_ops.cop_compress(src, srcsz, cbuf, cbufsz, &cbuflen);
+    err = compress_lz4_ops.cop_compress(src, srcsz, cbuf, cbufsz, 0, &cbuflen);
     if (err)
         log_errx("srcsz %zu, cbufsz %zu, cbuflen %u", err, srcsz, cbufsz, cbuflen);
     ASSERT_EQ(0, err);
@@ -76,7 +77,7 @@ MTF_DEFINE_UTEST(compression_test, compress)
     for (i = 0; i < 32; ++i) {
         srcsz = 512 + 8 - i;
 
-        err = compress_lz4_ops.cop_compress(src + i, srcsz, cbuf + i, cbufsz - i, &cbuflen);
+        err = compress_lz4_ops.cop_compress(src + i, srcsz, cbuf + i, cbufsz - i, 0, &cbuflen);
         if (err)
             log_errx("srcsz %zu, cbufsz %zu, cbuflen %u", err, srcsz, cbufsz - i, cbuflen);
         ASSERT_EQ(0, err);
@@ -130,7 +131,7 @@ MTF_DEFINE_UTEST(compression_test, mongo)
 
     /* Compress the full source buffer, output to cbuf...
      */
-    err = compress_lz4_ops.cop_compress(srcv, srcsz, cbuf, cbufsz, &cbuflen);
+    err = compress_lz4_ops.cop_compress(srcv, srcsz, cbuf, cbufsz, 0, &cbuflen);
     if (err)
         log_errx("srcsz %zu, cbufsz %zu, cbuflen %u", err, srcsz, cbufsz, cbuflen);
     ASSERT_EQ(0, err);
@@ -158,4 +159,66 @@ MTF_DEFINE_UTEST(compression_test, mongo)
     free(cbuf);
 }
 
+/* Round trip every algorithm supported by this build through the same
+ * decompression entry point used by the read paths, including truncated
+ * output buffers.
+ */
+MTF_DEFINE_UTEST(compression_test, vcomp_algorithms)
+{
+    size_t srcsz, cbufsz;
+    char *src, *cbuf, *dbuf;
+    uint cbuflen, dbuflen;
+    merr_t err;
+    int i, algo;
+
+    srcsz = 64 * 1024;
+    src = malloc(srcsz);
+    ASSERT_NE(NULL, src);
+
+    dbuf = malloc(srcsz);
+    ASSERT_NE(NULL, dbuf);
+
+    for (i = 0; i < srcsz; ++i)
+        src[i] = (i / 13) % 7;
+
+    for (algo = VCOMP_ALGO_MIN; algo <= VCOMP_ALGO_MAX; ++algo) {
+        const struct compress_ops *cops = vcomp_compress_ops[algo];
+
+        if (!cops) {
+            err = vcomp_decompress(algo, src, srcsz, dbuf, srcsz, &dbuflen);
+            ASSERT_EQ(ENOTSUP, merr_errno(err));
+            continue;
+        }
+
+        cbufsz = cops->cop_estimate(NULL, srcsz);
+        ASSERT_GE(cbufsz, srcsz);
+
+        cbuf = malloc(cbufsz);
+        ASSERT_NE(NULL, cbuf);
+
+        err = cops->cop_compress(src, srcsz, cbuf, cbufsz, 3, &cbuflen);
+        ASSERT_EQ(0, err);
+        ASSERT_LT(cbuflen, srcsz);
+
+        err = vcomp_decompress(algo, cbuf, cbuflen, dbuf, srcsz, &dbuflen);
+        ASSERT_EQ(0, err);
+        ASSERT_EQ(srcsz, dbuflen);
+        ASSERT_EQ(0, memcmp(src, dbuf, dbuflen));
+
+        for (i = 1; i < srcsz; i += 4093) {
+            memset(dbuf, 0xaa, srcsz);
+
+            err = vcomp_decompress(algo, cbuf, cbuflen, dbuf, i, &dbuflen);
+            ASSERT_EQ(0, err);
+            ASSERT_EQ(i, dbuflen);
+            ASSERT_EQ(0, memcmp(src, dbuf, i));
+        }
+
+        free(cbuf);
+    }
+
+    free(dbuf);
+    free(src);
+}
+
 MTF_END_UTEST_COLLECTION(compression_test)
@@ -0,0 +1,325 @@
+/* SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * SPDX-FileCopyrightText: Copyright 2022 Micron Technology, Inc.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <hse/ikvdb/key_hash.h>
+#include <hse/util/mutex.h>
+
+#include <hse/test/mock/api.h>
+#include <hse/test/mtf/framework.h>
+
+#include "wal/wal_replay.c"
+
+/* Enough records for wal_replay_gen_impl() to apply them in parallel, spread
+ * over few enough keys that every key is updated many times over, with the
+ * updates of each key interleaved with those of all the others.
+ */
+#define NRECS (3 * WAL_REPLAY_APPLY_RECS_MIN + 17)
+#define NKEYS (61)
+#define WIDTH (4)
+
+struct key_state {
+    uint64_t ks_seqno;
+    uint64_t ks_val;
+    bool ks_tomb;
+};
+
+static struct mutex state_lock;
+static struct key_state statev[NKEYS];
+static char keyv[NKEYS][16];
+static uint64_t valv[NRECS];
+static pthread_t main_tid;
+static uint64_t order_errs;
+static uint64_t main_calls;
+static uint64_t applied;
+static uint64_t pdel_applied;
+
+static int
+key2idx(const struct kvs_ktuple *kt)
+{
+    return atoi((const char *)kt->kt_data + 3);
+}
+
+static void
+apply(uint64_t seqno, struct kvs_ktuple *kt, struct kvs_vtuple *vt)
+{
+    struct key_state *ks = statev + key2idx(kt);
+
+    mutex_lock(&state_lock);
+    if (seqno <= ks->ks_seqno)
+        order_errs++;
+    if (pthread_equal(pthread_self(), main_tid))
+        main_calls++;
+
+    ks->ks_seqno = seqno;
+    ks->ks_tomb = !vt;
+    ks->ks_val = vt ? *(const uint64_t *)vt->vt_data : 0;
+    applied++;
+    mutex_unlock(&state_lock);
+}
+
+static merr_t
+mock_put(
+    struct ikvdb *ikvdb,
+    struct ikvdb_kvs_hdl *ikvsh,
+    uint64_t cnid,
+    uint64_t seqno,
+    struct kvs_ktuple *kt,
+    struct kvs_vtuple *vt)
+{
+    apply(seqno, kt, vt);
+
+    return 0;
+}
+
+static merr_t
+mock_del(
+    struct ikvdb *ikvdb,
+    struct ikvdb_kvs_hdl *ikvsh,
+    uint64_t cnid,
+    uint64_t seqno,
+    struct kvs_ktuple *kt)
+{
+    apply(seqno, kt, NULL);
+
+    return 0;
+}
+
+static merr_t
+mock_prefix_del(
+    struct ikvdb *ikvdb,
+    struct ikvdb_kvs_hdl *ikvsh,
+    uint64_t cnid,
+    uint64_t seqno,
+    struct kvs_ktuple *kt)
+{
+    /* A prefix delete must see every record that precedes it applied,
+     * and none of those that follow it.
+     */
+    mutex_lock(&state_lock);
+    pdel_applied = applied;
+    if (!pthread_equal(pthread_self(), main_tid))
+        order_errs++;
+    mutex_unlock(&state_lock);
+
+    return 0;
+}
+
+static uint64_t
+mock_key_hash(struct ikvdb_kvs_hdl *ikvsh, uint64_t cnid, const struct kvs_ktuple *kt)
+{
+    return key_hash64(kt->kt_data, kt->kt_len);
+}
+
+static int
+setup(struct mtf_test_info *lcl_ti)
+{
+    int i;
+
+    mutex_init(&state_lock);
+
+    for (i = 0; i < NKEYS; i++)
+        snprintf(keyv[i], sizeof(keyv[i]), "key%d", i);
+
+    MOCK_SET_FN(ikvdb, ikvdb_wal_replay_put, mock_put);
+    MOCK_SET_FN(ikvdb, ikvdb_wal_replay_del, mock_del);
+    MOCK_SET_FN(ikvdb, ikvdb_wal_replay_prefix_del, mock_prefix_del);
+    MOCK_SET_FN(ikvdb, ikvdb_wal_replay_key_hash, mock_key_hash);
+
+    return 0;
+}
+
+static int
+teardown(struct mtf_test_info *lcl_ti)
+{
+    MOCK_UNSET_FN(ikvdb, ikvdb_wal_replay_put);
+    MOCK_UNSET_FN(ikvdb, ikvdb_wal_replay_del);
+    MOCK_UNSET_FN(ikvdb, ikvdb_wal_replay_prefix_del);
+    MOCK_UNSET_FN(ikvdb, ikvdb_wal_replay_key_hash);
+
+    mutex_destroy(&state_lock);
+
+    return 0;
+}
+
+static int
+reset(struct mtf_test_info *lcl_ti)
+{
+    memset(statev, 0, sizeof(statev));
+    main_tid = pthread_self();
+    order_errs = 0;
+    main_calls = 0;
+    applied = 0;
+    pdel_applied = 0;
+
+    return 0;
+}
+
+/* Build a replay handle with an apply width of %width and a gen holding
+ * NRECS records in rid order.  Record i updates key (i % NKEYS) at seqno
+ * i + 1, and every 7th record is a delete.  If %pdel is non-zero, record
+ * %pdel is a prefix delete.
+ */
+static struct wal_replay *
+replay_create(uint32_t width, uint64_t pdel, struct wal_replay_gen **rgen_out)
+{
+    struct wal_replay_gen *rgen;
+    struct wal_replay *rep;
+    uint64_t i;
+
+    rep = aligned_alloc(__alignof__(*rep), sizeof(*rep));
+    rgen = aligned_alloc(__alignof__(*rgen), sizeof(*rgen));
+    if (!rep || !rgen)
+        abort();
+
+    memset(rep, 0, sizeof(*rep));
+    memset(rgen, 0, sizeof(*rgen));
+
+    rep->r_cache =
+        kmem_cache_create("wal-reprec", sizeof(struct wal_rec), alignof(struct wal_rec), 0, NULL);
+    if (!rep->r_cache)
+        abort();
+
+    rep->r_width = width;
+    if (width > 1) {
+        rep->r_wq = alloc_workqueue("wal_replay_test", 0, width, width);
+        if (!rep->r_wq)
+            abort();
+    }
+
+    rgen->rg_root = RB_ROOT;
+    rgen->rg_gen = 1;
+
+    for (i = 0; i < NRECS; i++) {
+        struct wal_rec *rec;
+        const char *key;
+
+        rec = kmem_cache_zalloc(rep->r_cache);
+        if (!rec)
+            abort();
+
+        key = keyv[i % NKEYS];
+        valv[i] = (i << 8) | (i % NKEYS);
+
+        rec->hdr.rid = i + 1;
+        rec->hdr.type = WAL_RT_NONTX;
+        rec->cnid = 1;
+        rec->seqno = i + 1;
+        rec->op = (i % 7 == 6) ? WAL_OP_DEL : WAL_OP_PUT;
+        if (pdel && i == pdel)
+            rec->op = WAL_OP_PDEL;
+
+        kvs_ktuple_init_nohash(&rec->kt, key, strlen(key));
+        kvs_vtuple_init(&rec->vt, valv + i, sizeof(valv[i]));
+
+        if (wal_rec_rb_insert(rgen, rec))
+            abort();
+        rgen->rg_nrecs++;
+    }
+
+    *rgen_out = rgen;
+
+    return rep;
+}
+
+static void
+replay_destroy(struct wal_replay *rep, struct wal_replay_gen *rgen)
+{
+    if (rep->r_wq)
+        destroy_workqueue(rep->r_wq);
+    kmem_cache_destroy(rep->r_cache);
+    free(rgen);
+    free(rep);
+}
+
+MTF_BEGIN_UTEST_COLLECTION_PREPOST(wal_replay_test, setup, teardown);
+
+MTF_DEFINE_UTEST_PRE(wal_replay_test, parallel_apply, reset)
+{
+    struct wal_replay_gen *rgen;
+    struct wal_replay *rep;
+    merr_t err;
+    int i;
+
+    rep = replay_create(WIDTH, 0, &rgen);
+
+    err = wal_replay_gen_impl(rep, rgen, HSE_BTF_MANAGED);
+    ASSERT_EQ(0, err);
+
+    /* Every record was applied by an apply worker, and every key saw its
+     * updates in seqno order.
+     */
+    ASSERT_EQ(NRECS, applied);
+    ASSERT_EQ(0, main_calls);
+    ASSERT_EQ(0, order_errs);
+    ASSERT_EQ(NRECS, rgen->rg_krcnt);
+    ASSERT_EQ(NRECS, rgen->rg_maxseqno);
+    ASSERT_TRUE(RB_EMPTY_ROOT(&rgen->rg_root));
+
+    /* Each key ends up with the value of its last record.
+     */
+    for (i = 0; i < NKEYS; i++) {
+        uint64_t last = NRECS - 1 - ((NRECS - 1 - i) % NKEYS);
+
+        ASSERT_EQ(last + 1, statev[i].ks_seqno);
+        ASSERT_EQ(last % 7 == 6, statev[i].ks_tomb);
+        if (!statev[i].ks_tomb)
+            ASSERT_EQ(valv[last], statev[i].ks_val);
+    }
+
+    replay_destroy(rep, rgen);
+}
+
+MTF_DEFINE_UTEST_PRE(wal_replay_test, parallel_apply_pdel, reset)
+{
+    const uint64_t pdel = WAL_REPLAY_APPLY_RECS_MIN + 5;
+    struct wal_replay_gen *rgen;
+    struct wal_replay *rep;
+    merr_t err;
+
+    rep = replay_create(WIDTH, pdel, &rgen);
+
+    err = wal_replay_gen_impl(rep, rgen, HSE_BTF_MANAGED);
+    ASSERT_EQ(0, err);
+
+    /* The prefix delete was applied serially, after all the records that
+     * precede it and before any that follow it.
+     */
+    ASSERT_EQ(NRECS - 1, applied);
+    ASSERT_EQ(pdel, pdel_applied);
+    ASSERT_EQ(0, main_calls);
+    ASSERT_EQ(0, order_errs);
+    ASSERT_EQ(NRECS, rgen->rg_maxseqno);
+
+    replay_destroy(rep, rgen);
+}
+
+MTF_DEFINE_UTEST_PRE(wal_replay_test, serial_apply, reset)
+{
+    struct wal_replay_gen *rgen;
+    struct wal_replay *rep;
+    merr_t err;
+
+    /* Without apply workers every record is applied by the caller.
+     */
+    rep = replay_create(1, 0, &rgen);
+    ASSERT_EQ(NULL, rep->r_wq);
+
+    err = wal_replay_gen_impl(rep, rgen, HSE_BTF_MANAGED);
+    ASSERT_EQ(0, err);
+
+    ASSERT_EQ(NRECS, applied);
+    ASSERT_EQ(NRECS, main_calls);
+    ASSERT_EQ(0, order_errs);
+    ASSERT_EQ(NRECS, rgen->rg_maxseqno);
+
+    replay_destroy(rep, rgen);
+}
+
+MTF_END_UTEST_COLLECTION(wal_replay_test)
@@ -23,6 +23,7 @@
 
 #include "cn/omf.h"
 #include "cn/wbt_internal.h"
+#include "cn/wbt_reader.h"
 #include "cndb_reader.h"
 #include "cndb_record.h"
 #include "commands.h"
@@ -293,9 +294,19 @@ val_get_next(const void *kmd, size_t *off, struct kmd_vref *vref)
 char
 fmt_wtype(uint magic, int isroot)
 {
-    return (
-        isroot ? 'r'
-               : (magic == WBT_LFE_NODE_MAGIC ? 'L' : (magic == WBT_INE_NODE_MAGIC ? 'i' : '?')));
+    if (isroot)
+        return 'r';
+
+    switch (magic) {
+    case WBT_LFE_NODE_MAGIC:
+        return 'L';
+    case WBT_LFC_NODE_MAGIC:
+        return 'C';
+    case WBT_INE_NODE_MAGIC:
+        return 'i';
+    default:
+        return '?';
+    }
 }
 
 static void
@@ -306,11 +317,35 @@ wbt_dump_node(const struct wbt_node_hdr_omf *wbn, uint version, const void *kmd,
     const void *kdata, *pfx;
     uint i, nkeys, klen, pfx_len;
     bool internal_node;
-    uint hdr_sz;
+    uint hdr_sz, magic;
     void *buf = NULL;
+    void *xnode = NULL;
     size_t bufsz = 0;
 
-    internal_node = omf_wbn_magic(wbn) == WBT_INE_NODE_MAGIC;
+    magic = omf_wbn_magic(wbn);
+
+    /* Compressed leaves are dumped from their expanded image.
+     */
+    if (magic == WBT_LFC_NODE_MAGIC) {
+        merr_t err;
+
+        xnode = malloc(WBT_LFX_NODE_SIZE);
+        if (!xnode)
+            fatal("malloc", merr(ENOMEM));
+
+        err = wbt_leaf_expand(wbn, xnode);
+        if (err) {
+            printf(
+                "    %c: pg %d  magic 0x%04x  nkeys %u  kmdoff %u  malformed\n",
+                fmt_wtype(magic, pgno == root), pgno, magic, omf_wbn_num_keys(wbn),
+                omf_wbn_kmd(wbn));
+            goto out;
+        }
+
+        wbn = xnode;
+    }
+
+    internal_node = magic == WBT_INE_NODE_MAGIC;
     hdr_sz = sizeof(struct wbt_node_hdr_omf);
     pfx_len = omf_wbn_pfx_len(wbn);
     pfx = ((void *)wbn) + hdr_sz;
@@ -320,7 +355,7 @@ wbt_dump_node(const struct wbt_node_hdr_omf *wbn, uint version, const void *kmd,
 
     printf(
         "    %c: pg %d  magic 0x%04x  nkeys %u  kmdoff %u  pfx_len %u  pfx %s\n",
-        fmt_wtype(omf_wbn_magic(wbn), pgno == root), pgno, omf_wbn_magic(wbn),
+        fmt_wtype(magic, pgno == root), pgno, magic,
         omf_wbn_num_keys(wbn), omf_wbn_kmd(wbn), pfx_len,
         fmt_data(&buf, &bufsz, pfx, pfx_len, opts.klen, opts.penc));
 
@@ -372,6 +407,7 @@ wbt_dump_node(const struct wbt_node_hdr_omf *wbn, uint version, const void *kmd,
     }
 
 out:
+    free(xnode);
     free(buf);
 }
 
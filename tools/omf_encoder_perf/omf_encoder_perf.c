@@ -529,7 +529,7 @@ run_kmd_write_perf(struct kmd_test_stats *s)
 
         s->nvals += count;
         while (count-- > 0)
-            kmd_add_val(mem, &off, seq++, vbidx, vboff, vlen);
+            kmd_add_val(mem, &off, seq++, 0, vbidx, vboff, vlen);
     }
 
     kmd_set_count(mem, &off, 0);
@@ -578,6 +578,7 @@ run_kmd_read_perf(struct kmd_test_stats *s)
                 s->nvals++;
                 break;
             case VTYPE_CVAL:
+            case VTYPE_ZCVAL:
                 kmd_cval(mem, &off, &vbidx, &vboff, &vlen, &clen);
                 s->nvals++;
                 break;
@@ -642,6 +643,7 @@ run_kmd_tp(struct kmd_test_profile *tp, struct kmd_test_stats *s, bool writing)
                 s->nivals++;
                 break;
             case VTYPE_CVAL:
+            case VTYPE_ZCVAL:
             case VTYPE_UCVAL:
                 s->nvals++;
                 break;
@@ -655,16 +657,17 @@ run_kmd_tp(struct kmd_test_profile *tp, struct kmd_test_stats *s, bool writing)
                     kmd_add_ptomb(mem, &off, seq);
                     break;
                 case VTYPE_ZVAL:
-                    kmd_add_zval(mem, &off, seq);
+                    kmd_add_zval(mem, &off, seq, 0);
                     break;
                 case VTYPE_IVAL:
-                    kmd_add_ival(mem, &off, seq, vdata, vlen);
+                    kmd_add_ival(mem, &off, seq, 0, vdata, vlen);
                     break;
                 case VTYPE_CVAL:
-                    kmd_add_cval(mem, &off, seq, vbidx, vboff, vlen, clen);
+                case VTYPE_ZCVAL:
+                    kmd_add_cval(mem, &off, vtype, seq, 0, vbidx, vboff, vlen, clen);
                     break;
                 case VTYPE_UCVAL:
-                    kmd_add_val(mem, &off, seq, vbidx, vboff, vlen);
+                    kmd_add_val(mem, &off, seq, 0, vbidx, vboff, vlen);
                     break;
                 }
             } else {
@@ -687,6 +690,7 @@ run_kmd_tp(struct kmd_test_profile *tp, struct kmd_test_stats *s, bool writing)
                     assert(actual_vlen == vlen);
                     break;
                 case VTYPE_CVAL:
+                case VTYPE_ZCVAL:
                     kmd_cval(mem, &off, &actual_vbidx, &actual_vboff, &actual_vlen, &actual_clen);
                     assert(actual_vbidx == vbidx);
                     assert(actual_vboff == vboff);
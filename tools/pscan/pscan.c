@@ -24,6 +24,7 @@
 #include <unistd.h>
 #include <xxhash.h>
 
+#include <hse/experimental.h>
 #include <hse/flags.h>
 #include <hse/hse.h>
 
@@ -76,6 +77,7 @@ usage(void)
 {
     printf(
         "usage: %s [options] mp kvdb kvs [param=value ...]\n"
+        "-b batch  read up to $batch pairs per cursor read call\n"
         "-C        count keys (no checksum)\n"
         "-c        count keys (compute running checksum)\n"
         "-D        delete keys as you find them\n"
@@ -164,10 +166,13 @@ main(int argc, char **argv)
     struct hse_kvs_cursor *cursor;
     struct hse_kvdb *kvdb_h;
     struct hse_kvs *kvs_h;
+    struct hse_kvs_cursor_kv *kvv = NULL;
+    size_t batch, kvc, kvi, bufsz;
+    void *buf = NULL;
     uint64_t keyhash, valhash;
     int showlen;
     int seeklen, pfxlen;
-    bool eof, countem, cksum, deletem, stats;
+    bool eof, beof, countem, cksum, deletem, stats;
     bool reverse = false;
     unsigned opt_help = 0, flags = 0;
     uint64_t iter, max_iter;
@@ -192,6 +197,7 @@ main(int argc, char **argv)
     prefix = "";
     seek = NULL;
     max_iter = ULONG_MAX;
+    batch = 0;
 
     Opts.kmax = HSE_KVS_KEY_LEN_MAX;
     Opts.vmax = HSE_KVS_VALUE_LEN_MAX;
@@ -203,12 +209,15 @@ main(int argc, char **argv)
     if (rc)
         fatal(rc, "pg_create");
 
-    while ((c = getopt(argc, argv, ":CcDHhi:k:lm:p:rs:t:uV:vxZ:")) != -1) {
+    while ((c = getopt(argc, argv, ":b:CcDHhi:k:lm:p:rs:t:uV:vxZ:")) != -1) {
         char *end = NULL;
 
         errno = 0;
 
         switch (c) {
+        case 'b':
+            batch = strtoul(optarg, &end, 0);
+            break;
         case 'C':
             countem = true;
             cksum = false;
@@ -350,6 +359,10 @@ main(int argc, char **argv)
     if (reverse)
         flags |= HSE_CURSOR_CREATE_REV;
 
+    /* Neither counting without a checksum nor deleting needs values. */
+    if ((countem && !cksum) || deletem)
+        flags |= HSE_CURSOR_CREATE_KEYS_ONLY;
+
     err = hse_kvs_cursor_create(kvs_h, flags, NULL, prefix, pfxlen, &cursor);
     EVENT_SAMPLE(tc);
     if (err) {
@@ -368,6 +381,17 @@ main(int argc, char **argv)
     if (Opts.kmax == 0)
         uniq = false;
 
+    if (batch > 0) {
+        /* Large enough to always hold at least one maximally sized pair.
+         */
+        bufsz = 2 * (HSE_KVS_KEY_LEN_MAX + HSE_KVS_VALUE_LEN_MAX);
+
+        kvv = malloc(batch * sizeof(*kvv));
+        buf = malloc(bufsz);
+        if (!kvv || !buf)
+            fatal(ENOMEM, "cannot allocate batch buffers");
+    }
+
     if (SIG_ERR == signal(SIGINT, sigint_isr))
         fatal(errno, "cannot install signal handler");
 
@@ -378,7 +402,8 @@ main(int argc, char **argv)
     }
 
     keyhash = valhash = 0;
-    eof = false;
+    eof = beof = false;
+    kvc = kvi = 0;
 
     for (iter = 0; iter < max_iter; iter++) {
         const void *key, *val;
@@ -387,7 +412,22 @@ main(int argc, char **argv)
         if (stats)
             EVENT_START(tr);
 
-        if (countem && !cksum)
+        if (kvv) {
+            if (kvi == kvc && !beof) {
+                kvc = batch;
+                kvi = 0;
+                err = hse_kvs_cursor_read_batch(cursor, 0, buf, bufsz, kvv, &kvc, &beof);
+            }
+
+            eof = (kvi == kvc);
+            if (!err && !eof) {
+                key = kvv[kvi].key;
+                klen = kvv[kvi].key_len;
+                val = kvv[kvi].val;
+                vlen = kvv[kvi].val_len;
+                ++kvi;
+            }
+        } else if (countem && !cksum)
             err = hse_kvs_cursor_read(cursor, 0, &key, &klen, NULL, NULL, &eof);
         else
             err = hse_kvs_cursor_read(cursor, 0, &key, &klen, &val, &vlen, &eof);
@@ -455,6 +495,9 @@ main(int argc, char **argv)
     hse_kvs_cursor_destroy(cursor);
     EVENT_SAMPLE(td);
 
+    free(buf);
+    free(kvv);
+
     if (deletem)
         printf("%lu deleted\n", shr.count);
     if (uniq)